@@ -0,0 +1,39 @@
+// Tests that the change stream pre-images remover job truncates the expired pre-images on every
+// node of a replica set when 'useTruncationForExpiredPreImagesRemoval' is enabled.
+// @tags: [
+//  requires_replication,
+// ]
+(function() {
+"use strict";
+
+load("jstests/noPassthrough/libs/change_stream_pre_image_time_based_expiration_utils.js");
+
+const replSetTest = new ReplSetTest({
+    name: "replSet",
+    nodes: [{}, {rsConfig: {priority: 0}}],
+    nodeOptions: {
+        setParameter: {
+            useTruncationForExpiredPreImagesRemoval: true,
+            // Make each pre-image a truncate marker of its own, so that the expired pre-images are
+            // removed as precisely as with deletes.
+            preImagesCollectionTruncateMarkersMinBytes: 1,
+            expiredChangeStreamPreImageRemovalJobSleepSecs: 1,
+        }
+    }
+});
+replSetTest.startSet();
+replSetTest.initiate();
+
+const primary = replSetTest.getPrimary();
+testTimeBasedPreImageRetentionPolicy(primary, primary);
+
+// The truncates are not replicated. The current time is only injected on the primary, so the
+// secondary expires the pre-images which the primary has retained on its own.
+const secondaryPreImageColl =
+    replSetTest.getSecondary().getDB("config").getCollection("system.preimages");
+assert.soon(() => secondaryPreImageColl.find().itcount() == 0);
+assert.gt(primary.getDB("config").getCollection("system.preimages").find().itcount(), 0);
+
+// The pre-images collections of the two nodes differ by design.
+replSetTest.stopSet(undefined /* signal */, false /* forRestart */, {skipCheckDBHashes: true});
+}());
@@ -0,0 +1,64 @@
+// Tests that the oplog scan of a change stream runs in SBE when
+// 'internalChangeStreamUseSbeForOplogScan' is enabled, and that it returns the same events as the
+// classic oplog scan, including for a user $match which is rewritten into the oplog filter.
+// @tags: [
+//   requires_majority_read_concern,
+//   requires_profiling,
+//   requires_replication,
+// ]
+(function() {
+"use strict";
+
+const rst = new ReplSetTest({nodes: 1});
+rst.startSet();
+rst.initiate();
+
+const db = rst.getPrimary().getDB("test");
+const coll = db.change_stream_sbe_oplog_scan;
+assert.commandWorked(db.setProfilingLevel(2));
+
+function setUseSbe(useSbe) {
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalChangeStreamUseSbeForOplogScan: useSbe}));
+}
+
+function getQueryFramework(comment) {
+    const profileObj = db.system.profile.find({"command.comment": comment}).next();
+    return profileObj.queryFramework;
+}
+
+// Opens a change stream with a user $match, performs some writes and returns the observed events.
+function runChangeStream(comment) {
+    const stream = coll.watch([{$match: {operationType: {$in: ["insert", "delete"]}}}],
+                              {comment: comment});
+    assert.commandWorked(coll.insert({_id: comment + "_a", x: 1}));
+    assert.commandWorked(coll.update({_id: comment + "_a"}, {$set: {x: 2}}));
+    assert.commandWorked(coll.insert({_id: comment + "_b", x: 1}));
+    assert.commandWorked(coll.remove({_id: comment + "_a"}));
+
+    let events = [];
+    for (let i = 0; i < 3; ++i) {
+        assert.soon(() => stream.hasNext());
+        const event = stream.next();
+        events.push({operationType: event.operationType, _id: event.documentKey._id});
+    }
+    stream.close();
+    return events;
+}
+
+const expectedEvents = (prefix) => [
+    {operationType: "insert", _id: prefix + "_a"},
+    {operationType: "insert", _id: prefix + "_b"},
+    {operationType: "delete", _id: prefix + "_a"},
+];
+
+setUseSbe(false);
+assert.eq(runChangeStream("classic"), expectedEvents("classic"));
+assert.eq(getQueryFramework("classic"), "classic");
+
+setUseSbe(true);
+assert.eq(runChangeStream("sbe"), expectedEvents("sbe"));
+assert.eq(getQueryFramework("sbe"), "sbe");
+
+rst.stopSet();
+})();
@@ -0,0 +1,72 @@
+// Tests that change streams which read from the shared oplog scan see the same events as they do
+// from their own oplog cursors, including streams on different collections and a stream which is
+// detached from the shared scan because it does not keep up.
+// @tags: [
+//   requires_majority_read_concern,
+//   requires_replication,
+// ]
+(function() {
+"use strict";
+
+const rst = new ReplSetTest({
+    nodes: 1,
+    nodeOptions: {
+        setParameter: {
+            internalChangeStreamUseSharedOplogScan: true,
+            internalChangeStreamSharedOplogScanBufferSize: 10,
+            internalChangeStreamSharedOplogScanSlowConsumerTimeoutMS: 0,
+        }
+    }
+});
+rst.startSet();
+rst.initiate();
+
+const db = rst.getPrimary().getDB("test");
+const collA = db.shared_oplog_scan_a;
+const collB = db.shared_oplog_scan_b;
+assert.commandWorked(collA.insert({_id: "init"}, {writeConcern: {w: "majority"}}));
+assert.commandWorked(collB.insert({_id: "init"}, {writeConcern: {w: "majority"}}));
+
+function assertNextInserts(stream, ids) {
+    for (let id of ids) {
+        assert.soon(() => stream.hasNext());
+        const event = stream.next();
+        assert.eq(event.operationType, "insert", event);
+        assert.eq(event.documentKey._id, id, event);
+    }
+}
+
+// Open the streams and let them catch up with the oplog, which hands them over to the shared scan.
+const streamsA = [collA.watch(), collA.watch()];
+const streamB = collB.watch();
+for (let stream of [...streamsA, streamB]) {
+    assert(!stream.hasNext());
+}
+
+let idsA = [];
+for (let i = 0; i < 5; ++i) {
+    assert.commandWorked(collA.insert({_id: i}, {writeConcern: {w: "majority"}}));
+    assert.commandWorked(collB.insert({_id: i}, {writeConcern: {w: "majority"}}));
+    idsA.push(i);
+}
+for (let stream of streamsA) {
+    assertNextInserts(stream, idsA);
+}
+assertNextInserts(streamB, idsA);
+
+// Write more than the shared buffer holds while only one of the streams on 'collA' consumes. The
+// other one is detached and goes back to its own oplog cursor without missing any event.
+idsA = [];
+for (let i = 5; i < 40; ++i) {
+    assert.commandWorked(collA.insert({_id: i}, {writeConcern: {w: "majority"}}));
+    idsA.push(i);
+}
+assertNextInserts(streamsA[0], idsA);
+assertNextInserts(streamsA[1], idsA);
+assert(!streamB.hasNext());
+
+for (let stream of [...streamsA, streamB]) {
+    stream.close();
+}
+rst.stopSet();
+}());
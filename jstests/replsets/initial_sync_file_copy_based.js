@@ -0,0 +1,65 @@
+/**
+ * Tests that a node added with initialSyncMethod "fileCopyBased" syncs the data of its sync source.
+ * When backup cursors are supported the node copies its files. Builds without $backupCursor
+ * support, such as community builds, do not offer the method, and the node uses logical initial
+ * sync instead.
+ *
+ * @tags: [requires_persistence, requires_wiredtiger]
+ */
+(function() {
+"use strict";
+
+const rst = new ReplSetTest({nodes: 1});
+rst.startSet();
+rst.initiate();
+
+const primary = rst.getPrimary();
+const dbName = "test";
+const collName = "coll";
+const primaryColl = primary.getDB(dbName).getCollection(collName);
+
+const docs = [];
+for (let i = 0; i < 1000; i++) {
+    docs.push({_id: i, x: i, padding: "a".repeat(100)});
+}
+assert.commandWorked(primaryColl.insert(docs));
+assert.commandWorked(primaryColl.createIndex({x: 1}));
+
+const backupCursorSupported = (() => {
+    const res = primary.adminCommand({aggregate: 1, pipeline: [{$backupCursor: {}}], cursor: {}});
+    if (!res.ok) {
+        return false;
+    }
+    assert.commandWorked(
+        primary.adminCommand({killCursors: "$cmd.aggregate", cursors: [res.cursor.id]}));
+    return true;
+})();
+
+jsTestLog("Adding a node which uses file copy based initial sync");
+const secondary = rst.add({
+    rsConfig: {priority: 0, votes: 0},
+    setParameter: {
+        initialSyncMethod: "fileCopyBased",
+        logComponentVerbosity: tojsononeline({replication: {initialSync: 1}}),
+    }
+});
+rst.reInitiate();
+rst.awaitSecondaryNodes();
+
+if (backupCursorSupported) {
+    checkLog.containsJson(secondary, 7095735);
+} else {
+    jsTestLog("Backup cursors are not supported, expecting logical initial sync");
+    checkLog.containsJson(secondary, 58154);
+}
+
+// Writes made after initial sync replicate to the new node.
+assert.commandWorked(primaryColl.insert({_id: "after"}, {writeConcern: {w: 2}}));
+
+rst.awaitReplication();
+const secondaryColl = secondary.getDB(dbName).getCollection(collName);
+assert.eq(1001, secondaryColl.find().itcount());
+assert.eq(1000, secondaryColl.find({x: {$gte: 0}}).hint({x: 1}).itcount());
+
+rst.stopSet();
+})();
@@ -275,6 +275,11 @@ Status _createTimeseries(OperationContext* opCtx,
     // cannot cover all constraints. Leave the validationLevel and validationAction to their
     // strict/error defaults.
     auto timeField = options.timeseries->getTimeField();
+    // Buckets only carry 'control.bloom' if the collection keeps Bloom filters, so existing
+    // collections keep their original validator.
+    auto bloomProperty = options.timeseries->getBucketBloomFilterFields()
+        ? ",\n                bloom: {bsonType: 'object'}"_sd
+        : ""_sd;
     auto validatorObj = fromjson(fmt::sprintf(R"(
 {
 '$jsonSchema' : {
@@ -298,7 +303,7 @@ Status _createTimeseries(OperationContext* opCtx,
                     properties: {'%s': {bsonType: 'date'}}
                 },
                 closed: {bsonType: 'bool'},
-                count: {bsonType: 'number', minimum: 1}
+                count: {bsonType: 'number', minimum: 1}%s
             },
             additionalProperties: false
         },
@@ -311,7 +316,8 @@ Status _createTimeseries(OperationContext* opCtx,
                                               timeField,
                                               timeField,
                                               timeField,
-                                              timeField));
+                                              timeField,
+                                              bloomProperty));
 
     bool existingBucketCollectionIsCompatible = false;
 
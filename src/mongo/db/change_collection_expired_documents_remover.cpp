@@ -95,10 +95,19 @@ void removeExpiredDocuments(Client* client) {
             AutoGetChangeCollection changeCollection{
                 opCtx.get(), AutoGetChangeCollection::AccessMode::kWrite, tenantId};
 
-            // Early exit if collection does not exist or if running on a secondary (requires
+            if (!changeCollection) {
+                continue;
+            }
+
+            // Truncates are local to each node, so they also run on secondaries.
+            if (ChangeStreamChangeCollectionManager::isTruncationEnabled()) {
+                removedCount += changeCollectionManager.truncateExpiredChangeCollectionsDocuments(
+                    opCtx.get(), *changeCollection, currentWallTime - Seconds(expiredAfterSeconds));
+            }
+
+            // Early exit if running on a secondary (requires
             // opCtx->lockState()->isRSTLLocked()).
-            if (!changeCollection ||
-                !repl::ReplicationCoordinator::get(opCtx.get())
+            if (!repl::ReplicationCoordinator::get(opCtx.get())
                      ->canAcceptWritesForDatabase(opCtx.get(), NamespaceString::kConfigDb)) {
                 continue;
             }
@@ -39,16 +39,19 @@
 #include "mongo/db/catalog/drop_collection.h"
 #include "mongo/db/catalog_raii.h"
 #include "mongo/db/change_stream_serverless_helpers.h"
+#include "mongo/db/change_streams_cluster_parameter_gen.h"
 #include "mongo/db/concurrency/exception_util.h"
 #include "mongo/db/multitenancy_gen.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/db/record_id_helpers.h"
 #include "mongo/db/repl/apply_ops_command_info.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/oplog_entry_gen.h"
 #include "mongo/db/server_feature_flags_gen.h"
 #include "mongo/db/server_options.h"
 #include "mongo/logv2/log.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -68,6 +71,55 @@ BSONObj createChangeCollectionEntryFromOplog(const BSONObj& oplogEntry) {
     return readyChangeCollDoc.toBson();
 }
 
+Date_t getWallTime(const BSONObj& changeCollDoc) {
+    return changeCollDoc[repl::OplogEntry::kWallClockTimeFieldName].Date();
+}
+
+/**
+ * Computes the initial truncate markers of a change collection, by scanning it or, if it is large
+ * enough, from random samples of it.
+ */
+CollectionTruncateMarkers::InitialSetOfMarkers computeInitialTruncateMarkers(
+    OperationContext* opCtx, RecordStore* rs, int64_t minBytesPerMarker) {
+    const auto numRecords = rs->numRecords(opCtx);
+    const auto dataSize = rs->dataSize(opCtx);
+    if (!CollectionTruncateMarkers::shouldSample(numRecords, dataSize, minBytesPerMarker)) {
+        auto cursor = rs->getCursor(opCtx, true /* forward */);
+        return CollectionTruncateMarkers::createMarkersByScanning(
+            [&] { return cursor->next(); },
+            minBytesPerMarker,
+            [](const Record& record) { return getWallTime(record.data.toBson()); });
+    }
+
+    const double avgRecordSize = double(dataSize) / numRecords;
+    const int64_t estRecordsPerMarker = std::ceil(minBytesPerMarker / avgRecordSize);
+    const int64_t estBytesPerMarker = estRecordsPerMarker * avgRecordSize;
+    const int64_t numSamples =
+        CollectionTruncateMarkers::kRandomSamplesPerMarker * numRecords / estRecordsPerMarker;
+
+    std::vector<CollectionTruncateMarkers::RecordIdAndWallTime> samples;
+    auto randomCursor = rs->getRandomCursor(opCtx);
+    for (int64_t i = 0; i < numSamples; ++i) {
+        auto record = randomCursor->next();
+        if (!record) {
+            // The collection was emptied while it was being sampled.
+            break;
+        }
+        samples.push_back({record->id, getWallTime(record->data.toBson())});
+    }
+    std::sort(samples.begin(), samples.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.id < rhs.id;
+    });
+
+    auto initialSet = CollectionTruncateMarkers::createMarkersFromSortedSamples(
+        samples, estRecordsPerMarker, estBytesPerMarker);
+    if (auto lastRecord = rs->getCursor(opCtx, false /* forward */)->next()) {
+        initialSet.leftoverHighestRecordId = lastRecord->id;
+        initialSet.leftoverHighestWallTime = getWallTime(lastRecord->data.toBson());
+    }
+    return initialSet;
+}
+
 /**
  * Helper to write insert statements to respective change collections based on tenant ids.
  */
@@ -117,6 +169,11 @@ public:
                                             << tenantChangeCollection->ns().toStringWithTenantId()
                                             << "failed, reason: " << status.reason());
             }
+
+            if (ChangeStreamChangeCollectionManager::isTruncationEnabled()) {
+                ChangeStreamChangeCollectionManager::get(opCtx).onInsertsToChangeCollection(
+                    opCtx, tenantChangeCollection->uuid(), insertStatements);
+            }
         }
 
         return Status::OK();
@@ -249,6 +306,8 @@ void ChangeStreamChangeCollectionManager::dropChangeCollection(OperationContext*
                                                                const TenantId& tenantId) {
     DropReply dropReply;
     const auto changeCollNss = NamespaceString::makeChangeCollectionNSS(tenantId);
+    const auto changeCollUUID =
+        CollectionCatalog::get(opCtx)->lookupUUIDByNSS(opCtx, changeCollNss);
 
     const auto status =
         dropCollection(opCtx,
@@ -259,6 +318,11 @@ void ChangeStreamChangeCollectionManager::dropChangeCollection(OperationContext*
             str::stream() << "Failed to drop change collection: "
                           << changeCollNss.toStringWithTenantId() << causedBy(status.reason()),
             status.isOK() || status.code() == ErrorCodes::NamespaceNotFound);
+
+    if (changeCollUUID) {
+        stdx::lock_guard<Latch> lk(_truncateMarkersMutex);
+        _truncateMarkersByCollection.erase(*changeCollUUID);
+    }
 }
 
 void ChangeStreamChangeCollectionManager::insertDocumentsToChangeCollection(
@@ -400,4 +464,114 @@ size_t ChangeStreamChangeCollectionManager::removeExpiredChangeCollectionsDocume
         return 0;
     }
 }
+
+bool ChangeStreamChangeCollectionManager::isTruncationEnabled() {
+    return gUseTruncationForExpiredChangeCollectionDocumentsRemoval;
+}
+
+void ChangeStreamChangeCollectionManager::onInsertsToChangeCollection(
+    OperationContext* opCtx,
+    const UUID& changeCollectionUUID,
+    const std::vector<InsertStatement>& insertStatements) {
+    int64_t bytesInserted = 0;
+    RecordId highestRecordId;
+    Date_t highestWallTime;
+    for (const auto& insertStatement : insertStatements) {
+        bytesInserted += insertStatement.doc.objsize();
+        highestRecordId = std::max(highestRecordId,
+                                   record_id_helpers::keyForElem(insertStatement.doc["_id"]));
+        highestWallTime = std::max(highestWallTime, getWallTime(insertStatement.doc));
+    }
+
+    opCtx->recoveryUnit()->onCommit([this,
+                                     changeCollectionUUID,
+                                     bytesInserted,
+                                     highestRecordId,
+                                     highestWallTime,
+                                     countInserted = int64_t(insertStatements.size())](
+                                        boost::optional<Timestamp>) {
+        std::shared_ptr<CollectionTruncateMarkers> markers;
+        {
+            stdx::lock_guard<Latch> lk(_truncateMarkersMutex);
+            auto it = _truncateMarkersByCollection.find(changeCollectionUUID);
+            if (it == _truncateMarkersByCollection.end()) {
+                // The markers have not been computed yet; computing them will count these
+                // documents.
+                return;
+            }
+            markers = it->second;
+        }
+        markers->updateCurrentMarker(
+            bytesInserted, highestRecordId, highestWallTime, countInserted);
+    });
+}
+
+std::shared_ptr<CollectionTruncateMarkers>
+ChangeStreamChangeCollectionManager::_getOrInitializeTruncateMarkers(
+    OperationContext* opCtx, const CollectionPtr& changeCollection) {
+    const auto collectionUUID = changeCollection->uuid();
+    const auto minBytesPerMarker = gChangeCollectionTruncateMarkersMinBytes.load();
+    auto markers = std::make_shared<CollectionTruncateMarkers>(
+        CollectionTruncateMarkers::InitialSetOfMarkers{}, minBytesPerMarker);
+    {
+        stdx::lock_guard<Latch> lk(_truncateMarkersMutex);
+        auto [it, inserted] = _truncateMarkersByCollection.emplace(collectionUUID, markers);
+        if (!inserted) {
+            return it->second;
+        }
+    }
+    ScopeGuard unpublishOnFailure([&] {
+        stdx::lock_guard<Latch> lk(_truncateMarkersMutex);
+        _truncateMarkersByCollection.erase(collectionUUID);
+    });
+
+    markers->prependInitialMarkers(computeInitialTruncateMarkers(
+        opCtx, changeCollection->getRecordStore(), minBytesPerMarker));
+    unpublishOnFailure.dismiss();
+    return markers;
+}
+
+size_t ChangeStreamChangeCollectionManager::truncateExpiredChangeCollectionsDocuments(
+    OperationContext* opCtx, const CollectionPtr& changeCollection, Date_t expirationTime) {
+    auto markers = _getOrInitializeTruncateMarkers(opCtx, changeCollection);
+    const auto expired = markers->peekExpiredMarkers(
+        [&](const CollectionTruncateMarkers::Marker& marker) {
+            return marker.wallTime <= expirationTime;
+        });
+    if (!expired) {
+        return 0;
+    }
+
+    // Keep the most recent document, as the batched delete does.
+    auto rs = changeCollection->getRecordStore();
+    RecordId maxRecordId = expired->lastRecord;
+    {
+        auto cursor = rs->getCursor(opCtx, false /* forward */);
+        auto lastRecord = cursor->next();
+        if (lastRecord && maxRecordId >= lastRecord->id) {
+            auto previousRecord = cursor->next();
+            if (!previousRecord) {
+                return 0;
+            }
+            maxRecordId = previousRecord->id;
+        }
+    }
+
+    const auto bytesRemoved = std::min(expired->bytes, rs->dataSize(opCtx));
+    const auto docsRemoved = std::min(expired->records, rs->numRecords(opCtx));
+    writeConflictRetry(
+        opCtx, "truncateExpiredChangeCollectionsDocuments", changeCollection->ns().ns(), [&] {
+            // The truncate is local to this node and is not timestamped.
+            opCtx->recoveryUnit()->allowUntimestampedWrite();
+            WriteUnitOfWork wuow(opCtx);
+            uassertStatusOK(
+                rs->rangeTruncate(opCtx, RecordId(), maxRecordId, -bytesRemoved, -docsRemoved));
+            wuow.commit();
+        });
+    markers->popOldestMarkers(expired->lastRecord);
+
+    _purgingJobStats.docsDeleted.fetchAndAddRelaxed(docsRemoved);
+    _purgingJobStats.bytesDeleted.fetchAndAddRelaxed(bytesRemoved);
+    return docsRemoved;
+}
 }  // namespace mongo
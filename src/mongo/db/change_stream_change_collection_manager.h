@@ -33,6 +33,9 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/collection_truncate_markers.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/unordered_map.h"
 
 namespace mongo {
 
@@ -174,8 +177,49 @@ public:
                                                           RecordIdBound maxRecordIdBound,
                                                           Date_t expirationTime);
 
+    /**
+     * Returns true if whole ranges of expired change collection documents are truncated before the
+     * remaining expired documents are deleted.
+     */
+    static bool isTruncationEnabled();
+
+    /**
+     * Accounts for the documents inserted by 'insertStatements' in the truncate markers of the
+     * change collection 'changeCollectionUUID' once the current unit of work commits.
+     */
+    void onInsertsToChangeCollection(OperationContext* opCtx,
+                                     const UUID& changeCollectionUUID,
+                                     const std::vector<InsertStatement>& insertStatements);
+
+    /**
+     * Truncates the whole truncate markers of the change collection whose documents all have a
+     * wall time less than or equal to 'expirationTime', always keeping the most recent document.
+     * Returns the approximate number of documents removed. The truncate is not replicated, so it
+     * runs on every node; the documents left over are removed by
+     * removeExpiredChangeCollectionsDocuments() on the primary.
+     */
+    size_t truncateExpiredChangeCollectionsDocuments(OperationContext* opCtx,
+                                                     const CollectionPtr& changeCollection,
+                                                     Date_t expirationTime);
+
 private:
+    /**
+     * Returns the truncate markers of 'changeCollection', computing them if this is the first
+     * truncate of the collection.
+     */
+    std::shared_ptr<CollectionTruncateMarkers> _getOrInitializeTruncateMarkers(
+        OperationContext* opCtx, const CollectionPtr& changeCollection);
+
     // Change collections purging job stats.
     PurgingJobStats _purgingJobStats;
+
+    Mutex _truncateMarkersMutex =
+        MONGO_MAKE_LATCH("ChangeStreamChangeCollectionManager::_truncateMarkersMutex");
+
+    // The truncate markers of each change collection, by collection UUID. The markers of a
+    // change collection are published before they are computed, so that the documents inserted
+    // while they are being computed are accounted for.
+    stdx::unordered_map<UUID, std::shared_ptr<CollectionTruncateMarkers>, UUID::Hash>
+        _truncateMarkersByCollection;
 };
 }  // namespace mongo
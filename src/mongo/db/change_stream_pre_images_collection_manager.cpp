@@ -31,11 +31,13 @@
 
 #include "mongo/base/error_codes.h"
 #include "mongo/db/catalog/clustered_collection_util.h"
+#include "mongo/db/catalog/collection_catalog.h"
 #include "mongo/db/catalog/collection_write_path.h"
 #include "mongo/db/catalog/create_collection.h"
 #include "mongo/db/catalog/drop_collection.h"
 #include "mongo/db/catalog_raii.h"
 #include "mongo/db/change_stream_options_manager.h"
+#include "mongo/db/change_stream_pre_images_truncate_manager.h"
 #include "mongo/db/change_stream_serverless_helpers.h"
 #include "mongo/db/concurrency/exception_util.h"
 #include "mongo/db/concurrency/lock_manager_defs.h"
@@ -117,6 +119,8 @@ void ChangeStreamPreImagesCollectionManager::dropPreImagesCollection(
     OperationContext* opCtx, boost::optional<TenantId> tenantId) {
     const auto preImagesCollectionNamespace = NamespaceString::makePreImageCollectionNSS(
         change_stream_serverless_helpers::resolveTenantId(tenantId));
+    const auto preImagesCollectionUUID =
+        CollectionCatalog::get(opCtx)->lookupUUIDByNSS(opCtx, preImagesCollectionNamespace);
     DropReply dropReply;
     const auto status =
         dropCollection(opCtx,
@@ -128,6 +132,10 @@ void ChangeStreamPreImagesCollectionManager::dropPreImagesCollection(
                           << preImagesCollectionNamespace.toStringWithTenantId()
                           << causedBy(status.reason()),
             status.isOK() || status.code() == ErrorCodes::NamespaceNotFound);
+
+    if (preImagesCollectionUUID) {
+        PreImagesTruncateManager::get(opCtx).dropMarkers(*preImagesCollectionUUID);
+    }
 }
 
 void ChangeStreamPreImagesCollectionManager::insertPreImage(OperationContext* opCtx,
@@ -155,10 +163,11 @@ void ChangeStreamPreImagesCollectionManager::insertPreImage(OperationContext* op
             "The change stream pre-images collection is not present",
             changeStreamPreImagesCollection);
 
+    const auto preImageDoc = preImage.toBSON();
     const auto insertionStatus =
         collection_internal::insertDocument(opCtx,
                                             changeStreamPreImagesCollection,
-                                            InsertStatement{preImage.toBSON()},
+                                            InsertStatement{preImageDoc},
                                             &CurOp::get(opCtx)->debug());
     tassert(5868601,
             str::stream() << "Attempted to insert a duplicate document into the pre-images "
@@ -166,6 +175,11 @@ void ChangeStreamPreImagesCollectionManager::insertPreImage(OperationContext* op
                           << preImage.getId().toBSON().toString(),
             insertionStatus != ErrorCodes::DuplicateKey);
     uassertStatusOK(insertionStatus);
+
+    if (PreImagesTruncateManager::isEnabled()) {
+        PreImagesTruncateManager::get(opCtx).onInsert(
+            opCtx, changeStreamPreImagesCollection->uuid(), preImage, preImageDoc.objsize());
+    }
 }
 
 namespace {
@@ -280,10 +294,13 @@ size_t deleteExpiredChangeStreamPreImages(OperationContext* opCtx,
     AutoGetCollection preImageColl(
         opCtx, NamespaceString::makePreImageCollectionNSS(boost::none), MODE_IX);
 
-    // Early exit if the collection doesn't exist or running on a secondary.
+    // Early exit if the collection doesn't exist or running on a secondary. Truncates are local
+    // to each node, so they also run on secondaries.
+    const bool useTruncation = PreImagesTruncateManager::isEnabled();
     if (!preImageColl ||
-        !repl::ReplicationCoordinator::get(opCtx)->canAcceptWritesForDatabase(
-            opCtx, NamespaceString::kConfigDb)) {
+        (!useTruncation &&
+         !repl::ReplicationCoordinator::get(opCtx)->canAcceptWritesForDatabase(
+             opCtx, NamespaceString::kConfigDb))) {
         return 0;
     }
 
@@ -294,6 +311,11 @@ size_t deleteExpiredChangeStreamPreImages(OperationContext* opCtx,
     const auto preImageExpirationTime = change_stream_pre_image_helpers::getPreImageExpirationTime(
         opCtx, currentTimeForTimeBasedExpiration);
 
+    if (useTruncation) {
+        return PreImagesTruncateManager::get(opCtx).truncateExpiredPreImages(
+            opCtx, *preImageColl, currentEarliestOplogEntryTs, preImageExpirationTime);
+    }
+
     // Configure the filter for the case when expiration parameter is set.
     if (preImageExpirationTime) {
         OrMatchExpression filter;
@@ -327,14 +349,25 @@ size_t deleteExpiredChangeStreamPreImagesForTenants(OperationContext* opCtx,
                                        change_stream_serverless_helpers::resolveTenantId(tenantId)),
                                    MODE_IX);
 
-    // Early exit if the collection doesn't exist or running on a secondary.
+    // Early exit if the collection doesn't exist or running on a secondary. Truncates are local
+    // to each node, so they also run on secondaries.
+    const bool useTruncation = PreImagesTruncateManager::isEnabled();
     if (!preImageColl ||
-        !repl::ReplicationCoordinator::get(opCtx)->canAcceptWritesForDatabase(
-            opCtx, NamespaceString::kConfigDb)) {
+        (!useTruncation &&
+         !repl::ReplicationCoordinator::get(opCtx)->canAcceptWritesForDatabase(
+             opCtx, NamespaceString::kConfigDb))) {
         return 0;
     }
 
     auto expiredAfterSeconds = change_stream_serverless_helpers::getExpireAfterSeconds(tenantId);
+    if (useTruncation) {
+        return PreImagesTruncateManager::get(opCtx).truncateExpiredPreImages(
+            opCtx,
+            *preImageColl,
+            boost::none /* earliestOplogEntryTs */,
+            currentTimeForTimeBasedExpiration - Seconds(expiredAfterSeconds));
+    }
+
     LTEMatchExpression filter{
         "operationTime"_sd,
         Value(currentTimeForTimeBasedExpiration - Seconds(expiredAfterSeconds))};
@@ -0,0 +1,294 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/db/change_stream_pre_images_truncate_manager.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/db/concurrency/exception_util.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/record_id_helpers.h"
+#include "mongo/logv2/log.h"
+#include "mongo/util/scopeguard.h"
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kQuery
+
+namespace mongo {
+namespace {
+
+const auto getPreImagesTruncateManager =
+    ServiceContext::declareDecoration<PreImagesTruncateManager>();
+
+using InitialSetsByNsUUID =
+    stdx::unordered_map<UUID, CollectionTruncateMarkers::InitialSetOfMarkers, UUID::Hash>;
+
+RecordId toRecordId(ChangeStreamPreImageId id) {
+    return record_id_helpers::keyForElem(
+        BSON(ChangeStreamPreImage::kIdFieldName << id.toBSON()).firstElement());
+}
+
+RecordId minRecordIdForNsUUID(const UUID& nsUUID) {
+    return toRecordId(ChangeStreamPreImageId(nsUUID, Timestamp(), 0));
+}
+
+RecordId maxRecordIdForNsUUID(const UUID& nsUUID) {
+    return toRecordId(
+        ChangeStreamPreImageId(nsUUID, Timestamp::max(), std::numeric_limits<int64_t>::max()));
+}
+
+UUID getNsUUID(const Record& record) {
+    const auto idObj = record.data.toBson()[ChangeStreamPreImage::kIdFieldName].Obj();
+    return uassertStatusOK(UUID::parse(idObj[ChangeStreamPreImageId::kNsUUIDFieldName]));
+}
+
+Date_t getOperationTime(const Record& record) {
+    return record.data.toBson()[ChangeStreamPreImage::kOperationTimeFieldName].Date();
+}
+
+/**
+ * Computes the initial markers of every 'nsUUID' by scanning the whole pre-images collection.
+ */
+InitialSetsByNsUUID scanPreImages(OperationContext* opCtx,
+                                  RecordStore* rs,
+                                  int64_t minBytesPerMarker) {
+    InitialSetsByNsUUID initialSets;
+    auto cursor = rs->getCursor(opCtx, true /* forward */);
+    auto record = cursor->next();
+    while (record) {
+        const auto nsUUID = getNsUUID(*record);
+        auto nextPreImageOfNsUUID = [&]() -> boost::optional<Record> {
+            if (!record || getNsUUID(*record) != nsUUID) {
+                return boost::none;
+            }
+            auto current = std::move(record);
+            current->data.makeOwned();
+            record = cursor->next();
+            return current;
+        };
+        initialSets.emplace(nsUUID,
+                            CollectionTruncateMarkers::createMarkersByScanning(
+                                nextPreImageOfNsUUID, minBytesPerMarker, getOperationTime));
+    }
+    return initialSets;
+}
+
+/**
+ * Computes the initial markers of every 'nsUUID' from random samples of the pre-images collection.
+ * The 'nsUUID' values, and the last pre-image of each of them, are found with a skip scan, since a
+ * collection with few pre-images may not be sampled at all.
+ */
+InitialSetsByNsUUID samplePreImages(OperationContext* opCtx,
+                                    RecordStore* rs,
+                                    int64_t minBytesPerMarker) {
+    const auto numRecords = rs->numRecords(opCtx);
+    const double avgRecordSize = double(rs->dataSize(opCtx)) / numRecords;
+    const int64_t estRecordsPerMarker = std::ceil(minBytesPerMarker / avgRecordSize);
+    const int64_t estBytesPerMarker = estRecordsPerMarker * avgRecordSize;
+    const int64_t numSamples =
+        CollectionTruncateMarkers::kRandomSamplesPerMarker * numRecords / estRecordsPerMarker;
+
+    using Samples = std::vector<CollectionTruncateMarkers::RecordIdAndWallTime>;
+    stdx::unordered_map<UUID, Samples, UUID::Hash> samplesByNsUUID;
+    auto randomCursor = rs->getRandomCursor(opCtx);
+    for (int64_t i = 0; i < numSamples; ++i) {
+        auto record = randomCursor->next();
+        if (!record) {
+            // The collection was emptied while it was being sampled.
+            break;
+        }
+        samplesByNsUUID[getNsUUID(*record)].push_back({record->id, getOperationTime(*record)});
+    }
+
+    InitialSetsByNsUUID initialSets;
+    auto cursor = rs->getCursor(opCtx, true /* forward */);
+    for (auto record = cursor->next(); record; record = cursor->next()) {
+        const auto nsUUID = getNsUUID(*record);
+
+        // The 'nsUUID' has at least one pre-image, so this is its last one.
+        const auto lastRecord = cursor->seekNear(maxRecordIdForNsUUID(nsUUID));
+        invariant(lastRecord && lastRecord->id >= minRecordIdForNsUUID(nsUUID));
+
+        auto& samples = samplesByNsUUID[nsUUID];
+        std::sort(samples.begin(), samples.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.id < rhs.id;
+        });
+        auto initialSet = CollectionTruncateMarkers::createMarkersFromSortedSamples(
+            samples, estRecordsPerMarker, estBytesPerMarker);
+        initialSet.leftoverHighestRecordId = lastRecord->id;
+        initialSet.leftoverHighestWallTime = getOperationTime(*lastRecord);
+        initialSets.emplace(nsUUID, std::move(initialSet));
+    }
+    return initialSets;
+}
+}  // namespace
+
+PreImagesTruncateManager& PreImagesTruncateManager::get(ServiceContext* service) {
+    return getPreImagesTruncateManager(service);
+}
+
+PreImagesTruncateManager& PreImagesTruncateManager::get(OperationContext* opCtx) {
+    return get(opCtx->getServiceContext());
+}
+
+bool PreImagesTruncateManager::isEnabled() {
+    return gUseTruncationForExpiredPreImagesRemoval;
+}
+
+std::shared_ptr<CollectionTruncateMarkers> PreImagesTruncateManager::CollectionMarkers::getOrCreate(
+    const UUID& nsUUID, int64_t minBytesPerMarker) {
+    stdx::lock_guard<Latch> lk(mutex);
+    auto& markers = markersByNsUUID[nsUUID];
+    if (!markers) {
+        markers = std::make_shared<CollectionTruncateMarkers>(
+            CollectionTruncateMarkers::InitialSetOfMarkers{}, minBytesPerMarker);
+    }
+    return markers;
+}
+
+void PreImagesTruncateManager::onInsert(OperationContext* opCtx,
+                                        const UUID& preImagesCollectionUUID,
+                                        const ChangeStreamPreImage& preImage,
+                                        int64_t bytes) {
+    opCtx->recoveryUnit()->onCommit(
+        [this,
+         preImagesCollectionUUID,
+         nsUUID = preImage.getId().getNsUUID(),
+         recordId = toRecordId(preImage.getId()),
+         operationTime = preImage.getOperationTime(),
+         bytes](boost::optional<Timestamp>) {
+            std::shared_ptr<CollectionMarkers> collectionMarkers;
+            {
+                stdx::lock_guard<Latch> lk(_mutex);
+                auto it = _markersByCollection.find(preImagesCollectionUUID);
+                if (it == _markersByCollection.end()) {
+                    return;
+                }
+                collectionMarkers = it->second;
+            }
+            collectionMarkers
+                ->getOrCreate(nsUUID, gPreImagesCollectionTruncateMarkersMinBytes.load())
+                ->updateCurrentMarker(bytes, recordId, operationTime, 1);
+        });
+}
+
+std::shared_ptr<PreImagesTruncateManager::CollectionMarkers>
+PreImagesTruncateManager::_getOrInitializeMarkers(OperationContext* opCtx,
+                                                  const CollectionPtr& preImagesCollection) {
+    const auto collectionUUID = preImagesCollection->uuid();
+    auto collectionMarkers = std::make_shared<CollectionMarkers>();
+    {
+        // Publish the markers before computing them, so that the pre-images inserted from now on
+        // are accounted for by onInsert().
+        stdx::lock_guard<Latch> lk(_mutex);
+        auto [it, inserted] = _markersByCollection.emplace(collectionUUID, collectionMarkers);
+        if (!inserted) {
+            return it->second;
+        }
+    }
+    ScopeGuard unpublishOnFailure([&] { dropMarkers(collectionUUID); });
+
+    const auto startTime = Date_t::now();
+    const auto minBytesPerMarker = gPreImagesCollectionTruncateMarkersMinBytes.load();
+    auto rs = preImagesCollection->getRecordStore();
+    const bool sampled = CollectionTruncateMarkers::shouldSample(
+        rs->numRecords(opCtx), rs->dataSize(opCtx), minBytesPerMarker);
+    auto initialSets = sampled ? samplePreImages(opCtx, rs, minBytesPerMarker)
+                               : scanPreImages(opCtx, rs, minBytesPerMarker);
+    for (auto&& [nsUUID, initialSet] : initialSets) {
+        collectionMarkers->getOrCreate(nsUUID, minBytesPerMarker)
+            ->prependInitialMarkers(std::move(initialSet));
+    }
+    unpublishOnFailure.dismiss();
+
+    LOGV2(7095757,
+          "Computed the truncate markers of the pre-images collection",
+          logAttrs(preImagesCollection->ns()),
+          "uuid"_attr = collectionUUID,
+          "numNsUUIDs"_attr = initialSets.size(),
+          "sampled"_attr = sampled,
+          "duration"_attr = Date_t::now() - startTime);
+    return collectionMarkers;
+}
+
+size_t PreImagesTruncateManager::truncateExpiredPreImages(
+    OperationContext* opCtx,
+    const CollectionPtr& preImagesCollection,
+    boost::optional<Timestamp> earliestOplogEntryTs,
+    boost::optional<Date_t> expirationTime) {
+    auto collectionMarkers = _getOrInitializeMarkers(opCtx, preImagesCollection);
+    MarkersByNsUUID markersByNsUUID;
+    {
+        stdx::lock_guard<Latch> lk(collectionMarkers->mutex);
+        markersByNsUUID = collectionMarkers->markersByNsUUID;
+    }
+
+    auto rs = preImagesCollection->getRecordStore();
+    size_t numberOfRemovals = 0;
+    for (const auto& [nsUUID, markers] : markersByNsUUID) {
+        boost::optional<RecordId> earliestRecordId;
+        if (earliestOplogEntryTs) {
+            earliestRecordId = toRecordId(ChangeStreamPreImageId(nsUUID, *earliestOplogEntryTs, 0));
+        }
+        auto isExpired = [&](const CollectionTruncateMarkers::Marker& marker) {
+            return (earliestRecordId && marker.lastRecord < *earliestRecordId) ||
+                (expirationTime && marker.wallTime <= *expirationTime);
+        };
+
+        markers->createPartialMarkerIfExpired(isExpired);
+        const auto expired = markers->peekExpiredMarkers(isExpired);
+        if (!expired) {
+            continue;
+        }
+
+        writeConflictRetry(
+            opCtx, "truncateExpiredPreImages", preImagesCollection->ns().ns(), [&] {
+                // The truncate is local to this node and is not timestamped.
+                opCtx->recoveryUnit()->allowUntimestampedWrite();
+                WriteUnitOfWork wuow(opCtx);
+                uassertStatusOK(rs->rangeTruncate(
+                    opCtx,
+                    minRecordIdForNsUUID(nsUUID),
+                    expired->lastRecord,
+                    -std::min(expired->bytes, rs->dataSize(opCtx)),
+                    -std::min(expired->records, rs->numRecords(opCtx))));
+                wuow.commit();
+            });
+        markers->popOldestMarkers(expired->lastRecord);
+        numberOfRemovals += expired->records;
+    }
+    return numberOfRemovals;
+}
+
+void PreImagesTruncateManager::dropMarkers(const UUID& preImagesCollectionUUID) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _markersByCollection.erase(preImagesCollectionUUID);
+}
+
+}  // namespace mongo
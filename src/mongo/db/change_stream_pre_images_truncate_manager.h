@@ -0,0 +1,118 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional/optional.hpp>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/pipeline/change_stream_preimage_gen.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/collection_truncate_markers.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/uuid.h"
+
+namespace mongo {
+
+/**
+ * Removes expired pre-images by truncating whole ranges of a pre-images collection instead of
+ * deleting the pre-images one by one. Pre-images are clustered by 'nsUUID' first, so the ranges are
+ * tracked separately for each 'nsUUID' with CollectionTruncateMarkers. The markers of a pre-images
+ * collection are computed on the first removal pass over it and then maintained as pre-images are
+ * inserted.
+ *
+ * Truncates are neither replicated nor timestamped, so every node, primary or secondary, removes
+ * its own expired pre-images.
+ */
+class PreImagesTruncateManager {
+public:
+    static PreImagesTruncateManager& get(ServiceContext* service);
+    static PreImagesTruncateManager& get(OperationContext* opCtx);
+
+    /**
+     * Returns true if expired pre-images are removed with truncates rather than deletes.
+     */
+    static bool isEnabled();
+
+    /**
+     * Accounts for the pre-image 'preImage', of 'bytes' bytes, in the markers of the pre-images
+     * collection 'preImagesCollectionUUID' once the current unit of work commits. Does nothing if
+     * the markers of the collection have not been computed yet, since the computation will see
+     * the pre-image.
+     */
+    void onInsert(OperationContext* opCtx,
+                  const UUID& preImagesCollectionUUID,
+                  const ChangeStreamPreImage& preImage,
+                  int64_t bytes);
+
+    /**
+     * Truncates the expired pre-images from 'preImagesCollection' and returns the approximate
+     * number of pre-images removed. A pre-image has expired if its timestamp is less than
+     * 'earliestOplogEntryTs' or if its 'operationTime' is not after 'expirationTime', when either
+     * is provided.
+     */
+    size_t truncateExpiredPreImages(OperationContext* opCtx,
+                                    const CollectionPtr& preImagesCollection,
+                                    boost::optional<Timestamp> earliestOplogEntryTs,
+                                    boost::optional<Date_t> expirationTime);
+
+    /**
+     * Forgets the markers of the dropped pre-images collection 'preImagesCollectionUUID'.
+     */
+    void dropMarkers(const UUID& preImagesCollectionUUID);
+
+private:
+    using MarkersByNsUUID =
+        stdx::unordered_map<UUID, std::shared_ptr<CollectionTruncateMarkers>, UUID::Hash>;
+
+    // The markers of a single pre-images collection.
+    struct CollectionMarkers {
+        std::shared_ptr<CollectionTruncateMarkers> getOrCreate(const UUID& nsUUID,
+                                                               int64_t minBytesPerMarker);
+
+        Mutex mutex = MONGO_MAKE_LATCH("PreImagesTruncateManager::CollectionMarkers::mutex");
+        MarkersByNsUUID markersByNsUUID;
+    };
+
+    /**
+     * Returns the markers of 'preImagesCollection', computing them if this is the first pass over
+     * the collection.
+     */
+    std::shared_ptr<CollectionMarkers> _getOrInitializeMarkers(
+        OperationContext* opCtx, const CollectionPtr& preImagesCollection);
+
+    Mutex _mutex = MONGO_MAKE_LATCH("PreImagesTruncateManager::_mutex");
+
+    // The markers of every pre-images collection, by collection UUID.
+    stdx::unordered_map<UUID, std::shared_ptr<CollectionMarkers>, UUID::Hash> _markersByCollection;
+};
+
+}  // namespace mongo
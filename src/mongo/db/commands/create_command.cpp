@@ -257,6 +257,36 @@ public:
                             mustBeTopLevel("metaField"),
                             !hasDot(*metaField));
                 }
+
+                if (auto bloomFilterFields = timeseries->getBucketBloomFilterFields()) {
+                    uassert(ErrorCodes::InvalidOptions,
+                            "'bucketBloomFilterFields' requires per-bucket Bloom filters to be "
+                            "enabled",
+                            feature_flags::gTimeseriesBucketBloomFilters.isEnabled(
+                                serverGlobalParams.featureCompatibility));
+                    uassert(ErrorCodes::InvalidOptions,
+                            str::stream() << "'bucketBloomFilterFields' may contain at most "
+                                          << timeseries::kMaxBucketBloomFilterFields << " fields",
+                            bloomFilterFields->size() <=
+                                timeseries::kMaxBucketBloomFilterFields);
+
+                    StringDataSet seen;
+                    for (auto&& field : *bloomFilterFields) {
+                        uassert(ErrorCodes::InvalidOptions,
+                                mustBeTopLevel("bucketBloomFilterFields"),
+                                !field.empty() && !hasDot(field));
+                        uassert(ErrorCodes::InvalidOptions,
+                                "'bucketBloomFilterFields' cannot contain the timeField, the "
+                                "metaField or \"_id\"",
+                                field != timeseries->getTimeField() &&
+                                    field != timeseries->getMetaField().value_or(""_sd) &&
+                                    field != "_id");
+                        uassert(ErrorCodes::InvalidOptions,
+                                str::stream() << "'bucketBloomFilterFields' contains '" << field
+                                              << "' more than once",
+                                seen.insert(field).second);
+                    }
+                }
             }
 
             if (cmd.getExpireAfterSeconds()) {
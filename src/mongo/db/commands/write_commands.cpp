@@ -72,8 +72,10 @@
 #include "mongo/db/timeseries/bucket_catalog.h"
 #include "mongo/db/timeseries/bucket_catalog_helpers.h"
 #include "mongo/db/timeseries/bucket_compression.h"
+#include "mongo/db/timeseries/bucket_compression_service.h"
 #include "mongo/db/timeseries/timeseries_constants.h"
 #include "mongo/db/timeseries/timeseries_extended_range.h"
+#include "mongo/db/timeseries/timeseries_gen.h"
 #include "mongo/db/timeseries/timeseries_index_schema_conversion_functions.h"
 #include "mongo/db/timeseries/timeseries_options.h"
 #include "mongo/db/timeseries/timeseries_stats.h"
@@ -162,9 +164,16 @@ write_ops::UpdateOpEntry makeTimeseriesUpdateOpEntry(
     const BSONObj& metadata) {
     BSONObjBuilder updateBuilder;
     {
-        if (!batch->min().isEmpty() || !batch->max().isEmpty()) {
+        if (!batch->min().isEmpty() || !batch->max().isEmpty() ||
+            !batch->bloomFilters().isEmpty()) {
             BSONObjBuilder controlBuilder(updateBuilder.subobjStart(
                 str::stream() << doc_diff::kSubDiffSectionFieldPrefix << "control"));
+            // The update section must precede the sub-diff sections.
+            if (!batch->bloomFilters().isEmpty()) {
+                controlBuilder.append(
+                    doc_diff::kUpdateSectionFieldName,
+                    BSON(timeseries::kBucketControlBloomFieldName << batch->bloomFilters()));
+            }
             if (!batch->min().isEmpty()) {
                 controlBuilder.append(
                     str::stream() << doc_diff::kSubDiffSectionFieldPrefix << "min", batch->min());
@@ -240,6 +249,150 @@ write_ops::UpdateOpEntry makeTimeseriesTransformationOpEntry(
     return update;
 }
 
+/**
+ * Returns an update request which rewrites the bucket 'bucketId' of the time-series collection
+ * 'ns' with 'transformationFunc'.
+ */
+write_ops::UpdateCommandRequest makeTimeseriesTransformationOp(
+    OperationContext* opCtx,
+    const NamespaceString& ns,
+    const OID& bucketId,
+    write_ops::UpdateModification::TransformFunc transformationFunc) {
+    write_ops::UpdateCommandRequest op(
+        makeTimeseriesBucketsNamespace(ns),
+        {makeTimeseriesTransformationOpEntry(opCtx, bucketId, std::move(transformationFunc))});
+
+    write_ops::WriteCommandRequestBase base;
+    // The schema validation configured in the bucket collection is intended for direct
+    // operations by end users and is not applicable here.
+    base.setBypassDocumentValidation(true);
+
+    // Timeseries compression operation is not a user operation and should not use a
+    // statement id from any user op. Set to Uninitialized to bypass.
+    base.setStmtIds(std::vector<StmtId>{kUninitializedStmtId});
+
+    op.setWriteCommandRequestBase(std::move(base));
+    return op;
+}
+
+/**
+ * Rewrites 'closedBucket' of the time-series collection 'ns' in compressed form and records the
+ * outcome in the bucket collection's TimeseriesStats.
+ */
+write_ops_exec::WriteResult performTimeseriesBucketCompression(
+    OperationContext* opCtx,
+    const NamespaceString& ns,
+    const BucketCatalog::ClosedBucket& closedBucket) {
+    bool validateCompression = gValidateTimeseriesCompression.load();
+
+    boost::optional<int> beforeSize;
+    TimeseriesStats::CompressedBucketInfo compressionStats;
+
+    auto bucketCompressionFunc = [&](const BSONObj& bucketDoc) -> boost::optional<BSONObj> {
+        beforeSize = bucketDoc.objsize();
+        // Reset every time we run to ensure we never use a stale value
+        compressionStats = {};
+        auto compressed = timeseries::compressBucket(bucketDoc,
+                                                     closedBucket.timeField,
+                                                     ns,
+                                                     closedBucket.eligibleForReopening,
+                                                     validateCompression);
+        if (compressed.compressedBucket) {
+            // If compressed object size is larger than uncompressed, skip compression
+            // update.
+            if (compressed.compressedBucket->objsize() >= *beforeSize) {
+                LOGV2_DEBUG(5857802,
+                            1,
+                            "Skipping time-series bucket compression, compressed object is "
+                            "larger than original",
+                            "originalSize"_attr = bucketDoc.objsize(),
+                            "compressedSize"_attr = compressed.compressedBucket->objsize());
+                return boost::none;
+            }
+
+            compressionStats.size = compressed.compressedBucket->objsize();
+            compressionStats.numInterleaveRestarts = compressed.numInterleavedRestarts;
+        } else if (compressed.decompressionFailed) {
+            compressionStats.decompressionFailed = true;
+        }
+
+        return compressed.compressedBucket;
+    };
+
+    auto compressionOp =
+        makeTimeseriesTransformationOp(opCtx, ns, closedBucket.bucketId, bucketCompressionFunc);
+    auto result = write_ops_exec::performUpdates(opCtx, compressionOp, OperationSource::kStandard);
+
+    // Report stats, if we fail before running the transform function then just skip
+    // reporting.
+    if (beforeSize) {
+        invariant(result.results.size() == 1);
+        compressionStats.result = result.results[0].getStatus();
+
+        // Report stats for the bucket collection
+        auto coll = CollectionCatalog::get(opCtx)->lookupCollectionByNamespaceForRead(
+            opCtx, compressionOp.getNamespace());
+        if (coll) {
+            const auto& stats = TimeseriesStats::get(coll.get());
+            stats.onBucketClosed(*beforeSize, compressionStats);
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Hands 'closedBucket' of the time-series collection 'ns' over to the BucketCompressionService.
+ * Returns false if it could not be queued, in which case the caller must compress it.
+ */
+bool scheduleTimeseriesBucketCompression(
+    OperationContext* opCtx,
+    const NamespaceString& ns,
+    const std::shared_ptr<BucketCatalog::ClosedBucket>& closedBucket) {
+    auto bucketsNs = makeTimeseriesBucketsNamespace(ns);
+    auto bucketsColl =
+        CollectionCatalog::get(opCtx)->lookupCollectionByNamespaceForRead(opCtx, bucketsNs);
+    if (!bucketsColl) {
+        return false;
+    }
+
+    // The rewrite runs under the versions the router attached to this insert, so that it fails
+    // with a stale version error rather than writing to a bucket this shard no longer owns. If the
+    // router did not version the bucket collection, compress inline as part of the insert.
+    auto& oss = OperationShardingState::get(opCtx);
+    auto shardVersion = oss.getShardVersion(bucketsNs);
+    auto dbVersion = oss.getDbVersion(bucketsNs.db());
+    if (OperationShardingState::isComingFromRouter(opCtx) && !shardVersion) {
+        return false;
+    }
+
+    // The job shares ownership of the ClosedBucket, which keeps the bucket from being reopened
+    // until it has been compressed.
+    TimeseriesStats::get(bucketsColl.get()).onBucketQueuedForCompression();
+    auto scheduled =
+        BucketCompressionService::get(opCtx->getServiceContext())
+            .schedule([ns, bucketsNs, closedBucket, shardVersion, dbVersion](
+                          OperationContext* opCtx, Milliseconds queuedFor) {
+                auto bucketsColl =
+                    CollectionCatalog::get(opCtx)->lookupCollectionByNamespaceForRead(opCtx,
+                                                                                      bucketsNs);
+                if (!bucketsColl) {
+                    return;
+                }
+                TimeseriesStats::get(bucketsColl.get()).onBucketDequeuedForCompression(queuedFor);
+
+                ScopedSetShardRole scopedSetShardRole(opCtx, bucketsNs, shardVersion, dbVersion);
+                auto result = performTimeseriesBucketCompression(opCtx, ns, *closedBucket);
+                if (!result.results.empty()) {
+                    uassertStatusOK(result.results[0].getStatus());
+                }
+            });
+    if (!scheduled) {
+        TimeseriesStats::get(bucketsColl.get()).onBucketDequeuedForCompression(boost::none);
+    }
+    return scheduled;
+}
+
 /**
  * Returns the document for inserting a new bucket.
  */
@@ -270,6 +423,9 @@ BSONObj makeTimeseriesInsertDocument(std::shared_ptr<BucketCatalog::WriteBatch>
                                     kTimeseriesControlDefaultVersion);
         bucketControlBuilder.append(kBucketControlMinFieldName, batch->min());
         bucketControlBuilder.append(kBucketControlMaxFieldName, batch->max());
+        if (!batch->bloomFilters().isEmpty()) {
+            bucketControlBuilder.append(kBucketControlBloomFieldName, batch->bloomFilters());
+        }
 
         if (feature_flags::gTimeseriesScalabilityImprovements.isEnabled(
                 serverGlobalParams.featureCompatibility)) {
@@ -653,28 +809,6 @@ public:
             return op;
         }
 
-        write_ops::UpdateCommandRequest _makeTimeseriesTransformationOp(
-            OperationContext* opCtx,
-            const OID& bucketId,
-            write_ops::UpdateModification::TransformFunc transformationFunc) const {
-            write_ops::UpdateCommandRequest op(
-                makeTimeseriesBucketsNamespace(ns()),
-                {makeTimeseriesTransformationOpEntry(
-                    opCtx, bucketId, std::move(transformationFunc))});
-
-            write_ops::WriteCommandRequestBase base;
-            // The schema validation configured in the bucket collection is intended for direct
-            // operations by end users and is not applicable here.
-            base.setBypassDocumentValidation(true);
-
-            // Timeseries compression operation is not a user operation and should not use a
-            // statement id from any user op. Set to Uninitialized to bypass.
-            base.setStmtIds(std::vector<StmtId>{kUninitializedStmtId});
-
-            op.setWriteCommandRequestBase(std::move(base));
-            return op;
-        }
-
         /**
          * Returns the status and whether the request can continue.
          */
@@ -709,7 +843,7 @@ public:
         }
 
         TimeseriesSingleWriteResult _performTimeseriesBucketCompression(
-            OperationContext* opCtx, const BucketCatalog::ClosedBucket& closedBucket) const {
+            OperationContext* opCtx, BucketCatalog::ClosedBucket closedBucket) const {
             if (!feature_flags::gTimeseriesBucketCompression.isEnabled(
                     serverGlobalParams.featureCompatibility)) {
                 return {SingleWriteResult(), true};
@@ -721,62 +855,17 @@ public:
                 return {SingleWriteResult(), true};
             }
 
-            bool validateCompression = gValidateTimeseriesCompression.load();
-
-            boost::optional<int> beforeSize;
-            TimeseriesStats::CompressedBucketInfo compressionStats;
-
-            auto bucketCompressionFunc = [&](const BSONObj& bucketDoc) -> boost::optional<BSONObj> {
-                beforeSize = bucketDoc.objsize();
-                // Reset every time we run to ensure we never use a stale value
-                compressionStats = {};
-                auto compressed = timeseries::compressBucket(bucketDoc,
-                                                             closedBucket.timeField,
-                                                             ns(),
-                                                             closedBucket.eligibleForReopening,
-                                                             validateCompression);
-                if (compressed.compressedBucket) {
-                    // If compressed object size is larger than uncompressed, skip compression
-                    // update.
-                    if (compressed.compressedBucket->objsize() >= *beforeSize) {
-                        LOGV2_DEBUG(5857802,
-                                    1,
-                                    "Skipping time-series bucket compression, compressed object is "
-                                    "larger than original",
-                                    "originalSize"_attr = bucketDoc.objsize(),
-                                    "compressedSize"_attr = compressed.compressedBucket->objsize());
-                        return boost::none;
-                    }
-
-                    compressionStats.size = compressed.compressedBucket->objsize();
-                    compressionStats.numInterleaveRestarts = compressed.numInterleavedRestarts;
-                } else if (compressed.decompressionFailed) {
-                    compressionStats.decompressionFailed = true;
-                }
-
-                return compressed.compressedBucket;
-            };
-
-            auto compressionOp = _makeTimeseriesTransformationOp(
-                opCtx, closedBucket.bucketId, bucketCompressionFunc);
-            auto result = _getTimeseriesSingleWriteResult(
-                write_ops_exec::performUpdates(opCtx, compressionOp, OperationSource::kStandard));
-
-            // Report stats, if we fail before running the transform function then just skip
-            // reporting.
-            if (beforeSize) {
-                compressionStats.result = result.result.getStatus();
-
-                // Report stats for the bucket collection
-                auto coll = CollectionCatalog::get(opCtx)->lookupCollectionByNamespaceForRead(
-                    opCtx, compressionOp.getNamespace());
-                if (coll) {
-                    const auto& stats = TimeseriesStats::get(coll.get());
-                    stats.onBucketClosed(*beforeSize, compressionStats);
-                }
+            // Leave the rewrite to the background pool if it has room, so that this insert does
+            // not pay for it.
+            auto sharedClosedBucket =
+                std::make_shared<BucketCatalog::ClosedBucket>(std::move(closedBucket));
+            if (gTimeseriesBackgroundBucketCompression.load() &&
+                scheduleTimeseriesBucketCompression(opCtx, ns(), sharedClosedBucket)) {
+                return {SingleWriteResult(), true};
             }
 
-            return result;
+            return _getTimeseriesSingleWriteResult(
+                performTimeseriesBucketCompression(opCtx, ns(), *sharedClosedBucket));
         }
 
         write_ops::UpdateCommandRequest _makeTimeseriesDecompressionOp(
@@ -787,8 +876,8 @@ public:
                 return timeseries::decompressBucket(bucketDoc);
             };
 
-            return _makeTimeseriesTransformationOp(
-                opCtx, batch->bucket().id, bucketDecompressionFunc);
+            return makeTimeseriesTransformationOp(
+                opCtx, ns(), batch->bucket().id, bucketDecompressionFunc);
         }
 
         /**
@@ -883,7 +972,8 @@ public:
 
             if (closedBucket) {
                 // If this write closed a bucket, compress the bucket
-                auto output = _performTimeseriesBucketCompression(opCtx, *closedBucket);
+                auto output =
+                    _performTimeseriesBucketCompression(opCtx, std::move(*closedBucket));
                 if (auto error =
                         generateError(opCtx, output.result, start + index, errors->size())) {
                     errors->emplace_back(std::move(*error));
@@ -984,7 +1074,8 @@ public:
                     }
 
                     // If this write closed a bucket, compress the bucket
-                    auto ret = _performTimeseriesBucketCompression(opCtx, *closedBucket);
+                    auto ret =
+                        _performTimeseriesBucketCompression(opCtx, std::move(*closedBucket));
                     if (!ret.result.isOK()) {
                         // Don't try to compress any other buckets if we fail. We're not allowed to
                         // do more write operations.
@@ -1225,7 +1316,7 @@ public:
                     return false;
                 }
 
-                const auto& insertResult = swResult.getValue();
+                auto& insertResult = swResult.getValue();
                 const auto& batch = insertResult.batch;
                 batches.emplace_back(batch, index);
                 if (isTimeseriesWriteRetryable(opCtx)) {
@@ -1234,13 +1325,14 @@ public:
 
                 // If this insert closed buckets, rewrite to be a compressed column. If we cannot
                 // perform write operations at this point the bucket will be left uncompressed.
-                for (const auto& closedBucket : insertResult.closedBuckets) {
+                for (auto& closedBucket : insertResult.closedBuckets) {
                     if (!canContinue) {
                         break;
                     }
 
                     // If this write closed a bucket, compress the bucket
-                    auto ret = _performTimeseriesBucketCompression(opCtx, closedBucket);
+                    auto ret =
+                        _performTimeseriesBucketCompression(opCtx, std::move(closedBucket));
                     if (auto error =
                             generateError(opCtx, ret.result, start + index, errors->size())) {
                         // Bucket compression only fail when we may not try to perform any other
@@ -144,9 +144,6 @@ BatchedDeleteStage::BatchedDeleteStage(
     tassert(6303800,
             "batched deletions only support multi-document deletions (multi: true)",
             _params->isMulti);
-    tassert(6303801,
-            "batched deletions do not support the 'fromMigrate' parameter",
-            !_params->fromMigrate);
     tassert(6303802,
             "batched deletions do not support the 'returnDelete' parameter",
             !_params->returnDeleted);
@@ -345,9 +342,12 @@ long long BatchedDeleteStage::_commitBatch(WorkingSetID* out,
         WorkingSetMember* member = _ws->get(workingSetMemberID);
 
         // Determine whether the document being deleted is owned by this shard, and the action
-        // to undertake if it isn't.
-        const auto action = docStillMatches ? _preWriteFilter.computeAction(member->doc.value())
-                                            : write_stage_common::PreWriteFilter::Action::kSkip;
+        // to undertake if it isn't. Deletes issued on behalf of a migration, such as the range
+        // deleter removing orphans, are already marked fromMigrate and must not be filtered.
+        const auto action = !docStillMatches
+            ? write_stage_common::PreWriteFilter::Action::kSkip
+            : _params->fromMigrate ? write_stage_common::PreWriteFilter::Action::kWrite
+                                   : _preWriteFilter.computeAction(member->doc.value());
         bool writeToOrphan = false;
         auto retryableWrite = write_stage_common::isRetryableWrite(opCtx());
         switch (action) {
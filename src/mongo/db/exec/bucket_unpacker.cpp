@@ -40,9 +40,11 @@
 #include "mongo/db/matcher/expression_internal_expr_comparison.h"
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/matcher/expression_tree.h"
+#include "mongo/db/matcher/expression_type.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
 #include "mongo/db/matcher/rewrite_expr.h"
 #include "mongo/db/pipeline/expression.h"
+#include "mongo/db/timeseries/bucket_bloom_filter.h"
 #include "mongo/db/timeseries/timeseries_options.h"
 
 namespace mongo {
@@ -131,6 +133,21 @@ std::unique_ptr<MatchExpression> makeOr(std::vector<std::unique_ptr<MatchExpress
     return std::make_unique<OrMatchExpression>(std::move(nontrivial));
 }
 
+/**
+ * Makes a predicate which is false only for buckets whose Bloom filter on 'matchExprPath' proves
+ * that no measurement in the bucket has a value equal to 'matchExprData'. Buckets without a usable
+ * filter, which store null or nothing at all in 'control.bloom.<field>', always match.
+ */
+std::unique_ptr<MatchExpression> makeBloomFilterPredicate(StringData matchExprPath,
+                                                          const BSONElement& matchExprData) {
+    auto bloomPath = std::string{timeseries::kControlBloomFieldNamePrefix} + matchExprPath;
+    return makeOr(makeVector<std::unique_ptr<MatchExpression>>(
+        std::make_unique<BitsAllSetMatchExpression>(
+            StringData(bloomPath), timeseries::BucketBloomFilter::bitPositions(matchExprData)),
+        std::make_unique<NotMatchExpression>(std::make_unique<TypeMatchExpression>(
+            StringData(bloomPath), MatcherTypeSet(BSONType::BinData)))));
+}
+
 BucketSpec::BucketPredicate handleIneligible(IneligiblePredicatePolicy policy,
                                              const MatchExpression* matchExpr,
                                              StringData message) {
@@ -310,13 +327,26 @@ std::unique_ptr<MatchExpression> createComparisonPredicate(
             //
             // The same procedure applies to aggregation expressions of the form
             // {$expr: {$eq: [...]}} that can be rewritten to use $_internalExprEq.
+            //
+            // If the buckets carry a Bloom filter on the field, additionally require that the
+            // filter may contain the value. Strings are only pruned this way under the simple
+            // collation, since the filter hashes the raw bytes.
             if (!isTimeField) {
-                return makeOr(makeVector<std::unique_ptr<MatchExpression>>(
+                auto minMaxPredicate = makeOr(makeVector<std::unique_ptr<MatchExpression>>(
                     makePredicate(MatchExprPredicate<InternalExprLTEMatchExpression>(
                                       minPathStringData, matchExprData),
                                   MatchExprPredicate<InternalExprGTEMatchExpression>(
                                       maxPathStringData, matchExprData)),
                     createTypeEqualityPredicate(pExpCtx, matchExprPath, assumeNoMixedSchemaData)));
+                if (bucketSpec.bloomFilterFields().count(matchExprPath.toString()) &&
+                    timeseries::BucketBloomFilter::canFilterOn(
+                        matchExprData, pExpCtx->getCollator() == nullptr)) {
+                    return std::make_unique<AndMatchExpression>(
+                        makeVector<std::unique_ptr<MatchExpression>>(
+                            std::move(minMaxPredicate),
+                            makeBloomFilterPredicate(matchExprPath, matchExprData)));
+                }
+                return minMaxPredicate;
             } else if (bucketSpec.usesExtendedRange()) {
                 return makePredicate(MatchExprPredicate<InternalExprLTEMatchExpression>(
                                          minPathStringData, matchExprData),
@@ -1255,7 +1285,8 @@ BucketSpec::BucketSpec(const BucketSpec& other)
       _timeField(other._timeField),
       _timeFieldHashed(HashedFieldName{_timeField, other._timeFieldHashed->hash()}),
       _metaField(other._metaField),
-      _usesExtendedRange(other._usesExtendedRange) {
+      _usesExtendedRange(other._usesExtendedRange),
+      _bloomFilterFields(other._bloomFilterFields) {
     if (_metaField) {
         _metaFieldHashed = HashedFieldName{*_metaField, other._metaFieldHashed->hash()};
     }
@@ -1267,7 +1298,8 @@ BucketSpec::BucketSpec(BucketSpec&& other)
       _timeField(std::move(other._timeField)),
       _timeFieldHashed(HashedFieldName{_timeField, other._timeFieldHashed->hash()}),
       _metaField(std::move(other._metaField)),
-      _usesExtendedRange(other._usesExtendedRange) {
+      _usesExtendedRange(other._usesExtendedRange),
+      _bloomFilterFields(std::move(other._bloomFilterFields)) {
     if (_metaField) {
         _metaFieldHashed = HashedFieldName{*_metaField, other._metaFieldHashed->hash()};
     }
@@ -1284,6 +1316,7 @@ BucketSpec& BucketSpec::operator=(const BucketSpec& other) {
             _metaFieldHashed = HashedFieldName{*_metaField, other._metaFieldHashed->hash()};
         }
         _usesExtendedRange = other._usesExtendedRange;
+        _bloomFilterFields = other._bloomFilterFields;
     }
     return *this;
 }
@@ -113,6 +113,15 @@ public:
         return _usesExtendedRange;
     }
 
+    // The measurement fields for which each bucket carries a Bloom filter in 'control.bloom'.
+    void setBloomFilterFields(std::set<std::string> fields) {
+        _bloomFilterFields = std::move(fields);
+    }
+
+    const std::set<std::string>& bloomFilterFields() const {
+        return _bloomFilterFields;
+    }
+
     // Returns whether 'field' depends on a pushed down $addFields or computed $project.
     bool fieldIsComputed(StringData field) const;
 
@@ -222,6 +231,8 @@ private:
     boost::optional<std::string> _metaField = boost::none;
     boost::optional<HashedFieldName> _metaFieldHashed = boost::none;
     bool _usesExtendedRange = false;
+
+    std::set<std::string> _bloomFilterFields;
 };
 
 /**
@@ -0,0 +1,203 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * This file contains tests for sbe::TsBucketUnpackStage.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/util/bsoncolumnbuilder.h"
+#include "mongo/db/exec/sbe/sbe_plan_stage_test.h"
+#include "mongo/db/exec/sbe/stages/ts_bucket_unpack.h"
+
+namespace mongo::sbe {
+namespace {
+Date_t makeTime(long long millis) {
+    return Date_t::fromMillisSinceEpoch(millis);
+}
+
+/**
+ * Builds a version 2 bucket whose data fields are compressed with BSONColumn. Undefined values in
+ * 'columns' are encoded as skipped (missing) measurements.
+ */
+BSONObj makeCompressedBucket(const BSONObj& meta,
+                             int count,
+                             const std::vector<std::pair<std::string, BSONArray>>& columns) {
+    BSONObjBuilder bucket;
+    bucket.append("control", BSON("version" << 2 << "count" << count));
+    bucket.append("meta", meta);
+    {
+        BSONObjBuilder data(bucket.subobjStart("data"));
+        for (auto&& [field, values] : columns) {
+            BSONColumnBuilder builder;
+            for (auto&& value : values) {
+                if (value.type() == BSONType::Undefined) {
+                    builder.skip();
+                } else {
+                    builder.append(value);
+                }
+            }
+            data.append(field, builder.finalize());
+        }
+    }
+    return bucket.obj();
+}
+}  // namespace
+
+class TsBucketUnpackStageTest : public PlanStageTestFixture {
+public:
+    /**
+     * Unpacks 'buckets' requesting 'fields' and returns one array per surviving measurement, with
+     * the meta value (if requested) appended after the field values.
+     */
+    std::pair<value::TypeTags, value::Value> unpack(
+        const BSONArray& buckets,
+        const std::vector<std::string>& fields,
+        bool includeMeta,
+        std::function<std::unique_ptr<EExpression>(const value::SlotVector&)> makeFilter = {}) {
+        auto [bucketSlot, scanStage] = generateVirtualScan(buckets);
+
+        value::SlotVector fieldSlots;
+        for (size_t idx = 0; idx < fields.size(); ++idx) {
+            fieldSlots.push_back(generateSlotId());
+        }
+        boost::optional<value::SlotId> metaSlot;
+        if (includeMeta) {
+            metaSlot = generateSlotId();
+        }
+
+        auto stage = makeS<TsBucketUnpackStage>(std::move(scanStage),
+                                                bucketSlot,
+                                                "time",
+                                                fields,
+                                                fieldSlots,
+                                                metaSlot,
+                                                makeFilter ? makeFilter(fieldSlots) : nullptr,
+                                                kEmptyPlanNodeId);
+
+        auto outputSlots = fieldSlots;
+        if (metaSlot) {
+            outputSlots.push_back(*metaSlot);
+        }
+
+        auto ctx = makeCompileCtx();
+        auto accessors = prepareTree(ctx.get(), stage.get(), outputSlots);
+        return getAllResultsMulti(stage.get(), accessors);
+    }
+
+    void assertResultsEqual(std::pair<value::TypeTags, value::Value> results,
+                            const BSONArray& expected) {
+        value::ValueGuard resultsGuard{results.first, results.second};
+        auto [expectedTag, expectedVal] = stage_builder::makeValue(expected);
+        value::ValueGuard expectedGuard{expectedTag, expectedVal};
+        assertValuesEqual(results.first, results.second, expectedTag, expectedVal);
+    }
+};
+
+TEST_F(TsBucketUnpackStageTest, UnpacksOnlyRequestedFieldsOfCompressedBuckets) {
+    auto bucket1 = makeCompressedBucket(
+        BSON("sensor" << 1),
+        3,
+        {{"time", BSON_ARRAY(makeTime(1) << makeTime(2) << makeTime(3))},
+         {"a", BSON_ARRAY(10 << 20 << 30)},
+         {"b", BSON_ARRAY("x" << "y" << "z")}});
+    auto bucket2 = makeCompressedBucket(BSON("sensor" << 2),
+                                        1,
+                                        {{"time", BSON_ARRAY(makeTime(4))},
+                                         {"a", BSON_ARRAY(40)},
+                                         {"b", BSON_ARRAY("w")}});
+
+    auto results = unpack(BSON_ARRAY(bucket1 << bucket2), {"time", "a"}, true /* includeMeta */);
+    assertResultsEqual(results,
+                       BSON_ARRAY(BSON_ARRAY(makeTime(1) << 10 << BSON("sensor" << 1))
+                                  << BSON_ARRAY(makeTime(2) << 20 << BSON("sensor" << 1))
+                                  << BSON_ARRAY(makeTime(3) << 30 << BSON("sensor" << 1))
+                                  << BSON_ARRAY(makeTime(4) << 40 << BSON("sensor" << 2))));
+}
+
+TEST_F(TsBucketUnpackStageTest, MissingValuesAreNothing) {
+    BSONObjBuilder undefinedBuilder;
+    undefinedBuilder.appendUndefined("");
+    auto undefined = undefinedBuilder.obj();
+    auto skip = undefined.firstElement();
+
+    auto bucket = makeCompressedBucket(
+        BSONObj(),
+        3,
+        {{"time", BSON_ARRAY(makeTime(1) << makeTime(2) << makeTime(3))},
+         {"a", BSON_ARRAY(1 << skip << 3)}});
+
+    // Nothing values are not added to the result rows, so the second row only holds the time.
+    auto results = unpack(BSON_ARRAY(bucket << bucket), {"time", "a", "c"}, false);
+    assertResultsEqual(results,
+                       BSON_ARRAY(BSON_ARRAY(makeTime(1) << 1) << BSON_ARRAY(makeTime(2))
+                                                               << BSON_ARRAY(makeTime(3) << 3)
+                                                               << BSON_ARRAY(makeTime(1) << 1)
+                                                               << BSON_ARRAY(makeTime(2))
+                                                               << BSON_ARRAY(makeTime(3) << 3)));
+}
+
+TEST_F(TsBucketUnpackStageTest, UnpacksUncompressedBuckets) {
+    auto bucket = BSON("control" << BSON("version" << 1) << "meta" << 5 << "data"
+                                 << BSON("time" << BSON("0" << makeTime(1) << "1" << makeTime(2))
+                                                << "a" << BSON("1" << 7)));
+
+    auto results = unpack(BSON_ARRAY(bucket), {"a", "time"}, true /* includeMeta */);
+    assertResultsEqual(
+        results,
+        BSON_ARRAY(BSON_ARRAY(makeTime(1) << 5) << BSON_ARRAY(7 << makeTime(2) << 5)));
+}
+
+TEST_F(TsBucketUnpackStageTest, FilterIsAppliedBeforeRowsAreReturned) {
+    auto bucket = makeCompressedBucket(
+        BSONObj(),
+        4,
+        {{"time", BSON_ARRAY(makeTime(1) << makeTime(2) << makeTime(3) << makeTime(4))},
+         {"a", BSON_ARRAY(5 << 50 << 6 << 60)}});
+
+    auto results =
+        unpack(BSON_ARRAY(bucket), {"time", "a"}, false, [](const value::SlotVector& slots) {
+            return stage_builder::makeFillEmptyFalse(
+                makeE<EPrimBinary>(EPrimBinary::greater,
+                                   makeE<EVariable>(slots[1]),
+                                   makeE<EConstant>(value::TypeTags::NumberInt32,
+                                                    value::bitcastFrom<int32_t>(10))));
+        });
+    assertResultsEqual(results,
+                       BSON_ARRAY(BSON_ARRAY(makeTime(2) << 50) << BSON_ARRAY(makeTime(4) << 60)));
+}
+
+TEST_F(TsBucketUnpackStageTest, EmptyBucketsProduceNoRows) {
+    auto bucket = BSON("control" << BSON("version" << 2 << "count" << 0) << "data" << BSONObj());
+
+    auto results = unpack(BSON_ARRAY(bucket), {"time"}, false);
+    assertResultsEqual(results, BSONArray());
+}
+}  // namespace mongo::sbe
@@ -0,0 +1,332 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/sbe/stages/ts_bucket_unpack.h"
+
+#include <algorithm>
+
+#include "mongo/db/exec/sbe/size_estimator.h"
+#include "mongo/db/exec/sbe/values/bson.h"
+#include "mongo/db/timeseries/timeseries_constants.h"
+#include "mongo/util/str.h"
+
+namespace mongo::sbe {
+TsBucketUnpackStage::TsBucketUnpackStage(std::unique_ptr<PlanStage> input,
+                                         value::SlotId bucketSlot,
+                                         std::string timeField,
+                                         std::vector<std::string> fields,
+                                         value::SlotVector fieldSlots,
+                                         boost::optional<value::SlotId> metaSlot,
+                                         std::unique_ptr<EExpression> filter,
+                                         PlanNodeId planNodeId,
+                                         bool participateInTrialRunTracking)
+    : PlanStage("ts_bucket_unpack"_sd, planNodeId, participateInTrialRunTracking),
+      _bucketSlot(bucketSlot),
+      _timeField(std::move(timeField)),
+      _fields(std::move(fields)),
+      _fieldSlots(std::move(fieldSlots)),
+      _metaSlot(metaSlot),
+      _filter(std::move(filter)) {
+    _children.emplace_back(std::move(input));
+
+    tassert(7095700,
+            "ts_bucket_unpack requires exactly one slot per field",
+            _fields.size() == _fieldSlots.size());
+}
+
+std::unique_ptr<PlanStage> TsBucketUnpackStage::clone() const {
+    return std::make_unique<TsBucketUnpackStage>(_children[0]->clone(),
+                                                 _bucketSlot,
+                                                 _timeField,
+                                                 _fields,
+                                                 _fieldSlots,
+                                                 _metaSlot,
+                                                 _filter ? _filter->clone() : nullptr,
+                                                 _commonStats.nodeId,
+                                                 _participateInTrialRunTracking);
+}
+
+void TsBucketUnpackStage::prepare(CompileCtx& ctx) {
+    _children[0]->prepare(ctx);
+
+    _bucketAccessor = _children[0]->getAccessor(ctx, _bucketSlot);
+
+    // The accessors must be created before the filter is compiled since the filter may refer to
+    // the output slots of this stage.
+    _fieldAccessors.resize(_fieldSlots.size());
+    _columns.resize(_fieldSlots.size());
+    for (size_t idx = 0; idx < _fieldSlots.size(); ++idx) {
+        auto [it, inserted] = _outAccessors.emplace(_fieldSlots[idx], &_fieldAccessors[idx]);
+        uassert(7095701, str::stream() << "duplicate slot: " << _fieldSlots[idx], inserted);
+    }
+    if (_metaSlot) {
+        auto [it, inserted] = _outAccessors.emplace(*_metaSlot, &_metaAccessor);
+        uassert(7095702, str::stream() << "duplicate slot: " << *_metaSlot, inserted);
+    }
+
+    if (_filter) {
+        ctx.root = this;
+        _filterCode = _filter->compile(ctx);
+    }
+}
+
+value::SlotAccessor* TsBucketUnpackStage::getAccessor(CompileCtx& ctx, value::SlotId slot) {
+    if (auto it = _outAccessors.find(slot); it != _outAccessors.end()) {
+        return it->second;
+    }
+
+    return _children[0]->getAccessor(ctx, slot);
+}
+
+void TsBucketUnpackStage::open(bool reOpen) {
+    auto optTimer(getOptTimer(_opCtx));
+
+    _commonStats.opens++;
+    _children[0]->open(reOpen);
+
+    _rowCount = 0;
+    _nextRow = 0;
+}
+
+size_t TsBucketUnpackStage::computeRowCount(const BSONObj& data) const {
+    auto control = _bucket[timeseries::kBucketControlFieldName];
+    uassert(7095703,
+            "Time-series bucket unpacking requires the 'control' object to be present",
+            control.type() == BSONType::Object);
+
+    auto count = control.Obj()[timeseries::kBucketControlCountFieldName];
+    if (count && isNumericBSONType(count.type())) {
+        return static_cast<size_t>(std::max(count.numberLong(), 0LL));
+    }
+
+    auto time = data[_timeField];
+    if (time.type() == BSONType::BinData && time.binDataType() == BinDataType::Column) {
+        return BSONColumn(time).size();
+    }
+    if (time.type() == BSONType::Object) {
+        // Version 1 buckets store one "<index>: <value>" pair for every measurement in the time
+        // column, since every measurement must have a time.
+        return static_cast<size_t>(time.Obj().nFields());
+    }
+    return 0;
+}
+
+void TsBucketUnpackStage::decodeColumn(const BSONElement& elem, Column& column) {
+    if (elem.type() == BSONType::BinData && elem.binDataType() == BinDataType::Column) {
+        auto& decoder = _decoders.emplace_back(std::make_unique<BSONColumn>(elem));
+        size_t row = 0;
+        for (auto it = decoder->begin(), end = decoder->end(); it != end && row < _rowCount;
+             ++it, ++row) {
+            if (!it->eoo()) {
+                column[row] = bson::convertFrom<true>(*it);
+            }
+        }
+    } else if (elem.type() == BSONType::Object) {
+        for (auto&& cell : elem.Obj()) {
+            auto row = str::parseUnsignedBase10Integer(cell.fieldNameStringData());
+            if (row && *row < _rowCount) {
+                column[*row] = bson::convertFrom<true>(cell);
+            }
+        }
+    }
+}
+
+bool TsBucketUnpackStage::loadBucket() {
+    // Release the views into the previous bucket before replacing it.
+    _decoders.clear();
+    for (auto& accessor : _fieldAccessors) {
+        accessor.reset();
+    }
+    _metaAccessor.reset();
+
+    auto [tag, val] = _bucketAccessor->getViewOfValue();
+    uassert(7095704,
+            "Time-series bucket unpacking requires the bucket to be an object",
+            tag == value::TypeTags::bsonObject);
+    _bucket = BSONObj(value::bitcastTo<const char*>(val)).getOwned();
+
+    auto data = _bucket[timeseries::kBucketDataFieldName];
+    auto dataObj = data.type() == BSONType::Object ? data.Obj() : BSONObj();
+    _rowCount = computeRowCount(dataObj);
+    _nextRow = 0;
+    ++_bucketsUnpacked;
+    if (_rowCount == 0) {
+        return false;
+    }
+
+    for (size_t idx = 0; idx < _fields.size(); ++idx) {
+        auto& column = _columns[idx];
+        column.assign(_rowCount, {value::TypeTags::Nothing, 0});
+        decodeColumn(dataObj[_fields[idx]], column);
+    }
+
+    if (_metaSlot) {
+        auto meta = _bucket[timeseries::kBucketMetaFieldName];
+        if (meta) {
+            auto [metaTag, metaVal] = bson::convertFrom<true>(meta);
+            _metaAccessor.reset(metaTag, metaVal);
+        }
+    }
+    return true;
+}
+
+void TsBucketUnpackStage::resetRowAccessors() {
+    for (size_t idx = 0; idx < _fieldAccessors.size(); ++idx) {
+        auto [tag, val] = _columns[idx][_nextRow];
+        _fieldAccessors[idx].reset(tag, val);
+    }
+}
+
+PlanState TsBucketUnpackStage::getNext() {
+    auto optTimer(getOptTimer(_opCtx));
+
+    while (true) {
+        if (_nextRow >= _rowCount) {
+            // We are about to call getNext() on our child so do not bother saving our internal
+            // state in case it yields as the state will be completely overwritten after the
+            // getNext() call.
+            disableSlotAccess();
+            auto state = _children[0]->getNext();
+            if (state != PlanState::ADVANCED) {
+                return trackPlanState(state);
+            }
+
+            if (!loadBucket()) {
+                continue;
+            }
+        }
+
+        resetRowAccessors();
+        ++_nextRow;
+        ++_rowsDecoded;
+
+        if (_filterCode && !_bytecode.runPredicate(_filterCode.get())) {
+            ++_rowsFiltered;
+            continue;
+        }
+
+        return trackPlanState(PlanState::ADVANCED);
+    }
+}
+
+void TsBucketUnpackStage::close() {
+    auto optTimer(getOptTimer(_opCtx));
+
+    trackClose();
+    _children[0]->close();
+
+    _decoders.clear();
+    for (auto& column : _columns) {
+        column.clear();
+    }
+    _bucket = BSONObj();
+    _rowCount = 0;
+    _nextRow = 0;
+}
+
+std::unique_ptr<PlanStageStats> TsBucketUnpackStage::getStats(bool includeDebugInfo) const {
+    auto ret = std::make_unique<PlanStageStats>(_commonStats);
+
+    if (includeDebugInfo) {
+        BSONObjBuilder bob;
+        bob.appendNumber("bucketSlot", static_cast<long long>(_bucketSlot));
+        bob.append("timeField", _timeField);
+        bob.append("fields", _fields);
+        bob.append("fieldSlots", _fieldSlots.begin(), _fieldSlots.end());
+        if (_metaSlot) {
+            bob.appendNumber("metaSlot", static_cast<long long>(*_metaSlot));
+        }
+        if (_filter) {
+            bob.append("filter", DebugPrinter{}.print(_filter->debugPrint()));
+        }
+        bob.appendNumber("bucketsUnpacked", static_cast<long long>(_bucketsUnpacked));
+        bob.appendNumber("rowsDecoded", static_cast<long long>(_rowsDecoded));
+        bob.appendNumber("rowsFiltered", static_cast<long long>(_rowsFiltered));
+        ret->debugInfo = bob.obj();
+    }
+
+    ret->children.emplace_back(_children[0]->getStats(includeDebugInfo));
+    return ret;
+}
+
+const SpecificStats* TsBucketUnpackStage::getSpecificStats() const {
+    return nullptr;
+}
+
+std::vector<DebugPrinter::Block> TsBucketUnpackStage::debugPrint() const {
+    auto ret = PlanStage::debugPrint();
+
+    DebugPrinter::addIdentifier(ret, _bucketSlot);
+    DebugPrinter::addIdentifier(ret, _timeField);
+    if (_metaSlot) {
+        DebugPrinter::addIdentifier(ret, *_metaSlot);
+    }
+
+    ret.emplace_back(DebugPrinter::Block("[`"));
+    for (size_t idx = 0; idx < _fields.size(); ++idx) {
+        if (idx) {
+            ret.emplace_back(DebugPrinter::Block("`,"));
+        }
+
+        DebugPrinter::addIdentifier(ret, _fieldSlots[idx]);
+        ret.emplace_back("=");
+        DebugPrinter::addIdentifier(ret, _fields[idx]);
+    }
+    ret.emplace_back(DebugPrinter::Block("`]"));
+
+    if (_filter) {
+        ret.emplace_back("{`");
+        DebugPrinter::addBlocks(ret, _filter->debugPrint());
+        ret.emplace_back("`}");
+    }
+
+    DebugPrinter::addNewLine(ret);
+    DebugPrinter::addBlocks(ret, _children[0]->debugPrint());
+
+    return ret;
+}
+
+void TsBucketUnpackStage::doSaveState(bool fullSave) {}
+
+void TsBucketUnpackStage::doRestoreState(bool fullSave) {}
+
+size_t TsBucketUnpackStage::estimateCompileTimeSize() const {
+    size_t size = sizeof(*this);
+    size += size_estimator::estimate(_children);
+    size += size_estimator::estimate(_timeField);
+    size += size_estimator::estimate(_fields);
+    size += size_estimator::estimate(_fieldSlots);
+    if (_filter) {
+        size += _filter->estimateSize();
+    }
+    return size;
+}
+}  // namespace mongo::sbe
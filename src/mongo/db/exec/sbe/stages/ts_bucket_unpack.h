@@ -0,0 +1,141 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/util/bsoncolumn.h"
+#include "mongo/db/exec/sbe/expressions/expression.h"
+#include "mongo/db/exec/sbe/stages/stages.h"
+#include "mongo/db/exec/sbe/vm/vm.h"
+
+namespace mongo::sbe {
+/**
+ * Unpacks a time-series bucket into its individual measurements a block at a time. The bucket is
+ * read from the 'bucketSlot' slot. For every bucket, the stage decodes only the 'data.<field>'
+ * columns named in 'fields' (either BSONColumn binary data or a version 1 object keyed by the
+ * measurement index) into parallel column arrays, and then iterates the rows of those arrays,
+ * exposing the value of field 'fields[i]' of the current row in slot 'fieldSlots[i]'. Missing
+ * values are exposed as Nothing.
+ *
+ * The optional 'filter' is a per-row predicate that may refer to the field slots and the meta
+ * slot. It is evaluated against the column arrays before the row is returned, so measurements that
+ * fail the predicate are never handed to the parent stage.
+ *
+ * If 'metaSlot' is provided then the bucket's 'meta' field (or Nothing) is exposed in it for every
+ * row of the bucket. The 'timeField' is used to size the column arrays when the bucket has no
+ * 'control.count' field.
+ *
+ * Debug string representation:
+ *
+ *   ts_bucket_unpack bucketSlot timeField metaSlot? [slot_1 = field_1, ..., slot_n = field_n]
+ *       { filter }? childStage
+ */
+class TsBucketUnpackStage final : public PlanStage {
+public:
+    TsBucketUnpackStage(std::unique_ptr<PlanStage> input,
+                        value::SlotId bucketSlot,
+                        std::string timeField,
+                        std::vector<std::string> fields,
+                        value::SlotVector fieldSlots,
+                        boost::optional<value::SlotId> metaSlot,
+                        std::unique_ptr<EExpression> filter,
+                        PlanNodeId planNodeId,
+                        bool participateInTrialRunTracking = true);
+
+    std::unique_ptr<PlanStage> clone() const final;
+
+    void prepare(CompileCtx& ctx) final;
+    value::SlotAccessor* getAccessor(CompileCtx& ctx, value::SlotId slot) final;
+    void open(bool reOpen) final;
+    PlanState getNext() final;
+    void close() final;
+
+    std::unique_ptr<PlanStageStats> getStats(bool includeDebugInfo) const final;
+    const SpecificStats* getSpecificStats() const final;
+    std::vector<DebugPrinter::Block> debugPrint() const final;
+    size_t estimateCompileTimeSize() const final;
+
+protected:
+    void doSaveState(bool relinquishCursor) final;
+    void doRestoreState(bool relinquishCursor) final;
+
+private:
+    using Column = std::vector<std::pair<value::TypeTags, value::Value>>;
+
+    /**
+     * Takes an owned copy of the bucket in the input slot and decodes the requested columns.
+     * Returns false if the bucket holds no measurements.
+     */
+    bool loadBucket();
+
+    /**
+     * Fills 'column' with views of the values stored in the bucket's 'data.<field>' element 'elem'.
+     */
+    void decodeColumn(const BSONElement& elem, Column& column);
+
+    /**
+     * Returns the number of measurements in the current bucket.
+     */
+    size_t computeRowCount(const BSONObj& data) const;
+
+    void resetRowAccessors();
+
+    const value::SlotId _bucketSlot;
+    const std::string _timeField;
+    const std::vector<std::string> _fields;
+    const value::SlotVector _fieldSlots;
+    const boost::optional<value::SlotId> _metaSlot;
+    const std::unique_ptr<EExpression> _filter;
+
+    value::SlotAccessor* _bucketAccessor{nullptr};
+    std::vector<value::ViewOfValueAccessor> _fieldAccessors;
+    value::SlotAccessorMap _outAccessors;
+    value::ViewOfValueAccessor _metaAccessor;
+
+    std::unique_ptr<vm::CodeFragment> _filterCode;
+    vm::ByteCode _bytecode;
+
+    // The owned copy of the bucket currently being unpacked. All values exposed by this stage are
+    // views into either this object or one of the '_decoders', so the stage has no state that needs
+    // to be saved across yields.
+    BSONObj _bucket;
+    std::vector<std::unique_ptr<BSONColumn>> _decoders;
+    std::vector<Column> _columns;
+    size_t _rowCount{0};
+    size_t _nextRow{0};
+
+    size_t _bucketsUnpacked{0};
+    size_t _rowsDecoded{0};
+    size_t _rowsFiltered{0};
+};
+}  // namespace mongo::sbe
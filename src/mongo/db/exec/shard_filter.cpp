@@ -104,6 +104,8 @@ PlanStage::StageState ShardFilterStage::doWork(WorkingSetID* out) {
                 ++_specificStats.chunkSkips;
                 return PlanStage::NEED_TIME;
             }
+
+            _shardFilterer.sampleChunkRead(opCtx(), *member);
         }
 
         // If we're here either we have shard state and our doc passed, or we have no shard
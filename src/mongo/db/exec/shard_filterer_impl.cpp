@@ -33,8 +33,15 @@
 
 #include "mongo/db/exec/filter.h"
 #include "mongo/db/matcher/matchable.h"
+#include "mongo/db/operation_context.h"
 
 namespace mongo {
+namespace {
+
+// Whether a read of the operation has already been offered to the chunk operation sampler.
+const auto chunkReadSampledDecoration = OperationContext::declareDecoration<bool>();
+
+}  // namespace
 
 std::unique_ptr<ShardFilterer> ShardFiltererImpl::clone() const {
     return std::make_unique<ShardFiltererImpl>(_collectionFilter);
@@ -53,15 +60,10 @@ ShardFilterer::DocumentBelongsResult ShardFiltererImpl::keyBelongsToMeHelper(
                                     : DocumentBelongsResult::kDoesNotBelong;
 }
 
-ShardFilterer::DocumentBelongsResult ShardFiltererImpl::documentBelongsToMe(
-    const WorkingSetMember& wsm) const {
-    if (!_collectionFilter.isSharded()) {
-        return DocumentBelongsResult::kBelongs;
-    }
-
+BSONObj ShardFiltererImpl::extractShardKey(const WorkingSetMember& wsm) const {
     if (wsm.hasObj()) {
-        return keyBelongsToMeHelper(_collectionFilter.getShardKeyPattern().extractShardKeyFromDoc(
-            wsm.doc.value().toBson()));
+        return _collectionFilter.getShardKeyPattern().extractShardKeyFromDoc(
+            wsm.doc.value().toBson());
     }
     // Transform 'IndexKeyDatum' provided by 'wsm' into 'IndexKeyData' to call
     // extractShardKeyFromIndexKeyData().
@@ -71,8 +73,28 @@ ShardFilterer::DocumentBelongsResult ShardFiltererImpl::documentBelongsToMe(
     for (auto&& indexKeyData : wsm.keyData) {
         indexKeyDataVector.push_back({indexKeyData.keyData, indexKeyData.indexKeyPattern});
     }
-    return keyBelongsToMeHelper(
-        _collectionFilter.getShardKeyPattern().extractShardKeyFromIndexKeyData(indexKeyDataVector));
+    return _collectionFilter.getShardKeyPattern().extractShardKeyFromIndexKeyData(
+        indexKeyDataVector);
+}
+
+ShardFilterer::DocumentBelongsResult ShardFiltererImpl::documentBelongsToMe(
+    const WorkingSetMember& wsm) const {
+    if (!_collectionFilter.isSharded()) {
+        return DocumentBelongsResult::kBelongs;
+    }
+
+    return keyBelongsToMeHelper(extractShardKey(wsm));
+}
+
+void ShardFiltererImpl::sampleChunkRead(OperationContext* opCtx,
+                                        const WorkingSetMember& wsm) const {
+    auto& chunkReadSampled = chunkReadSampledDecoration(opCtx);
+    if (chunkReadSampled) {
+        return;
+    }
+    chunkReadSampled = true;
+
+    _collectionFilter.sampleChunkRead(extractShardKey(wsm));
 }
 
 ShardFilterer::DocumentBelongsResult ShardFiltererImpl::documentBelongsToMe(
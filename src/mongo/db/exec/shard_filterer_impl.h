@@ -44,6 +44,13 @@ public:
     DocumentBelongsResult documentBelongsToMe(const BSONObj& doc) const override;
     DocumentBelongsResult documentBelongsToMe(const WorkingSetMember& wsm) const;
 
+    /**
+     * Offers a read of the chunk which owns the document in 'wsm', which must belong to this
+     * shard, to the chunk operation sampler. Only the first document of each operation is
+     * offered, so that an operation counts as one read no matter how many documents it returns.
+     */
+    void sampleChunkRead(OperationContext* opCtx, const WorkingSetMember& wsm) const;
+
     bool keyBelongsToMe(const BSONObj& shardKey) const override {
         return _collectionFilter.keyBelongsToMe(shardKey);
     };
@@ -58,6 +65,7 @@ public:
 
 private:
     DocumentBelongsResult keyBelongsToMeHelper(const BSONObj& doc) const;
+    BSONObj extractShardKey(const WorkingSetMember& wsm) const;
 
     ScopedCollectionFilter _collectionFilter;
 };
@@ -106,6 +106,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/periodic_runner_job_abort_expired_transactions.h"
 #include "mongo/db/pipeline/change_stream_expired_pre_image_remover.h"
+#include "mongo/db/pipeline/change_stream_oplog_multiplexer.h"
 #include "mongo/db/pipeline/process_interface/replica_set_node_process_interface.h"
 #include "mongo/db/query/ce/stats_cache_loader_impl.h"
 #include "mongo/db/query/ce/stats_catalog.h"
@@ -180,6 +181,7 @@
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/db/storage/storage_parameters_gen.h"
 #include "mongo/db/system_index.h"
+#include "mongo/db/timeseries/bucket_compression_service.h"
 #include "mongo/db/transaction/internal_transactions_reap_service.h"
 #include "mongo/db/transaction/session_catalog_mongod_transaction_interface_impl.h"
 #include "mongo/db/transaction/transaction_participant.h"
@@ -658,6 +660,7 @@ ExitCode _initAndListen(ServiceContext* serviceContext, int listenPort) {
     }
 
     WaitForMajorityService::get(serviceContext).startup(serviceContext);
+    BucketCompressionService::get(serviceContext).startup(serviceContext);
 
     // This function may take the global lock.
     auto shardingInitialized = ShardingInitializationMongoD::get(startupOpCtx.get())
@@ -1315,6 +1318,11 @@ void shutdownTask(const ShutdownTaskArgs& shutdownArgs) {
     LOGV2_OPTIONS(4784902, {LogComponent::kSharding}, "Shutting down the WaitForMajorityService");
     WaitForMajorityService::get(serviceContext).shutDown();
 
+    LOGV2_OPTIONS(7095716,
+                  {LogComponent::kStorage},
+                  "Shutting down the time-series bucket compression service");
+    BucketCompressionService::get(serviceContext).shutDown();
+
     // Join the logical session cache before the transport layer.
     if (auto lsc = LogicalSessionCache::get(serviceContext)) {
         LOGV2(4784903, "Shutting down the LogicalSessionCache");
@@ -1490,6 +1498,9 @@ void shutdownTask(const ShutdownTaskArgs& shutdownArgs) {
 
     shutdownChangeCollectionExpiredDocumentsRemover(serviceContext);
 
+    LOGV2(7095756, "Shutting down the shared change stream oplog reader");
+    ChangeStreamOplogMultiplexer::get(serviceContext)->shutdown();
+
     // We should always be able to acquire the global lock at shutdown.
     // An OperationContext is not necessary to call lockGlobal() during shutdown, as it's only used
     // to check that lockGlobal() is not called after a transaction timestamp has been set.
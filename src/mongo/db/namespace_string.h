@@ -216,6 +216,10 @@ public:
     // Namespace for storing config.transactions cloner progress for resharding.
     static const NamespaceString kReshardingTxnClonerProgressNamespace;
 
+    // Namespace for storing the _id ranges copied concurrently by the collection cloner for
+    // resharding.
+    static const NamespaceString kReshardingCollectionClonerProgressNamespace;
+
     // Namespace for storing config.collectionCriticalSections documents
     static const NamespaceString kCollectionCriticalSectionsNamespace;
 
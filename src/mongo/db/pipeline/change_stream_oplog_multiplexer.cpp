@@ -0,0 +1,395 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/change_stream_oplog_multiplexer.h"
+
+#include <algorithm>
+
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/catalog/local_oplog_info.h"
+#include "mongo/db/client.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/query/find_command_gen.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/repl/optime.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/db/storage/recovery_unit.h"
+#include "mongo/logv2/log.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/scopeguard.h"
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kQuery
+
+namespace mongo {
+namespace {
+
+const auto getChangeStreamOplogMultiplexer =
+    ServiceContext::declareDecoration<ChangeStreamOplogMultiplexer>();
+
+// How long the reader waits for new oplog entries before it looks again.
+constexpr Milliseconds kIdleWaitTime{1000};
+
+}  // namespace
+
+ChangeStreamOplogMultiplexer::Subscription::Subscription(ChangeStreamOplogMultiplexer* multiplexer,
+                                                         uint64_t nextSeq,
+                                                         Timestamp position)
+    : _multiplexer(multiplexer), _nextSeq(nextSeq), _position(position) {}
+
+ChangeStreamOplogMultiplexer::Subscription::~Subscription() {
+    _multiplexer->_unsubscribe(this);
+}
+
+size_t ChangeStreamOplogMultiplexer::Subscription::pull(std::deque<BSONObj>* out,
+                                                        size_t maxEntries) {
+    stdx::lock_guard<Latch> lk(_multiplexer->_mutex);
+    if (_detached) {
+        return 0;
+    }
+
+    const auto startSeq = _nextSeq;
+    const auto endSeq = _multiplexer->_endSeq(lk);
+    size_t numPulled = 0;
+    while (_nextSeq < endSeq && numPulled < maxEntries) {
+        const auto& entry = _multiplexer->_buffer[_nextSeq - _multiplexer->_firstSeq];
+        ++_nextSeq;
+
+        // A subscriber may have joined ahead of the reader, in which case it has already seen the
+        // entries up to its starting position.
+        if (entry.ts <= _position) {
+            continue;
+        }
+        out->push_back(entry.doc);
+        _position = entry.ts;
+        ++numPulled;
+    }
+
+    if (_nextSeq != startSeq && _multiplexer->_readerWaitingForRoom) {
+        _multiplexer->_roomAvailableCV.notify_all();
+    }
+    return numPulled;
+}
+
+void ChangeStreamOplogMultiplexer::Subscription::waitForEntries(OperationContext* opCtx,
+                                                                Date_t deadline) {
+    stdx::unique_lock<Latch> lk(_multiplexer->_mutex);
+    opCtx->waitForConditionOrInterruptUntil(
+        _multiplexer->_entriesAvailableCV, lk, deadline, [&] {
+            return _detached || _nextSeq < _multiplexer->_endSeq(lk);
+        });
+}
+
+bool ChangeStreamOplogMultiplexer::Subscription::isDetached() const {
+    stdx::lock_guard<Latch> lk(_multiplexer->_mutex);
+    return _detached;
+}
+
+Timestamp ChangeStreamOplogMultiplexer::Subscription::getPosition() const {
+    stdx::lock_guard<Latch> lk(_multiplexer->_mutex);
+    return _position;
+}
+
+ChangeStreamOplogMultiplexer* ChangeStreamOplogMultiplexer::get(ServiceContext* serviceContext) {
+    return &getChangeStreamOplogMultiplexer(serviceContext);
+}
+
+ChangeStreamOplogMultiplexer::ChangeStreamOplogMultiplexer(FetchBatchFn fetchBatch)
+    : _fetchBatch(std::move(fetchBatch)) {}
+
+ChangeStreamOplogMultiplexer::~ChangeStreamOplogMultiplexer() {
+    shutdown();
+    invariant(_subscriptions.empty());
+}
+
+std::unique_ptr<ChangeStreamOplogMultiplexer::Subscription> ChangeStreamOplogMultiplexer::subscribe(
+    OperationContext* opCtx, Timestamp resumeAfter) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_inShutdown) {
+        return nullptr;
+    }
+
+    uint64_t nextSeq;
+    if (_subscriptions.empty()) {
+        // Nobody is reading the oplog at the moment, so the reader starts over at this subscriber.
+        invariant(_buffer.empty());
+        _scannedThrough = resumeAfter;
+        _evictedThrough = resumeAfter;
+        nextSeq = _endSeq(lk);
+    } else if (resumeAfter < _evictedThrough) {
+        // Some of the entries this subscriber has yet to see are no longer buffered.
+        return nullptr;
+    } else {
+        auto it = std::upper_bound(
+            _buffer.begin(), _buffer.end(), resumeAfter, [](Timestamp ts, const Entry& entry) {
+                return ts < entry.ts;
+            });
+        nextSeq = _firstSeq + std::distance(_buffer.begin(), it);
+    }
+
+    std::unique_ptr<Subscription> subscription(new Subscription(this, nextSeq, resumeAfter));
+    subscription->_listIt = _subscriptions.insert(_subscriptions.end(), subscription.get());
+
+    if (!_reader.joinable()) {
+        _reader = stdx::thread(
+            [this, serviceContext = opCtx->getServiceContext()] { _readerThread(serviceContext); });
+    }
+    _readerCV.notify_all();
+    return subscription;
+}
+
+void ChangeStreamOplogMultiplexer::shutdown() {
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _inShutdown = true;
+        while (!_subscriptions.empty()) {
+            _detach(lk, _subscriptions.front());
+        }
+        _readerCV.notify_all();
+        _roomAvailableCV.notify_all();
+        if (_oplogNotifier) {
+            _oplogNotifier->notifyAll();
+        }
+    }
+
+    if (_reader.joinable()) {
+        _reader.join();
+    }
+}
+
+size_t ChangeStreamOplogMultiplexer::getNumSubscribers() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _subscriptions.size();
+}
+
+std::vector<BSONObj> ChangeStreamOplogMultiplexer::fetchMajorityCommittedBatch(
+    OperationContext* opCtx, Timestamp after, int batchSize) {
+    // The reader serves change streams of many users, each of which was authorized when it was
+    // opened.
+    AuthorizationSession::get(opCtx->getClient())->grantInternalAuthorization(opCtx->getClient());
+
+    // Change streams only return majority committed events, so read from the same snapshot that a
+    // change stream's own oplog cursor would.
+    opCtx->recoveryUnit()->setTimestampReadSource(RecoveryUnit::ReadSource::kMajorityCommitted);
+    if (!opCtx->recoveryUnit()->majorityCommittedSnapshotAvailable().isOK()) {
+        return {};
+    }
+
+    DBDirectClient client(opCtx);
+    FindCommandRequest findRequest{NamespaceString::kRsOplogNamespace};
+    findRequest.setFilter(BSON(repl::OpTime::kTimestampFieldName << BSON("$gt" << after)));
+    findRequest.setHint(BSON("$natural" << 1));
+    findRequest.setLimit(batchSize);
+    auto cursor = client.find(std::move(findRequest));
+
+    std::vector<BSONObj> batch;
+    while (cursor->more()) {
+        batch.push_back(cursor->nextSafe().getOwned());
+    }
+    return batch;
+}
+
+void ChangeStreamOplogMultiplexer::_readerThread(ServiceContext* serviceContext) {
+    ThreadClient tc("ChangeStreamOplogMultiplexer", serviceContext);
+    LOGV2(7095751, "Starting the shared change stream oplog reader");
+
+    while (true) {
+        Timestamp after;
+        uint64_t generation;
+        {
+            stdx::unique_lock<Latch> lk(_mutex);
+            MONGO_IDLE_THREAD_BLOCK;
+            _readerCV.wait(lk, [&] { return _inShutdown || !_subscriptions.empty(); });
+            if (_inShutdown) {
+                break;
+            }
+            after = _scannedThrough;
+            generation = _generation;
+
+            if (!_oplogNotifier) {
+                if (const auto& oplog = LocalOplogInfo::get(serviceContext)->getCollection()) {
+                    _oplogNotifier = oplog->getRecordStore()->getCappedInsertNotifier();
+                }
+            }
+        }
+
+        // Take the notifier version before reading, so that entries which become visible while we
+        // read are not missed when we wait below.
+        const auto notifierVersion = _oplogNotifier ? _oplogNotifier->getVersion() : 0;
+
+        std::vector<BSONObj> batch;
+        try {
+            auto opCtx = tc->makeOperationContext();
+            batch = _fetchBatch(
+                opCtx.get(), after, internalChangeStreamSharedOplogScanBatchSize.load());
+        } catch (const DBException& ex) {
+            // Every subscriber moves to its own oplog cursor, which reports the error to the
+            // client if it persists.
+            LOGV2_DEBUG(7095752,
+                        1,
+                        "Detaching all change streams from the shared oplog scan after an error",
+                        "error"_attr = redact(ex));
+            stdx::lock_guard<Latch> lk(_mutex);
+            while (!_subscriptions.empty()) {
+                _detach(lk, _subscriptions.front());
+            }
+            continue;
+        }
+
+        if (batch.empty()) {
+            if (_oplogNotifier) {
+                // Inserts into the oplog and advances of the majority commit point both signal the
+                // oplog's insert notifier.
+                MONGO_IDLE_THREAD_BLOCK;
+                _oplogNotifier->waitUntil(notifierVersion, Date_t::now() + kIdleWaitTime);
+            } else {
+                stdx::unique_lock<Latch> lk(_mutex);
+                MONGO_IDLE_THREAD_BLOCK;
+                _readerCV.wait_for(
+                    lk, kIdleWaitTime.toSystemDuration(), [&] { return _inShutdown; });
+            }
+            continue;
+        }
+
+        stdx::unique_lock<Latch> lk(_mutex);
+        _appendBatch(lk, std::move(batch), generation);
+    }
+
+    LOGV2(7095753, "Stopped the shared change stream oplog reader");
+}
+
+void ChangeStreamOplogMultiplexer::_appendBatch(stdx::unique_lock<Latch>& lk,
+                                                std::vector<BSONObj> batch,
+                                                uint64_t generation) {
+    for (auto&& doc : batch) {
+        _makeRoom(lk, generation);
+        if (_inShutdown || generation != _generation) {
+            return;
+        }
+
+        auto ts = doc[repl::OpTime::kTimestampFieldName].timestamp();
+        _buffer.push_back({ts, std::move(doc)});
+        _scannedThrough = ts;
+    }
+    _entriesAvailableCV.notify_all();
+}
+
+void ChangeStreamOplogMultiplexer::_makeRoom(stdx::unique_lock<Latch>& lk, uint64_t generation) {
+    const auto capacity = static_cast<size_t>(internalChangeStreamSharedOplogScanBufferSize.load());
+    _evictPulledEntries(lk, capacity);
+    if (_buffer.size() < capacity) {
+        return;
+    }
+
+    // Let subscribers see what has been appended so far, since that is what they need to pull
+    // for the oldest entries to be released.
+    _entriesAvailableCV.notify_all();
+
+    const auto deadline = Date_t::now() +
+        Milliseconds(internalChangeStreamSharedOplogScanSlowConsumerTimeoutMS.load());
+    _readerWaitingForRoom = true;
+    ON_BLOCK_EXIT([&] { _readerWaitingForRoom = false; });
+
+    while (true) {
+        _evictPulledEntries(lk, capacity);
+        if (_inShutdown || generation != _generation || _buffer.size() < capacity) {
+            return;
+        }
+
+        if (Date_t::now() >= deadline) {
+            // Detach the subscribers which hold back the oldest entry. They continue from their
+            // own oplog cursors, and the rest of the subscribers are no longer held back by them.
+            for (auto it = _subscriptions.begin(); it != _subscriptions.end();) {
+                auto subscription = *(it++);
+                if (subscription->_nextSeq == _firstSeq) {
+                    LOGV2_DEBUG(7095754,
+                                1,
+                                "Detaching a slow change stream from the shared oplog scan",
+                                "position"_attr = subscription->_position,
+                                "bufferedEntries"_attr = _buffer.size());
+                    _detach(lk, subscription);
+                }
+            }
+            continue;
+        }
+
+        MONGO_IDLE_THREAD_BLOCK;
+        _roomAvailableCV.wait_until(lk, deadline.toSystemTimePoint());
+    }
+}
+
+void ChangeStreamOplogMultiplexer::_evictPulledEntries(WithLock lk, size_t capacity) {
+    auto minNextSeq = _endSeq(lk);
+    for (auto subscription : _subscriptions) {
+        minNextSeq = std::min(minNextSeq, subscription->_nextSeq);
+    }
+
+    // Only evict what is needed to make room, since the remaining entries let streams whose own
+    // cursors are slightly behind subscribe.
+    while (_firstSeq < minNextSeq && _buffer.size() >= capacity) {
+        _evictedThrough = _buffer.front().ts;
+        _buffer.pop_front();
+        ++_firstSeq;
+    }
+}
+
+void ChangeStreamOplogMultiplexer::_detach(WithLock lk, Subscription* subscription) {
+    invariant(!subscription->_detached);
+    subscription->_detached = true;
+    _subscriptions.erase(subscription->_listIt);
+    _entriesAvailableCV.notify_all();
+    _resetIfIdle(lk);
+}
+
+void ChangeStreamOplogMultiplexer::_unsubscribe(Subscription* subscription) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (subscription->_detached) {
+        return;
+    }
+
+    _subscriptions.erase(subscription->_listIt);
+    _resetIfIdle(lk);
+    if (_readerWaitingForRoom) {
+        _roomAvailableCV.notify_all();
+    }
+}
+
+void ChangeStreamOplogMultiplexer::_resetIfIdle(WithLock lk) {
+    if (!_subscriptions.empty()) {
+        return;
+    }
+
+    _firstSeq = _endSeq(lk);
+    _buffer.clear();
+    ++_generation;
+}
+
+}  // namespace mongo
@@ -0,0 +1,238 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/timestamp.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class CappedInsertNotifier;
+
+/**
+ * Reads the tail of the oplog once on behalf of every change stream which has caught up with it,
+ * and fans the entries out to them. Each entry is read from storage and materialized a single
+ * time; all subscribers share the same buffer and apply their own oplog filters to it.
+ *
+ * Entries are kept in a bounded buffer until every subscriber has pulled them. When the buffer is
+ * full, the reader waits up to 'internalChangeStreamSharedOplogScanSlowConsumerTimeoutMS' for the
+ * slowest subscribers to catch up, and then detaches those which still hold back the oldest entry.
+ * A detached subscriber is expected to continue from its own oplog cursor, starting after its
+ * last pulled entry.
+ *
+ * The reader thread is started on the first subscription, and reads only while there is at least
+ * one subscriber. It reads the majority committed oplog, which is what change streams observe.
+ */
+class ChangeStreamOplogMultiplexer {
+    ChangeStreamOplogMultiplexer(const ChangeStreamOplogMultiplexer&) = delete;
+    ChangeStreamOplogMultiplexer& operator=(const ChangeStreamOplogMultiplexer&) = delete;
+
+public:
+    /**
+     * Returns up to 'batchSize' oplog entries with a timestamp greater than 'after', in timestamp
+     * order. The default implementation reads the majority committed oplog.
+     */
+    using FetchBatchFn = std::function<std::vector<BSONObj>(
+        OperationContext* opCtx, Timestamp after, int batchSize)>;
+
+    /**
+     * A change stream's position in the shared buffer. Destroying the subscription unsubscribes.
+     */
+    class Subscription {
+        Subscription(const Subscription&) = delete;
+        Subscription& operator=(const Subscription&) = delete;
+
+    public:
+        ~Subscription();
+
+        /**
+         * Appends up to 'maxEntries' entries which follow this subscription's position to 'out',
+         * and advances the position past them. Returns the number of entries appended.
+         */
+        size_t pull(std::deque<BSONObj>* out, size_t maxEntries);
+
+        /**
+         * Blocks until there are entries to pull, the subscription is detached, or 'deadline'
+         * passes. Throws if 'opCtx' is interrupted.
+         */
+        void waitForEntries(OperationContext* opCtx, Date_t deadline);
+
+        /**
+         * True once the multiplexer has stopped serving this subscription. Entries which were
+         * pulled before the detach are still valid; everything after getPosition() must be read
+         * from elsewhere.
+         */
+        bool isDetached() const;
+
+        /**
+         * Returns the timestamp of the last entry pulled, or the subscription's starting point if
+         * nothing was pulled yet.
+         */
+        Timestamp getPosition() const;
+
+    private:
+        friend class ChangeStreamOplogMultiplexer;
+
+        Subscription(ChangeStreamOplogMultiplexer* multiplexer,
+                     uint64_t nextSeq,
+                     Timestamp position);
+
+        ChangeStreamOplogMultiplexer* const _multiplexer;
+
+        // All of the below are protected by the multiplexer's mutex.
+        uint64_t _nextSeq;
+        Timestamp _position;
+        bool _detached = false;
+        std::list<Subscription*>::iterator _listIt;
+    };
+
+    static ChangeStreamOplogMultiplexer* get(ServiceContext* serviceContext);
+
+    explicit ChangeStreamOplogMultiplexer(FetchBatchFn fetchBatch = fetchMajorityCommittedBatch);
+    ~ChangeStreamOplogMultiplexer();
+
+    /**
+     * Subscribes a change stream which has observed the oplog up to and including 'resumeAfter'.
+     * Returns nullptr if the shared buffer no longer holds all of the entries after 'resumeAfter',
+     * or if the multiplexer has been shut down; the caller must then keep reading the oplog on its
+     * own.
+     */
+    std::unique_ptr<Subscription> subscribe(OperationContext* opCtx, Timestamp resumeAfter);
+
+    /**
+     * Detaches every subscriber and stops the reader thread. Subsequent calls to subscribe() fail.
+     */
+    void shutdown();
+
+    /**
+     * Returns the number of attached subscribers.
+     */
+    size_t getNumSubscribers() const;
+
+    /**
+     * Reads the oplog after 'after' from the majority committed snapshot.
+     */
+    static std::vector<BSONObj> fetchMajorityCommittedBatch(OperationContext* opCtx,
+                                                            Timestamp after,
+                                                            int batchSize);
+
+private:
+    struct Entry {
+        Timestamp ts;
+        BSONObj doc;
+    };
+
+    void _readerThread(ServiceContext* serviceContext);
+
+    /**
+     * Appends 'batch' to the buffer, evicting or waiting for entries which every subscriber has
+     * pulled. Returns early if the buffer was reset while waiting.
+     */
+    void _appendBatch(stdx::unique_lock<Latch>& lk,
+                      std::vector<BSONObj> batch,
+                      uint64_t generation);
+
+    /**
+     * Makes room for one more entry, detaching the subscribers which still need the oldest entry
+     * if they do not pull it within the slow consumer timeout.
+     */
+    void _makeRoom(stdx::unique_lock<Latch>& lk, uint64_t generation);
+
+    /**
+     * Evicts the oldest entries, which every subscriber has pulled, until the buffer holds fewer
+     * than 'capacity' entries.
+     */
+    void _evictPulledEntries(WithLock, size_t capacity);
+
+    void _detach(WithLock, Subscription* subscription);
+
+    void _unsubscribe(Subscription* subscription);
+
+    /**
+     * Clears the buffer once the last subscriber is gone, so that the reader stops reading until
+     * somebody subscribes again.
+     */
+    void _resetIfIdle(WithLock);
+
+    uint64_t _endSeq(WithLock) const {
+        return _firstSeq + _buffer.size();
+    }
+
+    const FetchBatchFn _fetchBatch;
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("ChangeStreamOplogMultiplexer::_mutex");
+
+    // Signalled when entries are appended or subscribers are detached.
+    stdx::condition_variable _entriesAvailableCV;
+
+    // Signalled when subscribers pull entries or unsubscribe while the reader waits for room.
+    stdx::condition_variable _roomAvailableCV;
+
+    // Signalled when the first subscriber arrives or on shutdown.
+    stdx::condition_variable _readerCV;
+
+    stdx::thread _reader;
+    bool _inShutdown = false;
+
+    // The oplog's insert notifier, which the reader waits on when it has read everything. Kept so
+    // that shutdown() can wake the reader up.
+    std::shared_ptr<CappedInsertNotifier> _oplogNotifier;
+
+    // Entries in timestamp order. '_buffer[i]' has sequence number '_firstSeq + i'.
+    std::deque<Entry> _buffer;
+    uint64_t _firstSeq = 0;
+
+    // Every oplog entry up to '_scannedThrough' has been appended to the buffer, or was evicted
+    // from it. Nothing at or before '_evictedThrough' is in the buffer anymore.
+    Timestamp _scannedThrough;
+    Timestamp _evictedThrough;
+
+    // Incremented when the buffer is reset, so that the reader discards what it read before.
+    uint64_t _generation = 0;
+
+    bool _readerWaitingForRoom = false;
+
+    std::list<Subscription*> _subscriptions;
+};
+
+}  // namespace mongo
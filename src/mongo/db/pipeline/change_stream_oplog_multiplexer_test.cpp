@@ -0,0 +1,218 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/change_stream_oplog_multiplexer.h"
+#include "mongo/db/service_context_test_fixture.h"
+#include "mongo/idl/server_parameter_test_util.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * An oplog which the multiplexer's reader tails. Reads block until there is an entry after the
+ * requested point, or until the oplog is closed.
+ */
+class FakeOplog {
+public:
+    void append(Timestamp ts) {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _entries.push_back(BSON("ts" << ts << "op"
+                                     << "n"));
+        _cv.notify_all();
+    }
+
+    void close() {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _closed = true;
+        _cv.notify_all();
+    }
+
+    std::vector<BSONObj> fetch(Timestamp after, int batchSize) {
+        stdx::unique_lock<Latch> lk(_mutex);
+        std::vector<BSONObj> batch;
+        _cv.wait(lk, [&] {
+            batch.clear();
+            for (auto&& entry : _entries) {
+                if (entry["ts"].timestamp() > after && int(batch.size()) < batchSize) {
+                    batch.push_back(entry);
+                }
+            }
+            return _closed || !batch.empty();
+        });
+        return batch;
+    }
+
+private:
+    Mutex _mutex = MONGO_MAKE_LATCH("FakeOplog::_mutex");
+    stdx::condition_variable _cv;
+    std::vector<BSONObj> _entries;
+    bool _closed = false;
+};
+
+class ChangeStreamOplogMultiplexerTest : public ServiceContextTest {
+public:
+    ~ChangeStreamOplogMultiplexerTest() {
+        _oplog.close();
+        _multiplexer.shutdown();
+    }
+
+    std::unique_ptr<ChangeStreamOplogMultiplexer::Subscription> subscribe(Timestamp resumeAfter) {
+        return _multiplexer.subscribe(_opCtx.get(), resumeAfter);
+    }
+
+    /**
+     * Pulls 'numEntries' entries from 'subscription', waiting for the reader as needed, and
+     * returns their timestamps.
+     */
+    std::vector<Timestamp> pull(ChangeStreamOplogMultiplexer::Subscription* subscription,
+                                size_t numEntries) {
+        std::deque<BSONObj> entries;
+        const auto deadline = Date_t::now() + Seconds(30);
+        while (entries.size() < numEntries) {
+            if (subscription->pull(&entries, numEntries - entries.size()) == 0) {
+                ASSERT_FALSE(subscription->isDetached());
+                ASSERT_LT(Date_t::now(), deadline);
+                subscription->waitForEntries(_opCtx.get(), deadline);
+            }
+        }
+
+        std::vector<Timestamp> timestamps;
+        for (auto&& entry : entries) {
+            timestamps.push_back(entry["ts"].timestamp());
+        }
+        return timestamps;
+    }
+
+protected:
+    ServiceContext::UniqueOperationContext _opCtx = makeOperationContext();
+    FakeOplog _oplog;
+    ChangeStreamOplogMultiplexer _multiplexer{
+        [this](OperationContext*, Timestamp after, int batchSize) {
+            return _oplog.fetch(after, batchSize);
+        }};
+};
+
+TEST_F(ChangeStreamOplogMultiplexerTest, FansOutEveryEntryToEverySubscriber) {
+    auto first = subscribe(Timestamp(10, 0));
+    auto second = subscribe(Timestamp(10, 0));
+    ASSERT(first && second);
+    ASSERT_EQ(_multiplexer.getNumSubscribers(), 2U);
+
+    for (uint32_t i = 1; i <= 3; ++i) {
+        _oplog.append(Timestamp(10, i));
+    }
+
+    const std::vector<Timestamp> expected{Timestamp(10, 1), Timestamp(10, 2), Timestamp(10, 3)};
+    ASSERT(pull(first.get(), 3) == expected);
+    ASSERT(pull(second.get(), 3) == expected);
+    ASSERT_EQ(first->getPosition(), Timestamp(10, 3));
+}
+
+TEST_F(ChangeStreamOplogMultiplexerTest, LateSubscriberStartsAfterItsPosition) {
+    auto first = subscribe(Timestamp(10, 0));
+    for (uint32_t i = 1; i <= 3; ++i) {
+        _oplog.append(Timestamp(10, i));
+    }
+    ASSERT_EQ(pull(first.get(), 3).size(), 3U);
+
+    // The entries are still buffered, so a stream which has seen the first two can join.
+    auto second = subscribe(Timestamp(10, 2));
+    ASSERT(second);
+    ASSERT(pull(second.get(), 1) == std::vector<Timestamp>{Timestamp(10, 3)});
+}
+
+TEST_F(ChangeStreamOplogMultiplexerTest, RejectsSubscriberWhoseEntriesWereEvicted) {
+    RAIIServerParameterControllerForTest bufferSize{"internalChangeStreamSharedOplogScanBufferSize",
+                                                    2};
+    auto first = subscribe(Timestamp(10, 0));
+    _oplog.append(Timestamp(10, 1));
+    _oplog.append(Timestamp(10, 2));
+    ASSERT_EQ(pull(first.get(), 2).size(), 2U);
+
+    // Appending a third entry to the full buffer evicts the first one.
+    _oplog.append(Timestamp(10, 3));
+    ASSERT_EQ(pull(first.get(), 1).size(), 1U);
+
+    ASSERT_FALSE(subscribe(Timestamp(10, 0)));
+    auto second = subscribe(Timestamp(10, 1));
+    ASSERT(second);
+    ASSERT_EQ(pull(second.get(), 2).size(), 2U);
+}
+
+TEST_F(ChangeStreamOplogMultiplexerTest, DetachesSlowSubscriber) {
+    RAIIServerParameterControllerForTest bufferSize{"internalChangeStreamSharedOplogScanBufferSize",
+                                                    2};
+    RAIIServerParameterControllerForTest slowConsumerTimeout{
+        "internalChangeStreamSharedOplogScanSlowConsumerTimeoutMS", 0};
+    auto fast = subscribe(Timestamp(10, 0));
+    auto slow = subscribe(Timestamp(10, 0));
+    _oplog.append(Timestamp(10, 1));
+    _oplog.append(Timestamp(10, 2));
+    ASSERT_EQ(pull(fast.get(), 2).size(), 2U);
+
+    // The slow subscriber holds back the oldest entry, so it is detached to make room.
+    _oplog.append(Timestamp(10, 3));
+    ASSERT(pull(fast.get(), 1) == std::vector<Timestamp>{Timestamp(10, 3)});
+    ASSERT(slow->isDetached());
+    ASSERT_EQ(slow->getPosition(), Timestamp(10, 0));
+    ASSERT_EQ(_multiplexer.getNumSubscribers(), 1U);
+
+    std::deque<BSONObj> entries;
+    ASSERT_EQ(slow->pull(&entries, 10), 0U);
+}
+
+TEST_F(ChangeStreamOplogMultiplexerTest, RestartsFromNextSubscriberWhenIdle) {
+    auto first = subscribe(Timestamp(10, 0));
+    _oplog.append(Timestamp(10, 1));
+    _oplog.append(Timestamp(10, 2));
+    ASSERT_EQ(pull(first.get(), 2).size(), 2U);
+    first.reset();
+    ASSERT_EQ(_multiplexer.getNumSubscribers(), 0U);
+
+    // With nobody subscribed the buffer is dropped, and the reader starts over at the position of
+    // the next subscriber, however far back it is.
+    auto second = subscribe(Timestamp(5, 0));
+    ASSERT(second);
+    ASSERT(pull(second.get(), 2) == (std::vector<Timestamp>{Timestamp(10, 1), Timestamp(10, 2)}));
+}
+
+TEST_F(ChangeStreamOplogMultiplexerTest, ShutdownDetachesSubscribers) {
+    auto subscription = subscribe(Timestamp(10, 0));
+    _oplog.close();
+    _multiplexer.shutdown();
+
+    ASSERT(subscription->isDetached());
+    ASSERT_FALSE(subscribe(Timestamp(10, 0)));
+}
+
+}  // namespace
+}  // namespace mongo
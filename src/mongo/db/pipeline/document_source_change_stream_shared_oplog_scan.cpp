@@ -0,0 +1,247 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_change_stream_shared_oplog_scan.h"
+
+#include "mongo/db/curop.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/extensions_callback_noop.h"
+#include "mongo/db/pipeline/document_source_change_stream_gen.h"
+#include "mongo/db/pipeline/document_source_change_stream_oplog_match.h"
+#include "mongo/db/query/find_common.h"
+#include "mongo/db/query/plan_executor.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/repl/optime.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/s/resharding/resume_token_gen.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+// The maximum number of entries that the stage pulls from its subscription at a time.
+constexpr size_t kMaxEntriesPerPull = 128;
+
+}  // namespace
+
+bool DocumentSourceChangeStreamSharedOplogScan::canUseSharedOplogScan(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx, const NamespaceString& nss) {
+    // Only a top-level change stream which reads the oplog itself can share its scan. The private
+    // cursors which this stage opens run as sub-pipelines, and so never nest another shared scan.
+    return internalChangeStreamUseSharedOplogScan.load() &&
+        nss == NamespaceString::kRsOplogNamespace && !expCtx->explain &&
+        expCtx->subPipelineDepth == 0 && expCtx->isTailableAwaitData();
+}
+
+boost::intrusive_ptr<DocumentSourceChangeStreamSharedOplogScan>
+DocumentSourceChangeStreamSharedOplogScan::create(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    boost::intrusive_ptr<DocumentSourceCursor> cursor,
+    BSONObj filter) {
+    return new DocumentSourceChangeStreamSharedOplogScan(
+        expCtx, std::move(cursor), std::move(filter));
+}
+
+DocumentSourceChangeStreamSharedOplogScan::DocumentSourceChangeStreamSharedOplogScan(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    boost::intrusive_ptr<DocumentSourceCursor> cursor,
+    BSONObj filter)
+    : DocumentSource(kStageName, expCtx),
+      _filter(filter.getOwned()),
+      _privateCursor(std::move(cursor)) {
+    // The oplog filter always runs with the simple collation, as it does in the $cursor stage.
+    auto collatorStash = pExpCtx->temporarilyChangeCollator(nullptr);
+    _matcher = uassertStatusOK(MatchExpressionParser::parse(
+        _filter, pExpCtx, ExtensionsCallbackNoop(), Pipeline::kAllowedMatcherFeatures));
+}
+
+DocumentSource::GetNextResult DocumentSourceChangeStreamSharedOplogScan::doGetNext() {
+    bool subscribed = false;
+    while (true) {
+        if (_subscription) {
+            if (auto next = _getNextFromSharedScan()) {
+                return std::move(*next);
+            }
+            _openPrivateCursor();
+        }
+
+        auto next = _privateCursor->getNext();
+        _latestOplogTimestamp =
+            std::max(_latestOplogTimestamp, _privateCursor->getLatestOplogTimestamp());
+
+        // The private cursor has caught up with the oplog. Try once per call to hand the scan over
+        // to the shared reader, so that a stream which is detached right away does not spin.
+        if (next.isEOF() && !subscribed && _trySubscribe()) {
+            subscribed = true;
+            continue;
+        }
+        return next;
+    }
+}
+
+boost::optional<DocumentSource::GetNextResult>
+DocumentSourceChangeStreamSharedOplogScan::_getNextFromSharedScan() {
+    bool waited = false;
+    while (true) {
+        while (!_pulledEntries.empty()) {
+            auto entry = std::move(_pulledEntries.front());
+            _pulledEntries.pop_front();
+            _latestOplogTimestamp = entry[repl::OpTime::kTimestampFieldName].timestamp();
+            if (_matcher->matchesBSON(entry)) {
+                return GetNextResult(Document(entry));
+            }
+        }
+
+        pExpCtx->checkForInterrupt();
+        if (_subscription->pull(&_pulledEntries, kMaxEntriesPerPull) > 0) {
+            continue;
+        }
+
+        if (_subscription->isDetached()) {
+            return boost::none;
+        }
+
+        if (waited || !_shouldWaitForEntries()) {
+            return GetNextResult::makeEOF();
+        }
+
+        auto curOp = CurOp::get(pExpCtx->opCtx);
+        curOp->pauseTimer();
+        ON_BLOCK_EXIT([curOp] { curOp->resumeTimer(); });
+        _subscription->waitForEntries(pExpCtx->opCtx,
+                                      awaitDataState(pExpCtx->opCtx).waitForInsertsDeadline);
+        waited = true;
+    }
+}
+
+bool DocumentSourceChangeStreamSharedOplogScan::_shouldWaitForEntries() const {
+    // This mirrors the conditions under which the $cursor stage waits for oplog inserts.
+    auto opCtx = pExpCtx->opCtx;
+    if (!awaitDataState(opCtx).shouldWaitForInserts || !opCtx->checkForInterruptNoAssert().isOK() ||
+        awaitDataState(opCtx).waitForInsertsDeadline <=
+            opCtx->getServiceContext()->getPreciseClockSource()->now()) {
+        return false;
+    }
+
+    // Return right away if the majority commit point has moved past the one that the client knows
+    // about, so that the client learns of the new one.
+    if (!clientsLastKnownCommittedOpTime(opCtx).isNull()) {
+        auto replCoord = repl::ReplicationCoordinator::get(opCtx);
+        return clientsLastKnownCommittedOpTime(opCtx) >= replCoord->getLastCommittedOpTime();
+    }
+    return true;
+}
+
+bool DocumentSourceChangeStreamSharedOplogScan::_trySubscribe() {
+    if (!internalChangeStreamUseSharedOplogScan.load()) {
+        return false;
+    }
+
+    const auto resumeAfter = _privateCursor->getLatestOplogTimestamp();
+    if (resumeAfter.isNull()) {
+        return false;
+    }
+
+    auto opCtx = pExpCtx->opCtx;
+    _subscription = ChangeStreamOplogMultiplexer::get(opCtx->getServiceContext())
+                        ->subscribe(opCtx, resumeAfter);
+    if (!_subscription) {
+        return false;
+    }
+
+    _disposePrivateCursor();
+    return true;
+}
+
+void DocumentSourceChangeStreamSharedOplogScan::_openPrivateCursor() {
+    invariant(_subscription && _subscription->isDetached() && _pulledEntries.empty());
+    const auto resumeAfter = _subscription->getPosition();
+    _subscription.reset();
+
+    // Rebuild the change stream's oplog scan with a lower bound after the last entry we pulled.
+    // The sub-pipeline's $cursor stage reports if that point has since fallen off the oplog.
+    auto expCtx = pExpCtx->copyForSubPipeline(NamespaceString::kRsOplogNamespace);
+    auto filter = BSON("$and" << BSON_ARRAY(
+                           _filter << BSON(repl::OpTime::kTimestampFieldName
+                                           << BSON("$gt" << resumeAfter))));
+    auto spec = BSON(DocumentSourceChangeStreamOplogMatch::kStageName
+                     << DocumentSourceChangeStreamOplogMatchSpec(filter).toBSON());
+    auto pipeline = Pipeline::create(
+        {DocumentSourceChangeStreamOplogMatch::createFromBson(spec.firstElement(), expCtx)},
+        expCtx);
+
+    _privatePipeline =
+        expCtx->mongoProcessInterface->attachCursorSourceToPipelineForLocalRead(pipeline.release());
+    _privateCursor = dynamic_cast<DocumentSourceCursor*>(_privatePipeline->peekFront());
+    tassert(7095755,
+            "Expected the private oplog scan of a change stream to be a $cursor stage",
+            _privateCursor && _privatePipeline->getSources().size() == 1);
+}
+
+void DocumentSourceChangeStreamSharedOplogScan::_disposePrivateCursor() {
+    if (_privatePipeline) {
+        _privatePipeline.get_deleter().dismissDisposal();
+        _privatePipeline->dispose(pExpCtx->opCtx);
+        _privatePipeline.reset();
+    } else if (_privateCursor) {
+        _privateCursor->dispose();
+    }
+    _privateCursor.reset();
+}
+
+void DocumentSourceChangeStreamSharedOplogScan::detachFromOperationContext() {
+    if (_privatePipeline) {
+        _privatePipeline->detachFromOperationContext();
+    } else if (_privateCursor) {
+        _privateCursor->detachFromOperationContext();
+    }
+}
+
+void DocumentSourceChangeStreamSharedOplogScan::reattachToOperationContext(
+    OperationContext* opCtx) {
+    if (_privatePipeline) {
+        _privatePipeline->reattachToOperationContext(opCtx);
+    } else if (_privateCursor) {
+        _privateCursor->reattachToOperationContext(opCtx);
+    }
+}
+
+BSONObj DocumentSourceChangeStreamSharedOplogScan::getPostBatchResumeToken() const {
+    return ResumeTokenOplogTimestamp{getLatestOplogTimestamp()}.toBSON();
+}
+
+void DocumentSourceChangeStreamSharedOplogScan::doDispose() {
+    _subscription.reset();
+    _pulledEntries.clear();
+    _disposePrivateCursor();
+}
+
+}  // namespace mongo
@@ -0,0 +1,171 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/pipeline/change_stream_oplog_multiplexer.h"
+#include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/document_source_cursor.h"
+#include "mongo/db/pipeline/pipeline.h"
+
+namespace mongo {
+
+/**
+ * Takes the place of the $cursor stage of a change stream on the oplog. It starts out reading from
+ * that $cursor, i.e. from the change stream's own oplog cursor. Once the cursor has caught up with
+ * the end of the oplog, the stage subscribes to the ChangeStreamOplogMultiplexer and applies the
+ * change stream's oplog filter to the entries which the shared reader fans out, so that the many
+ * change streams which tail the oplog do not each scan it.
+ *
+ * If the multiplexer detaches the subscription because this change stream does not keep up, the
+ * stage goes back to reading from an oplog cursor of its own, starting after the last entry it
+ * pulled, and subscribes again once that cursor has caught up.
+ */
+class DocumentSourceChangeStreamSharedOplogScan final : public DocumentSource {
+public:
+    static constexpr StringData kStageName = "$_internalChangeStreamSharedOplogScan"_sd;
+
+    /**
+     * Returns true if the change stream pipeline with context 'expCtx' which reads 'nss' should
+     * use a shared oplog scan.
+     */
+    static bool canUseSharedOplogScan(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                      const NamespaceString& nss);
+
+    /**
+     * Creates a stage which reads from 'cursor' until it has caught up with the oplog. 'filter' is
+     * the change stream's oplog filter, which 'cursor' applies as its query.
+     */
+    static boost::intrusive_ptr<DocumentSourceChangeStreamSharedOplogScan> create(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        boost::intrusive_ptr<DocumentSourceCursor> cursor,
+        BSONObj filter);
+
+    const char* getSourceName() const final {
+        return kStageName.rawData();
+    }
+
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final {
+        // Like $cursor, this stage is never parsed, and it is not used for explain.
+        return Value();
+    }
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        StageConstraints constraints(StreamType::kStreaming,
+                                     PositionRequirement::kFirst,
+                                     HostTypeRequirement::kAnyShard,
+                                     DiskUseRequirement::kNoDiskUse,
+                                     FacetRequirement::kNotAllowed,
+                                     TransactionRequirement::kNotAllowed,
+                                     LookupRequirement::kNotAllowed,
+                                     UnionRequirement::kNotAllowed);
+
+        constraints.requiresInputDocSource = false;
+        return constraints;
+    }
+
+    boost::optional<DistributedPlanLogic> distributedPlanLogic() final {
+        return boost::none;
+    }
+
+    void addVariableRefs(std::set<Variables::Id>* refs) const final {}
+
+    void detachFromOperationContext() final;
+
+    void reattachToOperationContext(OperationContext* opCtx) final;
+
+    /**
+     * Returns the timestamp up to which this stage has observed the oplog.
+     */
+    Timestamp getLatestOplogTimestamp() const {
+        return _latestOplogTimestamp;
+    }
+
+    BSONObj getPostBatchResumeToken() const;
+
+    /**
+     * Returns true while the stage reads from the shared oplog scan rather than its own cursor.
+     */
+    bool isUsingSharedOplogScan() const {
+        return bool(_subscription);
+    }
+
+private:
+    DocumentSourceChangeStreamSharedOplogScan(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                              boost::intrusive_ptr<DocumentSourceCursor> cursor,
+                                              BSONObj filter);
+
+    GetNextResult doGetNext() final;
+
+    void doDispose() final;
+
+    /**
+     * Returns the next matching entry from the shared oplog scan, EOF, or boost::none if the
+     * subscription was detached and everything pulled before the detach has been returned.
+     */
+    boost::optional<GetNextResult> _getNextFromSharedScan();
+
+    /**
+     * Hands the scan over to the multiplexer if it still buffers everything after the oplog
+     * position of the private cursor. Disposes of the cursor on success.
+     */
+    bool _trySubscribe();
+
+    /**
+     * Opens a new private oplog cursor which resumes after the last entry pulled from the detached
+     * subscription.
+     */
+    void _openPrivateCursor();
+
+    void _disposePrivateCursor();
+
+    bool _shouldWaitForEntries() const;
+
+    // The change stream's oplog filter, and the same filter parsed with the simple collation.
+    const BSONObj _filter;
+    std::unique_ptr<MatchExpression> _matcher;
+
+    // The private oplog cursor, when the stage is not using the shared scan. If the cursor was
+    // opened by this stage, '_privatePipeline' holds the pipeline which contains it.
+    boost::intrusive_ptr<DocumentSourceCursor> _privateCursor;
+    std::unique_ptr<Pipeline, PipelineDeleter> _privatePipeline;
+
+    // The subscription to the shared scan, and the entries pulled from it that we have yet to
+    // filter and return.
+    std::unique_ptr<ChangeStreamOplogMultiplexer::Subscription> _subscription;
+    std::deque<BSONObj> _pulledEntries;
+
+    Timestamp _latestOplogTimestamp;
+};
+
+}  // namespace mongo
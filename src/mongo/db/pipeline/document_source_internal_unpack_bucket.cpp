@@ -57,7 +57,9 @@
 #include "mongo/db/pipeline/document_source_single_document_transformation.h"
 #include "mongo/db/pipeline/document_source_sort.h"
 #include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/expression_dependencies.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
+#include "mongo/db/query/query_feature_flags_gen.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/db/query/util/make_data_structure.h"
 #include "mongo/db/timeseries/timeseries_constants.h"
@@ -230,6 +232,120 @@ boost::intrusive_ptr<DocumentSourceGroup> createBucketGroupForReorder(
     return DocumentSourceGroup::create(expCtx, groupByExpr, accumulators);
 }
 
+/**
+ * Returns true if 'expr' evaluates to the same value for every measurement of a bucket whose
+ * earliest and latest times evaluate to the same value. This holds for constants, paths on the
+ * metaField and $dateTrunc of the timeField with constant arguments, since truncation is monotonic
+ * in time, and for objects composed of those.
+ */
+bool isBucketLevelGroupKey(const Expression* expr, const BucketSpec& spec) {
+    if (dynamic_cast<const ExpressionConstant*>(expr)) {
+        return true;
+    }
+
+    if (const auto* exprPath = dynamic_cast<const ExpressionFieldPath*>(expr)) {
+        const auto& path = exprPath->getFieldPath();
+        return !exprPath->isVariableReference() && spec.metaField() && path.getPathLength() > 1 &&
+            path.getFieldName(1) == *spec.metaField();
+    }
+
+    if (const auto* exprDateTrunc = dynamic_cast<const ExpressionDateTrunc*>(expr)) {
+        const auto& children = exprDateTrunc->getChildren();
+        const auto* datePath = dynamic_cast<const ExpressionFieldPath*>(children[0].get());
+        if (!datePath || datePath->isVariableReference() ||
+            datePath->getFieldPath().getPathLength() != 2 ||
+            datePath->getFieldPath().getFieldName(1) != spec.timeField()) {
+            return false;
+        }
+        return std::all_of(std::next(children.begin()), children.end(), [](auto&& child) {
+            return !child || dynamic_cast<const ExpressionConstant*>(child.get());
+        });
+    }
+
+    if (const auto* exprObject = dynamic_cast<const ExpressionObject*>(expr)) {
+        const auto& children = exprObject->getChildExpressions();
+        return std::all_of(children.begin(), children.end(), [&](auto&& child) {
+            return isBucketLevelGroupKey(child.second.get(), spec);
+        });
+    }
+
+    return false;
+}
+
+DocumentSourceInternalUnpackBucket::BucketLevelGroup parseBucketLevelGroup(
+    BSONElement specElem, const boost::intrusive_ptr<ExpressionContext>& expCtx) {
+    DocumentSourceInternalUnpackBucket::BucketLevelGroup bucketLevelGroup;
+    auto parseFields = [](BSONElement elem, auto& fields) {
+        uassert(7095710,
+                str::stream() << DocumentSourceInternalUnpackBucket::kBucketLevelGroup << "."
+                              << elem.fieldNameStringData()
+                              << " field must be an object, got: " << elem.type(),
+                elem.type() == BSONType::Object);
+        for (auto&& field : elem.embeddedObject()) {
+            uassert(7095711,
+                    str::stream() << DocumentSourceInternalUnpackBucket::kBucketLevelGroup << "."
+                                  << elem.fieldNameStringData()
+                                  << " must map each output field to a string, got: "
+                                  << field.type(),
+                    field.type() == BSONType::String);
+            fields.emplace_back(field.fieldName(), field.str());
+        }
+    };
+
+    for (auto&& elem : specElem.embeddedObject()) {
+        auto fieldName = elem.fieldNameStringData();
+        if (fieldName == "key"_sd) {
+            bucketLevelGroup.key =
+                Expression::parseOperand(expCtx.get(), elem, expCtx->variablesParseState);
+        } else if (fieldName == "min"_sd) {
+            parseFields(elem, bucketLevelGroup.minFields);
+        } else if (fieldName == "max"_sd) {
+            parseFields(elem, bucketLevelGroup.maxFields);
+        } else if (fieldName == "count"_sd) {
+            uassert(7095712,
+                    str::stream() << DocumentSourceInternalUnpackBucket::kBucketLevelGroup
+                                  << ".count field must be a string, got: " << elem.type(),
+                    elem.type() == BSONType::String);
+            bucketLevelGroup.countField = elem.str();
+        } else {
+            uasserted(7095713,
+                      str::stream() << "unrecognized parameter to "
+                                    << DocumentSourceInternalUnpackBucket::kBucketLevelGroup << ": "
+                                    << fieldName);
+        }
+    }
+
+    uassert(7095714,
+            str::stream() << DocumentSourceInternalUnpackBucket::kBucketLevelGroup
+                          << " requires a key",
+            bucketLevelGroup.key);
+    return bucketLevelGroup;
+}
+
+Value serializeBucketLevelGroup(
+    const DocumentSourceInternalUnpackBucket::BucketLevelGroup& bucketLevelGroup) {
+    auto serializeFields = [](const auto& fields) {
+        MutableDocument out;
+        for (auto&& [outputField, field] : fields) {
+            out.addField(outputField, Value{field});
+        }
+        return out.freezeToValue();
+    };
+
+    MutableDocument out;
+    out.addField("key", bucketLevelGroup.key->serialize(false));
+    if (!bucketLevelGroup.minFields.empty()) {
+        out.addField("min", serializeFields(bucketLevelGroup.minFields));
+    }
+    if (!bucketLevelGroup.maxFields.empty()) {
+        out.addField("max", serializeFields(bucketLevelGroup.maxFields));
+    }
+    if (bucketLevelGroup.countField) {
+        out.addField("count", Value{*bucketLevelGroup.countField});
+    }
+    return out.freezeToValue();
+}
+
 // Optimize the section of the pipeline before the $_internalUnpackBucket stage.
 void optimizePrefix(Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
     auto prefix = Pipeline::SourceContainer(container->begin(), itr);
@@ -299,6 +415,7 @@ boost::intrusive_ptr<DocumentSource> DocumentSourceInternalUnpackBucket::createF
     std::vector<std::string> computedMetaProjFields;
     boost::optional<BSONObj> eventFilterBson;
     boost::optional<BSONObj> wholeBucketFilterBson;
+    boost::optional<BucketLevelGroup> bucketLevelGroup;
     for (auto&& elem : specElem.embeddedObject()) {
         auto fieldName = elem.fieldNameStringData();
         if (fieldName == kInclude || fieldName == kExclude) {
@@ -392,6 +509,22 @@ boost::intrusive_ptr<DocumentSource> DocumentSourceInternalUnpackBucket::createF
                                   << " field must be a bool, got: " << elem.type(),
                     elem.type() == BSONType::Bool);
             bucketSpec.setUsesExtendedRange(elem.boolean());
+        } else if (fieldName == kBloomFilterFields) {
+            uassert(7095717,
+                    str::stream() << kBloomFilterFields
+                                  << " field must be an array, got: " << elem.type(),
+                    elem.type() == BSONType::Array);
+
+            std::set<std::string> bloomFilterFields;
+            for (auto&& elt : elem.embeddedObject()) {
+                uassert(7095718,
+                        str::stream() << kBloomFilterFields
+                                      << " field element must be a single-element field path",
+                        elt.type() == BSONType::String &&
+                            elt.valueStringData().find('.') == std::string::npos);
+                bloomFilterFields.insert(elt.str());
+            }
+            bucketSpec.setBloomFilterFields(std::move(bloomFilterFields));
         } else if (fieldName == kEventFilter) {
             uassert(7026902,
                     str::stream() << kEventFilter
@@ -404,6 +537,12 @@ boost::intrusive_ptr<DocumentSource> DocumentSourceInternalUnpackBucket::createF
                                   << " field must be an object, got: " << elem.type(),
                     elem.type() == BSONType::Object);
             wholeBucketFilterBson = elem.Obj();
+        } else if (fieldName == kBucketLevelGroup) {
+            uassert(7095709,
+                    str::stream() << kBucketLevelGroup
+                                  << " field must be an object, got: " << elem.type(),
+                    elem.type() == BSONType::Object);
+            bucketLevelGroup = parseBucketLevelGroup(elem, expCtx);
         } else {
             uasserted(5346506,
                       str::stream()
@@ -418,13 +557,15 @@ boost::intrusive_ptr<DocumentSource> DocumentSourceInternalUnpackBucket::createF
             "The $_internalUnpackBucket stage requires a bucketMaxSpanSeconds parameter",
             hasBucketMaxSpanSeconds);
 
-    return make_intrusive<DocumentSourceInternalUnpackBucket>(
+    auto unpack = make_intrusive<DocumentSourceInternalUnpackBucket>(
         expCtx,
         BucketUnpacker{std::move(bucketSpec), unpackerBehavior},
         bucketMaxSpanSeconds,
         eventFilterBson,
         wholeBucketFilterBson,
         assumeClean);
+    unpack->_bucketLevelGroup = std::move(bucketLevelGroup);
+    return unpack;
 }
 
 boost::intrusive_ptr<DocumentSource> DocumentSourceInternalUnpackBucket::createFromBsonExternal(
@@ -505,6 +646,14 @@ void DocumentSourceInternalUnpackBucket::serializeToArray(
     if (_assumeNoMixedSchemaData)
         out.addField(kAssumeNoMixedSchemaData, Value(_assumeNoMixedSchemaData));
 
+    if (!spec.bloomFilterFields().empty()) {
+        std::vector<Value> bloomFields;
+        for (auto&& field : spec.bloomFilterFields()) {
+            bloomFields.emplace_back(field);
+        }
+        out.addField(kBloomFilterFields, Value{std::move(bloomFields)});
+    }
+
     if (!spec.computedMetaProjFields().empty())
         out.addField("computedMetaProjFields", Value{[&] {
                          std::vector<Value> compFields;
@@ -528,6 +677,9 @@ void DocumentSourceInternalUnpackBucket::serializeToArray(
     if (_eventFilter) {
         out.addField(kEventFilter, Value{_eventFilter->serialize()});
     }
+    if (_bucketLevelGroup) {
+        out.addField(kBucketLevelGroup, serializeBucketLevelGroup(*_bucketLevelGroup));
+    }
 
     if (!explain) {
         array.push_back(Value(DOC(getSourceName() << out.freeze())));
@@ -544,6 +696,13 @@ void DocumentSourceInternalUnpackBucket::serializeToArray(
     }
 }
 
+bool DocumentSourceInternalUnpackBucket::sbeCompatible() const {
+    return !_sampleSize && _bucketUnpacker.behavior() == BucketUnpacker::Behavior::kInclude &&
+        _bucketUnpacker.bucketSpec().computedMetaProjFields().empty() &&
+        !_bucketUnpacker.includeMinTimeAsMetadata() &&
+        !_bucketUnpacker.includeMaxTimeAsMetadata() && !_bucketLevelGroup;
+}
+
 boost::optional<Document> DocumentSourceInternalUnpackBucket::getNextMatchingMeasure() {
     while (_bucketUnpacker.hasNext()) {
         auto measure = _bucketUnpacker.getNext();
@@ -563,9 +722,141 @@ boost::optional<Document> DocumentSourceInternalUnpackBucket::getNextMatchingMea
     return {};
 }
 
+boost::optional<Document> DocumentSourceInternalUnpackBucket::aggregateWholeBucket(
+    const BSONObj& bucket) const {
+    const auto& spec = _bucketUnpacker.bucketSpec();
+    auto control = bucket[timeseries::kBucketControlFieldName];
+    if (control.type() != BSONType::Object) {
+        return boost::none;
+    }
+    auto controlMin = control.Obj()[timeseries::kBucketControlMinFieldName];
+    auto controlMax = control.Obj()[timeseries::kBucketControlMaxFieldName];
+    if (controlMin.type() != BSONType::Object || controlMax.type() != BSONType::Object) {
+        return boost::none;
+    }
+
+    auto minTime = controlMin.Obj()[spec.timeField()];
+    auto maxTime = controlMax.Obj()[spec.timeField()];
+    if (minTime.type() != BSONType::Date || maxTime.type() != BSONType::Date) {
+        return boost::none;
+    }
+
+    auto meta = bucket[timeseries::kBucketMetaFieldName];
+    auto makePartial = [&](const BSONElement& time) {
+        MutableDocument partial;
+        partial.addField(spec.timeField(), Value{time});
+        if (spec.metaField() && meta) {
+            partial.addField(*spec.metaField(), Value{meta});
+        }
+        return partial.freeze();
+    };
+
+    // 'control.min' of the time field is rounded down, so it may fall before the first
+    // measurement. The group key is monotonic in time, so if both bounds produce the same key then
+    // so does every measurement in between.
+    auto& variables = pExpCtx->variables;
+    auto minKey = _bucketLevelGroup->key->evaluate(makePartial(minTime), &variables);
+    auto maxKey = _bucketLevelGroup->key->evaluate(makePartial(maxTime), &variables);
+    if (pExpCtx->getValueComparator().evaluate(minKey != maxKey)) {
+        return boost::none;
+    }
+
+    MutableDocument partial{makePartial(maxTime)};
+    for (auto&& [outputField, field] : _bucketLevelGroup->minFields) {
+        // $min ignores nullish values but they sort lowest in 'control.min', and arrays and
+        // objects are bounded field by field, so neither can be answered from the control field.
+        auto min = controlMin.Obj()[field];
+        if (min.isNull() || min.type() == BSONType::Undefined || min.type() == BSONType::Array ||
+            min.type() == BSONType::Object) {
+            return boost::none;
+        }
+        if (min) {
+            partial.addField(outputField, Value{min});
+        }
+    }
+    for (auto&& [outputField, field] : _bucketLevelGroup->maxFields) {
+        auto max = controlMax.Obj()[field];
+        if (max.type() == BSONType::Array || max.type() == BSONType::Object) {
+            return boost::none;
+        }
+        if (max) {
+            partial.addField(outputField, Value{max});
+        }
+    }
+    if (_bucketLevelGroup->countField) {
+        // Only some compressed buckets record their count. Uncompressed buckets store each
+        // measurement as a separate field under the time column.
+        auto count = control.Obj()[timeseries::kBucketControlCountFieldName];
+        auto timeColumn = bucket[timeseries::kBucketDataFieldName].type() == BSONType::Object
+            ? bucket[timeseries::kBucketDataFieldName].Obj()[spec.timeField()]
+            : BSONElement{};
+        if (count.isNumber()) {
+            partial.addField(*_bucketLevelGroup->countField, Value{count.numberInt()});
+        } else if (timeColumn.type() == BSONType::Object) {
+            partial.addField(*_bucketLevelGroup->countField,
+                             Value{timeColumn.Obj().nFields()});
+        } else {
+            return boost::none;
+        }
+    }
+    return partial.freeze();
+}
+
+Document DocumentSourceInternalUnpackBucket::makeBucketLevelGroupPartial(
+    const Document& measure) const {
+    const auto& spec = _bucketUnpacker.bucketSpec();
+    MutableDocument partial;
+    auto addIfPresent = [&](const std::string& outputField, StringData field) {
+        if (auto value = measure[field]; !value.missing()) {
+            partial.addField(outputField, std::move(value));
+        }
+    };
+    addIfPresent(spec.timeField(), spec.timeField());
+    if (spec.metaField()) {
+        addIfPresent(*spec.metaField(), *spec.metaField());
+    }
+    for (auto&& [outputField, field] : _bucketLevelGroup->minFields) {
+        addIfPresent(outputField, field);
+    }
+    for (auto&& [outputField, field] : _bucketLevelGroup->maxFields) {
+        addIfPresent(outputField, field);
+    }
+    if (_bucketLevelGroup->countField) {
+        partial.addField(*_bucketLevelGroup->countField, Value{1});
+    }
+    return partial.freeze();
+}
+
+DocumentSource::GetNextResult DocumentSourceInternalUnpackBucket::getNextBucketLevelGroupPartial() {
+    if (_bucketUnpacker.hasNext()) {
+        return GetNextResult(makeBucketLevelGroupPartial(_bucketUnpacker.getNext()));
+    }
+
+    auto nextResult = pSource->getNext();
+    while (nextResult.isAdvanced()) {
+        auto bucket = nextResult.getDocument().toBson();
+        if (auto partial = aggregateWholeBucket(bucket)) {
+            return GetNextResult(std::move(*partial));
+        }
+
+        // The bucket straddles a group boundary, so fall back to one partial per measurement.
+        _bucketUnpacker.reset(std::move(bucket));
+        if (_bucketUnpacker.hasNext()) {
+            return GetNextResult(makeBucketLevelGroupPartial(_bucketUnpacker.getNext()));
+        }
+        nextResult = pSource->getNext();
+    }
+
+    return nextResult;
+}
+
 DocumentSource::GetNextResult DocumentSourceInternalUnpackBucket::doGetNext() {
     tassert(5521502, "calling doGetNext() when '_sampleSize' is set is disallowed", !_sampleSize);
 
+    if (_bucketLevelGroup) {
+        return getNextBucketLevelGroupPartial();
+    }
+
     // Otherwise, fallback to unpacking every measurement in all buckets until the child stage is
     // exhausted.
     if (auto measure = getNextMatchingMeasure()) {
@@ -795,6 +1086,9 @@ DocumentSourceInternalUnpackBucket::rewriteGroupByMinMax(Pipeline::SourceContain
             AccumulationExpression accExpr = stmt.expr;
             accExpr.argument = newExpr;
             accumulationStatements.emplace_back(stmt.fieldName, std::move(accExpr));
+        } else {
+            // Accumulators over anything but a path, e.g. $count, cannot be computed per bucket.
+            return {};
         }
     }
 
@@ -824,6 +1118,117 @@ DocumentSourceInternalUnpackBucket::rewriteGroupByMinMax(Pipeline::SourceContain
     }
 }
 
+bool DocumentSourceInternalUnpackBucket::rewriteGroupToBucketLevel(
+    Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
+    const auto* groupPtr = dynamic_cast<DocumentSourceGroup*>(std::next(itr)->get());
+    if (groupPtr == nullptr || groupPtr->doingMerge()) {
+        return false;
+    }
+
+    // The rewritten stage is sent to the shards, which reject the 'bucketLevelGroup' field until
+    // they have all been upgraded.
+    if (!serverGlobalParams.featureCompatibility.isVersionInitialized() ||
+        !feature_flags::gFeatureFlagTimeseriesBucketLevelGroup.isEnabled(
+            serverGlobalParams.featureCompatibility)) {
+        return false;
+    }
+
+    // Every measurement of a bucket must reach the $group for the control fields to describe
+    // them.
+    if (_bucketLevelGroup || _eventFilter || _wholeBucketFilter || _sampleSize ||
+        haveComputedMetaField() || _bucketUnpacker.includeMinTimeAsMetadata() ||
+        _bucketUnpacker.includeMaxTimeAsMetadata()) {
+        return false;
+    }
+
+    const auto& spec = _bucketUnpacker.bucketSpec();
+    for (auto&& [_, exprId] : groupPtr->getIdFields()) {
+        if (!isBucketLevelGroupKey(exprId.get(), spec)) {
+            return false;
+        }
+    }
+
+    // A constant key needs no unpacked fields at all and is left to the dependency analysis
+    // below, which already avoids materializing measurements for e.g. $count.
+    BucketLevelGroup bucketLevelGroup;
+    bucketLevelGroup.key = groupPtr->getIdExpression();
+    DepsTracker keyDeps;
+    expression::addDependencies(bucketLevelGroup.key.get(), &keyDeps);
+    if (keyDeps.fields.empty()) {
+        return false;
+    }
+
+    std::set<std::string> fields;
+    for (auto&& path : keyDeps.fields) {
+        fields.insert(path.substr(0, path.find('.')));
+    }
+
+    std::vector<AccumulationStatement> accumulationStatements;
+    for (const AccumulationStatement& stmt : groupPtr->getAccumulatedFields()) {
+        // The partial aggregates are stored next to the time and meta fields the key reads.
+        if (stmt.fieldName == spec.timeField() ||
+            (spec.metaField() && stmt.fieldName == *spec.metaField())) {
+            return false;
+        }
+
+        const auto& op = stmt.expr.name;
+        const auto* exprArg = stmt.expr.argument.get();
+        if (op == "$min" || op == "$max") {
+            const auto* exprArgPath = dynamic_cast<const ExpressionFieldPath*>(exprArg);
+            if (!exprArgPath || exprArgPath->isVariableReference() ||
+                exprArgPath->getFieldPath().getPathLength() != 2) {
+                return false;
+            }
+
+            // Control fields only bound measurements of a consistent type.
+            auto field = exprArgPath->getFieldPath().getFieldName(1).toString();
+            if (!_assumeNoMixedSchemaData || field == spec.timeField() ||
+                (spec.metaField() && field == *spec.metaField())) {
+                return false;
+            }
+
+            auto& outputFields =
+                op == "$min" ? bucketLevelGroup.minFields : bucketLevelGroup.maxFields;
+            outputFields.emplace_back(stmt.fieldName, field);
+            fields.insert(std::move(field));
+        } else if (op == "$sum") {
+            // Only {$sum: 1}, which is what $count desugars to, can be answered with the bucket's
+            // measurement count while preserving the result type.
+            const auto* exprArgConst = dynamic_cast<const ExpressionConstant*>(exprArg);
+            if (!exprArgConst || exprArgConst->getValue().getType() != BSONType::NumberInt ||
+                exprArgConst->getValue().getInt() != 1 || bucketLevelGroup.countField) {
+                return false;
+            }
+            bucketLevelGroup.countField = stmt.fieldName;
+        } else {
+            return false;
+        }
+
+        AccumulationExpression accExpr = stmt.expr;
+        accExpr.argument = ExpressionFieldPath::createPathFromString(
+            pExpCtx.get(), stmt.fieldName, pExpCtx->variablesParseState);
+        accumulationStatements.emplace_back(stmt.fieldName, std::move(accExpr));
+    }
+
+    auto newGroup = DocumentSourceGroup::create(pExpCtx,
+                                                bucketLevelGroup.key,
+                                                std::move(accumulationStatements),
+                                                groupPtr->getMaxMemoryUsageBytes());
+
+    // Straddling buckets are unpacked into exactly the fields the partial aggregates read, so no
+    // other projection may be internalized from now on.
+    BucketSpec newSpec{
+        spec.timeField(), spec.metaField(), std::move(fields), {}, spec.usesExtendedRange()};
+    newSpec.setBloomFilterFields(spec.bloomFilterFields());
+    _bucketUnpacker.setBucketSpecAndBehavior(std::move(newSpec),
+                                             BucketUnpacker::Behavior::kInclude);
+    _bucketLevelGroup = std::move(bucketLevelGroup);
+    _triedInternalizeProject = true;
+
+    *std::next(itr) = std::move(newGroup);
+    return true;
+}
+
 bool DocumentSourceInternalUnpackBucket::haveComputedMetaField() const {
     return _bucketUnpacker.bucketSpec().metaField() &&
         _bucketUnpacker.bucketSpec().fieldIsComputed(
@@ -1207,6 +1612,12 @@ Pipeline::SourceContainer::iterator DocumentSourceInternalUnpackBucket::doOptimi
             return itr;
         }
     }
+    if (_bucketLevelGroup) {
+        // The following $group consumes the partial aggregates produced by this stage, so the
+        // unpacked fields must stay as they are.
+        return container->end();
+    }
+
     {
         // Check if we can avoid unpacking if we have a group stage with min/max aggregates.
         auto [success, result] = rewriteGroupByMinMax(itr, container);
@@ -1215,6 +1626,12 @@ Pipeline::SourceContainer::iterator DocumentSourceInternalUnpackBucket::doOptimi
         }
     }
 
+    // Otherwise check if the group can be computed at bucket granularity, unpacking only the
+    // buckets which straddle a group boundary.
+    if (rewriteGroupToBucketLevel(itr, container)) {
+        return std::next(itr);
+    }
+
     {
         // Check if the rest of the pipeline needs any fields. For example we might only be
         // interested in $count.
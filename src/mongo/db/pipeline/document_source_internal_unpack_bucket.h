@@ -38,6 +38,7 @@
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_match.h"
+#include "mongo/db/pipeline/expression.h"
 
 namespace mongo {
 class DocumentSourceInternalUnpackBucket : public DocumentSource {
@@ -48,11 +49,31 @@ public:
     static constexpr StringData kExclude = "exclude"_sd;
     static constexpr StringData kAssumeNoMixedSchemaData = "assumeNoMixedSchemaData"_sd;
     static constexpr StringData kUsesExtendedRange = "usesExtendedRange"_sd;
+    static constexpr StringData kBloomFilterFields = "bloomFilterFields"_sd;
     static constexpr StringData kBucketMaxSpanSeconds = "bucketMaxSpanSeconds"_sd;
     static constexpr StringData kIncludeMinTimeAsMetadata = "includeMinTimeAsMetadata"_sd;
     static constexpr StringData kIncludeMaxTimeAsMetadata = "includeMaxTimeAsMetadata"_sd;
     static constexpr StringData kWholeBucketFilter = "wholeBucketFilter"_sd;
     static constexpr StringData kEventFilter = "eventFilter"_sd;
+    static constexpr StringData kBucketLevelGroup = "bucketLevelGroup"_sd;
+
+    /**
+     * Describes the partial aggregates produced for a following $group once it has been rewritten
+     * to aggregate at bucket granularity. A bucket whose whole time range maps to a single group
+     * key is reduced to one document computed from its control fields, while any other bucket is
+     * unpacked into one document per measurement with the same shape: the time field, the meta
+     * field and one field per accumulator named after the accumulator's output field.
+     */
+    struct BucketLevelGroup {
+        // The group key, used to decide whether a bucket falls entirely inside one group.
+        boost::intrusive_ptr<Expression> key;
+        // Pairs of (output field, measurement field) answered from 'control.min' and
+        // 'control.max' respectively.
+        std::vector<std::pair<std::string, std::string>> minFields;
+        std::vector<std::pair<std::string, std::string>> maxFields;
+        // Output field answered from 'control.count' or the number of measurements.
+        boost::optional<std::string> countField;
+    };
 
     static boost::intrusive_ptr<DocumentSource> createFromBsonInternal(
         BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& expCtx);
@@ -203,6 +224,17 @@ public:
         return _sampleSize;
     }
 
+    const MatchExpression* eventFilter() const {
+        return _eventFilter.get();
+    }
+
+    /**
+     * Returns true if this stage can be lowered to SBE, that is if it unpacks a fixed set of
+     * top-level fields and does not need to sample buckets, compute meta projections, expose the
+     * bucket bounds as metadata or produce bucket-level partial aggregates.
+     */
+    bool sbeCompatible() const;
+
     /**
      * If the stage after $_internalUnpackBucket is $project, $addFields, or $set, try to extract
      * from it computed meta projections and push them pass the current stage. Return true if the
@@ -227,6 +259,30 @@ public:
     std::pair<bool, Pipeline::SourceContainer::iterator> rewriteGroupByMinMax(
         Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container);
 
+    /**
+     * If the next stage is a $group keyed on the metaField and/or $dateTrunc of the timeField with
+     * only $min, $max and $count accumulators on measurement fields, switches this stage to emit
+     * bucket-level partial aggregates and rewrites the $group to combine them. Buckets that
+     * straddle a group boundary are still unpacked. Returns true if the rewrite was applied.
+     *
+     * Ex: user aggregation of
+     * [{$_internalUnpackBucket: {...}},
+     *  {$group: {_id: {m: "$myMeta", t: {$dateTrunc: {date: "$myTime", unit: "hour"}}},
+     *            hi: {$max: "$temp"}, n: {$count: {}}}}]
+     *
+     * will be rewritten into:
+     * [{$_internalUnpackBucket: {..., bucketLevelGroup: {key: ..., max: {hi: "temp"},
+     *                                                   count: "n"}}},
+     *  {$group: {_id: {m: "$myMeta", t: {$dateTrunc: {date: "$myTime", unit: "hour"}}},
+     *            hi: {$max: "$hi"}, n: {$sum: "$n"}}}]
+     */
+    bool rewriteGroupToBucketLevel(Pipeline::SourceContainer::iterator itr,
+                                   Pipeline::SourceContainer* container);
+
+    const boost::optional<BucketLevelGroup>& bucketLevelGroup() const {
+        return _bucketLevelGroup;
+    }
+
     /**
      * If the current aggregation is a lastpoint-type query (ie. with a $sort on meta and time
      * fields, and a $group with a meta _id and only $first or $last accumulators) we can rewrite
@@ -260,6 +316,17 @@ private:
 
     boost::optional<Document> getNextMatchingMeasure();
 
+    GetNextResult getNextBucketLevelGroupPartial();
+
+    /**
+     * Returns the partial aggregates of 'bucket' computed from its control fields, or boost::none
+     * if the bucket spans more than one group or its control fields cannot answer the
+     * accumulators, in which case the bucket must be unpacked.
+     */
+    boost::optional<Document> aggregateWholeBucket(const BSONObj& bucket) const;
+
+    Document makeBucketLevelGroupPartial(const Document& measure) const;
+
     bool haveComputedMetaField() const;
 
     // If buckets contained a mixed type schema along some path, we have to push down special
@@ -283,6 +350,9 @@ private:
     std::unique_ptr<MatchExpression> _wholeBucketFilter;
     BSONObj _wholeBucketFilterBson;
 
+    // Set when the following $group has been rewritten to consume bucket-level partial aggregates.
+    boost::optional<BucketLevelGroup> _bucketLevelGroup;
+
     bool _optimizedEndOfPipeline = false;
     bool _triedInternalizeProject = false;
     bool _triedLastpointRewrite = false;
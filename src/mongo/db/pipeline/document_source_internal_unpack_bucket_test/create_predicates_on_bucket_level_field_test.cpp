@@ -34,6 +34,7 @@
 #include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/query/util/make_data_structure.h"
+#include "mongo/db/timeseries/bucket_bloom_filter.h"
 
 namespace mongo {
 namespace {
@@ -151,6 +152,41 @@ TEST_F(InternalUnpackBucketPredicateMappingOptimizationTest,
     ASSERT_FALSE(predicate.tightPredicate);
 }
 
+TEST_F(InternalUnpackBucketPredicateMappingOptimizationTest,
+       OptimizeMapsEQPredicatesOnBloomFilterField) {
+    auto pipeline =
+        Pipeline::parse(makeVector(fromjson("{$_internalUnpackBucket: {exclude: [], timeField: "
+                                            "'time', bucketMaxSpanSeconds: 3600, "
+                                            "bloomFilterFields: ['a']}}"),
+                                   fromjson("{$match: {a: {$eq: 1}}}")),
+                        getExpCtx());
+    auto& container = pipeline->getSources();
+
+    ASSERT_EQ(pipeline->getSources().size(), 2U);
+
+    auto original = dynamic_cast<DocumentSourceMatch*>(container.back().get());
+    auto predicate = dynamic_cast<DocumentSourceInternalUnpackBucket*>(container.front().get())
+                         ->createPredicatesOnBucketLevelField(original->getMatchExpression());
+
+    BSONArrayBuilder bitPositions;
+    auto value = BSON("" << 1);
+    for (auto position : timeseries::BucketBloomFilter::bitPositions(value.firstElement())) {
+        bitPositions.append(static_cast<int>(position));
+    }
+    auto bloomPredicate = BSON(
+        "$or" << BSON_ARRAY(BSON("control.bloom.a" << BSON("$bitsAllSet" << bitPositions.arr()))
+                            << fromjson("{'control.bloom.a': {$not: {$type: [5]}}}")));
+
+    ASSERT_BSONOBJ_EQ(predicate.loosePredicate->serialize(true),
+                      BSON("$and" << BSON_ARRAY(
+                               fromjson("{$or: [ {$and:[{'control.min.a': {$_internalExprLte: 1}},"
+                                        "{'control.max.a': {$_internalExprGte: 1}}]},"
+                                        "{$expr: {$ne: [ {$type: [ \"$control.min.a\" ]},"
+                                        "{$type: [ \"$control.max.a\" ]} ]}} ]}")
+                               << bloomPredicate)));
+    ASSERT_FALSE(predicate.tightPredicate);
+}
+
 TEST_F(InternalUnpackBucketPredicateMappingOptimizationTest,
        OptimizeMapsINPredicatesOnControlField) {
     auto pipeline =
@@ -30,7 +30,9 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document_source_internal_unpack_bucket.h"
 #include "mongo/db/query/util/make_data_structure.h"
+#include "mongo/idl/server_parameter_test_util.h"
 
 namespace mongo {
 namespace {
@@ -142,5 +144,100 @@ TEST_F(InternalUnpackBucketGroupReorder, MinMaxGroupOnMetadataNegative1) {
     ASSERT_BSONOBJ_EQ(groupSpecObj, serialized[1]);
 }
 
+TEST_F(InternalUnpackBucketGroupReorder, BucketLevelGroupOnMetaAndDateTrunc) {
+    RAIIServerParameterControllerForTest featureFlag{"featureFlagTimeseriesBucketLevelGroup",
+                                                     true};
+    auto unpackSpecObj = fromjson(
+        "{$_internalUnpackBucket: { include: ['a', 'b', 'c'], metaField: 'meta1', timeField: 't', "
+        "bucketMaxSpanSeconds: 3600, assumeNoMixedSchemaData: true}}");
+    auto groupSpecObj = fromjson(
+        "{$group: {_id: {m: '$meta1.a', t: {$dateTrunc: {date: '$t', unit: 'hour'}}}, hi: {$max: "
+        "'$b'}, lo: {$min: '$c'}, n: {$count: {}}}}");
+
+    auto pipeline = Pipeline::parse(makeVector(unpackSpecObj, groupSpecObj), getExpCtx());
+    pipeline->optimizePipeline();
+
+    auto serialized = pipeline->serializeToBson();
+    ASSERT_EQ(2, serialized.size());
+
+    auto unpack = serialized[0].getObjectField("$_internalUnpackBucket");
+    ASSERT_BSONOBJ_EQ(fromjson("{include: ['b', 'c', 't', 'meta1']}"),
+                      BSON("include" << unpack["include"]));
+    auto bucketLevelGroup = unpack.getObjectField("bucketLevelGroup");
+    ASSERT_BSONOBJ_EQ(fromjson("{lo: 'c'}"), bucketLevelGroup.getObjectField("min"));
+    ASSERT_BSONOBJ_EQ(fromjson("{hi: 'b'}"), bucketLevelGroup.getObjectField("max"));
+    ASSERT_EQ("n", bucketLevelGroup["count"].str());
+
+    auto group = serialized[1].getObjectField("$group");
+    ASSERT_BSONOBJ_EQ(fromjson("{$max: '$hi'}"), group.getObjectField("hi"));
+    ASSERT_BSONOBJ_EQ(fromjson("{$min: '$lo'}"), group.getObjectField("lo"));
+    ASSERT_BSONOBJ_EQ(fromjson("{$sum: '$n'}"), group.getObjectField("n"));
+}
+
+TEST_F(InternalUnpackBucketGroupReorder, BucketLevelGroupCountOnMeta) {
+    RAIIServerParameterControllerForTest featureFlag{"featureFlagTimeseriesBucketLevelGroup",
+                                                     true};
+    auto unpackSpecObj = fromjson(
+        "{$_internalUnpackBucket: { include: ['a', 'b', 'c'], metaField: 'meta1', timeField: 't', "
+        "bucketMaxSpanSeconds: 3600}}");
+    auto groupSpecObj = fromjson("{$group: {_id: '$meta1', n: {$count: {}}}}");
+
+    auto pipeline = Pipeline::parse(makeVector(unpackSpecObj, groupSpecObj), getExpCtx());
+    pipeline->optimizePipeline();
+
+    auto serialized = pipeline->serializeToBson();
+    ASSERT_EQ(2, serialized.size());
+
+    // Counting does not rely on the bucket's min and max, so mixed schema data is fine.
+    ASSERT_BSONOBJ_EQ(
+        fromjson("{$_internalUnpackBucket: { include: ['meta1'], timeField: 't', metaField: "
+                 "'meta1', bucketMaxSpanSeconds: 3600, bucketLevelGroup: {key: '$meta1', count: "
+                 "'n'}}}"),
+        serialized[0]);
+    ASSERT_BSONOBJ_EQ(fromjson("{$group: {_id: '$meta1', n: {$sum: '$n'}}}"), serialized[1]);
+}
+
+TEST_F(InternalUnpackBucketGroupReorder, BucketLevelGroupNegative) {
+    RAIIServerParameterControllerForTest featureFlag{"featureFlagTimeseriesBucketLevelGroup",
+                                                     true};
+    auto unpackSpecObj = fromjson(
+        "{$_internalUnpackBucket: { include: ['a', 'b', 'c'], metaField: 'meta1', timeField: 't', "
+        "bucketMaxSpanSeconds: 3600, assumeNoMixedSchemaData: true}}");
+
+    // The key must not depend on measurement fields, the truncation unit must be constant and only
+    // $min, $max and $count are supported.
+    for (auto&& groupSpec : {"{$group: {_id: '$a', hi: {$max: '$b'}}}",
+                             "{$group: {_id: {$dateTrunc: {date: '$t', unit: '$meta1.unit'}}, hi: "
+                             "{$max: '$b'}}}",
+                             "{$group: {_id: {$dateTrunc: {date: '$t', unit: 'hour'}}, s: {$sum: "
+                             "'$b'}}}"}) {
+        auto groupSpecObj = fromjson(groupSpec);
+        auto pipeline = Pipeline::parse(makeVector(unpackSpecObj, groupSpecObj), getExpCtx());
+        pipeline->optimizePipeline();
+
+        auto serialized = pipeline->serializeToBson();
+        ASSERT_EQ(2, serialized.size());
+        ASSERT_FALSE(serialized[0].getObjectField("$_internalUnpackBucket").hasField(
+            DocumentSourceInternalUnpackBucket::kBucketLevelGroup));
+    }
+}
+
+TEST_F(InternalUnpackBucketGroupReorder, BucketLevelGroupRequiresFeatureFlag) {
+    RAIIServerParameterControllerForTest featureFlag{"featureFlagTimeseriesBucketLevelGroup",
+                                                     false};
+    auto unpackSpecObj = fromjson(
+        "{$_internalUnpackBucket: { include: ['a', 'b', 'c'], metaField: 'meta1', timeField: 't', "
+        "bucketMaxSpanSeconds: 3600}}");
+    auto groupSpecObj = fromjson("{$group: {_id: '$meta1', n: {$count: {}}}}");
+
+    auto pipeline = Pipeline::parse(makeVector(unpackSpecObj, groupSpecObj), getExpCtx());
+    pipeline->optimizePipeline();
+
+    auto serialized = pipeline->serializeToBson();
+    ASSERT_EQ(2, serialized.size());
+    ASSERT_FALSE(serialized[0].getObjectField("$_internalUnpackBucket").hasField(
+        DocumentSourceInternalUnpackBucket::kBucketLevelGroup));
+}
+
 }  // namespace
 }  // namespace mongo
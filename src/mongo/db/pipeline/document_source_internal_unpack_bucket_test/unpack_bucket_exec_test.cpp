@@ -925,5 +925,129 @@ TEST_F(InternalUnpackBucketExecTest, ParserRoundtripsComputedMetaProjFieldOverri
     unpackBucket->serializeToArray(array);
     ASSERT_BSONOBJ_EQ(array[0].getDocument().toBson(), bson);
 }
+
+TEST_F(InternalUnpackBucketExecTest, ParserRoundtripsBucketLevelGroup) {
+    auto bson = fromjson(
+        "{$_internalUnpackBucket: {include: ['a', 'time', 'meta'], timeField: 'time', metaField: "
+        "'meta', bucketMaxSpanSeconds: 3600, assumeNoMixedSchemaData: true, bucketLevelGroup: "
+        "{key: '$meta', min: {lo: 'a'}, max: {hi: 'a'}, count: 'n'}}}");
+    auto array = std::vector<Value>{};
+    DocumentSourceInternalUnpackBucket::createFromBsonInternal(bson.firstElement(), getExpCtx())
+        ->serializeToArray(array);
+    ASSERT_BSONOBJ_EQ(array[0].getDocument().toBson(), bson);
+}
+
+TEST_F(InternalUnpackBucketExecTest, ParserRejectsBucketLevelGroupWithoutKey) {
+    auto bson = fromjson(
+        "{$_internalUnpackBucket: {include: ['a', 'time'], timeField: 'time', "
+        "bucketMaxSpanSeconds: 3600, bucketLevelGroup: {max: {hi: 'a'}}}}");
+    ASSERT_THROWS_CODE(DocumentSourceInternalUnpackBucket::createFromBsonInternal(
+                           bson.firstElement(), getExpCtx()),
+                       AssertionException,
+                       7095714);
+}
+
+TEST_F(InternalUnpackBucketExecTest, BucketLevelGroupAggregatesOnlyAlignedBuckets) {
+    auto expCtx = getExpCtx();
+    auto spec = fromjson(
+        "{$_internalUnpackBucket: {include: ['a', 'time', 'myMeta'], timeField: 'time', "
+        "metaField: 'myMeta', bucketMaxSpanSeconds: 3600, assumeNoMixedSchemaData: true, "
+        "bucketLevelGroup: {key: {m: '$myMeta', t: {$dateTrunc: {date: '$time', unit: 'hour'}}}, "
+        "min: {lo: 'a'}, max: {hi: 'a'}, count: 'n'}}}");
+    auto unpack =
+        DocumentSourceInternalUnpackBucket::createFromBsonInternal(spec.firstElement(), expCtx);
+
+    auto minutes = [](int n) {
+        return Date_t::fromMillisSinceEpoch(n * 60 * 1000);
+    };
+    // The first bucket lies within a single hour and the second one straddles an hour boundary.
+    auto aligned = BSON("control" << BSON("version" << 1 << "min"
+                                                    << BSON("time" << minutes(0) << "a" << 1)
+                                                    << "max"
+                                                    << BSON("time" << minutes(30) << "a" << 5))
+                                  << "meta"
+                                  << "s1"
+                                  << "data"
+                                  << BSON("time" << BSON("0" << minutes(10) << "1" << minutes(30))
+                                                 << "a" << BSON("0" << 5 << "1" << 1)));
+    auto straddling =
+        BSON("control" << BSON("version" << 1 << "min" << BSON("time" << minutes(50) << "a" << 2)
+                                         << "max" << BSON("time" << minutes(70) << "a" << 3))
+                       << "meta"
+                       << "s1"
+                       << "data"
+                       << BSON("time" << BSON("0" << minutes(50) << "1" << minutes(70)) << "a"
+                                      << BSON("0" << 2 << "1" << 3)));
+    auto source = DocumentSourceMock::createForTest(std::vector<BSONObj>{aligned, straddling},
+                                                    expCtx);
+    unpack->setSource(source.get());
+
+    auto next = unpack->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.getDocument(),
+                       Document(BSON("time" << minutes(30) << "myMeta"
+                                            << "s1"
+                                            << "lo" << 1 << "hi" << 5 << "n" << 2)));
+
+    next = unpack->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.getDocument(),
+                       Document(BSON("time" << minutes(50) << "myMeta"
+                                            << "s1"
+                                            << "lo" << 2 << "hi" << 2 << "n" << 1)));
+
+    next = unpack->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.getDocument(),
+                       Document(BSON("time" << minutes(70) << "myMeta"
+                                            << "s1"
+                                            << "lo" << 3 << "hi" << 3 << "n" << 1)));
+
+    next = unpack->getNext();
+    ASSERT_TRUE(next.isEOF());
+}
+
+TEST_F(InternalUnpackBucketExecTest, BucketLevelGroupUnpacksBucketsWithNullMinimum) {
+    auto expCtx = getExpCtx();
+    auto spec = fromjson(
+        "{$_internalUnpackBucket: {include: ['a', 'time', 'myMeta'], timeField: 'time', "
+        "metaField: 'myMeta', bucketMaxSpanSeconds: 3600, assumeNoMixedSchemaData: true, "
+        "bucketLevelGroup: {key: '$myMeta', min: {lo: 'a'}}}}");
+    auto unpack =
+        DocumentSourceInternalUnpackBucket::createFromBsonInternal(spec.firstElement(), expCtx);
+
+    // $min ignores the null measurement, so 'control.min.a' cannot be used as the bucket's minimum.
+    auto bucket = BSON(
+        "control" << BSON("version" << 1 << "min"
+                                    << BSON("time" << Date_t::fromMillisSinceEpoch(0) << "a"
+                                                   << BSONNULL)
+                                    << "max"
+                                    << BSON("time" << Date_t::fromMillisSinceEpoch(1) << "a" << 4))
+                  << "meta"
+                  << "s1"
+                  << "data"
+                  << BSON("time" << BSON("0" << Date_t::fromMillisSinceEpoch(0) << "1"
+                                             << Date_t::fromMillisSinceEpoch(1))
+                                 << "a" << BSON("0" << BSONNULL << "1" << 4)));
+    auto source = DocumentSourceMock::createForTest(std::vector<BSONObj>{bucket}, expCtx);
+    unpack->setSource(source.get());
+
+    auto next = unpack->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.getDocument(),
+                       Document(BSON("time" << Date_t::fromMillisSinceEpoch(0) << "myMeta"
+                                            << "s1"
+                                            << "lo" << BSONNULL)));
+
+    next = unpack->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.getDocument(),
+                       Document(BSON("time" << Date_t::fromMillisSinceEpoch(1) << "myMeta"
+                                            << "s1"
+                                            << "lo" << 4)));
+
+    next = unpack->getNext();
+    ASSERT_TRUE(next.isEOF());
+}
 }  // namespace
 }  // namespace mongo
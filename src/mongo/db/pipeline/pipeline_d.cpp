@@ -58,6 +58,8 @@
 #include "mongo/db/ops/write_ops_gen.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
+#include "mongo/db/pipeline/document_source_change_stream_oplog_match.h"
+#include "mongo/db/pipeline/document_source_change_stream_shared_oplog_scan.h"
 #include "mongo/db/pipeline/document_source_cursor.h"
 #include "mongo/db/pipeline/document_source_geo_near.h"
 #include "mongo/db/pipeline/document_source_geo_near_cursor.h"
@@ -120,6 +122,15 @@ namespace {
  *    - When the 'internalQuerySlotBasedExecutionDisableLookupPushdown' query knob is 'false'.
  *    - The $lookup uses only the 'localField'/'foreignField' syntax (no pipelines).
  *    - The foreign collection is neither sharded nor a view.
+ *
+ * An $_internalUnpackBucket stage is extracted from the pipeline when all of the following
+ * conditions are met:
+ *    - When the 'internalQuerySlotBasedExecutionEnableTimeseriesUnpackPushdown' query knob is
+ *      'true'.
+ *    - It is the first stage of the pipeline and the bucket collection is not sharded.
+ *    - It unpacks a fixed set of top-level fields (see 'sbeCompatible()').
+ *    - It is immediately followed by a $group which is itself eligible for pushdown and doesn't
+ *      need the whole measurement, and the pipeline has no $sort stage.
  */
 std::vector<std::unique_ptr<InnerPipelineStageInterface>> findSbeCompatibleStagesForPushdown(
     const intrusive_ptr<ExpressionContext>& expCtx,
@@ -161,6 +172,41 @@ std::vector<std::unique_ptr<InnerPipelineStageInterface>> findSbeCompatibleStage
     for (auto itr = sources.begin(); itr != sources.end(); ++itr) {
         const bool isLastSource = itr->get() == sources.back().get();
 
+        // $_internalUnpackBucket pushdown logic.
+        if (auto unpackStage = dynamic_cast<DocumentSourceInternalUnpackBucket*>(itr->get())) {
+            if (!internalQuerySlotBasedExecutionEnableTimeseriesUnpackPushdown.load() ||
+                itr != sources.begin() || isMainCollectionSharded ||
+                !unpackStage->sbeCompatible()) {
+                break;
+            }
+
+            // The time-series bounded sort rewrite inspects the unpacking stage after the executor
+            // has been created, so leave the unpacking to the pipeline if there is any $sort.
+            const bool hasSort = std::any_of(sources.begin(), sources.end(), [](const auto& src) {
+                return dynamic_cast<DocumentSourceSort*>(src.get()) != nullptr;
+            });
+
+            auto nextItr = std::next(itr);
+            auto groupStage = nextItr != sources.end()
+                ? dynamic_cast<DocumentSourceGroup*>(nextItr->get())
+                : nullptr;
+            if (hasSort || !groupStage ||
+                internalQuerySlotBasedExecutionDisableGroupPushdown.load() ||
+                !groupStage->sbeCompatible() || groupStage->doingMerge()) {
+                break;
+            }
+
+            DepsTracker groupDeps;
+            groupStage->getDependencies(&groupDeps);
+            if (groupDeps.needWholeDocument) {
+                break;
+            }
+
+            stagesForPushdown.push_back(
+                std::make_unique<InnerPipelineStageImpl>(unpackStage, isLastSource));
+            continue;
+        }
+
         // $group pushdown logic.
         if (auto groupStage = dynamic_cast<DocumentSourceGroup*>(itr->get())) {
             if (internalQuerySlotBasedExecutionDisableGroupPushdown.load()) {
@@ -1223,9 +1269,17 @@ PipelineD::buildInnerQueryExecutorGeneric(const MultipleCollectionAccessor& coll
     // Look for an initial match. This works whether we got an initial query or not. If not, it
     // results in a "{}" query, which will be what we want in that case.
     const BSONObj queryObj = pipeline->getInitialQuery();
+    boost::optional<BSONObj> sharedOplogScanFilter;
     if (!queryObj.isEmpty()) {
         auto matchStage = dynamic_cast<DocumentSourceMatch*>(sources.front().get());
         if (matchStage) {
+            // A change stream on the oplog can later hand its scan over to the shared oplog
+            // reader, which then applies the same filter as the $cursor stage.
+            if (dynamic_cast<DocumentSourceChangeStreamOplogMatch*>(matchStage) &&
+                DocumentSourceChangeStreamSharedOplogScan::canUseSharedOplogScan(expCtx, nss)) {
+                sharedOplogScanFilter = queryObj;
+            }
+
             // If a $match query is pulled into the cursor, the $match is redundant, and can be
             // removed from the pipeline.
             sources.pop_front();
@@ -1498,11 +1552,17 @@ PipelineD::buildInnerQueryExecutorGeneric(const MultipleCollectionAccessor& coll
         (aggRequest && aggRequest->getRequestReshardingResumeToken());
 
     auto attachExecutorCallback =
-        [cursorType, trackOplogTS](const MultipleCollectionAccessor& collections,
-                                   std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> exec,
-                                   Pipeline* pipeline) {
+        [cursorType, trackOplogTS, sharedOplogScanFilter](
+            const MultipleCollectionAccessor& collections,
+            std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> exec,
+            Pipeline* pipeline) {
             auto cursor = DocumentSourceCursor::create(
                 collections, std::move(exec), pipeline->getContext(), cursorType, trackOplogTS);
+            if (sharedOplogScanFilter) {
+                pipeline->addInitialSource(DocumentSourceChangeStreamSharedOplogScan::create(
+                    pipeline->getContext(), std::move(cursor), *sharedOplogScanFilter));
+                return;
+            }
             pipeline->addInitialSource(std::move(cursor));
         };
     return std::make_pair(std::move(attachExecutorCallback), std::move(exec));
@@ -1734,6 +1794,10 @@ Timestamp PipelineD::getLatestOplogTimestamp(const Pipeline* pipeline) {
             dynamic_cast<DocumentSourceCursor*>(pipeline->_sources.front().get())) {
         return docSourceCursor->getLatestOplogTimestamp();
     }
+    if (auto sharedOplogScan = dynamic_cast<DocumentSourceChangeStreamSharedOplogScan*>(
+            pipeline->_sources.front().get())) {
+        return sharedOplogScan->getLatestOplogTimestamp();
+    }
     return Timestamp();
 }
 
@@ -1742,6 +1806,10 @@ BSONObj PipelineD::getPostBatchResumeToken(const Pipeline* pipeline) {
             dynamic_cast<DocumentSourceCursor*>(pipeline->_sources.front().get())) {
         return docSourceCursor->getPostBatchResumeToken();
     }
+    if (auto sharedOplogScan = dynamic_cast<DocumentSourceChangeStreamSharedOplogScan*>(
+            pipeline->_sources.front().get())) {
+        return sharedOplogScan->getPostBatchResumeToken();
+    }
     return BSONObj{};
 }
 }  // namespace mongo
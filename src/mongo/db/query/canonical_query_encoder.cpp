@@ -41,6 +41,7 @@
 #include "mongo/db/matcher/expression_where.h"
 #include "mongo/db/matcher/expression_where_noop.h"
 #include "mongo/db/pipeline/document_source_group.h"
+#include "mongo/db/pipeline/document_source_internal_unpack_bucket.h"
 #include "mongo/db/pipeline/document_source_lookup.h"
 #include "mongo/db/query/analyze_regex.h"
 #include "mongo/db/query/projection.h"
@@ -451,6 +452,14 @@ void encodePipeline(const std::vector<std::unique_ptr<InnerPipelineStageInterfac
             auto serializedGroup = groupStage->serialize();
             const auto bson = serializedGroup.getDocument().toBson();
             bufBuilder->appendBuf(bson.objdata(), bson.objsize());
+        } else if (auto unpackStage = dynamic_cast<DocumentSourceInternalUnpackBucket*>(
+                       stage->documentSource())) {
+            unpackStage->serializeToArray(serializedArray, boost::none);
+            tassert(7095708,
+                    "$_internalUnpackBucket stage isn't serialized to a single bson object",
+                    serializedArray.size() == 1 && serializedArray[0].getType() == Object);
+            const auto bson = serializedArray[0].getDocument().toBson();
+            bufBuilder->appendBuf(bson.objdata(), bson.objsize());
         } else {
             tasserted(6443200,
                       str::stream() << "Pipeline stage cannot be encoded in plan cache key: "
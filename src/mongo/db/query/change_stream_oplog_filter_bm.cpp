@@ -0,0 +1,176 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include <array>
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/exec/sbe/stages/bson_scan.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/document_source_change_stream_oplog_match.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/query_test_service_context.h"
+#include "mongo/db/query/sbe_stage_builder.h"
+#include "mongo/db/query/sbe_stage_builder_filter.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kWatchedNss{"test.watched"};
+const NamespaceString kOtherNss{"test.other"};
+const int kNumOplogEntries = 10000;
+
+/**
+ * Builds a batch of CRUD oplog entries in which one entry out of every 'watchedEvery' targets the
+ * namespace being watched, and the rest target an unrelated collection in the same database.
+ */
+std::vector<BSONObj> makeOplogEntries(int watchedEvery) {
+    const auto watchedUuid = UUID::gen();
+    const auto otherUuid = UUID::gen();
+    const std::array<StringData, 3> ops{"i"_sd, "u"_sd, "d"_sd};
+
+    std::vector<BSONObj> entries;
+    entries.reserve(kNumOplogEntries);
+    for (int i = 0; i < kNumOplogEntries; ++i) {
+        const bool watched = i % watchedEvery == 0;
+        const auto op = ops[i % ops.size()];
+        BSONObjBuilder bob;
+        bob.append("op", op);
+        bob.append("ns", (watched ? kWatchedNss : kOtherNss).ns());
+        (watched ? watchedUuid : otherUuid).appendToBuilder(&bob, "ui");
+        if (op == "u"_sd) {
+            bob.append("o", BSON("$v" << 2 << "diff" << BSON("u" << BSON("x" << i))));
+            bob.append("o2", BSON("_id" << i));
+        } else {
+            bob.append("o", BSON("_id" << i << "x" << i));
+        }
+        bob.append("ts", Timestamp(100, i + 1));
+        bob.append("t", 1LL);
+        bob.append("v", 2LL);
+        bob.appendDate("wall", Date_t::fromMillisSinceEpoch(i));
+        entries.push_back(bob.obj());
+    }
+    return entries;
+}
+
+/**
+ * Returns the oplog filter that a collection change stream on 'kWatchedNss' pushes down to its
+ * oplog scan, i.e. the filter held by its '$_internalChangeStreamOplogMatch' stage.
+ */
+BSONObj makeChangeStreamOplogFilter(OperationContext* opCtx) {
+    auto expCtx = make_intrusive<ExpressionContextForTest>(opCtx, kWatchedNss);
+    expCtx->changeStreamSpec = DocumentSourceChangeStreamSpec();
+    auto oplogMatch = make_intrusive<DocumentSourceChangeStreamOplogMatch>(Timestamp(1, 0), expCtx);
+    return oplogMatch->getQuery().getOwned();
+}
+
+/**
+ * Reports the number of oplog entries filtered per second of CPU time. The benchmarks are single
+ * threaded, so this is the throughput a change stream gets out of one core.
+ */
+void reportEventsPerSecondPerCore(benchmark::State& state) {
+    state.counters["eventsPerSecondPerCore"] =
+        benchmark::Counter(kNumOplogEntries, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+void BM_ChangeStreamOplogFilterClassic(benchmark::State& state) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    auto expCtx = make_intrusive<ExpressionContextForTest>(opCtx.get(),
+                                                           NamespaceString::kRsOplogNamespace);
+    auto filterObj = makeChangeStreamOplogFilter(opCtx.get());
+    auto filter = uassertStatusOK(MatchExpressionParser::parse(filterObj, expCtx));
+    const auto entries = makeOplogEntries(state.range(0));
+
+    for (auto keepRunning : state) {
+        for (auto&& entry : entries) {
+            benchmark::DoNotOptimize(filter->matchesBSON(entry));
+        }
+        benchmark::ClobberMemory();
+    }
+    reportEventsPerSecondPerCore(state);
+}
+
+void BM_ChangeStreamOplogFilterSbe(benchmark::State& state) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    auto expCtx = make_intrusive<ExpressionContextForTest>(opCtx.get(),
+                                                           NamespaceString::kRsOplogNamespace);
+    auto filterObj = makeChangeStreamOplogFilter(opCtx.get());
+    auto filter = uassertStatusOK(MatchExpressionParser::parse(filterObj, expCtx));
+    if (!expCtx->sbeCompatible) {
+        state.SkipWithError("change stream oplog filter is not supported by SBE");
+        return;
+    }
+
+    stage_builder::PlanStageData planStageData(std::make_unique<sbe::RuntimeEnvironment>());
+    Variables variables;
+    sbe::value::SlotIdGenerator slotIdGenerator;
+    sbe::value::FrameIdGenerator frameIdGenerator;
+    sbe::value::SpoolIdGenerator spoolIdGenerator;
+    stage_builder::StageBuilderState builderState{opCtx.get(),
+                                                  &planStageData,
+                                                  variables,
+                                                  &slotIdGenerator,
+                                                  &frameIdGenerator,
+                                                  &spoolIdGenerator,
+                                                  false /* needsMerge */,
+                                                  false /* allowDiskUse */};
+
+    // Scan the entries from memory, as the collection scan would, and compile the filter on top.
+    auto inputSlot = slotIdGenerator.generate();
+    stage_builder::EvalStage scanStage(
+        std::make_unique<sbe::BSONScanStage>(makeOplogEntries(state.range(0)),
+                                             boost::make_optional(inputSlot),
+                                             kEmptyPlanNodeId),
+        {inputSlot});
+    auto filterStage = stage_builder::generateFilter(builderState,
+                                                     filter.get(),
+                                                     std::move(scanStage),
+                                                     inputSlot,
+                                                     kEmptyPlanNodeId)
+                           .second.extractStage(kEmptyPlanNodeId);
+
+    filterStage->attachToOperationContext(opCtx.get());
+    filterStage->prepare(planStageData.ctx);
+    filterStage->open(false /* reopen */);
+    for (auto keepRunning : state) {
+        while (filterStage->getNext() == sbe::PlanState::ADVANCED) {
+        }
+        benchmark::ClobberMemory();
+        filterStage->open(true /* reopen */);
+    }
+    reportEventsPerSecondPerCore(state);
+}
+
+// The argument is the ratio of oplog entries to entries on the watched collection.
+BENCHMARK(BM_ChangeStreamOplogFilterClassic)->Arg(1)->Arg(10)->Arg(100);
+BENCHMARK(BM_ChangeStreamOplogFilterSbe)->Arg(1)->Arg(10)->Arg(100);
+
+}  // namespace
+}  // namespace mongo
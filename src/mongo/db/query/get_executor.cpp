@@ -1420,9 +1420,11 @@ attemptToGetSlotBasedExecutor(
         extractAndAttachPipelineStages(canonicalQuery.get(), true /* attachOnly */);
     }
 
-    // Use SBE if we find any $group/$lookup stages eligible for execution in SBE or if SBE
-    // is fully enabled. Otherwise, fallback to the classic engine.
+    // Use SBE if we find any $group/$lookup stages eligible for execution in SBE, if the query is
+    // the oplog scan of a change stream which has opted into SBE, or if SBE is fully enabled.
+    // Otherwise, fallback to the classic engine.
     if (canonicalQuery->pipeline().empty() &&
+        !isChangeStreamOplogScanSbeEligible(*canonicalQuery, plannerParams.options) &&
         !feature_flags::gFeatureFlagSbeFull.isEnabledAndIgnoreFCV()) {
         canonicalQuery->setSbeCompatible(false);
     } else {
@@ -401,7 +401,8 @@ std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> InternalPlanner::deleteWith
     const BSONObj& endKey,
     BoundInclusion boundInclusion,
     PlanYieldPolicy::YieldPolicy yieldPolicy,
-    Direction direction) {
+    Direction direction,
+    std::unique_ptr<BatchedDeleteStageParams> batchedDeleteParams) {
     if (shardKeyIdx.descriptor()) {
         return deleteWithIndexScan(opCtx,
                                    coll,
@@ -411,7 +412,8 @@ std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> InternalPlanner::deleteWith
                                    endKey,
                                    boundInclusion,
                                    yieldPolicy,
-                                   direction);
+                                   direction,
+                                   std::move(batchedDeleteParams));
     }
     auto collectionScanParams = convertIndexScanParamsToCollScanParams(
         opCtx, coll, shardKeyIdx.keyPattern(), startKey, endKey, boundInclusion, direction);
@@ -425,8 +427,17 @@ std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> InternalPlanner::deleteWith
         opCtx, std::unique_ptr<CollatorInterface>(nullptr), collection->ns());
 
     auto root = _collectionScan(expCtx, ws.get(), &collection, collectionScanParams);
-    root = std::make_unique<DeleteStage>(
-        expCtx.get(), std::move(params), ws.get(), collection, root.release());
+    if (batchedDeleteParams) {
+        root = std::make_unique<BatchedDeleteStage>(expCtx.get(),
+                                                    std::move(params),
+                                                    std::move(batchedDeleteParams),
+                                                    ws.get(),
+                                                    collection,
+                                                    root.release());
+    } else {
+        root = std::make_unique<DeleteStage>(
+            expCtx.get(), std::move(params), ws.get(), collection, root.release());
+    }
 
     auto executor = plan_executor_factory::make(expCtx,
                                                 std::move(ws),
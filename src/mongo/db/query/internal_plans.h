@@ -160,7 +160,7 @@ public:
     /**
      * Returns an IXSCAN => FETCH => DELETE plan when 'shardKeyIdx' indicates the index is a
      * standard index or a COLLSCAN => DELETE when 'shardKeyIdx' indicates the index is a clustered
-     * index.
+     * index. The DELETE stage is a BATCHED_DELETE if 'batchedDeleteParams' is set.
      */
     static std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> deleteWithShardKeyIndexScan(
         OperationContext* opCtx,
@@ -171,7 +171,8 @@ public:
         const BSONObj& endKey,
         BoundInclusion boundInclusion,
         PlanYieldPolicy::YieldPolicy yieldPolicy,
-        Direction direction = FORWARD);
+        Direction direction = FORWARD,
+        std::unique_ptr<BatchedDeleteStageParams> batchedDeleteParams = nullptr);
 
     /**
      * Returns an IDHACK => UPDATE plan.
@@ -183,6 +183,19 @@ void statsToBSON(const QuerySolutionNode* node,
             }
             break;
         }
+        case STAGE_UNPACK_TIMESERIES_BUCKET: {
+            auto utbn = static_cast<const UnpackTsBucketNode*>(node);
+
+            bob->append("timeField", utbn->timeField);
+            if (utbn->metaField && utbn->includeMetaField) {
+                bob->append("metaField", *utbn->metaField);
+            }
+            bob->append("fields", utbn->fields);
+            if (utbn->eventFilter) {
+                bob->append("eventFilter", utbn->eventFilter->serialize());
+            }
+            break;
+        }
         case STAGE_COLUMN_SCAN: {
             auto cisn = static_cast<const ColumnIndexScanNode*>(node);
 
@@ -49,6 +49,7 @@
 #include "mongo/db/matcher/match_expression_dependencies.h"
 #include "mongo/db/pipeline/dependencies.h"
 #include "mongo/db/pipeline/document_source_group.h"
+#include "mongo/db/pipeline/document_source_internal_unpack_bucket.h"
 #include "mongo/db/pipeline/document_source_lookup.h"
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/classic_plan_cache.h"
@@ -1617,8 +1618,38 @@ std::unique_ptr<QuerySolution> QueryPlanner::extendWithAggPipeline(
             continue;
         }
 
+        auto unpackStage =
+            dynamic_cast<DocumentSourceInternalUnpackBucket*>(innerStage->documentSource());
+        if (unpackStage) {
+            tassert(7095707,
+                    "This $_internalUnpackBucket stage should be compatible with SBE",
+                    unpackStage->sbeCompatible());
+            auto unpacker = unpackStage->bucketUnpacker();
+            const auto& spec = unpacker.bucketSpec();
+
+            // The meta field is unpacked from the bucket's 'meta' field rather than from its data
+            // region.
+            std::vector<std::string> fields;
+            for (auto&& field : spec.fieldSet()) {
+                if (!spec.metaField() || field != *spec.metaField()) {
+                    fields.push_back(field);
+                }
+            }
+
+            auto eventFilter = unpackStage->eventFilter();
+            solnForAgg = std::make_unique<UnpackTsBucketNode>(
+                std::move(solnForAgg),
+                spec.timeField(),
+                spec.metaField(),
+                std::move(fields),
+                unpackStage->includeMetaField(),
+                eventFilter ? eventFilter->clone() : nullptr);
+            continue;
+        }
+
         tasserted(5842400,
-                  "Cannot support pushdown of a stage other than $group or $lookup at the moment");
+                  "Cannot support pushdown of a stage other than $group, $lookup or "
+                  "$_internalUnpackBucket at the moment");
     }
 
     solution->extendWith(std::move(solnForAgg));
@@ -1638,6 +1638,47 @@ std::unique_ptr<QuerySolutionNode> EqLookupNode::clone() const {
                                                shouldProduceBson);
     return copy;
 }
+
+/**
+ * UnpackTsBucketNode.
+ */
+void UnpackTsBucketNode::appendToString(str::stream* ss, int indent) const {
+    addIndent(ss, indent);
+    *ss << "UNPACK_TS_BUCKET\n";
+    addIndent(ss, indent + 1);
+    *ss << "timeField = " << timeField << '\n';
+    if (metaField) {
+        addIndent(ss, indent + 1);
+        *ss << "metaField = " << *metaField << (includeMetaField ? "" : " (excluded)") << '\n';
+    }
+    addIndent(ss, indent + 1);
+    *ss << "fields = [";
+    for (size_t idx = 0; idx < fields.size(); ++idx) {
+        if (idx > 0) {
+            *ss << ", ";
+        }
+        *ss << fields[idx];
+    }
+    *ss << "]" << '\n';
+    if (eventFilter) {
+        addIndent(ss, indent + 1);
+        *ss << "eventFilter = " << eventFilter->debugString();
+    }
+    addCommon(ss, indent);
+    addIndent(ss, indent + 1);
+    *ss << "Child:" << '\n';
+    children[0]->appendToString(ss, indent + 2);
+}
+
+std::unique_ptr<QuerySolutionNode> UnpackTsBucketNode::clone() const {
+    return std::make_unique<UnpackTsBucketNode>(children[0]->clone(),
+                                                timeField,
+                                                metaField,
+                                                fields,
+                                                includeMetaField,
+                                                eventFilter ? eventFilter->clone() : nullptr);
+}
+
 /**
  * SentinelNode.
  */
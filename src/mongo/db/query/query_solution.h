@@ -1578,6 +1578,63 @@ struct EqLookupNode : public QuerySolutionNode {
     bool shouldProduceBson;
 };
 
+/**
+ * Represents a pushed down $_internalUnpackBucket stage which unpacks the time-series buckets
+ * produced by its child into individual measurements. Only the top-level measurement fields in
+ * 'fields' (and the meta field, if 'includeMetaField' is true) are produced. Measurements which
+ * do not match the optional 'eventFilter' are discarded.
+ */
+struct UnpackTsBucketNode : public QuerySolutionNode {
+    UnpackTsBucketNode(std::unique_ptr<QuerySolutionNode> child,
+                       std::string timeField,
+                       boost::optional<std::string> metaField,
+                       std::vector<std::string> fields,
+                       bool includeMetaField,
+                       std::unique_ptr<MatchExpression> eventFilter)
+        : QuerySolutionNode(std::move(child)),
+          timeField(std::move(timeField)),
+          metaField(std::move(metaField)),
+          fields(std::move(fields)),
+          includeMetaField(includeMetaField),
+          eventFilter(std::move(eventFilter)) {}
+
+    StageType getType() const override {
+        return STAGE_UNPACK_TIMESERIES_BUCKET;
+    }
+
+    void appendToString(str::stream* ss, int indent) const override;
+
+    bool fetched() const {
+        return true;
+    }
+
+    FieldAvailability getFieldAvailability(const std::string& field) const {
+        // The measurements are constructed by this node and don't map to the bucket documents.
+        return FieldAvailability::kNotProvided;
+    }
+
+    bool sortedByDiskLoc() const override {
+        return false;
+    }
+
+    const ProvidedSortSet& providedSorts() const final {
+        return kEmptySet;
+    }
+
+    std::unique_ptr<QuerySolutionNode> clone() const final;
+
+    std::string timeField;
+    boost::optional<std::string> metaField;
+
+    // The top-level measurement fields to unpack from the bucket's data region, not including the
+    // meta field.
+    std::vector<std::string> fields;
+    bool includeMetaField;
+
+    // The measurement-level predicate pushed into the unpacking stage, if any.
+    std::unique_ptr<MatchExpression> eventFilter;
+};
+
 struct SentinelNode : public QuerySolutionNode {
 
     SentinelNode() {}
@@ -31,6 +31,7 @@
 #include "mongo/db/query/query_utils.h"
 
 #include "mongo/db/exec/sbe/match_path.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner_params.h"
 
 namespace mongo {
@@ -44,6 +45,19 @@ bool isIdHackEligibleQuery(const CollectionPtr& collection, const CanonicalQuery
         CollatorInterface::collatorsMatch(query.getCollator(), collection->getDefaultCollator());
 }
 
+bool isChangeStreamOplogScanSbeEligible(const CanonicalQuery& query, size_t plannerOptions) {
+    // A change stream scans the oplog with a tailable, awaitData cursor and asks the planner to
+    // track the latest oplog timestamp and to assert that its start point has not fallen off the
+    // oplog. The SBE collection scan supports all of these, so only the generic oplog exclusion
+    // needs to be lifted. Other oplog readers, such as resharding, stay on the classic engine.
+    const auto kChangeStreamOptions = QueryPlannerParams::TRACK_LATEST_OPLOG_TS |
+        QueryPlannerParams::ASSERT_MIN_TS_HAS_NOT_FALLEN_OFF_OPLOG;
+    const auto& findCommand = query.getFindCommandRequest();
+    return internalChangeStreamUseSbeForOplogScan.load() && query.nss().isOplog() &&
+        findCommand.getTailable() && findCommand.getAwaitData() &&
+        (plannerOptions & kChangeStreamOptions) == kChangeStreamOptions;
+}
+
 bool isQuerySbeCompatible(const CollectionPtr* collection,
                           const CanonicalQuery* cq,
                           size_t plannerOptions) {
@@ -53,7 +67,8 @@ bool isQuerySbeCompatible(const CollectionPtr* collection,
     const auto& sortPattern = cq->getSortPattern();
     const bool allExpressionsSupported = expCtx && expCtx->sbeCompatible;
     const bool isNotCount = !(plannerOptions & QueryPlannerParams::IS_COUNT);
-    const bool isNotOplog = !cq->nss().isOplog();
+    const bool isNotOplog =
+        !cq->nss().isOplog() || isChangeStreamOplogScanSbeEligible(*cq, plannerOptions);
     const bool isNotChangeCollection = !cq->nss().isChangeCollection();
     const bool doesNotContainMetadataRequirements = cq->metadataDeps().none();
     const bool doesNotSortOnMetaOrPathWithNumericComponents =
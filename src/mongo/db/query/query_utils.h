@@ -38,6 +38,13 @@ namespace mongo {
  */
 bool isIdHackEligibleQuery(const CollectionPtr& collection, const CanonicalQuery& query);
 
+/**
+ * Returns 'true' if 'query' is the tailable oplog scan of a change stream and the
+ * 'internalChangeStreamUseSbeForOplogScan' knob allows it to run in SBE despite targeting the
+ * oplog.
+ */
+bool isChangeStreamOplogScanSbeEligible(const CanonicalQuery& query, size_t plannerOptions);
+
 /**
  * Checks if the given query can be executed with the SBE engine.
  */
@@ -51,6 +51,7 @@
 #include "mongo/db/exec/sbe/stages/sort.h"
 #include "mongo/db/exec/sbe/stages/sorted_merge.h"
 #include "mongo/db/exec/sbe/stages/traverse.h"
+#include "mongo/db/exec/sbe/stages/ts_bucket_unpack.h"
 #include "mongo/db/exec/sbe/stages/union.h"
 #include "mongo/db/exec/sbe/stages/unique.h"
 #include "mongo/db/exec/sbe/values/sort_spec.h"
@@ -60,6 +61,7 @@
 #include "mongo/db/fts/fts_spec.h"
 #include "mongo/db/index/fts_access_method.h"
 #include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/expression_tree.h"
 #include "mongo/db/matcher/match_expression_dependencies.h"
 #include "mongo/db/pipeline/abt/field_map_builder.h"
 #include "mongo/db/pipeline/expression.h"
@@ -2465,10 +2467,11 @@ std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> SlotBasedStageBuilder
 
     auto childReqs = reqs.copy().set(kResult).clearAllFields();
 
-    // Don't ask the GROUP child for the result slot to avoid unnecessary materialization if it's
-    // possible to get everything we need from top-level field slots.
-    if (childNode->getType() == StageType::STAGE_GROUP && !groupNode->needWholeDocument &&
-        !groupNode->needsAnyMetadata) {
+    // Don't ask a GROUP or UNPACK_TIMESERIES_BUCKET child for the result slot to avoid unnecessary
+    // materialization if it's possible to get everything we need from top-level field slots.
+    if ((childNode->getType() == StageType::STAGE_GROUP ||
+         childNode->getType() == StageType::STAGE_UNPACK_TIMESERIES_BUCKET) &&
+        !groupNode->needWholeDocument && !groupNode->needsAnyMetadata) {
         childReqs.clear(kResult);
 
         for (auto&& pathStr : groupNode->requiredFields) {
@@ -2608,6 +2611,207 @@ std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> SlotBasedStageBuilder
     return {std::move(outStage), std::move(outputs)};
 }
 
+namespace {
+/**
+ * Translates a single comparison of the time field against a date constant into an SBE predicate
+ * on 'timeSlot'. Returns nullptr if 'me' is not such a comparison.
+ *
+ * Every measurement of a time-series collection holds a scalar date in its time field, so these
+ * comparisons don't need any of the array traversal logic that a general MQL predicate requires.
+ */
+std::unique_ptr<sbe::EExpression> generateTimeFieldRowFilter(const MatchExpression* me,
+                                                             StringData timeField,
+                                                             sbe::value::SlotId timeSlot) {
+    sbe::EPrimBinary::Op op;
+    switch (me->matchType()) {
+        case MatchExpression::EQ:
+            op = sbe::EPrimBinary::eq;
+            break;
+        case MatchExpression::LT:
+            op = sbe::EPrimBinary::less;
+            break;
+        case MatchExpression::LTE:
+            op = sbe::EPrimBinary::lessEq;
+            break;
+        case MatchExpression::GT:
+            op = sbe::EPrimBinary::greater;
+            break;
+        case MatchExpression::GTE:
+            op = sbe::EPrimBinary::greaterEq;
+            break;
+        default:
+            return nullptr;
+    }
+
+    auto cmp = static_cast<const ComparisonMatchExpression*>(me);
+    if (cmp->path() != timeField || cmp->getData().type() != BSONType::Date) {
+        return nullptr;
+    }
+
+    return makeFillEmptyFalse(
+        makeBinaryOp(op,
+                     makeVariable(timeSlot),
+                     makeConstant(sbe::value::TypeTags::Date,
+                                  cmp->getData().date().toMillisSinceEpoch())));
+}
+
+/**
+ * Splits the event filter of an UNPACK_TS_BUCKET node into a predicate which the unpacking stage
+ * can evaluate directly against the decoded time column, and a residual MatchExpression (possibly
+ * null) which must be evaluated against the materialized measurements.
+ */
+std::pair<std::unique_ptr<sbe::EExpression>, std::unique_ptr<MatchExpression>> splitTsEventFilter(
+    const MatchExpression* eventFilter,
+    StringData timeField,
+    boost::optional<sbe::value::SlotId> timeSlot) {
+    if (!timeSlot) {
+        return {nullptr, eventFilter->clone()};
+    }
+
+    if (eventFilter->matchType() != MatchExpression::AND) {
+        if (auto rowFilter = generateTimeFieldRowFilter(eventFilter, timeField, *timeSlot)) {
+            return {std::move(rowFilter), nullptr};
+        }
+        return {nullptr, eventFilter->clone()};
+    }
+
+    std::unique_ptr<sbe::EExpression> rowFilter;
+    std::vector<std::unique_ptr<MatchExpression>> residual;
+    for (size_t i = 0; i < eventFilter->numChildren(); ++i) {
+        auto child = eventFilter->getChild(i);
+        if (auto childFilter = generateTimeFieldRowFilter(child, timeField, *timeSlot)) {
+            rowFilter = rowFilter ? makeBinaryOp(sbe::EPrimBinary::logicAnd,
+                                                 std::move(rowFilter),
+                                                 std::move(childFilter))
+                                  : std::move(childFilter);
+        } else {
+            residual.push_back(child->clone());
+        }
+    }
+
+    if (residual.empty()) {
+        return {std::move(rowFilter), nullptr};
+    }
+    if (residual.size() == 1) {
+        return {std::move(rowFilter), std::move(residual[0])};
+    }
+    auto residualAnd = std::make_unique<AndMatchExpression>();
+    for (auto&& child : residual) {
+        residualAnd->add(std::move(child));
+    }
+    return {std::move(rowFilter), std::move(residualAnd)};
+}
+}  // namespace
+
+/**
+ * Builds a 'ts_bucket_unpack' stage on top of the stage producing the buckets. Comparisons of the
+ * time field against dates are evaluated by the unpacking stage itself on the decoded columns. Any
+ * other part of the event filter is evaluated against the materialized measurement, exactly as the
+ * classic $_internalUnpackBucket stage does.
+ */
+std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots>
+SlotBasedStageBuilder::buildUnpackTsBucket(const QuerySolutionNode* root,
+                                           const PlanStageReqs& reqs) {
+    tassert(7095705, "buildUnpackTsBucket() does not support kKey", !reqs.hasKeys());
+    tassert(7095706,
+            "UNPACK_TS_BUCKET cannot propagate a record id slot, but the record id was requested "
+            "by the parent",
+            !reqs.has(kRecordId));
+
+    auto unpackNode = static_cast<const UnpackTsBucketNode*>(root);
+    auto nodeId = unpackNode->nodeId();
+
+    auto childReqs = reqs.copy().set(kResult).clearAllFields();
+    auto [stage, childOutputs] = build(unpackNode->children[0].get(), childReqs);
+    auto bucketSlot = childOutputs.get(kResult);
+
+    const auto& fields = unpackNode->fields;
+    auto fieldSlots = _slotIdGenerator.generateMultiple(fields.size());
+    boost::optional<sbe::value::SlotId> metaSlot;
+    if (unpackNode->includeMetaField && unpackNode->metaField) {
+        metaSlot = _slotIdGenerator.generate();
+    }
+
+    std::unique_ptr<sbe::EExpression> rowFilter;
+    std::unique_ptr<MatchExpression> residualFilter;
+    if (unpackNode->eventFilter) {
+        boost::optional<sbe::value::SlotId> timeSlot;
+        auto timeIt = std::find(fields.begin(), fields.end(), unpackNode->timeField);
+        if (timeIt != fields.end()) {
+            timeSlot = fieldSlots[std::distance(fields.begin(), timeIt)];
+        }
+        std::tie(rowFilter, residualFilter) = splitTsEventFilter(
+            unpackNode->eventFilter.get(), unpackNode->timeField, timeSlot);
+    }
+
+    stage = sbe::makeS<sbe::TsBucketUnpackStage>(std::move(stage),
+                                                 bucketSlot,
+                                                 unpackNode->timeField,
+                                                 fields,
+                                                 fieldSlots,
+                                                 metaSlot,
+                                                 std::move(rowFilter),
+                                                 nodeId);
+
+    PlanStageSlots outputs;
+    std::vector<std::string> projectFields = fields;
+    auto projectSlots = fieldSlots;
+    for (size_t i = 0; i < fields.size(); ++i) {
+        outputs.set(std::make_pair(PlanStageSlots::kField, fields[i]), fieldSlots[i]);
+    }
+    if (metaSlot) {
+        outputs.set(std::make_pair(PlanStageSlots::kField, *unpackNode->metaField), *metaSlot);
+        projectFields.push_back(*unpackNode->metaField);
+        projectSlots.push_back(*metaSlot);
+    }
+
+    // Any other top-level field requested by the parent is never present in the unpacked
+    // measurements.
+    auto additionalFields = filterVector(reqs.getFields(), [&](const std::string& s) {
+        return !outputs.has(std::make_pair(PlanStageSlots::kField, StringData(s)));
+    });
+    if (!additionalFields.empty()) {
+        auto [outStage, nothingSlots] = projectNothingToSlots(
+            std::move(stage), additionalFields.size(), nodeId, &_slotIdGenerator);
+        stage = std::move(outStage);
+        for (size_t i = 0; i < additionalFields.size(); ++i) {
+            outputs.set(std::make_pair(PlanStageSlots::kField, std::move(additionalFields[i])),
+                        nothingSlots[i]);
+        }
+    }
+
+    // Materialize the measurement only if the parent needs it or the residual filter has to be
+    // evaluated against it.
+    if (reqs.has(kResult) || residualFilter) {
+        auto resultSlot = _slotIdGenerator.generate();
+        stage = sbe::makeS<sbe::MakeBsonObjStage>(std::move(stage),
+                                                  resultSlot,                  // objSlot
+                                                  boost::none,                 // rootSlot
+                                                  boost::none,                 // fieldBehavior
+                                                  std::vector<std::string>{},  // fields
+                                                  std::move(projectFields),    // projectFields
+                                                  std::move(projectSlots),     // projectVars
+                                                  true,                        // forceNewObject
+                                                  false,                       // returnOldObject
+                                                  nodeId);
+        outputs.set(kResult, resultSlot);
+    }
+
+    if (residualFilter) {
+        auto relevantSlots = getSlotsToForward(reqs.copy().set(kResult), outputs);
+        auto [_, outputStage] = generateFilter(_state,
+                                               residualFilter.get(),
+                                               {std::move(stage), std::move(relevantSlots)},
+                                               outputs.get(kResult),
+                                               nodeId);
+        stage = outputStage.extractStage(nodeId);
+    }
+
+    outputs.clearNonRequiredSlots(reqs);
+
+    return {std::move(stage), std::move(outputs)};
+}
+
 std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots>
 SlotBasedStageBuilder::makeUnionForTailableCollScan(const QuerySolutionNode* root,
                                                     const PlanStageReqs& reqs) {
@@ -2941,6 +3145,7 @@ std::pair<std::unique_ptr<sbe::PlanStage>, PlanStageSlots> SlotBasedStageBuilder
             {STAGE_SORT_MERGE, &SlotBasedStageBuilder::buildSortMerge},
             {STAGE_GROUP, &SlotBasedStageBuilder::buildGroup},
             {STAGE_EQ_LOOKUP, &SlotBasedStageBuilder::buildLookup},
+            {STAGE_UNPACK_TIMESERIES_BUCKET, &SlotBasedStageBuilder::buildUnpackTsBucket},
             {STAGE_SHARDING_FILTER, &SlotBasedStageBuilder::buildShardFilter}};
 
     tassert(4822884,
@@ -30,6 +30,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
+
 #include "mongo/base/string_data.h"
 #include "mongo/db/catalog/clustered_collection_options_gen.h"
 #include "mongo/db/catalog/clustered_collection_util.h"
@@ -40,11 +42,15 @@
 #include "mongo/db/repl/collection_cloner.h"
 #include "mongo/db/repl/database_cloner_gen.h"
 #include "mongo/db/repl/repl_server_parameters_gen.h"
+#include "mongo/db/repl/replication_auth.h"
 #include "mongo/db/wire_version.h"
 #include "mongo/logv2/log.h"
 #include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/stdx/thread.h"
 
 #include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/scopeguard.h"
 
 #define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kReplicationInitialSync
 
@@ -60,6 +66,16 @@ MONGO_FAIL_POINT_DEFINE(initialSyncHangDuringCollectionClone);
 // DBClientConnection, optionally limited to a specific collection.
 MONGO_FAIL_POINT_DEFINE(initialSyncHangCollectionClonerAfterHandlingBatchResponse);
 
+namespace {
+
+// The number of _id values sampled from the source for each range of a partitioned clone.
+constexpr int kSamplesPerRange = 10;
+
+// How often the range queries of a partitioned clone are checked for having to stop.
+const Milliseconds kRangeQueriesInterruptCheckInterval{100};
+
+}  // namespace
+
 CollectionCloner::CollectionCloner(const NamespaceString& sourceNss,
                                    const CollectionOptions& collectionOptions,
                                    InitialSyncSharedData* sharedData,
@@ -76,6 +92,7 @@ CollectionCloner::CollectionCloner(const NamespaceString& sourceNss,
       _countStage("count", this, &CollectionCloner::countStage),
       _listIndexesStage("listIndexes", this, &CollectionCloner::listIndexesStage),
       _createCollectionStage("createCollection", this, &CollectionCloner::createCollectionStage),
+      _splitStage("split", this, &CollectionCloner::splitStage),
       _queryStage("query", this, &CollectionCloner::queryStage),
       _setupIndexBuildersForUnfinishedIndexesStage(
           "setupIndexBuildersForUnfinishedIndexes",
@@ -100,6 +117,8 @@ CollectionCloner::CollectionCloner(const NamespaceString& sourceNss,
           _dbWorkTaskRunner.schedule(std::move(task));
           return executor::TaskExecutor::CallbackHandle();
       }),
+      _createClientFn(
+          [] { return std::make_unique<DBClientConnection>(true /* autoReconnect */); }),
       _dbWorkTaskRunner(dbPool) {
     invariant(sourceNss.isValid());
     invariant(collectionOptions.uuid);
@@ -118,6 +137,7 @@ BaseCloner::ClonerStages CollectionCloner::getStages() {
     return {&_countStage,
             &_listIndexesStage,
             &_createCollectionStage,
+            &_splitStage,
             &_queryStage,
             &_setupIndexBuildersForUnfinishedIndexesStage};
 }
@@ -250,8 +270,101 @@ BaseCloner::AfterStageBehavior CollectionCloner::createCollectionStage() {
     return kContinueNormally;
 }
 
+BaseCloner::AfterStageBehavior CollectionCloner::splitStage() {
+    // The ranges survive retries of the following stages, which resume each of them.
+    if (collectionClonerPartitionCount <= 1 || !_ranges.empty()) {
+        return kContinueNormally;
+    }
+
+    // Capped collections must be cloned in their natural order. The ranges are bounds of the _id
+    // index, and are compared here with the simple collation.
+    if (_collectionOptions.capped || _idIndexSpec.isEmpty() ||
+        !_collectionOptions.collation.isEmpty()) {
+        return kContinueNormally;
+    }
+
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (_stats.bytesToCopy < collectionClonerMinBytesToPartition) {
+            return kContinueNormally;
+        }
+    }
+
+    // Split points are sampled rather than computed with splitVector, which cannot run on a
+    // secondary sync source.
+    const int sampleSize = collectionClonerPartitionCount * kSamplesPerRange;
+    BSONObj res;
+    getClient()->runCommand(
+        _sourceNss.db().toString(),
+        BSON("aggregate" << _sourceNss.coll() << "pipeline"
+                         << BSON_ARRAY(BSON("$sample" << BSON("size" << sampleSize))
+                                       << BSON("$project" << BSON("_id" << 1)))
+                         << "cursor" << BSON("batchSize" << sampleSize) << "readConcern"
+                         << ReadConcernArgs::kLocal),
+        res,
+        QueryOption_SecondaryOk);
+    if (auto status = getStatusFromCommandResult(res); !status.isOK()) {
+        LOGV2(7095721,
+              "Cloning collection with a single query because its _id values could not be "
+              "sampled",
+              logAttrs(_sourceNss),
+              "error"_attr = status);
+        return kContinueNormally;
+    }
+
+    const auto cursor = res["cursor"].Obj();
+    if (auto cursorId = cursor["id"].safeNumberLong(); cursorId != 0) {
+        getClient()->killCursor(_sourceNss, cursorId);
+    }
+
+    std::vector<BSONObj> splitKeys;
+    for (auto&& doc : cursor["firstBatch"].Array()) {
+        splitKeys.push_back(doc.Obj().getOwned());
+    }
+    auto lessThan = [](const BSONObj& lhs, const BSONObj& rhs) {
+        return lhs.firstElement().woCompare(rhs.firstElement(), false) < 0;
+    };
+    auto equal = [](const BSONObj& lhs, const BSONObj& rhs) {
+        return lhs.firstElement().woCompare(rhs.firstElement(), false) == 0;
+    };
+    std::sort(splitKeys.begin(), splitKeys.end(), lessThan);
+    splitKeys.erase(std::unique(splitKeys.begin(), splitKeys.end(), equal), splitKeys.end());
+
+    _ranges = makeRanges(splitKeys, collectionClonerPartitionCount);
+    if (!_ranges.empty()) {
+        LOGV2(7095722,
+              "Cloning collection in parallel ranges",
+              logAttrs(_sourceNss),
+              "numRanges"_attr = _ranges.size());
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    _stats.ranges = _ranges.size();
+    return kContinueNormally;
+}
+
+std::vector<CollectionCloner::Range> CollectionCloner::makeRanges(
+    const std::vector<BSONObj>& splitKeys, int numRanges) {
+    const size_t numBoundaries = std::min(splitKeys.size(), static_cast<size_t>(numRanges - 1));
+    if (numRanges <= 1 || numBoundaries == 0) {
+        return {};
+    }
+
+    std::vector<Range> ranges(numBoundaries + 1);
+    for (size_t i = 0; i < numBoundaries; ++i) {
+        const auto& boundary = splitKeys[(i + 1) * splitKeys.size() / (numBoundaries + 1)];
+        ranges[i].max = boundary;
+        ranges[i + 1].min = boundary;
+    }
+    return ranges;
+}
+
 BaseCloner::AfterStageBehavior CollectionCloner::queryStage() {
-    runQuery();
+    if (_ranges.empty()) {
+        runQuery();
+    } else {
+        runRangeQueries();
+    }
     waitForDatabaseWorkToComplete();
     // We want to free the _collLoader regardless of whether the commit succeeds.
     std::unique_ptr<CollectionBulkLoader> loader = std::move(_collLoader);
@@ -353,6 +466,211 @@ void CollectionCloner::runQuery() {
     }
 }
 
+void CollectionCloner::runRangeQueries() {
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _rangeQueriesInterrupted = false;
+    }
+
+    std::vector<Status> statuses(_ranges.size(), Status::OK());
+    std::vector<stdx::thread> threads;
+    for (size_t i = 0; i < _ranges.size(); ++i) {
+        if (_ranges[i].done) {
+            continue;
+        }
+
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            ++_numRangeQueriesRunning;
+        }
+        threads.emplace_back([this, i, &statuses] {
+            setThreadName(str::stream() << "CollectionClonerRange-" << i);
+            ON_BLOCK_EXIT([&] {
+                stdx::lock_guard<Latch> lk(_mutex);
+                --_numRangeQueriesRunning;
+                _rangeQueriesCV.notify_all();
+            });
+
+            try {
+                auto client = _createClientFn();
+                _registerRangeClient(client.get());
+                ON_BLOCK_EXIT([&] { _unregisterRangeClient(client.get()); });
+
+                uassertStatusOK(client->connect(getSource(), StringData(), boost::none));
+                uassertStatusOK(replAuthenticate(client.get())
+                                    .withContext(str::stream()
+                                                 << "Failed to authenticate to " << getSource()));
+                runRangeQuery(client.get(), _ranges[i]);
+                _ranges[i].done = true;
+            } catch (const DBException& ex) {
+                statuses[i] = ex.toStatus();
+            }
+        });
+    }
+
+    // The range queries do not run on the cloner's executor, so they are not interrupted with it.
+    // Close their connections once initial sync fails or is shut down, since a query blocked on an
+    // unresponsive sync source would otherwise never return.
+    {
+        stdx::unique_lock<Latch> lk(_mutex);
+        while (_numRangeQueriesRunning > 0) {
+            _rangeQueriesCV.wait_for(lk,
+                                     kRangeQueriesInterruptCheckInterval.toSystemDuration(),
+                                     [&] { return _numRangeQueriesRunning == 0; });
+            if (_numRangeQueriesRunning == 0 || _rangeQueriesInterrupted) {
+                continue;
+            }
+
+            lk.unlock();
+            const bool interrupt = mustExit();
+            lk.lock();
+            if (interrupt) {
+                _interruptRangeQueries(lk);
+            }
+        }
+    }
+
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    {
+        stdx::lock_guard<InitialSyncSharedData> lk(*getSharedData());
+        uassert(ErrorCodes::CallbackCanceled,
+                str::stream() << "Collection cloning cancelled due to initial sync failure: "
+                              << getSharedData()->getStatus(lk),
+                getSharedData()->getStatus(lk).isOK());
+    }
+
+    // Report an error which cannot be retried in preference to one which can, since retrying
+    // would only run into the former again.
+    boost::optional<Status> firstError;
+    for (auto&& status : statuses) {
+        if (status.isOK()) {
+            continue;
+        }
+        if (!_queryStage.isTransientError(status)) {
+            uassertStatusOK(status);
+        }
+        if (!firstError) {
+            firstError = status;
+        }
+    }
+    if (firstError) {
+        uassertStatusOK(*firstError);
+    }
+}
+
+void CollectionCloner::runRangeQuery(DBClientConnection* client, Range& range) {
+    FindCommandRequest findCmd{_sourceDbAndUuid};
+    findCmd.setHint(BSON("_id" << 1));
+
+    // Index bounds are compared by index key order, unlike a query on _id, which only matches
+    // values of the same type. 'min' is inclusive, so a resumed query skips the last document
+    // it already fetched.
+    const bool resuming = !range.lastId.isEmpty();
+    const auto& min = resuming ? range.lastId : range.min;
+    if (!min.isEmpty()) {
+        findCmd.setMin(min);
+    }
+    if (!range.max.isEmpty()) {
+        findCmd.setMax(range.max);
+    }
+    findCmd.setNoCursorTimeout(true);
+    findCmd.setReadConcern(ReadConcernArgs::kLocal);
+    if (_collectionClonerBatchSize) {
+        findCmd.setBatchSize(_collectionClonerBatchSize);
+    }
+
+    ExhaustMode exhaustMode = collectionClonerUsesExhaust ? ExhaustMode::kOn : ExhaustMode::kOff;
+    auto cursor = client->find(
+        std::move(findCmd), ReadPreferenceSetting{ReadPreference::SecondaryPreferred}, exhaustMode);
+
+    bool skipLastId = resuming;
+    while (cursor->more()) {
+        {
+            stdx::lock_guard<InitialSyncSharedData> lk(*getSharedData());
+            uassert(ErrorCodes::CallbackCanceled,
+                    str::stream() << "Collection cloning cancelled due to initial sync failure: "
+                                  << getSharedData()->getStatus(lk),
+                    getSharedData()->getStatus(lk).isOK());
+        }
+
+        std::vector<BSONObj> docs;
+        while (cursor->moreInCurrentBatch()) {
+            auto doc = cursor->nextSafe();
+            if (std::exchange(skipLastId, false) &&
+                doc["_id"].binaryEqualValues(range.lastId.firstElement())) {
+                continue;
+            }
+            docs.emplace_back(std::move(doc));
+        }
+
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            _stats.receivedBatches++;
+        }
+        if (docs.empty()) {
+            continue;
+        }
+        // The range only resumes after this batch once it is scheduled to be inserted.
+        auto lastId = docs.back()["_id"].wrap();
+
+        // The ranges are fetched faster than their documents can be inserted through the single
+        // bulk loader, so stop fetching while too many batches are waiting to be inserted.
+        {
+            stdx::unique_lock<Latch> lk(_mutex);
+            _rangeQueriesCV.wait(lk, [&] {
+                return _numBufferedRangeBatches < collectionClonerMaxBufferedRangeBatches ||
+                    _rangeQueriesInterrupted;
+            });
+            uassert(ErrorCodes::CallbackCanceled,
+                    "Collection cloning cancelled while waiting to insert documents",
+                    !_rangeQueriesInterrupted);
+            ++_numBufferedRangeBatches;
+        }
+
+        auto&& scheduleResult = _scheduleDbWorkFn(
+            [this, docs = std::move(docs)](const executor::TaskExecutor::CallbackArgs& cbd) {
+                insertRangeDocumentsCallback(cbd, docs);
+            });
+        if (!scheduleResult.isOK()) {
+            stdx::lock_guard<Latch> lk(_mutex);
+            --_numBufferedRangeBatches;
+            _rangeQueriesCV.notify_all();
+        }
+        uassertStatusOK(scheduleResult.getStatus().withContext(
+            str::stream() << "Error cloning collection '" << _sourceNss.ns() << "'"));
+        range.lastId = std::move(lastId);
+    }
+}
+
+void CollectionCloner::_registerRangeClient(DBClientConnection* client) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_rangeQueriesInterrupted) {
+        // Connecting fails once the connection has been shut down.
+        client->shutdownAndDisallowReconnect();
+    }
+    _rangeClients.push_back(client);
+}
+
+void CollectionCloner::_unregisterRangeClient(DBClientConnection* client) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _rangeClients.erase(std::find(_rangeClients.begin(), _rangeClients.end(), client));
+}
+
+void CollectionCloner::_interruptRangeQueries(WithLock) {
+    LOGV2(7095762,
+          "Interrupting the range queries of a partitioned collection clone",
+          logAttrs(_sourceNss),
+          "numRangeQueries"_attr = _numRangeQueriesRunning);
+    _rangeQueriesInterrupted = true;
+    for (auto client : _rangeClients) {
+        client->shutdownAndDisallowReconnect();
+    }
+    _rangeQueriesCV.notify_all();
+}
+
 void CollectionCloner::handleNextBatch(DBClientCursor& cursor) {
     {
         stdx::lock_guard<InitialSyncSharedData> lk(*getSharedData());
@@ -465,6 +783,27 @@ void CollectionCloner::insertDocumentsCallback(const executor::TaskExecutor::Cal
         });
 }
 
+void CollectionCloner::insertRangeDocumentsCallback(
+    const executor::TaskExecutor::CallbackArgs& cbd, const std::vector<BSONObj>& docs) {
+    ON_BLOCK_EXIT([&] {
+        stdx::lock_guard<Latch> lk(_mutex);
+        --_numBufferedRangeBatches;
+        _rangeQueriesCV.notify_all();
+    });
+    uassertStatusOK(cbd.status);
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    ++_stats.fetchedBatches;
+    _stats.documentsCopied += docs.size();
+    _stats.approxBytesCopied = ((long)_stats.documentsCopied) * _stats.avgObjSize;
+    _progressMeter.hit(int(docs.size()));
+    invariant(_collLoader);
+
+    // The ranges are fetched in parallel, but CollectionBulkLoader is not thread safe, so their
+    // inserts are still serialized.
+    uassertStatusOK(_collLoader->insertDocuments(docs.cbegin(), docs.cend()));
+}
+
 bool CollectionCloner::isMyFailPoint(const BSONObj& data) const {
     auto nss = data["nss"].str();
     return (nss.empty() || nss == _sourceNss.toString()) && BaseCloner::isMyFailPoint(data);
@@ -510,6 +849,9 @@ void CollectionCloner::Stats::append(BSONObjBuilder* builder) const {
         }
     }
     builder->appendNumber("receivedBatches", static_cast<long long>(receivedBatches));
+    if (ranges) {
+        builder->appendNumber("ranges", static_cast<long long>(ranges));
+    }
 }
 
 }  // namespace repl
@@ -36,6 +36,7 @@
 #include "mongo/db/repl/initial_sync_base_cloner.h"
 #include "mongo/db/repl/initial_sync_shared_data.h"
 #include "mongo/db/repl/task_runner.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/util/progress_meter.h"
 
 namespace mongo {
@@ -60,6 +61,7 @@ public:
         size_t indexes{0};
         size_t fetchedBatches{0};  // This is actually inserted batches.
         size_t receivedBatches{0};
+        size_t ranges{0};
         long long bytesToCopy{0};
         long long avgObjSize{0};
         long long approxBytesCopied{0};
@@ -77,6 +79,34 @@ public:
     using ScheduleDbWorkFn = unique_function<StatusWith<executor::TaskExecutor::CallbackHandle>(
         executor::TaskExecutor::CallbackFn)>;
 
+    /**
+     * Type of function to create the connections used to fetch the ranges of a partitioned
+     * collection.
+     */
+    using CreateClientFn = std::function<std::unique_ptr<DBClientConnection>()>;
+
+    /**
+     * A range of the source collection's _id index, cloned by its own query. An empty 'min' or
+     * 'max' leaves that side of the range unbounded.
+     */
+    struct Range {
+        BSONObj min;
+        BSONObj max;
+
+        // The _id of the last document fetched in this range, used to resume the range's query
+        // after a transient error.
+        BSONObj lastId;
+
+        bool done = false;
+    };
+
+    /**
+     * Divides the collection into at most 'numRanges' ranges, choosing evenly spaced boundaries
+     * from 'splitKeys'. Each key has the form {_id: <value>}, and the keys must be distinct and
+     * sorted in _id index order.
+     */
+    static std::vector<Range> makeRanges(const std::vector<BSONObj>& splitKeys, int numRanges);
+
     CollectionCloner(const NamespaceString& ns,
                      const CollectionOptions& collectionOptions,
                      InitialSyncSharedData* sharedData,
@@ -122,6 +152,15 @@ public:
         _scheduleDbWorkFn = std::move(scheduleDbWorkFn);
     }
 
+    /**
+     * Overrides how the connections for partitioned cloning are created.
+     *
+     * For testing only.
+     */
+    void setCreateClientFn_forTest(CreateClientFn createClientFn) {
+        _createClientFn = std::move(createClientFn);
+    }
+
 protected:
     ClonerStages getStages() final;
 
@@ -194,6 +233,14 @@ private:
      */
     AfterStageBehavior createCollectionStage();
 
+    /**
+     * Stage function that samples the _id values of a large collection on the source and divides
+     * the collection into ranges of its _id index to be queried in parallel. Collections which
+     * are small, capped, have a non-simple default collation or have no _id index are left to a
+     * single query.
+     */
+    AfterStageBehavior splitStage();
+
     /**
      * Stage function that executes a query to retrieve all documents in the collection.  For each
      * batch returned by the upstream node, handleNextBatch will be called with the data.  This
@@ -201,6 +248,33 @@ private:
      */
     AfterStageBehavior queryStage();
 
+    /**
+     * Queries each range not yet done over its own connection, each on its own thread. Closes the
+     * connections if initial sync fails or is shut down meanwhile. Rethrows the first error
+     * encountered once all the range queries have stopped, so that a retry of the query stage
+     * resumes the unfinished ranges.
+     */
+    void runRangeQueries();
+
+    /**
+     * Fetches the documents of 'range' using 'client', resuming after 'range.lastId' if set.
+     * Blocks while 'collectionClonerMaxBufferedRangeBatches' fetched batches are waiting to be
+     * inserted.
+     */
+    void runRangeQuery(DBClientConnection* client, Range& range);
+
+    /**
+     * Tracks the connection of a range query so that _interruptRangeQueries() can close it. Closes
+     * it right away if the range queries were already interrupted.
+     */
+    void _registerRangeClient(DBClientConnection* client);
+    void _unregisterRangeClient(DBClientConnection* client);
+
+    /**
+     * Closes the connections of the running range queries and wakes those waiting to insert.
+     */
+    void _interruptRangeQueries(WithLock);
+
     /**
      * Stage function that sets up index builders for any unfinished two-phase index builds.
      */
@@ -220,6 +294,12 @@ private:
      */
     void insertDocumentsCallback(const executor::TaskExecutor::CallbackArgs& cbd);
 
+    /**
+     * Inserts a batch of documents fetched by one of the range queries.
+     */
+    void insertRangeDocumentsCallback(const executor::TaskExecutor::CallbackArgs& cbd,
+                                      const std::vector<BSONObj>& docs);
+
     /**
      * Sends a query command to the source. That query command with be parameterized based on
      * wire version and clone progress.
@@ -243,6 +323,7 @@ private:
     CollectionClonerStage _countStage;                                   // (R)
     CollectionClonerStage _listIndexesStage;                             // (R)
     CollectionClonerStage _createCollectionStage;                        // (R)
+    CollectionClonerStage _splitStage;                                   // (R)
     CollectionClonerQueryStage _queryStage;                              // (R)
     CollectionClonerStage _setupIndexBuildersForUnfinishedIndexesStage;  // (R)
 
@@ -253,6 +334,22 @@ private:
     std::unique_ptr<CollectionBulkLoader> _collLoader;  // (X)
     //  Function for scheduling database work using the executor.
     ScheduleDbWorkFn _scheduleDbWorkFn;  // (R)
+    // Function for creating the connections used by range queries.
+    CreateClientFn _createClientFn;  // (R)
+    // The ranges of a partitioned clone. Empty if the collection is cloned by a single query.
+    // While the range queries run, each range is only accessed by the thread querying it.
+    std::vector<Range> _ranges;  // (S)
+    // The connections of the running range queries.
+    std::vector<DBClientConnection*> _rangeClients;  // (M)
+    // The number of range queries which have not stopped yet.
+    size_t _numRangeQueriesRunning = 0;  // (M)
+    // The number of batches fetched by the range queries which have not been inserted yet.
+    int _numBufferedRangeBatches = 0;  // (M)
+    // Set once the running range queries have been interrupted.
+    bool _rangeQueriesInterrupted = false;  // (M)
+    // Signaled when a range query stops, a buffered batch is inserted, or the range queries are
+    // interrupted.
+    stdx::condition_variable _rangeQueriesCV;
     // Documents read from source to insert.
     std::vector<BSONObj> _documentsToInsert;  // (M)
     Stats _stats;                             // (M)
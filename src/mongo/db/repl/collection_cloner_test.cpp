@@ -38,6 +38,7 @@
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/db/repl/storage_interface_mock.h"
 #include "mongo/db/service_context_test_fixture.h"
+#include "mongo/idl/server_parameter_test_util.h"
 #include "mongo/dbtests/mock/mock_dbclient_connection.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/concurrency/thread_pool.h"
@@ -120,6 +121,17 @@ protected:
         return cloner->_idIndexSpec;
     }
 
+    // Makes a cloner which splits the collection into ranges at the sampled 'splitIds', and
+    // queries each range through its own connection to the mock server.
+    std::unique_ptr<CollectionCloner> makePartitionedCollectionCloner(const BSONArray& splitIds) {
+        _mockServer->setCommandReply("aggregate", createCursorResponse(_nss.ns(), splitIds));
+        auto cloner = makeCollectionCloner();
+        cloner->setCreateClientFn_forTest([this] {
+            return std::make_unique<MockDBClientConnection>(_mockServer.get(), true);
+        });
+        return cloner;
+    }
+
     std::shared_ptr<CollectionMockStats> _collectionStats;  // Used by the _loader.
     StorageInterfaceMock::CreateCollectionForBulkFn _standardCreateCollectionFn;
     CollectionBulkLoaderMock* _loader = nullptr;  // Owned by CollectionCloner.
@@ -1006,6 +1018,255 @@ TEST_F(CollectionClonerTestResumable, ResumableQueryTwoResumes) {
     ASSERT_EQUALS(7u, stats.documentsCopied);
 }
 
+TEST_F(CollectionClonerTestResumable, SmallCollectionIsNotPartitioned) {
+    RAIIServerParameterControllerForTest partitionCount{"collectionClonerPartitionCount", 4};
+    RAIIServerParameterControllerForTest minBytes{"collectionClonerMinBytesToPartition", 1000};
+    setMockServerReplies(BSON("size" << 10),
+                         createCountResponse(2),
+                         createCursorResponse(_nss.ns(), BSON_ARRAY(_idIndexSpec)));
+    _mockServer->insert(_nss.ns(), BSON("_id" << 1));
+    _mockServer->insert(_nss.ns(), BSON("_id" << 2));
+
+    auto cloner = makeCollectionCloner();
+    ASSERT_OK(cloner->run());
+
+    ASSERT_EQUALS(2, _collectionStats->insertCount);
+    ASSERT_TRUE(_collectionStats->commitCalled);
+    ASSERT_EQUALS(0u, cloner->getStats().ranges);
+}
+
+TEST_F(CollectionClonerTestResumable, FailedSampleFallsBackToSingleQuery) {
+    RAIIServerParameterControllerForTest partitionCount{"collectionClonerPartitionCount", 4};
+    RAIIServerParameterControllerForTest minBytes{"collectionClonerMinBytesToPartition", 0};
+    setMockServerReplies(BSON("size" << 10),
+                         createCountResponse(2),
+                         createCursorResponse(_nss.ns(), BSON_ARRAY(_idIndexSpec)));
+    _mockServer->setCommandReply("aggregate", Status(ErrorCodes::OperationFailed, ""));
+    _mockServer->insert(_nss.ns(), BSON("_id" << 1));
+    _mockServer->insert(_nss.ns(), BSON("_id" << 2));
+
+    auto cloner = makeCollectionCloner();
+    ASSERT_OK(cloner->run());
+
+    ASSERT_EQUALS(2, _collectionStats->insertCount);
+    ASSERT_TRUE(_collectionStats->commitCalled);
+    ASSERT_EQUALS(0u, cloner->getStats().ranges);
+}
+
+TEST_F(CollectionClonerTestResumable, PartitionedCollectionIsClonedInParallelRanges) {
+    RAIIServerParameterControllerForTest partitionCount{"collectionClonerPartitionCount", 3};
+    RAIIServerParameterControllerForTest minBytes{"collectionClonerMinBytesToPartition", 0};
+    setMockServerReplies(BSON("size" << 10),
+                         createCountResponse(9),
+                         createCursorResponse(_nss.ns(), BSON_ARRAY(_idIndexSpec)));
+    for (int i = 1; i <= 9; ++i) {
+        _mockServer->insert(_nss.ns(), BSON("_id" << i));
+    }
+
+    auto cloner = makePartitionedCollectionCloner(
+        BSON_ARRAY(BSON("_id" << 7) << BSON("_id" << 2) << BSON("_id" << 4) << BSON("_id" << 4)));
+    cloner->setBatchSize_forTest(2);
+    ASSERT_OK(cloner->run());
+
+    // Every document is fetched by exactly one of the ranges.
+    ASSERT_EQUALS(9, _collectionStats->insertCount);
+    ASSERT_TRUE(_collectionStats->commitCalled);
+    auto stats = cloner->getStats();
+    ASSERT_EQUALS(3u, stats.ranges);
+    ASSERT_EQUALS(9u, stats.documentsCopied);
+}
+
+// Runs the inserts of the range queries on the calling thread, or holds them back until released.
+class HeldDbWork {
+public:
+    CollectionCloner::ScheduleDbWorkFn scheduleFn() {
+        return [this](executor::TaskExecutor::CallbackFn workFn) {
+            executor::TaskExecutor::CallbackHandle handle(std::make_shared<MockCallbackState>());
+            stdx::lock_guard<Latch> lk(_mutex);
+            if (_holding) {
+                _held.push_back(std::move(workFn));
+                return StatusWith<executor::TaskExecutor::CallbackHandle>(handle);
+            }
+            // The bulk loader is not thread safe, so the inserts still run one at a time.
+            workFn(executor::TaskExecutor::CallbackArgs(nullptr, handle, Status::OK()));
+            return StatusWith<executor::TaskExecutor::CallbackHandle>(handle);
+        };
+    }
+
+    size_t numHeld() {
+        stdx::lock_guard<Latch> lk(_mutex);
+        return _held.size();
+    }
+
+    void release() {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _holding = false;
+        executor::TaskExecutor::CallbackHandle handle(std::make_shared<MockCallbackState>());
+        for (auto&& workFn : std::exchange(_held, {})) {
+            workFn(executor::TaskExecutor::CallbackArgs(nullptr, handle, Status::OK()));
+        }
+    }
+
+private:
+    Mutex _mutex = MONGO_MAKE_LATCH("HeldDbWork::_mutex");
+    bool _holding = true;
+    std::vector<executor::TaskExecutor::CallbackFn> _held;
+};
+
+TEST_F(CollectionClonerTestResumable, RangeQueriesStopFetchingWhileBatchesAreBuffered) {
+    RAIIServerParameterControllerForTest partitionCount{"collectionClonerPartitionCount", 2};
+    RAIIServerParameterControllerForTest minBytes{"collectionClonerMinBytesToPartition", 0};
+    RAIIServerParameterControllerForTest maxBuffered{"collectionClonerMaxBufferedRangeBatches", 1};
+    setMockServerReplies(BSON("size" << 10),
+                         createCountResponse(8),
+                         createCursorResponse(_nss.ns(), BSON_ARRAY(_idIndexSpec)));
+    for (int i = 1; i <= 8; ++i) {
+        _mockServer->insert(_nss.ns(), BSON("_id" << i));
+    }
+
+    auto cloner = makePartitionedCollectionCloner(BSON_ARRAY(BSON("_id" << 5)));
+    cloner->setBatchSize_forTest(2);
+    HeldDbWork dbWork;
+    cloner->setScheduleDbWorkFn_forTest(dbWork.scheduleFn());
+
+    stdx::thread clonerThread([&] {
+        Client::initThread("ClonerRunner");
+        ASSERT_OK(cloner->run());
+    });
+
+    // Once one batch is buffered, the range which buffered it fetches one more batch and the
+    // other range fetches its first, and then both wait for the buffered batch to be inserted.
+    while (cloner->getStats().receivedBatches < 3) {
+        sleepmillis(10);
+    }
+    sleepmillis(100);
+    ASSERT_EQUALS(3, cloner->getStats().receivedBatches);
+    ASSERT_EQUALS(1u, dbWork.numHeld());
+    ASSERT_EQUALS(0, _collectionStats->insertCount);
+
+    dbWork.release();
+    clonerThread.join();
+
+    ASSERT_EQUALS(8, _collectionStats->insertCount);
+    ASSERT_TRUE(_collectionStats->commitCalled);
+    ASSERT_EQUALS(8u, cloner->getStats().documentsCopied);
+}
+
+TEST_F(CollectionClonerTestResumable, FailedRangeQueryResumesAfterLastInsertedId) {
+    RAIIServerParameterControllerForTest partitionCount{"collectionClonerPartitionCount", 2};
+    RAIIServerParameterControllerForTest minBytes{"collectionClonerMinBytesToPartition", 0};
+    RAIIServerParameterControllerForTest maxBuffered{"collectionClonerMaxBufferedRangeBatches", 1};
+    setMockServerReplies(BSON("size" << 10),
+                         createCountResponse(8),
+                         createCursorResponse(_nss.ns(), BSON_ARRAY(_idIndexSpec)));
+    for (int i = 1; i <= 8; ++i) {
+        _mockServer->insert(_nss.ns(), BSON("_id" << i));
+    }
+
+    auto cloner = makePartitionedCollectionCloner(BSON_ARRAY(BSON("_id" << 5)));
+    cloner->setBatchSize_forTest(2);
+    HeldDbWork dbWork;
+    cloner->setScheduleDbWorkFn_forTest(dbWork.scheduleFn());
+
+    stdx::thread clonerThread([&] {
+        Client::initThread("ClonerRunner");
+        ASSERT_OK(cloner->run());
+    });
+
+    // Wait for both ranges to have fetched their first batch, so that the next getMore of either
+    // range follows a batch it has scheduled to be inserted.
+    while (cloner->getStats().receivedBatches < 3) {
+        sleepmillis(10);
+    }
+
+    // This will cause the next batch of one of the ranges to fail once (transiently).
+    auto failNextBatch = globalFailPointRegistry().find("mockCursorThrowErrorOnGetMore");
+    failNextBatch->setMode(FailPoint::nTimes, 1, fromjson("{errorType: 'HostUnreachable'}"));
+
+    dbWork.release();
+    clonerThread.join();
+
+    // The failed range is queried again from its last inserted _id, which is skipped. Querying
+    // the range from its start would insert its first batch again.
+    ASSERT_EQUALS(8, _collectionStats->insertCount);
+    ASSERT_TRUE(_collectionStats->commitCalled);
+    auto stats = cloner->getStats();
+    ASSERT_EQUALS(2u, stats.ranges);
+    ASSERT_EQUALS(8u, stats.documentsCopied);
+}
+
+TEST_F(CollectionClonerTestResumable, InitialSyncFailureInterruptsRangeQueries) {
+    RAIIServerParameterControllerForTest partitionCount{"collectionClonerPartitionCount", 2};
+    RAIIServerParameterControllerForTest minBytes{"collectionClonerMinBytesToPartition", 0};
+    RAIIServerParameterControllerForTest maxBuffered{"collectionClonerMaxBufferedRangeBatches", 1};
+    setMockServerReplies(BSON("size" << 10),
+                         createCountResponse(8),
+                         createCursorResponse(_nss.ns(), BSON_ARRAY(_idIndexSpec)));
+    for (int i = 1; i <= 8; ++i) {
+        _mockServer->insert(_nss.ns(), BSON("_id" << i));
+    }
+
+    auto cloner = makePartitionedCollectionCloner(BSON_ARRAY(BSON("_id" << 5)));
+    cloner->setBatchSize_forTest(2);
+    HeldDbWork dbWork;
+    cloner->setScheduleDbWorkFn_forTest(dbWork.scheduleFn());
+
+    stdx::thread clonerThread([&] {
+        Client::initThread("ClonerRunner");
+        ASSERT_EQUALS(ErrorCodes::CallbackCanceled, cloner->run());
+    });
+
+    // Both ranges are now blocked waiting for the held batch to be inserted, which it never is.
+    while (cloner->getStats().receivedBatches < 3) {
+        sleepmillis(10);
+    }
+    {
+        stdx::lock_guard<InitialSyncSharedData> lk(*getSharedData());
+        getSharedData()->setStatusIfOK(lk, Status(ErrorCodes::UnknownError, "test failure"));
+    }
+    // Only interrupting the range queries wakes them, so this would hang if they were not.
+    clonerThread.join();
+
+    ASSERT_EQUALS(0, _collectionStats->insertCount);
+    ASSERT_FALSE(_collectionStats->commitCalled);
+    ASSERT_EQUALS(3, cloner->getStats().receivedBatches);
+}
+
+TEST(CollectionClonerRangesTest, MakeRangesChoosesEvenlySpacedBoundaries) {
+    std::vector<BSONObj> splitKeys;
+    for (int i = 0; i < 9; ++i) {
+        splitKeys.push_back(BSON("_id" << i));
+    }
+
+    auto ranges = CollectionCloner::makeRanges(splitKeys, 4);
+    ASSERT_EQUALS(4u, ranges.size());
+    ASSERT_BSONOBJ_EQ(BSONObj(), ranges[0].min);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 2), ranges[0].max);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 2), ranges[1].min);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 4), ranges[1].max);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 4), ranges[2].min);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 6), ranges[2].max);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 6), ranges[3].min);
+    ASSERT_BSONOBJ_EQ(BSONObj(), ranges[3].max);
+    for (auto&& range : ranges) {
+        ASSERT_TRUE(range.lastId.isEmpty());
+        ASSERT_FALSE(range.done);
+    }
+}
+
+TEST(CollectionClonerRangesTest, MakeRangesUsesEveryKeyWhenThereAreFewKeys) {
+    auto ranges = CollectionCloner::makeRanges({BSON("_id" << 1), BSON("_id" << 2)}, 8);
+    ASSERT_EQUALS(3u, ranges.size());
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 1), ranges[0].max);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 2), ranges[1].max);
+    ASSERT_BSONOBJ_EQ(BSON("_id" << 2), ranges[2].min);
+}
+
+TEST(CollectionClonerRangesTest, MakeRangesReturnsNothingWithoutBoundaries) {
+    ASSERT_TRUE(CollectionCloner::makeRanges({}, 4).empty());
+    ASSERT_TRUE(CollectionCloner::makeRanges({BSON("_id" << 1)}, 1).empty());
+}
+
 
 }  // namespace repl
 }  // namespace mongo
@@ -0,0 +1,1049 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/db/repl/file_copy_based_initial_syncer.h"
+
+#include <boost/filesystem/operations.hpp>
+#include <fstream>
+#include <utility>
+
+#include "mongo/client/dbclient_cursor.h"
+#include "mongo/client/read_preference.h"
+
+#include "mongo/db/catalog/catalog_control.h"
+#include "mongo/db/client.h"
+#include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/concurrency/lock_state.h"
+#include "mongo/db/cursor_server_params_gen.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/pipeline/aggregate_command_gen.h"
+#include "mongo/db/query/cursor_response.h"
+#include "mongo/db/query/find_command_gen.h"
+#include "mongo/db/repl/initial_syncer_common_stats.h"
+#include "mongo/db/repl/initial_syncer_factory.h"
+#include "mongo/db/repl/read_concern_args.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
+#include "mongo/db/repl/replication_auth.h"
+#include "mongo/db/repl/replication_consistency_markers.h"
+#include "mongo/db/repl/replication_recovery.h"
+#include "mongo/db/repl/sync_source_selector.h"
+#include "mongo/db/repl/tenant_migration_access_blocker_util.h"
+#include "mongo/db/repl/transaction_oplog_application.h"
+#include "mongo/db/serverless/serverless_operation_lock_registry.h"
+#include "mongo/db/startup_recovery.h"
+#include "mongo/db/storage/backup_cursor_hooks.h"
+#include "mongo/db/storage/storage_engine_init.h"
+#include "mongo/db/storage/storage_file_util.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/logv2/log.h"
+#include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/util/destructor_guard.h"
+#include "mongo/util/fail_point.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/str.h"
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kReplicationInitialSync
+
+namespace mongo {
+namespace repl {
+
+// Failpoint which causes the file copy based initial sync to hang after copying the sync source's
+// files, before switching the storage engine over to them.
+MONGO_FAIL_POINT_DEFINE(fileCopyBasedInitialSyncHangBeforeSwitchingStorage);
+
+namespace {
+
+// Keep the backup cursor alive by sending a getMore twice as often as the sync source's default
+// cursor timeout.
+constexpr Milliseconds kBackupCursorKeepAliveInterval{kCursorTimeoutMillisDefault / 2};
+
+// Files in the dbpath which are kept when the cloned files are moved into it.
+const std::vector<std::string> kFilesToKeep = {"mongod.lock", "diagnostic.data"};
+
+ServiceContext::ConstructorActionRegisterer fileCopyBasedInitialSyncerRegisterer(
+    "FileCopyBasedInitialSyncerRegisterer",
+    {"InitialSyncerFactoryRegisterer"} /* dependency list */,
+    [](ServiceContext* service) {
+        InitialSyncerFactory::get(service)->registerInitialSyncer(
+            FileCopyBasedInitialSyncer::kInitialSyncMethodName.toString(),
+            [service](InitialSyncerInterface::Options opts,
+                      std::unique_ptr<DataReplicatorExternalState> dataReplicatorExternalState,
+                      ThreadPool* writerPool,
+                      StorageInterface* storage,
+                      ReplicationProcess* replicationProcess,
+                      const InitialSyncerInterface::OnCompletionFn& onCompletion) {
+                // Builds without backup cursors can neither serve nor test a file copy, so the
+                // method is not available on them and the node uses logical initial sync.
+                uassert(ErrorCodes::NotImplemented,
+                        "File copy based initial sync requires backup cursor support",
+                        BackupCursorHooks::get(service)->enabled());
+                return std::make_shared<FileCopyBasedInitialSyncer>(
+                    opts,
+                    std::move(dataReplicatorExternalState),
+                    storage,
+                    replicationProcess,
+                    onCompletion);
+            },
+            FileCopyBasedInitialSyncer::runCrashRecovery);
+    });
+
+/**
+ * Returns true if 'status' means the sync source cannot open a backup cursor at all, as opposed to
+ * failing to open one this time.
+ */
+bool isBackupCursorUnsupported(const Status& status) {
+    // 40324 is the code for an unrecognized aggregation stage.
+    return status.code() == 40324 || status == ErrorCodes::NotImplemented ||
+        status == ErrorCodes::CommandNotSupported;
+}
+
+bool isRetriableError(const Status& status) {
+    return ErrorCodes::isRetriableError(status) || ErrorCodes::isNetworkError(status);
+}
+
+boost::filesystem::path clonedFilesDir() {
+    return boost::filesystem::path(storageGlobalParams.dbpath) /
+        FileCopyBasedInitialSyncer::kClonedFilesDirName.toString();
+}
+
+/**
+ * Makes the creation, removal and renaming of the entries of the directory 'dir' durable.
+ */
+void fsyncDirectory(const boost::filesystem::path& dir) {
+    uassertStatusOK(fsyncParentDirectory(dir / "."));
+}
+
+/**
+ * Removes everything in 'dir' except the entries named in 'kFilesToKeep' and 'alsoKeep'.
+ */
+void removeDirectoryContents(const boost::filesystem::path& dir, const std::string& alsoKeep) {
+    std::vector<boost::filesystem::path> toRemove;
+    for (const auto& entry : boost::filesystem::directory_iterator(dir)) {
+        const auto name = entry.path().filename().string();
+        if (name == alsoKeep ||
+            std::find(kFilesToKeep.begin(), kFilesToKeep.end(), name) != kFilesToKeep.end()) {
+            continue;
+        }
+        toRemove.push_back(entry.path());
+    }
+    for (const auto& path : toRemove) {
+        boost::filesystem::remove_all(path);
+    }
+}
+
+}  // namespace
+
+FileCopyBasedInitialSyncer::FileCopyBasedInitialSyncer(
+    InitialSyncerInterface::Options opts,
+    std::unique_ptr<DataReplicatorExternalState> dataReplicatorExternalState,
+    StorageInterface* storage,
+    ReplicationProcess* replicationProcess,
+    const OnCompletionFn& onCompletion)
+    : _opts(opts),
+      _dataReplicatorExternalState(std::move(dataReplicatorExternalState)),
+      _storage(storage),
+      _replicationProcess(replicationProcess),
+      _onCompletion(onCompletion),
+      _createClientFn(
+          [] { return std::make_unique<DBClientConnection>(true /* autoReconnect */); }) {
+    uassert(ErrorCodes::BadValue, "invalid storage interface", _storage);
+    uassert(ErrorCodes::BadValue, "invalid replication process", _replicationProcess);
+    uassert(ErrorCodes::BadValue, "invalid getMyLastOptime function", _opts.getMyLastOptime);
+    uassert(ErrorCodes::BadValue, "invalid setMyLastOptime function", _opts.setMyLastOptime);
+    uassert(ErrorCodes::BadValue, "invalid resetOptimes function", _opts.resetOptimes);
+    uassert(ErrorCodes::BadValue, "invalid sync source selector", _opts.syncSourceSelector);
+    uassert(ErrorCodes::BadValue, "callback function cannot be null", _onCompletion);
+}
+
+FileCopyBasedInitialSyncer::~FileCopyBasedInitialSyncer() {
+    DESTRUCTOR_GUARD({
+        shutdown().transitional_ignore();
+        join();
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+    });
+}
+
+Status FileCopyBasedInitialSyncer::startup(OperationContext* opCtx,
+                                           std::uint32_t maxAttempts) noexcept {
+    invariant(opCtx);
+    invariant(maxAttempts >= 1U);
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    switch (_state) {
+        case State::kPreStart:
+            _state = State::kRunning;
+            break;
+        case State::kRunning:
+            return Status(ErrorCodes::IllegalOperation, "initial syncer already started");
+        case State::kShuttingDown:
+            return Status(ErrorCodes::ShutdownInProgress, "initial syncer shutting down");
+        case State::kComplete:
+            return Status(ErrorCodes::ShutdownInProgress, "initial syncer completed");
+    }
+
+    try {
+        _replicationProcess->getConsistencyMarkers()->setInitialSyncFlag(opCtx);
+        _replicationProcess->getConsistencyMarkers()->clearInitialSyncId(opCtx);
+
+        auto serviceCtx = opCtx->getServiceContext();
+        _storage->setInitialDataTimestamp(serviceCtx, Timestamp::kAllowUnstableCheckpointsSentinel);
+        _storage->setStableTimestamp(serviceCtx, Timestamp::min());
+
+        _initialSyncStart = serviceCtx->getFastClockSource()->now();
+        _maxAttempts = maxAttempts;
+        _thread = stdx::thread([this, maxAttempts] { _run(maxAttempts); });
+    } catch (const DBException& e) {
+        _state = State::kComplete;
+        return e.toStatus();
+    }
+
+    return Status::OK();
+}
+
+Status FileCopyBasedInitialSyncer::shutdown() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    switch (_state) {
+        case State::kPreStart:
+            // Transition directly from PreStart to Complete if not started yet.
+            _state = State::kComplete;
+            return Status::OK();
+        case State::kRunning:
+            _state = State::kShuttingDown;
+            break;
+        case State::kShuttingDown:
+        case State::kComplete:
+            return Status::OK();
+    }
+
+    if (_client) {
+        _client->shutdownAndDisallowReconnect();
+    }
+    _stateCondition.notify_all();
+    return Status::OK();
+}
+
+void FileCopyBasedInitialSyncer::join() {
+    stdx::unique_lock<Latch> lk(_mutex);
+    _stateCondition.wait(lk, [this] {
+        return _state == State::kPreStart || _state == State::kComplete;
+    });
+}
+
+void FileCopyBasedInitialSyncer::cancelCurrentAttempt() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_state != State::kRunning) {
+        LOGV2_DEBUG(7095723,
+                    1,
+                    "There is no initial sync attempt to cancel because the initial syncer is not "
+                    "currently active.");
+        return;
+    }
+    LOGV2_DEBUG(7095724,
+                1,
+                "Cancelling the current initial sync attempt.",
+                "currentAttempt"_attr = _failedAttempts + 1);
+    _attemptCancelled = true;
+    if (_client) {
+        _client->shutdownAndDisallowReconnect();
+    }
+    _stateCondition.notify_all();
+}
+
+std::string FileCopyBasedInitialSyncer::getInitialSyncMethod() const {
+    return kInitialSyncMethodName.toString();
+}
+
+bool FileCopyBasedInitialSyncer::allowLocalDbAccess() const {
+    // The local database is replaced along with everything else when the storage engine switches
+    // to the cloned files.
+    return false;
+}
+
+void FileCopyBasedInitialSyncer::setCreateClientFn_forTest(const CreateClientFn& createClientFn) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _createClientFn = createClientFn;
+}
+
+BSONObj FileCopyBasedInitialSyncer::getInitialSyncProgress() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    BSONObjBuilder bob;
+    bob.append("method", getInitialSyncMethod());
+    bob.append("failedInitialSyncAttempts", static_cast<int>(_failedAttempts));
+    bob.append("maxFailedInitialSyncAttempts", static_cast<int>(_maxAttempts));
+    if (_initialSyncStart != Date_t()) {
+        bob.appendDate("initialSyncStart", _initialSyncStart);
+    }
+    if (!_syncSource.empty()) {
+        bob.append("syncSource", _syncSource.toString());
+    }
+    if (_backupId) {
+        _backupId->appendToBuilder(&bob, "backupId");
+        bob.append("checkpointTimestamp", _checkpointTimestamp);
+    }
+    bob.appendNumber("filesToCopy", static_cast<long long>(_filesToCopy));
+    bob.appendNumber("filesCopied", static_cast<long long>(_filesCopied));
+    bob.appendNumber("bytesToCopy", _bytesToCopy);
+    bob.appendNumber("bytesCopied", _bytesCopied);
+    bob.appendNumber("backupCursorExtensions", static_cast<long long>(_backupCursorExtensions));
+
+    BSONArrayBuilder attempts(bob.subarrayStart("initialSyncAttempts"));
+    for (const auto& attempt : _attemptErrors) {
+        attempts.append(attempt);
+    }
+    attempts.done();
+    return bob.obj();
+}
+
+std::string FileCopyBasedInitialSyncer::getRelativePath(const std::string& path,
+                                                        const std::string& basePath) {
+    uassert(7095725,
+            str::stream() << "The file " << path << " is not in the directory " << basePath,
+            !basePath.empty() && StringData(path).startsWith(basePath));
+
+    auto result = path.substr(basePath.size());
+    // Skip separators at the beginning of the relative part.
+    while (!result.empty() && (result[0] == '/' || result[0] == '\\')) {
+        result.erase(result.begin());
+    }
+    std::replace(result.begin(), result.end(), '\\', '/');
+
+    // A base path of "/data/db" must not match "/data/db2/collection.wt".
+    uassert(7095726,
+            str::stream() << "The file " << path << " is not in the directory " << basePath,
+            !result.empty() &&
+                (basePath.back() == '/' || basePath.back() == '\\' ||
+                 path[basePath.size()] == '/' || path[basePath.size()] == '\\'));
+    return result;
+}
+
+void FileCopyBasedInitialSyncer::moveClonedFiles(const boost::filesystem::path& dbPath,
+                                                 const boost::filesystem::path& clonedFilesDir) {
+    const auto clonedFilesDirName = clonedFilesDir.filename().string();
+    const auto marker = clonedFilesDir / kMovingFilesMarkerName.toString();
+    {
+        std::ofstream markerFile(marker.string());
+        uassert(ErrorCodes::FileOpenFailed,
+                str::stream() << "Failed to create " << marker.string(),
+                !markerFile.fail());
+    }
+    // Crash recovery can only clean up after the steps below if the marker is on disk first.
+    uassertStatusOK(fsyncFile(marker));
+    fsyncDirectory(clonedFilesDir);
+    fsyncDirectory(dbPath);
+
+    removeDirectoryContents(dbPath, clonedFilesDirName);
+    fsyncDirectory(dbPath);
+
+    for (const auto& entry : boost::filesystem::directory_iterator(clonedFilesDir)) {
+        const auto name = entry.path().filename();
+        if (name == kMovingFilesMarkerName.toString()) {
+            continue;
+        }
+        boost::filesystem::rename(entry.path(), dbPath / name);
+    }
+    fsyncDirectory(clonedFilesDir);
+    fsyncDirectory(dbPath);
+}
+
+void FileCopyBasedInitialSyncer::runCrashRecovery() {
+    const auto dir = clonedFilesDir();
+    if (!boost::filesystem::exists(dir)) {
+        return;
+    }
+
+    if (boost::filesystem::exists(dir / kMovingFilesMarkerName.toString())) {
+        // The dbpath holds some mix of this node's files and the sync source's, or the sync
+        // source's files before initial sync finished with them. Neither can be used, so start
+        // over from an empty dbpath.
+        LOGV2(7095727,
+              "File copy based initial sync was interrupted while switching to the cloned files; "
+              "removing the data files so that initial sync starts over",
+              "dbpath"_attr = storageGlobalParams.dbpath);
+        removeDirectoryContents(storageGlobalParams.dbpath, dir.filename().string());
+        // The marker must outlive the files it protects.
+        fsyncDirectory(storageGlobalParams.dbpath);
+    } else {
+        LOGV2(7095728,
+              "Removing the files of an unfinished file copy based initial sync",
+              "directory"_attr = dir.string());
+    }
+    boost::filesystem::remove_all(dir);
+}
+
+void FileCopyBasedInitialSyncer::_run(std::uint32_t maxAttempts) {
+    Client::initThread("FileCopyBasedInitialSyncer");
+
+    StatusWith<OpTimeAndWallTime> result =
+        Status(ErrorCodes::InternalError, "No initial sync attempt was made");
+    for (std::uint32_t attempt = 0; attempt < maxAttempts; ++attempt) {
+        LOGV2(7095729,
+              "Starting file copy based initial sync attempt",
+              "initialSyncAttempt"_attr = attempt + 1,
+              "initialSyncMaxAttempts"_attr = maxAttempts);
+        try {
+            result = _runAttempt();
+        } catch (const DBException& e) {
+            result = e.toStatus();
+        }
+
+        stdx::unique_lock<Latch> lk(_mutex);
+        _attemptCancelled = false;
+        if (result.isOK()) {
+            break;
+        }
+
+        ++_failedAttempts;
+        _attemptErrors.push_back(BSON("status" << result.getStatus().toString() << "syncSource"
+                                               << _syncSource.toString()));
+        LOGV2_ERROR(7095730,
+                    "File copy based initial sync attempt failed",
+                    "attemptsLeft"_attr = maxAttempts - (attempt + 1),
+                    "error"_attr = redact(result.getStatus()));
+        initial_sync_common_stats::initialSyncFailedAttempts.increment();
+
+        // Give up early when shutting down, and when the sync source cannot serve a file copy
+        // based initial sync at all; InvalidSyncSource makes the node fall back to logical initial
+        // sync.
+        if (_state == State::kShuttingDown || result == ErrorCodes::InvalidSyncSource) {
+            break;
+        }
+        _stateCondition.wait_for(lk, _opts.initialSyncRetryWait.toSystemDuration(), [this] {
+            return _state == State::kShuttingDown;
+        });
+    }
+
+    if (result.isOK()) {
+        initial_sync_common_stats::initialSyncCompletes.increment();
+    } else if (result != ErrorCodes::InvalidSyncSource) {
+        initial_sync_common_stats::initialSyncFailures.increment();
+    }
+
+    decltype(_onCompletion) onCompletion;
+    std::swap(_onCompletion, onCompletion);
+    try {
+        onCompletion(result);
+    } catch (...) {
+        LOGV2_WARNING(7095731,
+                      "Initial syncer finish callback threw exception",
+                      "error"_attr = redact(exceptionToStatus()));
+    }
+    onCompletion = {};
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    _state = State::kComplete;
+    _stateCondition.notify_all();
+}
+
+OpTimeAndWallTime FileCopyBasedInitialSyncer::_runAttempt() {
+    _opts.resetOptimes();
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _syncSource = HostAndPort();
+        _backupId = boost::none;
+        _filesToCopy = _filesCopied = 0;
+        _bytesToCopy = _bytesCopied = 0;
+        _backupCursorExtensions = 0;
+    }
+
+    HostAndPort syncSource;
+    for (int i = 0; i < numInitialSyncConnectAttempts.load(); ++i) {
+        _checkForCancellation();
+        syncSource = _opts.syncSourceSelector->chooseNewSyncSource(OpTime());
+        if (!syncSource.empty()) {
+            break;
+        }
+        stdx::unique_lock<Latch> lk(_mutex);
+        _stateCondition.wait_for(lk, _opts.syncSourceRetryWait.toSystemDuration(), [this] {
+            return _state != State::kRunning || _attemptCancelled;
+        });
+    }
+    uassert(ErrorCodes::InitialSyncOplogSourceMissing,
+            "No valid sync source available for file copy based initial sync",
+            !syncSource.empty());
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _syncSource = syncSource;
+    }
+    LOGV2(7095732,
+          "Chose sync source for file copy based initial sync",
+          "syncSource"_attr = syncSource);
+
+    auto client = _connect();
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _client = std::move(client);
+    }
+    ON_BLOCK_EXIT([this] {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _client.reset();
+    });
+    // A shutdown before '_client' was set could not interrupt it.
+    _checkForCancellation();
+
+    const auto dir = clonedFilesDir();
+    boost::filesystem::remove_all(dir);
+    boost::filesystem::create_directory(dir);
+    ScopeGuard removeClonedFiles([&] {
+        boost::system::error_code ec;
+        boost::filesystem::remove_all(dir, ec);
+    });
+
+    // The timestamp up to which the copied oplog has no holes: the backup's checkpoint timestamp,
+    // then the point each backup cursor extension waited for.
+    Timestamp copiedUpTo;
+    {
+        auto files = _openBackupCursor();
+        ON_BLOCK_EXIT([this] { _closeBackupCursor(); });
+        _keepAliveThread = stdx::thread([this] {
+            Client::initThread("FileCopyBasedInitialSyncerKeepAlive");
+            _keepBackupCursorAlive();
+        });
+
+        for (const auto& file : files) {
+            _cloneFile(file);
+        }
+
+        // Copy the journal until the copy is close enough to the sync source that steady state
+        // replication can catch up from it.
+        const auto maxLag = Seconds(fileBasedInitialSyncMaxLagSec);
+        copiedUpTo = [&] {
+            stdx::lock_guard<Latch> lk(_mutex);
+            return _checkpointTimestamp;
+        }();
+        for (int cycle = 0;; ++cycle) {
+            auto syncSourceLastApplied = _getSyncSourceLastApplied();
+            auto lag = Seconds(syncSourceLastApplied.getSecs() - copiedUpTo.getSecs());
+            if (syncSourceLastApplied <= copiedUpTo || lag <= maxLag) {
+                break;
+            }
+            if (cycle >= fileBasedInitialSyncMaxCyclesWithoutProgress) {
+                LOGV2(7095733,
+                      "File copy based initial sync is still behind its sync source after the "
+                      "maximum number of backup cursor extensions; steady state replication "
+                      "will catch up",
+                      "lag"_attr = lag,
+                      "maxLag"_attr = maxLag);
+                break;
+            }
+            for (const auto& file : _extendBackupCursor(syncSourceLastApplied)) {
+                _cloneFile(file);
+            }
+            copiedUpTo = syncSourceLastApplied;
+        }
+    }
+
+    if (MONGO_unlikely(fileCopyBasedInitialSyncHangBeforeSwitchingStorage.shouldFail())) {
+        LOGV2(7095734, "fileCopyBasedInitialSyncHangBeforeSwitchingStorage fail point enabled");
+        fileCopyBasedInitialSyncHangBeforeSwitchingStorage.pauseWhileSet();
+    }
+    _checkForCancellation();
+
+    auto opCtx = cc().makeOperationContext();
+    auto lastApplied = _switchToClonedFiles(opCtx.get(), copiedUpTo);
+
+    // The files are in use now, so the cloned files directory must only be removed once initial
+    // sync has finished with them.
+    removeClonedFiles.dismiss();
+
+    // Mirror the logical initial syncer's teardown. The initial sync id was copied from the sync
+    // source, so this node needs its own.
+    _storage->oplogDiskLocRegister(opCtx.get(), lastApplied.opTime.getTimestamp(), true);
+    tenant_migration_access_blocker::recoverTenantMigrationAccessBlockers(opCtx.get());
+    ServerlessOperationLockRegistry::recoverLocks(opCtx.get());
+    reconstructPreparedTransactions(opCtx.get(), OplogApplication::Mode::kInitialSync);
+
+    auto consistencyMarkers = _replicationProcess->getConsistencyMarkers();
+    consistencyMarkers->clearInitialSyncId(opCtx.get());
+    consistencyMarkers->setInitialSyncIdIfNotSet(opCtx.get());
+    _storage->setInitialDataTimestamp(opCtx->getServiceContext(),
+                                      lastApplied.opTime.getTimestamp());
+    consistencyMarkers->clearInitialSyncFlag(opCtx.get());
+    _opts.setMyLastOptime(lastApplied);
+
+    boost::filesystem::remove_all(dir);
+
+    LOGV2(7095735,
+          "File copy based initial sync done",
+          "lastApplied"_attr = lastApplied.opTime,
+          "duration"_attr = duration_cast<Seconds>(
+              opCtx->getServiceContext()->getFastClockSource()->now() - _initialSyncStart));
+    return lastApplied;
+}
+
+std::unique_ptr<DBClientConnection> FileCopyBasedInitialSyncer::_connect() {
+    auto [client, syncSource] = [&] {
+        stdx::lock_guard<Latch> lk(_mutex);
+        return std::make_pair(_createClientFn(), _syncSource);
+    }();
+    uassertStatusOK(client->connect(syncSource, StringData(), boost::none));
+    uassertStatusOK(replAuthenticate(client.get())
+                        .withContext(str::stream() << "Failed to authenticate to " << syncSource));
+    return std::move(client);
+}
+
+std::vector<FileCopyBasedInitialSyncer::BackupFile>
+FileCopyBasedInitialSyncer::_openBackupCursor() {
+    const auto cmd =
+        BSON("aggregate" << 1 << "pipeline"
+                         << BSON_ARRAY(BSON("$backupCursor" << BSONObj())) << "cursor"
+                         << BSONObj());
+    BSONObj reply;
+    {
+        auto client = [&] {
+            stdx::lock_guard<Latch> lk(_mutex);
+            return _client.get();
+        }();
+        client->runCommand(NamespaceString::kAdminDb.toString(), cmd, reply);
+    }
+    auto status = getStatusFromCommandResult(reply);
+    if (isBackupCursorUnsupported(status)) {
+        uasserted(ErrorCodes::InvalidSyncSource,
+                  str::stream() << "The sync source cannot open a backup cursor: " << status);
+    }
+    uassertStatusOKWithContext(status, "Failed to open a backup cursor on the sync source");
+
+    CursorId cursorId = 0;
+    auto docs = _readAllBatches(reply, &cursorId);
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _backupCursorId = cursorId;
+    }
+    uassert(7095736, "The backup cursor returned no metadata", !docs.empty());
+    const auto metadata = docs.front()["metadata"].Obj();
+    const auto remoteDbPath = metadata["dbpath"].str();
+    const auto backupId = uassertStatusOK(UUID::parse(metadata["backupId"]));
+    const auto checkpointTimestamp = metadata["checkpointTimestamp"].timestamp();
+    uassert(7095737,
+            "The sync source's backup has no checkpoint timestamp",
+            !checkpointTimestamp.isNull());
+
+    std::vector<BackupFile> files;
+    long long bytesToCopy = 0;
+    for (auto it = std::next(docs.begin()); it != docs.end(); ++it) {
+        BackupFile file;
+        file.remotePath = (*it)["filename"].str();
+        file.relativePath = getRelativePath(file.remotePath, remoteDbPath);
+        file.size = std::max(0LL, (*it)["fileSize"].safeNumberLong());
+        bytesToCopy += file.size;
+        files.push_back(std::move(file));
+    }
+
+    LOGV2(7095738,
+          "Opened backup cursor on the sync source",
+          "backupId"_attr = backupId,
+          "checkpointTimestamp"_attr = checkpointTimestamp,
+          "files"_attr = files.size(),
+          "bytes"_attr = bytesToCopy);
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    _backupId = backupId;
+    _remoteDbPath = remoteDbPath;
+    _checkpointTimestamp = checkpointTimestamp;
+    _stopKeepAlive = false;
+    _filesToCopy = files.size();
+    _bytesToCopy = bytesToCopy;
+    return files;
+}
+
+std::vector<FileCopyBasedInitialSyncer::BackupFile> FileCopyBasedInitialSyncer::_extendBackupCursor(
+    Timestamp extendTo) {
+    auto [client, backupId] = [&] {
+        stdx::lock_guard<Latch> lk(_mutex);
+        return std::make_pair(_client.get(), *_backupId);
+    }();
+
+    const auto cmd = BSON(
+        "aggregate" << 1 << "pipeline"
+                    << BSON_ARRAY(BSON("$backupCursorExtend" << BSON("backupId" << backupId
+                                                                                << "timestamp"
+                                                                                << extendTo)))
+                    << "cursor" << BSONObj() << "maxTimeMS"
+                    << fileBasedInitialSyncExtendCursorTimeoutMS);
+    BSONObj reply;
+    client->runCommand(NamespaceString::kAdminDb.toString(), cmd, reply);
+    uassertStatusOKWithContext(getStatusFromCommandResult(reply),
+                               "Failed to extend the backup cursor on the sync source");
+
+    // The extended cursor lists the sync source's journal files, which are copied whole again.
+    std::vector<BackupFile> files;
+    long long bytesToCopy = 0;
+    CursorId cursorId = 0;
+    const auto docs = _readAllBatches(reply, &cursorId);
+    for (const auto& doc : docs) {
+        BackupFile file;
+        file.remotePath = doc["filename"].str();
+        file.size = std::max(0LL, doc["fileSize"].safeNumberLong());
+        bytesToCopy += file.size;
+        files.push_back(std::move(file));
+    }
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    for (auto& file : files) {
+        file.relativePath = getRelativePath(file.remotePath, _remoteDbPath);
+    }
+    ++_backupCursorExtensions;
+    _filesToCopy += files.size();
+    _bytesToCopy += bytesToCopy;
+    LOGV2(7095739,
+          "Extended the backup cursor on the sync source",
+          "backupId"_attr = backupId,
+          "extendTo"_attr = extendTo,
+          "files"_attr = files.size());
+    return files;
+}
+
+std::vector<BSONObj> FileCopyBasedInitialSyncer::_readAllBatches(const BSONObj& cursorReply,
+                                                                 CursorId* cursorId) {
+    auto client = [&] {
+        stdx::lock_guard<Latch> lk(_mutex);
+        return _client.get();
+    }();
+
+    std::vector<BSONObj> docs;
+    auto response = CursorResponse::parseFromBSONThrowing(cursorReply);
+    for (bool isFirstBatch = true;; isFirstBatch = false) {
+        for (const auto& doc : response.getBatch()) {
+            docs.push_back(doc.getOwned());
+        }
+        *cursorId = response.getCursorId();
+
+        // A backup cursor stays open after returning every file, until it is killed.
+        if (*cursorId == 0 || (!isFirstBatch && response.getBatch().empty())) {
+            return docs;
+        }
+
+        BSONObj reply;
+        client->runCommand(NamespaceString::kAdminDb.toString(),
+                           BSON("getMore" << *cursorId << "collection"
+                                          << "$cmd.aggregate"),
+                           reply);
+        uassertStatusOK(getStatusFromCommandResult(reply));
+        response = CursorResponse::parseFromBSONThrowing(reply);
+    }
+}
+
+void FileCopyBasedInitialSyncer::_closeBackupCursor() {
+    {
+        stdx::lock_guard<Latch> lk(_mutex);
+        _stopKeepAlive = true;
+        _stateCondition.notify_all();
+    }
+    if (_keepAliveThread.joinable()) {
+        _keepAliveThread.join();
+    }
+
+    auto [client, cursorId] = [&] {
+        stdx::lock_guard<Latch> lk(_mutex);
+        return std::make_pair(_client.get(), std::exchange(_backupCursorId, 0));
+    }();
+    if (cursorId == 0 || !client) {
+        return;
+    }
+    try {
+        client->killCursor(
+            NamespaceString::makeCollectionlessAggregateNSS(NamespaceString::kAdminDb), cursorId);
+    } catch (const DBException& e) {
+        // The backup cursor times out on the sync source if it cannot be killed.
+        LOGV2_DEBUG(7095740,
+                    1,
+                    "Failed to kill the backup cursor on the sync source",
+                    "cursorId"_attr = cursorId,
+                    "error"_attr = e.toStatus());
+    }
+}
+
+void FileCopyBasedInitialSyncer::_keepBackupCursorAlive() {
+    std::unique_ptr<DBClientConnection> client;
+    while (true) {
+        CursorId cursorId;
+        {
+            stdx::unique_lock<Latch> lk(_mutex);
+            if (_stateCondition.wait_for(
+                    lk, kBackupCursorKeepAliveInterval.toSystemDuration(), [this] {
+                        return _stopKeepAlive || _state != State::kRunning;
+                    })) {
+                return;
+            }
+            cursorId = _backupCursorId;
+        }
+
+        try {
+            if (!client) {
+                client = _connect();
+            }
+            BSONObj reply;
+            client->runCommand(NamespaceString::kAdminDb.toString(),
+                               BSON("getMore" << cursorId << "collection"
+                                              << "$cmd.aggregate"),
+                               reply);
+        } catch (const DBException& e) {
+            // A failed getMore is retried on the next interval. If the backup cursor does time
+            // out, copying the remaining files fails and the attempt is retried.
+            LOGV2_DEBUG(7095741,
+                        1,
+                        "Failed to keep the backup cursor alive",
+                        "cursorId"_attr = cursorId,
+                        "error"_attr = e.toStatus());
+            client.reset();
+        }
+    }
+}
+
+Timestamp FileCopyBasedInitialSyncer::_getSyncSourceLastApplied() {
+    auto client = [&] {
+        stdx::lock_guard<Latch> lk(_mutex);
+        return _client.get();
+    }();
+
+    FindCommandRequest findCmd{NamespaceString::kRsOplogNamespace};
+    findCmd.setSort(BSON("$natural" << -1));
+    findCmd.setProjection(BSON("ts" << 1));
+    findCmd.setReadConcern(ReadConcernArgs::kLocal);
+    auto lastOplogEntry = client->findOne(
+        std::move(findCmd), ReadPreferenceSetting{ReadPreference::SecondaryPreferred});
+    uassert(ErrorCodes::InitialSyncOplogSourceMissing,
+            "The sync source's oplog is empty",
+            !lastOplogEntry.isEmpty());
+    return lastOplogEntry["ts"].timestamp();
+}
+
+void FileCopyBasedInitialSyncer::_cloneFile(const BackupFile& file) {
+    const auto dir = clonedFilesDir();
+    const auto localPath = (dir / file.relativePath).lexically_normal();
+    uassert(7095742,
+            str::stream() << "Path " << file.relativePath
+                          << " must not escape its parent directory",
+            StringData(localPath.generic_string()).startsWith(dir.generic_string() + "/"));
+
+    boost::filesystem::create_directories(localPath.parent_path());
+    std::ofstream localFile(localPath.string(),
+                            std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+    uassert(ErrorCodes::FileOpenFailed,
+            str::stream() << "Failed to open file " << localPath.string(),
+            !localFile.fail());
+
+    LOGV2_DEBUG(7095743,
+                1,
+                "Copying file from the sync source",
+                "remoteFile"_attr = file.remotePath,
+                "localFile"_attr = localPath.string(),
+                "fileSize"_attr = file.size);
+
+    long long offset = 0;
+    bool sawEof = false;
+    boost::optional<Date_t> retryDeadline;
+    while (!sawEof) {
+        _checkForCancellation();
+        auto [client, backupId] = [&] {
+            stdx::lock_guard<Latch> lk(_mutex);
+            return std::make_pair(_client.get(), *_backupId);
+        }();
+
+        try {
+            auto backupFileStage = BSON(
+                "$_backupFile" << BSON("backupId" << backupId << "file" << file.remotePath
+                                                  << "byteOffset" << offset));
+            AggregateCommandRequest aggRequest(
+                NamespaceString::makeCollectionlessAggregateNSS(NamespaceString::kAdminDb),
+                {backupFileStage});
+            aggRequest.setReadConcern(ReadConcernArgs::kImplicitDefault);
+            aggRequest.setWriteConcern(WriteConcernOptions());
+            auto cursor = uassertStatusOK(DBClientCursor::fromAggregationRequest(
+                client, std::move(aggRequest), true /* secondaryOk */, false /* useExhaust */));
+
+            while (cursor->more()) {
+                auto doc = cursor->nextSafe();
+                uassert(7095744,
+                        str::stream() << "Saw multiple end-of-file markers in file "
+                                      << file.remotePath,
+                        !sawEof);
+                uassert(7095745,
+                        str::stream() << "Expected data at offset " << offset << " of file "
+                                      << file.remotePath << ", got " << doc["byteOffset"],
+                        doc["byteOffset"].safeNumberLong() == offset);
+                const auto& dataElem = doc["data"];
+                uassert(7095746,
+                        str::stream() << "Expected file data to be type BinDataGeneral. " << doc,
+                        dataElem.type() == BinData && dataElem.binDataType() == BinDataGeneral);
+                int dataLength;
+                auto data = dataElem.binData(dataLength);
+                localFile.write(data, dataLength);
+                uassert(ErrorCodes::FileStreamFailed,
+                        str::stream() << "Unable to write file data for file " << file.remotePath
+                                      << " at offset " << offset,
+                        !localFile.fail());
+                offset += dataLength;
+                sawEof = doc["endOfFile"].booleanSafe();
+
+                stdx::lock_guard<Latch> lk(_mutex);
+                _bytesCopied += dataLength;
+            }
+            uassert(7095747,
+                    str::stream() << "Received entire file, but did not get end of file marker. "
+                                  << "File may be incomplete " << file.remotePath,
+                    sawEof);
+        } catch (const DBException& e) {
+            const auto status = e.toStatus();
+            if (!isRetriableError(status)) {
+                throw;
+            }
+
+            const auto now = getGlobalServiceContext()->getFastClockSource()->now();
+            if (!retryDeadline) {
+                retryDeadline = now + Seconds(initialSyncTransientErrorRetryPeriodSeconds.load());
+            }
+            if (now >= *retryDeadline) {
+                throw;
+            }
+            LOGV2(7095748,
+                  "Transient error copying a file from the sync source; resuming from the last "
+                  "byte copied",
+                  "remoteFile"_attr = file.remotePath,
+                  "byteOffset"_attr = offset,
+                  "error"_attr = status);
+
+            // Resume on a new connection. Checking for cancellation while installing it keeps a
+            // concurrent shutdown from being lost.
+            auto newClient = _connect();
+            stdx::lock_guard<Latch> lk(_mutex);
+            if (_state != State::kRunning || _attemptCancelled) {
+                uasserted(ErrorCodes::CallbackCanceled, "Initial sync attempt canceled");
+            }
+            _client = std::move(newClient);
+        }
+    }
+
+    localFile.close();
+    uassert(ErrorCodes::FileStreamFailed,
+            str::stream() << "Unable to write file data for file " << file.remotePath,
+            !localFile.fail());
+    // The copy must be durable before the moving files marker which protects it is removed.
+    uassertStatusOK(fsyncFile(localPath));
+
+    stdx::lock_guard<Latch> lk(_mutex);
+    ++_filesCopied;
+}
+
+boost::optional<LastVote> FileCopyBasedInitialSyncer::lastVoteToRestore(
+    const boost::optional<LastVote>& localLastVote, const LastVote& copiedLastVote) {
+    if (localLastVote && localLastVote->getTerm() > copiedLastVote.getTerm()) {
+        return localLastVote;
+    }
+    return boost::none;
+}
+
+OpTimeAndWallTime FileCopyBasedInitialSyncer::_switchToClonedFiles(
+    OperationContext* opCtx, Timestamp oplogTruncateAfterPoint) {
+    const boost::filesystem::path dbPath(storageGlobalParams.dbpath);
+    const auto dir = clonedFilesDir();
+
+    // The copied files hold the sync source's last vote in place of this node's. Remember this
+    // node's own so that it can be restored once the storage engine uses the copied files.
+    invariant(_opts.loadLastVote && _opts.storeLastVote);
+    boost::optional<LastVote> localLastVote;
+    {
+        auto swLastVote = _opts.loadLastVote(opCtx);
+        if (swLastVote.isOK()) {
+            localLastVote = swLastVote.getValue();
+        } else if (swLastVote.getStatus() != ErrorCodes::NoMatchingDocument) {
+            uassertStatusOKWithContext(swLastVote.getStatus(),
+                                       "Failed to read the last vote of this node");
+        }
+    }
+
+    {
+        Lock::GlobalWrite lk(opCtx);
+        catalog::closeCatalog(opCtx);
+        auto lastShutdownState =
+            reinitializeStorageEngine(opCtx, StorageEngineInitFlags{}, [&] {
+                try {
+                    moveClonedFiles(dbPath, dir);
+                } catch (const DBException& e) {
+                    // The dbpath can be in any state now. Crash recovery starts initial sync over
+                    // from an empty dbpath on restart.
+                    fassertFailedWithStatus(7095749, e.toStatus());
+                }
+            });
+        opCtx->getServiceContext()->getStorageEngine()->notifyStartupComplete();
+        startup_recovery::runStartupRecoveryInMode(
+            opCtx, lastShutdownState, startup_recovery::StartupRecoveryMode::kReplicaSetMember);
+        catalog::openCatalogAfterStorageChange(opCtx);
+    }
+    LOGV2(7095750, "Switched the storage engine to the files copied from the sync source");
+
+    {
+        // Writes made for elections must not be throttled.
+        SetAdmissionPriorityForLock priority(opCtx, AdmissionContext::Priority::kImmediate);
+
+        // The node would be able to vote again in a term it already voted in if it went on with
+        // the sync source's last vote, so failing to restore its own is fatal.
+        auto copiedLastVote = _opts.loadLastVote(opCtx);
+        fassert(7095763, copiedLastVote.getStatus());
+        if (auto lastVote = lastVoteToRestore(localLastVote, copiedLastVote.getValue())) {
+            fassert(7095764, _opts.storeLastVote(opCtx, *lastVote));
+            LOGV2(7095765,
+                  "Restored the last vote of this node over the one copied from the sync source",
+                  "lastVote"_attr = lastVote->toBSON(),
+                  "copiedLastVote"_attr = copiedLastVote.getValue().toBSON());
+        }
+    }
+
+    // The copied journal can hold oplog entries past the point the backup cursor guaranteed, with
+    // holes in front of them. Recovery truncates them before it applies the copied oplog from the
+    // backup's checkpoint timestamp.
+    _replicationProcess->getConsistencyMarkers()->setOplogTruncateAfterPoint(
+        opCtx, oplogTruncateAfterPoint);
+    _replicationProcess->getReplicationRecovery()->recoverFromOplog(opCtx, boost::none);
+
+    DBDirectClient client(opCtx);
+    FindCommandRequest findCmd{NamespaceString::kRsOplogNamespace};
+    findCmd.setSort(BSON("$natural" << -1));
+    auto lastOplogEntry = client.findOne(std::move(findCmd));
+    uassert(ErrorCodes::InitialSyncFailure,
+            "The oplog copied from the sync source is empty",
+            !lastOplogEntry.isEmpty());
+    return uassertStatusOK(OpTimeAndWallTime::parseOpTimeAndWallTimeFromOplogEntry(lastOplogEntry));
+}
+
+void FileCopyBasedInitialSyncer::_checkForCancellation() {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_state == State::kShuttingDown) {
+        uasserted(ErrorCodes::CallbackCanceled, "Initial syncer is shutting down");
+    }
+    if (_attemptCancelled) {
+        uasserted(ErrorCodes::CallbackCanceled, "Initial sync attempt canceled");
+    }
+}
+
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,271 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/filesystem/path.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/client/dbclient_connection.h"
+#include "mongo/db/cursor_id.h"
+#include "mongo/db/repl/data_replicator_external_state.h"
+#include "mongo/db/repl/initial_syncer_interface.h"
+#include "mongo/db/repl/optime.h"
+#include "mongo/db/repl/replication_process.h"
+#include "mongo/db/repl/storage_interface.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/uuid.h"
+
+namespace mongo {
+namespace repl {
+
+/**
+ * Initial sync by copying the sync source's data files, rather than its documents.
+ *
+ * An attempt opens a backup cursor on the sync source with $backupCursor and copies every file it
+ * lists into a temporary directory under the dbpath with $_backupFile. While the copy is more than
+ * 'fileBasedInitialSyncMaxLagSec' behind the sync source, the backup cursor is extended with
+ * $backupCursorExtend and the new journal files are copied, for at most
+ * 'fileBasedInitialSyncMaxCyclesWithoutProgress' rounds.
+ *
+ * The storage engine is then restarted on the copied files. Startup recovery brings them to the
+ * backup's checkpoint timestamp and replication recovery applies the copied oplog from there, so
+ * the node joins the set without cloning any collection or building any index.
+ *
+ * If the sync source cannot open a backup cursor, the initial sync fails with InvalidSyncSource,
+ * and the replication coordinator falls back to logical initial sync.
+ */
+class FileCopyBasedInitialSyncer final : public InitialSyncerInterface {
+    FileCopyBasedInitialSyncer(const FileCopyBasedInitialSyncer&) = delete;
+    FileCopyBasedInitialSyncer& operator=(const FileCopyBasedInitialSyncer&) = delete;
+
+public:
+    static constexpr StringData kInitialSyncMethodName = "fileCopyBased"_sd;
+
+    // The directory under the dbpath which an attempt copies the sync source's files into.
+    static constexpr StringData kClonedFilesDirName = ".initialsync"_sd;
+
+    // Created in the cloned files directory before the cloned files are moved into the dbpath, and
+    // removed with it once initial sync has finished. Its presence at startup means the dbpath
+    // holds files that initial sync had not finished with.
+    static constexpr StringData kMovingFilesMarkerName = "MOVING_FILES"_sd;
+
+    /**
+     * A file listed by the sync source's backup cursor.
+     */
+    struct BackupFile {
+        std::string remotePath;
+
+        // The path relative to the sync source's dbpath, with forward slashes.
+        std::string relativePath;
+
+        long long size = 0;
+    };
+
+    FileCopyBasedInitialSyncer(
+        InitialSyncerInterface::Options opts,
+        std::unique_ptr<DataReplicatorExternalState> dataReplicatorExternalState,
+        StorageInterface* storage,
+        ReplicationProcess* replicationProcess,
+        const OnCompletionFn& onCompletion);
+
+    ~FileCopyBasedInitialSyncer() override;
+
+    Status startup(OperationContext* opCtx, std::uint32_t maxAttempts) noexcept override;
+
+    Status shutdown() override;
+
+    void join() override;
+
+    BSONObj getInitialSyncProgress() const override;
+
+    void cancelCurrentAttempt() override;
+
+    std::string getInitialSyncMethod() const override;
+
+    bool allowLocalDbAccess() const override;
+
+    /**
+     * Overrides how the connections to the sync source are created.
+     *
+     * For testing only.
+     */
+    void setCreateClientFn_forTest(const CreateClientFn& createClientFn);
+
+    /**
+     * Returns 'path' relative to 'basePath', with forward slashes. Throws if 'path' is not inside
+     * 'basePath'.
+     */
+    static std::string getRelativePath(const std::string& path, const std::string& basePath);
+
+    /**
+     * Replaces the data files in 'dbPath' with the files in 'clonedFilesDir', leaving only the
+     * moving files marker in 'clonedFilesDir'. The lock file and diagnostic data are left in place.
+     * No storage engine may be running on 'dbPath'.
+     */
+    static void moveClonedFiles(const boost::filesystem::path& dbPath,
+                                const boost::filesystem::path& clonedFilesDir);
+
+    /**
+     * Run at startup, before the storage engine. Removes the files of an unfinished attempt. If the
+     * process stopped after the data files started to be replaced, also removes the data files so
+     * that initial sync starts over.
+     */
+    static void runCrashRecovery();
+
+    /**
+     * Returns the last vote to persist over 'copiedLastVote', the sync source's last vote copied
+     * with its files, or boost::none to keep the copied one. A node must never vote twice in a
+     * term, so its own last vote is kept if it is from a later term. Either vote prevents voting
+     * again in their common term if the terms are equal.
+     */
+    static boost::optional<LastVote> lastVoteToRestore(
+        const boost::optional<LastVote>& localLastVote, const LastVote& copiedLastVote);
+
+private:
+    enum class State { kPreStart, kRunning, kShuttingDown, kComplete };
+
+    /**
+     * Runs up to 'maxAttempts' attempts and reports the result to '_onCompletion'.
+     */
+    void _run(std::uint32_t maxAttempts);
+
+    /**
+     * Runs a single attempt, returning the last applied optime of the synced node.
+     */
+    OpTimeAndWallTime _runAttempt();
+
+    /**
+     * Returns a connection to '_syncSource', authenticated as the internal user.
+     */
+    std::unique_ptr<DBClientConnection> _connect();
+
+    /**
+     * Opens a backup cursor on the sync source and returns the files it lists.
+     */
+    std::vector<BackupFile> _openBackupCursor();
+
+    /**
+     * Extends the backup cursor to 'extendTo' and returns the journal files it lists.
+     */
+    std::vector<BackupFile> _extendBackupCursor(Timestamp extendTo);
+
+    /**
+     * Reads every batch of the cursor whose first batch is in 'cursorReply', and returns the
+     * cursor's id in 'cursorId', which is still open for a backup cursor.
+     */
+    std::vector<BSONObj> _readAllBatches(const BSONObj& cursorReply, CursorId* cursorId);
+
+    /**
+     * Kills the backup cursor, if one is open, and stops keeping it alive.
+     */
+    void _closeBackupCursor();
+
+    /**
+     * Sends a getMore on the backup cursor periodically, on its own connection, so that it does
+     * not time out while the files are copied.
+     */
+    void _keepBackupCursorAlive();
+
+    /**
+     * Returns the timestamp of the newest entry in the sync source's oplog.
+     */
+    Timestamp _getSyncSourceLastApplied();
+
+    /**
+     * Copies 'file' into the cloned files directory, resuming from the bytes already copied after
+     * a network error.
+     */
+    void _cloneFile(const BackupFile& file);
+
+    /**
+     * Restarts the storage engine on the cloned files, recovers them and returns the last applied
+     * optime of the recovered data. Recovery truncates the copied oplog after
+     * 'oplogTruncateAfterPoint', up to which the sync source guaranteed it has no holes.
+     */
+    OpTimeAndWallTime _switchToClonedFiles(OperationContext* opCtx,
+                                           Timestamp oplogTruncateAfterPoint);
+
+    /**
+     * Throws CallbackCanceled if the syncer is shutting down or the attempt has been cancelled.
+     */
+    void _checkForCancellation();
+
+    // All member variables are labeled with one of the following codes indicating the
+    // synchronization rules for accessing them.
+    //
+    // (R)  Read-only in concurrent operation; no synchronization required.
+    // (M)  Reads and writes guarded by _mutex.
+    // (X)  Access only allowed from the syncer thread.
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("FileCopyBasedInitialSyncer::_mutex");
+    stdx::condition_variable _stateCondition;
+
+    const InitialSyncerInterface::Options _opts;                                // (R)
+    const std::unique_ptr<DataReplicatorExternalState> _dataReplicatorExternalState;  // (R)
+    StorageInterface* const _storage;                                           // (R)
+    ReplicationProcess* const _replicationProcess;                              // (R)
+    OnCompletionFn _onCompletion;                                               // (X)
+    CreateClientFn _createClientFn;                                             // (R)
+
+    State _state = State::kPreStart;  // (M)
+    bool _attemptCancelled = false;   // (M)
+    stdx::thread _thread;             // (M)
+
+    // The connection the attempt uses, kept so that shutdown can interrupt it.
+    std::unique_ptr<DBClientConnection> _client;  // (M)
+
+    HostAndPort _syncSource;  // (M)
+
+    // The open backup cursor on the sync source, if any.
+    boost::optional<UUID> _backupId;  // (M)
+    CursorId _backupCursorId = 0;     // (M)
+    std::string _remoteDbPath;        // (M)
+    Timestamp _checkpointTimestamp;   // (M)
+
+    stdx::thread _keepAliveThread;  // (X)
+    bool _stopKeepAlive = false;    // (M)
+
+    // Progress of the current attempt, for getInitialSyncProgress().
+    Date_t _initialSyncStart;              // (M)
+    std::uint32_t _maxAttempts = 0;        // (M)
+    std::uint32_t _failedAttempts = 0;     // (M)
+    std::vector<BSONObj> _attemptErrors;   // (M)
+    size_t _filesToCopy = 0;               // (M)
+    size_t _filesCopied = 0;               // (M)
+    long long _bytesToCopy = 0;            // (M)
+    long long _bytesCopied = 0;            // (M)
+    size_t _backupCursorExtensions = 0;    // (M)
+};
+
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,196 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+#include "mongo/db/repl/file_copy_based_initial_syncer.h"
+#include "mongo/db/repl/initial_syncer_factory.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+using unittest::TempDir;
+
+void writeFile(const boost::filesystem::path& path, StringData contents) {
+    boost::filesystem::create_directories(path.parent_path());
+    std::ofstream file(path.string());
+    file << contents;
+}
+
+std::string readFile(const boost::filesystem::path& path) {
+    std::ifstream file(path.string());
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+class FileCopyBasedInitialSyncerTest : public unittest::Test {
+public:
+    void setUp() override {
+        _savedDbPath = storageGlobalParams.dbpath;
+        storageGlobalParams.dbpath = _dbPath.path();
+    }
+
+    void tearDown() override {
+        storageGlobalParams.dbpath = _savedDbPath;
+    }
+
+protected:
+    boost::filesystem::path dbPath() const {
+        return _dbPath.path();
+    }
+
+    boost::filesystem::path clonedFilesDir() const {
+        return dbPath() / FileCopyBasedInitialSyncer::kClonedFilesDirName.toString();
+    }
+
+private:
+    TempDir _dbPath{"FileCopyBasedInitialSyncerTest"};
+    std::string _savedDbPath;
+};
+
+TEST(FileCopyBasedInitialSyncerFactoryTest, UnavailableWithoutBackupCursors) {
+    auto service = ServiceContext::make();
+    auto swInitialSyncer = InitialSyncerFactory::get(service.get())
+                               ->makeInitialSyncer(
+                                   FileCopyBasedInitialSyncer::kInitialSyncMethodName.toString(),
+                                   InitialSyncerInterface::Options(),
+                                   nullptr /* dataReplicatorExternalState */,
+                                   nullptr /* writerPool */,
+                                   nullptr /* storage */,
+                                   nullptr /* replicationProcess */,
+                                   [](const StatusWith<OpTimeAndWallTime>&) {});
+    ASSERT_EQ(ErrorCodes::NotImplemented, swInitialSyncer.getStatus());
+}
+
+TEST(FileCopyBasedInitialSyncerRelativePathTest, GetRelativePath) {
+    ASSERT_EQ("collection-1.wt",
+              FileCopyBasedInitialSyncer::getRelativePath("/data/db/collection-1.wt", "/data/db"));
+    ASSERT_EQ("collection-1.wt",
+              FileCopyBasedInitialSyncer::getRelativePath("/data/db/collection-1.wt", "/data/db/"));
+    ASSERT_EQ("journal/WiredTigerLog.0000000001",
+              FileCopyBasedInitialSyncer::getRelativePath(
+                  "/data/db/journal/WiredTigerLog.0000000001", "/data/db"));
+    ASSERT_EQ("test/collection-1.wt",
+              FileCopyBasedInitialSyncer::getRelativePath("C:\\data\\db\\test\\collection-1.wt",
+                                                          "C:\\data\\db"));
+}
+
+TEST(FileCopyBasedInitialSyncerRelativePathTest, GetRelativePathRejectsOtherDirectories) {
+    ASSERT_THROWS_CODE(
+        FileCopyBasedInitialSyncer::getRelativePath("/data/other/collection-1.wt", "/data/db"),
+        DBException,
+        7095725);
+    ASSERT_THROWS_CODE(
+        FileCopyBasedInitialSyncer::getRelativePath("/data/db2/collection-1.wt", "/data/db"),
+        DBException,
+        7095726);
+    ASSERT_THROWS_CODE(FileCopyBasedInitialSyncer::getRelativePath("/data/db", "/data/db"),
+                       DBException,
+                       7095726);
+    ASSERT_THROWS_CODE(FileCopyBasedInitialSyncer::getRelativePath("/data/db/collection-1.wt", ""),
+                       DBException,
+                       7095725);
+}
+
+TEST_F(FileCopyBasedInitialSyncerTest, MoveClonedFilesReplacesDataFiles) {
+    writeFile(dbPath() / "mongod.lock", "1234");
+    writeFile(dbPath() / "diagnostic.data" / "metrics.interim", "metrics");
+    writeFile(dbPath() / "collection-0.wt", "local");
+    writeFile(dbPath() / "journal" / "WiredTigerLog.0000000001", "local");
+    writeFile(clonedFilesDir() / "collection-1.wt", "remote");
+    writeFile(clonedFilesDir() / "journal" / "WiredTigerLog.0000000002", "remote");
+
+    FileCopyBasedInitialSyncer::moveClonedFiles(dbPath(), clonedFilesDir());
+
+    ASSERT_EQ("1234", readFile(dbPath() / "mongod.lock"));
+    ASSERT_EQ("metrics", readFile(dbPath() / "diagnostic.data" / "metrics.interim"));
+    ASSERT_FALSE(boost::filesystem::exists(dbPath() / "collection-0.wt"));
+    ASSERT_FALSE(boost::filesystem::exists(dbPath() / "journal" / "WiredTigerLog.0000000001"));
+    ASSERT_EQ("remote", readFile(dbPath() / "collection-1.wt"));
+    ASSERT_EQ("remote", readFile(dbPath() / "journal" / "WiredTigerLog.0000000002"));
+
+    // Only the marker is left behind, until initial sync finishes with the files.
+    ASSERT_TRUE(boost::filesystem::exists(
+        clonedFilesDir() / FileCopyBasedInitialSyncer::kMovingFilesMarkerName.toString()));
+    ASSERT_FALSE(boost::filesystem::exists(clonedFilesDir() / "collection-1.wt"));
+}
+
+TEST_F(FileCopyBasedInitialSyncerTest, CrashRecoveryRemovesUnfinishedCopy) {
+    writeFile(dbPath() / "collection-0.wt", "local");
+    writeFile(clonedFilesDir() / "collection-1.wt", "remote");
+
+    FileCopyBasedInitialSyncer::runCrashRecovery();
+
+    ASSERT_FALSE(boost::filesystem::exists(clonedFilesDir()));
+    ASSERT_EQ("local", readFile(dbPath() / "collection-0.wt"));
+}
+
+TEST_F(FileCopyBasedInitialSyncerTest, CrashRecoveryAfterMovingFilesStartsOver) {
+    writeFile(dbPath() / "mongod.lock", "1234");
+    writeFile(dbPath() / "collection-0.wt", "local");
+    writeFile(clonedFilesDir() / "collection-1.wt", "remote");
+    FileCopyBasedInitialSyncer::moveClonedFiles(dbPath(), clonedFilesDir());
+
+    FileCopyBasedInitialSyncer::runCrashRecovery();
+
+    ASSERT_FALSE(boost::filesystem::exists(clonedFilesDir()));
+    ASSERT_FALSE(boost::filesystem::exists(dbPath() / "collection-1.wt"));
+    ASSERT_EQ("1234", readFile(dbPath() / "mongod.lock"));
+}
+
+TEST_F(FileCopyBasedInitialSyncerTest, CrashRecoveryWithoutClonedFilesDoesNothing) {
+    writeFile(dbPath() / "collection-0.wt", "local");
+
+    FileCopyBasedInitialSyncer::runCrashRecovery();
+
+    ASSERT_EQ("local", readFile(dbPath() / "collection-0.wt"));
+}
+
+}  // namespace
+TEST(FileCopyBasedInitialSyncerLastVoteTest, KeepsLocalLastVoteFromLaterTerm) {
+    auto lastVote =
+        FileCopyBasedInitialSyncer::lastVoteToRestore(LastVote(5, 1), LastVote(3, 2));
+    ASSERT(lastVote);
+    ASSERT_EQ(lastVote->getTerm(), 5);
+    ASSERT_EQ(lastVote->getCandidateIndex(), 1);
+}
+
+TEST(FileCopyBasedInitialSyncerLastVoteTest, KeepsCopiedLastVoteFromSameOrLaterTerm) {
+    ASSERT_FALSE(FileCopyBasedInitialSyncer::lastVoteToRestore(LastVote(3, 1), LastVote(3, 2)));
+    ASSERT_FALSE(FileCopyBasedInitialSyncer::lastVoteToRestore(LastVote(2, 1), LastVote(3, 2)));
+    ASSERT_FALSE(FileCopyBasedInitialSyncer::lastVoteToRestore(boost::none, LastVote(3, 2)));
+}
+
+}  // namespace repl
+}  // namespace mongo
@@ -67,12 +67,16 @@ StatusWith<std::shared_ptr<InitialSyncerInterface>> InitialSyncerFactory::makeIn
                 str::stream() << "The initial sync method " << initialSyncMethod
                               << " is not available."};
     }
-    return fn->second(opts,
-                      std::move(dataReplicatorExternalState),
-                      writerPool,
-                      storage,
-                      replicationProcess,
-                      onCompletion);
+    try {
+        return fn->second(opts,
+                          std::move(dataReplicatorExternalState),
+                          writerPool,
+                          storage,
+                          replicationProcess,
+                          onCompletion);
+    } catch (const DBException& e) {
+        return e.toStatus();
+    }
 }
 
 void InitialSyncerFactory::runCrashRecovery() {
@@ -76,7 +76,8 @@ public:
 
     /**
      * Make an InitialSyncer if the initialSyncMethod is "logical", or a FileCopyBasedInitialSyncer
-     * if the initialSyncMethod is "fileCopyBased".
+     * if the initialSyncMethod is "fileCopyBased". Returns NotImplemented if the method is not
+     * available, including when its create function throws NotImplemented.
      */
     StatusWith<std::shared_ptr<InitialSyncerInterface>> makeInitialSyncer(
         const std::string& initialSyncMethod,
@@ -34,6 +34,7 @@
 #include "mongo/bson/bsonobj.h"
 #include "mongo/client/dbclient_connection.h"
 #include "mongo/client/fetcher.h"
+#include "mongo/db/repl/last_vote.h"
 #include "mongo/db/repl/member_state.h"
 #include "mongo/db/repl/sync_source_selector.h"
 
@@ -64,6 +65,10 @@ public:
         /** Function to set this node into a specific follower mode. */
         using SetFollowerModeFn = std::function<bool(const MemberState&)>;
 
+        /** Functions to read and persist the last vote of this node. */
+        using LoadLastVoteFn = std::function<StatusWith<LastVote>(OperationContext*)>;
+        using StoreLastVoteFn = std::function<Status(OperationContext*, const LastVote&)>;
+
         // Retry values
         Milliseconds syncSourceRetryWait{1000};
         Milliseconds initialSyncRetryWait{1000};
@@ -77,6 +82,11 @@ public:
         SetMyLastOptimeFn setMyLastOptime;
         ResetOptimesFn resetOptimes;
 
+        // Used by initial sync methods which replace the node's local data, including its last
+        // vote, with the sync source's.
+        LoadLastVoteFn loadLastVote;
+        StoreLastVoteFn storeLastVote;
+
         SyncSourceSelector* syncSourceSelector = nullptr;
 
         // The oplog fetcher will restart the oplog tailing query this many times on
@@ -43,6 +43,8 @@
 #include "mongo/db/db_raii.h"
 #include "mongo/db/repl/apply_ops.h"
 #include "mongo/db/repl/oplog_applier_utils.h"
+#include "mongo/db/repl/oplog_prefetcher.h"
+#include "mongo/db/repl/oplog_writer_scheduler.h"
 #include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/db/repl/transaction_oplog_application.h"
 #include "mongo/db/session/logical_session_id.h"
@@ -297,9 +299,23 @@ OplogApplierImpl::OplogApplierImpl(executor::TaskExecutor* executor,
 void OplogApplierImpl::_run(OplogBuffer* oplogBuffer) {
     // Start up a thread from the batcher to pull from the oplog buffer into the batcher's oplog
     // batch.
+    // While a secondary applies one batch, warm the cache for the next one.
+    std::unique_ptr<OplogPrefetcher> prefetcher;
+    if (getOptions().mode == OplogApplication::Mode::kSecondary &&
+        replOplogPrefetchThreadCount > 0) {
+        prefetcher = std::make_unique<OplogPrefetcher>(replOplogPrefetchThreadCount);
+        _oplogBatcher->setPrefetcher(prefetcher.get());
+    }
+
     _oplogBatcher->startup(_storageInterface);
 
-    ON_BLOCK_EXIT([this] { _oplogBatcher->shutdown(); });
+    ON_BLOCK_EXIT([this, &prefetcher] {
+        _oplogBatcher->shutdown();
+        if (prefetcher) {
+            _oplogBatcher->setPrefetcher(nullptr);
+            prefetcher->shutdown();
+        }
+    });
 
     // We don't start data replication for arbiters at all and it's not allowed to reconfig
     // arbiterOnly field for any member.
@@ -544,10 +560,19 @@ StatusWith<OpTime> OplogApplierImpl::_applyOplogBatch(OperationContext* opCtx,
         //   and create a pseudo oplog.
         std::vector<std::vector<OplogEntry>> derivedOps;
 
+        // Unless disabled, spread the batch over several dependency chains per writer which the
+        // writers then claim dynamically, instead of one fixed vector per writer.
+        const size_t numWriters = _writerPool->getStats().options.maxThreads;
+        const size_t chainsPerWriter = replWriterChainsPerThread.load();
         std::vector<std::vector<const OplogEntry*>> writerVectors(
-            _writerPool->getStats().options.maxThreads);
+            numWriters * std::max<size_t>(chainsPerWriter, 1));
         fillWriterVectors(opCtx, &ops, &writerVectors, &derivedOps);
 
+        boost::optional<OplogWriterScheduler> scheduler;
+        if (chainsPerWriter > 0) {
+            scheduler.emplace(&writerVectors, numWriters);
+        }
+
         // Wait for writes to finish before applying ops.
         _writerPool->waitForIdle();
 
@@ -571,16 +596,18 @@ StatusWith<OpTime> OplogApplierImpl::_applyOplogBatch(OperationContext* opCtx,
 
         {
 
-            std::vector<Status> statusVector(_writerPool->getStats().options.maxThreads,
-                                             Status::OK());
+            std::vector<Status> statusVector(numWriters, Status::OK());
             // Doles out all the work to the writer pool threads. writerVectors is not modified,
             // but  applyOplogBatchPerWorker will modify the vectors that it contains.
-            invariant(writerVectors.size() == statusVector.size());
-            for (size_t i = 0; i < writerVectors.size(); i++) {
-                if (writerVectors[i].empty())
+            invariant(scheduler || writerVectors.size() == statusVector.size());
+            const size_t numTasks =
+                scheduler ? std::min(numWriters, scheduler->numChains()) : numWriters;
+            for (size_t i = 0; i < numTasks; i++) {
+                if (!scheduler && writerVectors[i].empty())
                     continue;
 
                 _writerPool->schedule([this,
+                                       &scheduler,
                                        &writer = writerVectors.at(i),
                                        &status = statusVector.at(i),
                                        &multikeyVector = multikeyVector.at(i),
@@ -598,8 +625,20 @@ StatusWith<OpTime> OplogApplierImpl::_applyOplogBatch(OperationContext* opCtx,
                     opCtx->setEnforceConstraints(false);
 
                     status = opCtx->runWithoutInterruptionExceptAtGlobalShutdown([&] {
-                        return applyOplogBatchPerWorker(
-                            opCtx.get(), &writer, &multikeyVector, isDataConsistent);
+                        if (!scheduler) {
+                            return applyOplogBatchPerWorker(
+                                opCtx.get(), &writer, &multikeyVector, isDataConsistent);
+                        }
+
+                        return scheduler->drain([&](std::vector<const OplogEntry*>* ops) {
+                            WorkerMultikeyPathInfo multikeyPaths;
+                            auto applyStatus = applyOplogBatchPerWorker(
+                                opCtx.get(), ops, &multikeyPaths, isDataConsistent);
+                            std::move(multikeyPaths.begin(),
+                                      multikeyPaths.end(),
+                                      std::back_inserter(multikeyVector));
+                            return applyStatus;
+                        });
                     });
                 });
             }
@@ -70,6 +70,9 @@ OplogBatch OplogBatcher::getNextBatch(Seconds maxWaitTime) {
     OplogBatch ops = std::move(_ops);
     _ops = OplogBatch(0);
     _cv.notify_all();
+    if (_prefetcher && !ops.empty()) {
+        _prefetcher->batchTaken();
+    }
     return ops;
 }
 
@@ -84,6 +87,11 @@ void OplogBatcher::shutdown() {
     }
 }
 
+void OplogBatcher::setPrefetcher(Prefetcher* prefetcher) {
+    invariant(!_thread);
+    _prefetcher = prefetcher;
+}
+
 namespace {
 /**
  * Returns whether an oplog entry represents an implicit commit for a transaction which has not
@@ -377,6 +385,11 @@ void OplogBatcher::_run(StorageInterface* storageInterface) {
             }
         }
 
+        // Let the prefetcher start on this batch while the applier finishes the previous one.
+        if (_prefetcher && !ops.empty()) {
+            _prefetcher->batchReady(ops.getBatch());
+        }
+
         stdx::unique_lock<Latch> lk(_mutex);
         // Block until the previous batch has been taken.
         _cv.wait(lk, [&] { return _ops.empty() && !_ops.termWhenExhausted(); });
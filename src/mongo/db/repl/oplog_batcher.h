@@ -139,6 +139,27 @@ public:
         Timestamp forceBatchBoundaryAfter;
     };
 
+    /**
+     * Receives each batch as soon as the batcher has assembled it, which is usually while the
+     * applier is still applying the previous batch, so that it can warm the cache for the batch's
+     * writes.
+     */
+    class Prefetcher {
+    public:
+        virtual ~Prefetcher() = default;
+
+        /**
+         * Called on the batcher thread with each non-empty batch before it is handed to the
+         * applier. Must not block.
+         */
+        virtual void batchReady(const std::vector<OplogEntry>& batch) = 0;
+
+        /**
+         * Called when the applier takes the batch most recently passed to batchReady().
+         */
+        virtual void batchTaken() = 0;
+    };
+
     /**
      * Constructs an OplogBatcher
      */
@@ -162,6 +183,12 @@ public:
      */
     void shutdown();
 
+    /**
+     * Sets the prefetcher which is shown each batch before the applier takes it. May only be
+     * called while the batcher is not running.
+     */
+    void setPrefetcher(Prefetcher* prefetcher);
+
     /**
      * Returns a new batch of ops to apply.
      * A batch may consist of:
@@ -217,6 +244,8 @@ private:
      */
     OplogBatch _ops;
 
+    Prefetcher* _prefetcher = nullptr;
+
     std::unique_ptr<stdx::thread> _thread;
 };
 
@@ -0,0 +1,269 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/db/repl/oplog_prefetcher.h"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/catalog_raii.h"
+#include "mongo/db/client.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/concurrency/locker.h"
+#include "mongo/db/dbhelpers.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/repl/oplog_applier.h"
+#include "mongo/logv2/log.h"
+#include "mongo/util/scopeguard.h"
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kReplication
+
+namespace mongo {
+namespace repl {
+namespace {
+
+// The number of documents and keys the prefetcher was asked to load.
+CounterMetric prefetchTargets("repl.apply.prefetch.targets");
+
+// Targets loaded before the applier started on their batch.
+CounterMetric prefetchHits("repl.apply.prefetch.hits");
+
+// Targets which the applier got to first, or which could not be loaded.
+CounterMetric prefetchMisses("repl.apply.prefetch.misses");
+
+// Updates and deletes whose target document did not exist when it was looked up.
+CounterMetric prefetchNotFound("repl.apply.prefetch.notFound");
+
+// Batches which were not prefetched because the previous batch's prefetch was still running.
+CounterMetric prefetchBatchesSkipped("repl.apply.prefetch.batchesSkipped");
+
+}  // namespace
+
+std::vector<OplogPrefetcher::Target> OplogPrefetcher::getTargets(
+    const std::vector<OplogEntry>& batch) {
+    std::vector<Target> targets;
+    for (auto&& entry : batch) {
+        const auto opType = entry.getOpType();
+        if (opType != OpTypeEnum::kInsert && opType != OpTypeEnum::kUpdate &&
+            opType != OpTypeEnum::kDelete) {
+            continue;
+        }
+
+        const auto& uuid = entry.getUuid();
+        auto id = entry.getIdElement();
+        if (!uuid || !id) {
+            continue;
+        }
+
+        // The entry's object points into the batch, which the applier frees once it is done with
+        // it, possibly while the prefetch tasks are still running.
+        targets.push_back({entry.getNss().dbName(),
+                           *uuid,
+                           id.wrap(),
+                           opType == OpTypeEnum::kInsert ? entry.getObject().getOwned()
+                                                         : BSONObj()});
+    }
+
+    // Group the targets by collection, so that each collection is only locked once per thread.
+    std::stable_sort(targets.begin(), targets.end(), [](const Target& lhs, const Target& rhs) {
+        return lhs.uuid < rhs.uuid;
+    });
+    return targets;
+}
+
+OplogPrefetcher::OplogPrefetcher(int numThreads)
+    : _numThreads(numThreads), _pool(makeReplWriterPool(numThreads, "ReplOplogPrefetcher"_sd)) {
+    LOGV2(7095719, "Started oplog prefetcher", "numThreads"_attr = numThreads);
+}
+
+OplogPrefetcher::~OplogPrefetcher() {
+    shutdown();
+}
+
+void OplogPrefetcher::shutdown() {
+    if (!_pool) {
+        return;
+    }
+
+    // Outstanding prefetches end at the next target once they see their batch has been taken.
+    _batchesTaken.store(std::numeric_limits<uint64_t>::max());
+    _pool->shutdown();
+    _pool->join();
+    _pool.reset();
+}
+
+void OplogPrefetcher::batchReady(const std::vector<OplogEntry>& batch) {
+    const auto batchNumber = ++_batchesReady;
+    if (!_pool) {
+        return;
+    }
+
+    // The prefetcher is falling behind the applier, so warming this batch would mostly compete
+    // with the writers for the same pages.
+    if (_tasksInProgress.load() > 0) {
+        prefetchBatchesSkipped.increment();
+        return;
+    }
+
+    auto targets = std::make_shared<std::vector<Target>>(getTargets(batch));
+    if (targets->empty()) {
+        return;
+    }
+    prefetchTargets.increment(targets->size());
+
+    const size_t numTasks = std::min<size_t>(_numThreads, targets->size());
+    const size_t targetsPerTask = (targets->size() + numTasks - 1) / numTasks;
+    _tasksInProgress.addAndFetch(numTasks);
+    for (size_t i = 0; i < numTasks; ++i) {
+        const size_t begin = std::min(i * targetsPerTask, targets->size());
+        const size_t end = std::min(begin + targetsPerTask, targets->size());
+        _pool->schedule([this, targets, batchNumber, begin, end](Status status) {
+            ON_BLOCK_EXIT([&] { _tasksInProgress.subtractAndFetch(1); });
+            if (!status.isOK()) {
+                prefetchMisses.increment(end - begin);
+                return;
+            }
+
+            auto opCtx = cc().makeOperationContext();
+            _prefetch(
+                opCtx.get(), batchNumber, targets->cbegin() + begin, targets->cbegin() + end);
+        });
+    }
+}
+
+void OplogPrefetcher::batchTaken() {
+    _batchesTaken.fetchAndAdd(1);
+}
+
+void OplogPrefetcher::_prefetch(OperationContext* opCtx,
+                                uint64_t batchNumber,
+                                std::vector<Target>::const_iterator begin,
+                                std::vector<Target>::const_iterator end) {
+    // Read alongside batch application, like secondary reads do. Prefetching only needs the pages
+    // to be loaded, not a consistent view of the data.
+    ShouldNotConflictWithSecondaryBatchApplicationBlock noConflict(opCtx->lockState());
+    opCtx->recoveryUnit()->setPrepareConflictBehavior(PrepareConflictBehavior::kIgnoreConflicts);
+
+    boost::optional<AutoGetCollection> autoColl;
+    for (auto it = begin; it != end; ++it) {
+        if (_batchesTaken.load() >= batchNumber) {
+            prefetchMisses.increment(std::distance(it, end));
+            return;
+        }
+
+        try {
+            if (!autoColl || std::prev(it)->uuid != it->uuid) {
+                autoColl.reset();
+                opCtx->recoveryUnit()->abandonSnapshot();
+                autoColl.emplace(opCtx, NamespaceStringOrUUID(it->dbName, it->uuid), MODE_IS);
+            }
+
+            switch (_prefetchTarget(opCtx, autoColl->getCollection(), *it)) {
+                case PrefetchResult::kLoaded:
+                    prefetchHits.increment();
+                    break;
+                case PrefetchResult::kNotFound:
+                    prefetchNotFound.increment();
+                    break;
+                case PrefetchResult::kNotLoaded:
+                    prefetchMisses.increment();
+                    break;
+            }
+        } catch (const DBException& ex) {
+            // The collection may have been dropped or renamed by an earlier batch. Whatever the
+            // reason, the applier will report real problems when it gets to the entry.
+            LOGV2_DEBUG(7095720,
+                        2,
+                        "Failed to prefetch oplog entry target",
+                        "uuid"_attr = it->uuid,
+                        "error"_attr = ex.toStatus());
+            autoColl.reset();
+            prefetchMisses.increment();
+        }
+    }
+}
+
+OplogPrefetcher::PrefetchResult OplogPrefetcher::_prefetchTarget(
+    OperationContext* opCtx, const CollectionPtr& collection, const Target& target) {
+    if (!collection) {
+        return PrefetchResult::kNotLoaded;
+    }
+
+    // Reads the _id index, or for clustered collections the record store, down to the leaf page
+    // holding the document.
+    bool found = false;
+    if (auto rid = Helpers::findById(opCtx, collection, target.idQuery); !rid.isNull()) {
+        RecordData data;
+        found = collection->getRecordStore()->findRecord(opCtx, rid, &data);
+    }
+
+    if (target.insertedDoc.isEmpty()) {
+        // The pages on the path to where the document would be were still loaded, but there is
+        // nothing for the applier to find, so this is neither a hit nor a miss.
+        return found ? PrefetchResult::kLoaded : PrefetchResult::kNotFound;
+    }
+
+    // An insert is expected not to find its _id, but it still has to check each unique index for
+    // a duplicate of its keys.
+    SharedBufferFragmentBuilder pooledBuilder(KeyString::HeapBuilder::kHeapAllocatorDefaultBytes);
+    auto it = collection->getIndexCatalog()->getIndexIterator(
+        opCtx, IndexCatalog::InclusionPolicy::kReady);
+    while (it->more()) {
+        const auto entry = it->next();
+        const auto descriptor = entry->descriptor();
+        const auto accessMethod = entry->accessMethod()->asSortedData();
+        if (!descriptor->unique() || descriptor->isIdIndex() || !accessMethod) {
+            continue;
+        }
+
+        KeyStringSet keys;
+        accessMethod->getKeys(
+            opCtx,
+            collection,
+            pooledBuilder,
+            target.insertedDoc,
+            InsertDeleteOptions::ConstraintEnforcementMode::kRelaxConstraintsUnfiltered,
+            SortedDataIndexAccessMethod::GetKeysContext::kAddingKeys,
+            &keys,
+            nullptr,       // multikeyMetadataKeys
+            nullptr,       // multikeyPaths
+            boost::none);  // loc
+
+        auto cursor = accessMethod->newCursor(opCtx);
+        for (auto&& key : keys) {
+            cursor->seekForKeyString(key);
+        }
+    }
+    return PrefetchResult::kLoaded;
+}
+
+}  // namespace repl
+}  // namespace mongo
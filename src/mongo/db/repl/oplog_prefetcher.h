@@ -0,0 +1,138 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/db/repl/oplog_batcher.h"
+#include "mongo/db/repl/oplog_entry.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/uuid.h"
+
+namespace mongo {
+
+class CollectionPtr;
+class OperationContext;
+
+namespace repl {
+
+/**
+ * Warms the storage engine cache for the next oplog batch while the applier is still applying the
+ * current one, so that the writer threads mostly find the documents and index entries they touch
+ * already in memory.
+ *
+ * For every insert, update and delete in the batch, the prefetcher looks up the target _id, which
+ * reads the pages of the _id index and of the record itself. For inserts it also seeks to the keys
+ * the new document will have in each unique secondary index, since inserting them has to check for
+ * duplicates. The work is split across a pool of threads which read without conflicting with batch
+ * application. Prefetching of a batch stops as soon as the applier takes it.
+ *
+ * Progress is reported in serverStatus under metrics.repl.apply.prefetch. The hit rate is
+ * 'hits' / ('hits' + 'misses'): the fraction of targets which were loaded before the applier
+ * started on their batch. Updates and deletes of documents which do not exist are counted as
+ * 'notFound' instead.
+ */
+class OplogPrefetcher : public OplogBatcher::Prefetcher {
+public:
+    /**
+     * A document which an entry in a batch will read or write.
+     */
+    struct Target {
+        DatabaseName dbName;
+        UUID uuid;
+
+        // A query of the form {_id: <value>}.
+        BSONObj idQuery;
+
+        // The document being inserted, if the entry is an insert. Owned, since the prefetch may
+        // outlive the batch.
+        BSONObj insertedDoc;
+    };
+
+    /**
+     * Returns the prefetch targets for the entries in 'batch', grouped by collection.
+     */
+    static std::vector<Target> getTargets(const std::vector<OplogEntry>& batch);
+
+    explicit OplogPrefetcher(int numThreads);
+
+    ~OplogPrefetcher();
+
+    /**
+     * Waits for outstanding prefetches to stop and shuts down the thread pool.
+     */
+    void shutdown();
+
+    void batchReady(const std::vector<OplogEntry>& batch) override;
+
+    void batchTaken() override;
+
+private:
+    enum class PrefetchResult {
+        // The pages the applier needs for the target were loaded.
+        kLoaded,
+        // An update or delete whose document does not exist.
+        kNotFound,
+        // The target could not be loaded, e.g. because its collection does not exist.
+        kNotLoaded,
+    };
+
+    /**
+     * Loads the targets in [begin, end) until the applier takes batch 'batchNumber'.
+     */
+    void _prefetch(OperationContext* opCtx,
+                   uint64_t batchNumber,
+                   std::vector<Target>::const_iterator begin,
+                   std::vector<Target>::const_iterator end);
+
+    /**
+     * Loads a single target from 'collection'.
+     */
+    PrefetchResult _prefetchTarget(OperationContext* opCtx,
+                                   const CollectionPtr& collection,
+                                   const Target& target);
+
+    const int _numThreads;
+    std::unique_ptr<ThreadPool> _pool;
+
+    // The number of batches passed to batchReady(). Only accessed on the batcher thread.
+    uint64_t _batchesReady = 0;
+
+    // The number of batches taken by the applier.
+    AtomicWord<uint64_t> _batchesTaken{0};
+
+    // The number of prefetch tasks scheduled and not yet finished.
+    AtomicWord<int> _tasksInProgress{0};
+};
+
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,137 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/db/repl/oplog_prefetcher.h"
+
+#include "mongo/db/repl/oplog_entry_test_helpers.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+const NamespaceString kNss("test.coll");
+
+OplogEntry makeCrudEntry(int t,
+                         OpTypeEnum opType,
+                         const BSONObj& o,
+                         boost::optional<BSONObj> o2,
+                         boost::optional<UUID> uuid) {
+    return makeOplogEntry(OpTime(Timestamp(t, 1), 1),  // optime
+                          opType,                      // op type
+                          kNss,                        // namespace
+                          o,                           // o
+                          o2,                          // o2
+                          {},                          // session info
+                          Date_t::now(),               // wall clock time
+                          {},                          // statement ids
+                          uuid);                       // uuid
+}
+
+TEST(OplogPrefetcherTest, TargetsInsertsUpdatesAndDeletes) {
+    auto uuid = UUID::gen();
+    std::vector<OplogEntry> batch{
+        makeCrudEntry(1, OpTypeEnum::kInsert, BSON("_id" << 1 << "x" << 1), boost::none, uuid),
+        makeCrudEntry(
+            2, OpTypeEnum::kUpdate, BSON("$set" << BSON("x" << 2)), BSON("_id" << 2), uuid),
+        makeCrudEntry(3, OpTypeEnum::kDelete, BSON("_id" << 3), boost::none, uuid),
+        makeCommandOplogEntry(OpTime(Timestamp(4, 1), 1), kNss, BSON("drop" << kNss.coll()), uuid),
+        makeCrudEntry(5, OpTypeEnum::kNoop, BSON("noop" << 1), boost::none, uuid),
+    };
+
+    auto targets = OplogPrefetcher::getTargets(batch);
+    ASSERT_EQ(targets.size(), 3U);
+
+    ASSERT_EQ(targets[0].uuid, uuid);
+    ASSERT_EQ(targets[0].dbName, kNss.dbName());
+    ASSERT_BSONOBJ_EQ(targets[0].idQuery, BSON("_id" << 1));
+    ASSERT_BSONOBJ_EQ(targets[0].insertedDoc, BSON("_id" << 1 << "x" << 1));
+
+    // Updates are looked up by the _id in 'o2', and only inserts carry the new document.
+    ASSERT_BSONOBJ_EQ(targets[1].idQuery, BSON("_id" << 2));
+    ASSERT(targets[1].insertedDoc.isEmpty());
+
+    ASSERT_BSONOBJ_EQ(targets[2].idQuery, BSON("_id" << 3));
+    ASSERT(targets[2].insertedDoc.isEmpty());
+}
+
+TEST(OplogPrefetcherTest, TargetsOutliveTheBatch) {
+    auto uuid = UUID::gen();
+    std::vector<OplogEntry> batch{
+        makeCrudEntry(1, OpTypeEnum::kInsert, BSON("_id" << 1 << "x" << 1), boost::none, uuid),
+        makeCrudEntry(2, OpTypeEnum::kDelete, BSON("_id" << 2), boost::none, uuid),
+    };
+
+    auto targets = OplogPrefetcher::getTargets(batch);
+    batch.clear();
+
+    ASSERT_EQ(targets.size(), 2U);
+    ASSERT(targets[0].idQuery.isOwned());
+    ASSERT(targets[0].insertedDoc.isOwned());
+    ASSERT_BSONOBJ_EQ(targets[0].insertedDoc, BSON("_id" << 1 << "x" << 1));
+    ASSERT(targets[1].idQuery.isOwned());
+    ASSERT_BSONOBJ_EQ(targets[1].idQuery, BSON("_id" << 2));
+}
+
+TEST(OplogPrefetcherTest, SkipsEntriesWithoutUuid) {
+    std::vector<OplogEntry> batch{
+        makeCrudEntry(1, OpTypeEnum::kInsert, BSON("_id" << 1), boost::none, boost::none),
+    };
+    ASSERT(OplogPrefetcher::getTargets(batch).empty());
+}
+
+TEST(OplogPrefetcherTest, GroupsTargetsByCollectionPreservingOrder) {
+    auto uuid1 = UUID::gen();
+    auto uuid2 = UUID::gen();
+    std::vector<OplogEntry> batch;
+    for (int i = 0; i < 6; ++i) {
+        batch.push_back(makeCrudEntry(
+            i + 1, OpTypeEnum::kDelete, BSON("_id" << i), boost::none, i % 2 ? uuid2 : uuid1));
+    }
+
+    auto targets = OplogPrefetcher::getTargets(batch);
+    ASSERT_EQ(targets.size(), 6U);
+
+    // Each collection's targets are contiguous and keep their relative order from the batch.
+    for (size_t i = 1; i < targets.size(); ++i) {
+        if (targets[i].uuid == targets[i - 1].uuid) {
+            ASSERT_LT(targets[i - 1].idQuery["_id"].numberInt(),
+                      targets[i].idQuery["_id"].numberInt());
+        }
+    }
+    size_t switches = 0;
+    for (size_t i = 1; i < targets.size(); ++i) {
+        switches += targets[i].uuid != targets[i - 1].uuid;
+    }
+    ASSERT_EQ(switches, 1U);
+}
+
+}  // namespace
+}  // namespace repl
+}  // namespace mongo
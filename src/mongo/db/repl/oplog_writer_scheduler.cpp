@@ -0,0 +1,88 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/db/repl/oplog_writer_scheduler.h"
+
+#include <algorithm>
+
+namespace mongo {
+namespace repl {
+
+OplogWriterScheduler::OplogWriterScheduler(std::vector<std::vector<const OplogEntry*>>* chains,
+                                           std::size_t numWriters)
+    : _chains(chains) {
+    std::size_t numOps = 0;
+    for (std::size_t i = 0; i < _chains->size(); ++i) {
+        const auto size = (*_chains)[i].size();
+        if (size > 0) {
+            _order.push_back(i);
+            numOps += size;
+        }
+    }
+
+    // Stable, so that equally long chains are claimed in a deterministic order.
+    std::stable_sort(_order.begin(), _order.end(), [&](std::size_t lhs, std::size_t rhs) {
+        return (*_chains)[lhs].size() > (*_chains)[rhs].size();
+    });
+
+    _minOpsPerClaim = std::max<std::size_t>(
+        1, numOps / (std::max<std::size_t>(numWriters, 1) * kClaimsPerWriter));
+}
+
+bool OplogWriterScheduler::claim(std::vector<const OplogEntry*>* ops) {
+    bool claimedAny = false;
+    std::size_t numClaimed = 0;
+    while (numClaimed < _minOpsPerClaim) {
+        const auto next = _next.fetchAndAdd(1);
+        if (next >= _order.size()) {
+            break;
+        }
+
+        const auto& chain = (*_chains)[_order[next]];
+        ops->insert(ops->end(), chain.begin(), chain.end());
+        numClaimed += chain.size();
+        claimedAny = true;
+    }
+    return claimedAny;
+}
+
+Status OplogWriterScheduler::drain(const ApplyFn& applyFn) {
+    std::vector<const OplogEntry*> ops;
+    while (claim(&ops)) {
+        auto status = applyFn(&ops);
+        if (!status.isOK()) {
+            return status;
+        }
+        ops.clear();
+    }
+    return Status::OK();
+}
+
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,106 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "mongo/base/status.h"
+#include "mongo/db/repl/oplog_entry.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+namespace repl {
+
+/**
+ * Dispatches the dependency chains of an oplog application batch to the writer threads.
+ *
+ * OplogApplierUtils::addToWriterVector places each entry in the vector selected by its conflict
+ * hash, so entries on the same document, entries on the same capped collection and the entries of
+ * a serially applied transaction always share a vector and keep their oplog order. When the batch
+ * is spread over many more vectors than there are writer threads, each vector is one chain of the
+ * batch's dependency graph and distinct chains may be applied in any order.
+ *
+ * Instead of binding every chain to a fixed writer, each writer repeatedly claims the next chain
+ * from a shared cursor, largest chains first, until none remain. A long chain for a hot document
+ * then occupies a single writer while the others drain the rest of the batch, rather than every
+ * document that happens to hash to the same writer waiting behind it.
+ */
+class OplogWriterScheduler {
+public:
+    using ApplyFn = std::function<Status(std::vector<const OplogEntry*>*)>;
+
+    /**
+     * The number of times each writer is expected to claim work in a batch. Claims are sized so
+     * that the batch is handed out in about this many rounds, which keeps consecutive inserts
+     * together for grouping without giving up on balancing the tail of the batch.
+     */
+    static constexpr std::size_t kClaimsPerWriter = 8;
+
+    /**
+     * 'chains' must outlive the scheduler and may not be modified while it is in use, other than by
+     * the callbacks passed to drain().
+     */
+    OplogWriterScheduler(std::vector<std::vector<const OplogEntry*>>* chains,
+                         std::size_t numWriters);
+
+    /**
+     * Returns the number of non-empty chains in the batch.
+     */
+    std::size_t numChains() const {
+        return _order.size();
+    }
+
+    /**
+     * Claims whole chains until at least the minimum claim size has been collected or no chains
+     * remain, appending their entries to 'ops'. Returns false if there was nothing left to claim.
+     * Safe to call concurrently.
+     */
+    bool claim(std::vector<const OplogEntry*>* ops);
+
+    /**
+     * Repeatedly claims work and passes it to 'applyFn' on the calling thread, until every chain
+     * has been claimed or 'applyFn' returns an error, which is then returned.
+     */
+    Status drain(const ApplyFn& applyFn);
+
+private:
+    std::vector<std::vector<const OplogEntry*>>* const _chains;
+
+    // Indexes into '_chains' of the non-empty chains, longest first.
+    std::vector<std::size_t> _order;
+
+    std::size_t _minOpsPerClaim = 1;
+
+    AtomicWord<std::size_t> _next{0};
+};
+
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,140 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/repl/oplog_entry_test_helpers.h"
+#include "mongo/db/repl/oplog_writer_scheduler.h"
+#include "mongo/platform/random.h"
+#include "mongo/util/concurrency/thread_pool.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+// Matches the defaults for replWriterThreadCount and replBatchLimitOperations.
+constexpr std::size_t kNumWriters = 16;
+constexpr std::size_t kBatchSize = 5000;
+
+constexpr int kNumDocuments = 100 * 1000;
+
+// Busy work standing in for applying a single entry.
+constexpr int kSpinsPerOp = 2000;
+
+/**
+ * Measures how long it takes the writer pool to apply one batch, which bounds how far a secondary
+ * falls behind while it applies it. The first argument is the number of dependency chains per
+ * writer, where 0 is the fixed assignment of entries to writers by hash. The second is the
+ * percentage of the batch updating a single hot document.
+ */
+class OplogApplicationBenchmark : public benchmark::Fixture {
+public:
+    void SetUp(benchmark::State& state) override {
+        const std::size_t chainsPerWriter = state.range(0);
+        const int hotPercent = state.range(1);
+
+        PseudoRandom random(1);
+        _entries.reserve(kBatchSize);
+        for (std::size_t i = 0; i < kBatchSize; ++i) {
+            const int id = random.nextInt32(100) < hotPercent ? 0 : random.nextInt32(kNumDocuments);
+            _entries.push_back(makeInsertDocumentOplogEntry(
+                OpTime(Timestamp(i + 1, 1), 1), _nss, BSON("_id" << id)));
+        }
+
+        _writerVectors.resize(kNumWriters * std::max<std::size_t>(chainsPerWriter, 1));
+        for (auto&& entry : _entries) {
+            // Knuth's multiplicative hash, standing in for the hash of namespace and _id.
+            auto hash = static_cast<uint32_t>(entry.getIdElement().numberInt()) * 2654435761U;
+            _writerVectors[hash % _writerVectors.size()].push_back(&entry);
+        }
+
+        ThreadPool::Options options;
+        options.minThreads = kNumWriters;
+        options.maxThreads = kNumWriters;
+        _pool = std::make_unique<ThreadPool>(options);
+        _pool->startup();
+    }
+
+    void TearDown(benchmark::State& state) override {
+        _pool->shutdown();
+        _pool->join();
+        _pool.reset();
+        _writerVectors.clear();
+        _entries.clear();
+    }
+
+    static Status apply(std::vector<const OplogEntry*>* ops) {
+        for (auto&& op : *ops) {
+            for (int i = 0; i < kSpinsPerOp; ++i) {
+                benchmark::DoNotOptimize(op);
+            }
+        }
+        return Status::OK();
+    }
+
+    void applyBatch(std::size_t chainsPerWriter) {
+        if (chainsPerWriter == 0) {
+            for (auto&& writer : _writerVectors) {
+                if (!writer.empty()) {
+                    _pool->schedule([&](auto status) { invariant(apply(&writer)); });
+                }
+            }
+            _pool->waitForIdle();
+            return;
+        }
+
+        OplogWriterScheduler scheduler(&_writerVectors, kNumWriters);
+        for (std::size_t i = 0; i < std::min(kNumWriters, scheduler.numChains()); ++i) {
+            _pool->schedule([&](auto status) { invariant(scheduler.drain(&apply)); });
+        }
+        _pool->waitForIdle();
+    }
+
+protected:
+    const NamespaceString _nss{"bench.coll"};
+    std::vector<OplogEntry> _entries;
+    std::vector<std::vector<const OplogEntry*>> _writerVectors;
+    std::unique_ptr<ThreadPool> _pool;
+};
+
+BENCHMARK_DEFINE_F(OplogApplicationBenchmark, BM_ApplyBatch)(benchmark::State& state) {
+    for (auto _ : state) {
+        applyBatch(state.range(0));
+    }
+    state.SetItemsProcessed(state.iterations() * kBatchSize);
+}
+
+BENCHMARK_REGISTER_F(OplogApplicationBenchmark, BM_ApplyBatch)
+    ->ArgsProduct({{0, 64}, {0, 10, 50}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,165 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/db/repl/oplog_writer_scheduler.h"
+
+#include <map>
+
+#include "mongo/db/repl/oplog_entry_test_helpers.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+class OplogWriterSchedulerTest : public unittest::Test {
+protected:
+    /**
+     * Creates 'numOps' insert entries and places them into chains of the given lengths, in order.
+     */
+    std::vector<std::vector<const OplogEntry*>> makeChains(std::vector<std::size_t> lengths) {
+        std::vector<std::vector<const OplogEntry*>> chains(lengths.size());
+        for (std::size_t i = 0; i < lengths.size(); ++i) {
+            for (std::size_t j = 0; j < lengths[i]; ++j) {
+                auto t = static_cast<int>(_entries.size()) + 1;
+                _entries.push_back(std::make_unique<OplogEntry>(makeInsertDocumentOplogEntry(
+                    OpTime(Timestamp(t, 1), 1), _nss, BSON("_id" << t << "chain" << (int)i))));
+                chains[i].push_back(_entries.back().get());
+            }
+        }
+        return chains;
+    }
+
+    const NamespaceString _nss{"test.coll"};
+    std::vector<std::unique_ptr<OplogEntry>> _entries;
+};
+
+TEST_F(OplogWriterSchedulerTest, ClaimsLongestChainsFirst) {
+    auto chains = makeChains({1, 0, 3, 2});
+    OplogWriterScheduler scheduler(&chains, 16);
+    ASSERT_EQ(scheduler.numChains(), 3U);
+
+    // With so few operations every claim is a single chain.
+    std::vector<const OplogEntry*> ops;
+    ASSERT_TRUE(scheduler.claim(&ops));
+    ASSERT(ops == chains[2]);
+
+    ops.clear();
+    ASSERT_TRUE(scheduler.claim(&ops));
+    ASSERT(ops == chains[3]);
+
+    ops.clear();
+    ASSERT_TRUE(scheduler.claim(&ops));
+    ASSERT(ops == chains[0]);
+
+    ops.clear();
+    ASSERT_FALSE(scheduler.claim(&ops));
+    ASSERT(ops.empty());
+}
+
+TEST_F(OplogWriterSchedulerTest, ClaimsWholeChainsUpToMinimumSize) {
+    // 64 chains of 4 entries over one writer gives a minimum claim of 256 / 8 = 32 entries.
+    auto chains = makeChains(std::vector<std::size_t>(64, 4));
+    OplogWriterScheduler scheduler(&chains, 1);
+
+    std::vector<const OplogEntry*> ops;
+    ASSERT_TRUE(scheduler.claim(&ops));
+    ASSERT_EQ(ops.size(), 32U);
+    for (std::size_t i = 0; i < 8; ++i) {
+        ASSERT(std::equal(chains[i].begin(), chains[i].end(), ops.begin() + 4 * i));
+    }
+}
+
+TEST_F(OplogWriterSchedulerTest, ConcurrentDrainAppliesEveryChainOnceInOrder) {
+    std::vector<std::size_t> lengths;
+    for (std::size_t i = 0; i < 200; ++i) {
+        lengths.push_back(i % 7 == 0 ? 50 : i % 5);
+    }
+    auto chains = makeChains(lengths);
+    OplogWriterScheduler scheduler(&chains, 4);
+
+    std::vector<std::vector<const OplogEntry*>> applied(4);
+    std::vector<Status> statuses(applied.size(), Status::OK());
+    std::vector<stdx::thread> writers;
+    for (std::size_t i = 0; i < applied.size(); ++i) {
+        writers.emplace_back([&, i] {
+            statuses[i] = scheduler.drain([&](std::vector<const OplogEntry*>* ops) {
+                applied[i].insert(applied[i].end(), ops->begin(), ops->end());
+                return Status::OK();
+            });
+        });
+    }
+    for (auto&& writer : writers) {
+        writer.join();
+    }
+    for (auto&& status : statuses) {
+        ASSERT_OK(status);
+    }
+
+    // Every entry is applied exactly once, and the entries of each chain by the same writer in
+    // their original order.
+    std::map<const OplogEntry*, std::pair<std::size_t, std::size_t>> appliedAt;
+    for (std::size_t i = 0; i < applied.size(); ++i) {
+        for (std::size_t j = 0; j < applied[i].size(); ++j) {
+            ASSERT(appliedAt.emplace(applied[i][j], std::make_pair(i, j)).second);
+        }
+    }
+    ASSERT_EQ(appliedAt.size(), _entries.size());
+    for (auto&& chain : chains) {
+        for (std::size_t j = 1; j < chain.size(); ++j) {
+            auto prev = appliedAt[chain[j - 1]];
+            auto cur = appliedAt[chain[j]];
+            ASSERT_EQ(prev.first, cur.first);
+            ASSERT_LT(prev.second, cur.second);
+        }
+    }
+}
+
+TEST_F(OplogWriterSchedulerTest, DrainStopsAtFirstError) {
+    auto chains = makeChains({2, 2, 2});
+    OplogWriterScheduler scheduler(&chains, 16);
+
+    int calls = 0;
+    auto status = scheduler.drain([&](std::vector<const OplogEntry*>* ops) {
+        ++calls;
+        return Status(ErrorCodes::InternalError, "apply failed");
+    });
+    ASSERT_EQ(status, ErrorCodes::InternalError);
+    ASSERT_EQ(calls, 1);
+
+    // The chains which weren't handed out can still be claimed.
+    std::vector<const OplogEntry*> ops;
+    ASSERT_TRUE(scheduler.claim(&ops));
+    ASSERT_EQ(ops.size(), 2U);
+}
+
+}  // namespace
+}  // namespace repl
+}  // namespace mongo
@@ -34,7 +34,12 @@
 
 #include "mongo/db/repl/replication_recovery.h"
 
+#include <deque>
+
+#include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/catalog/document_validation.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/concurrency/lock_state.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/index_builds_coordinator.h"
@@ -57,6 +62,9 @@
 #include "mongo/db/transaction/transaction_history_iterator.h"
 #include "mongo/db/transaction/transaction_participant.h"
 #include "mongo/logv2/log.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/timer.h"
 
@@ -74,6 +82,13 @@ namespace {
 const auto kRecoveryBatchLogLevel = logv2::LogSeverity::Debug(2);
 const auto kRecoveryOperationLogLevel = logv2::LogSeverity::Debug(3);
 
+// Cumulative counters for oplog application performed by replication recovery, reported in
+// serverStatus under 'metrics.repl.recovery'.
+CounterMetric recoveryBatchesApplied("repl.recovery.batches");
+CounterMetric recoveryOpsApplied("repl.recovery.ops");
+CounterMetric recoveryApplyMillis("repl.recovery.totalMillis");
+CounterMetric recoveryReadWaitMillis("repl.recovery.readWaitMillis");
+
 /**
  * Tracks and logs operations applied during recovery.
  */
@@ -94,6 +109,8 @@ public:
                            "numOpsApplied"_attr = _numOpsApplied);
 
         _numOpsApplied += batch.size();
+        recoveryBatchesApplied.increment();
+        recoveryOpsApplied.increment(batch.size());
         if (shouldLog(::mongo::logv2::LogComponent::kStorageRecovery, kRecoveryOperationLogLevel)) {
             std::size_t i = 0;
             for (const auto& entry : batch) {
@@ -114,17 +131,33 @@ public:
 
     void onBatchEnd(const StatusWith<OpTime>&, const std::vector<OplogEntry>&) final {}
 
+    /**
+     * Records time the applier spent blocked waiting for the next batch to be read from the oplog.
+     */
+    void recordReadWait(Milliseconds waited) {
+        _readWait += waited;
+        recoveryReadWaitMillis.increment(durationCount<Milliseconds>(waited));
+    }
+
     void complete(const OpTime& applyThroughOpTime) const {
+        const long long durationMillis = _timer.millis();
+        recoveryApplyMillis.increment(durationMillis);
         LOGV2(21536,
               "Applied {numOpsApplied} operations in {numBatches} batches. Last operation applied "
               "with optime: {applyThroughOpTime}",
               "Completed oplog application for recovery",
               "numOpsApplied"_attr = _numOpsApplied,
               "numBatches"_attr = _numBatches,
-              "applyThroughOpTime"_attr = applyThroughOpTime);
+              "applyThroughOpTime"_attr = applyThroughOpTime,
+              "durationMillis"_attr = durationMillis,
+              "readWaitMillis"_attr = durationCount<Milliseconds>(_readWait),
+              "opsPerSecond"_attr =
+                  static_cast<long long>(_numOpsApplied) * 1000 / std::max(durationMillis, 1LL));
     }
 
 private:
+    Timer _timer;
+    Milliseconds _readWait{0};
     std::size_t _numBatches = 0;
     std::size_t _numOpsApplied = 0;
 };
@@ -248,6 +281,140 @@ private:
     std::unique_ptr<DBClientCursor> _cursor;
 };
 
+/**
+ * Produces the applier batches for recovery. When read-ahead is enabled, batches are read from the
+ * local oplog on a dedicated thread, which keeps up to 'maxBatchesReadAhead' batches buffered so
+ * that the next batch is already in memory by the time the writer pool has applied the current
+ * one. Otherwise each batch is read on the applying thread.
+ */
+class RecoveryOplogBatchReader {
+public:
+    RecoveryOplogBatchReader(OplogApplier* oplogApplier,
+                             OplogBufferLocalOplog* oplogBuffer,
+                             OplogApplier::BatchLimits batchLimits,
+                             std::size_t maxBatchesReadAhead)
+        : _oplogApplier(oplogApplier),
+          _oplogBuffer(oplogBuffer),
+          _batchLimits(std::move(batchLimits)),
+          _maxBatchesReadAhead(maxBatchesReadAhead) {}
+
+    ~RecoveryOplogBatchReader() {
+        _stopReadAhead();
+    }
+
+    void startup(OperationContext* opCtx) {
+        if (_maxBatchesReadAhead == 0) {
+            _oplogBuffer->startup(opCtx);
+            return;
+        }
+
+        _readAheadThread = stdx::thread([this, serviceContext = opCtx->getServiceContext()] {
+            ThreadClient tc("ReplRecoveryOplogReader", serviceContext);
+            AuthorizationSession::get(cc())->grantInternalAuthorization(&cc());
+            auto readerOpCtx = cc().makeOperationContext();
+
+            // Recovery cannot make progress without the next batch, so reads of the oplog must not
+            // queue behind other work for a ticket.
+            SetAdmissionPriorityForLock priority(readerOpCtx.get(),
+                                                 AdmissionContext::Priority::kImmediate);
+            _readAhead(readerOpCtx.get());
+        });
+    }
+
+    /**
+     * Returns the next batch to apply. An empty batch indicates that every operation in the
+     * recovery range has been returned.
+     */
+    StatusWith<std::vector<OplogEntry>> getNextBatch(OperationContext* opCtx,
+                                                     RecoveryOplogApplierStats* stats) {
+        if (_maxBatchesReadAhead == 0) {
+            return _oplogApplier->getNextApplierBatch(opCtx, _batchLimits);
+        }
+
+        Timer waitTimer;
+        stdx::unique_lock<Latch> lk(_mutex);
+        _cv.wait(lk, [&] { return !_batches.empty(); });
+        stats->recordReadWait(Milliseconds(waitTimer.millis()));
+
+        auto batch = std::move(_batches.front());
+        _batches.pop_front();
+        _cv.notify_all();
+        return batch;
+    }
+
+    void shutdown(OperationContext* opCtx) {
+        if (_maxBatchesReadAhead == 0) {
+            invariant(_oplogBuffer->isEmpty(),
+                      "Oplog buffer not empty after reading all batches for recovery");
+            _oplogBuffer->shutdown(opCtx);
+            return;
+        }
+        _stopReadAhead();
+    }
+
+private:
+    void _readAhead(OperationContext* opCtx) {
+        try {
+            _oplogBuffer->startup(opCtx);
+            ON_BLOCK_EXIT([&] { _oplogBuffer->shutdown(opCtx); });
+
+            bool done = false;
+            while (!done) {
+                {
+                    stdx::unique_lock<Latch> lk(_mutex);
+                    _cv.wait(lk, [&] {
+                        return _inShutdown || _batches.size() < _maxBatchesReadAhead;
+                    });
+                    if (_inShutdown) {
+                        return;
+                    }
+                }
+
+                auto batch = _oplogApplier->getNextApplierBatch(opCtx, _batchLimits);
+                done = !batch.isOK() || batch.getValue().empty();
+                if (done && batch.isOK()) {
+                    invariant(_oplogBuffer->isEmpty(),
+                              "Oplog buffer not empty after reading all batches for recovery");
+                }
+
+                stdx::lock_guard<Latch> lk(_mutex);
+                _batches.push_back(std::move(batch));
+                _cv.notify_all();
+            }
+        } catch (const DBException& ex) {
+            stdx::lock_guard<Latch> lk(_mutex);
+            _batches.push_back(ex.toStatus());
+            _cv.notify_all();
+        }
+    }
+
+    void _stopReadAhead() {
+        if (!_readAheadThread.joinable()) {
+            return;
+        }
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            _inShutdown = true;
+            _cv.notify_all();
+        }
+        _readAheadThread.join();
+    }
+
+    OplogApplier* const _oplogApplier;
+    OplogBufferLocalOplog* const _oplogBuffer;
+    const OplogApplier::BatchLimits _batchLimits;
+    const std::size_t _maxBatchesReadAhead;
+
+    stdx::thread _readAheadThread;
+
+    Mutex _mutex = MONGO_MAKE_LATCH("RecoveryOplogBatchReader::_mutex");
+    stdx::condition_variable _cv;
+
+    // Batches read from the oplog but not yet handed to the applier. Guarded by '_mutex'.
+    std::deque<StatusWith<std::vector<OplogEntry>>> _batches;
+    bool _inShutdown = false;
+};
+
 boost::optional<Timestamp> recoverFromOplogPrecursor(OperationContext* opCtx,
                                                      StorageInterface* storageInterface) {
     if (!storageInterface->supportsRecoveryTimestamp(opCtx->getServiceContext())) {
@@ -701,7 +868,6 @@ Timestamp ReplicationRecoveryImpl::_applyOplogOperations(OperationContext* opCtx
           "endPoint"_attr = endPoint);
 
     OplogBufferLocalOplog oplogBuffer(startPoint, endPoint);
-    oplogBuffer.startup(opCtx);
 
     RecoveryOplogApplierStats stats;
 
@@ -720,6 +886,11 @@ Timestamp ReplicationRecoveryImpl::_applyOplogOperations(OperationContext* opCtx
     batchLimits.bytes = getBatchLimitOplogBytes(opCtx, _storageInterface);
     batchLimits.ops = getBatchLimitOplogEntries();
 
+    // Reading the next batch from the oplog overlaps with the writer pool applying the current one.
+    RecoveryOplogBatchReader batchReader(
+        &oplogApplier, &oplogBuffer, batchLimits, replRecoveryOplogReadAheadBatches);
+    batchReader.startup(opCtx);
+
     // If we're doing unstable checkpoints during the recovery process (as we do during the special
     // startupRecoveryForRestore mode), we need to advance the consistency marker for each batch so
     // the next time we recover we won't start all the way over.  Further, we can advance the oldest
@@ -735,8 +906,7 @@ Timestamp ReplicationRecoveryImpl::_applyOplogOperations(OperationContext* opCtx
 
     OpTime applyThroughOpTime;
     std::vector<OplogEntry> batch;
-    while (
-        !(batch = fassert(50763, oplogApplier.getNextApplierBatch(opCtx, batchLimits))).empty()) {
+    while (!(batch = fassert(50763, batchReader.getNextBatch(opCtx, &stats))).empty()) {
         if (advanceTimestampsEachBatch && applyThroughOpTime.isNull()) {
             // We must set appliedThrough before applying anything at all, so we know
             // any unstable checkpoints we take are "dirty".  A null appliedThrough indicates
@@ -752,11 +922,7 @@ Timestamp ReplicationRecoveryImpl::_applyOplogOperations(OperationContext* opCtx
         }
     }
     stats.complete(applyThroughOpTime);
-    invariant(oplogBuffer.isEmpty(),
-              str::stream() << "Oplog buffer not empty after applying operations. Last operation "
-                               "applied with optime: "
-                            << applyThroughOpTime.toBSON());
-    oplogBuffer.shutdown(opCtx);
+    batchReader.shutdown(opCtx);
 
     // The applied up to timestamp will be null if no oplog entries were applied.
     if (applyThroughOpTime.isNull()) {
@@ -0,0 +1,123 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/db/repl/replication_waiter_list.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace repl {
+
+std::string ReplicationWaiterList::_groupKey(const boost::optional<WriteConcernOptions>& w) {
+    if (!w) {
+        return std::string();
+    }
+
+    str::stream key;
+    if (auto mode = stdx::get_if<std::string>(&w->w)) {
+        key << "mode:" << *mode;
+    } else if (auto numNodes = stdx::get_if<std::int64_t>(&w->w)) {
+        key << "nodes:" << *numNodes;
+    } else {
+        // Tags are unordered, so sort them for equal tag sets to share a group.
+        const auto& wTags = stdx::get<WTags>(w->w);
+        std::vector<std::pair<std::string, std::int64_t>> tags(wTags.begin(), wTags.end());
+        std::sort(tags.begin(), tags.end());
+        key << "tags:";
+        for (const auto& [tag, count] : tags) {
+            key << tag << "=" << count << ",";
+        }
+    }
+
+    // Only journaled write concerns wait on the durable opTimes.
+    key << "|j:" << (w->syncMode == WriteConcernOptions::SyncMode::JOURNAL);
+    return key;
+}
+
+void ReplicationWaiterList::add_inlock(const OpTime& opTime, SharedWaiterHandle waiter) {
+    _waiters[_groupKey(waiter->writeConcern)].emplace(opTime, std::move(waiter));
+}
+
+SharedSemiFuture<void> ReplicationWaiterList::add_inlock(const OpTime& opTime,
+                                                         boost::optional<WriteConcernOptions> wc) {
+    auto pf = makePromiseFuture<void>();
+    add_inlock(opTime, std::make_shared<ReplicationWaiter>(std::move(pf.promise), std::move(wc)));
+    return std::move(pf.future);
+}
+
+bool ReplicationWaiterList::remove_inlock(SharedWaiterHandle waiter) {
+    auto group = _waiters.find(_groupKey(waiter->writeConcern));
+    if (group == _waiters.end()) {
+        return false;
+    }
+    auto& waiters = group->second;
+    for (auto iter = waiters.begin(); iter != waiters.end(); iter++) {
+        if (iter->second == waiter) {
+            waiters.erase(iter);
+            if (waiters.empty()) {
+                _waiters.erase(group);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+void ReplicationWaiterList::setValueAll_inlock() {
+    for (auto& [key, waiters] : _waiters) {
+        for (auto& [opTime, waiter] : waiters) {
+            waiter->promise.emplaceValue();
+        }
+    }
+    _waiters.clear();
+}
+
+void ReplicationWaiterList::setErrorAll_inlock(Status status) {
+    invariant(!status.isOK());
+    for (auto& [key, waiters] : _waiters) {
+        for (auto& [opTime, waiter] : waiters) {
+            waiter->promise.setError(status);
+        }
+    }
+    _waiters.clear();
+}
+
+size_t ReplicationWaiterList::size_inlock() const {
+    size_t size = 0;
+    for (const auto& [key, waiters] : _waiters) {
+        size += waiters.size();
+    }
+    return size;
+}
+
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,167 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "mongo/base/status.h"
+#include "mongo/db/repl/optime.h"
+#include "mongo/db/write_concern_options.h"
+#include "mongo/util/future.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+namespace repl {
+
+/**
+ * A thread waiting for replication to reach an opTime, optionally under a write concern.
+ */
+struct ReplicationWaiter {
+    Promise<void> promise;
+    boost::optional<WriteConcernOptions> writeConcern;
+    explicit ReplicationWaiter(Promise<void> p,
+                               boost::optional<WriteConcernOptions> w = boost::none)
+        : promise(std::move(p)), writeConcern(w) {}
+};
+
+using SharedWaiterHandle = std::shared_ptr<ReplicationWaiter>;
+
+/**
+ * The waiters for replication progress, ordered by opTime within groups of waiters whose write
+ * concerns are satisfied under the same conditions.
+ *
+ * Whether a write concern is satisfied at an opTime is monotonic: if it is not yet satisfied at
+ * some opTime, it is not satisfied at any later one either. setValueIfSatisfied_inlock() relies on
+ * this to stop at the first unsatisfied waiter of each group, so that waking k of n waiters costs
+ * O(k log n) rather than a scan of every waiter.
+ *
+ * Not synchronized; every method must be called with the owner's mutex held.
+ */
+class ReplicationWaiterList {
+public:
+    // Adds waiter into the list.
+    void add_inlock(const OpTime& opTime, SharedWaiterHandle waiter);
+    // Adds a waiter into the list and returns the future of the waiter's promise.
+    SharedSemiFuture<void> add_inlock(const OpTime& opTime,
+                                      boost::optional<WriteConcernOptions> w = boost::none);
+    // Returns whether waiter is found and removed.
+    bool remove_inlock(SharedWaiterHandle waiter);
+    // Signals all waiters whose opTime is <= the given opTime (if any) that satisfy the
+    // condition in func. Evaluates func for every such waiter.
+    template <typename Func>
+    void setValueIf_inlock(Func&& func, boost::optional<OpTime> opTime = boost::none);
+    // Signals the waiters whose opTime is <= the given opTime (if any) that satisfy the condition
+    // in func, which must be monotonic in opTime for a given write concern. Stops at the first
+    // waiter of each group that does not satisfy it.
+    template <typename Func>
+    void setValueIfSatisfied_inlock(Func&& func, boost::optional<OpTime> opTime = boost::none);
+    // Signals all waiters from the list and fulfills promises with OK status.
+    void setValueAll_inlock();
+    // Signals all waiters from the list and fulfills promises with Error status.
+    void setErrorAll_inlock(Status status);
+    // Returns the number of waiters in the list.
+    size_t size_inlock() const;
+
+private:
+    using Waiters = std::multimap<OpTime, SharedWaiterHandle>;
+
+    /**
+     * Returns the key of the group for waiters with write concern 'w'. Write concerns which only
+     * differ in the fields that do not affect when they are satisfied, like wtimeout, share a
+     * group.
+     */
+    static std::string _groupKey(const boost::optional<WriteConcernOptions>& w);
+
+    /**
+     * Signals the waiters in 'waiters' up to 'opTime' which satisfy 'func', stopping at the first
+     * one which does not if 'stopAtUnsatisfied' is set.
+     */
+    template <typename Func>
+    static void _setValueIf(Waiters& waiters,
+                            Func& func,
+                            const boost::optional<OpTime>& opTime,
+                            bool stopAtUnsatisfied);
+
+    // Waiters sorted by OpTime, keyed by the group of their write concern.
+    StringMap<Waiters> _waiters;
+};
+
+template <typename Func>
+void ReplicationWaiterList::_setValueIf(Waiters& waiters,
+                                        Func& func,
+                                        const boost::optional<OpTime>& opTime,
+                                        bool stopAtUnsatisfied) {
+    for (auto it = waiters.begin(); it != waiters.end() && (!opTime || it->first <= *opTime);) {
+        const auto& waiter = it->second;
+        try {
+            if (func(it->first, waiter)) {
+                waiter->promise.emplaceValue();
+                it = waiters.erase(it);
+            } else if (stopAtUnsatisfied) {
+                return;
+            } else {
+                ++it;
+            }
+        } catch (const DBException& e) {
+            waiter->promise.setError(e.toStatus());
+            it = waiters.erase(it);
+        }
+    }
+}
+
+template <typename Func>
+void ReplicationWaiterList::setValueIf_inlock(Func&& func, boost::optional<OpTime> opTime) {
+    for (auto it = _waiters.begin(); it != _waiters.end();) {
+        _setValueIf(it->second, func, opTime, false /* stopAtUnsatisfied */);
+        if (it->second.empty()) {
+            _waiters.erase(it++);
+        } else {
+            ++it;
+        }
+    }
+}
+
+template <typename Func>
+void ReplicationWaiterList::setValueIfSatisfied_inlock(Func&& func,
+                                                       boost::optional<OpTime> opTime) {
+    for (auto it = _waiters.begin(); it != _waiters.end();) {
+        _setValueIf(it->second, func, opTime, true /* stopAtUnsatisfied */);
+        if (it->second.empty()) {
+            _waiters.erase(it++);
+        } else {
+            ++it;
+        }
+    }
+}
+
+}  // namespace repl
+}  // namespace mongo
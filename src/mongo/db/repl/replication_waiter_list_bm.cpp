@@ -0,0 +1,109 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/repl/replication_waiter_list.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+constexpr unsigned kNumWaiters = 50 * 1000;
+
+/**
+ * Measures how long one advance of the commit point takes with 50K w:majority waiters, of which
+ * the advance satisfies the first state.range(0). The satisfied waiters are replaced so that the
+ * number of waiters stays the same.
+ */
+void BM_WakeSatisfiedWaiters(benchmark::State& state) {
+    const unsigned waitersPerAdvance = state.range(0);
+    const WriteConcernOptions majority(WriteConcernOptions::kMajority,
+                                       WriteConcernOptions::SyncMode::NONE,
+                                       WriteConcernOptions::kNoTimeout);
+
+    ReplicationWaiterList waiters;
+    unsigned lastAdded = 0;
+    for (; lastAdded < kNumWaiters; ++lastAdded) {
+        waiters.add_inlock(OpTime(Timestamp(lastAdded + 1, 1), 1), majority);
+    }
+
+    unsigned committed = 0;
+    for (auto _ : state) {
+        committed += waitersPerAdvance;
+        const OpTime commitPoint(Timestamp(committed, 1), 1);
+        waiters.setValueIfSatisfied_inlock(
+            [&](const OpTime& opTime, const SharedWaiterHandle&) { return opTime <= commitPoint; });
+
+        state.PauseTiming();
+        for (unsigned i = 0; i < waitersPerAdvance; ++i, ++lastAdded) {
+            waiters.add_inlock(OpTime(Timestamp(lastAdded + 1, 1), 1), majority);
+        }
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * waitersPerAdvance);
+}
+
+/**
+ * The same advance with every waiter checked, as before waiters were grouped by write concern.
+ */
+void BM_WakeWaitersFullScan(benchmark::State& state) {
+    const unsigned waitersPerAdvance = state.range(0);
+    const WriteConcernOptions majority(WriteConcernOptions::kMajority,
+                                       WriteConcernOptions::SyncMode::NONE,
+                                       WriteConcernOptions::kNoTimeout);
+
+    ReplicationWaiterList waiters;
+    unsigned lastAdded = 0;
+    for (; lastAdded < kNumWaiters; ++lastAdded) {
+        waiters.add_inlock(OpTime(Timestamp(lastAdded + 1, 1), 1), majority);
+    }
+
+    unsigned committed = 0;
+    for (auto _ : state) {
+        committed += waitersPerAdvance;
+        const OpTime commitPoint(Timestamp(committed, 1), 1);
+        waiters.setValueIf_inlock(
+            [&](const OpTime& opTime, const SharedWaiterHandle&) { return opTime <= commitPoint; });
+
+        state.PauseTiming();
+        for (unsigned i = 0; i < waitersPerAdvance; ++i, ++lastAdded) {
+            waiters.add_inlock(OpTime(Timestamp(lastAdded + 1, 1), 1), majority);
+        }
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * waitersPerAdvance);
+}
+
+BENCHMARK(BM_WakeSatisfiedWaiters)->Arg(1)->Arg(100)->Arg(1000);
+BENCHMARK(BM_WakeWaitersFullScan)->Arg(1)->Arg(100)->Arg(1000);
+
+}  // namespace
+}  // namespace repl
+}  // namespace mongo
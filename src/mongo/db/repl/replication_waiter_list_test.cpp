@@ -0,0 +1,158 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/db/repl/replication_waiter_list.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+OpTime opTime(unsigned secs) {
+    return OpTime(Timestamp(secs, 1), 1);
+}
+
+WriteConcernOptions majority(Milliseconds wTimeout = WriteConcernOptions::kNoTimeout) {
+    return WriteConcernOptions(WriteConcernOptions::kMajority,
+                               WriteConcernOptions::SyncMode::NONE,
+                               wTimeout);
+}
+
+WriteConcernOptions numNodes(int w) {
+    return WriteConcernOptions(w, WriteConcernOptions::SyncMode::NONE, Milliseconds(0));
+}
+
+TEST(ReplicationWaiterListTest, SetValueIfSatisfiedStopsAtFirstUnsatisfiedWaiter) {
+    ReplicationWaiterList waiters;
+    std::vector<SharedSemiFuture<void>> futures;
+    for (unsigned i = 1; i <= 5; ++i) {
+        futures.push_back(waiters.add_inlock(opTime(i), majority()));
+    }
+
+    int calls = 0;
+    waiters.setValueIfSatisfied_inlock([&](const OpTime& waitOpTime, const SharedWaiterHandle&) {
+        ++calls;
+        return waitOpTime <= opTime(3);
+    });
+
+    ASSERT_EQ(4, calls);
+    ASSERT_EQ(2U, waiters.size_inlock());
+    for (unsigned i = 0; i < 5; ++i) {
+        ASSERT_EQ(i < 3, futures[i].isReady());
+    }
+}
+
+TEST(ReplicationWaiterListTest, SetValueIfSatisfiedChecksEachWriteConcernSeparately) {
+    ReplicationWaiterList waiters;
+    auto majority1 = waiters.add_inlock(opTime(1), majority());
+    auto majority2 = waiters.add_inlock(opTime(2), majority(Milliseconds(100)));
+    auto w2 = waiters.add_inlock(opTime(1), numNodes(2));
+    auto w3 = waiters.add_inlock(opTime(1), numNodes(3));
+
+    int calls = 0;
+    waiters.setValueIfSatisfied_inlock([&](const OpTime&, const SharedWaiterHandle& waiter) {
+        ++calls;
+        // Only majority and w:2 are satisfied. wtimeout does not separate the majority waiters.
+        const auto& w = waiter->writeConcern->w;
+        return !stdx::holds_alternative<std::int64_t>(w) || stdx::get<std::int64_t>(w) != 3;
+    });
+
+    ASSERT_EQ(4, calls);
+    ASSERT(majority1.isReady());
+    ASSERT(majority2.isReady());
+    ASSERT(w2.isReady());
+    ASSERT_FALSE(w3.isReady());
+    ASSERT_EQ(1U, waiters.size_inlock());
+}
+
+TEST(ReplicationWaiterListTest, SetValueIfSatisfiedIgnoresWaitersAfterOpTime) {
+    ReplicationWaiterList waiters;
+    auto first = waiters.add_inlock(opTime(1));
+    auto second = waiters.add_inlock(opTime(2));
+
+    int calls = 0;
+    waiters.setValueIfSatisfied_inlock(
+        [&](const OpTime&, const SharedWaiterHandle&) {
+            ++calls;
+            return true;
+        },
+        opTime(1));
+
+    ASSERT_EQ(1, calls);
+    ASSERT(first.isReady());
+    ASSERT_FALSE(second.isReady());
+}
+
+TEST(ReplicationWaiterListTest, SetValueIfVisitsEveryWaiter) {
+    ReplicationWaiterList waiters;
+    std::vector<SharedSemiFuture<void>> futures;
+    for (unsigned i = 1; i <= 5; ++i) {
+        futures.push_back(waiters.add_inlock(opTime(i), majority()));
+    }
+
+    int calls = 0;
+    waiters.setValueIf_inlock([&](const OpTime& waitOpTime, const SharedWaiterHandle&) {
+        ++calls;
+        uassert(ErrorCodes::UnsatisfiableWriteConcern, "unsatisfiable", waitOpTime != opTime(2));
+        return false;
+    });
+
+    ASSERT_EQ(5, calls);
+    ASSERT_EQ(4U, waiters.size_inlock());
+    ASSERT_EQ(ErrorCodes::UnsatisfiableWriteConcern, futures[1].getNoThrow());
+    ASSERT_FALSE(futures[0].isReady());
+}
+
+TEST(ReplicationWaiterListTest, RemoveWaiter) {
+    ReplicationWaiterList waiters;
+    auto pf = makePromiseFuture<void>();
+    auto waiter = std::make_shared<ReplicationWaiter>(std::move(pf.promise), majority());
+    waiters.add_inlock(opTime(1), waiter);
+    waiters.add_inlock(opTime(1), majority());
+
+    ASSERT(waiters.remove_inlock(waiter));
+    ASSERT_FALSE(waiters.remove_inlock(waiter));
+    ASSERT_EQ(1U, waiters.size_inlock());
+}
+
+TEST(ReplicationWaiterListTest, SetErrorAll) {
+    ReplicationWaiterList waiters;
+    auto majorityWaiter = waiters.add_inlock(opTime(1), majority());
+    auto opTimeWaiter = waiters.add_inlock(opTime(2));
+
+    waiters.setErrorAll_inlock({ErrorCodes::PrimarySteppedDown, "stepped down"});
+
+    ASSERT_EQ(0U, waiters.size_inlock());
+    ASSERT_EQ(ErrorCodes::PrimarySteppedDown, majorityWaiter.getNoThrow());
+    ASSERT_EQ(ErrorCodes::PrimarySteppedDown, opTimeWaiter.getNoThrow());
+}
+
+}  // namespace
+}  // namespace repl
+}  // namespace mongo
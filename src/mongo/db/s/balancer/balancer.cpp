@@ -1204,6 +1204,10 @@ BalancerCollectionStatusResponse Balancer::getBalancerStatusForNs(OperationConte
         case MigrationReason::chunksImbalance:
             setViolationOnResponse(kBalancerPolicyStatusChunksImbalance);
             break;
+        case MigrationReason::loadImbalance:
+            // The load of the chunks is not collected when reporting the balancer status, since
+            // doing so would reset the counters sampled for the next balancing round
+            break;
     }
 
     return response;
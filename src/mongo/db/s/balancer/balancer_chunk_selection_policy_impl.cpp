@@ -102,9 +102,14 @@ StatusWith<DistributionStatus> createCollectionDistributionStatus(
     return {std::move(distribution)};
 }
 
+/**
+ * Retrieves the data size of the given collections from all the shards. If 'includeRangeLoad' is
+ * true, also retrieves the load sampled by the shards on each chunk, which resets their counters.
+ */
 stdx::unordered_map<NamespaceString, CollectionDataSizeInfoForBalancing>
 getDataSizeInfoForCollections(OperationContext* opCtx,
-                              const std::vector<CollectionType>& collections) {
+                              const std::vector<CollectionType>& collections,
+                              bool includeRangeLoad) {
     const auto balancerConfig = Grid::get(opCtx)->getBalancerConfiguration();
     uassertStatusOK(balancerConfig->refreshAndCheck(opCtx));
 
@@ -131,6 +136,9 @@ getDataSizeInfoForCollections(OperationContext* opCtx,
 
     ShardsvrGetStatsForBalancing req{namespacesWithUUIDsForStatsRequest};
     req.setScaleFactor(1);
+    if (includeRangeLoad) {
+        req.setIncludeRangeLoad(true);
+    }
     const auto reqObj = req.toBSON({});
 
     const auto executor = Grid::get(opCtx)->getExecutorPool()->getFixedExecutor();
@@ -159,7 +167,18 @@ getDataSizeInfoForCollections(OperationContext* opCtx,
             invariant(collStatsFromShard.size() == collections.size());
             for (const auto& stats : collStatsFromShard) {
                 invariant(dataSizeInfoMap.contains(stats.getNs()));
-                dataSizeInfoMap.at(stats.getNs()).shardToDataSizeMap[shardId] = stats.getCollSize();
+                auto& dataSizeInfo = dataSizeInfoMap.at(stats.getNs());
+                dataSizeInfo.shardToDataSizeMap[shardId] = stats.getCollSize();
+
+                const auto& rangeLoad = stats.getRangeLoad();
+                if (rangeLoad && !rangeLoad->empty()) {
+                    auto& chunkLoads = dataSizeInfo.shardToChunkLoadMap[shardId];
+                    for (const auto& range : *rangeLoad) {
+                        chunkLoads.push_back(
+                            {ChunkRange(range.getMin().getOwned(), range.getMax().getOwned()),
+                             range.getReads() + range.getWrites()});
+                    }
+                }
             }
         } catch (const ExceptionFor<ErrorCodes::ShardNotFound>& ex) {
             // Handle `removeShard`: skip shards removed during a balancing round
@@ -177,7 +196,8 @@ CollectionDataSizeInfoForBalancing getDataSizeInfoForCollection(OperationContext
                                                                 const NamespaceString& nss) {
     const auto coll = Grid::get(opCtx)->catalogClient()->getCollection(opCtx, nss);
     std::vector<CollectionType> vec{coll};
-    return std::move(getDataSizeInfoForCollections(opCtx, vec).at(nss));
+    return std::move(
+        getDataSizeInfoForCollections(opCtx, vec, false /* includeRangeLoad */).at(nss));
 }
 
 /**
@@ -454,7 +474,8 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::selectChunksToMo
             collsDataSizeInfo;
         if (feature_flags::gBalanceAccordingToDataSize.isEnabled(
                 serverGlobalParams.featureCompatibility)) {
-            collsDataSizeInfo.emplace(getDataSizeInfoForCollections(opCtx, collBatch));
+            collsDataSizeInfo.emplace(getDataSizeInfoForCollections(
+                opCtx, collBatch, balancerLoadAwareBalancing.load()));
         }
 
         for (const auto& collFromBatch : collBatch) {
@@ -32,9 +32,11 @@
 
 #include "mongo/db/s/balancer/balancer_policy.h"
 
+#include <algorithm>
 #include <random>
 
 #include "mongo/db/s/balancer/type_migration.h"
+#include "mongo/db/s/sharding_config_server_parameters_gen.h"
 #include "mongo/logv2/log.h"
 #include "mongo/s/balancer_configuration.h"
 #include "mongo/s/catalog/type_shard.h"
@@ -610,11 +612,31 @@ MigrateInfosWithReason BalancerPolicy::balance(
                                                               : ForceJumbo::kDoNotForce);
         };
 
+        bool zoneIsBalanced = true;
         while (singleZoneBalance()) {
+            zoneIsBalanced = false;
             if (firstReason == MigrationReason::none) {
                 firstReason = MigrationReason::chunksImbalance;
             }
         }
+
+        // Only spread the load of a zone whose data is balanced, so that the two policies do not
+        // compete over the same shards
+        if (zoneIsBalanced && collDataSizeInfo.has_value() &&
+            !collDataSizeInfo->shardToChunkLoadMap.empty()) {
+            while (_singleZoneBalanceBasedOnLoad(shardStats,
+                                                 distribution,
+                                                 *collDataSizeInfo,
+                                                 zone,
+                                                 &migrations,
+                                                 availableShards,
+                                                 forceJumbo ? ForceJumbo::kForceBalancer
+                                                            : ForceJumbo::kDoNotForce)) {
+                if (firstReason == MigrationReason::none) {
+                    firstReason = MigrationReason::loadImbalance;
+                }
+            }
+        }
     }
 
     return std::make_pair(std::move(migrations), firstReason);
@@ -814,6 +836,117 @@ bool BalancerPolicy::_singleZoneBalanceBasedOnDataSize(
     return false;
 }
 
+bool BalancerPolicy::_singleZoneBalanceBasedOnLoad(
+    const ShardStatisticsVector& shardStats,
+    const DistributionStatus& distribution,
+    const CollectionDataSizeInfoForBalancing& collDataSizeInfo,
+    const string& zone,
+    vector<MigrateInfo>* migrations,
+    stdx::unordered_set<ShardId>* availableShards,
+    ForceJumbo forceJumbo) {
+    const auto getShardLoad = [&](const ShardId& shardId) -> int64_t {
+        const auto it = collDataSizeInfo.shardToChunkLoadMap.find(shardId);
+        if (it == collDataSizeInfo.shardToChunkLoadMap.end()) {
+            return 0;
+        }
+
+        int64_t load = 0;
+        for (const auto& chunkLoad : it->second) {
+            load += chunkLoad.numOps;
+        }
+        return load;
+    };
+
+    ShardId from;
+    int64_t fromLoad = numeric_limits<int64_t>::min();
+    ShardId to;
+    int64_t toLoad = numeric_limits<int64_t>::max();
+
+    for (const auto& stat : shardStats) {
+        if (!availableShards->count(stat.shardId))
+            continue;
+
+        if (!isShardSuitableReceiver(stat, zone).isOK())
+            continue;
+
+        if (!collDataSizeInfo.shardToDataSizeMap.count(stat.shardId)) {
+            // Skip if stats not available (may happen if add|remove shard during a round)
+            continue;
+        }
+
+        const auto load = getShardLoad(stat.shardId);
+        if (load > fromLoad) {
+            from = stat.shardId;
+            fromLoad = load;
+        }
+        if (load < toLoad) {
+            to = stat.shardId;
+            toLoad = load;
+        }
+    }
+
+    if (!from.isValid() || !to.isValid() || from == to) {
+        return false;
+    }
+
+    LOGV2_DEBUG(7095758,
+                1,
+                "Balancing single zone based on load",
+                "namespace"_attr = distribution.nss().ns(),
+                "zone"_attr = zone,
+                "fromShardId"_attr = from,
+                "fromShardLoad"_attr = fromLoad,
+                "toShardId"_attr = to,
+                "toShardLoad"_attr = toLoad);
+
+    if (fromLoad - toLoad < balancerLoadMinOpsDifference.load() ||
+        static_cast<double>(fromLoad) <
+            balancerLoadImbalanceThreshold.load() * static_cast<double>(toLoad)) {
+        // Do not balance if the load differs too few between the chosen shards
+        return false;
+    }
+
+    auto chunksByMin = SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<const ChunkType*>();
+    for (const auto& chunk : distribution.getChunks(from)) {
+        chunksByMin.emplace(chunk.getMin(), &chunk);
+    }
+
+    auto chunkLoads = collDataSizeInfo.shardToChunkLoadMap.at(from);
+    std::sort(chunkLoads.begin(), chunkLoads.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.numOps > rhs.numOps;
+    });
+
+    for (const auto& chunkLoad : chunkLoads) {
+        // Moving a chunk carrying more than half of the load difference would only move the hot
+        // spot to the receiver, which would then send it back on the next balancing round
+        if (chunkLoad.numOps <= 0 || 2 * chunkLoad.numOps > fromLoad - toLoad)
+            continue;
+
+        // The shard may have reported the load of a chunk which has since been split, merged or
+        // moved, in which case it no longer matches any chunk of the routing table
+        const auto it = chunksByMin.find(chunkLoad.range.getMin());
+        if (it == chunksByMin.end() ||
+            SimpleBSONObjComparator::kInstance.evaluate(it->second->getMax() !=
+                                                        chunkLoad.range.getMax()))
+            continue;
+
+        const auto& chunk = *it->second;
+        if (distribution.getZoneForChunk(chunk) != zone)
+            continue;
+
+        if (chunk.getJumbo() && forceJumbo == ForceJumbo::kDoNotForce)
+            continue;
+
+        migrations->emplace_back(
+            to, distribution.nss(), chunk, forceJumbo, collDataSizeInfo.maxChunkSizeBytes);
+        invariant(availableShards->erase(from));
+        invariant(availableShards->erase(to));
+        return true;
+    }
+
+    return false;
+}
+
 ZoneRange::ZoneRange(const BSONObj& a_min, const BSONObj& a_max, const std::string& _zone)
     : min(a_min.getOwned()), max(a_max.getOwned()), zone(_zone) {}
 
@@ -97,7 +97,7 @@ struct MigrateInfo {
     boost::optional<int64_t> optMaxChunkSizeBytes;
 };
 
-enum MigrationReason { none, drain, zoneViolation, chunksImbalance };
+enum MigrationReason { none, drain, zoneViolation, chunksImbalance, loadImbalance };
 
 typedef std::vector<MigrateInfo> MigrateInfoVector;
 
@@ -218,6 +218,14 @@ typedef stdx::variant<Status, StatusWith<AutoSplitVectorResponse>, StatusWith<Da
 typedef std::vector<ClusterStatistics::ShardStatistics> ShardStatisticsVector;
 typedef std::map<ShardId, std::vector<ChunkType>> ShardToChunksMap;
 
+/**
+ * Estimated number of operations a shard received on one of its chunks.
+ */
+struct ChunkLoadInfo {
+    ChunkRange range;
+    int64_t numOps;
+};
+
 /*
  * Keeps track of info needed for data size aware balancing.
  */
@@ -228,6 +236,10 @@ struct CollectionDataSizeInfoForBalancing {
 
     std::map<ShardId, int64_t> shardToDataSizeMap;
     const int64_t maxChunkSizeBytes;
+
+    // Load sampled on each chunk since the previous balancing round, only populated when
+    // load-aware balancing is enabled. Shards with no sampled operations have no entry.
+    std::map<ShardId, std::vector<ChunkLoadInfo>> shardToChunkLoadMap;
 };
 
 /**
@@ -477,6 +489,29 @@ private:
         std::vector<MigrateInfo>* migrations,
         stdx::unordered_set<ShardId>* availableShards,
         ForceJumbo forceJumbo);
+
+    /**
+     * Selects one chunk for the specified zone (if appropriate) to be moved from the shard which
+     * received the most operations to the one which received the least, based on the load sampled
+     * on the chunks of the collection. Takes into account and updates the shards, which haven't
+     * been used for migrations yet.
+     *
+     * A chunk is only moved if the load of the two shards differs by at least
+     * balancerLoadImbalanceThreshold times and balancerLoadMinOpsDifference operations, and if the
+     * receiving shard remains less loaded than the donor once the chunk is moved, so that a chunk
+     * never bounces back on the next balancing round.
+     *
+     * Returns true if a migration was suggested, false otherwise. This method is intented to be
+     * called multiple times until all posible migrations for a zone have been selected.
+     */
+    static bool _singleZoneBalanceBasedOnLoad(
+        const ShardStatisticsVector& shardStats,
+        const DistributionStatus& distribution,
+        const CollectionDataSizeInfoForBalancing& collDataSizeInfo,
+        const std::string& zone,
+        std::vector<MigrateInfo>* migrations,
+        stdx::unordered_set<ShardId>* availableShards,
+        ForceJumbo forceJumbo);
 };
 
 }  // namespace mongo
@@ -127,6 +127,27 @@ MigrateInfosWithReason balanceChunks(const ShardStatisticsVector& shardStats,
         shardStats, distribution, boost::none /* collDataSizeInfo */, &availableShards, forceJumbo);
 }
 
+/**
+ * Returns the data size info of a collection whose data is evenly spread across the given shards,
+ * with the given number of operations sampled on each of the chunks.
+ */
+CollectionDataSizeInfoForBalancing makeCollDataSizeInfoWithLoad(
+    const ShardStatisticsVector& shardStats,
+    const std::vector<std::pair<ChunkType, int64_t>>& chunksAndNumOps) {
+    std::map<ShardId, int64_t> shardToDataSizeMap;
+    for (const auto& stat : shardStats) {
+        shardToDataSizeMap[stat.shardId] = 0;
+    }
+
+    CollectionDataSizeInfoForBalancing collDataSizeInfo(std::move(shardToDataSizeMap),
+                                                        1024 * 1024 /* maxChunkSizeBytes */);
+    for (const auto& [chunk, numOps] : chunksAndNumOps) {
+        collDataSizeInfo.shardToChunkLoadMap[chunk.getShard()].push_back(
+            {ChunkRange(chunk.getMin(), chunk.getMax()), numOps});
+    }
+    return collDataSizeInfo;
+}
+
 TEST(BalancerPolicy, Basic) {
     auto cluster = generateCluster(
         {{ShardStatistics(kShardId0, 4, false, emptyZoneSet, emptyShardVersion), 4},
@@ -694,6 +715,77 @@ TEST(BalancerPolicy, BalancerHandlesNoShardsWithZone) {
     ASSERT(balanceChunks(cluster.first, distribution, false, false).first.empty());
 }
 
+TEST(BalancerPolicy, LoadAwareBalancingMovesHottestChunkToLeastLoadedShard) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, 3, false, emptyZoneSet, emptyShardVersion), 3},
+         {ShardStatistics(kShardId1, 3, false, emptyZoneSet, emptyShardVersion), 3}});
+    const auto& shard0Chunks = cluster.second[kShardId0];
+    const auto collDataSizeInfo = makeCollDataSizeInfoWithLoad(
+        cluster.first, {{shard0Chunks[0], 100}, {shard0Chunks[1], 1000}, {shard0Chunks[2], 900}});
+
+    auto availableShards = getAllShardIds(cluster.first);
+    const auto [migrations, reason] =
+        BalancerPolicy::balance(cluster.first,
+                                DistributionStatus(kNamespace, cluster.second),
+                                collDataSizeInfo,
+                                &availableShards,
+                                false);
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId1, migrations[0].to);
+    ASSERT_BSONOBJ_EQ(shard0Chunks[1].getMin(), migrations[0].minKey);
+    ASSERT_BSONOBJ_EQ(shard0Chunks[1].getMax(), *migrations[0].maxKey);
+    ASSERT_EQ(MigrationReason::loadImbalance, reason);
+}
+
+TEST(BalancerPolicy, LoadAwareBalancingDoesNotMoveHotSpotToReceiver) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, 2, false, emptyZoneSet, emptyShardVersion), 2},
+         {ShardStatistics(kShardId1, 2, false, emptyZoneSet, emptyShardVersion), 2}});
+    const auto& shard0Chunks = cluster.second[kShardId0];
+
+    // Moving the chunk which carries most of the load would make the receiver the most loaded
+    // shard, so only the colder chunk is a candidate
+    const auto collDataSizeInfo = makeCollDataSizeInfoWithLoad(
+        cluster.first, {{shard0Chunks[0], 5000}, {shard0Chunks[1], 100}});
+
+    auto availableShards = getAllShardIds(cluster.first);
+    const auto [migrations, reason] =
+        BalancerPolicy::balance(cluster.first,
+                                DistributionStatus(kNamespace, cluster.second),
+                                collDataSizeInfo,
+                                &availableShards,
+                                false);
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId1, migrations[0].to);
+    ASSERT_BSONOBJ_EQ(shard0Chunks[1].getMin(), migrations[0].minKey);
+    ASSERT_EQ(MigrationReason::loadImbalance, reason);
+}
+
+TEST(BalancerPolicy, LoadAwareBalancingThresholdObeyed) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, 2, false, emptyZoneSet, emptyShardVersion), 2},
+         {ShardStatistics(kShardId1, 2, false, emptyZoneSet, emptyShardVersion), 2}});
+    const auto& shard0Chunks = cluster.second[kShardId0];
+    const auto& shard1Chunks = cluster.second[kShardId1];
+    const auto collDataSizeInfo = makeCollDataSizeInfoWithLoad(cluster.first,
+                                                               {{shard0Chunks[0], 1000},
+                                                                {shard0Chunks[1], 1000},
+                                                                {shard1Chunks[0], 1000},
+                                                                {shard1Chunks[1], 500}});
+
+    auto availableShards = getAllShardIds(cluster.first);
+    const auto [migrations, reason] =
+        BalancerPolicy::balance(cluster.first,
+                                DistributionStatus(kNamespace, cluster.second),
+                                collDataSizeInfo,
+                                &availableShards,
+                                false);
+    ASSERT(migrations.empty());
+    ASSERT_EQ(MigrationReason::none, reason);
+}
+
 TEST(DistributionStatus, AddZoneRangeOverlap) {
     DistributionStatus d(kNamespace, ShardToChunksMap{});
 
@@ -0,0 +1,279 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/db/catalog/create_collection.h"
+#include "mongo/db/catalog_raii.h"
+#include "mongo/db/client.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/exec/queued_data_stage.h"
+#include "mongo/db/exec/shard_filter.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/s/collection_sharding_runtime.h"
+#include "mongo/db/s/operation_sharding_state.h"
+#include "mongo/db/s/shard_server_test_fixture.h"
+#include "mongo/idl/server_parameter_test_util.h"
+#include "mongo/s/request_types/get_stats_for_balancing_gen.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("TestDB", "TestColl");
+const KeyPattern kShardKeyPattern(BSON("key" << 1));
+
+/**
+ * Tests the sampling of the reads and writes which target each chunk, and how the sampled load is
+ * reported to the balancer.
+ */
+class ChunkOpSamplingTest : public ShardServerTestFixture {
+protected:
+    void setUp() override {
+        ShardServerTestFixture::setUp();
+
+        {
+            OperationShardingState::ScopedAllowImplicitCollectionCreate_UNSAFE
+                unsafeCreateCollection(operationContext());
+            uassertStatusOK(
+                createCollection(operationContext(), kNss.dbName(), BSON("create" << kNss.coll())));
+        }
+
+        const auto uuid = [&] {
+            AutoGetCollection autoColl(operationContext(), kNss, MODE_IX);
+            return autoColl.getCollection()->uuid();
+        }();
+
+        // This shard owns both chunks, [MinKey, 0) and [0, MaxKey).
+        const OID epoch = OID::gen();
+        const Timestamp timestamp(1);
+        auto rt = RoutingTableHistory::makeNew(
+            kNss,
+            uuid,
+            kShardKeyPattern,
+            nullptr,
+            false,
+            epoch,
+            timestamp,
+            boost::none /* timeseriesFields */,
+            boost::none /* resharding Fields */,
+            boost::none /* chunkSizeBytes */,
+            true,
+            {ChunkType{uuid,
+                       ChunkRange{BSON("key" << MINKEY), BSON("key" << 0)},
+                       ChunkVersion({epoch, timestamp}, {1, 0}),
+                       _myShardName},
+             ChunkType{uuid,
+                       ChunkRange{BSON("key" << 0), BSON("key" << MAXKEY)},
+                       ChunkVersion({epoch, timestamp}, {1, 1}),
+                       _myShardName}});
+
+        AutoGetDb autoDb(operationContext(), kNss.dbName(), MODE_IX);
+        Lock::CollectionLock collLock(operationContext(), kNss, MODE_IX);
+        CollectionShardingRuntime::assertCollectionLockedAndAcquire(
+            operationContext(), kNss, CSRAcquisitionMode::kExclusive)
+            ->setFilteringMetadata(
+                operationContext(),
+                CollectionMetadata(ChunkManager(_myShardName,
+                                                DatabaseVersion(UUID::gen(), Timestamp(1, 1)),
+                                                makeStandaloneRoutingTableHistory(std::move(rt)),
+                                                boost::none),
+                                   _myShardName));
+    }
+
+    /**
+     * Runs _shardsvrGetStatsForBalancing for the test collection and returns the load it reports
+     * on each chunk, or boost::none if it did not report any.
+     */
+    boost::optional<std::vector<RangeLoadForBalancing>> getRangeLoad(bool includeRangeLoad) {
+        BSONObjBuilder cmdBuilder;
+        cmdBuilder.append("_shardsvrGetStatsForBalancing", 1);
+        cmdBuilder.append("collections", BSON_ARRAY(BSON("ns" << kNss.ns())));
+        if (includeRangeLoad) {
+            cmdBuilder.append("includeRangeLoad", true);
+        }
+
+        DBDirectClient client(operationContext());
+        BSONObj result;
+        ASSERT(client.runCommand("admin", cmdBuilder.obj(), result)) << result;
+
+        auto reply = ShardsvrGetStatsForBalancingReply::parse(
+            IDLParserContext("ShardsvrGetStatsForBalancingReply"), result);
+        ASSERT_EQ(reply.getStats().size(), 1U);
+        return reply.getStats()[0].getRangeLoad();
+    }
+
+    /**
+     * Asserts that 'rangeLoad' reports the given reads and writes on the chunk starting at 'min',
+     * where a chunk which is not reported had no sampled operations.
+     */
+    static void assertLoadOfChunk(const std::vector<RangeLoadForBalancing>& rangeLoad,
+                                  const BSONObj& min,
+                                  long long reads,
+                                  long long writes) {
+        for (const auto& chunkLoad : rangeLoad) {
+            if (chunkLoad.getMin().woCompare(min) == 0) {
+                ASSERT_EQ(chunkLoad.getReads(), reads);
+                ASSERT_EQ(chunkLoad.getWrites(), writes);
+                return;
+            }
+        }
+        ASSERT_EQ(0, reads);
+        ASSERT_EQ(0, writes);
+    }
+
+    /**
+     * Passes documents with the given shard key values through a ShardFilterStage, as a single
+     * read operation of its own.
+     */
+    void readThroughShardFilter(const std::vector<int>& keys) {
+        auto client = getServiceContext()->makeClient("ChunkOpSamplingTestReader");
+        AlternativeClientRegion acr(client);
+        auto opCtx = cc().makeOperationContext();
+
+        AutoGetCollection autoColl(opCtx.get(), kNss, MODE_IS);
+        auto collectionFilter =
+            CollectionShardingRuntime::assertCollectionLockedAndAcquire(
+                opCtx.get(), kNss, CSRAcquisitionMode::kShared)
+                ->getOwnershipFilter(
+                    opCtx.get(),
+                    CollectionShardingState::OrphanCleanupPolicy::kDisallowOrphanCleanup,
+                    true /* supportNonVersionedOperations */);
+
+        auto expCtx = make_intrusive<ExpressionContext>(opCtx.get(), nullptr, kNss);
+        WorkingSet ws;
+        auto queuedDataStage = std::make_unique<QueuedDataStage>(expCtx.get(), &ws);
+        for (int key : keys) {
+            auto id = ws.allocate();
+            auto member = ws.get(id);
+            member->doc = {SnapshotId(), Document{{"_id", key}, {"key", key}}};
+            member->transitionToOwnedObj();
+            queuedDataStage->pushBack(id);
+        }
+
+        ShardFilterStage shardFilterStage(
+            expCtx.get(), std::move(collectionFilter), &ws, std::move(queuedDataStage));
+        WorkingSetID out;
+        size_t numReturned = 0;
+        for (auto state = shardFilterStage.work(&out); state != PlanStage::IS_EOF;
+             state = shardFilterStage.work(&out)) {
+            if (state == PlanStage::ADVANCED) {
+                ++numReturned;
+            }
+        }
+        ASSERT_EQ(numReturned, keys.size());
+    }
+};
+
+TEST_F(ChunkOpSamplingTest, ShardFilterSamplesTheFirstOwnedDocumentOfEachRead) {
+    RAIIServerParameterControllerForTest samplingInterval{"chunkOpSamplingInterval", 1};
+
+    readThroughShardFilter({-1, 1, 2});
+    readThroughShardFilter({-2, -1});
+    readThroughShardFilter({1, -1});
+
+    auto rangeLoad = getRangeLoad(true /* includeRangeLoad */);
+    ASSERT(rangeLoad);
+    ASSERT_EQ(rangeLoad->size(), 2U);
+    assertLoadOfChunk(*rangeLoad, BSON("key" << MINKEY), 2, 0);
+    assertLoadOfChunk(*rangeLoad, BSON("key" << 0), 1, 0);
+}
+
+TEST_F(ChunkOpSamplingTest, ShardFilterDoesNotSampleWhenSamplingIsDisabled) {
+    readThroughShardFilter({-1, 1});
+
+    auto rangeLoad = getRangeLoad(true /* includeRangeLoad */);
+    ASSERT(rangeLoad);
+    ASSERT(rangeLoad->empty());
+}
+
+TEST_F(ChunkOpSamplingTest, OpObserverSamplesEachWrittenDocument) {
+    RAIIServerParameterControllerForTest samplingInterval{"chunkOpSamplingInterval", 1};
+
+    DBDirectClient client(operationContext());
+    client.insert(kNss.ns(),
+                  std::vector<BSONObj>{BSON("_id" << -1 << "key" << -1),
+                                       BSON("_id" << 1 << "key" << 1),
+                                       BSON("_id" << 2 << "key" << 2)});
+    client.update(kNss.ns(), BSON("_id" << 1), BSON("$set" << BSON("x" << 1)));
+
+    auto rangeLoad = getRangeLoad(true /* includeRangeLoad */);
+    ASSERT(rangeLoad);
+    assertLoadOfChunk(*rangeLoad, BSON("key" << MINKEY), 0, 1);
+    assertLoadOfChunk(*rangeLoad, BSON("key" << 0), 0, 3);
+}
+
+TEST_F(ChunkOpSamplingTest, OpObserverSamplesDeletes) {
+    DBDirectClient client(operationContext());
+    client.insert(kNss.ns(),
+                  std::vector<BSONObj>{BSON("_id" << -1 << "key" << -1),
+                                       BSON("_id" << 1 << "key" << 1),
+                                       BSON("_id" << 2 << "key" << 2),
+                                       BSON("_id" << 3 << "key" << 3),
+                                       BSON("_id" << 4 << "key" << 4)});
+
+    // Only one in every two deletes is sampled, and each sample stands for two deletes.
+    RAIIServerParameterControllerForTest samplingInterval{"chunkOpSamplingInterval", 2};
+    client.remove(kNss.ns(), BSON("key" << BSON("$gt" << 0)));
+
+    auto rangeLoad = getRangeLoad(true /* includeRangeLoad */);
+    ASSERT(rangeLoad);
+    ASSERT_EQ(rangeLoad->size(), 1U);
+    assertLoadOfChunk(*rangeLoad, BSON("key" << 0), 0, 4);
+}
+
+TEST_F(ChunkOpSamplingTest, GetStatsForBalancingResetsTheReportedLoad) {
+    RAIIServerParameterControllerForTest samplingInterval{"chunkOpSamplingInterval", 1};
+
+    DBDirectClient client(operationContext());
+    client.insert(kNss.ns(), BSON("_id" << 1 << "key" << 1));
+    readThroughShardFilter({1});
+
+    // Requests which do not ask for the load neither report nor reset it.
+    ASSERT_FALSE(getRangeLoad(false /* includeRangeLoad */));
+
+    auto rangeLoad = getRangeLoad(true /* includeRangeLoad */);
+    ASSERT(rangeLoad);
+    ASSERT_EQ(rangeLoad->size(), 1U);
+    ASSERT_BSONOBJ_EQ(rangeLoad->front().getMin(), BSON("key" << 0));
+    ASSERT_BSONOBJ_EQ(rangeLoad->front().getMax(), BSON("key" << MAXKEY));
+    assertLoadOfChunk(*rangeLoad, BSON("key" << 0), 1, 1);
+
+    rangeLoad = getRangeLoad(true /* includeRangeLoad */);
+    ASSERT(rangeLoad);
+    ASSERT(rangeLoad->empty());
+
+    readThroughShardFilter({1});
+    rangeLoad = getRangeLoad(true /* includeRangeLoad */);
+    ASSERT(rangeLoad);
+    assertLoadOfChunk(*rangeLoad, BSON("key" << 0), 1, 0);
+}
+
+}  // namespace
+}  // namespace mongo
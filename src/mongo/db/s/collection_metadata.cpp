@@ -37,6 +37,7 @@
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/bson/util/builder.h"
 #include "mongo/db/bson/dotted_path_support.h"
+#include "mongo/db/s/sharding_api_d_params_gen.h"
 #include "mongo/logv2/log.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/util/str.h"
@@ -55,6 +56,19 @@ bool CollectionMetadata::allowMigrations() const {
     return _cm ? _cm->allowMigrations() : true;
 }
 
+void CollectionMetadata::sampleChunkOp(const BSONObj& key,
+                                       ChunkWritesTracker::OpType opType) const {
+    invariant(isSharded());
+
+    const int samplingInterval = chunkOpSamplingInterval.load();
+    if (!ChunkWritesTracker::shouldSampleOp(samplingInterval)) {
+        return;
+    }
+
+    _cm->findIntersectingChunkWithSimpleCollation(key).getWritesTracker()->addSampledOp(
+        opType, samplingInterval);
+}
+
 boost::optional<ShardKeyPattern> CollectionMetadata::getReshardingKeyIfShouldForwardOps() const {
     if (!isSharded())
         return boost::none;
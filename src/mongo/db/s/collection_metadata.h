@@ -31,6 +31,7 @@
 
 #include "mongo/db/range_arithmetic.h"
 #include "mongo/s/chunk_manager.h"
+#include "mongo/s/chunk_writes_tracker.h"
 
 namespace mongo {
 
@@ -184,6 +185,12 @@ public:
         return _cm->keyBelongsToShard(key, _thisShardId);
     }
 
+    /**
+     * Records the operation against the chunk which contains 'key' if chunk operation sampling is
+     * enabled and selects it. If key is not a valid shard key, the behaviour is undefined.
+     */
+    void sampleChunkOp(const BSONObj& key, ChunkWritesTracker::OpType opType) const;
+
     /**
      * Given a key 'lookupKey' in the shard key range, get the next chunk which overlaps or is
      * greater than this key.  Returns true if a chunk exists, false otherwise.
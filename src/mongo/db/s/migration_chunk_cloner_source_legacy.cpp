@@ -716,15 +716,41 @@ void MigrationChunkClonerSourceLegacy::_nextCloneBatchFromIndexScan(OperationCon
 }
 
 void MigrationChunkClonerSourceLegacy::_nextCloneBatchFromCloneRecordIds(
-    OperationContext* opCtx, const CollectionPtr& collection, BSONArrayBuilder* arrBuilder) {
+    OperationContext* opCtx,
+    const CollectionPtr& collection,
+    int partition,
+    int numPartitions,
+    BSONArrayBuilder* arrBuilder) {
     ElapsedTracker tracker(opCtx->getServiceContext()->getFastClockSource(),
                            internalQueryExecYieldIterations.load(),
                            Milliseconds(internalQueryExecYieldPeriodMS.load()));
 
     stdx::unique_lock<Latch> lk(_mutex);
-    auto iter = _cloneRecordIds.begin();
+    if (numPartitions > 1 && _cloneNumPartitions == 1) {
+        _clonePartitionBounds = computeCloneRecordIdPartitionBounds(_cloneRecordIds, numPartitions);
+        _cloneNumPartitions = numPartitions;
+    }
 
-    for (; iter != _cloneRecordIds.end(); ++iter) {
+    uassert(ErrorCodes::BadValue,
+            str::stream() << "Requested initial clone partition " << partition << " of "
+                          << numPartitions << " but the clone is being served in "
+                          << _cloneNumPartitions << " partitions",
+            numPartitions == _cloneNumPartitions && partition >= 0 && partition < numPartitions);
+
+    // Other partitions are erased concurrently while the mutex is released below, so only the
+    // iterators within this partition's range can be relied upon and its upper bound is compared
+    // by value instead.
+    const bool hasBounds = !_clonePartitionBounds.empty();
+    const auto firstIter = (hasBounds && partition > 0)
+        ? _cloneRecordIds.lower_bound(_clonePartitionBounds[partition - 1])
+        : _cloneRecordIds.begin();
+    const boost::optional<RecordId> upperBound = (hasBounds && partition < numPartitions - 1)
+        ? boost::make_optional(_clonePartitionBounds[partition])
+        : boost::none;
+
+    auto iter = firstIter;
+
+    for (; iter != _cloneRecordIds.end() && (!upperBound || *iter < *upperBound); ++iter) {
         // We must always make progress in this method by at least one document because empty
         // return indicates there is no more initial clone data.
         if (arrBuilder->arrSize() && tracker.intervalHasElapsed()) {
@@ -763,7 +789,7 @@ void MigrationChunkClonerSourceLegacy::_nextCloneBatchFromCloneRecordIds(
         }
     }
 
-    _cloneRecordIds.erase(_cloneRecordIds.begin(), iter);
+    _cloneRecordIds.erase(firstIter, iter);
 }
 
 uint64_t MigrationChunkClonerSourceLegacy::getCloneBatchBufferAllocationSize() {
@@ -778,11 +804,24 @@ uint64_t MigrationChunkClonerSourceLegacy::getCloneBatchBufferAllocationSize() {
 Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* opCtx,
                                                         const CollectionPtr& collection,
                                                         BSONArrayBuilder* arrBuilder) {
+    return nextCloneBatch(opCtx, collection, 0 /* partition */, 1 /* numPartitions */, arrBuilder);
+}
+
+Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* opCtx,
+                                                        const CollectionPtr& collection,
+                                                        int partition,
+                                                        int numPartitions,
+                                                        BSONArrayBuilder* arrBuilder) {
     dassert(opCtx->lockState()->isCollectionLockedForMode(nss(), MODE_IS));
 
     // If this chunk is too large to store records in _cloneRecordIds and the command args specify
-    // to attempt to move it, scan the collection directly.
+    // to attempt to move it, scan the collection directly. The index scan cannot be split, so the
+    // other partitions have nothing to return.
     if (_jumboChunkCloneState && _forceJumbo) {
+        if (partition > 0) {
+            return Status::OK();
+        }
+
         try {
             _nextCloneBatchFromIndexScan(opCtx, collection, arrBuilder);
             return Status::OK();
@@ -791,7 +830,11 @@ Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* opCtx,
         }
     }
 
-    _nextCloneBatchFromCloneRecordIds(opCtx, collection, arrBuilder);
+    try {
+        _nextCloneBatchFromCloneRecordIds(opCtx, collection, partition, numPartitions, arrBuilder);
+    } catch (const DBException& ex) {
+        return ex.toStatus();
+    }
     return Status::OK();
 }
 
@@ -1040,6 +1083,29 @@ Status MigrationChunkClonerSourceLegacy::_storeCurrentRecordId(OperationContext*
     return Status::OK();
 }
 
+std::vector<RecordId> computeCloneRecordIdPartitionBounds(const std::set<RecordId>& recordIds,
+                                                          int numPartitions) {
+    invariant(numPartitions >= 1);
+
+    std::vector<RecordId> bounds;
+    if (recordIds.empty()) {
+        return bounds;
+    }
+
+    bounds.reserve(numPartitions - 1);
+    const size_t numRecordIds = recordIds.size();
+    auto iter = recordIds.begin();
+    size_t pos = 0;
+    for (int i = 1; i < numPartitions; ++i) {
+        const size_t boundPos = numRecordIds * i / numPartitions;
+        std::advance(iter, boundPos - pos);
+        pos = boundPos;
+        bounds.push_back(*iter);
+    }
+
+    return bounds;
+}
+
 long long xferMods(BSONArrayBuilder* arr,
                    std::list<BSONObj>* modsList,
                    long long initialSize,
@@ -32,6 +32,7 @@
 #include <list>
 #include <memory>
 #include <set>
+#include <vector>
 
 #include "mongo/bson/bsonobj.h"
 #include "mongo/client/connection_string.h"
@@ -167,6 +168,20 @@ public:
                           const CollectionPtr& collection,
                           BSONArrayBuilder* arrBuilder);
 
+    /**
+     * Same as above, but only returns the documents whose record ids fall in the 'partition'-th of
+     * 'numPartitions' contiguous ranges of the record ids collected when the clone started. This
+     * lets the recipient fetch the initial clone over several concurrent _migrateClone streams,
+     * with at most one active caller per partition. All callers must use the same 'numPartitions'.
+     *
+     * Jumbo chunks, which are cloned through an index scan, are served entirely by partition 0.
+     */
+    Status nextCloneBatch(OperationContext* opCtx,
+                          const CollectionPtr& collection,
+                          int partition,
+                          int numPartitions,
+                          BSONArrayBuilder* arrBuilder);
+
     /**
      * Called by the recipient shard. Transfers the accummulated local mods from source to
      * destination. Must not be called before all cloned objects have been fetched through calls to
@@ -250,6 +265,8 @@ private:
 
     void _nextCloneBatchFromCloneRecordIds(OperationContext* opCtx,
                                            const CollectionPtr& collection,
+                                           int partition,
+                                           int numPartitions,
                                            BSONArrayBuilder* arrBuilder);
 
     /**
@@ -351,6 +368,12 @@ private:
     // List of record ids that needs to be transferred (initial clone)
     std::set<RecordId> _cloneRecordIds;
 
+    // Number of partitions the initial clone is served in and the first record id of every
+    // partition but the first one. Fixed by the first partitioned nextCloneBatch call, since the
+    // ranges must not move while the partitions are drained concurrently.
+    int _cloneNumPartitions{1};
+    std::vector<RecordId> _clonePartitionBounds;
+
     // The estimated average object size during the clone phase. Used for buffer size
     // pre-allocation (initial clone).
     uint64_t _averageObjectSizeForCloneRecordIds{0};
@@ -402,6 +425,15 @@ private:
     boost::optional<JumboChunkCloneState> _jumboChunkCloneState;
 };
 
+/**
+ * Splits the ordered 'recordIds' into 'numPartitions' contiguous ranges holding roughly the same
+ * number of entries and returns the first record id of every range but the first one. Ranges may
+ * be empty when there are fewer record ids than partitions. Returns an empty vector if 'recordIds'
+ * is empty.
+ */
+std::vector<RecordId> computeCloneRecordIdPartitionBounds(const std::set<RecordId>& recordIds,
+                                                          int numPartitions);
+
 /**
  * Appends to the builder the list of documents either deleted or modified during migration.
  * Entries appended to the builder are removed from the list.
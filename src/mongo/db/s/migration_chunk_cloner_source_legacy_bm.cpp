@@ -32,6 +32,8 @@
 #include <benchmark/benchmark.h>
 
 #include "migration_chunk_cloner_source_legacy.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/stdx/thread.h"
 
 namespace mongo {
 namespace {
@@ -75,5 +77,77 @@ void BM_xferDeletes(benchmark::State& state) {
 
 BENCHMARK(BM_xferDeletes)->ArgsProduct({{0, 25, 50, 75, 100}, {1, 1024, 2048}});
 
+std::set<RecordId> createCloneRecordIds(int numRecordIds) {
+    std::set<RecordId> recordIds;
+    for (int64_t i = 1; i <= numRecordIds; i++) {
+        recordIds.insert(RecordId(i));
+    }
+    return recordIds;
+}
+
+void BM_computeCloneRecordIdPartitionBounds(benchmark::State& state) {
+    const auto recordIds = createCloneRecordIds(state.range(0));
+    const int numPartitions = state.range(1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(computeCloneRecordIdPartitionBounds(recordIds, numPartitions));
+    }
+}
+
+BENCHMARK(BM_computeCloneRecordIdPartitionBounds)->ArgsProduct({{10000, 100000}, {2, 4, 8}});
+
+/**
+ * Mimics the donor serving a partitioned initial clone: every partition is drained by its own
+ * thread, which builds batches from its range of the shared record id set while releasing the
+ * mutex for each document fetch, the way _nextCloneBatchFromCloneRecordIds does.
+ */
+void BM_drainCloneRecordIdsInParallel(benchmark::State& state) {
+    const int numRecordIds = 100000;
+    const int numPartitions = state.range(0);
+    const int docSizeInBytes = state.range(1);
+    const int batchSize = 1000;
+    const BSONObj doc = createCollectionDocumentWithSize(0, docSizeInBytes);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto recordIds = createCloneRecordIds(numRecordIds);
+        const auto bounds = computeCloneRecordIdPartitionBounds(recordIds, numPartitions);
+        auto mutex = MONGO_MAKE_LATCH();
+        state.ResumeTiming();
+
+        std::vector<stdx::thread> threads;
+        for (int partition = 0; partition < numPartitions; partition++) {
+            threads.emplace_back([&, partition] {
+                while (true) {
+                    BSONArrayBuilder arrBuilder;
+                    stdx::unique_lock<Latch> lk(mutex);
+                    const auto firstIter = partition > 0
+                        ? recordIds.lower_bound(bounds[partition - 1])
+                        : recordIds.begin();
+                    auto iter = firstIter;
+                    for (; iter != recordIds.end() && arrBuilder.arrSize() < batchSize &&
+                         (partition == numPartitions - 1 || *iter < bounds[partition]);
+                         ++iter) {
+                        lk.unlock();
+                        arrBuilder.append(doc);
+                        lk.lock();
+                    }
+                    recordIds.erase(firstIter, iter);
+                    if (arrBuilder.arrSize() == 0) {
+                        return;
+                    }
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+}
+
+BENCHMARK(BM_drainCloneRecordIdsInParallel)
+    ->ArgsProduct({{1, 2, 4, 8}, {128, 1024}})
+    ->UseRealTime();
+
 }  // namespace
 }  // namespace mongo
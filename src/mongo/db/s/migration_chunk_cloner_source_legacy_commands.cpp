@@ -165,6 +165,17 @@ public:
         const MigrationSessionId migrationSessionId(
             uassertStatusOK(MigrationSessionId::extractFromBSON(cmdObj)));
 
+        // Recipients cloning over several concurrent streams request one partition of the initial
+        // clone each.
+        const int numPartitions =
+            cmdObj.hasField("numPartitions") ? cmdObj["numPartitions"].safeNumberInt() : 1;
+        const int partition =
+            cmdObj.hasField("partition") ? cmdObj["partition"].safeNumberInt() : 0;
+        uassert(ErrorCodes::BadValue,
+                str::stream() << "Invalid initial clone partition " << partition << " of "
+                              << numPartitions,
+                numPartitions >= 1 && partition >= 0 && partition < numPartitions);
+
         boost::optional<BSONArrayBuilder> arrBuilder;
 
         // Try to maximize on the size of the buffer, which we are returning in order to have less
@@ -181,7 +192,7 @@ public:
             arrSizeAtPrevIteration = arrBuilder->arrSize();
 
             uassertStatusOK(autoCloner.getCloner()->nextCloneBatch(
-                opCtx, autoCloner.getColl(), arrBuilder.get_ptr()));
+                opCtx, autoCloner.getColl(), partition, numPartitions, arrBuilder.get_ptr()));
         }
 
         invariant(arrBuilder);
@@ -378,6 +378,94 @@ TEST_F(MigrationChunkClonerSourceLegacyTest, CorrectDocumentsFetched) {
     futureCommit.default_timed_get();
 }
 
+TEST_F(MigrationChunkClonerSourceLegacyTest, PartitionedInitialCloneFetchesEveryDocumentOnce) {
+    std::vector<BSONObj> contents;
+    for (int i = 95; i < 205; ++i) {
+        contents.push_back(createCollectionDocument(i));
+    }
+
+    createShardedCollection(contents);
+
+    const ShardsvrMoveRange req =
+        createMoveRangeRequest(ChunkRange(BSON("X" << 100), BSON("X" << 200)));
+    MigrationChunkClonerSourceLegacy cloner(req,
+                                            WriteConcernOptions(),
+                                            kShardKeyPattern,
+                                            kDonorConnStr,
+                                            kRecipientConnStr.getServers()[0]);
+
+    {
+        auto futureStartClone = launchAsync([&]() {
+            onCommand([&](const RemoteCommandRequest& request) { return BSON("ok" << true); });
+        });
+
+        ASSERT_OK(cloner.startClone(operationContext(), UUID::gen(), _lsid, _txnNumber));
+        futureStartClone.default_timed_get();
+    }
+
+    {
+        AutoGetCollection autoColl(operationContext(), kNss, MODE_IS);
+
+        const int numPartitions = 3;
+        std::set<int> clonedValues;
+        for (int partition : {2, 0, 1}) {
+            while (true) {
+                BSONArrayBuilder arrBuilder;
+                ASSERT_OK(cloner.nextCloneBatch(operationContext(),
+                                                autoColl.getCollection(),
+                                                partition,
+                                                numPartitions,
+                                                &arrBuilder));
+                if (arrBuilder.arrSize() == 0) {
+                    break;
+                }
+
+                for (auto&& elem : arrBuilder.arr()) {
+                    ASSERT_TRUE(clonedValues.insert(elem.Obj()["X"].numberInt()).second);
+                }
+            }
+        }
+
+        ASSERT_EQ(100U, clonedValues.size());
+        ASSERT_EQ(100, *clonedValues.begin());
+        ASSERT_EQ(199, *clonedValues.rbegin());
+
+        // The number of partitions is fixed by the first partitioned request.
+        BSONArrayBuilder arrBuilder;
+        ASSERT_EQ(ErrorCodes::BadValue,
+                  cloner.nextCloneBatch(
+                      operationContext(), autoColl.getCollection(), 0, 2, &arrBuilder));
+    }
+
+    auto futureCommit = launchAsync([&]() {
+        onCommand([&](const RemoteCommandRequest& request) { return BSON("ok" << true); });
+    });
+
+    ASSERT_OK(cloner.commitClone(operationContext()));
+    futureCommit.default_timed_get();
+}
+
+TEST(ComputeCloneRecordIdPartitionBoundsTest, SplitsIntoEvenContiguousRanges) {
+    std::set<RecordId> recordIds;
+    for (int64_t i = 1; i <= 10; ++i) {
+        recordIds.insert(RecordId(i * 10));
+    }
+
+    ASSERT_TRUE(computeCloneRecordIdPartitionBounds(recordIds, 1).empty());
+    ASSERT_TRUE(computeCloneRecordIdPartitionBounds({}, 4).empty());
+
+    const auto bounds = computeCloneRecordIdPartitionBounds(recordIds, 3);
+    ASSERT_EQ(2U, bounds.size());
+    ASSERT_EQ(RecordId(40), bounds[0]);
+    ASSERT_EQ(RecordId(70), bounds[1]);
+
+    // With fewer record ids than partitions, some of the ranges are empty.
+    const auto sparseBounds = computeCloneRecordIdPartitionBounds({RecordId(5)}, 3);
+    ASSERT_EQ(2U, sparseBounds.size());
+    ASSERT_EQ(RecordId(5), sparseBounds[0]);
+    ASSERT_EQ(RecordId(5), sparseBounds[1]);
+}
+
 
 TEST_F(MigrationChunkClonerSourceLegacyTest, RemoveDuplicateDocuments) {
     const std::vector<BSONObj> contents = {createCollectionDocument(100),
@@ -157,6 +157,59 @@ void runWithoutSession(OperationContext* opCtx, Callable&& callable) {
     checkOutSessionAndVerifyTxnState(opCtx);
 }
 
+/**
+ * Lets several clone streams run functions without the outer operation's session checked out at
+ * the same time. The first stream to start checks the session in and the last one to finish
+ * checks it out again, so that the streams do not wait for each other while, for example, they
+ * wait for replication.
+ */
+class SharedSessionYield {
+public:
+    explicit SharedSessionYield(OperationContext* outerOpCtx) : _outerOpCtx(outerOpCtx) {}
+
+    template <typename Callable>
+    void runWithoutSession(Callable&& callable) {
+        {
+            stdx::lock_guard<Latch> lk(_mutex);
+            ++_numRunning;
+            if (!_sessionCheckedIn) {
+                MongoDSessionCatalog::get(_outerOpCtx)
+                    ->checkInUnscopedSession(_outerOpCtx,
+                                             OperationContextSession::CheckInReason::kYield);
+                _sessionCheckedIn = true;
+            }
+        }
+
+        try {
+            callable();
+        } catch (...) {
+            // Same as runWithoutSession above, the session is not reacquired on error.
+            stdx::lock_guard<Latch> lk(_mutex);
+            --_numRunning;
+            throw;
+        }
+
+        // The below code can throw, so it cannot run in a scope guard.
+        stdx::lock_guard<Latch> lk(_mutex);
+        if (--_numRunning == 0) {
+            _outerOpCtx->checkForInterrupt();
+            checkOutSessionAndVerifyTxnState(_outerOpCtx);
+            _sessionCheckedIn = false;
+        }
+    }
+
+private:
+    OperationContext* const _outerOpCtx;
+
+    Mutex _mutex = MONGO_MAKE_LATCH("SharedSessionYield::_mutex");
+
+    // The number of streams currently running without the session.
+    int _numRunning{0};
+
+    // Whether the session is currently checked in on behalf of the streams.
+    bool _sessionCheckedIn{false};
+};
+
 /**
  * Returns a human-readabale name of the migration manager's state.
  */
@@ -257,11 +310,20 @@ bool opReplicatedEnough(OperationContext* opCtx,
  * Create the migration clone request BSON object to send to the source shard.
  *
  * 'sessionId' unique identifier for this migration.
+ * 'partition' the partition of the initial clone to fetch, out of 'numPartitions'. The partition
+ * fields are omitted when cloning over a single stream.
  */
-BSONObj createMigrateCloneRequest(const NamespaceString& nss, const MigrationSessionId& sessionId) {
+BSONObj createMigrateCloneRequest(const NamespaceString& nss,
+                                  const MigrationSessionId& sessionId,
+                                  int partition,
+                                  int numPartitions) {
     BSONObjBuilder builder;
     builder.append("_migrateClone", nss.ns());
     sessionId.append(&builder);
+    if (numPartitions > 1) {
+        builder.append("partition", partition);
+        builder.append("numPartitions", numPartitions);
+    }
     return builder.obj();
 }
 
@@ -488,6 +550,7 @@ Status MigrationDestinationManager::start(OperationContext* opCtx,
     _min = cloneRequest.getMinKey();
     _max = cloneRequest.getMaxKey();
     _shardKeyPattern = cloneRequest.getShardKeyPattern();
+    _donorSupportsPartitionedClone = cloneRequest.getSupportsPartitionedClone();
 
     _epoch = epoch;
 
@@ -640,6 +703,74 @@ repl::OpTime MigrationDestinationManager::fetchAndApplyBatch(
     return lastOpApplied;
 }
 
+repl::OpTime MigrationDestinationManager::fetchAndApplyBatchesInParallel(
+    OperationContext* opCtx,
+    int numStreams,
+    std::function<bool(OperationContext*, BSONObj)> applyBatchFn,
+    std::function<bool(OperationContext*, int, BSONObj*)> fetchBatchFn) {
+    invariant(numStreams >= 1);
+
+    if (numStreams == 1) {
+        return fetchAndApplyBatch(
+            opCtx, applyBatchFn, [&](OperationContext* opCtx, BSONObj* nextBatch) {
+                return fetchBatchFn(opCtx, 0, nextBatch);
+            });
+    }
+
+    // Interrupts the remaining streams as soon as one of them fails.
+    CancellationSource streamsCancellationSource(opCtx->getCancellationToken());
+    auto executor = Grid::get(opCtx->getServiceContext())->getExecutorPool()->getFixedExecutor();
+
+    auto mutex = MONGO_MAKE_LATCH("MigrationDestinationManager::fetchAndApplyBatchesInParallel");
+    Status firstError = Status::OK();
+    repl::OpTime lastOpApplied;
+
+    std::vector<stdx::thread> streamThreads;
+    streamThreads.reserve(numStreams);
+    for (int stream = 0; stream < numStreams; ++stream) {
+        streamThreads.emplace_back([&, stream] {
+            Client::initThread("migrateCloneStream-" + std::to_string(stream),
+                               opCtx->getServiceContext(),
+                               nullptr);
+            auto client = Client::getCurrent();
+            {
+                stdx::lock_guard lk(*client);
+                client->setSystemOperationKillableByStepdown(lk);
+            }
+            auto streamOpCtx = CancelableOperationContext(
+                cc().makeOperationContext(), streamsCancellationSource.token(), executor);
+
+            try {
+                const auto streamLastOpApplied = fetchAndApplyBatch(
+                    streamOpCtx.get(),
+                    applyBatchFn,
+                    [&](OperationContext* opCtx, BSONObj* nextBatch) {
+                        return fetchBatchFn(opCtx, stream, nextBatch);
+                    });
+
+                stdx::lock_guard lk(mutex);
+                lastOpApplied = std::max(lastOpApplied, streamLastOpApplied);
+            } catch (...) {
+                {
+                    stdx::lock_guard lk(mutex);
+                    if (firstError.isOK()) {
+                        firstError = exceptionToStatus();
+                    }
+                }
+                streamsCancellationSource.cancel();
+            }
+        });
+    }
+
+    for (auto& streamThread : streamThreads) {
+        streamThread.join();
+    }
+
+    opCtx->checkForInterrupt();
+    uassertStatusOK(firstError);
+    return lastOpApplied;
+}
+
 Status MigrationDestinationManager::abort(const MigrationSessionId& sessionId) {
     stdx::lock_guard<Latch> sl(_mutex);
 
@@ -1357,7 +1488,25 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* outerOpCtx,
 
             _sessionMigration->start(opCtx->getServiceContext());
 
-            const BSONObj migrateCloneRequest = createMigrateCloneRequest(_nss, *_sessionId);
+            // A donor which does not know about partitioned cloning would ignore the partition
+            // of each request and return the same documents to every stream.
+            int numCloneStreams = migrateCloneNumParallelStreams.load();
+            if (numCloneStreams > 1 && !_donorSupportsPartitionedClone) {
+                LOGV2(7095767,
+                      "Donor shard does not support partitioned cloning, cloning with one stream",
+                      "migrationId"_attr = _migrationId->toBSON(),
+                      "fromShard"_attr = _fromShard,
+                      "migrateCloneNumParallelStreams"_attr = numCloneStreams);
+                numCloneStreams = 1;
+            }
+            std::vector<BSONObj> migrateCloneRequests;
+            for (int stream = 0; stream < numCloneStreams; ++stream) {
+                migrateCloneRequests.push_back(
+                    createMigrateCloneRequest(_nss, *_sessionId, stream, numCloneStreams));
+            }
+
+            // The clone streams share the outer session while they wait for replication.
+            SharedSessionYield sessionYield(outerOpCtx);
 
             _chunkMarkedPending = true;  // no lock needed, only the migrate thread looks.
 
@@ -1425,7 +1574,7 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* outerOpCtx,
                         _clonedBytes += batchClonedBytes;
                     }
                     if (_writeConcern.needToWaitForOtherNodes()) {
-                        runWithoutSession(outerOpCtx, [&] {
+                        sessionYield.runWithoutSession([&] {
                             repl::ReplicationCoordinator::StatusAndDuration replStatus =
                                 repl::ReplicationCoordinator::get(opCtx)->awaitReplication(
                                     opCtx,
@@ -1447,12 +1596,12 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* outerOpCtx,
                 return true;
             };
 
-            auto fetchBatchFn = [&](OperationContext* opCtx, BSONObj* nextBatch) {
+            auto fetchBatchFn = [&](OperationContext* opCtx, int stream, BSONObj* nextBatch) {
                 auto commandResponse = uassertStatusOKWithContext(
                     fromShard->runCommand(opCtx,
                                           ReadPreferenceSetting(ReadPreference::PrimaryOnly),
                                           "admin",
-                                          migrateCloneRequest,
+                                          migrateCloneRequests[stream],
                                           Shard::RetryPolicy::kNoRetry),
                     "_migrateClone failed: ");
 
@@ -1466,7 +1615,8 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* outerOpCtx,
 
             // If running on a replicated system, we'll need to flush the docs we cloned to the
             // secondaries
-            lastOpApplied = fetchAndApplyBatch(opCtx, insertBatchFn, fetchBatchFn);
+            lastOpApplied = fetchAndApplyBatchesInParallel(
+                opCtx, numCloneStreams, insertBatchFn, fetchBatchFn);
 
             timing->done(4);
             migrateThreadHangAtStep4.pauseWhileSet();
@@ -143,6 +143,18 @@ public:
         std::function<bool(OperationContext*, BSONObj)> applyBatchFn,
         std::function<bool(OperationContext*, BSONObj*)> fetchBatchFn);
 
+    /**
+     * Clones documents from a donor shard over 'numStreams' concurrent fetch and apply pipelines,
+     * each running on its own thread with its own operation context. 'fetchBatchFn' is given the
+     * index of the stream it fetches for. If any stream fails, the others are interrupted and its
+     * error is rethrown on the calling thread.
+     */
+    static repl::OpTime fetchAndApplyBatchesInParallel(
+        OperationContext* opCtx,
+        int numStreams,
+        std::function<bool(OperationContext*, BSONObj)> applyBatchFn,
+        std::function<bool(OperationContext*, int, BSONObj*)> fetchBatchFn);
+
     /**
      * Idempotent method, which causes the current ongoing migration to abort only if it has the
      * specified session id. If the migration is already aborted, does nothing.
@@ -295,6 +307,9 @@ private:
     BSONObj _max;
     BSONObj _shardKeyPattern;
 
+    // Whether the donor can split the initial clone between several parallel streams.
+    bool _donorSupportsPartitionedClone{false};
+
     OID _epoch;
 
     WriteConcernOptions _writeConcern;
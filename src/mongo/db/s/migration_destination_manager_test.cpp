@@ -165,6 +165,73 @@ TEST_F(MigrationDestinationManagerTest, CloneDocumentsCatchesInsertErrors) {
     ASSERT_EQ(operationContext()->getKillStatus(), 51008);
 }
 
+// Tests that every stream of a parallel clone ferries its own documents to the insert logic.
+TEST_F(MigrationDestinationManagerTest, CloneDocumentsOverParallelStreamsWorksCorrectly) {
+    const int numStreams = 3;
+    // Each stream only touches its own entry, so this must not be a std::vector<bool>.
+    std::vector<char> ranOnce(numStreams, false);
+
+    auto fetchBatchFn = [&](OperationContext* opCtx, int stream, BSONObj* nextBatch) {
+        BSONObjBuilder fetchBatchResultBuilder;
+
+        if (ranOnce[stream]) {
+            fetchBatchResultBuilder.append("objects", BSONObj());
+        } else {
+            ranOnce[stream] = true;
+            BSONArrayBuilder arrayBuilder;
+            arrayBuilder.append(createDocument(stream));
+            fetchBatchResultBuilder.append("objects", arrayBuilder.arr());
+        }
+
+        *nextBatch = fetchBatchResultBuilder.obj();
+        return nextBatch->getField("objects").Obj().isEmpty();
+    };
+
+    auto mutex = MONGO_MAKE_LATCH();
+    std::set<int> resultValues;
+
+    auto insertBatchFn = [&](OperationContext* opCtx, BSONObj docs) {
+        auto arr = docs["objects"].Obj();
+        if (arr.isEmpty())
+            return false;
+        stdx::lock_guard<Latch> lk(mutex);
+        for (auto&& docToClone : arr) {
+            resultValues.insert(docToClone.Obj()["X"].numberInt());
+        }
+        return true;
+    };
+
+    MigrationDestinationManager::fetchAndApplyBatchesInParallel(
+        operationContext(), numStreams, insertBatchFn, fetchBatchFn);
+
+    ASSERT_EQ(std::set<int>({0, 1, 2}), resultValues);
+}
+
+// Tests that an exception in the fetch logic of one stream interrupts the other streams and is
+// rethrown on the main thread.
+TEST_F(MigrationDestinationManagerTest, CloneDocumentsOverParallelStreamsThrowsFetchErrors) {
+    auto fetchBatchFn = [&](OperationContext* opCtx, int stream, BSONObj* nextBatch) {
+        if (stream == 1) {
+            uasserted(ErrorCodes::NetworkTimeout, "network error");
+        }
+
+        // The other streams keep returning documents until they get interrupted.
+        opCtx->checkForInterrupt();
+        BSONObjBuilder fetchBatchResultBuilder;
+        fetchBatchResultBuilder.append("objects", createDocumentsToCloneArray());
+        *nextBatch = fetchBatchResultBuilder.obj();
+        return nextBatch->getField("objects").Obj().isEmpty();
+    };
+
+    auto insertBatchFn = [&](OperationContext* opCtx, BSONObj docs) { return true; };
+
+    ASSERT_THROWS_CODE_AND_WHAT(MigrationDestinationManager::fetchAndApplyBatchesInParallel(
+                                    operationContext(), 3, insertBatchFn, fetchBatchFn),
+                                DBException,
+                                ErrorCodes::NetworkTimeout,
+                                "network error");
+}
+
 using MigrationDestinationManagerNetworkTest = CatalogCacheTestFixture;
 
 // Verifies MigrationDestinationManager::getCollectionOptions() and
@@ -38,6 +38,7 @@
 #include "mongo/db/concurrency/exception_util.h"
 #include "mongo/db/concurrency/lock_state.h"
 #include "mongo/db/dbhelpers.h"
+#include "mongo/db/exec/batched_delete_stage.h"
 #include "mongo/db/exec/delete_stage.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/index/index_descriptor.h"
@@ -75,18 +76,30 @@ MONGO_FAIL_POINT_DEFINE(suspendRangeDeletion);
 MONGO_FAIL_POINT_DEFINE(throwWriteConflictExceptionInDeleteRange);
 MONGO_FAIL_POINT_DEFINE(throwInternalErrorInDeleteRange);
 
+struct DeleteBatchResult {
+    // Number of documents removed by the batch.
+    int numDeleted;
+
+    // True if the scan over the range reached its end, so no documents are left to delete.
+    bool rangeExhausted;
+};
+
 /**
  * Performs the deletion of up to numDocsToRemovePerBatch entries within the range in progress. Must
  * be called under the collection lock.
  *
- * Returns the number of documents deleted, 0 if done with the range, or bad status if deleting
- * the range failed.
+ * When 'rangeDeleterUseBatchedDeletes' is set, the documents are removed by a BATCHED_DELETE stage,
+ * which groups many removals in a single write unit of work and applyOps oplog entry, and the
+ * batch may slightly exceed numDocsToRemovePerBatch.
+ *
+ * Returns the number of documents deleted and whether the range was exhausted, or bad status if
+ * deleting the range failed.
  */
-StatusWith<int> deleteNextBatch(OperationContext* opCtx,
-                                const CollectionPtr& collection,
-                                BSONObj const& keyPattern,
-                                ChunkRange const& range,
-                                int numDocsToRemovePerBatch) {
+StatusWith<DeleteBatchResult> deleteNextBatch(OperationContext* opCtx,
+                                              const CollectionPtr& collection,
+                                              BSONObj const& keyPattern,
+                                              ChunkRange const& range,
+                                              int numDocsToRemovePerBatch) {
     invariant(collection);
 
     auto const nss = collection->ns();
@@ -121,16 +134,26 @@ StatusWith<int> deleteNextBatch(OperationContext* opCtx,
                 "max"_attr = max,
                 "namespace"_attr = nss.ns());
 
+    // Batched deletes cannot save the removed documents for moveParanoia.
+    const bool useBatchedDeletes =
+        rangeDeleterUseBatchedDeletes.load() && !serverGlobalParams.moveParanoia;
+
     auto deleteStageParams = std::make_unique<DeleteStageParams>();
     deleteStageParams->fromMigrate = true;
     deleteStageParams->isMulti = true;
-    deleteStageParams->returnDeleted = true;
+    deleteStageParams->returnDeleted = !useBatchedDeletes;
 
     if (serverGlobalParams.moveParanoia) {
         deleteStageParams->removeSaver =
             std::make_unique<RemoveSaver>("moveChunk", nss.ns(), "cleaning");
     }
 
+    std::unique_ptr<BatchedDeleteStageParams> batchedDeleteParams;
+    if (useBatchedDeletes) {
+        batchedDeleteParams = std::make_unique<BatchedDeleteStageParams>();
+        batchedDeleteParams->targetPassDocs = numDocsToRemovePerBatch;
+    }
+
     auto exec =
         InternalPlanner::deleteWithShardKeyIndexScan(opCtx,
                                                      &collection,
@@ -140,30 +163,17 @@ StatusWith<int> deleteNextBatch(OperationContext* opCtx,
                                                      max,
                                                      BoundInclusion::kIncludeStartKeyOnly,
                                                      PlanYieldPolicy::YieldPolicy::YIELD_AUTO,
-                                                     InternalPlanner::FORWARD);
+                                                     InternalPlanner::FORWARD,
+                                                     std::move(batchedDeleteParams));
 
     if (MONGO_unlikely(hangBeforeDoingDeletion.shouldFail())) {
         LOGV2(23768, "Hit hangBeforeDoingDeletion failpoint");
         hangBeforeDoingDeletion.pauseWhileSet(opCtx);
     }
 
-    int numDeleted = 0;
-    do {
-        BSONObj deletedObj;
-
-        if (throwWriteConflictExceptionInDeleteRange.shouldFail()) {
-            throwWriteConflictException(
-                str::stream() << "Hit failpoint '"
-                              << throwWriteConflictExceptionInDeleteRange.getName() << "'.");
-        }
-
-        if (throwInternalErrorInDeleteRange.shouldFail()) {
-            uasserted(ErrorCodes::InternalError, "Failing for test");
-        }
-
-        PlanExecutor::ExecState state;
+    const auto getNextWithLogging = [&](BSONObj* deletedObj) {
         try {
-            state = exec->getNext(&deletedObj, nullptr);
+            return exec->getNext(deletedObj, nullptr);
         } catch (const DBException& ex) {
             auto&& explainer = exec->getPlanExplainer();
             auto&& [stats, _] =
@@ -179,9 +189,49 @@ StatusWith<int> deleteNextBatch(OperationContext* opCtx,
                           "error"_attr = redact(ex.toStatus()));
             throw;
         }
+    };
+
+    if (useBatchedDeletes) {
+        if (throwWriteConflictExceptionInDeleteRange.shouldFail()) {
+            throwWriteConflictException(
+                str::stream() << "Hit failpoint '"
+                              << throwWriteConflictExceptionInDeleteRange.getName() << "'.");
+        }
+
+        if (throwInternalErrorInDeleteRange.shouldFail()) {
+            uasserted(ErrorCodes::InternalError, "Failing for test");
+        }
+
+        // The batched delete stage never returns documents, it runs the whole pass to EOF.
+        BSONObj unused;
+        invariant(PlanExecutor::IS_EOF == getNextWithLogging(&unused));
+
+        const auto batchedDeleteStats = exec->getBatchedDeleteStats();
+        const int numDeleted = batchedDeleteStats.docsDeleted;
+        ShardingStatistics::get(opCtx).countDocsDeletedOnDonor.addAndFetch(numDeleted);
+
+        // A pass target met implies there may be more to delete.
+        return DeleteBatchResult{numDeleted, !batchedDeleteStats.passTargetMet};
+    }
+
+    int numDeleted = 0;
+    do {
+        BSONObj deletedObj;
+
+        if (throwWriteConflictExceptionInDeleteRange.shouldFail()) {
+            throwWriteConflictException(
+                str::stream() << "Hit failpoint '"
+                              << throwWriteConflictExceptionInDeleteRange.getName() << "'.");
+        }
+
+        if (throwInternalErrorInDeleteRange.shouldFail()) {
+            uasserted(ErrorCodes::InternalError, "Failing for test");
+        }
+
+        const auto state = getNextWithLogging(&deletedObj);
 
         if (state == PlanExecutor::IS_EOF) {
-            break;
+            return DeleteBatchResult{numDeleted, true /* rangeExhausted */};
         }
 
         invariant(PlanExecutor::ADVANCED == state);
@@ -189,7 +239,7 @@ StatusWith<int> deleteNextBatch(OperationContext* opCtx,
 
     } while (++numDeleted < numDocsToRemovePerBatch);
 
-    return numDeleted;
+    return DeleteBatchResult{numDeleted, false /* rangeExhausted */};
 }
 
 void ensureRangeDeletionTaskStillExists(OperationContext* opCtx,
@@ -342,6 +392,7 @@ Status deleteRangeInBatches(OperationContext* opCtx,
             markRangeDeletionTaskAsProcessing(opCtx, collectionUuid, range);
 
             int numDeleted;
+            bool rangeExhausted;
             const auto nss = [&]() {
                 try {
                     AutoGetCollection collection(
@@ -356,11 +407,14 @@ Status deleteRangeInBatches(OperationContext* opCtx,
                                 "numDocsToRemovePerBatch"_attr = numDocsToRemovePerBatch,
                                 "delayBetweenBatches"_attr = delayBetweenBatches);
 
-                    numDeleted = uassertStatusOK(deleteNextBatch(opCtx,
-                                                                 collection.getCollection(),
-                                                                 keyPattern,
-                                                                 range,
-                                                                 numDocsToRemovePerBatch));
+                    const auto batchResult =
+                        uassertStatusOK(deleteNextBatch(opCtx,
+                                                        collection.getCollection(),
+                                                        keyPattern,
+                                                        range,
+                                                        numDocsToRemovePerBatch));
+                    numDeleted = batchResult.numDeleted;
+                    rangeExhausted = batchResult.rangeExhausted;
 
                     return collection.getNss();
                 } catch (const ExceptionFor<ErrorCodes::NamespaceNotFound>&) {
@@ -393,7 +447,7 @@ Status deleteRangeInBatches(OperationContext* opCtx,
                 opCtx->sleepFor(delayBetweenBatches);
             }
 
-            allDocsRemoved = numDeleted < numDocsToRemovePerBatch;
+            allDocsRemoved = rangeExhausted;
         } catch (const DBException& ex) {
             // Errors other than those indicating stepdown and those that indicate that the
             // range deletion can no longer occur should be retried.
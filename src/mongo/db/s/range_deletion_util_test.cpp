@@ -42,6 +42,7 @@
 #include "mongo/db/s/shard_server_test_fixture.h"
 #include "mongo/db/s/sharding_runtime_d_params_gen.h"
 #include "mongo/db/vector_clock.h"
+#include "mongo/idl/server_parameter_test_util.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/util/fail_point.h"
 
@@ -518,6 +519,40 @@ TEST_F(RangeDeleterTest, RemoveDocumentsInRangeWaitsForReplicationOnlyOnceAfterS
     ASSERT_EQ(numTimesWaitedForReplication, expectedNumTimesWaitedForReplication);
 }
 
+TEST_F(RangeDeleterTest, RemoveDocumentsInRangeWithBatchedDeletes) {
+    RAIIServerParameterControllerForTest useBatchedDeletes{"rangeDeleterUseBatchedDeletes", true};
+
+    const auto numDocsToRemovePerBatch = 3;
+    rangeDeleterBatchSize.store(numDocsToRemovePerBatch);
+
+    setFilteringMetadataWithUUID(uuid());
+    DBDirectClient dbclient(_opCtx);
+    for (auto i = 0; i < 10; ++i) {
+        dbclient.insert(kNss.toString(), BSON(kShardKey << i));
+    }
+    // A document outside of the range, which must not be deleted.
+    dbclient.insert(kNss.toString(), BSON(kShardKey << 20));
+
+    // Insert range deletion task for this collection and range.
+    const ChunkRange range(BSON(kShardKey << 0), BSON(kShardKey << 10));
+    auto t = insertRangeDeletionTask(_opCtx, uuid(), range);
+
+    auto queriesComplete = SemiFuture<void>::makeReady();
+    auto cleanupComplete =
+        removeDocumentsInRange(executor(),
+                               std::move(queriesComplete),
+                               kNss,
+                               uuid(),
+                               kShardKeyPattern,
+                               range,
+                               Seconds(0) /* delayForActiveQueriesOnSecondariesToComplete */);
+
+    cleanupComplete.get();
+
+    ASSERT_EQUALS(dbclient.count(kNss, BSONObj()), 1);
+    ASSERT_BSONOBJ_EQ(dbclient.findOne(kNss, BSONObj{}), BSON(kShardKey << 20));
+}
+
 TEST_F(RangeDeleterTest, RemoveDocumentsInRangeDoesNotWaitForReplicationIfErrorDuringDeletion) {
     auto replCoord = checked_cast<repl::ReplicationCoordinatorMock*>(
         repl::ReplicationCoordinator::get(getServiceContext()));
@@ -32,6 +32,7 @@
 
 #include "mongo/db/s/resharding/resharding_collection_cloner.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "mongo/bson/json.h"
@@ -40,6 +41,8 @@
 #include "mongo/db/client.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/exec/document_value/document.h"
+#include "mongo/db/exec/document_value/value_comparator.h"
+#include "mongo/db/persistent_task_store.h"
 #include "mongo/db/pipeline/aggregation_request_helper.h"
 #include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/document_source_replace_root.h"
@@ -47,6 +50,7 @@
 #include "mongo/db/query/query_request_helper.h"
 #include "mongo/db/s/operation_sharding_state.h"
 #include "mongo/db/s/resharding/document_source_resharding_ownership_match.h"
+#include "mongo/db/s/resharding/resharding_collection_cloner_progress_gen.h"
 #include "mongo/db/s/resharding/resharding_data_copy_util.h"
 #include "mongo/db/s/resharding/resharding_future_util.h"
 #include "mongo/db/s/resharding/resharding_metrics.h"
@@ -67,6 +71,10 @@
 namespace mongo {
 namespace {
 
+// Number of _id values sampled per range when splitting the collection being resharded, to smooth
+// out the sizes of the ranges.
+constexpr int kNumSamplesPerPartition = 10;
+
 bool collectionHasSimpleCollation(OperationContext* opCtx, const NamespaceString& nss) {
     auto catalogCache = Grid::get(opCtx)->catalogCache();
     auto sourceChunkMgr = uassertStatusOK(catalogCache->getCollectionRoutingInfo(opCtx, nss));
@@ -98,7 +106,8 @@ ReshardingCollectionCloner::ReshardingCollectionCloner(ReshardingMetrics* metric
 std::unique_ptr<Pipeline, PipelineDeleter> ReshardingCollectionCloner::makePipeline(
     OperationContext* opCtx,
     std::shared_ptr<MongoProcessInterface> mongoProcessInterface,
-    Value resumeId) {
+    Value resumeId,
+    const IdRange& idRange) {
     using Doc = Document;
     using Arr = std::vector<Value>;
     using V = Value;
@@ -151,6 +160,21 @@ std::unique_ptr<Pipeline, PipelineDeleter> ReshardingCollectionCloner::makePipel
             expCtx));
     }
 
+    if (!idRange.min.missing() || !idRange.max.missing()) {
+        Arr conditions;
+        if (!idRange.min.missing()) {
+            conditions.emplace_back(
+                Doc{{"$gte", Arr{V{"$_id"_sd}, V{Doc{{"$literal", idRange.min}}}}}});
+        }
+        if (!idRange.max.missing()) {
+            conditions.emplace_back(
+                Doc{{"$lt", Arr{V{"$_id"_sd}, V{Doc{{"$literal", idRange.max}}}}}});
+        }
+
+        stages.emplace_back(DocumentSourceMatch::create(
+            Doc{{"$expr", Doc{{"$and", std::move(conditions)}}}}.toBson(), expCtx));
+    }
+
     stages.emplace_back(DocumentSourceReshardingOwnershipMatch::create(
         _recipientShard, ShardKeyPattern{_newShardKeyPattern.getKeyPattern()}, expCtx));
 
@@ -214,15 +238,150 @@ std::unique_ptr<Pipeline, PipelineDeleter> ReshardingCollectionCloner::_targetAg
                              });
 }
 
-std::unique_ptr<Pipeline, PipelineDeleter> ReshardingCollectionCloner::_restartPipeline(
+std::vector<Value> ReshardingCollectionCloner::selectIdSplitPoints(std::vector<Value> sampledIds,
+                                                                   int numPartitions) {
+    std::sort(sampledIds.begin(), sampledIds.end(), ValueComparator::kInstance.getLessThan());
+    sampledIds.erase(
+        std::unique(sampledIds.begin(), sampledIds.end(), ValueComparator::kInstance.getEqualTo()),
+        sampledIds.end());
+
+    std::vector<Value> idSplitPoints;
+    for (int i = 1; i < numPartitions; ++i) {
+        const size_t index = sampledIds.size() * i / numPartitions;
+
+        // With fewer distinct samples than ranges, several ranges would share the same split
+        // point. Only keep the ranges which aren't empty.
+        if (index == 0 ||
+            (!idSplitPoints.empty() &&
+             ValueComparator::kInstance.evaluate(idSplitPoints.back() == sampledIds[index]))) {
+            continue;
+        }
+
+        idSplitPoints.push_back(sampledIds[index]);
+    }
+
+    return idSplitPoints;
+}
+
+std::vector<ReshardingCollectionCloner::IdRange> ReshardingCollectionCloner::makeIdRanges(
+    const std::vector<Value>& idSplitPoints) {
+    std::vector<IdRange> idRanges;
+    idRanges.reserve(idSplitPoints.size() + 1);
+
+    Value min;
+    for (const auto& idSplitPoint : idSplitPoints) {
+        idRanges.push_back({min, idSplitPoint});
+        min = idSplitPoint;
+    }
+    idRanges.push_back({min, Value()});
+
+    return idRanges;
+}
+
+std::vector<Value> ReshardingCollectionCloner::_sampleIds(OperationContext* opCtx,
+                                                          int numSamples) {
+    StringMap<ExpressionContext::ResolvedNamespace> resolvedNamespaces;
+    resolvedNamespaces[_sourceNss.coll()] = {_sourceNss, std::vector<BSONObj>{}};
+
+    // The sampled _id values are sorted with the simple collation to match how the aggregation
+    // pipeline compares them to the bounds of each range.
+    auto expCtx = make_intrusive<ExpressionContext>(opCtx,
+                                                    boost::none, /* explain */
+                                                    false,       /* fromMongos */
+                                                    false,       /* needsMerge */
+                                                    false,       /* allowDiskUse */
+                                                    false,       /* bypassDocumentValidation */
+                                                    false,       /* isMapReduceCommand */
+                                                    _sourceNss,
+                                                    boost::none, /* runtimeConstants */
+                                                    nullptr,     /* collator */
+                                                    MongoProcessInterface::create(opCtx),
+                                                    std::move(resolvedNamespaces),
+                                                    _sourceUUID);
+
+    // The BlockingResultsMerger underlying the merging of the samples from all of the donor shards
+    // records how long the recipient spent waiting for them, which requires the CurOp to be marked
+    // as having started.
+    auto* curOp = CurOp::get(opCtx);
+    curOp->ensureStarted();
+    ON_BLOCK_EXIT([curOp] { curOp->done(); });
+
+    auto pipeline = Pipeline::makePipeline(
+        {BSON("$sample" << BSON("size" << numSamples)), BSON("$project" << BSON("_id" << 1))},
+        expCtx);
+
+    std::vector<Value> sampledIds;
+    while (auto doc = pipeline->getNext()) {
+        sampledIds.emplace_back((*doc)["_id"]);
+    }
+
+    return sampledIds;
+}
+
+std::vector<ReshardingCollectionCloner::IdRange> ReshardingCollectionCloner::_getIdRanges(
     OperationContext* opCtx) {
+    PersistentTaskStore<ReshardingCollectionClonerProgress> store(
+        NamespaceString::kReshardingCollectionClonerProgressNamespace);
+
+    boost::optional<std::vector<Value>> idSplitPoints;
+    store.forEach(
+        opCtx,
+        BSON(ReshardingCollectionClonerProgress::kSourceUUIDFieldName << _sourceUUID),
+        [&](const ReshardingCollectionClonerProgress& progress) {
+            idSplitPoints.emplace();
+            for (const auto& idSplitPoint : progress.getIdSplitPoints()) {
+                idSplitPoints->emplace_back(idSplitPoint["_id"]);
+            }
+            return false;
+        });
+
+    if (idSplitPoints) {
+        return makeIdRanges(*idSplitPoints);
+    }
+
+    // Resuming a range relies on the documents within it being inserted in _id order, which is only
+    // efficient for collections with the simple default collation (see makePipeline()). The
+    // documents inserted before the ranges are persisted form a prefix of the collection in _id
+    // order, and therefore a prefix of each range, so it is safe to start splitting the collection
+    // after having cloned part of it in a single range.
+    const int numPartitions = resharding::gReshardingCollectionClonerNumPartitions.load();
+    if (numPartitions <= 1 || !collectionHasSimpleCollation(opCtx, _sourceNss)) {
+        return {IdRange()};
+    }
+
+    const int numSamples = numPartitions * kNumSamplesPerPartition;
+    idSplitPoints = selectIdSplitPoints(
+        _sampleIdsFn ? _sampleIdsFn(numSamples) : _sampleIds(opCtx, numSamples), numPartitions);
+    if (idSplitPoints->empty()) {
+        return {IdRange()};
+    }
+
+    std::vector<BSONObj> idSplitPointObjs;
+    idSplitPointObjs.reserve(idSplitPoints->size());
+    for (const auto& idSplitPoint : *idSplitPoints) {
+        idSplitPointObjs.push_back(Document{{"_id", idSplitPoint}}.toBson());
+    }
+    store.add(opCtx, ReshardingCollectionClonerProgress(_sourceUUID, std::move(idSplitPointObjs)));
+
+    LOGV2(7095759,
+          "Split the collection being resharded into _id ranges cloned concurrently",
+          "sourceNamespace"_attr = _sourceNss,
+          "outputNamespace"_attr = _outputNss,
+          "numRanges"_attr = idSplitPoints->size() + 1);
+
+    return makeIdRanges(*idSplitPoints);
+}
+
+std::unique_ptr<Pipeline, PipelineDeleter> ReshardingCollectionCloner::_restartPipeline(
+    OperationContext* opCtx, const IdRange& idRange) {
     auto idToResumeFrom = [&] {
         AutoGetCollection outputColl(opCtx, _outputNss, MODE_IS);
         uassert(ErrorCodes::NamespaceNotFound,
                 str::stream() << "Resharding collection cloner's output collection '" << _outputNss
                               << "' did not already exist",
                 outputColl);
-        return resharding::data_copy::findHighestInsertedId(opCtx, *outputColl);
+        return resharding::data_copy::findHighestInsertedIdInRange(
+            opCtx, *outputColl, idRange.min, idRange.max);
     }();
 
     // The BlockingResultsMerger underlying by the $mergeCursors stage records how long the
@@ -232,8 +391,11 @@ std::unique_ptr<Pipeline, PipelineDeleter> ReshardingCollectionCloner::_restartP
     curOp->ensureStarted();
     ON_BLOCK_EXIT([curOp] { curOp->done(); });
 
-    auto pipeline = _targetAggregationRequest(
-        *makePipeline(opCtx, MongoProcessInterface::create(opCtx), idToResumeFrom));
+    auto pipelineToTarget =
+        makePipeline(opCtx, MongoProcessInterface::create(opCtx), idToResumeFrom, idRange);
+    auto pipeline = _targetAggregationRequestFn
+        ? _targetAggregationRequestFn(*pipelineToTarget, idRange)
+        : _targetAggregationRequest(*pipelineToTarget);
 
     if (!idToResumeFrom.missing()) {
         // Skip inserting the first document retrieved after resuming because $gte was used in the
@@ -300,6 +462,54 @@ SemiFuture<void> ReshardingCollectionCloner::run(
     std::shared_ptr<executor::TaskExecutor> cleanupExecutor,
     CancellationToken cancelToken,
     CancelableOperationContextFactory factory) {
+    auto idRanges = std::make_shared<std::vector<IdRange>>();
+
+    return resharding::WithAutomaticRetry([this, idRanges, factory] {
+               auto opCtx = factory.makeOperationContext(&cc());
+               *idRanges = _getIdRanges(opCtx.get());
+           })
+        .onTransientError([this](const Status& status) {
+            LOGV2(7095760,
+                  "Transient error while splitting the collection being resharded into _id ranges",
+                  "sourceNamespace"_attr = _sourceNss,
+                  "outputNamespace"_attr = _outputNss,
+                  "error"_attr = redact(status));
+        })
+        .onUnrecoverableError([this](const Status& status) {
+            LOGV2_ERROR(7095761,
+                        "Operation-fatal error for resharding while splitting the collection being "
+                        "resharded into _id ranges",
+                        "sourceNamespace"_attr = _sourceNss,
+                        "outputNamespace"_attr = _outputNss,
+                        "error"_attr = redact(status));
+        })
+        .until<Status>([](const Status& status) { return status.isOK(); })
+        .on(executor, cancelToken)
+        .then([this, idRanges, executor, cleanupExecutor, cancelToken, factory] {
+            // Stop cloning the other ranges as soon as one of them fails, and wait for all of them
+            // to stop before completing since they refer to this cloner.
+            CancellationSource cancelSource(cancelToken);
+
+            std::vector<SharedSemiFuture<void>> futures;
+            futures.reserve(idRanges->size());
+            for (const auto& idRange : *idRanges) {
+                futures.emplace_back(
+                    _runIdRange(executor, cleanupExecutor, cancelSource.token(), factory, idRange)
+                        .share());
+            }
+
+            return resharding::cancelWhenAnyErrorThenQuiesce(
+                futures, executor, std::move(cancelSource));
+        })
+        .semi();
+}
+
+SemiFuture<void> ReshardingCollectionCloner::_runIdRange(
+    std::shared_ptr<executor::TaskExecutor> executor,
+    std::shared_ptr<executor::TaskExecutor> cleanupExecutor,
+    CancellationToken cancelToken,
+    CancelableOperationContextFactory factory,
+    IdRange idRange) {
     struct ChainContext {
         std::unique_ptr<Pipeline, PipelineDeleter> pipeline;
         bool moreToCome = true;
@@ -307,10 +517,10 @@ SemiFuture<void> ReshardingCollectionCloner::run(
 
     auto chainCtx = std::make_shared<ChainContext>();
 
-    return resharding::WithAutomaticRetry([this, chainCtx, factory] {
+    return resharding::WithAutomaticRetry([this, chainCtx, factory, idRange] {
                if (!chainCtx->pipeline) {
                    auto opCtx = factory.makeOperationContext(&cc());
-                   chainCtx->pipeline = _restartPipeline(opCtx.get());
+                   chainCtx->pipeline = _restartPipeline(opCtx.get(), idRange);
                }
 
                auto opCtx = factory.makeOperationContext(&cc());
@@ -29,7 +29,9 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <vector>
 
 #include "mongo/bson/timestamp.h"
 #include "mongo/db/cancelable_operation_context.h"
@@ -61,6 +63,16 @@ class ServiceContext;
  */
 class ReshardingCollectionCloner {
 public:
+    /**
+     * A range [min, max) of _id values of the collection being resharded which is fetched and
+     * inserted independently of the other ranges. A missing bound leaves the range unbounded on
+     * that side.
+     */
+    struct IdRange {
+        Value min;
+        Value max;
+    };
+
     ReshardingCollectionCloner(ReshardingMetrics* metrics,
                                ShardKeyPattern newShardKeyPattern,
                                NamespaceString sourceNss,
@@ -72,10 +84,25 @@ public:
     std::unique_ptr<Pipeline, PipelineDeleter> makePipeline(
         OperationContext* opCtx,
         std::shared_ptr<MongoProcessInterface> mongoProcessInterface,
-        Value resumeId = Value());
+        Value resumeId = Value(),
+        const IdRange& idRange = IdRange());
+
+    /**
+     * Returns up to 'numPartitions' - 1 distinct values, taken at regular intervals from the
+     * sampled _id values, which split the _id space into ranges of roughly equal sizes.
+     */
+    static std::vector<Value> selectIdSplitPoints(std::vector<Value> sampledIds, int numPartitions);
 
     /**
-     * Schedules work to repeatedly fetch and insert batches of documents.
+     * Returns the ranges delimited by the given sorted split points, the first of which starts at
+     * the lowest _id and the last of which ends after the highest _id.
+     */
+    static std::vector<IdRange> makeIdRanges(const std::vector<Value>& idSplitPoints);
+
+    /**
+     * Schedules work to repeatedly fetch and insert batches of documents. The collection is split
+     * into _id ranges (see reshardingCollectionClonerNumPartitions) which are each fetched and
+     * inserted concurrently.
      *
      * Returns a future that becomes ready when either:
      *   (a) all documents have been fetched and inserted, or
@@ -94,10 +121,48 @@ public:
      */
     bool doOneBatch(OperationContext* opCtx, Pipeline& pipeline);
 
+    using SampleIdsFn = std::function<std::vector<Value>(int numSamples)>;
+    using TargetAggregationRequestFn = std::function<std::unique_ptr<Pipeline, PipelineDeleter>(
+        const Pipeline& pipeline, const IdRange& idRange)>;
+
+    /**
+     * Overrides how the _id values of the collection being resharded are sampled.
+     */
+    void setSampleIdsFn_forTest(SampleIdsFn sampleIdsFn) {
+        _sampleIdsFn = std::move(sampleIdsFn);
+    }
+
+    /**
+     * Overrides how the pipeline fetching the documents of an _id range is sent to the donor
+     * shards, so that tests can feed it documents instead.
+     */
+    void setTargetAggregationRequestFn_forTest(TargetAggregationRequestFn targetFn) {
+        _targetAggregationRequestFn = std::move(targetFn);
+    }
+
 private:
     std::unique_ptr<Pipeline, PipelineDeleter> _targetAggregationRequest(const Pipeline& pipeline);
 
-    std::unique_ptr<Pipeline, PipelineDeleter> _restartPipeline(OperationContext* opCtx);
+    std::unique_ptr<Pipeline, PipelineDeleter> _restartPipeline(OperationContext* opCtx,
+                                                                const IdRange& idRange);
+
+    /**
+     * Returns the _id ranges to clone concurrently. They are computed by sampling the collection
+     * being resharded the first time cloning starts, and persisted so that a resumed cloner keeps
+     * copying the same ranges.
+     */
+    std::vector<IdRange> _getIdRanges(OperationContext* opCtx);
+
+    std::vector<Value> _sampleIds(OperationContext* opCtx, int numSamples);
+
+    /**
+     * Schedules work to repeatedly fetch and insert batches of documents within 'idRange'.
+     */
+    SemiFuture<void> _runIdRange(std::shared_ptr<executor::TaskExecutor> executor,
+                                 std::shared_ptr<executor::TaskExecutor> cleanupExecutor,
+                                 CancellationToken cancelToken,
+                                 CancelableOperationContextFactory factory,
+                                 IdRange idRange);
 
     ReshardingMetrics* _metrics;
     const ShardKeyPattern _newShardKeyPattern;
@@ -106,6 +171,9 @@ private:
     const ShardId _recipientShard;
     const Timestamp _atClusterTime;
     const NamespaceString _outputNss;
+
+    SampleIdsFn _sampleIdsFn;
+    TargetAggregationRequestFn _targetAggregationRequestFn;
 };
 
 }  // namespace mongo
@@ -33,17 +33,28 @@
 
 #include "mongo/bson/bsonmisc.h"
 #include "mongo/bson/json.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/cancelable_operation_context.h"
 #include "mongo/db/catalog/create_collection.h"
 #include "mongo/db/exec/document_value/document_value_test_util.h"
 #include "mongo/db/hasher.h"
+#include "mongo/db/persistent_task_store.h"
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/s/operation_sharding_state.h"
 #include "mongo/db/s/resharding/resharding_collection_cloner.h"
+#include "mongo/db/s/resharding/resharding_collection_cloner_progress_gen.h"
+#include "mongo/db/s/resharding/resharding_data_copy_util.h"
 #include "mongo/db/s/resharding/resharding_metrics.h"
 #include "mongo/db/s/resharding/resharding_util.h"
 #include "mongo/db/s/shard_server_test_fixture.h"
 #include "mongo/db/service_context_test_fixture.h"
+#include "mongo/db/vector_clock_metadata_hook.h"
+#include "mongo/executor/network_interface_factory.h"
+#include "mongo/executor/thread_pool_task_executor.h"
+#include "mongo/idl/server_parameter_test_util.h"
+#include "mongo/rpc/metadata/egress_metadata_hook_list.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/thread_pool.h"
 
 namespace mongo {
 namespace {
@@ -82,6 +93,23 @@ protected:
         const ShardKeyPattern& newShardKeyPattern,
         const ShardId& recipientShard,
         const std::deque<DocumentSource::GetNextResult>& sourceCollectionData,
+        const std::deque<DocumentSource::GetNextResult>& configCacheChunksData,
+        const ReshardingCollectionCloner::IdRange& idRange = {}) {
+        initializeCloner(newShardKeyPattern, recipientShard, configCacheChunksData);
+
+        _pipeline =
+            _cloner->makePipeline(operationContext(),
+                                  std::make_shared<MockMongoInterface>(configCacheChunksData),
+                                  Value(),
+                                  idRange);
+
+        _pipeline->addInitialSource(
+            DocumentSourceMock::createForTest(sourceCollectionData, _pipeline->getContext()));
+    }
+
+    void initializeCloner(
+        const ShardKeyPattern& newShardKeyPattern,
+        const ShardId& recipientShard,
         const std::deque<DocumentSource::GetNextResult>& configCacheChunksData) {
         _metrics = ReshardingMetrics::makeInstance(_sourceUUID,
                                                    newShardKeyPattern.toBSON(),
@@ -101,12 +129,108 @@ protected:
 
         getCatalogCacheMock()->setChunkManagerReturnValue(
             createChunkManager(newShardKeyPattern, configCacheChunksData));
+    }
 
-        _pipeline = _cloner->makePipeline(
-            operationContext(), std::make_shared<MockMongoInterface>(configCacheChunksData));
+    /**
+     * Makes the cloner fetch each _id range from 'sourceCollectionData' rather than from the donor
+     * shards.
+     */
+    void fetchFromSourceCollectionData(
+        const std::deque<DocumentSource::GetNextResult>& sourceCollectionData) {
+        _cloner->setTargetAggregationRequestFn_forTest(
+            [sourceCollectionData](const Pipeline& pipeline, const auto& idRange) {
+                auto fetched = Pipeline::parse(pipeline.serializeToBson(), pipeline.getContext());
+                fetched->addInitialSource(
+                    DocumentSourceMock::createForTest(sourceCollectionData, fetched->getContext()));
+                return fetched;
+            });
+    }
 
-        _pipeline->addInitialSource(
-            DocumentSourceMock::createForTest(sourceCollectionData, _pipeline->getContext()));
+    void insertIntoOutputCollection(const std::vector<BSONObj>& docs) {
+        std::vector<InsertStatement> batch(docs.begin(), docs.end());
+        ScopedSetShardRole scopedSetShardRole(operationContext(),
+                                              tempNss,
+                                              ShardVersion::IGNORED() /* shardVersion */,
+                                              boost::none /* databaseVersion */);
+        resharding::data_copy::insertBatch(operationContext(), tempNss, batch);
+    }
+
+    /**
+     * Returns the _id values of the output collection, sorted.
+     */
+    std::vector<int> getOutputCollectionIds() {
+        auto opCtx = operationContext();
+        AutoGetCollection tempColl{opCtx, tempNss, MODE_IS};
+        std::vector<int> ids;
+        auto cursor = tempColl->getCursor(opCtx);
+        while (auto record = cursor->next()) {
+            ids.push_back(record->data.toBson()["_id"].numberInt());
+        }
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    }
+
+    void persistIdSplitPoints(const std::vector<int>& idSplitPoints) {
+        std::vector<BSONObj> idSplitPointObjs;
+        for (int idSplitPoint : idSplitPoints) {
+            idSplitPointObjs.push_back(BSON("_id" << idSplitPoint));
+        }
+        PersistentTaskStore<ReshardingCollectionClonerProgress> store(
+            NamespaceString::kReshardingCollectionClonerProgressNamespace);
+        store.add(operationContext(),
+                  ReshardingCollectionClonerProgress(_sourceUUID, std::move(idSplitPointObjs)));
+    }
+
+    std::shared_ptr<executor::ThreadPoolTaskExecutor> makeTaskExecutorForCloner() {
+        // The ReshardingCollectionCloner expects there to already be a Client associated with the
+        // thread from the thread pool. We set up the ThreadPoolTaskExecutor identically to how the
+        // recipient's primary-only service is set up.
+        ThreadPool::Options threadPoolOptions;
+        threadPoolOptions.maxThreads = 1;
+        threadPoolOptions.threadNamePrefix = "TestReshardCollectionCloner-";
+        threadPoolOptions.poolName = "TestReshardCollectionClonerThreadPool";
+        threadPoolOptions.onCreateThread = [](const std::string& threadName) {
+            Client::initThread(threadName.c_str());
+            auto* client = Client::getCurrent();
+            AuthorizationSession::get(*client)->grantInternalAuthorization(client);
+
+            {
+                stdx::lock_guard<Client> lk(*client);
+                client->setSystemOperationKillableByStepdown(lk);
+            }
+        };
+
+        auto hookList = std::make_unique<rpc::EgressMetadataHookList>();
+        hookList->addHook(std::make_unique<rpc::VectorClockMetadataHook>(getServiceContext()));
+
+        auto executor = std::make_shared<executor::ThreadPoolTaskExecutor>(
+            std::make_unique<ThreadPool>(std::move(threadPoolOptions)),
+            executor::makeNetworkInterface(
+                "TestReshardCollectionClonerNetwork", nullptr, std::move(hookList)));
+        executor->startup();
+
+        return executor;
+    }
+
+    Status runCloner() {
+        auto executor = makeTaskExecutorForCloner();
+        auto cancelToken = operationContext()->getCancellationToken();
+
+        auto cancelableOpCtxExecutor = std::make_shared<ThreadPool>([] {
+            ThreadPool::Options options;
+            options.poolName = "TestReshardCollectionClonerCancelableOpCtxPool";
+            options.minThreads = 1;
+            options.maxThreads = 1;
+            return options;
+        }());
+        CancelableOperationContextFactory opCtxFactory(cancelToken, cancelableOpCtxExecutor);
+
+        // Waits on the executor for the callbacks of run() to be destroyed, so that the executor
+        // does not outlive the ServiceContext.
+        return _cloner->run(executor, executor, cancelToken, std::move(opCtxFactory))
+            .thenRunOn(executor)
+            .onCompletion([](auto x) { return x; })
+            .getNoThrow();
     }
 
     template <class T>
@@ -169,8 +293,9 @@ protected:
         std::deque<DocumentSource::GetNextResult> collectionData,
         std::deque<DocumentSource::GetNextResult> configData,
         int64_t expectedDocumentsCount,
-        std::function<void(std::unique_ptr<SeekableRecordCursor>)> verifyFunction) {
-        initializePipelineTest(shardKey, recipientShard, collectionData, configData);
+        std::function<void(std::unique_ptr<SeekableRecordCursor>)> verifyFunction,
+        const ReshardingCollectionCloner::IdRange& idRange = {}) {
+        initializePipelineTest(shardKey, recipientShard, collectionData, configData, idRange);
         auto opCtx = operationContext();
         AutoGetCollection tempColl{opCtx, tempNss, MODE_IS};
         while (_cloner->doOneBatch(operationContext(), *_pipeline)) {
@@ -383,5 +508,221 @@ TEST_F(ReshardingCollectionClonerTest, CompoundHashedShardKey) {
                     verify);
 }
 
+TEST_F(ReshardingCollectionClonerTest, IdRange) {
+    ShardKeyPattern sk{fromjson("{x: 1}")};
+    std::deque<DocumentSource::GetNextResult> collectionData{
+        Doc(fromjson("{_id: 1, x: 1}")),
+        Doc(fromjson("{_id: 2, x: 2}")),
+        Doc(fromjson("{_id: 3, x: 3}")),
+        Doc(fromjson("{_id: 4, x: 4}")),
+        Doc(fromjson("{_id: 5, x: 5}"))};
+    std::deque<DocumentSource::GetNextResult> configData{
+        Doc(fromjson("{_id: {x: {$minKey: 1}}, max: {x: {$maxKey: 1}}, shard: 'myShardName'}"))};
+    constexpr auto kExpectedCopiedCount = 2;
+    const auto verify = [](auto cursor) {
+        auto next = cursor->next();
+        ASSERT(next);
+        ASSERT_BSONOBJ_BINARY_EQ(BSON("_id" << 2 << "x" << 2 << "$sortKey" << BSON_ARRAY(2)),
+                                 next->data.toBson());
+
+        next = cursor->next();
+        ASSERT(next);
+        ASSERT_BSONOBJ_BINARY_EQ(BSON("_id" << 3 << "x" << 3 << "$sortKey" << BSON_ARRAY(3)),
+                                 next->data.toBson());
+
+        ASSERT_FALSE(cursor->next());
+    };
+
+    runPipelineTest(std::move(sk),
+                    _myShardName,
+                    std::move(collectionData),
+                    std::move(configData),
+                    kExpectedCopiedCount,
+                    verify,
+                    {Value(2), Value(4)});
+}
+
+TEST_F(ReshardingCollectionClonerTest, FindHighestInsertedIdInRange) {
+    insertIntoOutputCollection({BSON("_id" << 1),
+                                BSON("_id" << 5),
+                                BSON("_id" << 9),
+                                BSON("_id"
+                                     << "a"),
+                                BSON("_id" << BSON("x" << 1))});
+
+    auto opCtx = operationContext();
+    AutoGetCollection tempColl{opCtx, tempNss, MODE_IS};
+    auto findHighest = [&](const Value& minId, const Value& maxId) {
+        return resharding::data_copy::findHighestInsertedIdInRange(
+            opCtx, *tempColl, minId, maxId);
+    };
+
+    ASSERT_VALUE_EQ(findHighest(Value(), Value()), Value(Document{{"x", 1}}));
+    ASSERT_VALUE_EQ(findHighest(Value(), Value(5)), Value(1));
+    ASSERT_VALUE_EQ(findHighest(Value(5), Value(9)), Value(5));
+    ASSERT_VALUE_EQ(findHighest(Value(2), Value(9.5)), Value(9));
+    ASSERT(findHighest(Value(2), Value(5)).missing());
+    ASSERT(findHighest(Value(10), Value("a"_sd)).missing());
+}
+
+TEST_F(ReshardingCollectionClonerTest, FindHighestInsertedIdInRangeWithMixedTypes) {
+    insertIntoOutputCollection({BSON("_id" << 1),
+                                BSON("_id" << 9),
+                                BSON("_id"
+                                     << "a"),
+                                BSON("_id"
+                                     << "b"),
+                                BSON("_id" << BSON("x" << 1))});
+
+    auto opCtx = operationContext();
+    AutoGetCollection tempColl{opCtx, tempNss, MODE_IS};
+    auto findHighest = [&](const Value& minId, const Value& maxId) {
+        return resharding::data_copy::findHighestInsertedIdInRange(
+            opCtx, *tempColl, minId, maxId);
+    };
+
+    // The bounds order _id values of different types the way the cloner's pipeline does: numbers
+    // before strings before objects.
+    ASSERT_VALUE_EQ(findHighest(Value(), Value("b"_sd)), Value("a"_sd));
+    ASSERT_VALUE_EQ(findHighest(Value(5), Value("b"_sd)), Value("a"_sd));
+    ASSERT_VALUE_EQ(findHighest(Value(5), Value("a"_sd)), Value(9));
+    ASSERT_VALUE_EQ(findHighest(Value("a"_sd), Value()), Value(Document{{"x", 1}}));
+    ASSERT_VALUE_EQ(findHighest(Value("a"_sd), Value(Document{{"x", 0}})), Value("b"_sd));
+    ASSERT(findHighest(Value(10), Value("a"_sd)).missing());
+}
+
+TEST_F(ReshardingCollectionClonerTest, ResumesEachRangeFromPersistedSplitPoints) {
+    RAIIServerParameterControllerForTest numPartitions{"reshardingCollectionClonerNumPartitions",
+                                                       4};
+    std::deque<DocumentSource::GetNextResult> collectionData;
+    for (int i = 1; i <= 10; ++i) {
+        collectionData.emplace_back(Doc{{"_id", i}, {"x", i}});
+    }
+    std::deque<DocumentSource::GetNextResult> configData{
+        Doc(fromjson("{_id: {x: {$minKey: 1}}, max: {x: {$maxKey: 1}}, shard: 'myShardName'}"))};
+    initializeCloner(ShardKeyPattern{fromjson("{x: 1}")}, _myShardName, configData);
+    fetchFromSourceCollectionData(collectionData);
+
+    // The ranges [MinKey, 4), [4, 8) and [8, MaxKey) were being cloned when the cloner stopped.
+    // Each of them resumes after the highest _id inserted within it, and none of them samples the
+    // collection again.
+    persistIdSplitPoints({4, 8});
+    insertIntoOutputCollection(
+        {BSON("_id" << 1 << "x" << 1), BSON("_id" << 2 << "x" << 2), BSON("_id" << 4 << "x" << 4)});
+    bool sampled = false;
+    _cloner->setSampleIdsFn_forTest([&](int numSamples) {
+        sampled = true;
+        return std::vector<Value>{};
+    });
+
+    ASSERT_OK(runCloner());
+
+    ASSERT_FALSE(sampled);
+    ASSERT_EQ(getOutputCollectionIds(), (std::vector<int>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10}));
+    ASSERT_EQ(_metrics->getDocumentsProcessedCount(), 7);
+}
+
+TEST_F(ReshardingCollectionClonerTest, SplitsIntoRangesAfterCloningPartOfTheCollection) {
+    RAIIServerParameterControllerForTest numPartitions{"reshardingCollectionClonerNumPartitions",
+                                                       3};
+    std::deque<DocumentSource::GetNextResult> collectionData;
+    std::vector<Value> sampledIds;
+    for (int i = 1; i <= 10; ++i) {
+        collectionData.emplace_back(Doc{{"_id", i}, {"x", i}});
+        sampledIds.emplace_back(i);
+    }
+    std::deque<DocumentSource::GetNextResult> configData{
+        Doc(fromjson("{_id: {x: {$minKey: 1}}, max: {x: {$maxKey: 1}}, shard: 'myShardName'}"))};
+    initializeCloner(ShardKeyPattern{fromjson("{x: 1}")}, _myShardName, configData);
+    fetchFromSourceCollectionData(collectionData);
+
+    // A single range cloned the lowest _id values before the cloner stopped. They are a prefix of
+    // the first of the ranges [MinKey, 4), [4, 7) and [7, MaxKey) it splits the collection into.
+    insertIntoOutputCollection(
+        {BSON("_id" << 1 << "x" << 1), BSON("_id" << 2 << "x" << 2), BSON("_id" << 3 << "x" << 3)});
+    _cloner->setSampleIdsFn_forTest([&](int numSamples) { return sampledIds; });
+
+    ASSERT_OK(runCloner());
+
+    ASSERT_EQ(getOutputCollectionIds(), (std::vector<int>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10}));
+    ASSERT_EQ(_metrics->getDocumentsProcessedCount(), 7);
+
+    PersistentTaskStore<ReshardingCollectionClonerProgress> store(
+        NamespaceString::kReshardingCollectionClonerProgressNamespace);
+    std::vector<BSONObj> idSplitPoints;
+    store.forEach(operationContext(),
+                  BSON(ReshardingCollectionClonerProgress::kSourceUUIDFieldName << _sourceUUID),
+                  [&](const ReshardingCollectionClonerProgress& progress) {
+                      idSplitPoints = progress.getIdSplitPoints();
+                      return false;
+                  });
+    ASSERT_EQ(idSplitPoints.size(), 2U);
+    ASSERT_BSONOBJ_EQ(idSplitPoints[0], BSON("_id" << 4));
+    ASSERT_BSONOBJ_EQ(idSplitPoints[1], BSON("_id" << 7));
+}
+
+TEST_F(ReshardingCollectionClonerTest, FailedRangeCancelsTheOtherRanges) {
+    RAIIServerParameterControllerForTest numPartitions{"reshardingCollectionClonerNumPartitions",
+                                                       2};
+    std::deque<DocumentSource::GetNextResult> configData{
+        Doc(fromjson("{_id: {x: {$minKey: 1}}, max: {x: {$maxKey: 1}}, shard: 'myShardName'}"))};
+    initializeCloner(ShardKeyPattern{fromjson("{x: 1}")}, _myShardName, configData);
+    persistIdSplitPoints({5});
+
+    // The first range keeps failing with a transient error, so it only stops once it is canceled
+    // because the second range failed with an unrecoverable one.
+    _cloner->setTargetAggregationRequestFn_forTest(
+        [](const Pipeline& pipeline, const ReshardingCollectionCloner::IdRange& idRange)
+            -> std::unique_ptr<Pipeline, PipelineDeleter> {
+            if (idRange.min.missing()) {
+                uasserted(ErrorCodes::HostUnreachable, "Simulated transient error");
+            }
+            uasserted(ErrorCodes::InternalError, "Simulated unrecoverable error");
+        });
+
+    ASSERT_EQ(runCloner(), ErrorCodes::InternalError);
+    ASSERT(getOutputCollectionIds().empty());
+}
+
+TEST(ReshardingCollectionClonerIdRangesTest, SelectIdSplitPoints) {
+    std::vector<Value> sampledIds;
+    for (int i = 9; i >= 0; --i) {
+        sampledIds.emplace_back(i);
+        sampledIds.emplace_back(i);
+    }
+
+    auto idSplitPoints = ReshardingCollectionCloner::selectIdSplitPoints(sampledIds, 5);
+    ASSERT_EQ(idSplitPoints.size(), 4U);
+    ASSERT_VALUE_EQ(idSplitPoints[0], Value(2));
+    ASSERT_VALUE_EQ(idSplitPoints[1], Value(4));
+    ASSERT_VALUE_EQ(idSplitPoints[2], Value(6));
+    ASSERT_VALUE_EQ(idSplitPoints[3], Value(8));
+
+    // Fewer distinct samples than ranges must not produce empty ranges.
+    idSplitPoints =
+        ReshardingCollectionCloner::selectIdSplitPoints({Value(1), Value(1), Value(2)}, 8);
+    ASSERT_EQ(idSplitPoints.size(), 1U);
+    ASSERT_VALUE_EQ(idSplitPoints[0], Value(2));
+
+    ASSERT(ReshardingCollectionCloner::selectIdSplitPoints({}, 8).empty());
+    ASSERT(ReshardingCollectionCloner::selectIdSplitPoints(sampledIds, 1).empty());
+}
+
+TEST(ReshardingCollectionClonerIdRangesTest, MakeIdRanges) {
+    auto idRanges = ReshardingCollectionCloner::makeIdRanges({Value(2), Value(4)});
+    ASSERT_EQ(idRanges.size(), 3U);
+    ASSERT(idRanges[0].min.missing());
+    ASSERT_VALUE_EQ(idRanges[0].max, Value(2));
+    ASSERT_VALUE_EQ(idRanges[1].min, Value(2));
+    ASSERT_VALUE_EQ(idRanges[1].max, Value(4));
+    ASSERT_VALUE_EQ(idRanges[2].min, Value(4));
+    ASSERT(idRanges[2].max.missing());
+
+    idRanges = ReshardingCollectionCloner::makeIdRanges({});
+    ASSERT_EQ(idRanges.size(), 1U);
+    ASSERT(idRanges[0].min.missing());
+    ASSERT(idRanges[0].max.missing());
+}
+
 }  // namespace
 }  // namespace mongo
@@ -39,6 +39,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/persistent_task_store.h"
 #include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/s/resharding/resharding_collection_cloner_progress_gen.h"
 #include "mongo/db/s/resharding/resharding_oplog_applier_progress_gen.h"
 #include "mongo/db/s/resharding/resharding_txn_cloner_progress_gen.h"
 #include "mongo/db/s/resharding/resharding_util.h"
@@ -103,6 +104,14 @@ void ensureOplogCollectionsDropped(OperationContext* opCtx,
         auto oplogBufferNss = getLocalOplogBufferNamespace(sourceUUID, donor.getShardId());
         mongo::sharding_ddl_util::ensureCollectionDroppedNoChangeEvent(opCtx, oplogBufferNss);
     }
+
+    // Remove the collection cloner progress doc.
+    PersistentTaskStore<ReshardingCollectionClonerProgress> collectionClonerProgressStore(
+        NamespaceString::kReshardingCollectionClonerProgressNamespace);
+    collectionClonerProgressStore.remove(
+        opCtx,
+        BSON(ReshardingCollectionClonerProgress::kSourceUUIDFieldName << sourceUUID),
+        WriteConcernOptions());
 }
 
 void ensureTemporaryReshardingCollectionRenamed(OperationContext* opCtx,
@@ -153,6 +162,45 @@ Value findHighestInsertedId(OperationContext* opCtx, const CollectionPtr& collec
     return value;
 }
 
+Value findHighestInsertedIdInRange(OperationContext* opCtx,
+                                   const CollectionPtr& collection,
+                                   const Value& minId,
+                                   const Value& maxId) {
+    if (minId.missing() && maxId.missing()) {
+        return findHighestInsertedId(opCtx, collection);
+    }
+
+    // TODO SERVER-60824: Remove special handling for empty collections once non-blocking sort is
+    // enabled on clustered collections.
+    if (collection && collection->isEmpty(opCtx)) {
+        return Value{};
+    }
+
+    // The bounds are compared through $expr rather than through query operators so that _id values
+    // of different types are ordered the same way as by the cloner's aggregation pipeline.
+    std::vector<Value> conditions;
+    if (!minId.missing()) {
+        conditions.emplace_back(Document{
+            {"$gte", std::vector<Value>{Value{"$_id"_sd}, Value{Document{{"$literal", minId}}}}}});
+    }
+    if (!maxId.missing()) {
+        conditions.emplace_back(Document{
+            {"$lt", std::vector<Value>{Value{"$_id"_sd}, Value{Document{{"$literal", maxId}}}}}});
+    }
+
+    auto findCommand = std::make_unique<FindCommandRequest>(collection->ns());
+    findCommand->setFilter(Document{{"$expr", Document{{"$and", std::move(conditions)}}}}.toBson());
+    findCommand->setLimit(1);
+    findCommand->setSort(BSON("_id" << -1));
+
+    auto recordId = Helpers::findOne(opCtx, collection, std::move(findCommand));
+    if (recordId.isNull()) {
+        return Value{};
+    }
+
+    return Value{collection->docFor(opCtx, recordId).value()["_id"]};
+}
+
 boost::optional<Document> findDocWithHighestInsertedId(OperationContext* opCtx,
                                                        const CollectionPtr& collection) {
     // TODO SERVER-60824: Remove special handling for empty collections once non-blocking sort is
@@ -85,6 +85,15 @@ void ensureTemporaryReshardingCollectionRenamed(OperationContext* opCtx,
  */
 Value findHighestInsertedId(OperationContext* opCtx, const CollectionPtr& collection);
 
+/**
+ * Returns the largest _id value in the collection within the range [minId, maxId). A missing bound
+ * leaves the range unbounded on that side.
+ */
+Value findHighestInsertedIdInRange(OperationContext* opCtx,
+                                   const CollectionPtr& collection,
+                                   const Value& minId,
+                                   const Value& maxId);
+
 /**
  * Returns the full document of the largest _id value in the collection.
  */
@@ -125,6 +125,10 @@ public:
     bool keyBelongsToMe(const BSONObj& key) const {
         return _impl->get().keyBelongsToMe(key);
     }
+
+    void sampleChunkRead(const BSONObj& key) const {
+        _impl->get().sampleChunkOp(key, ChunkWritesTracker::OpType::kRead);
+    }
 };
 
 }  // namespace mongo
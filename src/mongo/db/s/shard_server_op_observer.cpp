@@ -45,6 +45,7 @@
 #include "mongo/db/s/operation_sharding_state.h"
 #include "mongo/db/s/range_deletion_task_gen.h"
 #include "mongo/db/s/shard_identity_rollback_notifier.h"
+#include "mongo/db/s/sharding_api_d_params_gen.h"
 #include "mongo/db/s/sharding_initialization_mongod.h"
 #include "mongo/db/s/sharding_recovery_service.h"
 #include "mongo/db/s/sharding_state.h"
@@ -65,6 +66,14 @@ namespace {
 
 const auto documentIdDecoration = OperationContext::declareDecoration<BSONObj>();
 
+// Tracker of the chunk which owns the document about to be deleted, set only if the delete was
+// sampled, along with the sampling interval it was sampled at.
+struct SampledDelete {
+    std::shared_ptr<ChunkWritesTracker> chunkWritesTracker;
+    int samplingInterval{0};
+};
+const auto sampledDeleteDecoration = OperationContext::declareDecoration<SampledDelete>();
+
 bool isStandaloneOrPrimary(OperationContext* opCtx) {
     auto replCoord = repl::ReplicationCoordinator::get(opCtx);
     const bool isReplSet =
@@ -186,6 +195,11 @@ void incrementChunkOnInsertOrUpdate(OperationContext* opCtx,
     // Don't trigger chunk splits from inserts happening due to migration since
     // we don't necessarily own that chunk yet
     if (!fromMigrate) {
+        const int samplingInterval = chunkOpSamplingInterval.load();
+        if (ChunkWritesTracker::shouldSampleOp(samplingInterval)) {
+            chunkWritesTracker->addSampledOp(ChunkWritesTracker::OpType::kWrite, samplingInterval);
+        }
+
         const auto balancerConfig = Grid::get(opCtx)->getBalancerConfiguration();
 
         const uint64_t maxChunkSizeBytes = [&] {
@@ -518,6 +532,28 @@ void ShardServerOpObserver::aboutToDelete(OperationContext* opCtx,
         // document itself as the _id.
         documentIdDecoration(opCtx) = doc["_id"] ? doc["_id"].wrap() : doc;
     }
+
+    // Only sampled deletes pay for looking up the chunk which owns the document.
+    auto& sampledDelete = sampledDeleteDecoration(opCtx);
+    sampledDelete = {};
+    const int samplingInterval = chunkOpSamplingInterval.load();
+    if (!ChunkWritesTracker::shouldSampleOp(samplingInterval)) {
+        return;
+    }
+
+    auto metadata = CollectionShardingRuntime::assertCollectionLockedAndAcquire(
+                        opCtx, coll->ns(), CSRAcquisitionMode::kShared)
+                        ->getCurrentMetadataIfKnown();
+    if (metadata && metadata->isSharded()) {
+        const auto shardKey = metadata->getShardKeyPattern().extractShardKeyFromDoc(doc);
+        if (!shardKey.isEmpty()) {
+            sampledDelete.chunkWritesTracker =
+                metadata->getChunkManager()
+                    ->findIntersectingChunkWithSimpleCollation(shardKey)
+                    .getWritesTracker();
+            sampledDelete.samplingInterval = samplingInterval;
+        }
+    }
 }
 
 void ShardServerOpObserver::onModifyShardedCollectionGlobalIndexCatalogEntry(
@@ -599,6 +635,13 @@ void ShardServerOpObserver::onDelete(OperationContext* opCtx,
     auto& documentId = documentIdDecoration(opCtx);
     invariant(!documentId.isEmpty());
 
+    // Migrations and range deletions do not count towards the load of the chunk.
+    if (auto sampledDelete = std::exchange(sampledDeleteDecoration(opCtx), {});
+        sampledDelete.chunkWritesTracker && !args.fromMigrate) {
+        sampledDelete.chunkWritesTracker->addSampledOp(ChunkWritesTracker::OpType::kWrite,
+                                                       sampledDelete.samplingInterval);
+    }
+
     if (nss == NamespaceString::kShardConfigCollectionsNamespace) {
         onConfigDeleteInvalidateCachedCollectionMetadataAndNotify(opCtx, documentId);
     }
@@ -30,8 +30,10 @@
 
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/commands.h"
+#include "mongo/db/catalog_raii.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/s/balancer_stats_registry.h"
+#include "mongo/db/s/collection_sharding_runtime.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/logv2/log.h"
 #include "mongo/s/grid.h"
@@ -90,6 +92,9 @@ public:
                 const auto collDataSizeScaled = static_cast<long long>(
                     _getCollDataSizeBytes(opCtx, nsWithOptUUID) / scaleFactor);
                 collStats.emplace_back(nsWithOptUUID.getNs(), collDataSizeScaled);
+                if (request().getIncludeRangeLoad()) {
+                    collStats.back().setRangeLoad(_getCollRangeLoad(opCtx, nsWithOptUUID));
+                }
             }
             return {std::move(collStats)};
         }
@@ -138,6 +143,53 @@ public:
             return avgObjSizeBytes * (numRecords - numOrphanDocs);
         }
 
+        /**
+         * Returns the load sampled on each chunk of the collection owned by this shard since the
+         * previous call, and resets the sampled counters of those chunks.
+         */
+        std::vector<RangeLoadForBalancing> _getCollRangeLoad(
+            OperationContext* opCtx, const NamespaceWithOptionalUUID& nsWithOptUUID) const {
+            const auto& ns = nsWithOptUUID.getNs();
+            std::vector<RangeLoadForBalancing> rangeLoad;
+
+            AutoGetCollection autoColl(opCtx, ns, MODE_IS);
+            if (!autoColl ||
+                (nsWithOptUUID.getUUID() && nsWithOptUUID.getUUID() != autoColl->uuid())) {
+                return rangeLoad;
+            }
+
+            const auto optMetadata =
+                CollectionShardingRuntime::assertCollectionLockedAndAcquire(
+                    opCtx, ns, CSRAcquisitionMode::kShared)
+                    ->getCurrentMetadataIfKnown();
+            if (!optMetadata || !optMetadata->isSharded()) {
+                return rangeLoad;
+            }
+
+            const auto thisShardId = ShardingState::get(opCtx)->shardId();
+            optMetadata->getChunkManager()->forEachChunk([&](const Chunk& chunk) {
+                if (chunk.getShardId() != thisShardId) {
+                    return true;
+                }
+
+                // Chunks which were never sampled have no writes tracker
+                const auto writesTracker = chunk.peekWritesTracker();
+                if (!writesTracker) {
+                    return true;
+                }
+
+                const auto sampledOps = writesTracker->clearSampledOps();
+                if (sampledOps.reads || sampledOps.writes) {
+                    rangeLoad.emplace_back(chunk.getMin(),
+                                           chunk.getMax(),
+                                           static_cast<long long>(sampledOps.reads),
+                                           static_cast<long long>(sampledOps.writes));
+                }
+                return true;
+            });
+            return rangeLoad;
+        }
+
         NamespaceString ns() const override {
             return {request().getDbName(), ""};
         }
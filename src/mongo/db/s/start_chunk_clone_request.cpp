@@ -156,6 +156,7 @@ StatusWith<StartChunkCloneRequest> StartChunkCloneRequest::createFromCommand(Nam
     request._lsid =
         LogicalSessionId::parse(IDLParserContext("StartChunkCloneRequest"), obj[kLsid].Obj());
     request._txnNumber = obj.getField(kTxnNumber).Long();
+    request._supportsPartitionedClone = obj[kSupportsPartitionedClone].trueValue();
 
     return request;
 }
@@ -192,6 +193,7 @@ void StartChunkCloneRequest::appendAsCommand(
     builder->append(kChunkMaxKey, chunkMaxKey);
     builder->append(kShardKeyPattern, shardKeyPattern);
     secondaryThrottle.append(builder);
+    builder->append(kSupportsPartitionedClone, true);
 }
 
 }  // namespace mongo
@@ -51,6 +51,7 @@ class StartChunkCloneRequest {
 public:
     static constexpr auto kSupportsCriticalSectionDuringCatchUp =
         "supportsCriticalSectionDuringCatchUp"_sd;
+    static constexpr auto kSupportsPartitionedClone = "supportsPartitionedClone"_sd;
 
     /**
      * Parses the input command and produces a request corresponding to its arguments.
@@ -130,6 +131,13 @@ public:
         return _secondaryThrottle;
     }
 
+    /**
+     * Whether the donor can split the initial clone between several '_migrateClone' streams.
+     */
+    bool getSupportsPartitionedClone() const {
+        return _supportsPartitionedClone;
+    }
+
 private:
     StartChunkCloneRequest(NamespaceString nss,
                            MigrationSessionId sessionId,
@@ -161,6 +169,9 @@ private:
 
     // The parsed secondary throttle options
     MigrationSecondaryThrottleOptions _secondaryThrottle;
+
+    // Donors which predate partitioned cloning do not send this field
+    bool _supportsPartitionedClone{false};
 };
 
 }  // namespace mongo
@@ -32,9 +32,12 @@
 
 #include "mongo/db/storage/checkpointer.h"
 
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/commands/server_status.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/kv/kv_engine.h"
+#include "mongo/db/storage/storage_parameters_gen.h"
 #include "mongo/logv2/log.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/fail_point.h"
@@ -50,8 +53,93 @@ const auto getCheckpointer = ServiceContext::declareDecoration<std::unique_ptr<C
 
 MONGO_FAIL_POINT_DEFINE(pauseCheckpointThread);
 
+// How often the adaptive scheduler samples the storage engine's cache statistics.
+const Milliseconds kAdaptivePollInterval = Seconds(1);
+
+// Weight given to the newest sample in the exponentially weighted write rate.
+constexpr double kWriteRateSmoothing = 0.3;
+
+class CheckpointSchedulerServerStatusSection : public ServerStatusSection {
+public:
+    CheckpointSchedulerServerStatusSection() : ServerStatusSection("checkpointScheduler") {}
+
+    bool includeByDefault() const override {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        BSONObjBuilder builder;
+        if (auto checkpointer = Checkpointer::get(opCtx)) {
+            checkpointer->appendSchedulerStats(&builder);
+        }
+        return builder.obj();
+    }
+} checkpointSchedulerSection;
+
 }  // namespace
 
+StringData Checkpointer::toString(CheckpointTrigger trigger) {
+    switch (trigger) {
+        case CheckpointTrigger::kNone:
+            return "none"_sd;
+        case CheckpointTrigger::kInterval:
+            return "interval"_sd;
+        case CheckpointTrigger::kRequested:
+            return "requested"_sd;
+        case CheckpointTrigger::kDirtyCache:
+            return "dirtyCache"_sd;
+        case CheckpointTrigger::kProjectedDirtyCache:
+            return "projectedDirtyCache"_sd;
+        case CheckpointTrigger::kPaced:
+            return "paced"_sd;
+    }
+    MONGO_UNREACHABLE;
+}
+
+Checkpointer::CheckpointTrigger Checkpointer::decideAdaptiveCheckpoint(
+    const AdaptiveScheduleInput& input) {
+    if (input.sinceLastCheckpoint >= input.maxInterval) {
+        return CheckpointTrigger::kInterval;
+    }
+    if (input.sinceLastCheckpoint < input.minInterval || input.cacheMaxBytes <= 0) {
+        return CheckpointTrigger::kNone;
+    }
+
+    const double cacheBytes = input.cacheMaxBytes;
+    if (input.cacheDirtyBytes / cacheBytes >= input.dirtyTriggerFraction) {
+        return CheckpointTrigger::kDirtyCache;
+    }
+
+    // Start early enough that the checkpoint is expected to complete before the dirty cache
+    // reaches the trigger.
+    const double lookaheadSecs = durationCount<Milliseconds>(input.lookahead) / 1000.0;
+    const double projectedDirtyBytes =
+        input.cacheDirtyBytes + input.writeBytesPerSec * lookaheadSecs;
+    if (projectedDirtyBytes / cacheBytes >= input.dirtyTriggerFraction) {
+        return CheckpointTrigger::kProjectedDirtyCache;
+    }
+
+    if (input.pacedInterval > Milliseconds(0) && input.sinceLastCheckpoint >= input.pacedInterval) {
+        return CheckpointTrigger::kPaced;
+    }
+    return CheckpointTrigger::kNone;
+}
+
+Milliseconds Checkpointer::computePacedCheckpointInterval(double writeBytesPerSec,
+                                                          int64_t checkpointBytes,
+                                                          Milliseconds minInterval,
+                                                          Milliseconds maxInterval) {
+    if (writeBytesPerSec <= 0) {
+        return maxInterval;
+    }
+    const double intervalMillis = checkpointBytes / writeBytesPerSec * 1000;
+    if (intervalMillis >= durationCount<Milliseconds>(maxInterval)) {
+        return maxInterval;
+    }
+    return std::max(minInterval, Milliseconds(static_cast<int64_t>(intervalMillis)));
+}
+
 Checkpointer* Checkpointer::get(ServiceContext* serviceCtx) {
     return getCheckpointer(serviceCtx).get();
 }
@@ -73,29 +161,21 @@ void Checkpointer::run() {
     ThreadClient tc(name(), getGlobalServiceContext());
     LOGV2_DEBUG(22307, 1, "Starting thread", "threadName"_attr = name());
 
+    {
+        stdx::lock_guard<Latch> lock(_mutex);
+        _lastCheckpointEnd = Date_t::now();
+    }
+
     while (true) {
         auto opCtx = tc->makeOperationContext();
 
+        CheckpointTrigger trigger;
         {
             stdx::unique_lock<Latch> lock(_mutex);
             MONGO_IDLE_THREAD_BLOCK;
 
-            // Wait for 'storageGlobalParams.checkpointDelaySecs' seconds; or until either shutdown
-            // is signaled or a checkpoint is triggered.
-            _sleepCV.wait_for(lock,
-                              stdx::chrono::seconds(static_cast<std::int64_t>(
-                                  storageGlobalParams.checkpointDelaySecs)),
-                              [&] { return _shuttingDown || _triggerCheckpoint; });
-
-            // If the checkpointDelaySecs is set to 0, that means we should skip checkpointing.
-            // However, checkpointDelaySecs is adjustable by a runtime server parameter, so we
-            // need to wake up to check periodically. The wakeup to check period is arbitrary.
-            while (storageGlobalParams.checkpointDelaySecs == 0 && !_shuttingDown &&
-                   !_triggerCheckpoint) {
-                _sleepCV.wait_for(lock, stdx::chrono::seconds(static_cast<std::int64_t>(3)), [&] {
-                    return _shuttingDown || _triggerCheckpoint;
-                });
-            }
+            trigger = gAdaptiveCheckpointScheduling.load() ? _waitForAdaptiveCheckpoint(lock)
+                                                           : _waitForPeriodicCheckpoint(lock);
 
             if (_shuttingDown) {
                 invariant(!_shutdownReason.isOK());
@@ -107,8 +187,15 @@ void Checkpointer::run() {
                 return;
             }
 
+            if (trigger == CheckpointTrigger::kNone) {
+                // The scheduling mode changed while waiting.
+                continue;
+            }
+
             // Clear the trigger so we do not immediately checkpoint again after this.
             _triggerCheckpoint = false;
+            _lastTrigger = trigger;
+            ++_numCheckpointsByTrigger[static_cast<size_t>(trigger)];
         }
 
         pauseCheckpointThread.pauseWhileSet();
@@ -118,16 +205,133 @@ void Checkpointer::run() {
         // TODO SERVER-50861: Access the storage engine via the ServiceContext.
         _kvEngine->checkpoint(opCtx.get());
 
-        const auto secondsElapsed = durationCount<Seconds>(Date_t::now() - startTime);
+        const Date_t endTime = Date_t::now();
+
+        {
+            stdx::lock_guard<Latch> lock(_mutex);
+            _lastCheckpointEnd = endTime;
+            _lastCheckpointDuration = endTime - startTime;
+        }
+
+        const auto secondsElapsed = durationCount<Seconds>(endTime - startTime);
         if (secondsElapsed >= 30) {
             LOGV2_DEBUG(22308,
                         1,
                         "Checkpoint was slow to complete",
-                        "secondsElapsed"_attr = secondsElapsed);
+                        "secondsElapsed"_attr = secondsElapsed,
+                        "trigger"_attr = toString(trigger));
         }
     }
 }
 
+Checkpointer::CheckpointTrigger Checkpointer::_waitForPeriodicCheckpoint(
+    stdx::unique_lock<Latch>& lock) {
+    // Wait for 'storageGlobalParams.checkpointDelaySecs' seconds; or until either shutdown is
+    // signaled or a checkpoint is triggered.
+    _sleepCV.wait_for(
+        lock,
+        stdx::chrono::seconds(static_cast<std::int64_t>(storageGlobalParams.checkpointDelaySecs)),
+        [&] { return _shuttingDown || _triggerCheckpoint; });
+
+    // If the checkpointDelaySecs is set to 0, that means we should skip checkpointing. However,
+    // checkpointDelaySecs is adjustable by a runtime server parameter, so we need to wake up to
+    // check periodically. The wakeup to check period is arbitrary.
+    while (storageGlobalParams.checkpointDelaySecs == 0 && !_shuttingDown && !_triggerCheckpoint) {
+        _sleepCV.wait_for(lock, stdx::chrono::seconds(static_cast<std::int64_t>(3)), [&] {
+            return _shuttingDown || _triggerCheckpoint;
+        });
+    }
+
+    _pacedInterval = Milliseconds(0);
+    return _triggerCheckpoint ? CheckpointTrigger::kRequested : CheckpointTrigger::kInterval;
+}
+
+Checkpointer::CheckpointTrigger Checkpointer::_waitForAdaptiveCheckpoint(
+    stdx::unique_lock<Latch>& lock) {
+    while (true) {
+        _sleepCV.wait_for(lock, kAdaptivePollInterval.toSystemDuration(), [&] {
+            return _shuttingDown || _triggerCheckpoint;
+        });
+        if (_shuttingDown || _triggerCheckpoint) {
+            return CheckpointTrigger::kRequested;
+        }
+        if (!gAdaptiveCheckpointScheduling.load()) {
+            return CheckpointTrigger::kNone;
+        }
+
+        // Sample the storage engine without holding the mutex so that triggering a checkpoint or
+        // shutting down never waits on the storage engine.
+        lock.unlock();
+        auto stats = _kvEngine->getCheckpointSchedulingStats();
+        const Date_t now = Date_t::now();
+        lock.lock();
+
+        // If the checkpointDelaySecs is set to 0, that means we should skip checkpointing.
+        if (storageGlobalParams.checkpointDelaySecs == 0) {
+            continue;
+        }
+        const Milliseconds maxInterval =
+            Seconds(static_cast<std::int64_t>(storageGlobalParams.checkpointDelaySecs));
+        const Milliseconds sinceLastCheckpoint = now - _lastCheckpointEnd;
+
+        if (!stats) {
+            // Without cache statistics, fall back to the periodic schedule.
+            if (sinceLastCheckpoint >= maxInterval) {
+                return CheckpointTrigger::kInterval;
+            }
+            continue;
+        }
+
+        if (_lastBytesWritten >= 0 && now > _lastSampleTime) {
+            const double sampleSecs = durationCount<Milliseconds>(now - _lastSampleTime) / 1000.0;
+            const double rate =
+                std::max<int64_t>(stats->bytesWritten - _lastBytesWritten, 0) / sampleSecs;
+            _writeBytesPerSec =
+                kWriteRateSmoothing * rate + (1 - kWriteRateSmoothing) * _writeBytesPerSec;
+        }
+        _lastBytesWritten = stats->bytesWritten;
+        _lastSampleTime = now;
+        _dirtyCacheFraction = stats->cacheMaxBytes > 0
+            ? static_cast<double>(stats->cacheDirtyBytes) / stats->cacheMaxBytes
+            : 0;
+
+        AdaptiveScheduleInput input;
+        input.cacheDirtyBytes = stats->cacheDirtyBytes;
+        input.cacheMaxBytes = stats->cacheMaxBytes;
+        input.writeBytesPerSec = _writeBytesPerSec;
+        input.sinceLastCheckpoint = sinceLastCheckpoint;
+        input.lookahead = _lastCheckpointDuration + kAdaptivePollInterval;
+        input.minInterval = Seconds(gAdaptiveCheckpointMinIntervalSecs.load());
+        input.maxInterval = maxInterval;
+        input.dirtyTriggerFraction = gAdaptiveCheckpointDirtyCacheTriggerPercent.load() / 100.0;
+
+        // Pace checkpoints by starting them often enough that each one flushes about half of the
+        // dirty bytes the trigger allows, rather than by throttling the storage engine's I/O.
+        _pacedInterval = gAdaptiveCheckpointPaceIO.load()
+            ? computePacedCheckpointInterval(
+                  _writeBytesPerSec,
+                  static_cast<int64_t>(stats->cacheMaxBytes * input.dirtyTriggerFraction / 2),
+                  input.minInterval,
+                  maxInterval)
+            : Milliseconds(0);
+        input.pacedInterval = _pacedInterval;
+
+        const auto trigger = decideAdaptiveCheckpoint(input);
+        if (trigger == CheckpointTrigger::kNone) {
+            continue;
+        }
+
+        LOGV2_DEBUG(7095601,
+                    2,
+                    "Adaptive checkpoint scheduler starting a checkpoint",
+                    "trigger"_attr = toString(trigger),
+                    "dirtyCacheFraction"_attr = _dirtyCacheFraction,
+                    "writeBytesPerSec"_attr = static_cast<long long>(_writeBytesPerSec),
+                    "pacedInterval"_attr = _pacedInterval);
+        return trigger;
+    }
+}
+
 void Checkpointer::triggerFirstStableCheckpoint(Timestamp prevStable,
                                                 Timestamp initialData,
                                                 Timestamp currStable) {
@@ -150,6 +354,25 @@ bool Checkpointer::hasTriggeredFirstStableCheckpoint() {
     return _hasTriggeredFirstStableCheckpoint;
 }
 
+void Checkpointer::appendSchedulerStats(BSONObjBuilder* builder) {
+    stdx::lock_guard<Latch> lock(_mutex);
+    builder->append("mode", gAdaptiveCheckpointScheduling.load() ? "adaptive" : "periodic");
+    builder->append("lastTrigger", toString(_lastTrigger));
+    builder->append("lastCheckpointDurationMillis",
+                    durationCount<Milliseconds>(_lastCheckpointDuration));
+    builder->append("dirtyCacheFraction", _dirtyCacheFraction);
+    builder->append("writeBytesPerSec", static_cast<long long>(_writeBytesPerSec));
+    builder->append("pacedIntervalMillis", durationCount<Milliseconds>(_pacedInterval));
+
+    BSONObjBuilder triggers(builder->subobjStart("checkpointsByTrigger"));
+    for (size_t i = 0; i < kNumCheckpointTriggers; ++i) {
+        const auto trigger = static_cast<CheckpointTrigger>(i);
+        if (trigger != CheckpointTrigger::kNone) {
+            triggers.append(toString(trigger), _numCheckpointsByTrigger[i]);
+        }
+    }
+}
+
 void Checkpointer::shutdown(const Status& reason) {
     LOGV2(22322, "Shutting down checkpoint thread");
 
@@ -29,12 +29,18 @@
 
 #pragma once
 
+#include <array>
+
+#include "mongo/base/string_data.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/util/background.h"
+#include "mongo/util/duration.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
+class BSONObjBuilder;
 class KVEngine;
 class OperationContext;
 class ServiceContext;
@@ -42,6 +48,59 @@ class Timestamp;
 
 class Checkpointer : public BackgroundJob {
 public:
+    /**
+     * The reasons the checkpoint thread takes a checkpoint.
+     */
+    enum class CheckpointTrigger {
+        kNone,
+        // 'storageGlobalParams.checkpointDelaySecs' elapsed since the last checkpoint.
+        kInterval,
+        // A checkpoint was requested, e.g. the first stable checkpoint.
+        kRequested,
+        // The dirty fraction of the cache reached the adaptive trigger.
+        kDirtyCache,
+        // At the current write rate, the dirty fraction of the cache is expected to reach the
+        // adaptive trigger before a checkpoint started now would complete.
+        kProjectedDirtyCache,
+        // The paced interval, sized from the write rate, elapsed since the last checkpoint.
+        kPaced,
+    };
+    static constexpr size_t kNumCheckpointTriggers = 6;
+
+    static StringData toString(CheckpointTrigger trigger);
+
+    /**
+     * Inputs to the adaptive scheduling decision, sampled each time the checkpoint thread wakes.
+     */
+    struct AdaptiveScheduleInput {
+        int64_t cacheDirtyBytes = 0;
+        int64_t cacheMaxBytes = 0;
+        double writeBytesPerSec = 0;
+        Milliseconds sinceLastCheckpoint{0};
+        // How far ahead to project the dirty cache growth: the expected duration of a checkpoint
+        // plus the time until the scheduler next wakes.
+        Milliseconds lookahead{0};
+        Milliseconds minInterval{0};
+        Milliseconds maxInterval{0};
+        double dirtyTriggerFraction = 0;
+        // The interval after which a paced checkpoint starts, or zero if checkpoints are not paced.
+        Milliseconds pacedInterval{0};
+    };
+
+    /**
+     * Returns why a checkpoint should be started now, or kNone if it should not.
+     */
+    static CheckpointTrigger decideAdaptiveCheckpoint(const AdaptiveScheduleInput& input);
+
+    /**
+     * Returns the interval between checkpoints over which writes arriving at 'writeBytesPerSec'
+     * dirty 'checkpointBytes' of the cache, bounded by 'minInterval' and 'maxInterval'.
+     */
+    static Milliseconds computePacedCheckpointInterval(double writeBytesPerSec,
+                                                       int64_t checkpointBytes,
+                                                       Milliseconds minInterval,
+                                                       Milliseconds maxInterval);
+
     Checkpointer(KVEngine* kvEngine)
         : BackgroundJob(false /* deleteSelf */),
           _kvEngine(kvEngine),
@@ -59,7 +118,9 @@ public:
     }
 
     /**
-     * Starts the checkpoint thread that runs every storageGlobalParams.checkpointDelaySecs seconds.
+     * Starts the checkpoint thread that runs every storageGlobalParams.checkpointDelaySecs seconds,
+     * or, when adaptive checkpoint scheduling is enabled, whenever the dirty cache and write rate
+     * call for a checkpoint.
      */
     void run() override;
 
@@ -87,7 +148,25 @@ public:
      */
     void shutdown(const Status& reason);
 
+    /**
+     * Appends the state of the checkpoint scheduler for serverStatus.
+     */
+    void appendSchedulerStats(BSONObjBuilder* builder);
+
 private:
+    /**
+     * Waits for 'storageGlobalParams.checkpointDelaySecs' seconds, or until either shutdown is
+     * signaled or a checkpoint is triggered.
+     */
+    CheckpointTrigger _waitForPeriodicCheckpoint(stdx::unique_lock<Latch>& lock);
+
+    /**
+     * Periodically samples the storage engine's cache statistics until they call for a
+     * checkpoint, shutdown is signaled, or a checkpoint is triggered. Returns kNone if adaptive
+     * scheduling was disabled while waiting.
+     */
+    CheckpointTrigger _waitForAdaptiveCheckpoint(stdx::unique_lock<Latch>& lock);
+
     // A pointer to the KVEngine is maintained only due to unit testing limitations that don't fully
     // setup the ServiceContext.
     // TODO SERVER-50861: Remove this pointer.
@@ -109,6 +188,21 @@ private:
 
     // This flag allows the checkpoint thread to wake up early when _sleepCV is signaled.
     bool _triggerCheckpoint;
+
+    // Scheduler state, reported in serverStatus.
+    Date_t _lastCheckpointEnd;
+    Milliseconds _lastCheckpointDuration{0};
+    CheckpointTrigger _lastTrigger = CheckpointTrigger::kNone;
+    std::array<long long, kNumCheckpointTriggers> _numCheckpointsByTrigger{};
+
+    // Adaptive scheduler samples. '_lastBytesWritten' is negative until the first sample.
+    Date_t _lastSampleTime;
+    int64_t _lastBytesWritten = -1;
+    double _dirtyCacheFraction = 0;
+    double _writeBytesPerSec = 0;
+
+    // The most recent paced interval, or zero if checkpoints are not paced.
+    Milliseconds _pacedInterval{0};
 };
 
 }  // namespace mongo
@@ -0,0 +1,125 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/checkpointer.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using Trigger = Checkpointer::CheckpointTrigger;
+
+constexpr int64_t kCacheBytes = 1000 * 1000 * 1000;
+
+Checkpointer::AdaptiveScheduleInput makeInput() {
+    Checkpointer::AdaptiveScheduleInput input;
+    input.cacheMaxBytes = kCacheBytes;
+    input.sinceLastCheckpoint = Seconds(10);
+    input.lookahead = Seconds(5);
+    input.minInterval = Seconds(5);
+    input.maxInterval = Seconds(60);
+    input.dirtyTriggerFraction = 0.1;
+    return input;
+}
+
+TEST(CheckpointerAdaptiveScheduleTest, WaitsWhileCacheIsCleanAndIdle) {
+    auto input = makeInput();
+    input.cacheDirtyBytes = kCacheBytes / 100;
+    ASSERT(Checkpointer::decideAdaptiveCheckpoint(input) == Trigger::kNone);
+}
+
+TEST(CheckpointerAdaptiveScheduleTest, CheckpointsWhenMaxIntervalElapses) {
+    auto input = makeInput();
+    input.sinceLastCheckpoint = Seconds(60);
+    ASSERT(Checkpointer::decideAdaptiveCheckpoint(input) == Trigger::kInterval);
+}
+
+TEST(CheckpointerAdaptiveScheduleTest, CheckpointsWhenDirtyCacheReachesTrigger) {
+    auto input = makeInput();
+    input.cacheDirtyBytes = kCacheBytes / 10;
+    ASSERT(Checkpointer::decideAdaptiveCheckpoint(input) == Trigger::kDirtyCache);
+}
+
+TEST(CheckpointerAdaptiveScheduleTest, CheckpointsWhenWriteRateWillReachTrigger) {
+    auto input = makeInput();
+    input.cacheDirtyBytes = kCacheBytes / 20;
+    // 5% of the cache in 5 seconds of lookahead reaches the 10% trigger.
+    input.writeBytesPerSec = kCacheBytes / 100;
+    ASSERT(Checkpointer::decideAdaptiveCheckpoint(input) == Trigger::kProjectedDirtyCache);
+
+    input.writeBytesPerSec = kCacheBytes / 1000;
+    ASSERT(Checkpointer::decideAdaptiveCheckpoint(input) == Trigger::kNone);
+}
+
+TEST(CheckpointerAdaptiveScheduleTest, RespectsMinInterval) {
+    auto input = makeInput();
+    input.sinceLastCheckpoint = Seconds(1);
+    input.cacheDirtyBytes = kCacheBytes / 2;
+    ASSERT(Checkpointer::decideAdaptiveCheckpoint(input) == Trigger::kNone);
+}
+
+TEST(CheckpointerAdaptiveScheduleTest, CheckpointsWhenPacedIntervalElapses) {
+    auto input = makeInput();
+    input.pacedInterval = Seconds(10);
+    ASSERT(Checkpointer::decideAdaptiveCheckpoint(input) == Trigger::kPaced);
+
+    input.sinceLastCheckpoint = Seconds(9);
+    ASSERT(Checkpointer::decideAdaptiveCheckpoint(input) == Trigger::kNone);
+
+    // A paced interval of zero disables pacing.
+    input.pacedInterval = Milliseconds(0);
+    input.sinceLastCheckpoint = Seconds(30);
+    ASSERT(Checkpointer::decideAdaptiveCheckpoint(input) == Trigger::kNone);
+}
+
+TEST(CheckpointerAdaptiveScheduleTest, PacedIntervalShrinksAsWriteRateGrows) {
+    ASSERT_EQ(Checkpointer::computePacedCheckpointInterval(
+                  10 * 1000 * 1000, 200 * 1000 * 1000, Seconds(5), Seconds(60)),
+              Seconds(20));
+    ASSERT_EQ(Checkpointer::computePacedCheckpointInterval(
+                  20 * 1000 * 1000, 200 * 1000 * 1000, Seconds(5), Seconds(60)),
+              Seconds(10));
+
+    // The interval stays within the configured bounds, and an idle system checkpoints only as
+    // often as syncdelay requires.
+    ASSERT_EQ(Checkpointer::computePacedCheckpointInterval(
+                  1000 * 1000 * 1000, 200 * 1000 * 1000, Seconds(5), Seconds(60)),
+              Seconds(5));
+    ASSERT_EQ(Checkpointer::computePacedCheckpointInterval(
+                  1000, 200 * 1000 * 1000, Seconds(5), Seconds(60)),
+              Seconds(60));
+    ASSERT_EQ(
+        Checkpointer::computePacedCheckpointInterval(0, 200 * 1000 * 1000, Seconds(5), Seconds(60)),
+        Seconds(60));
+}
+
+}  // namespace
+}  // namespace mongo
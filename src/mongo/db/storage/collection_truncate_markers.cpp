@@ -0,0 +1,205 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/db/storage/collection_truncate_markers.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace mongo {
+
+CollectionTruncateMarkers::CollectionTruncateMarkers(InitialSetOfMarkers initialSet,
+                                                     int64_t minBytesPerMarker)
+    : _minBytesPerMarker(minBytesPerMarker),
+      _markers(std::move(initialSet.markers)),
+      _currentRecords(initialSet.leftoverRecordsCount),
+      _currentBytes(initialSet.leftoverRecordsBytes),
+      _currentHighestRecordId(std::move(initialSet.leftoverHighestRecordId)),
+      _currentHighestWallTime(initialSet.leftoverHighestWallTime) {
+    invariant(_minBytesPerMarker > 0);
+}
+
+boost::optional<CollectionTruncateMarkers::Marker> CollectionTruncateMarkers::peekExpiredMarkers(
+    const IsExpiredFn& isExpired) const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    boost::optional<Marker> expired;
+    for (const auto& marker : _markers) {
+        if (!isExpired(marker)) {
+            break;
+        }
+        if (!expired) {
+            expired.emplace(marker);
+            continue;
+        }
+        expired->records += marker.records;
+        expired->bytes += marker.bytes;
+        expired->lastRecord = std::max(expired->lastRecord, marker.lastRecord);
+        expired->wallTime = std::max(expired->wallTime, marker.wallTime);
+    }
+    return expired;
+}
+
+void CollectionTruncateMarkers::popOldestMarkers(const RecordId& upTo) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    while (!_markers.empty() && _markers.front().lastRecord <= upTo) {
+        _markers.pop_front();
+    }
+}
+
+void CollectionTruncateMarkers::createPartialMarkerIfExpired(const IsExpiredFn& isExpired) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    if (_currentHighestRecordId.isNull() ||
+        (!_markers.empty() && _currentHighestRecordId <= _markers.back().lastRecord)) {
+        return;
+    }
+    Marker partial(
+        _currentRecords, _currentBytes, _currentHighestRecordId, _currentHighestWallTime);
+    if (isExpired(partial)) {
+        _createNewMarker(lk);
+    }
+}
+
+void CollectionTruncateMarkers::updateCurrentMarker(int64_t bytesInserted,
+                                                    const RecordId& highestInsertedRecordId,
+                                                    Date_t wallTime,
+                                                    int64_t countInserted) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _currentRecords += countInserted;
+    _currentBytes += bytesInserted;
+    _currentHighestRecordId = std::max(_currentHighestRecordId, highestInsertedRecordId);
+    _currentHighestWallTime = std::max(_currentHighestWallTime, wallTime);
+    if (_currentBytes >= _minBytesPerMarker) {
+        _createNewMarker(lk);
+    }
+}
+
+void CollectionTruncateMarkers::prependInitialMarkers(InitialSetOfMarkers initialSet) {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _markers.insert(_markers.begin(),
+                    std::make_move_iterator(initialSet.markers.begin()),
+                    std::make_move_iterator(initialSet.markers.end()));
+    _currentRecords += initialSet.leftoverRecordsCount;
+    _currentBytes += initialSet.leftoverRecordsBytes;
+    _currentHighestRecordId = std::max(_currentHighestRecordId, initialSet.leftoverHighestRecordId);
+    _currentHighestWallTime = std::max(_currentHighestWallTime, initialSet.leftoverHighestWallTime);
+}
+
+size_t CollectionTruncateMarkers::numMarkers() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _markers.size();
+}
+
+int64_t CollectionTruncateMarkers::currentRecords() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _currentRecords;
+}
+
+int64_t CollectionTruncateMarkers::currentBytes() const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _currentBytes;
+}
+
+void CollectionTruncateMarkers::_createNewMarker(WithLock) {
+    // A marker created from inserts which committed out of RecordId order may end before the
+    // previous one. Keep the queue ordered so that truncating a marker covers all older markers.
+    if (!_markers.empty()) {
+        _currentHighestRecordId = std::max(_currentHighestRecordId, _markers.back().lastRecord);
+    }
+    _markers.emplace_back(
+        _currentRecords, _currentBytes, _currentHighestRecordId, _currentHighestWallTime);
+    _currentRecords = 0;
+    _currentBytes = 0;
+}
+
+bool CollectionTruncateMarkers::shouldSample(int64_t numRecords,
+                                             int64_t dataSize,
+                                             int64_t minBytesPerMarker) {
+    // Only sample if the number of samples drawn is less than 5% of the collection.
+    const int64_t kMinSampleRatioForRandCursor = 20;
+    if (numRecords <= 0 || dataSize <= 0) {
+        return false;
+    }
+    const int64_t numMarkers = dataSize / minBytesPerMarker;
+    return numRecords >= kMinSampleRatioForRandCursor * kRandomSamplesPerMarker * numMarkers &&
+        numMarkers > 0;
+}
+
+CollectionTruncateMarkers::InitialSetOfMarkers CollectionTruncateMarkers::createMarkersByScanning(
+    const std::function<boost::optional<Record>()>& nextRecord,
+    int64_t minBytesPerMarker,
+    const std::function<Date_t(const Record&)>& getWallTime) {
+    InitialSetOfMarkers initialSet;
+    while (auto record = nextRecord()) {
+        const auto wallTime = getWallTime(*record);
+        initialSet.leftoverRecordsCount++;
+        initialSet.leftoverRecordsBytes += record->data.size();
+        initialSet.leftoverHighestRecordId = record->id;
+        initialSet.leftoverHighestWallTime =
+            std::max(initialSet.leftoverHighestWallTime, wallTime);
+        if (initialSet.leftoverRecordsBytes >= minBytesPerMarker) {
+            initialSet.markers.emplace_back(initialSet.leftoverRecordsCount,
+                                            initialSet.leftoverRecordsBytes,
+                                            record->id,
+                                            initialSet.leftoverHighestWallTime);
+            initialSet.leftoverRecordsCount = 0;
+            initialSet.leftoverRecordsBytes = 0;
+        }
+    }
+    return initialSet;
+}
+
+CollectionTruncateMarkers::InitialSetOfMarkers
+CollectionTruncateMarkers::createMarkersFromSortedSamples(
+    const std::vector<RecordIdAndWallTime>& samples,
+    int64_t estRecordsPerMarker,
+    int64_t estBytesPerMarker) {
+    InitialSetOfMarkers initialSet;
+    const int64_t wholeMarkers = samples.size() / kRandomSamplesPerMarker;
+    Date_t highestWallTime;
+    for (int64_t i = 1; i <= wholeMarkers; ++i) {
+        // Use every (kRandomSamplesPerMarker)th sample, starting with the
+        // (kRandomSamplesPerMarker - 1)th, as the last record for each marker. Samples are not
+        // ordered by wall time, so carry the highest one forward.
+        for (int64_t j = (i - 1) * kRandomSamplesPerMarker; j < i * kRandomSamplesPerMarker; ++j) {
+            highestWallTime = std::max(highestWallTime, samples[j].wallTime);
+        }
+        const auto& lastSample = samples[i * kRandomSamplesPerMarker - 1];
+        initialSet.markers.emplace_back(
+            estRecordsPerMarker, estBytesPerMarker, lastSample.id, highestWallTime);
+    }
+
+    // Each remaining sample stands for 1 / kRandomSamplesPerMarker of a marker.
+    const int64_t leftoverSamples = samples.size() - wholeMarkers * kRandomSamplesPerMarker;
+    initialSet.leftoverRecordsCount =
+        leftoverSamples * estRecordsPerMarker / kRandomSamplesPerMarker;
+    initialSet.leftoverRecordsBytes = leftoverSamples * estBytesPerMarker / kRandomSamplesPerMarker;
+    return initialSet;
+}
+
+}  // namespace mongo
@@ -0,0 +1,178 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <functional>
+
+#include "mongo/db/record_id.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/**
+ * Divides a collection, in RecordId order, into ranges which can each be removed with a single
+ * range truncate, in the manner of the oplog stones. Each marker covers every record up to and
+ * including its 'lastRecord', holds at least 'minBytesPerMarker' bytes, and remembers the highest
+ * wall time of its records. The records after the newest marker form the partial marker, which is
+ * only tracked by its counters and highest record.
+ *
+ * Markers are approximate. They are computed by scanning or sampling the collection when it is
+ * first loaded and then maintained as records are inserted. Since a truncate removes a whole
+ * RecordId range, records which were not counted are still removed with their marker, and
+ * counting errors only affect the size statistics.
+ *
+ * This class is thread-safe.
+ */
+class CollectionTruncateMarkers {
+public:
+    struct Marker {
+        Marker(int64_t records, int64_t bytes, RecordId lastRecord, Date_t wallTime)
+            : records(records),
+              bytes(bytes),
+              lastRecord(std::move(lastRecord)),
+              wallTime(wallTime) {}
+
+        int64_t records;      // Approximate number of records covered by the marker.
+        int64_t bytes;        // Approximate size of the records covered by the marker.
+        RecordId lastRecord;  // RecordId of the last record covered by the marker.
+        Date_t wallTime;      // Highest wall time of the records covered by the marker.
+    };
+
+    /**
+     * The markers computed when a collection is first loaded, along with the records which come
+     * after the newest of them.
+     */
+    struct InitialSetOfMarkers {
+        std::deque<Marker> markers;
+        int64_t leftoverRecordsCount = 0;
+        int64_t leftoverRecordsBytes = 0;
+        RecordId leftoverHighestRecordId;
+        Date_t leftoverHighestWallTime;
+    };
+
+    struct RecordIdAndWallTime {
+        RecordId id;
+        Date_t wallTime;
+    };
+
+    // Decides whether a marker has expired and may be truncated.
+    using IsExpiredFn = std::function<bool(const Marker&)>;
+
+    // The number of random samples taken for each marker when sampling a collection.
+    static constexpr int64_t kRandomSamplesPerMarker = 10;
+
+    CollectionTruncateMarkers(InitialSetOfMarkers initialSet, int64_t minBytesPerMarker);
+
+    /**
+     * Returns a marker which covers every marker at the front of the queue which 'isExpired'
+     * accepts, or boost::none if the oldest marker has not expired. The markers stay queued until
+     * popOldestMarkers() is called once their records have been truncated.
+     */
+    boost::optional<Marker> peekExpiredMarkers(const IsExpiredFn& isExpired) const;
+
+    /**
+     * Removes the markers whose last record is at or before 'upTo'.
+     */
+    void popOldestMarkers(const RecordId& upTo);
+
+    /**
+     * Turns the partial marker into a whole one if 'isExpired' accepts it, so that the records of
+     * a collection which grows too slowly to fill a marker are also removed eventually.
+     */
+    void createPartialMarkerIfExpired(const IsExpiredFn& isExpired);
+
+    /**
+     * Accounts for records inserted by a unit of work which has committed. Creates a new marker
+     * once the partial marker holds 'minBytesPerMarker' bytes.
+     */
+    void updateCurrentMarker(int64_t bytesInserted,
+                             const RecordId& highestInsertedRecordId,
+                             Date_t wallTime,
+                             int64_t countInserted);
+
+    /**
+     * Puts markers computed by a scan or sample in front of those created by the inserts which
+     * committed while they were being computed, and adds the leftover records to the partial
+     * marker.
+     */
+    void prependInitialMarkers(InitialSetOfMarkers initialSet);
+
+    size_t numMarkers() const;
+    int64_t currentRecords() const;
+    int64_t currentBytes() const;
+
+    /**
+     * Returns true if 'numRecords' records of 'dataSize' bytes in total are better processed by
+     * sampling than by scanning, i.e. if the samples would be less than 5% of the records.
+     */
+    static bool shouldSample(int64_t numRecords, int64_t dataSize, int64_t minBytesPerMarker);
+
+    /**
+     * Creates the initial markers by iterating over the records 'nextRecord' returns, in RecordId
+     * order, until it returns boost::none.
+     */
+    static InitialSetOfMarkers createMarkersByScanning(
+        const std::function<boost::optional<Record>()>& nextRecord,
+        int64_t minBytesPerMarker,
+        const std::function<Date_t(const Record&)>& getWallTime);
+
+    /**
+     * Creates the initial markers from 'samples', which must be sorted by RecordId and hold
+     * 'kRandomSamplesPerMarker' samples for every 'estRecordsPerMarker' records. Every
+     * 'kRandomSamplesPerMarker'th sample ends a marker. The leftover records are estimated from
+     * the samples after the last marker; the caller sets the leftover highest record and wall
+     * time, which the samples are unlikely to contain.
+     */
+    static InitialSetOfMarkers createMarkersFromSortedSamples(
+        const std::vector<RecordIdAndWallTime>& samples,
+        int64_t estRecordsPerMarker,
+        int64_t estBytesPerMarker);
+
+private:
+    void _createNewMarker(WithLock);
+
+    const int64_t _minBytesPerMarker;
+
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("CollectionTruncateMarkers::_mutex");
+
+    // The whole markers, oldest first.
+    std::deque<Marker> _markers;
+
+    // The partial marker.
+    int64_t _currentRecords = 0;
+    int64_t _currentBytes = 0;
+    RecordId _currentHighestRecordId;
+    Date_t _currentHighestWallTime;
+};
+
+}  // namespace mongo
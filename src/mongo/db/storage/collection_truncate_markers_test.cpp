@@ -0,0 +1,185 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/db/storage/collection_truncate_markers.h"
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using Marker = CollectionTruncateMarkers::Marker;
+
+Date_t wallTime(int seconds) {
+    return Date_t::fromMillisSinceEpoch(seconds * 1000);
+}
+
+CollectionTruncateMarkers::IsExpiredFn expiredAtOrBefore(Date_t expiry) {
+    return [expiry](const Marker& marker) {
+        return marker.wallTime <= expiry;
+    };
+}
+
+TEST(CollectionTruncateMarkersTest, CreatesMarkerOnceEnoughBytesAreInserted) {
+    CollectionTruncateMarkers markers({}, 100 /* minBytesPerMarker */);
+
+    markers.updateCurrentMarker(60, RecordId(1), wallTime(1), 1);
+    ASSERT_EQ(markers.numMarkers(), 0U);
+    ASSERT_EQ(markers.currentRecords(), 1);
+    ASSERT_EQ(markers.currentBytes(), 60);
+
+    markers.updateCurrentMarker(60, RecordId(2), wallTime(2), 1);
+    ASSERT_EQ(markers.numMarkers(), 1U);
+    ASSERT_EQ(markers.currentRecords(), 0);
+    ASSERT_EQ(markers.currentBytes(), 0);
+
+    auto expired = markers.peekExpiredMarkers(expiredAtOrBefore(wallTime(2)));
+    ASSERT(expired);
+    ASSERT_EQ(expired->records, 2);
+    ASSERT_EQ(expired->bytes, 120);
+    ASSERT_EQ(expired->lastRecord, RecordId(2));
+    ASSERT_EQ(expired->wallTime, wallTime(2));
+}
+
+TEST(CollectionTruncateMarkersTest, PeekCombinesExpiredMarkersUntilTheFirstUnexpiredOne) {
+    CollectionTruncateMarkers markers({}, 10 /* minBytesPerMarker */);
+    for (int i = 1; i <= 4; ++i) {
+        markers.updateCurrentMarker(10, RecordId(i), wallTime(i), 1);
+    }
+    ASSERT_EQ(markers.numMarkers(), 4U);
+
+    ASSERT_FALSE(markers.peekExpiredMarkers(expiredAtOrBefore(wallTime(0))));
+
+    auto expired = markers.peekExpiredMarkers(expiredAtOrBefore(wallTime(3)));
+    ASSERT(expired);
+    ASSERT_EQ(expired->records, 3);
+    ASSERT_EQ(expired->bytes, 30);
+    ASSERT_EQ(expired->lastRecord, RecordId(3));
+
+    // Peeking does not remove anything, popping removes the markers which were truncated.
+    ASSERT_EQ(markers.numMarkers(), 4U);
+    markers.popOldestMarkers(expired->lastRecord);
+    ASSERT_EQ(markers.numMarkers(), 1U);
+    ASSERT_FALSE(markers.peekExpiredMarkers(expiredAtOrBefore(wallTime(3))));
+}
+
+TEST(CollectionTruncateMarkersTest, ExpiredPartialMarkerBecomesWholeMarker) {
+    CollectionTruncateMarkers markers({}, 1000 /* minBytesPerMarker */);
+    markers.updateCurrentMarker(10, RecordId(1), wallTime(1), 1);
+    markers.updateCurrentMarker(10, RecordId(2), wallTime(2), 1);
+
+    markers.createPartialMarkerIfExpired(expiredAtOrBefore(wallTime(1)));
+    ASSERT_EQ(markers.numMarkers(), 0U);
+
+    markers.createPartialMarkerIfExpired(expiredAtOrBefore(wallTime(2)));
+    ASSERT_EQ(markers.numMarkers(), 1U);
+    ASSERT_EQ(markers.currentRecords(), 0);
+
+    // Without new inserts there is no partial marker to expire.
+    markers.createPartialMarkerIfExpired(expiredAtOrBefore(wallTime(2)));
+    ASSERT_EQ(markers.numMarkers(), 1U);
+}
+
+TEST(CollectionTruncateMarkersTest, MarkersStayOrderedWhenInsertsCommitOutOfOrder) {
+    CollectionTruncateMarkers markers({}, 10 /* minBytesPerMarker */);
+    markers.updateCurrentMarker(10, RecordId(5), wallTime(5), 1);
+    markers.updateCurrentMarker(10, RecordId(4), wallTime(4), 1);
+
+    // The second marker must cover the first one, even though its own record is older.
+    auto expired = markers.peekExpiredMarkers(expiredAtOrBefore(wallTime(5)));
+    ASSERT(expired);
+    ASSERT_EQ(expired->lastRecord, RecordId(5));
+    markers.popOldestMarkers(expired->lastRecord);
+    ASSERT_EQ(markers.numMarkers(), 0U);
+}
+
+TEST(CollectionTruncateMarkersTest, PrependInitialMarkersKeepsConcurrentInserts) {
+    CollectionTruncateMarkers markers({}, 100 /* minBytesPerMarker */);
+    markers.updateCurrentMarker(10, RecordId(10), wallTime(10), 1);
+
+    CollectionTruncateMarkers::InitialSetOfMarkers initialSet;
+    initialSet.markers.emplace_back(5, 100, RecordId(5), wallTime(5));
+    initialSet.leftoverRecordsCount = 2;
+    initialSet.leftoverRecordsBytes = 20;
+    initialSet.leftoverHighestRecordId = RecordId(7);
+    initialSet.leftoverHighestWallTime = wallTime(7);
+    markers.prependInitialMarkers(std::move(initialSet));
+
+    ASSERT_EQ(markers.numMarkers(), 1U);
+    ASSERT_EQ(markers.currentRecords(), 3);
+    ASSERT_EQ(markers.currentBytes(), 30);
+
+    markers.createPartialMarkerIfExpired(expiredAtOrBefore(wallTime(10)));
+    auto expired = markers.peekExpiredMarkers(expiredAtOrBefore(wallTime(10)));
+    ASSERT(expired);
+    ASSERT_EQ(expired->lastRecord, RecordId(10));
+    ASSERT_EQ(expired->records, 8);
+}
+
+TEST(CollectionTruncateMarkersTest, CreateMarkersByScanning) {
+    std::vector<std::string> data(10, std::string(9, 'x'));
+    int next = 0;
+    auto initialSet = CollectionTruncateMarkers::createMarkersByScanning(
+        [&]() -> boost::optional<Record> {
+            if (next == int(data.size())) {
+                return boost::none;
+            }
+            auto& str = data[next];
+            ++next;
+            return Record{RecordId(next), RecordData(str.c_str(), str.size() + 1)};
+        },
+        30 /* minBytesPerMarker */,
+        [](const Record& record) { return wallTime(record.id.getLong()); });
+
+    ASSERT_EQ(initialSet.markers.size(), 3U);
+    ASSERT_EQ(initialSet.markers[0].lastRecord, RecordId(3));
+    ASSERT_EQ(initialSet.markers[2].lastRecord, RecordId(9));
+    ASSERT_EQ(initialSet.markers[2].wallTime, wallTime(9));
+    ASSERT_EQ(initialSet.leftoverRecordsCount, 1);
+    ASSERT_EQ(initialSet.leftoverHighestRecordId, RecordId(10));
+}
+
+TEST(CollectionTruncateMarkersTest, CreateMarkersFromSortedSamples) {
+    std::vector<CollectionTruncateMarkers::RecordIdAndWallTime> samples;
+    for (int i = 1; i <= 25; ++i) {
+        samples.push_back({RecordId(i * 100), wallTime(i)});
+    }
+    auto initialSet = CollectionTruncateMarkers::createMarkersFromSortedSamples(
+        samples, 1000 /* estRecordsPerMarker */, 50000 /* estBytesPerMarker */);
+
+    ASSERT_EQ(initialSet.markers.size(), 2U);
+    ASSERT_EQ(initialSet.markers[0].lastRecord, RecordId(1000));
+    ASSERT_EQ(initialSet.markers[1].lastRecord, RecordId(2000));
+    ASSERT_EQ(initialSet.markers[1].wallTime, wallTime(20));
+    ASSERT_EQ(initialSet.leftoverRecordsCount, 500);
+    ASSERT_EQ(initialSet.leftoverRecordsBytes, 25000);
+}
+
+}  // namespace
+}  // namespace mongo
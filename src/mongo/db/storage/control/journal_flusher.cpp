@@ -32,14 +32,21 @@
 
 #include "mongo/db/storage/control/journal_flusher.h"
 
+#include <cmath>
+
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/client.h"
+#include "mongo/db/commands/server_status.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/storage/recovery_unit.h"
 #include "mongo/db/storage/storage_options.h"
+#include "mongo/db/storage/storage_parameters_gen.h"
 #include "mongo/logv2/log.h"
 #include "mongo/stdx/future.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/fail_point.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 #define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kStorage
 
@@ -52,6 +59,31 @@ const auto getJournalFlusher = ServiceContext::declareDecoration<std::unique_ptr
 
 MONGO_FAIL_POINT_DEFINE(pauseJournalFlusherBeforeFlush);
 MONGO_FAIL_POINT_DEFINE(pauseJournalFlusherThread);
+MONGO_FAIL_POINT_DEFINE(slowJournalFlush);
+
+// Weight given to the newest round in the moving averages that tune group commit.
+constexpr double kGroupCommitSmoothing = 0.2;
+
+// Flushes are only held for group commit when, on average, more than this many callers share one.
+constexpr double kGroupCommitMinAvgWaiters = 1.5;
+
+class JournalFlusherServerStatusSection : public ServerStatusSection {
+public:
+    JournalFlusherServerStatusSection() : ServerStatusSection("journalFlusher") {}
+
+    bool includeByDefault() const override {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        BSONObjBuilder builder;
+        if (auto& journalFlusher = getJournalFlusher(opCtx->getServiceContext())) {
+            journalFlusher->appendStats(&builder);
+        }
+        return builder.obj();
+    }
+} journalFlusherSection;
 
 }  // namespace
 
@@ -105,6 +137,7 @@ void JournalFlusher::run() {
     setUpOpCtx();
     while (true) {
         pauseJournalFlusherBeforeFlush.pauseWhileSet();
+        Microseconds flushDuration{0};
         try {
             ON_BLOCK_EXIT([&] {
                 // We do not want to miss an interrupt for the next round. Therefore, the opCtx
@@ -119,7 +152,11 @@ void JournalFlusher::run() {
                 setUpOpCtx();
             });
 
+            Timer flushTimer;
             _uniqueCtx->get()->recoveryUnit()->waitUntilDurable(_uniqueCtx->get());
+            slowJournalFlush.execute(
+                [&](const BSONObj& data) { sleepmillis(data["millis"].numberInt()); });
+            flushDuration = Microseconds(flushTimer.micros());
 
             // Signal the waiters that a round completed.
             _currentSharedPromise->emplaceValue();
@@ -155,6 +192,7 @@ void JournalFlusher::run() {
             Date_t::now() + Milliseconds(storageGlobalParams.journalCommitIntervalMs.load());
 
         stdx::unique_lock<Latch> lk(_stateMutex);
+        _recordFlush(lk, flushDuration, _currentRoundWaiters);
 
         MONGO_IDLE_THREAD_BLOCK;
         if (_disablePeriodicFlushes || MONGO_unlikely(pauseJournalFlusherThread.shouldFail())) {
@@ -169,6 +207,11 @@ void JournalFlusher::run() {
             });
         }
 
+        if (_flushJournalNow && !_needToPause && !_shuttingDown &&
+            gJournalFlusherGroupCommit.load()) {
+            _holdForGroupCommit(lk);
+        }
+
         if (_needToPause) {
             _state = States::Paused;
             _stateChangeCV.notify_all();
@@ -197,9 +240,62 @@ void JournalFlusher::run() {
         // Take the next promise as current and reset the next promise.
         _currentSharedPromise =
             std::exchange(_nextSharedPromise, std::make_unique<SharedPromise<void>>());
+        _currentRoundWaiters = std::exchange(_nextRoundWaiters, 0);
     }
 }
 
+void JournalFlusher::_holdForGroupCommit(stdx::unique_lock<Latch>& lk) {
+    _lastGroupCommitWindow = computeGroupCommitWindow(
+        _avgFlushDuration,
+        _avgWaitersPerFlush,
+        Microseconds(gJournalFlusherGroupCommitMaxWindowMicros.load()));
+    if (_lastGroupCommitWindow <= Microseconds{0}) {
+        return;
+    }
+
+    // Stop holding early once as many callers as usually share a flush have arrived.
+    _groupCommitTargetWaiters = std::max<int64_t>(2, std::llround(_avgWaitersPerFlush));
+    _holdingForGroupCommit = true;
+    ++_numGroupCommitHolds;
+    _flushJournalNowCV.wait_for(lk, _lastGroupCommitWindow.toSystemDuration(), [&] {
+        return _nextRoundWaiters >= _groupCommitTargetWaiters || _needToPause || _shuttingDown;
+    });
+    _holdingForGroupCommit = false;
+}
+
+void JournalFlusher::_recordFlush(WithLock, Microseconds duration, int64_t waiters) {
+    _waitersPerFlush.increment(waiters);
+    _avgFlushDuration = Microseconds(static_cast<int64_t>(
+        kGroupCommitSmoothing * durationCount<Microseconds>(duration) +
+        (1 - kGroupCommitSmoothing) * durationCount<Microseconds>(_avgFlushDuration)));
+
+    // Periodic flushes that nobody waited on say nothing about how many callers could share one.
+    if (waiters > 0) {
+        _avgWaitersPerFlush =
+            kGroupCommitSmoothing * waiters + (1 - kGroupCommitSmoothing) * _avgWaitersPerFlush;
+    }
+}
+
+Microseconds JournalFlusher::computeGroupCommitWindow(Microseconds avgFlushDuration,
+                                                      double avgWaitersPerFlush,
+                                                      Microseconds maxWindow) {
+    if (avgWaitersPerFlush <= kGroupCommitMinAvgWaiters) {
+        return Microseconds{0};
+    }
+    return std::min(maxWindow, avgFlushDuration / 2);
+}
+
+void JournalFlusher::appendStats(BSONObjBuilder* builder) const {
+    stdx::lock_guard<Latch> lk(_stateMutex);
+    builder->append("groupCommit", gJournalFlusherGroupCommit.load());
+    builder->append("averageFlushMicros", durationCount<Microseconds>(_avgFlushDuration));
+    builder->append("averageWaitersPerFlush", _avgWaitersPerFlush);
+    builder->append("groupCommitHolds", _numGroupCommitHolds);
+    builder->append("lastGroupCommitWindowMicros",
+                    durationCount<Microseconds>(_lastGroupCommitWindow));
+    appendHistogram(*builder, _waitersPerFlush, "waitersPerFlush");
+}
+
 void JournalFlusher::shutdown(const Status& reason) {
     LOGV2(22320, "Shutting down journal flusher thread");
     {
@@ -258,9 +354,12 @@ void JournalFlusher::interruptJournalFlusherForReplStateChange() {
 void JournalFlusher::_waitForJournalFlushNoRetry() {
     auto myFuture = [&]() {
         stdx::unique_lock<Latch> lk(_stateMutex);
+        ++_nextRoundWaiters;
         if (!_flushJournalNow) {
             _flushJournalNow = true;
             _flushJournalNowCV.notify_one();
+        } else if (_holdingForGroupCommit && _nextRoundWaiters >= _groupCommitTargetWaiters) {
+            _flushJournalNowCV.notify_one();
         }
         return _nextSharedPromise->getFuture();
     }();
@@ -32,10 +32,14 @@
 #include "mongo/db/service_context.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/util/background.h"
+#include "mongo/util/concurrency/with_lock.h"
+#include "mongo/util/duration.h"
 #include "mongo/util/future.h"
+#include "mongo/util/histogram.h"
 
 namespace mongo {
 
+class BSONObjBuilder;
 class OperationContext;
 
 /**
@@ -47,7 +51,9 @@ class OperationContext;
  *    a great deal of their data across a server crash.
  *  - Asynchronously grouping data flush requests reduces the total number of flushes executed,
  *    reducing i/o load on the system and improving write performance. This thread groups both the
- *    periodic flushes and immediate flush requests from the rest of the system.
+ *    periodic flushes and immediate flush requests from the rest of the system. With group commit
+ *    enabled, a requested flush is additionally held for a short window while other callers are
+ *    arriving, so that concurrent writers waiting for durability share a single flush.
  *
  * And incidentally helpful for another reason:
  *  - waitUntilDurable() calls update the replication JournalListener, so more frequent calls may be
@@ -115,6 +121,20 @@ public:
      */
     void interruptJournalFlusherForReplStateChange();
 
+    /**
+     * Appends flush statistics, including the histogram of waiters per flush, for serverStatus.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
+    /**
+     * Returns how long to hold a requested flush so that more waiters can join it. Flushes are only
+     * held when recent flushes have been shared by more than one waiter, and for no more than half
+     * of the average flush duration, bounded by 'maxWindow'.
+     */
+    static Microseconds computeGroupCommitWindow(Microseconds avgFlushDuration,
+                                                 double avgWaitersPerFlush,
+                                                 Microseconds maxWindow);
+
 private:
     // Journal flusher internal states.
     enum class States {
@@ -131,6 +151,17 @@ private:
      */
     void _waitForJournalFlushNoRetry();
 
+    /**
+     * Holds the requested flush for the group commit window, or until enough waiters have joined
+     * the next round, or the thread is asked to pause or shut down.
+     */
+    void _holdForGroupCommit(stdx::unique_lock<Latch>& lk);
+
+    /**
+     * Records a completed flushing round that 'waiters' callers were waiting on.
+     */
+    void _recordFlush(WithLock, Microseconds duration, int64_t waiters);
+
     // Serializes setting/resetting _uniqueCtx and marking _uniqueCtx killed.
     mutable Mutex _opCtxMutex = MONGO_MAKE_LATCH("JournalFlusherOpCtxMutex");
 
@@ -164,6 +195,23 @@ private:
     std::unique_ptr<SharedPromise<void>> _nextSharedPromise =
         std::make_unique<SharedPromise<void>>();
 
+    // The number of callers waiting on _nextSharedPromise and _currentSharedPromise respectively.
+    int64_t _nextRoundWaiters = 0;
+    int64_t _currentRoundWaiters = 0;
+
+    // Set while a requested flush is held for group commit. Callers wake the thread once
+    // _nextRoundWaiters reaches _groupCommitTargetWaiters.
+    bool _holdingForGroupCommit = false;
+    int64_t _groupCommitTargetWaiters = 0;
+
+    // Moving averages that tune the group commit window.
+    Microseconds _avgFlushDuration{0};
+    double _avgWaitersPerFlush = 0;
+
+    Microseconds _lastGroupCommitWindow{0};
+    long long _numGroupCommitHolds = 0;
+    Histogram<int64_t> _waitersPerFlush{{1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024}};
+
     // Controls whether to ignore the 'storageGlobalParams.journalCommitIntervalMs' setting. If set,
     // data flushes will only be executed upon explicit request, no longer periodically in addition
     // to upon request.
@@ -0,0 +1,143 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/control/journal_flusher.h"
+
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/service_context_d_test_fixture.h"
+#include "mongo/db/storage/storage_parameters_gen.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/fail_point.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+namespace {
+
+class JournalFlusherTest : public ServiceContextMongoDTest {
+protected:
+    static constexpr Milliseconds kFlushDuration{50};
+    static constexpr Milliseconds kMaxWindow{10};
+
+    void setUp() override {
+        ServiceContextMongoDTest::setUp();
+        _groupCommit = gJournalFlusherGroupCommit.swap(true);
+        _maxWindowMicros = gJournalFlusherGroupCommitMaxWindowMicros.swap(
+            durationCount<Microseconds>(kMaxWindow));
+    }
+
+    void tearDown() override {
+        gJournalFlusherGroupCommit.store(_groupCommit);
+        gJournalFlusherGroupCommitMaxWindowMicros.store(_maxWindowMicros);
+        ServiceContextMongoDTest::tearDown();
+    }
+
+    BSONObj getStats() {
+        BSONObjBuilder builder;
+        JournalFlusher::get(getServiceContext())->appendStats(&builder);
+        return builder.obj();
+    }
+
+    void waitForJournalFlushConcurrently(int numWaiters) {
+        std::vector<stdx::thread> threads;
+        for (int i = 0; i < numWaiters; ++i) {
+            threads.emplace_back(
+                [&] { JournalFlusher::get(getServiceContext())->waitForJournalFlush(); });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+private:
+    bool _groupCommit;
+    int _maxWindowMicros;
+};
+
+TEST_F(JournalFlusherTest, HoldsFlushAfterConcurrentWaitersWithinMaxWindow) {
+    // Make every flush take long enough for the group commit window to reach its maximum.
+    FailPointEnableBlock slowFlush("slowJournalFlush",
+                                   BSON("millis" << durationCount<Milliseconds>(kFlushDuration)));
+
+    // Callers arriving while a flush is in progress share the next one. The statistics may not
+    // include the last flush yet, so require a margin above the group commit threshold that a
+    // single unrecorded flush with one waiter cannot erase.
+    const auto minAvgFlushMicros = 2 * durationCount<Microseconds>(kMaxWindow);
+    BSONObj stats;
+    for (int i = 0; i < 20; ++i) {
+        waitForJournalFlushConcurrently(16);
+        stats = getStats();
+        if (stats["averageWaitersPerFlush"].numberDouble() > 2.5 &&
+            stats["averageFlushMicros"].numberLong() >= minAvgFlushMicros) {
+            break;
+        }
+    }
+    ASSERT_GT(stats["averageWaitersPerFlush"].numberDouble(), 2.5);
+    ASSERT_GTE(stats["averageFlushMicros"].numberLong(), minAvgFlushMicros);
+    const auto holds = stats["groupCommitHolds"].numberLong();
+
+    // A lone caller is held for the whole window in case others join, but no longer.
+    Timer timer;
+    JournalFlusher::get(getServiceContext())->waitForJournalFlush();
+    const Microseconds elapsed(timer.micros());
+
+    stats = getStats();
+    ASSERT_EQ(stats["groupCommitHolds"].numberLong(), holds + 1);
+    ASSERT_EQ(stats["lastGroupCommitWindowMicros"].numberLong(),
+              durationCount<Microseconds>(kMaxWindow));
+    ASSERT_GTE(elapsed, kMaxWindow + kFlushDuration);
+    // Leave ample slack for slow test hosts; a caller that was never woken would hang instead.
+    ASSERT_LT(elapsed, kMaxWindow + kFlushDuration + Seconds(5));
+}
+
+TEST(JournalFlusherGroupCommitTest, DoesNotHoldWithoutConcurrentWaiters) {
+    ASSERT_EQ(JournalFlusher::computeGroupCommitWindow(Milliseconds(2), 1.0, Milliseconds(1)),
+              Microseconds(0));
+    ASSERT_EQ(JournalFlusher::computeGroupCommitWindow(Milliseconds(2), 0, Milliseconds(1)),
+              Microseconds(0));
+}
+
+TEST(JournalFlusherGroupCommitTest, HoldsForHalfTheAverageFlush) {
+    ASSERT_EQ(JournalFlusher::computeGroupCommitWindow(Microseconds(800), 4.0, Milliseconds(1)),
+              Microseconds(400));
+}
+
+TEST(JournalFlusherGroupCommitTest, WindowIsBoundedByMaximum) {
+    ASSERT_EQ(JournalFlusher::computeGroupCommitWindow(Milliseconds(10), 4.0, Milliseconds(1)),
+              Milliseconds(1));
+    ASSERT_EQ(JournalFlusher::computeGroupCommitWindow(Milliseconds(10), 4.0, Microseconds(0)),
+              Microseconds(0));
+}
+
+}  // namespace
+}  // namespace mongo
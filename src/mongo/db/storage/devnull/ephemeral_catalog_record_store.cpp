@@ -480,6 +480,25 @@ Status EphemeralForTestRecordStore::doTruncate(OperationContext* opCtx) {
     return Status::OK();
 }
 
+Status EphemeralForTestRecordStore::doRangeTruncate(OperationContext* opCtx,
+                                                    const RecordId& minRecordId,
+                                                    const RecordId& maxRecordId,
+                                                    int64_t hintDataSizeIncrement,
+                                                    int64_t hintNumRecordsIncrement) {
+    stdx::lock_guard<stdx::recursive_mutex> lock(_data->recordsMutex);
+    auto it =
+        minRecordId.isNull() ? _data->records.begin() : _data->records.lower_bound(minRecordId);
+    auto end =
+        maxRecordId.isNull() ? _data->records.end() : _data->records.upper_bound(maxRecordId);
+    while (it != end) {
+        // Deleting one record at a time keeps each removal individually rollback-able.
+        const RecordId id = it->first;
+        ++it;
+        deleteRecord(lock, opCtx, id);
+    }
+    return Status::OK();
+}
+
 void EphemeralForTestRecordStore::doCappedTruncateAfter(
     OperationContext* opCtx,
     const RecordId& end,
@@ -86,6 +86,12 @@ public:
 
     Status doTruncate(OperationContext* opCtx) override;
 
+    Status doRangeTruncate(OperationContext* opCtx,
+                           const RecordId& minRecordId,
+                           const RecordId& maxRecordId,
+                           int64_t hintDataSizeIncrement,
+                           int64_t hintNumRecordsIncrement) override;
+
     void doCappedTruncateAfter(OperationContext* opCtx,
                                const RecordId& end,
                                bool inclusive,
@@ -127,6 +127,15 @@ protected:
         return {ErrorCodes::Error::UnknownError, "Unknown error"};
     }
 
+    Status doRangeTruncate(OperationContext*,
+                           const RecordId&,
+                           const RecordId&,
+                           int64_t,
+                           int64_t) final {
+        unimplementedTasserted();
+        return {ErrorCodes::Error::UnknownError, "Unknown error"};
+    }
+
     void doCappedTruncateAfter(OperationContext*,
                                const RecordId&,
                                bool,
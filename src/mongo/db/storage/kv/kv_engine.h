@@ -263,6 +263,24 @@ public:
 
     virtual void checkpoint(OperationContext* opCtx) {}
 
+    /**
+     * Cache statistics sampled by the checkpoint thread when scheduling checkpoints adaptively.
+     * 'bytesWritten' is a cumulative count of the bytes written into the cache by operations.
+     */
+    struct CheckpointSchedulingStats {
+        int64_t cacheDirtyBytes = 0;
+        int64_t cacheMaxBytes = 0;
+        int64_t bytesWritten = 0;
+    };
+
+    /**
+     * Returns the statistics used to schedule checkpoints adaptively, or boost::none if the engine
+     * does not provide them.
+     */
+    virtual boost::optional<CheckpointSchedulingStats> getCheckpointSchedulingStats() const {
+        return boost::none;
+    }
+
     virtual std::unique_ptr<StorageEngine::CheckpointLock> getCheckpointLock(
         OperationContext* opCtx, StorageEngine::CheckpointLock::Mode mode) {
         uasserted(ErrorCodes::CommandNotSupported,
@@ -81,6 +81,20 @@ Status RecordStore::truncate(OperationContext* opCtx) {
     return doTruncate(opCtx);
 }
 
+Status RecordStore::rangeTruncate(OperationContext* opCtx,
+                                  const RecordId& minRecordId,
+                                  const RecordId& maxRecordId,
+                                  int64_t hintDataSizeIncrement,
+                                  int64_t hintNumRecordsIncrement) {
+    validateWriteAllowed(opCtx);
+    invariant(minRecordId.isNull() || maxRecordId.isNull() || minRecordId <= maxRecordId,
+              "Start position cannot be after end position");
+    invariant(hintDataSizeIncrement <= 0);
+    invariant(hintNumRecordsIncrement <= 0);
+    return doRangeTruncate(
+        opCtx, minRecordId, maxRecordId, hintDataSizeIncrement, hintNumRecordsIncrement);
+}
+
 void RecordStore::cappedTruncateAfter(OperationContext* opCtx,
                                       const RecordId& end,
                                       bool inclusive,
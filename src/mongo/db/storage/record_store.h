@@ -536,6 +536,22 @@ public:
      */
     Status truncate(OperationContext* opCtx);
 
+    /**
+     * Removes all records in the inclusive range ['minRecordId', 'maxRecordId'] without visiting
+     * them individually. Either bound may be a null RecordId, in which case the range is open on
+     * that side. Callers which already know how much data the range holds pass it through
+     * 'hintDataSizeIncrement' and 'hintNumRecordsIncrement' (both negative, or zero), which are
+     * applied to the size and count statistics instead of being computed.
+     *
+     * Nothing is observed or replicated: callers are responsible for the effect of the removal on
+     * indexes, replication and any in-memory state describing the range.
+     */
+    Status rangeTruncate(OperationContext* opCtx,
+                         const RecordId& minRecordId = RecordId(),
+                         const RecordId& maxRecordId = RecordId(),
+                         int64_t hintDataSizeIncrement = 0,
+                         int64_t hintNumRecordsIncrement = 0);
+
     /**
      * Truncate documents newer than the document at 'end' from the capped
      * collection.  The collection cannot be completely emptied using this
@@ -715,6 +731,11 @@ protected:
         const char* damageSource,
         const mutablebson::DamageVector& damages) = 0;
     virtual Status doTruncate(OperationContext* opCtx) = 0;
+    virtual Status doRangeTruncate(OperationContext* opCtx,
+                                   const RecordId& minRecordId,
+                                   const RecordId& maxRecordId,
+                                   int64_t hintDataSizeIncrement,
+                                   int64_t hintNumRecordsIncrement) = 0;
     virtual void doCappedTruncateAfter(OperationContext* opCtx,
                                        const RecordId& end,
                                        bool inclusive,
@@ -114,5 +114,76 @@ TEST(RecordStoreTestHarness, TruncateNonEmpty) {
     }
 }
 
+// Insert multiple records, and verify that rangeTruncate() removes exactly the records within the
+// inclusive range and applies the size hints.
+TEST(RecordStoreTestHarness, RangeTruncate) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newRecordStore());
+
+    std::vector<RecordId> ids;
+    int nToInsert = 10;
+    for (int i = 0; i < nToInsert; i++) {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            stringstream ss;
+            ss << "record " << i;
+            string data = ss.str();
+
+            WriteUnitOfWork uow(opCtx.get());
+            StatusWith<RecordId> res =
+                rs->insertRecord(opCtx.get(), data.c_str(), data.size() + 1, Timestamp());
+            ASSERT_OK(res.getStatus());
+            ids.push_back(res.getValue());
+            uow.commit();
+        }
+    }
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            ASSERT_OK(rs->rangeTruncate(opCtx.get(), ids[2], ids[6], 0, -5));
+            uow.commit();
+        }
+    }
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(nToInsert - 5, rs->numRecords(opCtx.get()));
+
+        std::vector<RecordId> remaining;
+        auto cursor = rs->getCursor(opCtx.get());
+        while (auto record = cursor->next()) {
+            remaining.push_back(record->id);
+        }
+        ASSERT_EQ(remaining.size(), 5U);
+        ASSERT_EQ(remaining[0], ids[0]);
+        ASSERT_EQ(remaining[1], ids[1]);
+        ASSERT_EQ(remaining[2], ids[7]);
+        ASSERT_EQ(remaining[3], ids[8]);
+        ASSERT_EQ(remaining[4], ids[9]);
+    }
+
+    // A range which is open at the start removes everything up to and including its end.
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            ASSERT_OK(rs->rangeTruncate(opCtx.get(), RecordId(), ids[7], 0, -3));
+            uow.commit();
+        }
+    }
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(2, rs->numRecords(opCtx.get()));
+
+        auto cursor = rs->getCursor(opCtx.get());
+        auto record = cursor->next();
+        ASSERT(record);
+        ASSERT_EQ(record->id, ids[8]);
+    }
+}
+
 }  // namespace
 }  // namespace mongo
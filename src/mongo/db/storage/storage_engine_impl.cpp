@@ -49,15 +49,19 @@
 #include "mongo/db/storage/durable_history_pin.h"
 #include "mongo/db/storage/historical_ident_tracker.h"
 #include "mongo/db/storage/kv/kv_engine.h"
+#include "mongo/db/storage/storage_parameters_gen.h"
 #include "mongo/db/storage/storage_repair_observer.h"
 #include "mongo/db/storage/storage_util.h"
 #include "mongo/db/storage/two_phase_index_build_knobs_gen.h"
 #include "mongo/logv2/log.h"
 #include "mongo/stdx/unordered_map.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/fail_point.h"
+#include "mongo/util/processinfo.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
+#include "mongo/util/timer.h"
 
 #define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kStorage
 
@@ -285,6 +289,15 @@ void StorageEngineImpl::loadCatalog(OperationContext* opCtx,
         // Let the CollectionCatalog know that we are maintaining timestamps from minValidTs
         catalog.cleanupForCatalogReopen(minValidTs);
     });
+
+    // Loading the collections is split into phases so that opening their record stores, which
+    // dominates startup time with many collections, can be done in parallel. Reconciling the
+    // catalog entries with the storage engine and reading their metadata writes to and reads from
+    // the catalog under the global lock held by this thread, so it stays serial, as does
+    // registering the collections with the batched CollectionCatalog writer.
+    Timer phaseTimer;
+    std::vector<CollectionToInit> collectionsToInit;
+    collectionsToInit.reserve(catalogEntries.size());
     for (DurableCatalog::EntryIdentifier entry : catalogEntries) {
         if (_options.forRestore) {
             // When restoring a subset of user collections from a backup, the collections not
@@ -394,17 +407,117 @@ void StorageEngineImpl::loadCatalog(OperationContext* opCtx,
                 });
         }
 
-        _initCollection(
-            opCtx, entry.catalogId, entry.nss, _options.forRepair, minVisibleTs, minValidTs);
+        auto md = _catalog->getMetaData(opCtx, entry.catalogId);
+        uassert(ErrorCodes::MustDowngrade,
+                str::stream() << "Collection does not have UUID in KVCatalog. Collection: "
+                              << entry.nss,
+                md->options.uuid);
+
+        collectionsToInit.push_back(
+            {entry.catalogId, entry.nss, entry.ident, minVisibleTs, std::move(md), nullptr});
 
         if (entry.nss.isOrphanCollection()) {
             LOGV2(22248, "Orphaned collection found", logAttrs(entry.nss));
         }
     }
+    const auto readCatalogDuration = Milliseconds(phaseTimer.millis());
+
+    phaseTimer.reset();
+    size_t numThreads = 0;
+    if (!_options.forRepair) {
+        // Using a NULL rs during repair since we don't want to open the record stores before they
+        // have been repaired.
+        numThreads = _openRecordStoresInParallel(opCtx, &collectionsToInit);
+    }
+    const auto openRecordStoresDuration = Milliseconds(phaseTimer.millis());
+
+    phaseTimer.reset();
+    for (auto& toInit : collectionsToInit) {
+        _registerCollection(opCtx, std::move(toInit), _options.forRepair, minValidTs);
+    }
+    const auto registerCollectionsDuration = Milliseconds(phaseTimer.millis());
+
+    LOGV2(7095500,
+          "Loaded the storage engine catalog",
+          "numCollections"_attr = collectionsToInit.size(),
+          "numThreads"_attr = numThreads,
+          "readCatalogDuration"_attr = readCatalogDuration,
+          "openRecordStoresDuration"_attr = openRecordStoresDuration,
+          "registerCollectionsDuration"_attr = registerCollectionsDuration);
 
     opCtx->recoveryUnit()->abandonSnapshot();
 }
 
+size_t StorageEngineImpl::_openRecordStoresInParallel(OperationContext* opCtx,
+                                                      std::vector<CollectionToInit>* collections) {
+    size_t numThreads = gStorageEngineCatalogLoadThreads > 0
+        ? static_cast<size_t>(gStorageEngineCatalogLoadThreads)
+        : static_cast<size_t>(ProcessInfo::getNumAvailableCores());
+    numThreads = std::min(numThreads, collections->size());
+    if (numThreads <= 1) {
+        // Not worth spinning up a thread pool, the collections get opened while registering them.
+        return 1;
+    }
+
+    ThreadPool::Options options;
+    options.poolName = "StorageEngineCatalogLoader";
+    options.threadNamePrefix = "StorageEngineCatalogLoader-";
+    options.minThreads = 0;
+    options.maxThreads = numThreads;
+    options.onCreateThread = [](const std::string& threadName) {
+        Client::initThread(threadName);
+    };
+    ThreadPool pool(options);
+    pool.startup();
+
+    AtomicWord<size_t> nextToOpen{0};
+    Mutex errorMutex = MONGO_MAKE_LATCH("StorageEngineImpl::_openRecordStoresInParallel");
+    Status firstError = Status::OK();
+
+    for (size_t i = 0; i < numThreads; ++i) {
+        pool.schedule([&](Status status) {
+            invariant(status);
+
+            // This runs before the storage engine is installed on the service context, so the
+            // operation context does not get a usable recovery unit on its own. Its locker is
+            // never used: this thread's global lock protects the catalog while these run.
+            auto workerOpCtx = cc().makeOperationContext();
+            workerOpCtx->setRecoveryUnit(
+                std::unique_ptr<RecoveryUnit>(_engine->newRecoveryUnit()),
+                WriteUnitOfWork::RecoveryUnitState::kNotInUnitOfWork);
+
+            try {
+                for (size_t idx = nextToOpen.fetchAndAdd(1); idx < collections->size();
+                     idx = nextToOpen.fetchAndAdd(1)) {
+                    auto& toInit = (*collections)[idx];
+                    if (toInit.nss.isOplog()) {
+                        // Opening the oplog starts the oplog manager and computes the oplog
+                        // truncate markers, leave that to the registration phase.
+                        continue;
+                    }
+                    toInit.rs = _engine->getRecordStore(
+                        workerOpCtx.get(), toInit.nss, toInit.ident, toInit.md->options);
+                    invariant(toInit.rs);
+                }
+            } catch (const DBException& ex) {
+                stdx::lock_guard<Latch> lk(errorMutex);
+                if (firstError.isOK()) {
+                    firstError = ex.toStatus();
+                }
+                // Stop the other threads from opening more record stores.
+                nextToOpen.store(collections->size());
+            }
+            workerOpCtx->recoveryUnit()->abandonSnapshot();
+        });
+    }
+
+    pool.shutdown();
+    pool.join();
+    uassertStatusOK(firstError);
+
+    return numThreads;
+}
+
 void StorageEngineImpl::_initCollection(OperationContext* opCtx,
                                         RecordId catalogId,
                                         const NamespaceString& nss,
@@ -418,23 +531,38 @@ void StorageEngineImpl::_initCollection(OperationContext* opCtx,
 
     auto ident = _catalog->getEntry(catalogId).ident;
 
+    _registerCollection(opCtx,
+                        {catalogId, nss, std::move(ident), minVisibleTs, std::move(md), nullptr},
+                        forRepair,
+                        minValidTs);
+}
+
+void StorageEngineImpl::_registerCollection(OperationContext* opCtx,
+                                            CollectionToInit toInit,
+                                            bool forRepair,
+                                            Timestamp minValidTs) {
     std::unique_ptr<RecordStore> rs;
     if (forRepair) {
         // Using a NULL rs since we don't want to open this record store before it has been
         // repaired. This also ensures that if we try to use it, it will blow up.
         rs = nullptr;
+    } else if (toInit.rs) {
+        rs = std::move(toInit.rs);
     } else {
-        rs = _engine->getRecordStore(opCtx, nss, ident, md->options);
+        rs = _engine->getRecordStore(opCtx, toInit.nss, toInit.ident, toInit.md->options);
         invariant(rs);
     }
 
     auto collectionFactory = Collection::Factory::get(getGlobalServiceContext());
-    auto collection = collectionFactory->make(opCtx, nss, catalogId, md, std::move(rs));
-    collection->setMinimumVisibleSnapshot(minVisibleTs);
+    auto collection =
+        collectionFactory->make(opCtx, toInit.nss, toInit.catalogId, toInit.md, std::move(rs));
+    collection->setMinimumVisibleSnapshot(toInit.minVisibleTs);
 
     CollectionCatalog::write(opCtx, [&](CollectionCatalog& catalog) {
-        catalog.registerCollection(
-            opCtx, md->options.uuid.value(), std::move(collection), /*commitTime*/ minValidTs);
+        catalog.registerCollection(opCtx,
+                                   toInit.md->options.uuid.value(),
+                                   std::move(collection),
+                                   /*commitTime*/ minValidTs);
     });
 }
 
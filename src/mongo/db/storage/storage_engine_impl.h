@@ -392,6 +392,19 @@ public:
 private:
     using CollIter = std::list<std::string>::iterator;
 
+    /**
+     * A collection found in the catalog by loadCatalog() whose in-memory representation still has
+     * to be built and registered with the CollectionCatalog.
+     */
+    struct CollectionToInit {
+        RecordId catalogId;
+        NamespaceString nss;
+        std::string ident;
+        Timestamp minVisibleTs;
+        std::shared_ptr<BSONCollectionCatalogEntry::MetaData> md;
+        std::unique_ptr<RecordStore> rs;
+    };
+
     void _initCollection(OperationContext* opCtx,
                          RecordId catalogId,
                          const NamespaceString& nss,
@@ -399,6 +412,23 @@ private:
                          Timestamp minVisibleTs,
                          Timestamp minValidTs);
 
+    /**
+     * Constructs the Collection for 'toInit' and registers it with the CollectionCatalog. Opens the
+     * record store unless it was already opened or 'forRepair' is true.
+     */
+    void _registerCollection(OperationContext* opCtx,
+                             CollectionToInit toInit,
+                             bool forRepair,
+                             Timestamp minValidTs);
+
+    /**
+     * Opens the record stores of 'collections' using a pool of up to
+     * 'storageEngineCatalogLoadThreads' threads. The oplog is skipped and left to be opened by the
+     * caller. Returns the number of threads used.
+     */
+    size_t _openRecordStoresInParallel(OperationContext* opCtx,
+                                       std::vector<CollectionToInit>* collections);
+
     Status _dropCollectionsNoTimestamp(OperationContext* opCtx, const std::vector<UUID>& toDrop);
 
     /**
@@ -86,6 +86,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_extensions.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_index.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_oplog_stone_storer.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
@@ -318,6 +319,7 @@ std::string toString(const StorageEngine::OldestActiveTransactionTimestampResult
 }
 
 StringData WiredTigerKVEngine::kTableUriPrefix = "table:"_sd;
+StringData WiredTigerKVEngine::kOplogStoneStorerIdent = "oplogTruncateMarkers"_sd;
 
 WiredTigerKVEngine::WiredTigerKVEngine(OperationContext* opCtx,
                                        const std::string& canonicalName,
@@ -581,6 +583,18 @@ WiredTigerKVEngine::WiredTigerKVEngine(OperationContext* opCtx,
     }
 
     _sizeStorer = std::make_unique<WiredTigerSizeStorer>(_conn, _sizeStorerUri);
+
+    _oplogStoneStorerUri = _uri(kOplogStoneStorerIdent);
+    if (repair && _hasUri(session.getSession(), _oplogStoneStorerUri)) {
+        // The persisted oplog truncate markers are only a hint. Rather than salvaging them, drop
+        // the table so that they are recomputed from the repaired oplog.
+        LOGV2(7095402, "Dropping persisted oplog truncate markers during repair");
+        invariantWTOK(session.getSession()->drop(
+                          session.getSession(), _oplogStoneStorerUri.c_str(), "force=true"),
+                      session.getSession());
+    }
+    _oplogStoneStorer = std::make_unique<WiredTigerOplogStoneStorer>(_conn, _oplogStoneStorerUri);
+
     _runTimeConfigParam.reset(makeServerParameter<WiredTigerEngineRuntimeConfigParameter>(
         "wiredTigerEngineRuntimeConfig", ServerParameterType::kRuntimeOnly));
     _runTimeConfigParam->_data.second = this;
@@ -732,6 +746,7 @@ void WiredTigerKVEngine::cleanShutdown() {
     // they release their session back to the session cache. If the shutdown flag has been set,
     // released sessions will skip flushing the size storer.
     _sizeStorer.reset();
+    _oplogStoneStorer.reset();
 
     // We want WiredTiger to leak memory for faster shutdown except when we are running tools to
     // look for memory leaks.
@@ -2020,6 +2035,29 @@ void WiredTigerKVEngine::checkpoint(OperationContext* opCtx) {
     return _checkpoint(opCtx, s);
 }
 
+boost::optional<KVEngine::CheckpointSchedulingStats>
+WiredTigerKVEngine::getCheckpointSchedulingStats() const {
+    auto session = _sessionCache->getSession();
+    auto getStat = [&](int key) {
+        return WiredTigerUtil::getStatisticsValue(
+            session->getSession(), "statistics:", "statistics=(fast)", key);
+    };
+
+    auto dirtyBytes = getStat(WT_STAT_CONN_CACHE_BYTES_DIRTY);
+    auto maxBytes = getStat(WT_STAT_CONN_CACHE_BYTES_MAX);
+    auto insertBytes = getStat(WT_STAT_CONN_CURSOR_INSERT_BYTES);
+    auto updateBytes = getStat(WT_STAT_CONN_CURSOR_UPDATE_BYTES);
+    if (!dirtyBytes.isOK() || !maxBytes.isOK() || !insertBytes.isOK() || !updateBytes.isOK()) {
+        return boost::none;
+    }
+
+    CheckpointSchedulingStats stats;
+    stats.cacheDirtyBytes = dirtyBytes.getValue();
+    stats.cacheMaxBytes = maxBytes.getValue();
+    stats.bytesWritten = insertBytes.getValue() + updateBytes.getValue();
+    return stats;
+}
+
 std::unique_ptr<StorageEngine::CheckpointLock> WiredTigerKVEngine::getCheckpointLock(
     OperationContext* opCtx, StorageEngine::CheckpointLock::Mode mode) {
     return std::make_unique<WiredTigerCheckpointLock>(opCtx, mode);
@@ -2064,7 +2102,7 @@ std::vector<std::string> WiredTigerKVEngine::getAllIdents(OperationContext* opCt
             continue;
 
         StringData ident = key.substr(idx + 1);
-        if (ident == "sizeStorer")
+        if (ident == "sizeStorer" || ident == kOplogStoneStorerIdent)
             continue;
 
         all.push_back(ident.toString());
@@ -56,6 +56,7 @@ class ClockSource;
 class JournalListener;
 class WiredTigerRecordStore;
 class WiredTigerSessionCache;
+class WiredTigerOplogStoneStorer;
 class WiredTigerSizeStorer;
 class WiredTigerEngineRuntimeConfigParameter;
 
@@ -100,6 +101,9 @@ class WiredTigerKVEngine final : public KVEngine {
 public:
     static StringData kTableUriPrefix;
 
+    // The ident of the table holding the persisted oplog truncate markers.
+    static StringData kOplogStoneStorerIdent;
+
     WiredTigerKVEngine(OperationContext* opCtx,
                        const std::string& canonicalName,
                        const std::string& path,
@@ -128,6 +132,8 @@ public:
 
     void checkpoint(OperationContext* opCtx) override;
 
+    boost::optional<CheckpointSchedulingStats> getCheckpointSchedulingStats() const override;
+
     std::unique_ptr<StorageEngine::CheckpointLock> getCheckpointLock(
         OperationContext* opCtx, StorageEngine::CheckpointLock::Mode mode) override;
 
@@ -307,6 +313,13 @@ public:
 
     void syncSizeInfo(bool sync) const;
 
+    /**
+     * Returns the storer persisting the oplog truncate markers, or nullptr during shutdown.
+     */
+    WiredTigerOplogStoneStorer* getOplogStoneStorer() const {
+        return _oplogStoneStorer.get();
+    }
+
     /*
      * The oplog manager is always accessible, but this method will start the background thread to
      * control oplog entry visibility for reads.
@@ -503,6 +516,9 @@ private:
     std::unique_ptr<WiredTigerSizeStorer> _sizeStorer;
     std::string _sizeStorerUri;
     mutable ElapsedTracker _sizeStorerSyncTracker;
+
+    std::unique_ptr<WiredTigerOplogStoneStorer> _oplogStoneStorer;
+    std::string _oplogStoneStorerUri;
     bool _ephemeral;  // whether we are using the in-memory mode of the WT engine
     const bool _inRepairMode;
 
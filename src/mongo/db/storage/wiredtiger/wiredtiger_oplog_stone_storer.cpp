@@ -0,0 +1,197 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_oplog_stone_storer.h"
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_begin_transaction_block.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/logv2/log.h"
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kStorage
+
+
+namespace mongo {
+namespace {
+
+constexpr auto kIdentFieldName = "ident"_sd;
+constexpr auto kRecordsFieldName = "records"_sd;
+constexpr auto kBytesFieldName = "bytes"_sd;
+constexpr auto kWallFieldName = "wall"_sd;
+
+BSONObj toBSON(StringData ident, const WiredTigerOplogStoneStorer::PersistedStone& stone) {
+    return BSON(kIdentFieldName << ident << kRecordsFieldName << stone.records << kBytesFieldName
+                                << stone.bytes << kWallFieldName << stone.wallTime);
+}
+
+int insertStone(WT_CURSOR* cursor,
+                StringData ident,
+                const WiredTigerOplogStoneStorer::PersistedStone& stone) {
+    BSONObj data = toBSON(ident, stone);
+    WiredTigerItem value(data.objdata(), data.objsize());
+    cursor->set_key(cursor, stone.lastRecord.getLong());
+    cursor->set_value(cursor, value.Get());
+    return cursor->insert(cursor);
+}
+
+}  // namespace
+
+WiredTigerOplogStoneStorer::WiredTigerOplogStoneStorer(WT_CONNECTION* conn,
+                                                       const std::string& storageUri)
+    : _conn(conn), _storageUri(storageUri) {
+    std::string config = "key_format=q,value_format=u," +
+        WiredTigerCustomizationHooks::get(getGlobalServiceContext())
+            ->getTableCreateConfig(_storageUri);
+
+    WiredTigerSession session(_conn);
+    invariantWTOK(
+        session.getSession()->create(session.getSession(), _storageUri.c_str(), config.c_str()),
+        session.getSession());
+}
+
+std::vector<WiredTigerOplogStoneStorer::PersistedStone> WiredTigerOplogStoneStorer::load(
+    StringData ident) const {
+    std::vector<PersistedStone> stones;
+
+    WiredTigerSession session(_conn);
+    WT_CURSOR* cursor = session.getNewCursor(_storageUri);
+
+    int ret;
+    while ((ret = cursor->next(cursor)) == 0) {
+        int64_t key;
+        WT_ITEM value;
+        invariantWTOK(cursor->get_key(cursor, &key), cursor->session);
+        invariantWTOK(cursor->get_value(cursor, &value), cursor->session);
+        BSONObj data(reinterpret_cast<const char*>(value.data));
+
+        if (data[kIdentFieldName].str() != ident) {
+            LOGV2(7095400,
+                  "Ignoring persisted oplog truncate markers written for a different oplog",
+                  "ident"_attr = ident,
+                  "persisted"_attr = redact(data));
+            return {};
+        }
+
+        stones.push_back({RecordId(key),
+                          data[kRecordsFieldName].safeNumberLong(),
+                          data[kBytesFieldName].safeNumberLong(),
+                          data[kWallFieldName].Date()});
+    }
+    invariantWTOK(ret == WT_NOTFOUND ? 0 : ret, cursor->session);
+
+    LOGV2_DEBUG(7095401,
+                2,
+                "WiredTigerOplogStoneStorer::load",
+                "ident"_attr = ident,
+                "numStones"_attr = stones.size());
+    return stones;
+}
+
+Status WiredTigerOplogStoneStorer::insert(StringData ident, const PersistedStone& stone) {
+    return _runInTxn([&](WT_CURSOR* cursor) { return insertStone(cursor, ident, stone); });
+}
+
+Status WiredTigerOplogStoneStorer::removeUpTo(const RecordId& lastRecord) {
+    return _runInTxn([&](WT_CURSOR* cursor) {
+        int ret;
+        while ((ret = cursor->next(cursor)) == 0) {
+            int64_t key;
+            if ((ret = cursor->get_key(cursor, &key)) != 0)
+                return ret;
+            if (key > lastRecord.getLong())
+                return 0;
+            if ((ret = cursor->remove(cursor)) != 0)
+                return ret;
+        }
+        return ret == WT_NOTFOUND ? 0 : ret;
+    });
+}
+
+Status WiredTigerOplogStoneStorer::removeFrom(const RecordId& firstRecord) {
+    return _runInTxn([&](WT_CURSOR* cursor) {
+        int ret;
+        while ((ret = cursor->prev(cursor)) == 0) {
+            int64_t key;
+            if ((ret = cursor->get_key(cursor, &key)) != 0)
+                return ret;
+            if (key < firstRecord.getLong())
+                return 0;
+            if ((ret = cursor->remove(cursor)) != 0)
+                return ret;
+        }
+        return ret == WT_NOTFOUND ? 0 : ret;
+    });
+}
+
+Status WiredTigerOplogStoneStorer::replaceAll(StringData ident,
+                                              const std::vector<PersistedStone>& stones) {
+    return _runInTxn([&](WT_CURSOR* cursor) {
+        int ret;
+        while ((ret = cursor->next(cursor)) == 0) {
+            if ((ret = cursor->remove(cursor)) != 0)
+                return ret;
+        }
+        if (ret != WT_NOTFOUND)
+            return ret;
+
+        for (const auto& stone : stones) {
+            if ((ret = insertStone(cursor, ident, stone)) != 0)
+                return ret;
+        }
+        return 0;
+    });
+}
+
+template <typename Func>
+Status WiredTigerOplogStoneStorer::_runInTxn(Func&& func) {
+    // When the session is destructed, it closes any cursors that remain open.
+    WiredTigerSession session(_conn);
+    WT_SESSION* s = session.getSession();
+    WT_CURSOR* cursor = session.getNewCursor(_storageUri, "overwrite=true");
+
+    // These writes may happen while committing an oplog insert, so, as for the size storer, let the
+    // transaction time itself out instead of risking a deadlock with cache eviction. The stones are
+    // only a hint and the caller rewrites them on failure.
+    WiredTigerBeginTxnBlock txnOpen(s, "operation_timeout_ms=10");
+    int ret = func(cursor);
+    if (ret != 0) {
+        return wtRCToStatus(ret, s, "Failed to update persisted oplog truncate markers: ");
+    }
+    txnOpen.done();
+    return wtRCToStatus(s->commit_transaction(s, nullptr), s);
+}
+
+}  // namespace mongo
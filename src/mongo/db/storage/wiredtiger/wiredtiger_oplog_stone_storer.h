@@ -0,0 +1,107 @@
+/**
+ *    Copyright (C) 2022-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <wiredtiger.h>
+
+#include "mongo/base/status.h"
+#include "mongo/base/string_data.h"
+#include "mongo/db/record_id.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/**
+ * The WiredTigerOplogStoneStorer durably records the oplog stones (truncate markers) of the active
+ * oplog in a separate WiredTiger table, so that they can be restored on startup instead of being
+ * recomputed by scanning or sampling the oplog. Entries are keyed by the RecordId of the last
+ * record in the stone and carry a BSON value with the stone's approximate record count and size,
+ * its wall clock time and the ident of the oplog it belongs to.
+ *
+ * The table is maintained incrementally as stones are created and truncated. It is only a hint: a
+ * failed write leaves the persisted stones stale, and the caller is expected to rewrite the whole
+ * table with replaceAll() once it notices the failure. Callers must serialize access.
+ */
+class WiredTigerOplogStoneStorer {
+public:
+    struct PersistedStone {
+        RecordId lastRecord;
+        int64_t records;
+        int64_t bytes;
+        Date_t wallTime;
+    };
+
+    WiredTigerOplogStoneStorer(WT_CONNECTION* conn, const std::string& storageUri);
+    ~WiredTigerOplogStoneStorer() = default;
+
+    /**
+     * Returns the persisted stones belonging to the oplog with the given ident, ordered by
+     * 'lastRecord'. Returns an empty vector if the table is empty or contains entries written for
+     * another ident, e.g. because the oplog was dropped and recreated.
+     */
+    std::vector<PersistedStone> load(StringData ident) const;
+
+    /**
+     * Adds a newly created stone.
+     */
+    Status insert(StringData ident, const PersistedStone& stone);
+
+    /**
+     * Removes the stones whose last record is less than or equal to 'lastRecord'.
+     */
+    Status removeUpTo(const RecordId& lastRecord);
+
+    /**
+     * Removes the stones whose last record is greater than or equal to 'firstRecord'.
+     */
+    Status removeFrom(const RecordId& firstRecord);
+
+    /**
+     * Atomically replaces the contents of the table with 'stones'.
+     */
+    Status replaceAll(StringData ident, const std::vector<PersistedStone>& stones);
+
+private:
+    /**
+     * Runs 'func' in its own WiredTiger transaction on a cursor opened over the table, committing
+     * only if 'func' returns 0.
+     */
+    template <typename Func>
+    Status _runInTxn(Func&& func);
+
+    WT_CONNECTION* _conn;
+    const std::string _storageUri;
+};
+
+}  // namespace mongo
@@ -59,6 +59,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_oplog_stone_storer.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_prepare_conflict.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store_oplog_stones.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
@@ -127,6 +128,11 @@ void appendNumericStats(WT_SESSION* s, const std::string& uri, BSONObjBuilder& b
     }
 }
 
+WiredTigerOplogStoneStorer::PersistedStone toPersistedStone(
+    const WiredTigerRecordStore::OplogStones::Stone& stone) {
+    return {stone.lastRecord, stone.records, stone.bytes, stone.wallTime};
+}
+
 std::size_t computeRecordIdSize(const RecordId& id) {
     // We previously weren't accounting for WiredTiger key size when it was an int64_t, thus we
     // return 0 in those cases. With the clustering capabilities we now support potentially large
@@ -219,9 +225,66 @@ WiredTigerRecordStore::OplogStones::OplogStones(OperationContext* opCtx, WiredTi
     invariant(_minBytesPerStone > 0);
 
     _calculateStones(opCtx, numStonesToKeep);
+    if (_persistedStonesStale) {
+        // The stones were recomputed, replace whatever a previous run persisted.
+        _persistAllStones_inlock();
+    }
     _pokeReclaimThreadIfNeeded();  // Reclaim stones if over the limit.
 }
 
+WiredTigerOplogStoneStorer* WiredTigerRecordStore::OplogStones::_getStorer() const {
+    if (!gPersistOplogTruncationPoints || !_rs->_kvEngine) {
+        return nullptr;
+    }
+    return _rs->_kvEngine->getOplogStoneStorer();
+}
+
+template <typename Func>
+void WiredTigerRecordStore::OplogStones::_updatePersistedStones_inlock(Func&& write) {
+    if (_persistedStonesStale) {
+        _persistAllStones_inlock();
+        return;
+    }
+
+    auto storer = _getStorer();
+    if (!storer) {
+        return;
+    }
+
+    Status status = write(storer);
+    if (!status.isOK()) {
+        LOGV2_DEBUG(7095403,
+                    1,
+                    "Failed to update the persisted oplog truncate markers, they will be rewritten "
+                    "on the next change",
+                    "error"_attr = status);
+        _persistedStonesStale = true;
+    }
+}
+
+void WiredTigerRecordStore::OplogStones::_persistAllStones_inlock() {
+    auto storer = _getStorer();
+    if (!storer) {
+        return;
+    }
+
+    std::vector<WiredTigerOplogStoneStorer::PersistedStone> stones;
+    stones.reserve(_stones.size());
+    for (const auto& stone : _stones) {
+        stones.push_back(toPersistedStone(stone));
+    }
+
+    Status status = storer->replaceAll(_rs->getIdent(), stones);
+    if (!status.isOK()) {
+        LOGV2_DEBUG(7095404,
+                    1,
+                    "Failed to persist the oplog truncate markers, they will be rewritten on the "
+                    "next change",
+                    "error"_attr = status);
+    }
+    _persistedStonesStale = !status.isOK();
+}
+
 bool WiredTigerRecordStore::OplogStones::isDead() {
     stdx::lock_guard<Latch> lk(_oplogReclaimMutex);
     return _isDead;
@@ -308,7 +371,10 @@ WiredTigerRecordStore::OplogStones::peekOldestStoneIfNeeded() const {
 
 void WiredTigerRecordStore::OplogStones::popOldestStone() {
     stdx::lock_guard<Latch> lk(_mutex);
+    RecordId lastRecord = std::move(_stones.front().lastRecord);
     _stones.pop_front();
+    _updatePersistedStones_inlock(
+        [&](WiredTigerOplogStoneStorer* storer) { return storer->removeUpTo(lastRecord); });
 }
 
 void WiredTigerRecordStore::OplogStones::createNewStoneIfNeeded(OperationContext* opCtx,
@@ -358,6 +424,9 @@ void WiredTigerRecordStore::OplogStones::createNewStoneIfNeeded(OperationContext
                 "wallTime"_attr = stone.wallTime,
                 "numStones"_attr = _stones.size());
 
+    _updatePersistedStones_inlock([&](WiredTigerOplogStoneStorer* storer) {
+        return storer->insert(_rs->getIdent(), toPersistedStone(stone));
+    });
     _pokeReclaimThreadIfNeeded();
 }
 
@@ -377,6 +446,9 @@ void WiredTigerRecordStore::OplogStones::clearStonesOnCommit(OperationContext* o
 
         stdx::lock_guard<Latch> lk(_mutex);
         _stones.clear();
+        _updatePersistedStones_inlock([&](WiredTigerOplogStoneStorer* storer) {
+            return storer->replaceAll(_rs->getIdent(), {});
+        });
     });
 }
 
@@ -402,6 +474,11 @@ void WiredTigerRecordStore::OplogStones::updateStonesAfterCappedTruncateAfter(
     // Remove the stones corresponding to the records that were deleted.
     int64_t offset = _stones.size() - numStonesToRemove;
     _stones.erase(_stones.begin() + offset, _stones.end());
+    if (numStonesToRemove > 0) {
+        _updatePersistedStones_inlock([&](WiredTigerOplogStoneStorer* storer) {
+            return storer->removeFrom(firstRemovedId);
+        });
+    }
 
     // Account for any remaining records from a partially truncated stone in the stone currently
     // being filled.
@@ -448,6 +525,12 @@ void WiredTigerRecordStore::OplogStones::_calculateStones(OperationContext* opCt
         return;
     }
 
+    // Prefer the stones persisted by the previous run, which avoids touching the oplog beyond its
+    // first and last records.
+    if (_loadPersistedStones(opCtx)) {
+        return;
+    }
+
     // Only use sampling to estimate where to place the oplog stones if the number of samples drawn
     // is less than 5% of the collection.
     const uint64_t kMinSampleRatioForRandCursor = 20;
@@ -470,6 +553,86 @@ void WiredTigerRecordStore::OplogStones::_calculateStones(OperationContext* opCt
     _calculateStonesBySampling(opCtx, int64_t(estRecordsPerStone), int64_t(estBytesPerStone));
 }
 
+bool WiredTigerRecordStore::OplogStones::_loadPersistedStones(OperationContext* opCtx) {
+    auto storer = _getStorer();
+    if (!storer) {
+        return false;
+    }
+
+    auto persistedStones = storer->load(_rs->getIdent());
+    if (persistedStones.empty()) {
+        LOGV2(7095405, "No persisted oplog truncate markers found");
+        return false;
+    }
+
+    RecordId earliestRecord;
+    RecordId latestRecord;
+    {
+        auto record = _rs->getCursor(opCtx, /*forward=*/true)->next();
+        if (!record) {
+            return false;
+        }
+        earliestRecord = record->id;
+    }
+    {
+        auto record = _rs->getCursor(opCtx, /*forward=*/false)->next();
+        if (!record) {
+            return false;
+        }
+        latestRecord = record->id;
+    }
+
+    std::deque<Stone> stones;
+    int64_t recordsInStones = 0;
+    int64_t bytesInStones = 0;
+    for (const auto& persisted : persistedStones) {
+        if (persisted.lastRecord < earliestRecord) {
+            // The oplog was truncated past this stone before its removal was persisted.
+            continue;
+        }
+
+        if (persisted.lastRecord > latestRecord || persisted.records < 0 || persisted.bytes < 0) {
+            LOGV2(7095406,
+                  "Persisted oplog truncate markers are inconsistent with the oplog, ignoring them",
+                  "lastRecord"_attr = persisted.lastRecord,
+                  "earliestRecord"_attr = earliestRecord,
+                  "latestRecord"_attr = latestRecord);
+            return false;
+        }
+
+        recordsInStones += persisted.records;
+        bytesInStones += persisted.bytes;
+        stones.emplace_back(
+            persisted.records, persisted.bytes, persisted.lastRecord, persisted.wallTime);
+    }
+
+    long long numRecords = _rs->numRecords(opCtx);
+    long long dataSize = _rs->dataSize(opCtx);
+    if (recordsInStones > numRecords || bytesInStones > dataSize) {
+        LOGV2(7095407,
+              "Persisted oplog truncate markers exceed the size of the oplog, ignoring them",
+              "recordsInStones"_attr = recordsInStones,
+              "bytesInStones"_attr = bytesInStones,
+              "numRecords"_attr = numRecords,
+              "dataSize"_attr = dataSize);
+        return false;
+    }
+
+    LOGV2(7095408,
+          "Restored the persisted oplog truncate markers",
+          "numStones"_attr = stones.size(),
+          "numIgnored"_attr = persistedStones.size() - stones.size());
+
+    _processByLoading.store(true);
+    _stones = std::move(stones);
+    _currentRecords.store(numRecords - recordsInStones);
+    _currentBytes.store(dataSize - bytesInStones);
+
+    // Drop the persisted stones that no longer cover any part of the oplog.
+    _persistedStonesStale = _stones.size() != persistedStones.size();
+    return true;
+}
+
 void WiredTigerRecordStore::OplogStones::_calculateStonesByScanning(OperationContext* opCtx) {
     _processBySampling.store(false);  // process by scanning
     LOGV2(22384, "Scanning the oplog to determine where to place markers for truncation");
@@ -1725,6 +1888,55 @@ Status WiredTigerRecordStore::doTruncate(OperationContext* opCtx) {
     return Status::OK();
 }
 
+Status WiredTigerRecordStore::doRangeTruncate(OperationContext* opCtx,
+                                              const RecordId& minRecordId,
+                                              const RecordId& maxRecordId,
+                                              int64_t hintDataSizeIncrement,
+                                              int64_t hintNumRecordsIncrement) {
+    // The oplog is only ever truncated through its stones.
+    invariant(!_oplogStones);
+
+    // Position the start cursor on the first record of the range. WiredTiger does not require the
+    // bounds to exist, but an empty range must not reach the truncate call.
+    WiredTigerCursor startWrap(_uri, _tableId, true, opCtx);
+    WT_CURSOR* start = startWrap.get();
+    int ret;
+    if (minRecordId.isNull()) {
+        ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return start->next(start); });
+    } else {
+        CursorKey startKey = makeCursorKey(minRecordId, _keyFormat);
+        setKey(start, &startKey);
+        int cmp;
+        ret = wiredTigerPrepareConflictRetry(opCtx,
+                                             [&] { return start->search_near(start, &cmp); });
+        if (ret == 0 && cmp < 0) {
+            ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return start->next(start); });
+        }
+    }
+    if (ret == WT_NOTFOUND) {
+        return Status::OK();
+    }
+    invariantWTOK(ret, start->session);
+    if (!maxRecordId.isNull() && getKey(start) > maxRecordId) {
+        return Status::OK();
+    }
+
+    boost::optional<WiredTigerCursor> stopWrap;
+    WT_CURSOR* stop = nullptr;
+    if (!maxRecordId.isNull()) {
+        stopWrap.emplace(_uri, _tableId, true, opCtx);
+        stop = stopWrap->get();
+        CursorKey stopKey = makeCursorKey(maxRecordId, _keyFormat);
+        setKey(stop, &stopKey);
+    }
+
+    WT_SESSION* session = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
+    invariantWTOK(WT_OP_CHECK(session->truncate(session, nullptr, start, stop, nullptr)), session);
+    _changeNumRecordsAndDataSize(opCtx, hintNumRecordsIncrement, hintDataSizeIncrement);
+
+    return Status::OK();
+}
+
 Status WiredTigerRecordStore::doCompact(OperationContext* opCtx) {
     dassert(opCtx->lockState()->isWriteLocked());
 
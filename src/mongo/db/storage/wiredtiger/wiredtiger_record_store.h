@@ -175,6 +175,12 @@ public:
 
     Status doTruncate(OperationContext* opCtx) final;
 
+    Status doRangeTruncate(OperationContext* opCtx,
+                           const RecordId& minRecordId,
+                           const RecordId& maxRecordId,
+                           int64_t hintDataSizeIncrement,
+                           int64_t hintNumRecordsIncrement) final;
+
     virtual bool compactSupported() const {
         return !_isEphemeral;
     }
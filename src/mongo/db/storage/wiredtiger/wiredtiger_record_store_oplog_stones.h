@@ -40,6 +40,7 @@ namespace mongo {
 
 class OperationContext;
 class RecordId;
+class WiredTigerOplogStoneStorer;
 
 // Keep "milestones" against the oplog to efficiently remove the old records when the collection
 // grows beyond its desired maximum size.
@@ -70,7 +71,10 @@ public:
 
     void getOplogStonesStats(BSONObjBuilder& builder) const {
         builder.append("totalTimeProcessingMicros", _totalTimeProcessing.load());
-        builder.append("processingMethod", _processBySampling.load() ? "sampling" : "scanning");
+        builder.append("processingMethod",
+                       _processByLoading.load()        ? "persisted"
+                           : _processBySampling.load() ? "sampling"
+                                                       : "scanning");
         if (auto oplogMinRetentionHours = storageGlobalParams.oplogMinRetentionHours.load()) {
             builder.append("oplogMinRetentionHours", oplogMinRetentionHours);
         }
@@ -126,6 +130,10 @@ public:
         return _processBySampling.load();
     }
 
+    bool processedByLoading() const {
+        return _processByLoading.load();
+    }
+
 private:
     class InsertChange;
 
@@ -135,6 +143,20 @@ private:
                                     int64_t estRecordsPerStone,
                                     int64_t estBytesPerStone);
 
+    // Returns the storer persisting the stones, or nullptr if persistence is disabled.
+    WiredTigerOplogStoneStorer* _getStorer() const;
+
+    // Restores the stones persisted by a previous run. Returns false, leaving the stones
+    // untouched, if persistence is disabled or the persisted stones are missing or inconsistent
+    // with the oplog.
+    bool _loadPersistedStones(OperationContext* opCtx);
+
+    // Applies 'write' to the persisted copy of the stones after the in-memory stones changed. If an
+    // earlier write failed, the persisted stones are rewritten as a whole instead.
+    template <typename Func>
+    void _updatePersistedStones_inlock(Func&& write);
+    void _persistAllStones_inlock();
+
     void _pokeReclaimThreadIfNeeded();
 
     static const uint64_t kRandomSamplesPerStone = 10;
@@ -157,10 +179,15 @@ private:
     AtomicWord<int64_t> _totalTimeProcessing;  // Amount of time spent scanning and/or sampling the
                                                // oplog during start up, if any.
     AtomicWord<bool> _processBySampling;       // Whether the oplog was sampled or scanned.
+    AtomicWord<bool> _processByLoading;        // Whether the stones were loaded from disk.
 
     // Protects against concurrent access to the deque of oplog stones.
     mutable Mutex _mutex = MONGO_MAKE_LATCH("OplogStones::_mutex");
     std::deque<OplogStones::Stone> _stones;  // front = oldest, back = newest.
+
+    // True if the persisted copy of '_stones' may not match the in-memory one, either because it
+    // has not been written yet or because an earlier write to it failed. Protected by '_mutex'.
+    bool _persistedStonesStale = true;
 };
 
 }  // namespace mongo
@@ -38,6 +38,7 @@
 #include "mongo/db/catalog/clustered_collection_util.h"
 #include "mongo/db/json.h"
 #include "mongo/db/operation_context_noop.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_oplog_stone_storer.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store_oplog_stones.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store_test_harness.h"
@@ -956,6 +957,95 @@ TEST(WiredTigerRecordStoreTest, OplogStones_Duplicates) {
     }
 }
 
+// Verify that oplog stones are persisted as they are created and truncated, and that rebuilding
+// the stones for the same oplog restores them instead of scanning or sampling the oplog.
+TEST(WiredTigerRecordStoreTest, OplogStones_Persisted) {
+    std::unique_ptr<RecordStoreHarnessHelper> harnessHelper = newRecordStoreHarnessHelper();
+    std::unique_ptr<RecordStore> rs(harnessHelper->newOplogRecordStore());
+
+    WiredTigerRecordStore* wtrs = static_cast<WiredTigerRecordStore*>(rs.get());
+    WiredTigerRecordStore::OplogStones* oplogStones = wtrs->oplogStones();
+    auto wtKvEngine = dynamic_cast<WiredTigerKVEngine*>(harnessHelper->getEngine());
+    auto storer = wtKvEngine->getOplogStoneStorer();
+
+    oplogStones->setMinBytesPerStone(100);
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 1), 50), RecordId(1, 1));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 2), 50), RecordId(1, 2));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 3), 100), RecordId(1, 3));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 4), 50), RecordId(1, 4));
+        ASSERT_EQ(2U, oplogStones->numStones());
+
+        auto persisted = storer->load(wtrs->getIdent());
+        ASSERT_EQ(2U, persisted.size());
+        ASSERT_EQ(RecordId(1, 2), persisted[0].lastRecord);
+        ASSERT_EQ(2, persisted[0].records);
+        ASSERT_EQ(100, persisted[0].bytes);
+        ASSERT_EQ(RecordId(1, 3), persisted[1].lastRecord);
+        ASSERT_EQ(1, persisted[1].records);
+        ASSERT_EQ(100, persisted[1].bytes);
+
+        // Stones persisted for another oplog are ignored.
+        ASSERT(storer->load("local.oplog.other").empty());
+    }
+
+    // Make sure all are visible.
+    rs->waitForAllEarlierOplogWritesToBeVisible(harnessHelper->newOperationContext().get());
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        WiredTigerRecordStore::OplogStones restoredStones(opCtx.get(), wtrs);
+        ASSERT(restoredStones.processedByLoading());
+        ASSERT_FALSE(restoredStones.processedBySampling());
+        ASSERT_EQ(2U, restoredStones.numStones());
+        ASSERT_EQ(1, restoredStones.currentRecords());
+        ASSERT_EQ(50, restoredStones.currentBytes());
+    }
+
+    {
+        // Truncating the oplog after the first stone removes the persisted stones it covered.
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        rs->cappedTruncateAfter(opCtx.get(),
+                                RecordId(1, 2),
+                                false /* inclusive */,
+                                nullptr /* aboutToDelete callback */);
+        ASSERT_EQ(1U, oplogStones->numStones());
+
+        auto persisted = storer->load(wtrs->getIdent());
+        ASSERT_EQ(1U, persisted.size());
+        ASSERT_EQ(RecordId(1, 2), persisted[0].lastRecord);
+    }
+
+    {
+        // Reclaiming the oldest stone removes it from the persisted stones as well.
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(2, 1), 100), RecordId(2, 1));
+        ASSERT_EQ(2U, oplogStones->numStones());
+        ASSERT_OK(wtrs->updateOplogSize(100));
+        wtrs->reclaimOplog(opCtx.get(), Timestamp(2, 2));
+        ASSERT_EQ(1U, oplogStones->numStones());
+
+        auto persisted = storer->load(wtrs->getIdent());
+        ASSERT_EQ(1U, persisted.size());
+        ASSERT_EQ(RecordId(2, 1), persisted[0].lastRecord);
+    }
+
+    {
+        // Truncating the whole oplog clears the persisted stones.
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork wuow(opCtx.get());
+        ASSERT_OK(rs->truncate(opCtx.get()));
+        wuow.commit();
+
+        ASSERT_EQ(0U, oplogStones->numStones());
+        ASSERT(storer->load(wtrs->getIdent()).empty());
+    }
+}
+
 TEST(WiredTigerRecordStoreTest, GetLatestOplogTest) {
     unique_ptr<RecordStoreHarnessHelper> harnessHelper(newRecordStoreHarnessHelper());
     unique_ptr<RecordStore> rs(harnessHelper->newOplogRecordStore());
@@ -0,0 +1,140 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/db/timeseries/bucket_bloom_filter.h"
+
+#include <cstring>
+
+#include "mongo/db/hasher.h"
+
+namespace mongo {
+namespace timeseries {
+namespace {
+
+// Derives the filter's bit positions from two halves of one 64-bit hash, as described by Kirsch
+// and Mitzenmacher, "Less Hashing, Same Performance: Building a Better Bloom Filter".
+template <typename Fn>
+void forEachBitPosition(const BSONElement& value, Fn&& fn) {
+    auto hash = static_cast<uint64_t>(
+        BSONElementHasher::hash64(value, BSONElementHasher::DEFAULT_HASH_SEED));
+    auto h1 = static_cast<uint32_t>(hash);
+    auto h2 = static_cast<uint32_t>(hash >> 32);
+    for (uint32_t i = 0; i < BucketBloomFilter::kNumHashFunctions; ++i) {
+        // The positions are persisted, so compute them in fixed-width arithmetic.
+        uint32_t combined = h1 + i * h2;
+        fn(static_cast<uint32_t>(combined % BucketBloomFilter::kNumBits));
+    }
+}
+
+}  // namespace
+
+bool BucketBloomFilter::canFilterOn(const BSONElement& value, bool hasSimpleCollation) {
+    switch (value.type()) {
+        case NumberInt:
+        case NumberLong:
+        case NumberDouble:
+        case NumberDecimal:
+        case jstOID:
+        case Bool:
+        case Date:
+        case bsonTimestamp:
+        case BinData:
+            return true;
+        case String:
+            return hasSimpleCollation;
+        default:
+            // Null also matches missing fields, and arrays and objects have more complicated
+            // equality semantics. None of these are worth filtering on.
+            return false;
+    }
+}
+
+std::vector<uint32_t> BucketBloomFilter::bitPositions(const BSONElement& value) {
+    std::vector<uint32_t> positions;
+    positions.reserve(kNumHashFunctions);
+    forEachBitPosition(value, [&](uint32_t position) { positions.push_back(position); });
+    return positions;
+}
+
+BucketBloomFilter BucketBloomFilter::parse(const BSONElement& elem) {
+    BucketBloomFilter filter;
+    int len = 0;
+    const char* data = nullptr;
+    if (elem.type() == BinData) {
+        data = elem.binData(len);
+    }
+    if (!data || static_cast<std::size_t>(len) != filter._bits.size()) {
+        filter._usable = false;
+        return filter;
+    }
+    std::memcpy(filter._bits.data(), data, len);
+    return filter;
+}
+
+bool BucketBloomFilter::add(const BSONElement& value) {
+    if (!_usable) {
+        return false;
+    }
+    if (value.type() == Array) {
+        _usable = false;
+        return true;
+    }
+
+    bool changed = false;
+    forEachBitPosition(value, [&](uint32_t position) {
+        uint8_t mask = 1 << (position % 8);
+        auto& byte = _bits[position / 8];
+        changed |= !(byte & mask);
+        byte |= mask;
+    });
+    return changed;
+}
+
+bool BucketBloomFilter::mayContain(const BSONElement& value) const {
+    if (!_usable) {
+        return true;
+    }
+
+    bool allSet = true;
+    forEachBitPosition(value, [&](uint32_t position) {
+        allSet &= static_cast<bool>(_bits[position / 8] & (1 << (position % 8)));
+    });
+    return allSet;
+}
+
+void BucketBloomFilter::appendTo(BSONObjBuilder* builder, StringData fieldName) const {
+    if (!_usable) {
+        builder->appendNull(fieldName);
+        return;
+    }
+    builder->appendBinData(fieldName, _bits.size(), BinDataGeneral, _bits.data());
+}
+
+}  // namespace timeseries
+}  // namespace mongo
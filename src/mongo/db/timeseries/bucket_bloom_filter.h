@@ -0,0 +1,103 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "mongo/bson/bsonelement.h"
+#include "mongo/bson/bsonobjbuilder.h"
+
+namespace mongo {
+namespace timeseries {
+
+/**
+ * A Bloom filter over the values of one top-level measurement field in a time-series bucket,
+ * stored as 'control.bloom.<field>'. It lets equality predicates on high-cardinality fields skip
+ * buckets whose 'control.min' and 'control.max' would otherwise admit the value.
+ *
+ * The filter has a fixed size and number of hash functions, so that the bit positions for a value
+ * can be computed once per query and tested against every bucket with $bitsAllSet. Values are
+ * hashed with BSONElementHasher, which treats numerically equal values of different numeric types
+ * alike, matching the semantics of $eq.
+ *
+ * A filter stops being usable once an array is inserted into it, since {f: v} then also matches
+ * arrays containing 'v'. An unusable filter is stored as null and never excludes a bucket.
+ */
+class BucketBloomFilter {
+public:
+    static constexpr std::size_t kNumBits = 2048;
+    static constexpr std::size_t kNumHashFunctions = 3;
+
+    /**
+     * Returns whether an equality predicate against 'value' can be answered by the filter. String
+     * comparisons are only eligible under the simple collation, since the filter hashes the raw
+     * string bytes.
+     */
+    static bool canFilterOn(const BSONElement& value, bool hasSimpleCollation);
+
+    /**
+     * Returns the bits which are set in every filter containing 'value'.
+     */
+    static std::vector<uint32_t> bitPositions(const BSONElement& value);
+
+    /**
+     * Reconstructs a filter from its stored representation. Anything other than a BinData of the
+     * expected length, including a missing element, produces an unusable filter.
+     */
+    static BucketBloomFilter parse(const BSONElement& elem);
+
+    /**
+     * Adds the value of a measurement field. Returns whether the filter changed.
+     */
+    bool add(const BSONElement& value);
+
+    /**
+     * Returns whether 'value' may have been added to the filter. Always true for an unusable
+     * filter.
+     */
+    bool mayContain(const BSONElement& value) const;
+
+    bool usable() const {
+        return _usable;
+    }
+
+    /**
+     * Appends the stored representation of the filter under 'fieldName'.
+     */
+    void appendTo(BSONObjBuilder* builder, StringData fieldName) const;
+
+private:
+    std::array<uint8_t, kNumBits / 8> _bits{};
+    bool _usable = true;
+};
+
+}  // namespace timeseries
+}  // namespace mongo
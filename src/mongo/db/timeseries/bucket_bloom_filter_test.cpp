@@ -0,0 +1,120 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/db/timeseries/bucket_bloom_filter.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/json.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo::timeseries {
+namespace {
+
+TEST(BucketBloomFilterTest, ContainsAddedValues) {
+    BucketBloomFilter filter;
+    auto added = fromjson("{a: 'sensor-17', b: 42, c: {$oid: '0102030405060708090a0b0c'}}");
+    for (auto&& elem : added) {
+        ASSERT_TRUE(filter.add(elem));
+        ASSERT_FALSE(filter.add(elem));
+    }
+    for (auto&& elem : added) {
+        ASSERT_TRUE(filter.mayContain(elem));
+    }
+
+    // With three values in a 2048-bit filter, a false positive for every one of these is
+    // vanishingly unlikely.
+    size_t matches = 0;
+    for (int i = 0; i < 100; ++i) {
+        auto obj = BSON("v"
+                        << "sensor-" + std::to_string(1000 + i));
+        matches += filter.mayContain(obj.firstElement());
+    }
+    ASSERT_LT(matches, 100U);
+}
+
+TEST(BucketBloomFilterTest, NumericallyEqualValuesHashAlike) {
+    BucketBloomFilter filter;
+    auto obj = BSON("i" << 7 << "l" << 7LL << "d" << 7.0 << "dec" << Decimal128(7));
+    filter.add(obj["i"]);
+    ASSERT_TRUE(filter.mayContain(obj["l"]));
+    ASSERT_TRUE(filter.mayContain(obj["d"]));
+    ASSERT_TRUE(filter.mayContain(obj["dec"]));
+    ASSERT_EQ(BucketBloomFilter::bitPositions(obj["i"]),
+              BucketBloomFilter::bitPositions(obj["d"]));
+}
+
+TEST(BucketBloomFilterTest, ArrayMakesFilterUnusable) {
+    BucketBloomFilter filter;
+    auto obj = fromjson("{a: 1, b: [2, 3], c: 4}");
+    filter.add(obj["a"]);
+    ASSERT_TRUE(filter.usable());
+    ASSERT_TRUE(filter.add(obj["b"]));
+    ASSERT_FALSE(filter.usable());
+    ASSERT_FALSE(filter.add(obj["c"]));
+    ASSERT_TRUE(filter.mayContain(obj["c"]));
+
+    BSONObjBuilder builder;
+    filter.appendTo(&builder, "f");
+    ASSERT_BSONOBJ_EQ(builder.obj(), BSON("f" << BSONNULL));
+}
+
+TEST(BucketBloomFilterTest, ParseRoundTrip) {
+    BucketBloomFilter filter;
+    auto obj = fromjson("{a: 'x', b: 'y', c: 'z'}");
+    filter.add(obj["a"]);
+    filter.add(obj["b"]);
+
+    BSONObjBuilder builder;
+    filter.appendTo(&builder, "f");
+    auto stored = builder.obj();
+    ASSERT_EQ(stored["f"].type(), BSONType::BinData);
+
+    auto parsed = BucketBloomFilter::parse(stored["f"]);
+    ASSERT_TRUE(parsed.usable());
+    ASSERT_TRUE(parsed.mayContain(obj["a"]));
+    ASSERT_TRUE(parsed.mayContain(obj["b"]));
+    ASSERT_EQ(parsed.mayContain(obj["c"]), filter.mayContain(obj["c"]));
+
+    // A missing or malformed filter never excludes anything.
+    ASSERT_FALSE(BucketBloomFilter::parse(BSONElement()).usable());
+    ASSERT_FALSE(BucketBloomFilter::parse(BSON("f" << 1).firstElement()).usable());
+}
+
+TEST(BucketBloomFilterTest, CanFilterOn) {
+    auto obj = fromjson("{n: 1, s: 'abc', o: {x: 1}, a: [1], z: null}");
+    ASSERT_TRUE(BucketBloomFilter::canFilterOn(obj["n"], false));
+    ASSERT_TRUE(BucketBloomFilter::canFilterOn(obj["s"], true));
+    ASSERT_FALSE(BucketBloomFilter::canFilterOn(obj["s"], false));
+    ASSERT_FALSE(BucketBloomFilter::canFilterOn(obj["o"], true));
+    ASSERT_FALSE(BucketBloomFilter::canFilterOn(obj["a"], true));
+    ASSERT_FALSE(BucketBloomFilter::canFilterOn(obj["z"], true));
+}
+
+}  // namespace
+}  // namespace mongo::timeseries
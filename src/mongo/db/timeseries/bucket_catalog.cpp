@@ -36,6 +36,7 @@
 #include <algorithm>
 #include <boost/iterator/transform_iterator.hpp>
 #include <boost/utility/in_place_factory.hpp>
+#include <limits>
 
 #include "mongo/bson/util/bsoncolumn.h"
 #include "mongo/db/catalog/database_holder.h"
@@ -147,13 +148,15 @@ Status getTimeseriesBucketClearedError(const OID& bucketId,
  * buckets.
  */
 int32_t getCacheDerivedBucketMaxSize(StorageEngine* storageEngine, uint32_t workloadCardinality) {
+    if (!feature_flags::gTimeseriesScalabilityImprovements.isEnabled(
+            serverGlobalParams.featureCompatibility)) {
+        return INT_MAX;
+    }
+
     invariant(storageEngine);
     uint64_t storageCacheSize =
         static_cast<uint64_t>(storageEngine->getEngine()->getCacheSizeMB() * 1024 * 1024);
-
-    if (!feature_flags::gTimeseriesScalabilityImprovements.isEnabled(
-            serverGlobalParams.featureCompatibility) ||
-        storageCacheSize == 0 || workloadCardinality == 0) {
+    if (storageCacheSize == 0 || workloadCardinality == 0) {
         return INT_MAX;
     }
 
@@ -779,6 +782,10 @@ const BSONObj& BucketCatalog::WriteBatch::max() const {
     return _max;
 }
 
+const BSONObj& BucketCatalog::WriteBatch::bloomFilters() const {
+    return _bloomFilters;
+}
+
 const StringMap<std::size_t>& BucketCatalog::WriteBatch::newFieldNamesToBeInserted() const {
     return _newFieldNamesToBeInserted;
 }
@@ -854,6 +861,22 @@ void BucketCatalog::WriteBatch::_prepareCommit(Bucket* bucket) {
         bucket->_memoryUsage += _min.objsize();
         bucket->_memoryUsage += _max.objsize();
     }
+
+    bool bloomFiltersChanged = !isUpdate;
+    for (auto&& [fieldName, filter] : bucket->_bloomFilters) {
+        for (const auto& doc : _measurements) {
+            if (auto elem = doc[fieldName]) {
+                bloomFiltersChanged |= filter.add(elem);
+            }
+        }
+    }
+    if (bloomFiltersChanged && !bucket->_bloomFilters.empty()) {
+        BSONObjBuilder builder;
+        for (auto&& [fieldName, filter] : bucket->_bloomFilters) {
+            filter.appendTo(&builder, fieldName);
+        }
+        _bloomFilters = builder.obj();
+    }
 }
 
 void BucketCatalog::WriteBatch::_finish(const CommitInfo& info) {
@@ -869,6 +892,13 @@ void BucketCatalog::WriteBatch::_abort(const Status& status) {
     _promise.setError(status);
 }
 
+BucketCatalog::BucketCatalog() : BucketCatalog(gTimeseriesBucketCatalogStripes) {}
+
+BucketCatalog::BucketCatalog(std::size_t numberOfStripes) : _stripes(numberOfStripes) {
+    invariant(numberOfStripes > 0);
+    invariant(numberOfStripes <= std::numeric_limits<StripeNumber>::max() + std::size_t{1});
+}
+
 BucketCatalog& BucketCatalog::get(ServiceContext* svcCtx) {
     return getBucketCatalog(svcCtx);
 }
@@ -1306,7 +1336,7 @@ BucketCatalog::StripeNumber BucketCatalog::_getStripeNumber(const BucketKey& key
     if (MONGO_unlikely(alwaysUseSameBucketCatalogStripe.shouldFail())) {
         return 0;
     }
-    return key.hash % kNumberOfStripes;
+    return key.hash % _stripes.size();
 }
 
 const BucketCatalog::Bucket* BucketCatalog::_findBucket(const Stripe& stripe,
@@ -1447,6 +1477,16 @@ StatusWith<std::unique_ptr<BucketCatalog::Bucket>> BucketCatalog::_rehydrateBuck
                            .getField(options.getTimeField())
                            .Date();
 
+    // A filter missing from the document is rebuilt as unusable, so that it never wrongly excludes
+    // the bucket.
+    if (auto bloomFilterFields = options.getBucketBloomFilterFields()) {
+        auto bloomObj = controlField.getObjectField(timeseries::kBucketControlBloomFieldName);
+        for (auto&& fieldName : *bloomFilterFields) {
+            bucket->_bloomFilters.emplace(
+                fieldName, timeseries::BucketBloomFilter::parse(bloomObj[fieldName]));
+        }
+    }
+
     // Populate the top-level data field names.
     const BSONObj& dataObj = bucketDoc.getObjectField(timeseries::kBucketDataFieldName);
     for (const BSONElement& dataElem : dataObj) {
@@ -2082,6 +2122,12 @@ BucketCatalog::Bucket* BucketCatalog::_allocateBucket(Stripe* stripe,
 
     bucket->_timeField = info.options.getTimeField().toString();
     bucket->_minTime = roundedTime;
+    if (auto bloomFilterFields = info.options.getBucketBloomFilterFields()) {
+        for (auto&& fieldName : *bloomFilterFields) {
+            bucket->_bloomFilters.emplace(fieldName, timeseries::BucketBloomFilter{});
+        }
+        bucket->_memoryUsage += bloomFilterFields->size() * sizeof(timeseries::BucketBloomFilter);
+    }
 
     // Make sure we set the control.min time field to match the rounded _id timestamp.
     auto controlDoc = buildControlMinTimestampDoc(info.options.getTimeField(), roundedTime);
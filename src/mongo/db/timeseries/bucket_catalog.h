@@ -38,6 +38,7 @@
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/ops/single_write_result_gen.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/timeseries/bucket_bloom_filter.h"
 #include "mongo/db/timeseries/flat_bson.h"
 #include "mongo/db/timeseries/timeseries_gen.h"
 #include "mongo/db/views/view.h"
@@ -53,7 +54,7 @@ protected:
     static constexpr std::size_t kNumStaticNewFields = 10;
     using NewFieldNames = boost::container::small_vector<StringMapHashedKey, kNumStaticNewFields>;
 
-    using StripeNumber = std::uint8_t;
+    using StripeNumber = std::uint16_t;
 
     using EraCountMap = std::map<uint64_t, uint64_t>;
 
@@ -211,6 +212,7 @@ public:
         const std::vector<BSONObj>& measurements() const;
         const BSONObj& min() const;
         const BSONObj& max() const;
+        const BSONObj& bloomFilters() const;
         const StringMap<std::size_t>& newFieldNamesToBeInserted() const;
         uint32_t numPreviouslyCommittedMeasurements() const;
         bool needToDecompressBucketBeforeInserting() const;
@@ -234,9 +236,9 @@ public:
         void _recordNewFields(Bucket* bucket, NewFieldNames&& fields);
 
         /**
-         * Prepares the batch for commit. Sets min/max appropriately, records the number of
-         * documents that have previously been committed to the bucket, and renders the batch
-         * inactive. Must have commit rights.
+         * Prepares the batch for commit. Sets min/max and the Bloom filters appropriately, records
+         * the number of documents that have previously been committed to the bucket, and renders
+         * the batch inactive. Must have commit rights.
          */
         void _prepareCommit(Bucket* bucket);
 
@@ -258,6 +260,7 @@ public:
         std::vector<BSONObj> _measurements;
         BSONObj _min;  // Batch-local min; full if first batch, updates otherwise.
         BSONObj _max;  // Batch-local max; full if first batch, updates otherwise.
+        BSONObj _bloomFilters;  // All of the bucket's filters if any changed, empty otherwise.
         uint32_t _numPreviouslyCommittedMeasurements = 0;
         StringMap<std::size_t> _newFieldNamesToBeInserted;    // Value is hash of string key
         bool _needToDecompressBucketBeforeInserting = false;  // Bucket is compressed on-disk.
@@ -307,7 +310,16 @@ public:
     static BucketCatalog& get(ServiceContext* svcCtx);
     static BucketCatalog& get(OperationContext* opCtx);
 
-    BucketCatalog() = default;
+    /**
+     * Creates a catalog whose number of stripes is determined by the
+     * 'timeseriesBucketCatalogStripes' server parameter.
+     */
+    BucketCatalog();
+
+    /**
+     * Creates a catalog with exactly 'numberOfStripes' stripes.
+     */
+    explicit BucketCatalog(std::size_t numberOfStripes);
 
     BucketCatalog(const BucketCatalog&) = delete;
     BucketCatalog operator=(const BucketCatalog&) = delete;
@@ -371,6 +383,13 @@ public:
                                     CombineWithInsertsFromOtherClients combine,
                                     BucketFindResult bucketFindResult = {});
 
+    /**
+     * Returns the number of stripes the buckets of this catalog are spread across.
+     */
+    std::size_t numberOfStripes() const {
+        return _stripes.size();
+    }
+
     /**
      * Prepares a batch for commit, transitioning it to an inactive state. Caller must already have
      * commit rights on batch. Returns OK if the batch was successfully prepared, or a status
@@ -863,6 +882,10 @@ protected:
         // The minimum and maximum values for each field in the bucket.
         timeseries::MinMax _minmax;
 
+        // The Bloom filters over the committed values of the collection's
+        // 'bucketBloomFilterFields', keyed by field name.
+        StringMap<timeseries::BucketBloomFilter> _bloomFilters;
+
         // The reference schema for measurements in this bucket. May reflect schema of uncommitted
         // measurements.
         timeseries::Schema _schema;
@@ -1156,8 +1179,9 @@ protected:
 
     BucketStateManager _bucketStateManager{&_mutex};
 
-    static constexpr std::size_t kNumberOfStripes = 32;
-    std::array<Stripe, kNumberOfStripes> _stripes;
+    // Buckets are spread across independently-lockable stripes to improve parallelism. The number
+    // of stripes is fixed for the lifetime of the catalog, so the vector is never resized.
+    std::vector<Stripe> _stripes;
 
     // Per-namespace execution stats. This map is protected by '_mutex'. Once you complete your
     // lookup, you can keep the shared_ptr to an individual namespace's stats object and release the
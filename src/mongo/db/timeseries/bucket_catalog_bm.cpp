@@ -0,0 +1,116 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/base/init.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/client.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/timeseries/bucket_catalog.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace {
+
+constexpr int kMaxThreads = 64;
+
+// Each thread inserts measurements for its own set of metadata values, so that threads only
+// contend on the stripes their buckets happen to share.
+constexpr int kMetaValuesPerThread = 8;
+
+MONGO_INITIALIZER_GENERAL(BucketCatalogBenchmarkServiceContext, (), ())
+(InitializerContext* context) {
+    setGlobalServiceContext(ServiceContext::make());
+}
+
+const NamespaceString kNss{"bucket_catalog_bm", "ts"};
+
+TimeseriesOptions makeTimeseriesOptions() {
+    TimeseriesOptions options{"time"};
+    options.setMetaField("meta"_sd);
+    return options;
+}
+
+BSONObj makeMeasurement(int threadIndex, int i) {
+    int meta = threadIndex * kMetaValuesPerThread + i % kMetaValuesPerThread;
+    return BSON("time" << Date_t::now() << "meta" << meta << "value" << i);
+}
+
+void commit(BucketCatalog& catalog, const std::shared_ptr<BucketCatalog::WriteBatch>& batch) {
+    if (!batch || !batch->claimCommitRights()) {
+        return;
+    }
+    if (catalog.prepareCommit(batch).isOK()) {
+        catalog.finish(batch, {});
+    }
+}
+
+class BucketCatalogBenchmark : public benchmark::Fixture {
+protected:
+    // Created by the first thread before the benchmark loop starts, which acts as a barrier for
+    // the other threads.
+    static std::unique_ptr<BucketCatalog> catalog;
+};
+
+std::unique_ptr<BucketCatalog> BucketCatalogBenchmark::catalog;
+
+BENCHMARK_DEFINE_F(BucketCatalogBenchmark, BM_Insert)(benchmark::State& state) {
+    if (state.thread_index == 0) {
+        catalog = std::make_unique<BucketCatalog>(static_cast<std::size_t>(state.range(0)));
+    }
+
+    auto client = getGlobalServiceContext()->makeClient(
+        str::stream() << "bucket catalog benchmark thread " << state.thread_index);
+    auto opCtx = client->makeOperationContext();
+    const auto options = makeTimeseriesOptions();
+
+    int i = 0;
+    for (auto keepRunning : state) {
+        auto result = catalog->insert(opCtx.get(),
+                                      kNss,
+                                      nullptr,
+                                      options,
+                                      makeMeasurement(state.thread_index, i++),
+                                      BucketCatalog::CombineWithInsertsFromOtherClients::kDisallow);
+        commit(*catalog, result.getValue().batch);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Compare the default stripe count against a larger one, to measure whether the default should
+// scale with the machine.
+BENCHMARK_REGISTER_F(BucketCatalogBenchmark, BM_Insert)
+    ->Arg(32)
+    ->Arg(256)
+    ->ThreadRange(1, kMaxThreads)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace mongo
@@ -282,6 +282,50 @@ TEST_F(BucketCatalogTest, InsertIntoSameBucket) {
     ASSERT_OK(result3.getStatus());
 }
 
+TEST_F(BucketCatalogTest, BloomFiltersOnlyWrittenWhenChanged) {
+    auto options = _getTimeseriesOptions(_ns1);
+    options.setBucketBloomFilterFields(std::vector<std::string>{"a"});
+
+    auto commit = [&](const BSONObj& doc) {
+        auto batch = _bucketCatalog
+                         ->insert(_opCtx,
+                                  _ns1,
+                                  _getCollator(_ns1),
+                                  options,
+                                  doc,
+                                  BucketCatalog::CombineWithInsertsFromOtherClients::kAllow)
+                         .getValue()
+                         .batch;
+        ASSERT(batch->claimCommitRights());
+        ASSERT_OK(_bucketCatalog->prepareCommit(batch));
+        auto bloomFilters = batch->bloomFilters().getOwned();
+        _bucketCatalog->finish(batch, {});
+        return bloomFilters;
+    };
+
+    auto now = Date_t::now();
+    auto values = BSON("x"
+                       << "sensor-1"
+                       << "y"
+                       << "sensor-2");
+
+    // The first commit writes the filter out along with the rest of the bucket.
+    auto filters = commit(BSON(_timeField << now << "a" << values["x"]));
+    ASSERT_EQ(filters["a"].type(), BSONType::BinData);
+    auto filter = timeseries::BucketBloomFilter::parse(filters["a"]);
+    ASSERT_TRUE(filter.mayContain(values["x"]));
+
+    // Adding a value which is already in the filter leaves it alone.
+    ASSERT_TRUE(commit(BSON(_timeField << now << "a" << values["x"])).isEmpty());
+
+    // A new value changes the filter, so it is rewritten in full.
+    filters = commit(BSON(_timeField << now << "a" << values["y"]));
+    ASSERT_EQ(filters["a"].type(), BSONType::BinData);
+    filter = timeseries::BucketBloomFilter::parse(filters["a"]);
+    ASSERT_TRUE(filter.mayContain(values["x"]));
+    ASSERT_TRUE(filter.mayContain(values["y"]));
+}
+
 TEST_F(BucketCatalogTest, GetMetadataReturnsEmptyDocOnMissingBucket) {
     auto batch = _bucketCatalog
                      ->insert(_opCtx,
@@ -341,6 +385,21 @@ TEST_F(BucketCatalogTest, InsertIntoDifferentBuckets) {
     }
 }
 
+TEST_F(BucketCatalogTest, NumberOfStripes) {
+    ASSERT_EQ(_bucketCatalog->numberOfStripes(), 32);
+
+    {
+        BucketCatalog catalog{7};
+        ASSERT_EQ(catalog.numberOfStripes(), 7);
+    }
+
+    {
+        RAIIServerParameterControllerForTest stripes{"timeseriesBucketCatalogStripes", 100};
+        BucketCatalog catalog;
+        ASSERT_EQ(catalog.numberOfStripes(), 100);
+    }
+}
+
 TEST_F(BucketCatalogTest, InsertIntoSameBucketArray) {
     auto result1 = _bucketCatalog->insert(
         _opCtx,
@@ -0,0 +1,178 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/db/timeseries/bucket_compression_service.h"
+
+#include "mongo/db/client.h"
+#include "mongo/db/commands/server_status.h"
+#include "mongo/db/timeseries/timeseries_gen.h"
+#include "mongo/logv2/log.h"
+#include "mongo/logv2/redaction.h"
+#include "mongo/util/scopeguard.h"
+
+#define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kStorage
+
+
+namespace mongo {
+namespace {
+
+const auto getBucketCompressionService =
+    ServiceContext::declareDecoration<BucketCompressionService>();
+
+}  // namespace
+
+BucketCompressionService::~BucketCompressionService() {
+    shutDown();
+}
+
+BucketCompressionService& BucketCompressionService::get(ServiceContext* service) {
+    return getBucketCompressionService(service);
+}
+
+void BucketCompressionService::startup(ServiceContext* service) {
+    stdx::lock_guard lk(_mutex);
+    invariant(_state == State::kNotStarted);
+
+    ThreadPool::Options options;
+    options.poolName = "TimeseriesBucketCompression";
+    options.minThreads = 0;
+    options.maxThreads = gTimeseriesBackgroundBucketCompressionThreads;
+    options.onCreateThread = [](const std::string& name) {
+        Client::initThread(name);
+    };
+
+    _service = service;
+    _pool = std::make_unique<ThreadPool>(options);
+    _pool->startup();
+    _state = State::kRunning;
+}
+
+void BucketCompressionService::shutDown() {
+    {
+        stdx::lock_guard lk(_mutex);
+        if (_state != State::kRunning) {
+            _state = State::kShutdown;
+            return;
+        }
+        _state = State::kShutdown;
+    }
+
+    _pool->shutdown();
+    _pool->join();
+}
+
+bool BucketCompressionService::schedule(Job job) {
+    stdx::lock_guard lk(_mutex);
+    if (_state != State::kRunning ||
+        _queueDepth.load() >= gTimeseriesBackgroundBucketCompressionMaxQueueDepth.load()) {
+        return false;
+    }
+
+    _queueDepth.addAndFetch(1);
+    _pool->schedule([this, job = std::move(job), queuedAt = _service->getFastClockSource()->now()](
+                        Status status) mutable {
+        if (!status.isOK()) {
+            _queueDepth.subtractAndFetch(1);
+            return;
+        }
+        _runJob(std::move(job), queuedAt);
+    });
+    return true;
+}
+
+void BucketCompressionService::_waitForThrottle(OperationContext* opCtx) {
+    while (true) {
+        auto maxPerSecond = gTimeseriesBackgroundBucketCompressionMaxPerSecond.load();
+        if (maxPerSecond <= 0) {
+            return;
+        }
+
+        Date_t wakeUpAt;
+        {
+            stdx::lock_guard lk(_mutex);
+            auto now = _service->getFastClockSource()->now();
+            if (now >= _throttleWindowEnd) {
+                _throttleWindowEnd = now + Seconds(1);
+                _jobsStartedInThrottleWindow = 0;
+            }
+            if (_jobsStartedInThrottleWindow < maxPerSecond) {
+                ++_jobsStartedInThrottleWindow;
+                return;
+            }
+            wakeUpAt = _throttleWindowEnd;
+        }
+        opCtx->sleepUntil(wakeUpAt);
+    }
+}
+
+void BucketCompressionService::_runJob(Job job, Date_t queuedAt) {
+    ON_BLOCK_EXIT([&] { _queueDepth.subtractAndFetch(1); });
+    {
+        stdx::lock_guard lk(_mutex);
+        if (_state != State::kRunning) {
+            return;
+        }
+    }
+
+    auto opCtx = cc().makeOperationContext();
+    // The rewrite is a replicated write, so it must not survive a change of replication state.
+    opCtx->setAlwaysInterruptAtStepDownOrUp_UNSAFE();
+
+    try {
+        _waitForThrottle(opCtx.get());
+        job(opCtx.get(), _service->getFastClockSource()->now() - queuedAt);
+    } catch (const DBException& ex) {
+        // The bucket stays uncompressed, which readers and writers handle transparently.
+        _numFailedJobs.addAndFetch(1);
+        LOGV2_WARNING(7095715,
+                      "Background time-series bucket compression failed",
+                      "error"_attr = redact(ex.toStatus()));
+    }
+}
+
+class BucketCompressionServiceServerStatus : public ServerStatusSection {
+public:
+    BucketCompressionServiceServerStatus()
+        : ServerStatusSection("timeseriesBackgroundBucketCompression") {}
+
+    bool includeByDefault() const override {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx, const BSONElement&) const override {
+        const auto& service = BucketCompressionService::get(opCtx->getServiceContext());
+        BSONObjBuilder builder;
+        builder.appendNumber("queueDepth", service.queueDepth());
+        builder.appendNumber("numFailedCompressions", service.numFailedJobs());
+        return builder.obj();
+    }
+} bucketCompressionServiceServerStatus;
+
+}  // namespace mongo
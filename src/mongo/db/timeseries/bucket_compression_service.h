@@ -0,0 +1,127 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/duration.h"
+#include "mongo/util/functional.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/**
+ * Compresses closed time-series buckets in the background, so that the insert which closed a
+ * bucket does not have to pay for rewriting it.
+ *
+ * Callers hand over a job which rewrites one bucket. Jobs run on a small thread pool, each with
+ * its own OperationContext, and are throttled by
+ * 'timeseriesBackgroundBucketCompressionMaxPerSecond' so that the rewrites do not compete with the
+ * user's writes. A bucket which cannot be queued, because the service is not running or too many
+ * buckets are already waiting, must be compressed by the caller.
+ */
+class BucketCompressionService {
+public:
+    /**
+     * Rewrites a single bucket. 'queuedFor' is how long the job waited before starting to run.
+     */
+    using Job = unique_function<void(OperationContext* opCtx, Milliseconds queuedFor)>;
+
+    ~BucketCompressionService();
+
+    static BucketCompressionService& get(ServiceContext* service);
+
+    /**
+     * Starts the thread pool which runs the compression jobs.
+     */
+    void startup(ServiceContext* service);
+
+    /**
+     * Stops accepting jobs and joins the thread pool. Jobs which have not started yet are
+     * discarded, leaving their buckets uncompressed.
+     */
+    void shutDown();
+
+    /**
+     * Queues 'job' to run in the background and returns true, or returns false if the service is
+     * not running or its queue is full.
+     */
+    bool schedule(Job job);
+
+    /**
+     * Returns the number of jobs which have been queued but have not finished yet.
+     */
+    long long queueDepth() const {
+        return _queueDepth.load();
+    }
+
+    /**
+     * Returns the number of jobs which have failed, leaving their buckets uncompressed.
+     */
+    long long numFailedJobs() const {
+        return _numFailedJobs.load();
+    }
+
+private:
+    enum class State { kNotStarted, kRunning, kShutdown };
+
+    /**
+     * Blocks until the throttle allows the next job to start.
+     */
+    void _waitForThrottle(OperationContext* opCtx);
+
+    void _runJob(Job job, Date_t queuedAt);
+
+    ServiceContext* _service = nullptr;
+
+    std::unique_ptr<ThreadPool> _pool;
+
+    // Jobs which have been accepted by schedule() and have not finished running.
+    AtomicWord<long long> _queueDepth{0};
+
+    AtomicWord<long long> _numFailedJobs{0};
+
+    // Protects the members declared below.
+    Mutex _mutex = MONGO_MAKE_LATCH("BucketCompressionService::_mutex");
+
+    State _state = State::kNotStarted;
+
+    // Jobs are throttled in windows of one second. These track the end of the current window and
+    // how many jobs have started in it.
+    Date_t _throttleWindowEnd;
+    int _jobsStartedInThrottleWindow = 0;
+};
+
+}  // namespace mongo
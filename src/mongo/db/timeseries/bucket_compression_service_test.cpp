@@ -0,0 +1,126 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/db/timeseries/bucket_compression_service.h"
+
+#include "mongo/db/service_context_test_fixture.h"
+#include "mongo/idl/server_parameter_test_util.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/notification.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+class BucketCompressionServiceTest : public ServiceContextTest {
+public:
+    void setUp() override {
+        ServiceContextTest::setUp();
+        service().startup(getServiceContext());
+    }
+
+    void tearDown() override {
+        service().shutDown();
+        ServiceContextTest::tearDown();
+    }
+
+    BucketCompressionService& service() {
+        return BucketCompressionService::get(getServiceContext());
+    }
+};
+
+class BucketCompressionServiceNoStartupTest : public ServiceContextTest {};
+
+TEST_F(BucketCompressionServiceNoStartupTest, ScheduleBeforeStartupIsRejected) {
+    auto& service = BucketCompressionService::get(getServiceContext());
+    ASSERT_FALSE(service.schedule([](OperationContext*, Milliseconds) {}));
+    ASSERT_EQ(0, service.queueDepth());
+    service.shutDown();
+}
+
+TEST_F(BucketCompressionServiceTest, RunsScheduledJobs) {
+    AtomicWord<int> jobsRun{0};
+    Notification<void> allJobsRun;
+    const int numJobs = 10;
+    for (int i = 0; i < numJobs; ++i) {
+        ASSERT_TRUE(service().schedule([&](OperationContext* opCtx, Milliseconds queuedFor) {
+            ASSERT(opCtx);
+            ASSERT_GTE(queuedFor, Milliseconds(0));
+            if (jobsRun.addAndFetch(1) == numJobs) {
+                allJobsRun.set();
+            }
+        }));
+    }
+    allJobsRun.get();
+    ASSERT_EQ(numJobs, jobsRun.load());
+}
+
+TEST_F(BucketCompressionServiceTest, ScheduleIsRejectedWhenQueueIsFull) {
+    RAIIServerParameterControllerForTest maxQueueDepth{
+        "timeseriesBackgroundBucketCompressionMaxQueueDepth", 1};
+
+    Notification<void> jobStarted;
+    Notification<void> unblockJob;
+    ASSERT_TRUE(service().schedule([&](OperationContext*, Milliseconds) {
+        jobStarted.set();
+        unblockJob.get();
+    }));
+    jobStarted.get();
+
+    ASSERT_EQ(1, service().queueDepth());
+    ASSERT_FALSE(service().schedule([](OperationContext*, Milliseconds) {}));
+
+    unblockJob.set();
+}
+
+TEST_F(BucketCompressionServiceTest, ExceptionsFromJobsAreSwallowed) {
+    Notification<void> secondJobRun;
+    ASSERT_TRUE(service().schedule([](OperationContext*, Milliseconds) {
+        uasserted(ErrorCodes::WriteConflict, "Simulated compression failure");
+    }));
+    ASSERT_TRUE(service().schedule([&](OperationContext*, Milliseconds) { secondJobRun.set(); }));
+    secondJobRun.get();
+
+    // The jobs may run on different threads, so the failure is only known to have been counted
+    // once both jobs have left the queue.
+    while (service().queueDepth() > 0) {
+        sleepmillis(1);
+    }
+    ASSERT_EQ(1, service().numFailedJobs());
+}
+
+TEST_F(BucketCompressionServiceTest, ScheduleAfterShutdownIsRejected) {
+    service().shutDown();
+    ASSERT_FALSE(service().schedule([](OperationContext*, Milliseconds) {}));
+    ASSERT_EQ(0, service().queueDepth());
+}
+
+}  // namespace
+}  // namespace mongo
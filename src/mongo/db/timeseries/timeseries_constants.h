@@ -46,8 +46,10 @@ static constexpr StringData kBucketControlVersionFieldName = "version"_sd;
 static constexpr StringData kBucketControlCountFieldName = "count"_sd;
 static constexpr StringData kBucketControlMinFieldName = "min"_sd;
 static constexpr StringData kBucketControlMaxFieldName = "max"_sd;
+static constexpr StringData kBucketControlBloomFieldName = "bloom"_sd;
 static constexpr StringData kControlMaxFieldNamePrefix = "control.max."_sd;
 static constexpr StringData kControlMinFieldNamePrefix = "control.min."_sd;
+static constexpr StringData kControlBloomFieldNamePrefix = "control.bloom."_sd;
 static constexpr StringData kDataFieldNamePrefix = "data."_sd;
 
 // These are hard-coded field names in create collection for time-series collections.
@@ -59,6 +61,9 @@ static constexpr StringData kKeyFieldName = "key"_sd;
 static constexpr StringData kOriginalSpecFieldName = "originalSpec"_sd;
 static constexpr StringData kPartialFilterExpressionFieldName = "partialFilterExpression"_sd;
 
+// The maximum number of measurement fields a time-series collection may keep Bloom filters for.
+static constexpr std::size_t kMaxBucketBloomFilterFields = 8;
+
 static constexpr int kTimeseriesControlDefaultVersion = 1;
 static constexpr int kTimeseriesControlCompressedVersion = 2;
 
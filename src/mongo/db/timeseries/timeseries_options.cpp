@@ -219,17 +219,17 @@ StatusWith<std::pair<TimeseriesOptions, bool>> applyTimeseriesOptionsModificatio
 }
 
 BSONObj generateViewPipeline(const TimeseriesOptions& options, bool asArray) {
+    BSONObjBuilder unpackBuilder;
+    unpackBuilder.append("timeField", options.getTimeField());
     if (options.getMetaField()) {
-        return wrapInArrayIf(
-            asArray,
-            BSON("$_internalUnpackBucket" << BSON(
-                     "timeField" << options.getTimeField() << "metaField" << *options.getMetaField()
-                                 << "bucketMaxSpanSeconds" << *options.getBucketMaxSpanSeconds())));
+        unpackBuilder.append("metaField", *options.getMetaField());
     }
-    return wrapInArrayIf(asArray,
-                         BSON("$_internalUnpackBucket" << BSON(
-                                  "timeField" << options.getTimeField() << "bucketMaxSpanSeconds"
-                                              << *options.getBucketMaxSpanSeconds())));
+    unpackBuilder.append("bucketMaxSpanSeconds", *options.getBucketMaxSpanSeconds());
+    const auto& bloomFields = options.getBucketBloomFilterFields();
+    if (bloomFields && !bloomFields->empty()) {
+        unpackBuilder.append("bloomFilterFields", *bloomFields);
+    }
+    return wrapInArrayIf(asArray, BSON("$_internalUnpackBucket" << unpackBuilder.obj()));
 }
 
 bool optionsAreEqual(const TimeseriesOptions& option1, const TimeseriesOptions& option2) {
@@ -278,6 +278,10 @@ bool optionsAreEqual(const TimeseriesOptions& option1, const TimeseriesOptions&
         return false;
     }
 
+    if (option1.getBucketBloomFilterFields() != option2.getBucketBloomFilterFields()) {
+        return false;
+    }
+
     return true;
 }
 
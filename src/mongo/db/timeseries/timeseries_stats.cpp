@@ -60,6 +60,20 @@ void TimeseriesStats::onBucketClosed(int uncompressedSize,
     }
 }
 
+void TimeseriesStats::onBucketQueuedForCompression() const {
+    _numBucketsQueuedForCompression.fetchAndAddRelaxed(1);
+}
+
+void TimeseriesStats::onBucketDequeuedForCompression(
+    boost::optional<Milliseconds> queuedFor) const {
+    _numBucketsQueuedForCompression.fetchAndAddRelaxed(-1);
+    if (queuedFor) {
+        _numBackgroundCompressions.fetchAndAddRelaxed(1);
+        _totalBackgroundCompressionLagMillis.fetchAndAddRelaxed(
+            durationCount<Milliseconds>(*queuedFor));
+    }
+}
+
 void TimeseriesStats::append(BSONObjBuilder* builder) const {
     builder->appendNumber("numBytesUncompressed", _uncompressedSize.load());
     builder->appendNumber("numBytesCompressed", _compressedSize.load());
@@ -67,6 +81,11 @@ void TimeseriesStats::append(BSONObjBuilder* builder) const {
     builder->appendNumber("numCompressedBuckets", _numCompressedBuckets.load());
     builder->appendNumber("numUncompressedBuckets", _numUncompressedBuckets.load());
     builder->appendNumber("numFailedDecompressBuckets", _numFailedDecompressBuckets.load());
+    builder->appendNumber("numBucketsQueuedForCompression",
+                          _numBucketsQueuedForCompression.load());
+    builder->appendNumber("numBackgroundCompressions", _numBackgroundCompressions.load());
+    builder->appendNumber("totalBackgroundCompressionLagMillis",
+                          _totalBackgroundCompressionLagMillis.load());
 }
 
 }  // namespace mongo
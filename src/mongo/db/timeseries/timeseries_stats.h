@@ -57,6 +57,18 @@ public:
      */
     void onBucketClosed(int uncompressedSize, const CompressedBucketInfo& compressed) const;
 
+    /**
+     * Records that a closed bucket was queued to be compressed in the background.
+     */
+    void onBucketQueuedForCompression() const;
+
+    /**
+     * Records that a bucket queued for background compression left the queue, either because its
+     * compression started after waiting for 'queuedFor', or, if 'boost::none', because it could
+     * not be queued after all.
+     */
+    void onBucketDequeuedForCompression(boost::optional<Milliseconds> queuedFor) const;
+
     /**
      * Appends current stats to the given BSONObjBuilder.
      */
@@ -71,5 +83,8 @@ private:
     mutable AtomicWord<long long> _numCompressedBuckets;
     mutable AtomicWord<long long> _numUncompressedBuckets;
     mutable AtomicWord<long long> _numFailedDecompressBuckets;
+    mutable AtomicWord<long long> _numBucketsQueuedForCompression;
+    mutable AtomicWord<long long> _numBackgroundCompressions;
+    mutable AtomicWord<long long> _totalBackgroundCompressionLagMillis;
 };
 }  // namespace mongo
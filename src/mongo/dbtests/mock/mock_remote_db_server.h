@@ -163,7 +163,10 @@ public:
     rpc::UniqueReply runCommand(InstanceID id, const OpMsgRequest& request);
 
     /**
-     * Finds documents from this mock server according to 'findRequest'.
+     * Finds documents from this mock server according to 'findRequest'. Only the projection and
+     * the 'min' and 'max' bounds of the request are applied. The bounds are compared against the
+     * document field named by their first element, and the documents are returned in insertion
+     * order rather than in index order.
      */
     mongo::BSONArray find(InstanceID id, const FindCommandRequest& findRequest);
 
@@ -234,7 +237,9 @@ private:
      */
     mongo::BSONArray findImpl(InstanceID id,
                               const NamespaceStringOrUUID& nsOrUuid,
-                              BSONObj projection);
+                              BSONObj projection,
+                              const BSONObj& min = BSONObj(),
+                              const BSONObj& max = BSONObj());
 
     typedef stdx::unordered_map<std::string, std::shared_ptr<CircularBSONIterator>> CmdToReplyObj;
     typedef stdx::unordered_map<std::string, std::vector<BSONObj>> MockDataMgr;
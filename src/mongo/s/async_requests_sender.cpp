@@ -84,10 +84,10 @@ AsyncRequestsSender::AsyncRequestsSender(OperationContext* opCtx,
     // Initialize command metadata to handle the read preference.
     _metadataObj = readPreference.toContainingBSON();
 
-    _remotes.reserve(requests.size());
     for (const auto& request : requests) {
         // Kick off requests immediately.
-        _remotes.emplace_back(this, request.shardId, request.cmdObj).executeRequest();
+        _remotes.emplace_back(this, _remotes.size(), request.shardId, request.cmdObj)
+            .executeRequest();
     }
 }
 
@@ -156,6 +156,20 @@ AsyncRequestsSender::Response AsyncRequestsSender::next() noexcept {
     return _responseQueue.pop();
 }
 
+void AsyncRequestsSender::addRequest(const Request& request) {
+    ++_remotesLeft;
+    auto& remote = _remotes.emplace_back(this, _remotes.size(), request.shardId, request.cmdObj);
+
+    // Once interrupted, the ARS no longer services callbacks, so fail the request right away like
+    // the ones which were outstanding when the interruption happened.
+    if (!_interruptStatus.isOK()) {
+        _responseQueue.push(std::move(remote).makeFailedResponse(_interruptStatus));
+        return;
+    }
+
+    remote.executeRequest();
+}
+
 void AsyncRequestsSender::stopRetrying() noexcept {
     _stopRetrying = true;
 }
@@ -168,9 +182,13 @@ AsyncRequestsSender::Request::Request(ShardId shardId, BSONObj cmdObj)
     : shardId(shardId), cmdObj(cmdObj) {}
 
 AsyncRequestsSender::RemoteData::RemoteData(AsyncRequestsSender* ars,
+                                            size_t requestIndex,
                                             ShardId shardId,
                                             BSONObj cmdObj)
-    : _ars(ars), _shardId(std::move(shardId)), _cmdObj(std::move(cmdObj)) {}
+    : _ars(ars),
+      _requestIndex(requestIndex),
+      _shardId(std::move(shardId)),
+      _cmdObj(std::move(cmdObj)) {}
 
 SemiFuture<std::shared_ptr<Shard>> AsyncRequestsSender::RemoteData::getShard() noexcept {
     return Grid::get(getGlobalServiceContext())
@@ -184,11 +202,15 @@ void AsyncRequestsSender::RemoteData::executeRequest() {
         .getAsync([this](StatusWith<RemoteCommandOnAnyCallbackArgs> rcr) {
             _done = true;
             if (rcr.isOK()) {
-                _ars->_responseQueue.push(
-                    {std::move(_shardId), rcr.getValue().response, std::move(_shardHostAndPort)});
+                _ars->_responseQueue.push({std::move(_shardId),
+                                           rcr.getValue().response,
+                                           std::move(_shardHostAndPort),
+                                           _requestIndex});
             } else {
-                _ars->_responseQueue.push(
-                    {std::move(_shardId), rcr.getStatus(), std::move(_shardHostAndPort)});
+                _ars->_responseQueue.push({std::move(_shardId),
+                                           rcr.getStatus(),
+                                           std::move(_shardHostAndPort),
+                                           _requestIndex});
             }
         });
 }
@@ -30,6 +30,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <deque>
 #include <vector>
 
 #include "mongo/base/status_with.h"
@@ -125,6 +126,11 @@ public:
         // The exact host on which the remote command was run. Is unset if the shard could not be
         // found or no shard hosts matching the readPreference could be found.
         boost::optional<HostAndPort> shardHostAndPort;
+
+        // The position of the request among all the requests sent by the ARS, counting those
+        // passed to the constructor first and then those passed to addRequest(). Tells apart the
+        // responses of several requests sent to the same shard.
+        size_t requestIndex = 0;
     };
 
     /**
@@ -156,6 +162,14 @@ public:
      */
     Response next() noexcept;
 
+    /**
+     * Schedules one more request on this ARS, whose response is returned by a later call to next().
+     *
+     * Lets a caller which processes responses as they arrive send follow-up requests without
+     * waiting for the responses to all the requests it sent before.
+     */
+    void addRequest(const Request& request);
+
     /**
      * Stops the ARS from retrying requests.
      *
@@ -176,7 +190,7 @@ private:
         /**
          * Creates a new uninitialized remote state with a command to send.
          */
-        RemoteData(AsyncRequestsSender* ars, ShardId shardId, BSONObj cmdObj);
+        RemoteData(AsyncRequestsSender* ars, size_t requestIndex, ShardId shardId, BSONObj cmdObj);
 
         /**
          * Returns a SemiFuture containing a shard object associated with this remote.
@@ -200,7 +214,10 @@ private:
          * Extracts a failed response from the remote, given an interruption status.
          */
         Response makeFailedResponse(Status status) && {
-            return {std::move(_shardId), std::move(status), std::move(_shardHostAndPort)};
+            return {std::move(_shardId),
+                    std::move(status),
+                    std::move(_shardHostAndPort),
+                    _requestIndex};
         }
 
         /**
@@ -246,6 +263,9 @@ private:
 
         AsyncRequestsSender* const _ars;
 
+        // The position of this remote's request among all the requests sent by the ARS.
+        const size_t _requestIndex;
+
         // ShardId of the shard to which the command will be sent.
         ShardId _shardId;
 
@@ -275,8 +295,9 @@ private:
     // The policy to use when deciding whether to retry on an error.
     Shard::RetryPolicy _retryPolicy;
 
-    // Data tracking the state of our communication with each of the remote nodes.
-    std::vector<RemoteData> _remotes;
+    // Data tracking the state of our communication with each of the remote nodes. A deque, since
+    // the callbacks of in-flight requests point into it while addRequest() appends to it.
+    std::deque<RemoteData> _remotes;
 
     // Number of remotes we haven't returned final results from.
     size_t _remotesLeft;
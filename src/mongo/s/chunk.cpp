@@ -33,6 +33,7 @@
 #include "mongo/s/chunk.h"
 
 #include "mongo/platform/random.h"
+#include "mongo/s/chunk_manager.h"
 #include "mongo/s/chunk_writes_tracker.h"
 #include "mongo/util/str.h"
 
@@ -57,15 +58,16 @@ ChunkInfo::ChunkInfo(ChunkRange range,
                      ShardId shardId,
                      ChunkVersion version,
                      std::vector<ChunkHistory> history,
-                     bool jumbo,
-                     std::shared_ptr<ChunkWritesTracker> writesTracker)
+                     std::shared_ptr<const ChunkBlock> block,
+                     size_t indexInBlock)
     : _range(std::move(range)),
       _maxKeyString(std::move(maxKeyString)),
-      _shardId(shardId),
+      _shardId(std::move(shardId)),
       _lastmod(std::move(version)),
       _history(std::move(history)),
-      _jumbo(jumbo),
-      _writesTracker(writesTracker) {}
+      _jumbo(false),
+      _block(std::move(block)),
+      _indexInBlock(indexInBlock) {}
 
 const ShardId& ChunkInfo::getShardIdAt(const boost::optional<Timestamp>& ts) const {
     // This chunk was refreshed from FCV 3.6 config server so it doesn't have history
@@ -117,7 +119,22 @@ std::string ChunkInfo::toString() const {
                          << ": " << _lastmod.toString() << ", " << _range.toString();
 }
 
+bool ChunkInfo::isJumbo() const {
+    return _block ? _block->isJumbo(_indexInBlock) : _jumbo;
+}
+
+std::shared_ptr<ChunkWritesTracker> ChunkInfo::getWritesTracker() const {
+    return _block ? _block->getWritesTracker(_indexInBlock) : _writesTracker;
+}
+
+std::shared_ptr<ChunkWritesTracker> ChunkInfo::peekWritesTracker() const {
+    return _block ? _block->peekWritesTracker(_indexInBlock) : _writesTracker;
+}
+
 void ChunkInfo::markAsJumbo() {
+    if (_block) {
+        _block->markAsJumbo(_indexInBlock);
+    }
     _jumbo = true;
 }
 
@@ -126,7 +143,7 @@ void Chunk::throwIfMoved() const {
         return;
     }
 
-    _chunkInfo.throwIfMovedSince(*_atClusterTime);
+    _chunkInfo->throwIfMovedSince(*_atClusterTime);
 }
 
 }  // namespace mongo
@@ -34,22 +34,28 @@
 namespace mongo {
 
 class BSONObj;
+class ChunkBlock;
 class ChunkWritesTracker;
 
 /**
- * Represents a cache entry for a single Chunk. Owned by a RoutingTableHistory.
+ * Represents a cache entry for a single Chunk. A RoutingTableHistory stores its chunks in compact
+ * form and builds these objects from it on demand.
  */
 class ChunkInfo {
 public:
     explicit ChunkInfo(const ChunkType& from);
 
+    /**
+     * Makes the entry for the chunk at 'indexInBlock' of 'block'. Its jumbo flag and its writes
+     * tracker are kept in the block, so that they outlive this object.
+     */
     ChunkInfo(ChunkRange range,
               std::string maxKeyString,
               ShardId shardId,
               ChunkVersion version,
               std::vector<ChunkHistory> history,
-              bool jumbo,
-              std::shared_ptr<ChunkWritesTracker> writesTracker);
+              std::shared_ptr<const ChunkBlock> block,
+              size_t indexInBlock);
 
     const auto& getRange() const {
         return _range;
@@ -89,16 +95,17 @@ public:
         return _history;
     }
 
-    bool isJumbo() const {
-        return _jumbo;
-    }
+    bool isJumbo() const;
 
     /**
      * Get writes tracker for this chunk.
      */
-    std::shared_ptr<ChunkWritesTracker> getWritesTracker() const {
-        return _writesTracker;
-    }
+    std::shared_ptr<ChunkWritesTracker> getWritesTracker() const;
+
+    /**
+     * Get writes tracker for this chunk, or nullptr if nothing has asked for it yet.
+     */
+    std::shared_ptr<ChunkWritesTracker> peekWritesTracker() const;
 
     /**
      * Returns a string represenation of the chunk for logging.
@@ -134,27 +141,32 @@ private:
     // ChunkInfo objects are always treated as const, and this contains metadata about the chunk
     // that needs to change, it's okay (and necessary) to mark it mutable.
     mutable std::shared_ptr<ChunkWritesTracker> _writesTracker;
+
+    // Set if this entry was built from a block of a RoutingTableHistory, which then holds the
+    // jumbo flag and the writes tracker of the chunk instead of the two fields above
+    const std::shared_ptr<const ChunkBlock> _block;
+    const size_t _indexInBlock = 0;
 };
 
 class Chunk {
 public:
-    Chunk(ChunkInfo& chunkInfo, const boost::optional<Timestamp>& atClusterTime)
-        : _chunkInfo(chunkInfo), _atClusterTime(atClusterTime) {}
+    Chunk(std::shared_ptr<ChunkInfo> chunkInfo, const boost::optional<Timestamp>& atClusterTime)
+        : _chunkInfo(std::move(chunkInfo)), _atClusterTime(atClusterTime) {}
 
     const BSONObj& getMin() const {
-        return _chunkInfo.getMin();
+        return _chunkInfo->getMin();
     }
 
     const BSONObj& getMax() const {
-        return _chunkInfo.getMax();
+        return _chunkInfo->getMax();
     }
 
     const ShardId& getShardId() const {
-        return _chunkInfo.getShardIdAt(_atClusterTime);
+        return _chunkInfo->getShardIdAt(_atClusterTime);
     }
 
     const auto& getRange() const {
-        return _chunkInfo.getRange();
+        return _chunkInfo->getRange();
     }
 
     /**
@@ -166,29 +178,36 @@ public:
     void throwIfMoved() const;
 
     ChunkVersion getLastmod() const {
-        return _chunkInfo.getLastmod();
+        return _chunkInfo->getLastmod();
     }
 
     const auto& getHistory() const {
-        return _chunkInfo.getHistory();
+        return _chunkInfo->getHistory();
     }
 
     bool isJumbo() const {
-        return _chunkInfo.isJumbo();
+        return _chunkInfo->isJumbo();
     }
 
     /**
      * Get writes tracker for this chunk.
      */
     std::shared_ptr<ChunkWritesTracker> getWritesTracker() const {
-        return _chunkInfo.getWritesTracker();
+        return _chunkInfo->getWritesTracker();
+    }
+
+    /**
+     * Get writes tracker for this chunk, or nullptr if nothing has asked for it yet.
+     */
+    std::shared_ptr<ChunkWritesTracker> peekWritesTracker() const {
+        return _chunkInfo->peekWritesTracker();
     }
 
     /**
      * Returns a string represenation of the chunk for logging.
      */
     std::string toString() const {
-        return _chunkInfo.toString();
+        return _chunkInfo->toString();
     }
 
     // Returns true if this chunk contains the given shard key, and false otherwise
@@ -196,18 +215,18 @@ public:
     // Note: this function takes an extracted *key*, not an original document (the point may be
     // computed by, say, hashing a given field or projecting to a subset of fields).
     bool containsKey(const BSONObj& shardKey) const {
-        return _chunkInfo.containsKey(shardKey);
+        return _chunkInfo->containsKey(shardKey);
     }
 
     /**
      * Marks this chunk as jumbo. Only moves from false to true once and is used by the balancer.
      */
     void markAsJumbo() {
-        _chunkInfo.markAsJumbo();
+        _chunkInfo->markAsJumbo();
     }
 
 private:
-    ChunkInfo& _chunkInfo;
+    std::shared_ptr<ChunkInfo> _chunkInfo;
     const boost::optional<Timestamp> _atClusterTime;
 };
 
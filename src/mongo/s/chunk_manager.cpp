@@ -43,6 +43,7 @@
 #include "mongo/s/chunk_writes_tracker.h"
 #include "mongo/s/mongod_and_mongos_server_parameters_gen.h"
 #include "mongo/s/shard_invalidated_for_targeting_exception.h"
+#include "mongo/util/bufreader.h"
 
 #define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kSharding
 
@@ -128,94 +129,308 @@ void validateChunkIsNotOlderThan(const std::shared_ptr<ChunkInfo>& chunk,
             version.isOlderOrEqualThan(chunk->getLastmod()));
 }
 
+uint64_t packPlacement(const ChunkVersion& version) {
+    return static_cast<uint64_t>(version.majorVersion()) << 32 | version.minorVersion();
+}
+
+// A chunk bound encoded the way ChunkBlock stores it, with the same KeyString as
+// ShardKeyPattern::toKeyString()
+struct EncodedBound {
+    std::string keyString;
+    std::string typeBits;
+};
+
+EncodedBound encodeBound(const BSONObj& bound) {
+    KeyString::Builder ks(KeyString::Version::V1, Ordering::allAscending());
+    for (auto&& elem : bound) {
+        ks.appendBSONElement(elem);
+    }
+
+    const auto& typeBits = ks.getTypeBits();
+    return {std::string(ks.getBuffer(), ks.getSize()),
+            typeBits.isAllZeros() ? std::string()
+                                  : std::string(typeBits.getBuffer(), typeBits.getSize())};
+}
+
 }  // namespace
 
-ChunkMap::ChunkMap(OID epoch, const Timestamp& timestamp, size_t initialCapacity)
-    : _collectionVersion({epoch, timestamp}, {0, 0}) {
-    _chunkMap.reserve(initialCapacity);
+ChunkBlock::ChunkBlock(const ChunkBlock& other)
+    : _maxKeys(other._maxKeys),
+      _maxKeyEnds(other._maxKeyEnds),
+      _maxKeyTypeBits(other._maxKeyTypeBits),
+      _maxKeyTypeBitsEnds(other._maxKeyTypeBitsEnds),
+      _minBounds(other._minBounds),
+      _shardIdxs(other._shardIdxs),
+      _placements(other._placements),
+      _historyValidAfter(other._historyValidAfter),
+      _historyShardIdxs(other._historyShardIdxs),
+      _historyEnds(other._historyEnds) {
+    stdx::lock_guard<Latch> lk(other._mutex);
+    _jumbo = other._jumbo;
+    _writesTrackers = other._writesTrackers;
 }
 
-ShardVersionMap ChunkMap::constructShardVersionMap() const {
-    ShardVersionMap shardVersions;
-    ChunkVector::const_iterator current = _chunkMap.cbegin();
-
-    boost::optional<BSONObj> firstMin = boost::none;
-    boost::optional<BSONObj> lastMax = boost::none;
-
-    while (current != _chunkMap.cend()) {
-        const auto& firstChunkInRange = *current;
-        const auto& currentRangeShardId = firstChunkInRange->getShardIdAt(boost::none);
-
-        // Tracks the max shard version for the shard on which the current range will reside
-        auto shardVersionIt = shardVersions.find(currentRangeShardId);
-        if (shardVersionIt == shardVersions.end()) {
-            shardVersionIt = shardVersions
-                                 .emplace(std::piecewise_construct,
-                                          std::forward_as_tuple(currentRangeShardId),
-                                          std::forward_as_tuple(_collectionVersion.epoch(),
-                                                                _collectionVersion.getTimestamp()))
-                                 .first;
+bool ChunkBlock::isJumbo(size_t idx) const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    return _jumbo[idx];
+}
+
+void ChunkBlock::markAsJumbo(size_t idx) const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    _jumbo[idx] = true;
+}
+
+std::shared_ptr<ChunkWritesTracker> ChunkBlock::getWritesTracker(size_t idx) const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    auto& writesTracker = _writesTrackers[idx];
+    if (!writesTracker) {
+        writesTracker = std::make_shared<ChunkWritesTracker>();
+    }
+    return writesTracker;
+}
+
+std::shared_ptr<ChunkWritesTracker> ChunkBlock::peekWritesTracker(size_t idx) const {
+    stdx::lock_guard<Latch> lk(_mutex);
+    const auto it = _writesTrackers.find(idx);
+    return it == _writesTrackers.end() ? nullptr : it->second;
+}
+
+uint64_t ChunkBlock::getBytesWritten(size_t idx) const {
+    const auto writesTracker = peekWritesTracker(idx);
+    return writesTracker ? writesTracker->getBytesWritten() : 0;
+}
+
+StringData ChunkBlock::_maxKeyString(size_t idx) const {
+    const size_t begin = idx == 0 ? 0 : _maxKeyEnds[idx - 1];
+    return StringData(_maxKeys.data() + begin, _maxKeyEnds[idx] - begin);
+}
+
+ChunkBlock::Bound ChunkBlock::_maxBound(size_t idx) const {
+    const size_t typeBitsBegin = idx == 0 ? 0 : _maxKeyTypeBitsEnds[idx - 1];
+    return {_maxKeyString(idx),
+            StringData(_maxKeyTypeBits.data() + typeBitsBegin,
+                       _maxKeyTypeBitsEnds[idx] - typeBitsBegin)};
+}
+
+ChunkBlock::Bound ChunkBlock::_minBound(size_t idx) const {
+    const auto it = std::lower_bound(
+        _minBounds.begin(), _minBounds.end(), idx, [](const MinBound& minBound, size_t chunkIdx) {
+            return minBound.idx < chunkIdx;
+        });
+    if (it != _minBounds.end() && it->idx == idx) {
+        return {it->keyString, it->typeBits};
+    }
+
+    invariant(idx > 0);
+    return _maxBound(idx - 1);
+}
+
+uint16_t ChunkBlock::_shardIdxAt(size_t idx,
+                                 const boost::optional<Timestamp>& atClusterTime) const {
+    const size_t historyBegin = idx == 0 ? 0 : _historyEnds[idx - 1];
+    const size_t historyEnd = _historyEnds[idx];
+
+    // Same as ChunkInfo::getShardIdAt(), which returns the current shard for a chunk without
+    // history or if no timestamp is provided
+    if (historyBegin == historyEnd || !atClusterTime) {
+        return _shardIdxs[idx];
+    }
+
+    for (size_t i = historyBegin; i < historyEnd; ++i) {
+        if (_historyValidAfter[i] <= *atClusterTime) {
+            return _historyShardIdxs[i];
         }
+    }
+
+    uasserted(ErrorCodes::StaleChunkHistory,
+              str::stream() << "Cannot find shardId the chunk belonged to at cluster time "
+                            << atClusterTime->toString());
+}
+
+void ChunkBlock::_appendBounds(const Bound& min, const Bound& max) {
+    const size_t idx = size();
+    if (idx == 0 || _maxBound(idx - 1).keyString != min.keyString ||
+        _maxBound(idx - 1).typeBits != min.typeBits) {
+        _minBounds.push_back(
+            {static_cast<uint32_t>(idx), min.keyString.toString(), min.typeBits.toString()});
+    }
+
+    _maxKeys.append(max.keyString.rawData(), max.keyString.size());
+    _maxKeyEnds.push_back(_maxKeys.size());
+    _maxKeyTypeBits.append(max.typeBits.rawData(), max.typeBits.size());
+    _maxKeyTypeBitsEnds.push_back(_maxKeyTypeBits.size());
+}
+
+void ChunkBlock::_appendFrom(const ChunkBlock& other, size_t idx) {
+    _appendBounds(other._minBound(idx), other._maxBound(idx));
+    _shardIdxs.push_back(other._shardIdxs[idx]);
+    _placements.push_back(other._placements[idx]);
+
+    const size_t historyBegin = idx == 0 ? 0 : other._historyEnds[idx - 1];
+    const size_t historyEnd = other._historyEnds[idx];
+    _historyValidAfter.insert(_historyValidAfter.end(),
+                              other._historyValidAfter.begin() + historyBegin,
+                              other._historyValidAfter.begin() + historyEnd);
+    _historyShardIdxs.insert(_historyShardIdxs.end(),
+                             other._historyShardIdxs.begin() + historyBegin,
+                             other._historyShardIdxs.begin() + historyEnd);
+    _historyEnds.push_back(_historyValidAfter.size());
+
+    stdx::lock_guard<Latch> lk(other._mutex);
+    _jumbo.push_back(other._jumbo[idx]);
+    const auto it = other._writesTrackers.find(idx);
+    if (it != other._writesTrackers.end()) {
+        _writesTrackers.emplace(size() - 1, it->second);
+    }
+}
 
-        auto& maxShardVersion = shardVersionIt->second.shardVersion;
+void ChunkBlock::_popBack() {
+    const size_t idx = size() - 1;
+    if (_minBounds.back().idx == idx) {
+        _minBounds.pop_back();
+    }
 
-        current =
-            std::find_if(current,
-                         _chunkMap.cend(),
-                         [&currentRangeShardId, &maxShardVersion](const auto& currentChunk) {
-                             if (currentChunk->getShardIdAt(boost::none) != currentRangeShardId)
-                                 return true;
+    _maxKeyEnds.pop_back();
+    _maxKeys.resize(_maxKeyEnds.empty() ? 0 : _maxKeyEnds.back());
+    _maxKeyTypeBitsEnds.pop_back();
+    _maxKeyTypeBits.resize(_maxKeyTypeBitsEnds.empty() ? 0 : _maxKeyTypeBitsEnds.back());
+    _shardIdxs.pop_back();
+    _placements.pop_back();
 
-                             if (maxShardVersion.isOlderThan(currentChunk->getLastmod()))
-                                 maxShardVersion = currentChunk->getLastmod();
+    _historyEnds.pop_back();
+    const size_t historySize = _historyEnds.empty() ? 0 : _historyEnds.back();
+    _historyValidAfter.resize(historySize);
+    _historyShardIdxs.resize(historySize);
 
-                             return false;
-                         });
+    _jumbo.pop_back();
+    _writesTrackers.erase(idx);
+}
 
-        const auto rangeLast = *std::prev(current);
+ChunkMap::ChunkMap(OID epoch, const Timestamp& timestamp, size_t initialCapacity)
+    : _shardTable(std::make_shared<ShardTable>()),
+      _collectionVersion({epoch, timestamp}, {0, 0}) {
+    _blocks.reserve(initialCapacity / kMaxBlockSize + 1);
+}
 
-        const auto& rangeMin = firstChunkInRange->getMin();
-        const auto& rangeMax = rangeLast->getMax();
+ShardVersionMap ChunkMap::constructShardVersionMap() const {
+    // The max version of the chunks on each shard, by index in the shard table
+    std::vector<boost::optional<uint64_t>> maxPlacements(_shardTable->shardIds.size());
 
+    // The current range of consecutive chunks which reside on the same shard, and the last chunk of
+    // the range before it
+    boost::optional<ConstIterator> firstChunkInRange;
+    boost::optional<ConstIterator> lastChunkInRange;
+    boost::optional<ConstIterator> lastChunkInPrevRange;
+
+    const auto shardIdxOf = [&](const ConstIterator& it) {
+        return _blocks[it._blockIdx]->_shardIdxs[it._chunkIdx];
+    };
+
+    const auto closeRange = [&] {
         // Check the continuity of the chunks map
-        if (lastMax && !SimpleBSONObjComparator::kInstance.evaluate(*lastMax == rangeMin)) {
-            if (SimpleBSONObjComparator::kInstance.evaluate(*lastMax < rangeMin))
-                uasserted(ErrorCodes::ConflictingOperationInProgress,
-                          str::stream() << "Gap exists in the routing table between chunks "
-                                        << findIntersectingChunk(*lastMax)->getRange().toString()
-                                        << " and " << rangeLast->getRange().toString());
-            else
+        if (lastChunkInPrevRange) {
+            const auto lastMax =
+                _blocks[lastChunkInPrevRange->_blockIdx]->_maxKeyString(
+                    lastChunkInPrevRange->_chunkIdx);
+            const auto rangeMin = _blocks[firstChunkInRange->_blockIdx]
+                                      ->_minBound(firstChunkInRange->_chunkIdx)
+                                      .keyString;
+            if (lastMax != rangeMin) {
                 uasserted(ErrorCodes::ConflictingOperationInProgress,
-                          str::stream() << "Overlap exists in the routing table between chunks "
-                                        << findIntersectingChunk(*lastMax)->getRange().toString()
-                                        << " and " << rangeLast->getRange().toString());
+                          str::stream()
+                              << (lastMax < rangeMin ? "Gap" : "Overlap")
+                              << " exists in the routing table between chunks "
+                              << (**lastChunkInPrevRange)->getRange().toString() << " and "
+                              << (**firstChunkInRange)->getRange().toString());
+            }
         }
 
-        if (!firstMin)
-            firstMin = rangeMin;
+        lastChunkInPrevRange = lastChunkInRange;
+    };
+
+    for (auto it = _begin(); it != _end(); ++it) {
+        const auto shardIdx = shardIdxOf(it);
 
-        lastMax = rangeMax;
+        if (!firstChunkInRange || shardIdxOf(*firstChunkInRange) != shardIdx) {
+            if (firstChunkInRange)
+                closeRange();
 
-        // If a shard has chunks it must have a shard version, otherwise we have an invalid chunk
-        // somewhere, which should have been caught at chunk load time
-        invariant(maxShardVersion.isSet());
+            firstChunkInRange = it;
+        }
+
+        const auto placement = _blocks[it._blockIdx]->_placements[it._chunkIdx];
+        auto& maxPlacement = maxPlacements[shardIdx];
+        if (!maxPlacement || *maxPlacement < placement)
+            maxPlacement = placement;
+
+        lastChunkInRange = it;
     }
 
-    if (!_chunkMap.empty()) {
-        invariant(!shardVersions.empty());
-        invariant(firstMin.has_value());
-        invariant(lastMax.has_value());
+    ShardVersionMap shardVersions;
 
-        checkAllElementsAreOfType(MinKey, firstMin.value());
-        checkAllElementsAreOfType(MaxKey, lastMax.value());
+    if (firstChunkInRange) {
+        closeRange();
+
+        checkAllElementsAreOfType(MinKey, _toBSON(_blocks.front()->_minBound(0)));
+        checkAllElementsAreOfType(MaxKey,
+                                  _toBSON(_blocks.back()->_maxBound(_blocks.back()->size() - 1)));
+
+        for (size_t shardIdx = 0; shardIdx < maxPlacements.size(); ++shardIdx) {
+            if (!maxPlacements[shardIdx])
+                continue;
+
+            auto& shardVersion =
+                shardVersions
+                    .emplace(std::piecewise_construct,
+                             std::forward_as_tuple(_shardTable->shardIds[shardIdx]),
+                             std::forward_as_tuple(_collectionVersion.epoch(),
+                                                   _collectionVersion.getTimestamp()))
+                    .first->second.shardVersion;
+            shardVersion = _unpackVersion(*maxPlacements[shardIdx]);
+
+            // If a shard has chunks it must have a shard version, otherwise we have an invalid
+            // chunk somewhere, which should have been caught at chunk load time
+            invariant(shardVersion.isSet());
+        }
+
+        invariant(!shardVersions.empty());
     }
 
     return shardVersions;
 }
 
 void ChunkMap::appendChunk(const std::shared_ptr<ChunkInfo>& chunk) {
-    appendChunkTo(_chunkMap, chunk);
+    if (_shardKeyFields.empty()) {
+        for (auto&& elem : chunk->getMax()) {
+            _shardKeyFields.push_back(elem.fieldName());
+        }
+    }
+
+    const auto min = encodeBound(chunk->getMin());
+    const auto max = encodeBound(chunk->getMax());
     const auto chunkVersion = chunk->getLastmod();
+
+    if (_prepareAppend(min.keyString, max.keyString, chunkVersion)) {
+        auto& block = _blockForAppend();
+        block._appendBounds({min.keyString, min.typeBits}, {max.keyString, max.typeBits});
+        block._shardIdxs.push_back(_shardIdx(chunk->getShardId()));
+        block._placements.push_back(packPlacement(chunkVersion));
+        for (const auto& entry : chunk->getHistory()) {
+            block._historyValidAfter.push_back(entry.getValidAfter());
+            block._historyShardIdxs.push_back(_shardIdx(entry.getShard()));
+        }
+        block._historyEnds.push_back(block._historyValidAfter.size());
+        block._jumbo.push_back(chunk->isJumbo());
+
+        // Only keep the writes tracker if it has something to carry over; otherwise it will be
+        // allocated if it is ever asked for
+        auto writesTracker = chunk->getWritesTracker();
+        if (writesTracker->getBytesWritten() > 0) {
+            block._writesTrackers.emplace(block.size() - 1, std::move(writesTracker));
+        }
+        ++_size;
+    }
+
     if (_collectionVersion.isOlderThan(chunkVersion)) {
         _collectionVersion = chunkVersion;
     }
@@ -224,47 +439,99 @@ void ChunkMap::appendChunk(const std::shared_ptr<ChunkInfo>& chunk) {
 std::shared_ptr<ChunkInfo> ChunkMap::findIntersectingChunk(const BSONObj& shardKey) const {
     const auto it = _findIntersectingChunk(shardKey);
 
-    if (it != _chunkMap.end())
+    if (it != _end())
         return *it;
 
     return std::shared_ptr<ChunkInfo>();
 }
 
+boost::optional<ChunkMap::ChunkRef> ChunkMap::findChunkContaining(const BSONObj& shardKey) const {
+    const auto shardKeyString = ShardKeyPattern::toKeyString(shardKey);
+    const auto it = _findIntersectingChunk(shardKeyString, true);
+
+    if (it == _end())
+        return boost::none;
+
+    const auto& block = *_blocks[it._blockIdx];
+    if (StringData(shardKeyString) < block._minBound(it._chunkIdx).keyString)
+        return boost::none;
+
+    return it.ref();
+}
+
+const ShardId* ChunkMap::findIntersectingShardId(
+    const BSONObj& shardKey, const boost::optional<Timestamp>& atClusterTime) const {
+    const auto chunk = findChunkContaining(shardKey);
+    if (!chunk)
+        return nullptr;
+
+    return &chunk->getShardIdAt(atClusterTime);
+}
+
 ChunkMap ChunkMap::createMerged(
     const std::vector<std::shared_ptr<ChunkInfo>>& changedChunks) const {
-    size_t chunkMapIndex = 0;
     size_t changedChunkIndex = 0;
 
-    ChunkMap updatedChunkMap(
-        getVersion().epoch(), getVersion().getTimestamp(), _chunkMap.size() + changedChunks.size());
+    ChunkMap updatedChunkMap(getVersion().epoch(), getVersion().getTimestamp(), _size);
+    updatedChunkMap._shardTable = _shardTable;
+    updatedChunkMap._shardKeyFields = _shardKeyFields;
 
-    while (chunkMapIndex < _chunkMap.size() || changedChunkIndex < changedChunks.size()) {
-        if (chunkMapIndex >= _chunkMap.size()) {
-            validateChunkIsNotOlderThan(changedChunks[changedChunkIndex], getVersion());
-            updatedChunkMap.appendChunk(changedChunks[changedChunkIndex++]);
-            continue;
-        }
-
-        if (changedChunkIndex >= changedChunks.size()) {
-            updatedChunkMap.appendChunk(_chunkMap[chunkMapIndex++]);
-            continue;
-        }
+    // ChunkInfo only precomputes the KeyString of the max bound
+    std::vector<std::string> changedChunkMinKeyStrings;
+    changedChunkMinKeyStrings.reserve(changedChunks.size());
+    for (const auto& changedChunk : changedChunks) {
+        changedChunkMinKeyStrings.push_back(ShardKeyPattern::toKeyString(changedChunk->getMin()));
+    }
 
-        auto overlap = _chunkMap[chunkMapIndex]->getRange().overlaps(
-            changedChunks[changedChunkIndex]->getRange());
+    const auto nextChangedChunkOverlaps = [&](const ChunkBlock& block, size_t idx) {
+        return changedChunkIndex < changedChunks.size() &&
+            StringData(changedChunkMinKeyStrings[changedChunkIndex]) < block._maxKeyString(idx) &&
+            block._minBound(idx).keyString <
+            StringData(changedChunks[changedChunkIndex]->getMaxKeyString());
+    };
 
-        if (overlap) {
+    // Appends the changed chunks which overlap the chunk at 'idx' of 'block' in place of it.
+    const auto appendChangedChunksOverlapping = [&](const ChunkBlock& block, size_t idx) {
+        while (nextChangedChunkOverlaps(block, idx)) {
             auto& changedChunk = changedChunks[changedChunkIndex++];
-            auto& chunkInfo = _chunkMap[chunkMapIndex];
 
-            auto bytesInReplacedChunk = chunkInfo->getWritesTracker()->getBytesWritten();
+            auto bytesInReplacedChunk = block.getBytesWritten(idx);
             changedChunk->getWritesTracker()->addBytesWritten(bytesInReplacedChunk);
 
             validateChunkIsNotOlderThan(changedChunk, getVersion());
             updatedChunkMap.appendChunk(changedChunk);
-        } else {
-            updatedChunkMap.appendChunk(_chunkMap[chunkMapIndex++]);
         }
+    };
+
+    for (const auto& block : _blocks) {
+        // The block can be reused as is if none of the changed chunks overlaps it, which is the
+        // case if the next changed chunk starts after it, and if the last chunk appended so far,
+        // which may be a changed chunk, does not overlap its first chunk either.
+        const bool untouched = (changedChunkIndex == changedChunks.size() ||
+                                !(StringData(changedChunkMinKeyStrings[changedChunkIndex]) <
+                                  block->_maxKeyString(block->size() - 1))) &&
+            !updatedChunkMap._overlapsLastChunk(block->_minBound(0).keyString,
+                                                block->_maxKeyString(0));
+        if (untouched) {
+            updatedChunkMap._appendBlock(block);
+            continue;
+        }
+
+        for (size_t idx = 0; idx < block->size(); ++idx) {
+            appendChangedChunksOverlapping(*block, idx);
+            updatedChunkMap._appendChunkFrom(*block, idx);
+        }
+    }
+
+    while (changedChunkIndex < changedChunks.size()) {
+        validateChunkIsNotOlderThan(changedChunks[changedChunkIndex], getVersion());
+        updatedChunkMap.appendChunk(changedChunks[changedChunkIndex++]);
+    }
+
+    // The shared blocks do not contribute to the version of the updated map, but none of their
+    // chunks is newer than the version of this map, which the changed chunks cannot be older than.
+    if (updatedChunkMap._collectionVersion.isOlderThan(_collectionVersion)) {
+        updatedChunkMap._collectionVersion = _collectionVersion;
     }
 
     return updatedChunkMap;
@@ -274,50 +541,211 @@ BSONObj ChunkMap::toBSON() const {
     BSONObjBuilder builder;
 
     getVersion().serialize("startingVersion"_sd, &builder);
-    builder.append("chunkCount", static_cast<int64_t>(_chunkMap.size()));
+    builder.append("chunkCount", static_cast<int64_t>(_size));
 
     {
         BSONArrayBuilder arrayBuilder(builder.subarrayStart("chunks"_sd));
-        for (const auto& chunk : _chunkMap) {
+        forEach([&](const auto& chunk) {
             arrayBuilder.append(chunk->toString());
-        }
+            return true;
+        });
     }
 
     return builder.obj();
 }
 
-ChunkMap::ChunkVector::const_iterator ChunkMap::_findIntersectingChunk(const BSONObj& shardKey,
-                                                                       bool isMaxInclusive) const {
-    auto shardKeyString = ShardKeyPattern::toKeyString(shardKey);
+ChunkMap::ConstIterator ChunkMap::_findIntersectingChunk(const BSONObj& shardKey,
+                                                         bool isMaxInclusive) const {
+    return _findIntersectingChunk(ShardKeyPattern::toKeyString(shardKey), isMaxInclusive);
+}
 
-    if (!isMaxInclusive) {
-        return std::lower_bound(_chunkMap.begin(),
-                                _chunkMap.end(),
-                                shardKey,
-                                [&shardKeyString](const auto& chunkInfo, const BSONObj& shardKey) {
-                                    return chunkInfo->getMaxKeyString() < shardKeyString;
-                                });
-    } else {
-        return std::upper_bound(_chunkMap.begin(),
-                                _chunkMap.end(),
-                                shardKey,
-                                [&shardKeyString](const BSONObj& shardKey, const auto& chunkInfo) {
-                                    return shardKeyString < chunkInfo->getMaxKeyString();
-                                });
+ChunkMap::ConstIterator ChunkMap::_findIntersectingChunk(StringData shardKeyString,
+                                                         bool isMaxInclusive) const {
+    // Finds the first chunk whose max key is greater than the shard key (or greater than or equal
+    // to it, if the max key is exclusive), first among the blocks by their last chunk, and then
+    // within the block.
+    const auto isBeforeShardKey = [&](const ChunkBlock& block, size_t idx) {
+        const auto maxKeyString = block._maxKeyString(idx);
+        return isMaxInclusive ? !(shardKeyString < maxKeyString) : maxKeyString < shardKeyString;
+    };
+
+    const auto blockIt = std::partition_point(
+        _blocks.begin(), _blocks.end(), [&](const ChunkBlockPtr& block) {
+            return isBeforeShardKey(*block, block->size() - 1);
+        });
+    if (blockIt == _blocks.end()) {
+        return _end();
+    }
+
+    // The last chunk of the block is not before the shard key
+    const auto& block = **blockIt;
+    size_t low = 0;
+    size_t high = block.size() - 1;
+    while (low < high) {
+        const size_t mid = low + (high - low) / 2;
+        if (isBeforeShardKey(block, mid)) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
     }
+
+    return ConstIterator(this, blockIt - _blocks.begin(), low);
 }
 
-std::pair<ChunkMap::ChunkVector::const_iterator, ChunkMap::ChunkVector::const_iterator>
-ChunkMap::_overlappingBounds(const BSONObj& min, const BSONObj& max, bool isMaxInclusive) const {
+std::pair<ChunkMap::ConstIterator, ChunkMap::ConstIterator> ChunkMap::_overlappingBounds(
+    const BSONObj& min, const BSONObj& max, bool isMaxInclusive) const {
     const auto itMin = _findIntersectingChunk(min);
     const auto itMax = [&]() {
         auto it = _findIntersectingChunk(max, isMaxInclusive);
-        return it == _chunkMap.end() ? it : ++it;
+        return it == _end() ? it : ++it;
     }();
 
     return {itMin, itMax};
 }
 
+std::shared_ptr<ChunkInfo> ChunkMap::_makeChunkInfo(const ChunkBlockPtr& block, size_t idx) const {
+    const auto& shardIds = _shardTable->shardIds;
+
+    const size_t historyBegin = idx == 0 ? 0 : block->_historyEnds[idx - 1];
+    const size_t historyEnd = block->_historyEnds[idx];
+    std::vector<ChunkHistory> history;
+    history.reserve(historyEnd - historyBegin);
+    for (size_t i = historyBegin; i < historyEnd; ++i) {
+        history.emplace_back(block->_historyValidAfter[i], shardIds[block->_historyShardIdxs[i]]);
+    }
+
+    const auto max = block->_maxBound(idx);
+    return std::make_shared<ChunkInfo>(ChunkRange(_toBSON(block->_minBound(idx)), _toBSON(max)),
+                                       max.keyString.toString(),
+                                       shardIds[block->_shardIdxs[idx]],
+                                       _unpackVersion(block->_placements[idx]),
+                                       std::move(history),
+                                       block,
+                                       idx);
+}
+
+const ShardId& ChunkMap::_shardIdAt(size_t blockIdx,
+                                    size_t chunkIdx,
+                                    const boost::optional<Timestamp>& atClusterTime) const {
+    return _shardTable->shardIds[_blocks[blockIdx]->_shardIdxAt(chunkIdx, atClusterTime)];
+}
+
+ChunkRange ChunkMap::_range(size_t blockIdx, size_t chunkIdx) const {
+    const auto& block = *_blocks[blockIdx];
+    return ChunkRange(_toBSON(block._minBound(chunkIdx)), _toBSON(block._maxBound(chunkIdx)));
+}
+
+BSONObj ChunkMap::_toBSON(const ChunkBlock::Bound& bound) const {
+    BufReader reader(bound.typeBits.rawData(), bound.typeBits.size());
+    const auto typeBits = KeyString::TypeBits::fromBuffer(KeyString::Version::V1, &reader);
+    const auto key = KeyString::toBson(
+        bound.keyString.rawData(), bound.keyString.size(), Ordering::allAscending(), typeBits);
+
+    // The KeyString does not contain the field names
+    BSONObjBuilder builder;
+    auto fieldIt = _shardKeyFields.begin();
+    for (auto&& elem : key) {
+        invariant(fieldIt != _shardKeyFields.end());
+        builder.appendAs(elem, *fieldIt++);
+    }
+    return builder.obj();
+}
+
+ChunkVersion ChunkMap::_unpackVersion(uint64_t placement) const {
+    return ChunkVersion({_collectionVersion.epoch(), _collectionVersion.getTimestamp()},
+                        {static_cast<uint32_t>(placement >> 32), static_cast<uint32_t>(placement)});
+}
+
+uint16_t ChunkMap::_shardIdx(const ShardId& shardId) {
+    const auto it = _shardTable->indexes.find(shardId);
+    if (it != _shardTable->indexes.end()) {
+        return it->second;
+    }
+
+    uassert(7095766,
+            "Too many shards in the routing table",
+            _shardTable->shardIds.size() < std::numeric_limits<uint16_t>::max());
+
+    if (_shardTable.use_count() > 1) {
+        _shardTable = std::make_shared<ShardTable>(*_shardTable);
+    }
+
+    const auto idx = static_cast<uint16_t>(_shardTable->shardIds.size());
+    _shardTable->shardIds.push_back(shardId);
+    _shardTable->indexes.emplace(shardId, idx);
+    return idx;
+}
+
+bool ChunkMap::_overlapsLastChunk(StringData minKeyString, StringData maxKeyString) const {
+    if (_blocks.empty()) {
+        return false;
+    }
+
+    const auto& lastBlock = *_blocks.back();
+    const auto lastIdx = lastBlock.size() - 1;
+    return minKeyString < lastBlock._maxKeyString(lastIdx) &&
+        lastBlock._minBound(lastIdx).keyString < maxKeyString;
+}
+
+bool ChunkMap::_prepareAppend(StringData minKeyString,
+                              StringData maxKeyString,
+                              ChunkVersion version) {
+    if (!_overlapsLastChunk(minKeyString, maxKeyString)) {
+        return true;
+    }
+
+    if (!_unpackVersion(_blocks.back()->_placements.back()).isOlderThan(version)) {
+        return false;
+    }
+
+    _lastBlockForWrite()._popBack();
+    --_size;
+    return true;
+}
+
+void ChunkMap::_appendChunkFrom(const ChunkBlock& block, size_t idx) {
+    const auto chunkVersion = _unpackVersion(block._placements[idx]);
+
+    if (_prepareAppend(block._minBound(idx).keyString, block._maxKeyString(idx), chunkVersion)) {
+        _blockForAppend()._appendFrom(block, idx);
+        ++_size;
+    }
+
+    if (_collectionVersion.isOlderThan(chunkVersion)) {
+        _collectionVersion = chunkVersion;
+    }
+}
+
+void ChunkMap::_appendBlock(const ChunkBlockPtr& block) {
+    if (!_blocks.empty() && _blocks.back().use_count() == 1 &&
+        _blocks.back()->size() + block->size() <= kMaxBlockSize) {
+        auto& lastBlock = *_blocks.back();
+        for (size_t idx = 0; idx < block->size(); ++idx) {
+            lastBlock._appendFrom(*block, idx);
+        }
+    } else {
+        _blocks.push_back(block);
+    }
+    _size += block->size();
+}
+
+ChunkBlock& ChunkMap::_lastBlockForWrite() {
+    auto& lastBlock = _blocks.back();
+    if (lastBlock.use_count() > 1) {
+        lastBlock = std::make_shared<ChunkBlock>(*lastBlock);
+    }
+    return *lastBlock;
+}
+
+ChunkBlock& ChunkMap::_blockForAppend() {
+    if (_blocks.empty() || _blocks.back()->size() >= kMaxBlockSize) {
+        _blocks.push_back(std::make_shared<ChunkBlock>());
+        return *_blocks.back();
+    }
+    return _lastBlockForWrite();
+}
+
 ShardVersionTargetingInfo::ShardVersionTargetingInfo(const OID& epoch, const Timestamp& timestamp)
     : shardVersion({epoch, timestamp}, {0, 0}) {}
 
@@ -364,6 +792,14 @@ void RoutingTableHistory::setAllShardsRefreshed() {
 Chunk ChunkManager::findIntersectingChunk(const BSONObj& shardKey,
                                           const BSONObj& collation,
                                           bool bypassIsFieldHashedCheck) const {
+    return Chunk(
+        _findIntersectingChunkRef(shardKey, collation, bypassIsFieldHashedCheck).makeChunkInfo(),
+        _clusterTime);
+}
+
+ChunkMap::ChunkRef ChunkManager::_findIntersectingChunkRef(const BSONObj& shardKey,
+                                                           const BSONObj& collation,
+                                                           bool bypassIsFieldHashedCheck) const {
     const bool hasSimpleCollation = (collation.isEmpty() && !_rt->optRt->getDefaultCollator()) ||
         SimpleBSONObjComparator::kInstance.evaluate(collation == CollationSpec::kSimpleSpec);
     if (!hasSimpleCollation) {
@@ -387,27 +823,27 @@ Chunk ChunkManager::findIntersectingChunk(const BSONObj& shardKey,
         }
     }
 
-    auto chunkInfo = _rt->optRt->findIntersectingChunk(shardKey);
+    auto chunk = _rt->optRt->findChunkContaining(shardKey);
 
     uassert(ErrorCodes::ShardKeyNotFound,
             str::stream() << "Cannot target single shard using key " << shardKey
                           << " for namespace " << _rt->optRt->nss(),
-            chunkInfo && chunkInfo->containsKey(shardKey));
+            chunk);
 
-    return Chunk(*chunkInfo, _clusterTime);
+    return *chunk;
 }
 
 bool ChunkManager::keyBelongsToShard(const BSONObj& shardKey, const ShardId& shardId) const {
     if (shardKey.isEmpty())
         return false;
 
-    auto chunkInfo = _rt->optRt->findIntersectingChunk(shardKey);
-    if (!chunkInfo)
+    // Looks up the owning shard without building the ChunkInfo, since the shard filtering of reads
+    // calls this for every document
+    const auto ownerShardId = _rt->optRt->findIntersectingShardId(shardKey, _clusterTime);
+    if (!ownerShardId)
         return false;
 
-    invariant(chunkInfo->containsKey(shardKey));
-
-    return chunkInfo->getShardIdAt(_clusterTime) == shardId;
+    return *ownerShardId == shardId;
 }
 
 void ChunkManager::getShardIdsForQuery(boost::intrusive_ptr<ExpressionContext> expCtx,
@@ -444,8 +880,8 @@ void ChunkManager::getShardIdsForQuery(boost::intrusive_ptr<ExpressionContext> e
     auto shardKeyToFind = _rt->optRt->getShardKeyPattern().extractShardKeyFromQuery(*cq);
     if (!shardKeyToFind.isEmpty()) {
         try {
-            auto chunk = findIntersectingChunk(shardKeyToFind, collation);
-            shardIds->insert(chunk.getShardId());
+            auto chunk = _findIntersectingChunkRef(shardKeyToFind, collation);
+            shardIds->insert(chunk.getShardIdAt(_clusterTime));
             if (chunkRanges) {
                 chunkRanges->insert(chunk.getRange());
             }
@@ -518,10 +954,11 @@ void ChunkManager::getShardIdsForRange(const BSONObj& min,
         return;
     }
 
-    _rt->optRt->forEachOverlappingChunk(min, max, true, [&](auto& chunkInfo) {
-        shardIds->insert(chunkInfo->getShardIdAt(_clusterTime));
+    // Only decodes the range of a chunk if it is asked for
+    _rt->optRt->forEachOverlappingChunkRef(min, max, true, [&](const auto& chunk) {
+        shardIds->insert(chunk.getShardIdAt(_clusterTime));
         if (chunkRanges) {
-            chunkRanges->insert(chunkInfo->getRange());
+            chunkRanges->insert(chunk.getRange());
         }
 
         // No need to iterate through the rest of the ranges, because we already know we need to use
@@ -540,9 +977,9 @@ void ChunkManager::getShardIdsForRange(const BSONObj& min,
 bool ChunkManager::rangeOverlapsShard(const ChunkRange& range, const ShardId& shardId) const {
     bool overlapFound = false;
 
-    _rt->optRt->forEachOverlappingChunk(
-        range.getMin(), range.getMax(), false, [&](auto& chunkInfo) {
-            if (chunkInfo->getShardIdAt(_clusterTime) == shardId) {
+    _rt->optRt->forEachOverlappingChunkRef(
+        range.getMin(), range.getMax(), false, [&](const auto& chunk) {
+            if (chunk.getShardIdAt(_clusterTime) == shardId) {
                 overlapFound = true;
                 return false;
             }
@@ -557,10 +994,11 @@ boost::optional<Chunk> ChunkManager::getNextChunkOnShard(const BSONObj& shardKey
                                                          const ShardId& shardId) const {
     boost::optional<Chunk> chunk;
 
-    _rt->optRt->forEachChunk(
-        [&](auto& chunkInfo) {
-            if (chunkInfo->getShardIdAt(_clusterTime) == shardId) {
-                chunk.emplace(*chunkInfo, _clusterTime);
+    // Only builds the ChunkInfo of the chunk which is returned
+    _rt->optRt->forEachChunkRef(
+        [&](const auto& chunkRef) {
+            if (chunkRef.getShardIdAt(_clusterTime) == shardId) {
+                chunk.emplace(chunkRef.makeChunkInfo(), _clusterTime);
                 return false;
             }
             return true;
@@ -572,7 +1010,7 @@ boost::optional<Chunk> ChunkManager::getNextChunkOnShard(const BSONObj& shardKey
 
 ShardId ChunkManager::getMinKeyShardIdWithSimpleCollation() const {
     auto minKey = getShardKeyPattern().getKeyPattern().globalMin();
-    return findIntersectingChunkWithSimpleCollation(minKey).getShardId();
+    return _findIntersectingChunkRef(minKey, CollationSpec::kSimpleSpec).getShardIdAt(_clusterTime);
 }
 
 void RoutingTableHistory::getAllShardIds(std::set<ShardId>* all) const {
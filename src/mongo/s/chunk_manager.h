@@ -29,12 +29,14 @@
 
 #pragma once
 
+#include <algorithm>
 #include <set>
 #include <string>
 #include <vector>
 
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/platform/mutex.h"
 #include "mongo/s/chunk.h"
 #include "mongo/s/database_version.h"
 #include "mongo/s/resharding/type_collection_fields_gen.h"
@@ -64,20 +66,215 @@ struct ShardVersionTargetingInfo {
 // shard is currently marked as needing a catalog cache refresh (stale).
 using ShardVersionMap = stdx::unordered_map<ShardId, ShardVersionTargetingInfo, ShardId::Hasher>;
 
+/**
+ * Holds up to ChunkMap::kMaxBlockSize consecutive chunks of a ChunkMap in compact form, so that a
+ * routing table does not need a heap object per chunk:
+ *  - The max bounds are KeyStrings stored one after the other in a single buffer, next to the
+ *    TypeBits needed to turn them back into BSON. The min bound of a chunk is the max bound of the
+ *    chunk before it, so it is only stored for the first chunk of the block and for any chunk which
+ *    does not start where the chunk before it ends.
+ *  - The shard ids are indexes into the shard table of the ChunkMap.
+ *  - The versions are packed major and minor versions. Their epoch and timestamp are those of the
+ *    map.
+ *  - The history entries of all the chunks are stored in flat arrays.
+ *
+ * The ChunkMap builds the ChunkInfo of a chunk from its block on demand. The jumbo flags and the
+ * writes trackers, which change after the chunks have been loaded, stay in the block, and the
+ * writes tracker of a chunk is only allocated once it is asked for.
+ */
+class ChunkBlock {
+public:
+    ChunkBlock() = default;
+
+    /**
+     * Copies the chunks of 'other', which keep sharing their writes trackers with it.
+     */
+    ChunkBlock(const ChunkBlock& other);
+    ChunkBlock& operator=(const ChunkBlock&) = delete;
+
+    size_t size() const {
+        return _maxKeyEnds.size();
+    }
+
+    bool isJumbo(size_t idx) const;
+
+    void markAsJumbo(size_t idx) const;
+
+    /**
+     * Returns the writes tracker of the chunk at 'idx', which is allocated on the first call.
+     */
+    std::shared_ptr<ChunkWritesTracker> getWritesTracker(size_t idx) const;
+
+    /**
+     * Returns the writes tracker of the chunk at 'idx', or nullptr if it has not been allocated.
+     */
+    std::shared_ptr<ChunkWritesTracker> peekWritesTracker(size_t idx) const;
+
+    /**
+     * Returns the number of bytes written to the chunk at 'idx', without allocating its writes
+     * tracker.
+     */
+    uint64_t getBytesWritten(size_t idx) const;
+
+private:
+    friend class ChunkMap;
+
+    // A chunk bound as a KeyString and the TypeBits of the KeyString, which are empty when they are
+    // all zeros
+    struct Bound {
+        StringData keyString;
+        StringData typeBits;
+    };
+
+    // The min bound of a chunk which does not start at the max bound of the chunk before it
+    struct MinBound {
+        uint32_t idx;
+        std::string keyString;
+        std::string typeBits;
+    };
+
+    StringData _maxKeyString(size_t idx) const;
+    Bound _maxBound(size_t idx) const;
+    Bound _minBound(size_t idx) const;
+
+    /**
+     * Returns the index in the shard table of the shard which owned the chunk at 'idx' at
+     * 'atClusterTime', or which owns it now if 'atClusterTime' is not set.
+     */
+    uint16_t _shardIdxAt(size_t idx, const boost::optional<Timestamp>& atClusterTime) const;
+
+    /**
+     * Appends the bounds of a new last chunk.
+     */
+    void _appendBounds(const Bound& min, const Bound& max);
+
+    /**
+     * Appends the chunk at 'idx' of 'other', whose shard indexes refer to the same shard table.
+     */
+    void _appendFrom(const ChunkBlock& other, size_t idx);
+
+    void _popBack();
+
+    std::string _maxKeys;
+    std::vector<uint32_t> _maxKeyEnds;
+    std::string _maxKeyTypeBits;
+    std::vector<uint32_t> _maxKeyTypeBitsEnds;
+
+    // Ordered by chunk index, and always starts with the min bound of the first chunk
+    std::vector<MinBound> _minBounds;
+
+    std::vector<uint16_t> _shardIdxs;
+
+    // The major version in the high 32 bits and the minor version in the low 32 bits
+    std::vector<uint64_t> _placements;
+
+    // The history entries of all the chunks, and the index at which the entries of each chunk end
+    std::vector<Timestamp> _historyValidAfter;
+    std::vector<uint16_t> _historyShardIdxs;
+    std::vector<uint32_t> _historyEnds;
+
+    // Guards the jumbo flags and the writes trackers, which change while the block is in use
+    mutable Mutex _mutex = MONGO_MAKE_LATCH("ChunkBlock::_mutex");
+    mutable std::vector<bool> _jumbo;
+    mutable stdx::unordered_map<uint32_t, std::shared_ptr<ChunkWritesTracker>> _writesTrackers;
+};
+
 /**
  * This class serves as a Facade around how the mapping of ranges to chunks is represented. It also
  * provides a simpler, high-level interface for domain specific operations without exposing the
  * underlying implementation.
  */
 class ChunkMap {
-    // Vector of chunks ordered by max key.
-    using ChunkVector = std::vector<std::shared_ptr<ChunkInfo>>;
+    // The chunks are stored in blocks of at most 'kMaxBlockSize' chunks. A block is copied before
+    // it is modified if another map refers to it, so a map created by createMerged() shares every
+    // block which the changed chunks do not touch with the map it was created from, and a refresh
+    // only copies the blocks it changes.
+    using ChunkBlockPtr = std::shared_ptr<ChunkBlock>;
+
+    // The shards which the blocks refer to by index. Shards are only ever added to the table, so
+    // the blocks which a map shares with the map it was created from are valid with either table.
+    struct ShardTable {
+        std::vector<ShardId> shardIds;
+        stdx::unordered_map<ShardId, uint16_t, ShardId::Hasher> indexes;
+    };
 
 public:
+    static constexpr size_t kMaxBlockSize = 1024;
+
+    /**
+     * Refers to a chunk in its block. Only the parts of the chunk which are asked for are decoded,
+     * so looking up the shards or the ranges of chunks does not build their ChunkInfo.
+     */
+    class ChunkRef {
+    public:
+        const ShardId& getShardIdAt(const boost::optional<Timestamp>& atClusterTime) const {
+            return _map->_shardIdAt(_blockIdx, _chunkIdx, atClusterTime);
+        }
+
+        ChunkRange getRange() const {
+            return _map->_range(_blockIdx, _chunkIdx);
+        }
+
+        std::shared_ptr<ChunkInfo> makeChunkInfo() const {
+            return _map->_makeChunkInfo(_map->_blocks[_blockIdx], _chunkIdx);
+        }
+
+    private:
+        friend class ChunkMap;
+
+        ChunkRef(const ChunkMap* map, size_t blockIdx, size_t chunkIdx)
+            : _map(map), _blockIdx(blockIdx), _chunkIdx(chunkIdx) {}
+
+        const ChunkMap* _map;
+        size_t _blockIdx;
+        size_t _chunkIdx;
+    };
+
+    /**
+     * Iterates over the chunks of a map in max key order, building the ChunkInfo of every chunk it
+     * visits.
+     */
+    class ConstIterator {
+    public:
+        std::shared_ptr<ChunkInfo> operator*() const {
+            return ref().makeChunkInfo();
+        }
+
+        ChunkRef ref() const {
+            return ChunkRef(_map, _blockIdx, _chunkIdx);
+        }
+
+        ConstIterator& operator++() {
+            if (++_chunkIdx == _map->_blocks[_blockIdx]->size()) {
+                ++_blockIdx;
+                _chunkIdx = 0;
+            }
+            return *this;
+        }
+
+        bool operator==(const ConstIterator& other) const {
+            return _blockIdx == other._blockIdx && _chunkIdx == other._chunkIdx;
+        }
+
+        bool operator!=(const ConstIterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        friend class ChunkMap;
+
+        ConstIterator(const ChunkMap* map, size_t blockIdx, size_t chunkIdx)
+            : _map(map), _blockIdx(blockIdx), _chunkIdx(chunkIdx) {}
+
+        const ChunkMap* _map;
+        size_t _blockIdx;
+        size_t _chunkIdx;
+    };
+
     ChunkMap(OID epoch, const Timestamp& timestamp, size_t initialCapacity = 0);
 
     size_t size() const {
-        return _chunkMap.size();
+        return _size;
     }
 
     ChunkVersion getVersion() const {
@@ -86,10 +283,24 @@ public:
 
     template <typename Callable>
     void forEach(Callable&& handler, const BSONObj& shardKey = BSONObj()) const {
-        auto it = shardKey.isEmpty() ? _chunkMap.begin() : _findIntersectingChunk(shardKey);
+        auto it = shardKey.isEmpty() ? _begin() : _findIntersectingChunk(shardKey);
+
+        for (; it != _end(); ++it) {
+            auto chunk = *it;
+            if (!handler(chunk))
+                break;
+        }
+    }
+
+    /**
+     * Same as forEach(), but passes 'handler' a ChunkRef instead of building a ChunkInfo.
+     */
+    template <typename Callable>
+    void forEachRef(Callable&& handler, const BSONObj& shardKey = BSONObj()) const {
+        auto it = shardKey.isEmpty() ? _begin() : _findIntersectingChunk(shardKey);
 
-        for (; it != _chunkMap.end(); ++it) {
-            if (!handler(*it))
+        for (; it != _end(); ++it) {
+            if (!handler(it.ref()))
                 break;
         }
     }
@@ -102,7 +313,25 @@ public:
         const auto bounds = _overlappingBounds(min, max, isMaxInclusive);
 
         for (auto it = bounds.first; it != bounds.second; ++it) {
-            if (!handler(*it))
+            auto chunk = *it;
+            if (!handler(chunk))
+                break;
+        }
+    }
+
+    /**
+     * Same as forEachOverlappingChunk(), but passes 'handler' a ChunkRef instead of building a
+     * ChunkInfo.
+     */
+    template <typename Callable>
+    void forEachOverlappingChunkRef(const BSONObj& min,
+                                    const BSONObj& max,
+                                    bool isMaxInclusive,
+                                    Callable&& handler) const {
+        const auto bounds = _overlappingBounds(min, max, isMaxInclusive);
+
+        for (auto it = bounds.first; it != bounds.second; ++it) {
+            if (!handler(it.ref()))
                 break;
         }
     }
@@ -110,19 +339,121 @@ public:
     ShardVersionMap constructShardVersionMap() const;
     std::shared_ptr<ChunkInfo> findIntersectingChunk(const BSONObj& shardKey) const;
 
+    /**
+     * Returns the chunk which contains 'shardKey', or boost::none if no chunk contains it.
+     */
+    boost::optional<ChunkRef> findChunkContaining(const BSONObj& shardKey) const;
+
+    /**
+     * Returns the shard which owned the chunk containing 'shardKey' at 'atClusterTime', or which
+     * owns it now if 'atClusterTime' is not set, without building the ChunkInfo of the chunk.
+     * Returns nullptr if no chunk contains 'shardKey'.
+     */
+    const ShardId* findIntersectingShardId(const BSONObj& shardKey,
+                                           const boost::optional<Timestamp>& atClusterTime) const;
+
     void appendChunk(const std::shared_ptr<ChunkInfo>& chunk);
 
+    /**
+     * Returns a new map in which 'changedChunks', which must be ordered by max key and must not
+     * overlap, replace the chunks they overlap. Only the blocks which contain replaced chunks are
+     * copied; the new map shares all the other blocks with this one.
+     */
     ChunkMap createMerged(const std::vector<std::shared_ptr<ChunkInfo>>& changedChunks) const;
 
     BSONObj toBSON() const;
 
+    /**
+     * Returns the number of blocks the chunks are stored in.
+     */
+    size_t numBlocks_forTest() const {
+        return _blocks.size();
+    }
+
+    /**
+     * Returns true if the block at 'blockIdx' is shared with 'other'.
+     */
+    bool sharesBlockWith_forTest(const ChunkMap& other, size_t blockIdx) const {
+        return std::find(other._blocks.begin(), other._blocks.end(), _blocks[blockIdx]) !=
+            other._blocks.end();
+    }
+
 private:
-    ChunkVector::const_iterator _findIntersectingChunk(const BSONObj& shardKey,
-                                                       bool isMaxInclusive = true) const;
-    std::pair<ChunkVector::const_iterator, ChunkVector::const_iterator> _overlappingBounds(
-        const BSONObj& min, const BSONObj& max, bool isMaxInclusive) const;
+    ConstIterator _begin() const {
+        return ConstIterator(this, 0, 0);
+    }
+
+    ConstIterator _end() const {
+        return ConstIterator(this, _blocks.size(), 0);
+    }
+
+    ConstIterator _findIntersectingChunk(const BSONObj& shardKey,
+                                         bool isMaxInclusive = true) const;
+    ConstIterator _findIntersectingChunk(StringData shardKeyString, bool isMaxInclusive) const;
+    std::pair<ConstIterator, ConstIterator> _overlappingBounds(const BSONObj& min,
+                                                               const BSONObj& max,
+                                                               bool isMaxInclusive) const;
+
+    std::shared_ptr<ChunkInfo> _makeChunkInfo(const ChunkBlockPtr& block, size_t idx) const;
+
+    const ShardId& _shardIdAt(size_t blockIdx,
+                              size_t chunkIdx,
+                              const boost::optional<Timestamp>& atClusterTime) const;
+
+    ChunkRange _range(size_t blockIdx, size_t chunkIdx) const;
+
+    /**
+     * Turns a bound stored in a block back into a shard key.
+     */
+    BSONObj _toBSON(const ChunkBlock::Bound& bound) const;
 
-    ChunkVector _chunkMap;
+    ChunkVersion _unpackVersion(uint64_t placement) const;
+
+    /**
+     * Returns the index of 'shardId' in the shard table, after adding it if it is not there yet.
+     */
+    uint16_t _shardIdx(const ShardId& shardId);
+
+    bool _overlapsLastChunk(StringData minKeyString, StringData maxKeyString) const;
+
+    /**
+     * Makes room for a chunk with the given bounds and version at the end of the map. A chunk which
+     * overlaps the last chunk replaces it if it is newer, and is dropped otherwise, in which case
+     * this returns false.
+     */
+    bool _prepareAppend(StringData minKeyString, StringData maxKeyString, ChunkVersion version);
+
+    /**
+     * Appends the chunk at 'idx' of a block of another map in the same lineage as this one.
+     */
+    void _appendChunkFrom(const ChunkBlock& block, size_t idx);
+
+    /**
+     * Appends a block of another map. The block is shared, unless its chunks fit into the last
+     * block of this map and that block is not shared, in which case they are copied into it. This
+     * keeps the blocks around the changed chunks from getting smaller with every merge.
+     */
+    void _appendBlock(const ChunkBlockPtr& block);
+
+    /**
+     * Returns the last block, after copying it if it is shared with another map.
+     */
+    ChunkBlock& _lastBlockForWrite();
+
+    /**
+     * Returns the block to append the next chunk to, which is the last block unless it is full.
+     */
+    ChunkBlock& _blockForAppend();
+
+    std::vector<ChunkBlockPtr> _blocks;
+
+    std::shared_ptr<ShardTable> _shardTable;
+
+    // Names of the shard key fields, which the KeyStrings of the bounds do not contain
+    std::vector<std::string> _shardKeyFields;
+
+    // Total number of chunks across all blocks
+    size_t _size = 0;
 
     // Max version across all chunks
     ChunkVersion _collectionVersion;
@@ -242,6 +573,11 @@ public:
         _chunkMap.forEach(std::forward<Callable>(handler), shardKey);
     }
 
+    template <typename Callable>
+    void forEachChunkRef(Callable&& handler, const BSONObj& shardKey = BSONObj()) const {
+        _chunkMap.forEachRef(std::forward<Callable>(handler), shardKey);
+    }
+
     template <typename Callable>
     void forEachOverlappingChunk(const BSONObj& min,
                                  const BSONObj& max,
@@ -251,10 +587,28 @@ public:
             min, max, isMaxInclusive, std::forward<Callable>(handler));
     }
 
+    template <typename Callable>
+    void forEachOverlappingChunkRef(const BSONObj& min,
+                                    const BSONObj& max,
+                                    bool isMaxInclusive,
+                                    Callable&& handler) const {
+        _chunkMap.forEachOverlappingChunkRef(
+            min, max, isMaxInclusive, std::forward<Callable>(handler));
+    }
+
     std::shared_ptr<ChunkInfo> findIntersectingChunk(const BSONObj& shardKey) const {
         return _chunkMap.findIntersectingChunk(shardKey);
     }
 
+    boost::optional<ChunkMap::ChunkRef> findChunkContaining(const BSONObj& shardKey) const {
+        return _chunkMap.findChunkContaining(shardKey);
+    }
+
+    const ShardId* findIntersectingShardId(const BSONObj& shardKey,
+                                           const boost::optional<Timestamp>& atClusterTime) const {
+        return _chunkMap.findIntersectingShardId(shardKey, atClusterTime);
+    }
+
     /**
      * Returns the ids of all shards on which the collection has any chunks.
      */
@@ -558,7 +912,7 @@ public:
     void forEachChunk(Callable&& handler) const {
         _rt->optRt->forEachChunk(
             [this, handler = std::forward<Callable>(handler)](const auto& chunkInfo) mutable {
-                if (!handler(Chunk{*chunkInfo, _clusterTime}))
+                if (!handler(Chunk{chunkInfo, _clusterTime}))
                     return false;
 
                 return true;
@@ -714,6 +1068,13 @@ public:
     }
 
 private:
+    /**
+     * Same as findIntersectingChunk(), but does not build the ChunkInfo of the chunk.
+     */
+    ChunkMap::ChunkRef _findIntersectingChunkRef(const BSONObj& shardKey,
+                                                 const BSONObj& collation,
+                                                 bool bypassIsFieldHashedCheck = false) const;
+
     ShardId _dbPrimary;
     DatabaseVersion _dbVersion;
 
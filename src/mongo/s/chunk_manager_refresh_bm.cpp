@@ -150,7 +150,49 @@ void BM_IncrementalRefreshOfPessimalBalancedDistribution(benchmark::State& state
 BENCHMARK(BM_IncrementalRefreshOfPessimalBalancedDistribution)
     ->Args({2, 50000})
     ->Args({2, 250000})
-    ->Args({2, 500000});
+    ->Args({2, 500000})
+    ->Args({2, 1000000});
+
+// Measures the merge of a split into the chunk map alone, which only copies the block of chunks
+// holding the split chunk, without building the rest of the routing table.
+void BM_IncrementalMergeOfChunkMap(benchmark::State& state) {
+    const uint32_t nChunks = state.range(0);
+
+    const auto collUuid = UUID::gen();
+    const auto collEpoch = OID::gen();
+
+    std::vector<std::shared_ptr<ChunkInfo>> chunks;
+    chunks.reserve(nChunks);
+    for (uint32_t i = 0; i < nChunks; ++i) {
+        chunks.push_back(std::make_shared<ChunkInfo>(
+            ChunkType(collUuid,
+                      getRangeForChunk(i, nChunks),
+                      ChunkVersion({collEpoch, Timestamp(1, 0)}, {i + 1, 0}),
+                      pessimalShardSelector(i, 2, nChunks))));
+    }
+    const auto chunkMap = ChunkMap(collEpoch, Timestamp(1, 0)).createMerged(chunks);
+
+    const int splitChunk = nChunks / 2;
+    const auto splitRange = getRangeForChunk(splitChunk, nChunks);
+    const auto splitPoint = BSON("_id" << (splitChunk - 1) * 100 + 50);
+    auto splitVersion = chunkMap.getVersion();
+    splitVersion.incMajor();
+    std::vector<std::shared_ptr<ChunkInfo>> splitChunks{
+        std::make_shared<ChunkInfo>(ChunkType(collUuid,
+                                              ChunkRange(splitRange.getMin(), splitPoint),
+                                              splitVersion,
+                                              ShardId("shard0"))),
+        std::make_shared<ChunkInfo>(ChunkType(collUuid,
+                                              ChunkRange(splitPoint, splitRange.getMax()),
+                                              splitVersion,
+                                              ShardId("shard0")))};
+
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(chunkMap.createMerged(splitChunks));
+    }
+}
+
+BENCHMARK(BM_IncrementalMergeOfChunkMap)->Arg(50000)->Arg(250000)->Arg(1000000);
 
 template <typename ShardSelectorFn>
 auto BM_FullBuildOfChunkManager(benchmark::State& state, ShardSelectorFn selectShard) {
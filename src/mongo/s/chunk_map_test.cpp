@@ -46,6 +46,23 @@ public:
         return _uuid;
     }
 
+    /**
+     * Returns 'numChunks' chunks of version 'version' covering the whole key space, the i-th of
+     * which starts at {a: i * 10}.
+     */
+    std::vector<std::shared_ptr<ChunkInfo>> makeChunks(int numChunks,
+                                                       const ChunkVersion& version) const {
+        std::vector<std::shared_ptr<ChunkInfo>> chunks;
+        for (int i = 0; i < numChunks; ++i) {
+            auto min = i == 0 ? getShardKeyPattern().globalMin() : BSON("a" << i * 10);
+            auto max = i + 1 == numChunks ? getShardKeyPattern().globalMax()
+                                          : BSON("a" << (i + 1) * 10);
+            chunks.push_back(std::make_shared<ChunkInfo>(
+                ChunkType{uuid(), ChunkRange{min, max}, version, kThisShard}));
+        }
+        return chunks;
+    }
+
 private:
     KeyPattern _shardKeyPattern{BSON("a" << 1)};
     const UUID _uuid = UUID::gen();
@@ -167,4 +184,238 @@ TEST_F(ChunkMapTest, TestEnumerateOverlappingChunks) {
     ASSERT_EQ(count, 3);
 }
 
+TEST_F(ChunkMapTest, TestIntersectingChunkAcrossBlocks) {
+    const OID epoch = OID::gen();
+    const int numChunks = 3 * ChunkMap::kMaxBlockSize + 1;
+    ChunkVersion version({epoch, Timestamp(1, 1)}, {1, 0});
+
+    auto chunkMap = ChunkMap{epoch, Timestamp(1, 1)}.createMerged(makeChunks(numChunks, version));
+    ASSERT_EQ(chunkMap.size(), numChunks);
+    ASSERT_EQ(chunkMap.numBlocks_forTest(), 4);
+
+    const int blockSize = ChunkMap::kMaxBlockSize;
+    for (int i : {0, 1, blockSize - 1, blockSize, numChunks}) {
+        auto intersectingChunk = chunkMap.findIntersectingChunk(BSON("a" << i * 10 - 5));
+        ASSERT(intersectingChunk);
+        ASSERT_BSONOBJ_EQ(intersectingChunk->getMax(),
+                          i == numChunks ? getShardKeyPattern().globalMax()
+                                         : BSON("a" << std::max(i, 1) * 10));
+    }
+
+    int count = 0;
+    chunkMap.forEachOverlappingChunk(BSON("a" << 10235), BSON("a" << 10245), true, [&](auto&&) {
+        count++;
+        return true;
+    });
+    ASSERT_EQ(count, 2);
+}
+
+TEST_F(ChunkMapTest, TestMergeSharesUntouchedBlocks) {
+    const OID epoch = OID::gen();
+    const int numChunks = 3 * ChunkMap::kMaxBlockSize;
+    ChunkVersion version({epoch, Timestamp(1, 1)}, {1, 0});
+
+    auto chunkMap = ChunkMap{epoch, Timestamp(1, 1)}.createMerged(makeChunks(numChunks, version));
+    ASSERT_EQ(chunkMap.numBlocks_forTest(), 3);
+
+    // Split a chunk of the second block.
+    const int splitChunk = ChunkMap::kMaxBlockSize + 10;
+    ChunkVersion splitVersion({epoch, Timestamp(1, 1)}, {2, 0});
+    auto newChunkMap = chunkMap.createMerged(
+        {std::make_shared<ChunkInfo>(ChunkType{
+             uuid(),
+             ChunkRange{BSON("a" << splitChunk * 10), BSON("a" << splitChunk * 10 + 5)},
+             splitVersion,
+             kThisShard}),
+         std::make_shared<ChunkInfo>(ChunkType{
+             uuid(),
+             ChunkRange{BSON("a" << splitChunk * 10 + 5), BSON("a" << (splitChunk + 1) * 10)},
+             splitVersion,
+             kThisShard})});
+
+    ASSERT_EQ(newChunkMap.size(), numChunks + 1);
+    ASSERT_EQ(newChunkMap.getVersion(), splitVersion);
+    ASSERT_EQ(chunkMap.size(), numChunks);
+
+    // Only the block which holds the split chunk was copied, and it overflowed into a new block.
+    // The blocks around it are shared.
+    ASSERT_EQ(newChunkMap.numBlocks_forTest(), 4);
+    ASSERT(newChunkMap.sharesBlockWith_forTest(chunkMap, 0));
+    ASSERT(!newChunkMap.sharesBlockWith_forTest(chunkMap, 1));
+    ASSERT(!newChunkMap.sharesBlockWith_forTest(chunkMap, 2));
+    ASSERT(newChunkMap.sharesBlockWith_forTest(chunkMap, 3));
+
+    auto lastMax = getShardKeyPattern().globalMin();
+    newChunkMap.forEach([&](const auto& chunkInfo) {
+        ASSERT_BSONOBJ_EQ(chunkInfo->getMin(), lastMax);
+        lastMax = chunkInfo->getMax();
+        return true;
+    });
+    ASSERT_BSONOBJ_EQ(lastMax, getShardKeyPattern().globalMax());
+
+    auto intersectingChunk = newChunkMap.findIntersectingChunk(BSON("a" << splitChunk * 10 + 7));
+    ASSERT_EQ(intersectingChunk->getLastmod(), splitVersion);
+    ASSERT_BSONOBJ_EQ(intersectingChunk->getMin(), BSON("a" << splitChunk * 10 + 5));
+
+    // The original map is unchanged.
+    intersectingChunk = chunkMap.findIntersectingChunk(BSON("a" << splitChunk * 10 + 7));
+    ASSERT_EQ(intersectingChunk->getLastmod(), version);
+}
+
+TEST_F(ChunkMapTest, TestBoundsKeepTheirTypes) {
+    const OID epoch = OID::gen();
+    ChunkVersion version({epoch, Timestamp(1, 1)}, {1, 0});
+
+    const std::vector<BSONObj> bounds{getShardKeyPattern().globalMin(),
+                                      BSON("a" << 10LL),
+                                      BSON("a" << 20.5),
+                                      BSON("a" << 30),
+                                      BSON("a"
+                                           << "x"),
+                                      getShardKeyPattern().globalMax()};
+    std::vector<std::shared_ptr<ChunkInfo>> chunks;
+    for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+        chunks.push_back(std::make_shared<ChunkInfo>(
+            ChunkType{uuid(), ChunkRange{bounds[i], bounds[i + 1]}, version, kThisShard}));
+    }
+
+    auto chunkMap = ChunkMap{epoch, Timestamp(1, 1)}.createMerged(chunks);
+    ASSERT_EQ(chunkMap.size(), bounds.size() - 1);
+
+    size_t i = 0;
+    chunkMap.forEach([&](const auto& chunkInfo) {
+        ASSERT(chunkInfo->getMin().binaryEqual(bounds[i])) << chunkInfo->getMin();
+        ASSERT(chunkInfo->getMax().binaryEqual(bounds[i + 1])) << chunkInfo->getMax();
+        ASSERT_EQ(chunkInfo->getLastmod(), version);
+        ASSERT_EQ(chunkInfo->getShardId(), kThisShard);
+        i++;
+        return true;
+    });
+    ASSERT_EQ(i, bounds.size() - 1);
+}
+
+TEST_F(ChunkMapTest, TestChunkWhichDoesNotStartAtThePreviousMax) {
+    const OID epoch = OID::gen();
+    ChunkVersion version({epoch, Timestamp(1, 1)}, {1, 0});
+
+    auto chunkMap = ChunkMap{epoch, Timestamp(1, 1)}.createMerged(
+        {std::make_shared<ChunkInfo>(
+             ChunkType{uuid(), ChunkRange{BSON("a" << 0), BSON("a" << 10)}, version, kThisShard}),
+         std::make_shared<ChunkInfo>(ChunkType{
+             uuid(), ChunkRange{BSON("a" << 20), BSON("a" << 30)}, version, kThisShard})});
+    ASSERT_EQ(chunkMap.size(), 2);
+
+    auto intersectingChunk = chunkMap.findIntersectingChunk(BSON("a" << 25));
+    ASSERT_BSONOBJ_EQ(intersectingChunk->getMin(), BSON("a" << 20));
+    ASSERT_BSONOBJ_EQ(intersectingChunk->getMax(), BSON("a" << 30));
+
+    ASSERT(!chunkMap.findIntersectingShardId(BSON("a" << 15), boost::none));
+    ASSERT_EQ(*chunkMap.findIntersectingShardId(BSON("a" << 20), boost::none), kThisShard);
+}
+
+TEST_F(ChunkMapTest, TestChunkRefsMatchTheirChunkInfo) {
+    const OID epoch = OID::gen();
+    const int numChunks = ChunkMap::kMaxBlockSize + 10;
+    ChunkVersion version({epoch, Timestamp(1, 1)}, {1, 0});
+
+    auto chunkMap = ChunkMap{epoch, Timestamp(1, 1)}.createMerged(makeChunks(numChunks, version));
+
+    std::vector<ChunkRange> ranges;
+    chunkMap.forEachOverlappingChunkRef(
+        BSON("a" << (ChunkMap::kMaxBlockSize - 1) * 10 + 5),
+        BSON("a" << (ChunkMap::kMaxBlockSize + 1) * 10),
+        false,
+        [&](const auto& chunk) {
+            ASSERT_EQ(chunk.getShardIdAt(boost::none), kThisShard);
+            const auto chunkInfo = chunk.makeChunkInfo();
+            ASSERT_BSONOBJ_EQ(chunk.getRange().getMin(), chunkInfo->getMin());
+            ASSERT_BSONOBJ_EQ(chunk.getRange().getMax(), chunkInfo->getMax());
+            ranges.push_back(chunk.getRange());
+            return true;
+        });
+    ASSERT_EQ(ranges.size(), 2);
+    ASSERT_BSONOBJ_EQ(ranges[0].getMin(), BSON("a" << (ChunkMap::kMaxBlockSize - 1) * 10));
+    ASSERT_BSONOBJ_EQ(ranges[1].getMax(), BSON("a" << (ChunkMap::kMaxBlockSize + 1) * 10));
+
+    int count = 0;
+    chunkMap.forEachRef(
+        [&](const auto& chunk) {
+            ++count;
+            return true;
+        },
+        BSON("a" << 15));
+    ASSERT_EQ(count, numChunks - 1);
+
+    auto chunk = chunkMap.findChunkContaining(BSON("a" << 15));
+    ASSERT(chunk);
+    ASSERT_BSONOBJ_EQ(chunk->getRange().getMin(), BSON("a" << 10));
+}
+
+TEST_F(ChunkMapTest, TestFindIntersectingShardIdAtClusterTime) {
+    const OID epoch = OID::gen();
+    const ShardId otherShard("otherShard");
+    ChunkVersion version({epoch, Timestamp(1, 1)}, {2, 0});
+
+    ChunkType movedChunk{uuid(),
+                         ChunkRange{getShardKeyPattern().globalMin(), BSON("a" << 0)},
+                         version,
+                         otherShard};
+    movedChunk.setHistory({ChunkHistory(Timestamp(20, 0), otherShard),
+                           ChunkHistory(Timestamp(10, 0), kThisShard)});
+    ChunkType otherChunk{uuid(),
+                         ChunkRange{BSON("a" << 0), getShardKeyPattern().globalMax()},
+                         version,
+                         kThisShard};
+    otherChunk.setHistory({ChunkHistory(Timestamp(10, 0), kThisShard)});
+
+    auto chunkMap = ChunkMap{epoch, Timestamp(1, 1)}.createMerged(
+        {std::make_shared<ChunkInfo>(movedChunk), std::make_shared<ChunkInfo>(otherChunk)});
+
+    const auto key = BSON("a" << -5);
+    ASSERT_EQ(*chunkMap.findIntersectingShardId(key, boost::none), otherShard);
+    ASSERT_EQ(*chunkMap.findIntersectingShardId(key, Timestamp(25, 0)), otherShard);
+    ASSERT_EQ(*chunkMap.findIntersectingShardId(key, Timestamp(15, 0)), kThisShard);
+    ASSERT_THROWS_CODE(chunkMap.findIntersectingShardId(key, Timestamp(5, 0)),
+                       DBException,
+                       ErrorCodes::StaleChunkHistory);
+
+    auto chunkInfo = chunkMap.findIntersectingChunk(key);
+    ASSERT_EQ(chunkInfo->getHistory().size(), 2);
+    ASSERT_EQ(chunkInfo->getShardIdAt(Timestamp(15, 0)), kThisShard);
+}
+
+TEST_F(ChunkMapTest, TestJumboFlagAndWritesTrackerOutliveChunkInfo) {
+    const OID epoch = OID::gen();
+    const int numChunks = 2 * ChunkMap::kMaxBlockSize;
+    ChunkVersion version({epoch, Timestamp(1, 1)}, {1, 0});
+
+    auto chunkMap = ChunkMap{epoch, Timestamp(1, 1)}.createMerged(makeChunks(numChunks, version));
+
+    const auto key = BSON("a" << 15);
+    {
+        auto chunkInfo = chunkMap.findIntersectingChunk(key);
+        ASSERT(!chunkInfo->isJumbo());
+        chunkInfo->markAsJumbo();
+        chunkInfo->getWritesTracker()->addBytesWritten(100);
+    }
+
+    auto chunkInfo = chunkMap.findIntersectingChunk(key);
+    ASSERT(chunkInfo->isJumbo());
+    ASSERT_EQ(chunkInfo->getWritesTracker()->getBytesWritten(), 100);
+
+    // Splitting another chunk of the same block copies the block, and the chunk keeps its state.
+    ChunkVersion splitVersion({epoch, Timestamp(1, 1)}, {2, 0});
+    auto newChunkMap = chunkMap.createMerged(
+        {std::make_shared<ChunkInfo>(ChunkType{
+             uuid(), ChunkRange{BSON("a" << 100), BSON("a" << 105)}, splitVersion, kThisShard}),
+         std::make_shared<ChunkInfo>(ChunkType{
+             uuid(), ChunkRange{BSON("a" << 105), BSON("a" << 110)}, splitVersion, kThisShard})});
+    ASSERT(!newChunkMap.sharesBlockWith_forTest(chunkMap, 0));
+
+    chunkInfo = newChunkMap.findIntersectingChunk(key);
+    ASSERT(chunkInfo->isJumbo());
+    ASSERT_EQ(chunkInfo->getWritesTracker()->getBytesWritten(), 100);
+    ASSERT(!newChunkMap.findIntersectingChunk(BSON("a" << 25))->isJumbo());
+}
+
 }  // namespace mongo
@@ -50,7 +50,7 @@ TEST(ChunkTest, HasMovedSincePinnedTimestamp) {
     chunkType.setHistory(
         {ChunkHistory(Timestamp(101, 0), kShardOne), ChunkHistory(Timestamp(100, 0), kShardTwo)});
 
-    ChunkInfo chunkInfo(chunkType);
+    auto chunkInfo = std::make_shared<ChunkInfo>(chunkType);
     Chunk chunk(chunkInfo, Timestamp(100, 0));
     ASSERT_THROWS_CODE(chunk.throwIfMoved(), AssertionException, ErrorCodes::MigrationConflict);
 }
@@ -68,7 +68,7 @@ TEST(ChunkTest, HasMovedAndReturnedSincePinnedTimestamp) {
                           ChunkHistory(Timestamp(101, 0), kShardTwo),
                           ChunkHistory(Timestamp(100, 0), kShardOne)});
 
-    ChunkInfo chunkInfo(chunkType);
+    auto chunkInfo = std::make_shared<ChunkInfo>(chunkType);
     Chunk chunk(chunkInfo, Timestamp(100, 0));
     ASSERT_THROWS_CODE(chunk.throwIfMoved(), AssertionException, ErrorCodes::MigrationConflict);
 }
@@ -85,7 +85,7 @@ TEST(ChunkTest, HasNotMovedSincePinnedTimestamp) {
     chunkType.setHistory(
         {ChunkHistory(Timestamp(100, 0), kShardOne), ChunkHistory(Timestamp(99, 0), kShardTwo)});
 
-    ChunkInfo chunkInfo(chunkType);
+    auto chunkInfo = std::make_shared<ChunkInfo>(chunkType);
     Chunk chunk(chunkInfo, Timestamp(100, 0));
     // Should not throw.
     chunk.throwIfMoved();
@@ -102,7 +102,7 @@ TEST(ChunkTest, HasNoHistoryValidForPinnedTimestamp_OneEntry) {
                         kShardOne);
     chunkType.setHistory({ChunkHistory(Timestamp(101, 0), kShardOne)});
 
-    ChunkInfo chunkInfo(chunkType);
+    auto chunkInfo = std::make_shared<ChunkInfo>(chunkType);
     Chunk chunk(chunkInfo, Timestamp(100, 0));
     ASSERT_THROWS_CODE(chunk.throwIfMoved(), AssertionException, ErrorCodes::StaleChunkHistory);
 }
@@ -119,7 +119,7 @@ TEST(ChunkTest, HasNoHistoryValidForPinnedTimestamp_MoreThanOneEntry) {
     chunkType.setHistory(
         {ChunkHistory(Timestamp(102, 0), kShardOne), ChunkHistory(Timestamp(101, 0), kShardTwo)});
 
-    ChunkInfo chunkInfo(chunkType);
+    auto chunkInfo = std::make_shared<ChunkInfo>(chunkType);
     Chunk chunk(chunkInfo, Timestamp(100, 0));
     ASSERT_THROWS_CODE(chunk.throwIfMoved(), AssertionException, ErrorCodes::StaleChunkHistory);
 }
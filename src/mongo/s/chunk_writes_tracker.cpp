@@ -30,6 +30,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
 #include <cstdint>
 
 #include "mongo/s/chunk_writes_tracker.h"
@@ -44,6 +45,32 @@ uint64_t ChunkWritesTracker::clearBytesWritten() {
     return _bytesWritten.swap(0);
 }
 
+bool ChunkWritesTracker::shouldSampleOp(int samplingInterval) {
+    if (samplingInterval <= 0) {
+        return false;
+    }
+
+    // Each thread counts down independently so that the sampling decision does not contend on a
+    // shared counter in the read and write paths.
+    thread_local int opsUntilNextSample = 0;
+    if (opsUntilNextSample <= 0 || opsUntilNextSample > samplingInterval) {
+        opsUntilNextSample = samplingInterval;
+    }
+    return --opsUntilNextSample == 0;
+}
+
+void ChunkWritesTracker::addSampledOp(OpType opType, int samplingInterval) {
+    auto& counter = opType == OpType::kRead ? _sampledReads : _sampledWrites;
+    counter.fetchAndAdd(static_cast<unsigned long long>(std::max(samplingInterval, 1)));
+}
+
+ChunkWritesTracker::SampledOps ChunkWritesTracker::clearSampledOps() {
+    SampledOps sampledOps;
+    sampledOps.reads = _sampledReads.swap(0);
+    sampledOps.writes = _sampledWrites.swap(0);
+    return sampledOps;
+}
+
 bool ChunkWritesTracker::shouldSplit(uint64_t maxChunkSize) {
     if (_isLockedForSplitting) {
         return false;
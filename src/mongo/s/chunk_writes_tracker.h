@@ -36,6 +36,17 @@ namespace mongo {
 
 class ChunkWritesTracker {
 public:
+    enum class OpType { kRead, kWrite };
+
+    /**
+     * Estimated number of reads and writes which targeted the chunk, extrapolated from the sampled
+     * operations.
+     */
+    struct SampledOps {
+        uint64_t reads{0};
+        uint64_t writes{0};
+    };
+
     /**
      * A factor that determines when a chunk should be split. We should split once data *
      * kSplitTestFactor > chunkSize (approximately).
@@ -62,6 +73,24 @@ public:
      */
     uint64_t clearBytesWritten();
 
+    /**
+     * Returns true once every 'samplingInterval' calls made by the calling thread, in which case
+     * the caller is expected to record the operation through addSampledOp. Always returns false if
+     * 'samplingInterval' is not positive.
+     */
+    static bool shouldSampleOp(int samplingInterval);
+
+    /**
+     * Records a sampled operation against the chunk, which stands for 'samplingInterval'
+     * operations.
+     */
+    void addSampledOp(OpType opType, int samplingInterval);
+
+    /**
+     * Resets the sampled operation counters to zero and returns their values prior to clearing.
+     */
+    SampledOps clearSampledOps();
+
     /**
      * Returns whether or not this chunk is ready to be split based on the
      * maximum allowable size of a chunk.
@@ -86,6 +115,12 @@ private:
      */
     AtomicWord<unsigned long long> _bytesWritten{0};
 
+    /**
+     * The estimated number of reads and writes to this chunk since the counters were last cleared.
+     */
+    AtomicWord<unsigned long long> _sampledReads{0};
+    AtomicWord<unsigned long long> _sampledWrites{0};
+
     /**
      * Protects _splitState when starting a split.
      */
@@ -144,6 +144,45 @@ TEST(ChunkWritesTrackerTest, AcquireSplitLockThenReleaseThenReacquireReturnsTrue
     ASSERT_TRUE(wt.acquireSplitLock());
 }
 
+TEST(ChunkWritesTrackerTest, ShouldSampleOpReturnsFalseWhenSamplingIsDisabled) {
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_FALSE(ChunkWritesTracker::shouldSampleOp(0));
+    }
+}
+
+TEST(ChunkWritesTrackerTest, ShouldSampleOpSamplesOnceEveryInterval) {
+    const int samplingInterval = 4;
+    int numSampled = 0;
+    for (int i = 0; i < 10 * samplingInterval; ++i) {
+        if (ChunkWritesTracker::shouldSampleOp(samplingInterval)) {
+            ++numSampled;
+        }
+    }
+    ASSERT_EQ(numSampled, 10);
+}
+
+TEST(ChunkWritesTrackerTest, AddSampledOpIsWeightedBySamplingInterval) {
+    ChunkWritesTracker wt;
+    wt.addSampledOp(ChunkWritesTracker::OpType::kRead, 10);
+    wt.addSampledOp(ChunkWritesTracker::OpType::kRead, 10);
+    wt.addSampledOp(ChunkWritesTracker::OpType::kWrite, 5);
+
+    auto sampledOps = wt.clearSampledOps();
+    ASSERT_EQ(sampledOps.reads, 20ull);
+    ASSERT_EQ(sampledOps.writes, 5ull);
+}
+
+TEST(ChunkWritesTrackerTest, ClearSampledOpsSetsCountersToZero) {
+    ChunkWritesTracker wt;
+    wt.addSampledOp(ChunkWritesTracker::OpType::kRead, 1);
+    wt.addSampledOp(ChunkWritesTracker::OpType::kWrite, 1);
+    wt.clearSampledOps();
+
+    auto sampledOps = wt.clearSampledOps();
+    ASSERT_EQ(sampledOps.reads, 0ull);
+    ASSERT_EQ(sampledOps.writes, 0ull);
+}
+
 DEATH_TEST(ChunkWritesTrackerTest, ReleaseSplitLockWithoutAcquiringErrors, "Invariant failure") {
     ChunkWritesTracker wt;
     wt.releaseSplitLock();
@@ -61,6 +61,8 @@ public:
 
     AsyncRequestsSender::Response next();
 
+    void addRequest(const AsyncRequestsSender::Request& request);
+
     void stopRetrying();
 
 private:
@@ -43,6 +43,7 @@
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
 #include "mongo/s/catalog/type_shard.h"
+#include "mongo/s/query/async_results_merger_params_gen.h"
 #include "mongo/util/assert_util.h"
 
 #define MONGO_LOGV2_DEFAULT_COMPONENT ::mongo::logv2::LogComponent::kQuery
@@ -109,13 +110,22 @@ AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
       // support a default value for an enum. The default tailable mode should be 'kNormal', but
       // since that is not supported we treat boost::none (unspecified) to mean 'kNormal'.
       _tailableMode(_params.getTailableMode().value_or(TailableModeEnum::kNormal)),
-      _mergeQueue(MergingComparator(
-          _remotes, _params.getSort().value_or(BSONObj()), _params.getCompareWholeSortKey())),
+      _mergeTree(_params.getRemotes().size(),
+                 MergingComparator(_remotes,
+                                   _params.getSort().value_or(BSONObj()),
+                                   _params.getCompareWholeSortKey())),
       _promisedMinSortKeys(PromisedMinSortKeyComparator(_params.getSort().value_or(BSONObj()))) {
     if (_params.getTxnNumber()) {
         invariant(_params.getSessionId());
     }
 
+    // Ordering::make() only supports as many fields as a compound index key. Merge on longer sort
+    // patterns by comparing the BSON sort keys instead.
+    if (const auto& sort = _params.getSort();
+        sort && static_cast<size_t>(sort->nFields()) <= Ordering::kMaxCompoundIndexKeys) {
+        _sortKeyOrdering = Ordering::make(*sort);
+    }
+
     size_t remoteIndex = 0;
     for (const auto& remote : _params.getRemotes()) {
         _remotes.emplace_back(remote.getHostAndPort(),
@@ -225,6 +235,7 @@ void AsyncResultsMerger::addNewShardCursors(std::vector<RemoteCursor>&& newCurso
     stdx::lock_guard<Latch> lk(_mutex);
     // Create a new entry in the '_remotes' list for each new shard, and add the first cursor batch
     // to its buffer. This ensures the shard's initial high water mark is respected, if it exists.
+    _mergeTree.addStreams(newCursors.size());
     for (auto&& remote : newCursors) {
         const auto newIndex = _remotes.size();
         _remotes.emplace_back(remote.getHostAndPort(),
@@ -319,12 +330,12 @@ bool AsyncResultsMerger::_readySorted(WithLock lk) {
 }
 
 bool AsyncResultsMerger::_readySortedTailable(WithLock lk) {
-    if (_mergeQueue.empty()) {
+    const auto smallestRemote = _mergeTree.top();
+    if (!smallestRemote) {
         return false;
     }
 
-    auto smallestRemote = _mergeQueue.top();
-    auto smallestResult = _remotes[smallestRemote].docBuffer.front();
+    auto smallestResult = _remotes[*smallestRemote].docBuffer.front();
     auto keyWeWantToReturn =
         extractSortKey(*smallestResult.getResult(), _params.getCompareWholeSortKey());
     // We should always have a minPromisedSortKey from every shard in the sorted tailable case.
@@ -367,16 +378,16 @@ StatusWith<ClusterQueryResult> AsyncResultsMerger::nextReady() {
     return _params.getSort() ? _nextReadySorted(lk) : _nextReadyUnsorted(lk);
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
+ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock lk) {
     // Tailable non-awaitData cursors cannot have a sort.
     invariant(_tailableMode != TailableModeEnum::kTailable);
 
-    if (_mergeQueue.empty()) {
+    const auto top = _mergeTree.top();
+    if (!top) {
         return {};
     }
 
-    size_t smallestRemote = _mergeQueue.top();
-    _mergeQueue.pop();
+    const size_t smallestRemote = *top;
 
     invariant(!_remotes[smallestRemote].docBuffer.empty());
     invariant(_remotes[smallestRemote].status.isOK());
@@ -384,11 +395,10 @@ ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
     ClusterQueryResult front = _remotes[smallestRemote].docBuffer.front();
     _remotes[smallestRemote].docBuffer.pop();
 
-    // Re-populate the merging queue with the next result from 'smallestRemote', if it has a
-    // next result.
-    if (!_remotes[smallestRemote].docBuffer.empty()) {
-        _mergeQueue.push(smallestRemote);
-    }
+    // Replay the matches of 'smallestRemote' against its next result, or take it out of the tree
+    // if it has no next result.
+    _updateMergeTree(lk, smallestRemote);
+    _prefetchIfBelowLowWaterMark(lk, smallestRemote);
 
     // For sorted tailable awaitData cursors, update the high water mark to the document's sort key.
     if (_tailableMode == TailableModeEnum::kTailableAndAwaitData) {
@@ -401,7 +411,7 @@ ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
     return front;
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
+ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock lk) {
     size_t remotesAttempted = 0;
     while (remotesAttempted < _remotes.size()) {
         // It is illegal to call this method if there is an error received from any shard.
@@ -419,6 +429,7 @@ ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
                 _eofNext = true;
             }
 
+            _prefetchIfBelowLowWaterMark(lk, _gettingFromRemote);
             return front;
         }
 
@@ -432,6 +443,40 @@ ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
     return {};
 }
 
+void AsyncResultsMerger::_updateMergeTree(WithLock, size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+    remote.frontSortKey = boost::none;
+    if (remote.hasNext() && _sortKeyOrdering) {
+        remote.frontSortKey =
+            KeyString::Builder(KeyString::Version::kLatestVersion,
+                               extractSortKey(*remote.docBuffer.front().getResult(),
+                                              _params.getCompareWholeSortKey()),
+                               *_sortKeyOrdering)
+                .getValueCopy();
+    }
+    _mergeTree.update(remoteIndex, remote.hasNext());
+}
+
+void AsyncResultsMerger::_prefetchIfBelowLowWaterMark(WithLock lk, size_t remoteIndex) {
+    // Tailable cursors ask for more results only once the client asks for the next batch, so that
+    // they do not hold up the shards with awaitData getMores nobody is waiting for.
+    const auto lowWaterMark = gInternalQueryAsyncResultsMergerPrefetchLowWaterMark.load();
+    if (lowWaterMark <= 0 || _tailableMode != TailableModeEnum::kNormal || !_opCtx ||
+        _lifecycleState != kAlive) {
+        return;
+    }
+
+    auto& remote = _remotes[remoteIndex];
+    if (!remote.status.isOK() || remote.exhausted() || remote.cbHandle.isValid() ||
+        remote.docBuffer.size() > static_cast<size_t>(lowWaterMark)) {
+        return;
+    }
+
+    // As in _scheduleGetMores(), a failure to schedule the getMore is reported by the next call to
+    // ready() or nextReady().
+    remote.status = _askForNextBatch(lk, remoteIndex);
+}
+
 Status AsyncResultsMerger::_askForNextBatch(WithLock, size_t remoteIndex) {
     invariant(_opCtx, "Cannot schedule a getMore without an OperationContext");
     auto& remote = _remotes[remoteIndex];
@@ -753,6 +798,9 @@ void AsyncResultsMerger::_cleanUpFailedBatch(WithLock lk, Status status, size_t
         std::swap(remote.docBuffer, emptyBuffer);
         remote.status = Status::OK();
         remote.cursorId = 0;
+        if (_params.getSort()) {
+            _updateMergeTree(lk, remoteIndex);
+        }
     }
 }
 
@@ -805,6 +853,7 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
                                            size_t remoteIndex,
                                            const CursorResponse& response) {
     auto& remote = _remotes[remoteIndex];
+    const bool wasEmpty = !remote.hasNext();
     _updateRemoteMetadata(lk, remoteIndex, response);
     for (const auto& obj : response.getBatch()) {
         // If there's a sort, we're expecting the remote node to have given us back a sort key.
@@ -830,10 +879,10 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
         ++remote.fetchedCount;
     }
 
-    // If we're doing a sorted merge, then we have to make sure to put this remote onto the merge
-    // queue.
-    if (_params.getSort() && !response.getBatch().empty()) {
-        _mergeQueue.push(remoteIndex);
+    // If we're doing a sorted merge, then we have to make sure to enter this remote into the merge
+    // tree. A prefetched batch is appended behind buffered results, which leaves the front as is.
+    if (_params.getSort() && wasEmpty && !response.getBatch().empty()) {
+        _updateMergeTree(lk, remoteIndex);
     }
     return true;
 }
@@ -944,13 +993,18 @@ bool AsyncResultsMerger::RemoteCursorData::exhausted() const {
 // AsyncResultsMerger::MergingComparator
 //
 
-bool AsyncResultsMerger::MergingComparator::operator()(const size_t& lhs, const size_t& rhs) {
-    const ClusterQueryResult& leftDoc = _remotes[lhs].docBuffer.front();
-    const ClusterQueryResult& rightDoc = _remotes[rhs].docBuffer.front();
+bool AsyncResultsMerger::MergingComparator::operator()(size_t lhs, size_t rhs) const {
+    const auto& left = _remotes[lhs];
+    const auto& right = _remotes[rhs];
+    if (left.frontSortKey && right.frontSortKey) {
+        return left.frontSortKey->compare(*right.frontSortKey) < 0;
+    }
 
+    const ClusterQueryResult& leftDoc = left.docBuffer.front();
+    const ClusterQueryResult& rightDoc = right.docBuffer.front();
     return compareSortKeys(extractSortKey(*leftDoc.getResult(), _compareWholeSortKey),
                            extractSortKey(*rightDoc.getResult(), _compareWholeSortKey),
-                           _sort) > 0;
+                           _sort) < 0;
 }
 
 bool AsyncResultsMerger::PromisedMinSortKeyComparator::operator()(
@@ -35,11 +35,14 @@
 
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/ordering.h"
 #include "mongo/db/cursor_id.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/platform/mutex.h"
 #include "mongo/s/query/async_results_merger_params_gen.h"
 #include "mongo/s/query/cluster_query_result.h"
+#include "mongo/s/query/tournament_tree.h"
 #include "mongo/stdx/future.h"
 #include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/net/hostandport.h"
@@ -89,8 +92,8 @@ public:
      * the hosts on which they exist in _remotes.
      *
      * Additionally copies each remote's first batch of results, if one exists, into that remote's
-     * docBuffer. If a sort is specified in the ClusterClientCursorParams, places the remotes with
-     * buffered results onto _mergeQueue.
+     * docBuffer. If a sort is specified in the ClusterClientCursorParams, enters the remotes with
+     * buffered results into _mergeTree.
      *
      * The TaskExecutor* must remain valid for the lifetime of the ARM.
      *
@@ -307,6 +310,11 @@ private:
         // The buffer of results that have been retrieved but not yet returned to the caller.
         std::queue<ClusterQueryResult> docBuffer;
 
+        // The sort key of the front of 'docBuffer', encoded as a KeyString so that the sorted merge
+        // can compare it with a memcmp. Only set if there is a sort, the buffer is not empty, and
+        // the sort pattern has few enough fields to build an Ordering for it.
+        boost::optional<KeyString::Value> frontSortKey;
+
         // Is valid if there is currently a pending request to this remote.
         executor::TaskExecutor::CallbackHandle cbHandle;
 
@@ -322,6 +330,10 @@ private:
         bool invalidated = false;
     };
 
+    /**
+     * Returns true if the next result of the remote 'lhs' sorts before the next result of the
+     * remote 'rhs'. Both remotes must have a buffered result.
+     */
     class MergingComparator {
     public:
         MergingComparator(const std::vector<RemoteCursorData>& remotes,
@@ -329,7 +341,7 @@ private:
                           bool compareWholeSortKey)
             : _remotes(remotes), _sort(sort), _compareWholeSortKey(compareWholeSortKey) {}
 
-        bool operator()(const size_t& lhs, const size_t& rhs);
+        bool operator()(size_t lhs, size_t rhs) const;
 
     private:
         const std::vector<RemoteCursorData>& _remotes;
@@ -395,6 +407,18 @@ private:
     ClusterQueryResult _nextReadySorted(WithLock);
     ClusterQueryResult _nextReadyUnsorted(WithLock);
 
+    /**
+     * Replays the matches of the remote at 'remoteIndex' in '_mergeTree' after the front of its
+     * buffer has changed, first encoding the sort key of the new front if applicable.
+     */
+    void _updateMergeTree(WithLock, size_t remoteIndex);
+
+    /**
+     * Schedules a getMore against the remote at 'remoteIndex' ahead of its buffer running dry, if
+     * prefetching is enabled and the number of buffered results has dropped to the low-water mark.
+     */
+    void _prefetchIfBelowLowWaterMark(WithLock, size_t remoteIndex);
+
     using CbData = executor::TaskExecutor::RemoteCommandCallbackArgs;
     using CbResponse = executor::TaskExecutor::ResponseStatus;
 
@@ -494,9 +518,13 @@ private:
     // Data tracking the state of our communication with each of the remote nodes.
     std::vector<RemoteCursorData> _remotes;
 
-    // The top of this priority queue is the index into '_remotes' for the remote host that has the
-    // next document to return, according to the sort order. Used only if there is a sort.
-    std::priority_queue<size_t, std::vector<size_t>, MergingComparator> _mergeQueue;
+    // The top of this tree is the index into '_remotes' for the remote host that has the next
+    // document to return, according to the sort order. Used only if there is a sort.
+    TournamentTree<MergingComparator> _mergeTree;
+
+    // The ordering used to encode the 'frontSortKey' of each remote. Not set if there is no sort,
+    // or if the sort pattern has too many fields, in which case the merge compares BSON sort keys.
+    boost::optional<Ordering> _sortKeyOrdering;
 
     // The index into '_remotes' for the remote from which we are currently retrieving results.
     // Used only if there is *not* a sort.
@@ -39,6 +39,7 @@
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_command_gen.h"
 #include "mongo/executor/task_executor.h"
+#include "mongo/idl/server_parameter_test_util.h"
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/query/results_merger_test_fixture.h"
@@ -444,6 +445,63 @@ TEST_F(AsyncResultsMergerTest, CompoundSortKey) {
     ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
 }
 
+TEST_F(AsyncResultsMergerTest, PrefetchesWhenBufferDropsToLowWaterMark) {
+    RAIIServerParameterControllerForTest lowWaterMark{
+        "internalQueryAsyncResultsMergerPrefetchLowWaterMark", 1};
+
+    BSONObj findCmd = fromjson("{find: 'testcoll', sort: {_id: 1}}");
+    std::vector<RemoteCursor> cursors;
+    std::vector<BSONObj> batch1 = {fromjson("{$sortKey: [1]}"), fromjson("{$sortKey: [3]}")};
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 5, batch1)));
+    std::vector<BSONObj> batch2 = {fromjson("{$sortKey: [2]}"), fromjson("{$sortKey: [4]}")};
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[1], kTestShardHosts[1], CursorResponse(kTestNss, 6, batch2)));
+    auto arm = makeARMFromExistingCursors(std::move(cursors), findCmd);
+
+    // Both remotes have buffered results, so no getMore is needed to return the first one.
+    ASSERT_TRUE(arm->ready());
+    ASSERT_FALSE(networkHasReadyRequests());
+
+    // Returning the first result leaves a single result buffered for the first shard, which is
+    // the low-water mark, so the ARM asks that shard for more before its buffer runs dry.
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: [1]}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    auto cmd = GetMoreCommandRequest::parse(IDLParserContext{"getMore"},
+                                            getNthPendingRequest(0).cmdObj.addField(
+                                                BSON("$db"
+                                                     << "anydbname")
+                                                    .firstElement()));
+    ASSERT_EQ(cmd.getCommandParameter(), 5LL);
+
+    // The ARM can keep returning results while the getMore is in flight.
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: [2]}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+
+    // Returning the second result did the same for the second shard, and both shards respond to
+    // their prefetch getMores. The new results are appended behind the ones
+    // which were already buffered.
+    std::vector<CursorResponse> responses;
+    std::vector<BSONObj> batch3 = {fromjson("{$sortKey: [5]}")};
+    responses.emplace_back(kTestNss, CursorId(0), batch3);
+    std::vector<BSONObj> batch4 = {fromjson("{$sortKey: [6]}")};
+    responses.emplace_back(kTestNss, CursorId(0), batch4);
+    scheduleNetworkResponses(std::move(responses));
+
+    ASSERT_TRUE(arm->remotesExhausted());
+    for (auto&& expected :
+         {"{$sortKey: [3]}", "{$sortKey: [4]}", "{$sortKey: [5]}", "{$sortKey: [6]}"}) {
+        ASSERT_TRUE(arm->ready());
+        ASSERT_BSONOBJ_EQ(fromjson(expected), *unittest::assertGet(arm->nextReady()).getResult());
+    }
+
+    // Exhausted remotes are not asked for more.
+    ASSERT_FALSE(networkHasReadyRequests());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+}
+
 TEST_F(AsyncResultsMergerTest, SortedButNoSortKey) {
     BSONObj findCmd = fromjson("{find: 'testcoll', sort: {a: -1, b: 1}}");
     std::vector<RemoteCursor> cursors;
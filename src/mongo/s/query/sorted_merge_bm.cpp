@@ -0,0 +1,146 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include <benchmark/benchmark.h>
+#include <queue>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/ordering.h"
+#include "mongo/db/storage/key_string.h"
+#include "mongo/platform/random.h"
+#include "mongo/s/query/tournament_tree.h"
+
+namespace mongo {
+namespace {
+
+// Mirrors the sort of a query on {a: 1, b: -1}, for which each shard attaches a $sortKey holding
+// one value per field of the sort pattern.
+const BSONObj kSortPattern = BSON("a" << 1 << "b" << -1);
+constexpr int kDocsPerRemote = 1000;
+
+/**
+ * The results buffered by a mocked remote, in sort order, and the position of the next one.
+ */
+struct MockRemote {
+    std::vector<BSONObj> sortKeys;
+    size_t next = 0;
+
+    bool hasNext() const {
+        return next < sortKeys.size();
+    }
+};
+
+std::vector<MockRemote> makeRemotes(size_t numRemotes) {
+    PseudoRandom random(static_cast<int64_t>(numRemotes));
+    std::vector<MockRemote> remotes(numRemotes);
+    for (auto&& remote : remotes) {
+        // Interleave the remotes by giving each an ascending sequence of 'a' with random gaps, and
+        // a descending sequence of 'b' for the ties.
+        long long a = 0;
+        for (int i = 0; i < kDocsPerRemote; ++i) {
+            a += random.nextInt32(4);
+            remote.sortKeys.push_back(
+                BSON("" << a << "" << ("key-" + std::to_string(kDocsPerRemote - i))));
+        }
+    }
+    return remotes;
+}
+
+/**
+ * Merges the remotes by keeping their indexes in a priority queue which compares the BSON sort
+ * keys of the next results, as the AsyncResultsMerger used to do.
+ */
+void BM_PriorityQueueMerge(benchmark::State& state) {
+    auto remotes = makeRemotes(state.range(0));
+    auto greater = [&](size_t lhs, size_t rhs) {
+        return remotes[lhs].sortKeys[remotes[lhs].next].woCompare(
+                   remotes[rhs].sortKeys[remotes[rhs].next], kSortPattern, 0) > 0;
+    };
+
+    for (auto _ : state) {
+        std::priority_queue<size_t, std::vector<size_t>, decltype(greater)> mergeQueue(greater);
+        for (size_t i = 0; i < remotes.size(); ++i) {
+            remotes[i].next = 0;
+            mergeQueue.push(i);
+        }
+        while (!mergeQueue.empty()) {
+            const auto smallest = mergeQueue.top();
+            mergeQueue.pop();
+            benchmark::DoNotOptimize(remotes[smallest].sortKeys[remotes[smallest].next++]);
+            if (remotes[smallest].hasNext()) {
+                mergeQueue.push(smallest);
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * remotes.size() * kDocsPerRemote);
+}
+
+/**
+ * Merges the remotes with a tournament tree which compares KeyString encodings of the sort keys
+ * of the next results, encoding each sort key once as it reaches the front of its remote.
+ */
+void BM_TournamentTreeMerge(benchmark::State& state) {
+    auto remotes = makeRemotes(state.range(0));
+    const auto ordering = Ordering::make(kSortPattern);
+    std::vector<KeyString::Value> frontSortKeys(remotes.size());
+    auto less = [&](size_t lhs, size_t rhs) {
+        return frontSortKeys[lhs].compare(frontSortKeys[rhs]) < 0;
+    };
+    const auto advance = [&](TournamentTree<decltype(less)>& mergeTree, size_t remote) {
+        const bool hasNext = remotes[remote].hasNext();
+        if (hasNext) {
+            frontSortKeys[remote] =
+                KeyString::Builder(KeyString::Version::kLatestVersion,
+                                   remotes[remote].sortKeys[remotes[remote].next],
+                                   ordering)
+                    .getValueCopy();
+        }
+        mergeTree.update(remote, hasNext);
+    };
+
+    for (auto _ : state) {
+        TournamentTree<decltype(less)> mergeTree(remotes.size(), less);
+        for (size_t i = 0; i < remotes.size(); ++i) {
+            remotes[i].next = 0;
+            advance(mergeTree, i);
+        }
+        while (auto smallest = mergeTree.top()) {
+            benchmark::DoNotOptimize(remotes[*smallest].sortKeys[remotes[*smallest].next++]);
+            advance(mergeTree, *smallest);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * remotes.size() * kDocsPerRemote);
+}
+
+BENCHMARK(BM_PriorityQueueMerge)->Arg(16)->Arg(256);
+BENCHMARK(BM_TournamentTreeMerge)->Arg(16)->Arg(256);
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,147 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <limits>
+#include <vector>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+/**
+ * A tournament tree over a number of sorted input streams, identified by their index, which keeps
+ * track of the stream whose next element is the smallest. Returning the smallest stream is O(1),
+ * and when the next element of any one stream changes, whether because it was consumed, because
+ * the stream ran dry or because a dry stream was refilled, update() replays the matches on the
+ * path from that stream to the root, which takes one comparison per level.
+ *
+ * Unlike a loser tree, which only supports replacing the element of the current winner, every
+ * internal node holds the winner of its subtree, so any stream can be updated at any time.
+ *
+ * 'Less' is called with the indexes of two streams which both have a next element, and returns
+ * true if the next element of the first is smaller than that of the second. On ties, the stream
+ * with the lower index wins.
+ */
+template <typename Less>
+class TournamentTree {
+public:
+    TournamentTree(size_t numStreams, Less less)
+        : _less(std::move(less)), _hasNext(numStreams, false), _winners(numStreams, kNone) {}
+
+    /**
+     * Returns the stream with the smallest next element, or boost::none if no stream has a next
+     * element.
+     */
+    boost::optional<size_t> top() const {
+        if (_hasNext.empty()) {
+            return boost::none;
+        }
+        const auto winner = _hasNext.size() == 1 ? _leafWinner(0) : _winners[1];
+        return winner == kNone ? boost::none : boost::make_optional(winner);
+    }
+
+    bool empty() const {
+        return !top();
+    }
+
+    /**
+     * Records that the next element of 'stream' has changed. 'hasNext' is false if the stream has
+     * no next element.
+     */
+    void update(size_t stream, bool hasNext) {
+        invariant(stream < _hasNext.size());
+        _hasNext[stream] = hasNext;
+        for (size_t node = (stream + _hasNext.size()) / 2; node > 0; node /= 2) {
+            _winners[node] = _playMatch(node);
+        }
+    }
+
+    /**
+     * Adds 'numStreams' streams, which have no next element, after the existing ones.
+     */
+    void addStreams(size_t numStreams) {
+        const auto newSize = _hasNext.size() + numStreams;
+        _hasNext.resize(newSize, false);
+
+        // The shape of the tree depends on the number of streams, so replay all the matches.
+        _winners.assign(newSize, kNone);
+        for (size_t node = newSize - 1; node > 0; --node) {
+            _winners[node] = _playMatch(node);
+        }
+    }
+
+    size_t numStreams() const {
+        return _hasNext.size();
+    }
+
+private:
+    static constexpr size_t kNone = std::numeric_limits<size_t>::max();
+
+    // The streams are the leaves of an implicit binary tree in which node 'n' has the children
+    // '2n' and '2n + 1', and the leaf of stream 's' is node 's + numStreams'. Each of the nodes
+    // 1 to numStreams - 1 has two children.
+    size_t _winnerOf(size_t node) const {
+        return node >= _hasNext.size() ? _leafWinner(node - _hasNext.size()) : _winners[node];
+    }
+
+    size_t _leafWinner(size_t stream) const {
+        return _hasNext[stream] ? stream : kNone;
+    }
+
+    size_t _playMatch(size_t node) const {
+        const auto left = _winnerOf(2 * node);
+        const auto right = _winnerOf(2 * node + 1);
+        if (left == kNone) {
+            return right;
+        }
+        if (right == kNone) {
+            return left;
+        }
+        // The leaves are not in stream order when the number of streams is not a power of two, so
+        // break ties explicitly.
+        if (_less(right, left) || (!_less(left, right) && right < left)) {
+            return right;
+        }
+        return left;
+    }
+
+    Less _less;
+
+    // Whether each stream has a next element.
+    std::vector<bool> _hasNext;
+
+    // The winner of the subtree rooted at each internal node, or kNone if none of the streams in
+    // the subtree has a next element. The element at index 0 is unused.
+    std::vector<size_t> _winners;
+};
+
+}  // namespace mongo
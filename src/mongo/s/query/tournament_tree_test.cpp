@@ -0,0 +1,192 @@
+/**
+ *    Copyright (C) 2023-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/query/tournament_tree.h"
+
+#include <deque>
+#include <random>
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * A number of sorted streams of ints, merged with a TournamentTree.
+ */
+class Streams {
+public:
+    struct Less {
+        bool operator()(size_t lhs, size_t rhs) const {
+            return streams->front(lhs) < streams->front(rhs);
+        }
+        const Streams* streams;
+    };
+
+    explicit Streams(size_t numStreams) : _streams(numStreams), _tree(numStreams, Less{this}) {}
+
+    int front(size_t stream) const {
+        return _streams[stream].front();
+    }
+
+    void push(size_t stream, int value) {
+        _streams[stream].push_back(value);
+        if (_streams[stream].size() == 1) {
+            _tree.update(stream, true);
+        }
+    }
+
+    void addStreams(size_t numStreams) {
+        _streams.resize(_streams.size() + numStreams);
+        _tree.addStreams(numStreams);
+    }
+
+    /**
+     * Pops the smallest value across all streams, or returns boost::none if all are empty.
+     */
+    boost::optional<std::pair<size_t, int>> pop() {
+        auto stream = _tree.top();
+        if (!stream) {
+            return boost::none;
+        }
+        const auto value = front(*stream);
+        _streams[*stream].pop_front();
+        _tree.update(*stream, !_streams[*stream].empty());
+        return std::make_pair(*stream, value);
+    }
+
+    /**
+     * Returns the stream with the smallest front, found by scanning all the streams.
+     */
+    boost::optional<size_t> expectedTop() const {
+        boost::optional<size_t> top;
+        for (size_t i = 0; i < _streams.size(); ++i) {
+            if (!_streams[i].empty() && (!top || front(i) < front(*top))) {
+                top = i;
+            }
+        }
+        return top;
+    }
+
+    const TournamentTree<Less>& tree() const {
+        return _tree;
+    }
+
+private:
+    std::vector<std::deque<int>> _streams;
+    TournamentTree<Less> _tree;
+};
+
+TEST(TournamentTreeTest, EmptyTree) {
+    Streams streams(0);
+    ASSERT_TRUE(streams.tree().empty());
+    ASSERT_FALSE(streams.pop());
+}
+
+TEST(TournamentTreeTest, SingleStream) {
+    Streams streams(1);
+    ASSERT_TRUE(streams.tree().empty());
+    streams.push(0, 1);
+    streams.push(0, 2);
+    ASSERT_EQ(streams.pop()->second, 1);
+    ASSERT_EQ(streams.pop()->second, 2);
+    ASSERT_TRUE(streams.tree().empty());
+}
+
+TEST(TournamentTreeTest, TiesGoToTheLowerStream) {
+    // Five streams make for leaves at different depths, which are not in stream order.
+    Streams streams(5);
+    for (size_t i = 0; i < 5; ++i) {
+        streams.push(4 - i, 7);
+    }
+    for (size_t i = 0; i < 5; ++i) {
+        auto popped = streams.pop();
+        ASSERT_EQ(popped->first, i);
+        ASSERT_EQ(popped->second, 7);
+    }
+    ASSERT_TRUE(streams.tree().empty());
+}
+
+TEST(TournamentTreeTest, UpdatesOfStreamsOtherThanTheWinner) {
+    Streams streams(3);
+    streams.push(0, 5);
+    streams.push(1, 9);
+    ASSERT_EQ(*streams.tree().top(), 0U);
+
+    // A stream which was empty receives a value smaller than the current winner.
+    streams.push(2, 1);
+    ASSERT_EQ(*streams.tree().top(), 2U);
+    ASSERT_EQ(streams.pop()->second, 1);
+    ASSERT_EQ(streams.pop()->second, 5);
+    ASSERT_EQ(streams.pop()->second, 9);
+    ASSERT_FALSE(streams.pop());
+}
+
+TEST(TournamentTreeTest, AddStreams) {
+    Streams streams(2);
+    streams.push(0, 4);
+    streams.push(1, 6);
+    streams.addStreams(3);
+    ASSERT_EQ(*streams.tree().top(), 0U);
+    streams.push(4, 2);
+    ASSERT_EQ(streams.tree().numStreams(), 5U);
+    ASSERT_EQ(streams.pop()->second, 2);
+    ASSERT_EQ(streams.pop()->second, 4);
+    ASSERT_EQ(streams.pop()->second, 6);
+    ASSERT_FALSE(streams.pop());
+}
+
+TEST(TournamentTreeTest, MatchesLinearScanUnderRandomUpdates) {
+    std::mt19937 gen(42);
+    for (size_t numStreams : {2, 3, 7, 8, 33, 256}) {
+        Streams streams(numStreams);
+        std::vector<int> next(numStreams, 0);
+        for (int i = 0; i < 10000; ++i) {
+            // Mostly append to a random stream, keeping each stream sorted, and otherwise pop.
+            if (gen() % 3) {
+                const size_t stream = gen() % numStreams;
+                next[stream] += gen() % 10;
+                streams.push(stream, next[stream]);
+            } else {
+                auto expected = streams.expectedTop();
+                auto popped = streams.pop();
+                ASSERT_EQ(bool(expected), bool(popped));
+                if (popped) {
+                    ASSERT_EQ(*expected, popped->first);
+                }
+            }
+            ASSERT_TRUE(streams.expectedTop() == streams.tree().top());
+        }
+    }
+}
+
+}  // namespace
+}  // namespace mongo
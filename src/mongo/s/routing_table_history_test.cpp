@@ -76,15 +76,15 @@ RoutingTableHistory splitChunk(const RoutingTableHistory& rt,
 }
 
 /**
- * Gets a set of raw pointers to ChunkInfo objects in the specified range,
+ * Gets the ranges of the chunks in the specified range.
  */
-std::set<ChunkInfo*> getChunksInRange(const RoutingTableHistory& rt,
+std::set<ChunkRange> getChunksInRange(const RoutingTableHistory& rt,
                                       const BSONObj& min,
                                       const BSONObj& max) {
-    std::set<ChunkInfo*> chunksFromSplit;
+    std::set<ChunkRange> chunksFromSplit;
 
     rt.forEachOverlappingChunk(min, max, false, [&](auto& chunk) {
-        chunksFromSplit.insert(chunk.get());
+        chunksFromSplit.insert(chunk->getRange());
         return true;
     });
 
@@ -95,7 +95,9 @@ std::set<ChunkInfo*> getChunksInRange(const RoutingTableHistory& rt,
  * Looks up a chunk that corresponds to or contains the range [min, max). There should only be one
  * such chunk in the input RoutingTableHistory object.
  */
-ChunkInfo* getChunkToSplit(const RoutingTableHistory& rt, const BSONObj& min, const BSONObj& max) {
+std::shared_ptr<ChunkInfo> getChunkToSplit(const RoutingTableHistory& rt,
+                                           const BSONObj& min,
+                                           const BSONObj& max) {
     std::shared_ptr<ChunkInfo> firstOverlappingChunk;
 
     rt.forEachOverlappingChunk(min, max, false, [&](auto& chunkInfo) {
@@ -104,7 +106,7 @@ ChunkInfo* getChunkToSplit(const RoutingTableHistory& rt, const BSONObj& min, co
     });
 
     invariant(firstOverlappingChunk);
-    return firstOverlappingChunk.get();
+    return firstOverlappingChunk;
 }
 
 /**
@@ -134,7 +136,7 @@ void assertCorrectBytesWritten(const RoutingTableHistory& rt,
     rt.forEachChunk([&](const auto& chunkInfo) {
         auto writesTracker = chunkInfo->getWritesTracker();
         auto bytesWritten = writesTracker->getBytesWritten();
-        if (chunksFromSplit.count(chunkInfo.get()) > 0) {
+        if (chunksFromSplit.count(chunkInfo->getRange()) > 0) {
             ASSERT_EQ(bytesWritten, expectedBytesInChunksFromSplit);
         } else {
             ASSERT_EQ(bytesWritten, expectedBytesInChunksNotSplit);
@@ -118,7 +118,7 @@ ShardingTestFixture::ShardingTestFixture()
 
     auto netForPool = std::make_unique<executor::NetworkInterfaceMock>();
     netForPool->setEgressMetadataHook(makeMetadataHookList());
-    auto _mockNetworkForPool = netForPool.get();
+    _mockNetworkForPool = netForPool.get();
     auto execForPool = makeShardingTestExecutor(std::move(netForPool));
     _networkTestEnvForPool =
         std::make_unique<NetworkTestEnv>(execForPool.get(), _mockNetworkForPool);
@@ -217,6 +217,11 @@ void ShardingTestFixture::onCommandForPoolExecutor(NetworkTestEnv::OnCommandFunc
     _networkTestEnvForPool->onCommand(func);
 }
 
+executor::NetworkInterfaceMock* ShardingTestFixture::networkForPool() const {
+    invariant(_mockNetworkForPool);
+    return _mockNetworkForPool;
+}
+
 void ShardingTestFixture::addRemoteShards(
     const std::vector<std::tuple<ShardId, HostAndPort>>& shardInfos) {
     std::vector<ShardType> shards;
@@ -75,6 +75,12 @@ protected:
      */
     void onCommandForPoolExecutor(executor::NetworkTestEnv::OnCommandFunction func);
 
+    /**
+     * Returns the mock network of the arbitrary executor of the Grid's executorPool, for tests
+     * which need to hold back or reorder the responses to several requests in flight.
+     */
+    executor::NetworkInterfaceMock* networkForPool() const;
+
     /**
      * Setup the shard registry to contain the given shards until the next reload.
      */
@@ -149,6 +155,7 @@ private:
     std::shared_ptr<executor::TaskExecutor> _fixedExecutor;
 
     // For the Grid's arbitrary executor in its executorPool.
+    executor::NetworkInterfaceMock* _mockNetworkForPool{nullptr};
     std::unique_ptr<executor::NetworkTestEnv> _networkTestEnvForPool;
 };
 
@@ -32,6 +32,8 @@
 
 #include "mongo/s/write_ops/batch_write_exec.h"
 
+#include <deque>
+
 #include "mongo/base/error_codes.h"
 #include "mongo/base/status.h"
 #include "mongo/bson/util/builder.h"
@@ -43,6 +45,7 @@
 #include "mongo/logv2/log.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/grid.h"
+#include "mongo/s/mongod_and_mongos_server_parameters_gen.h"
 #include "mongo/s/multi_statement_transaction_requests_sender.h"
 #include "mongo/s/transaction_router.h"
 #include "mongo/s/write_ops/batch_write_op.h"
@@ -106,6 +109,275 @@ bool hasTransientTransactionError(const BatchedCommandResponse& response) {
 // applies when no writes are occurring and metadata is not changing on reload.
 const int kMaxRoundsWithoutProgress(5);
 
+/**
+ * Builds the request which sends the child batch 'batch' to its shard.
+ */
+AsyncRequestsSender::Request buildShardRequest(OperationContext* opCtx,
+                                               const BatchWriteOp& batchOp,
+                                               const NSTargeter& targeter,
+                                               const TargetedWriteBatch& batch,
+                                               BatchWriteExecStats* stats) {
+    const auto& targetShardId = batch.getEndpoint().shardName;
+    stats->noteTargetedShard(targetShardId);
+
+    const auto request = [&] {
+        const auto shardBatchRequest(batchOp.buildBatchRequest(batch, targeter));
+
+        BSONObjBuilder requestBuilder;
+        shardBatchRequest.serialize(&requestBuilder);
+        logical_session_id_helpers::serializeLsidAndTxnNumber(opCtx, &requestBuilder);
+
+        return requestBuilder.obj();
+    }();
+
+    LOGV2_DEBUG(22905,
+                4,
+                "Sending write batch to {shardId}: {request}",
+                "Sending write batch",
+                "shardId"_attr = targetShardId,
+                "request"_attr = redact(request));
+
+    return {targetShardId, request};
+}
+
+enum class ResponseOutcome {
+    // The response was noted and the batch can carry on.
+    kNoted,
+
+    // The response was noted, and some of its writes failed because the routing information of
+    // this router is stale. They will be retargeted once the targeter is refreshed.
+    kNotedStaleRouting,
+
+    // The whole batch must stop, which only happens in transactions.
+    kAbortBatch,
+};
+
+/**
+ * Notes the response of a shard to the child batch 'batch' in 'batchOp'.
+ */
+ResponseOutcome processResponseFromRemote(OperationContext* opCtx,
+                                          NSTargeter& targeter,
+                                          const AsyncRequestsSender::Response& response,
+                                          const TargetedWriteBatch& batch,
+                                          BatchWriteOp& batchOp,
+                                          BatchWriteExecStats* stats) {
+    const auto shardInfo = response.shardHostAndPort ? response.shardHostAndPort->toString()
+                                                     : batch.getEndpoint().shardName;
+
+    // Then check if we successfully got a response.
+    Status responseStatus = response.swResponse.getStatus();
+    BatchedCommandResponse batchedCommandResponse;
+    if (responseStatus.isOK()) {
+        std::string errMsg;
+        if (!batchedCommandResponse.parseBSON(response.swResponse.getValue().data, &errMsg)) {
+            responseStatus = {ErrorCodes::FailedToParse, errMsg};
+        }
+    }
+
+    if (responseStatus.isOK()) {
+        TrackedErrors trackedErrors;
+        trackedErrors.startTracking(ErrorCodes::StaleConfig);
+        trackedErrors.startTracking(ErrorCodes::StaleDbVersion);
+        trackedErrors.startTracking(ErrorCodes::TenantMigrationAborted);
+
+        LOGV2_DEBUG(22907,
+                    4,
+                    "Write results received from {shardInfo}: {response}",
+                    "Write results received",
+                    "shardInfo"_attr = shardInfo,
+                    "status"_attr = redact(batchedCommandResponse.toStatus()));
+
+        // Dispatch was ok, note response
+        batchOp.noteBatchResponse(batch, batchedCommandResponse, &trackedErrors);
+
+        // If we are in a transaction, we must fail the whole batch on any error.
+        if (TransactionRouter::get(opCtx)) {
+            // Note: this returns a bad status if any part of the batch failed.
+            auto batchStatus = batchedCommandResponse.toStatus();
+            if (!batchStatus.isOK() && batchStatus != ErrorCodes::WouldChangeOwningShard) {
+                auto newStatus = batchStatus.withContext(
+                    str::stream() << "Encountered error from " << shardInfo
+                                  << " during a transaction");
+
+                batchOp.forgetTargetedBatchesOnTransactionAbortingError();
+
+                // Throw when there is a transient transaction error since this
+                // should be a top level error and not just a write error.
+                if (hasTransientTransactionError(batchedCommandResponse)) {
+                    uassertStatusOK(newStatus);
+                }
+
+                return ResponseOutcome::kAbortBatch;
+            }
+        }
+
+        // Note if anything was stale
+        auto staleConfigErrors = trackedErrors.getErrors(ErrorCodes::StaleConfig);
+        const auto& staleDbErrors = trackedErrors.getErrors(ErrorCodes::StaleDbVersion);
+        const auto& tenantMigrationAbortedErrors =
+            trackedErrors.getErrors(ErrorCodes::TenantMigrationAborted);
+
+        if (!staleConfigErrors.empty()) {
+            invariant(staleDbErrors.empty());
+            noteStaleShardResponses(opCtx, staleConfigErrors, &targeter);
+            ++stats->numStaleShardBatches;
+        }
+
+        if (!staleDbErrors.empty()) {
+            invariant(staleConfigErrors.empty());
+            noteStaleDbResponses(opCtx, staleDbErrors, &targeter);
+            ++stats->numStaleDbBatches;
+        }
+
+        if (!tenantMigrationAbortedErrors.empty()) {
+            ++stats->numTenantMigrationAbortedErrors;
+        }
+
+        if (response.shardHostAndPort) {
+            // Remember that we successfully wrote to this shard
+            // NOTE: This will record lastOps for shards where we actually didn't update
+            // or delete any documents, which preserves old behavior but is conservative
+            stats->noteWriteAt(*response.shardHostAndPort,
+                               batchedCommandResponse.isLastOpSet()
+                                   ? batchedCommandResponse.getLastOp()
+                                   : repl::OpTime(),
+                               batchedCommandResponse.isElectionIdSet()
+                                   ? batchedCommandResponse.getElectionId()
+                                   : OID());
+        }
+
+        return staleConfigErrors.empty() && staleDbErrors.empty()
+            ? ResponseOutcome::kNoted
+            : ResponseOutcome::kNotedStaleRouting;
+    }
+
+    if ((ErrorCodes::isShutdownError(responseStatus) ||
+         responseStatus == ErrorCodes::CallbackCanceled) &&
+        globalInShutdownDeprecated()) {
+        // Throw an error since the mongos itself is shutting down so this should
+        // be a top level error instead of a write error.
+        uassertStatusOK(responseStatus);
+    }
+
+    // Error occurred dispatching, note it
+    const Status status = responseStatus.withContext(
+        str::stream() << "Write results unavailable "
+                      << (response.shardHostAndPort ? "from "
+                                                    : "from failing to target a host in the shard ")
+                      << shardInfo);
+
+    batchOp.noteBatchError(batch, write_ops::WriteError(0, status));
+
+    LOGV2_DEBUG(22908,
+                4,
+                "Unable to receive write results from {shardInfo}: {error}",
+                "Unable to receive write results",
+                "shardInfo"_attr = shardInfo,
+                "error"_attr = redact(status));
+
+    // If we are in a transaction, we must stop immediately (even for unordered).
+    if (TransactionRouter::get(opCtx)) {
+        batchOp.forgetTargetedBatchesOnTransactionAbortingError();
+
+        // Throw when there is a transient transaction error since this should be a
+        // top level error and not just a write error.
+        if (isTransientTransactionError(status.code(), false, false)) {
+            uassertStatusOK(status);
+        }
+
+        return ResponseOutcome::kAbortBatch;
+    }
+
+    return ResponseOutcome::kNoted;
+}
+
+/**
+ * Sends the child batches of one round of an unordered insert outside of a transaction.
+ *
+ * A regular round sends each shard at most one child batch and waits for all of them to complete
+ * before the next round targets more, so each round is paced by the slowest shard. Instead, this
+ * targets all the remaining write ops upfront, and sends each shard its next child batch as soon
+ * as one of its previous ones completes, with up to 'maxInFlightPerShard' of them in flight.
+ *
+ * Once a shard reports that the routing information is stale, the child batches which were not
+ * sent yet are returned to the Ready state, so that the next round retargets them after the
+ * targeter is refreshed. Since every insert goes to a single shard, this is safe to do for any
+ * child batch.
+ */
+void executePipelinedRound(OperationContext* opCtx,
+                           NSTargeter& targeter,
+                           const BatchedCommandRequest& clientRequest,
+                           BatchWriteOp& batchOp,
+                           bool recordTargetErrors,
+                           int maxInFlightPerShard,
+                           std::map<ShardId, std::unique_ptr<TargetedWriteBatch>>* childBatches,
+                           BatchWriteExecStats* stats) {
+    // The child batches which have yet to be sent to each shard, in targeting order.
+    std::map<ShardId, std::deque<std::unique_ptr<TargetedWriteBatch>>> unsentBatches;
+
+    // Each targeting pass stops as soon as any child batch is full, so keep targeting until all
+    // the remaining write ops are in a child batch. A targeting error leaves the write ops which
+    // could not be targeted to the next round.
+    auto status = Status::OK();
+    while (!childBatches->empty() && status.isOK()) {
+        for (auto&& [shardId, batch] : *childBatches) {
+            unsentBatches[shardId].push_back(std::move(batch));
+        }
+        childBatches->clear();
+        status = batchOp.targetBatch(targeter, recordTargetErrors, childBatches);
+    }
+
+    // The child batches which were sent, indexed by the position of their request in the ARS.
+    std::vector<std::unique_ptr<TargetedWriteBatch>> sentBatches;
+    const auto makeRequestForNextBatch = [&](const ShardId& shardId) {
+        auto& batches = unsentBatches[shardId];
+        sentBatches.push_back(std::move(batches.front()));
+        batches.pop_front();
+        return buildShardRequest(opCtx, batchOp, targeter, *sentBatches.back(), stats);
+    };
+
+    std::vector<AsyncRequestsSender::Request> requests;
+    for (auto&& [shardId, batches] : unsentBatches) {
+        for (int i = 0; i < maxInFlightPerShard && !batches.empty(); ++i) {
+            requests.push_back(makeRequestForNextBatch(shardId));
+        }
+    }
+
+    const bool isRetryableWrite = opCtx->getTxnNumber().has_value();
+
+    MultiStatementTransactionRequestsSender ars(
+        opCtx,
+        Grid::get(opCtx)->getExecutorPool()->getArbitraryExecutor(),
+        clientRequest.getNS().db().toString(),
+        requests,
+        kPrimaryOnlyReadPreference,
+        isRetryableWrite ? Shard::RetryPolicy::kIdempotent : Shard::RetryPolicy::kNoRetry);
+
+    bool staleRouting = false;
+    while (!ars.done()) {
+        // Block until a response is available.
+        auto response = ars.next();
+        invariant(response.requestIndex < sentBatches.size());
+
+        const auto outcome = processResponseFromRemote(
+            opCtx, targeter, response, *sentBatches[response.requestIndex], batchOp, stats);
+        invariant(outcome != ResponseOutcome::kAbortBatch);
+        staleRouting = staleRouting || outcome == ResponseOutcome::kNotedStaleRouting;
+
+        // Keep the shard busy with its next child batch, unless the ones which have yet to be sent
+        // need to be retargeted.
+        if (!staleRouting && !unsentBatches[response.shardId].empty()) {
+            ars.addRequest(makeRequestForNextBatch(response.shardId));
+        }
+    }
+
+    for (auto&& [shardId, batches] : unsentBatches) {
+        for (auto&& batch : batches) {
+            batchOp.cancelUnsentBatch(*batch);
+        }
+    }
+}
+
 }  // namespace
 
 void BatchWriteExec::executeBatch(OperationContext* opCtx,
@@ -185,6 +457,22 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
         // Send all child batches
         //
 
+        const auto maxInFlightPerShard = gMaxInFlightUnorderedInsertBatchesPerShard.load();
+        if (maxInFlightPerShard > 0 && !childBatches.empty() &&
+            clientRequest.getBatchType() == BatchedCommandRequest::BatchType_Insert &&
+            !clientRequest.getWriteCommandRequestBase().getOrdered() &&
+            !TransactionRouter::get(opCtx)) {
+            // This takes all the child batches, which leaves none for the loop below.
+            executePipelinedRound(opCtx,
+                                  targeter,
+                                  clientRequest,
+                                  batchOp,
+                                  recordTargetErrors,
+                                  maxInFlightPerShard,
+                                  &childBatches,
+                                  stats);
+        }
+
         const size_t numToSend = childBatches.size();
         size_t numSent = 0;
 
@@ -211,26 +499,7 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
                 if (pendingBatches.count(targetShardId))
                     continue;
 
-                stats->noteTargetedShard(targetShardId);
-
-                const auto request = [&] {
-                    const auto shardBatchRequest(batchOp.buildBatchRequest(*nextBatch, targeter));
-
-                    BSONObjBuilder requestBuilder;
-                    shardBatchRequest.serialize(&requestBuilder);
-                    logical_session_id_helpers::serializeLsidAndTxnNumber(opCtx, &requestBuilder);
-
-                    return requestBuilder.obj();
-                }();
-
-                LOGV2_DEBUG(22905,
-                            4,
-                            "Sending write batch to {shardId}: {request}",
-                            "Sending write batch",
-                            "shardId"_attr = targetShardId,
-                            "request"_attr = redact(request));
-
-                requests.emplace_back(targetShardId, request);
+                requests.push_back(buildShardRequest(opCtx, batchOp, targeter, *nextBatch, stats));
 
                 // Indicate we're done by setting the batch to nullptr. We'll only get duplicate
                 // hostEndpoints if we have broadcast and non-broadcast endpoints for the same host,
@@ -264,133 +533,10 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
                 dassert(pendingBatches.find(response.shardId) != pendingBatches.end());
                 TargetedWriteBatch* batch = pendingBatches.find(response.shardId)->second.get();
 
-                const auto shardInfo = response.shardHostAndPort
-                    ? response.shardHostAndPort->toString()
-                    : batch->getEndpoint().shardName;
-
-                // Then check if we successfully got a response.
-                Status responseStatus = response.swResponse.getStatus();
-                BatchedCommandResponse batchedCommandResponse;
-                if (responseStatus.isOK()) {
-                    std::string errMsg;
-                    if (!batchedCommandResponse.parseBSON(response.swResponse.getValue().data,
-                                                          &errMsg)) {
-                        responseStatus = {ErrorCodes::FailedToParse, errMsg};
-                    }
-                }
-
-                if (responseStatus.isOK()) {
-                    TrackedErrors trackedErrors;
-                    trackedErrors.startTracking(ErrorCodes::StaleConfig);
-                    trackedErrors.startTracking(ErrorCodes::StaleDbVersion);
-                    trackedErrors.startTracking(ErrorCodes::TenantMigrationAborted);
-
-                    LOGV2_DEBUG(22907,
-                                4,
-                                "Write results received from {shardInfo}: {response}",
-                                "Write results received",
-                                "shardInfo"_attr = shardInfo,
-                                "status"_attr = redact(batchedCommandResponse.toStatus()));
-
-                    // Dispatch was ok, note response
-                    batchOp.noteBatchResponse(*batch, batchedCommandResponse, &trackedErrors);
-
-                    // If we are in a transaction, we must fail the whole batch on any error.
-                    if (TransactionRouter::get(opCtx)) {
-                        // Note: this returns a bad status if any part of the batch failed.
-                        auto batchStatus = batchedCommandResponse.toStatus();
-                        if (!batchStatus.isOK() &&
-                            batchStatus != ErrorCodes::WouldChangeOwningShard) {
-                            auto newStatus = batchStatus.withContext(
-                                str::stream() << "Encountered error from " << shardInfo
-                                              << " during a transaction");
-
-                            batchOp.forgetTargetedBatchesOnTransactionAbortingError();
-
-                            // Throw when there is a transient transaction error since this
-                            // should be a top level error and not just a write error.
-                            if (hasTransientTransactionError(batchedCommandResponse)) {
-                                uassertStatusOK(newStatus);
-                            }
-
-                            abortBatch = true;
-                            break;
-                        }
-                    }
-
-                    // Note if anything was stale
-                    auto staleConfigErrors = trackedErrors.getErrors(ErrorCodes::StaleConfig);
-                    const auto& staleDbErrors = trackedErrors.getErrors(ErrorCodes::StaleDbVersion);
-                    const auto& tenantMigrationAbortedErrors =
-                        trackedErrors.getErrors(ErrorCodes::TenantMigrationAborted);
-
-                    if (!staleConfigErrors.empty()) {
-                        invariant(staleDbErrors.empty());
-                        noteStaleShardResponses(opCtx, staleConfigErrors, &targeter);
-                        ++stats->numStaleShardBatches;
-                    }
-
-                    if (!staleDbErrors.empty()) {
-                        invariant(staleConfigErrors.empty());
-                        noteStaleDbResponses(opCtx, staleDbErrors, &targeter);
-                        ++stats->numStaleDbBatches;
-                    }
-
-                    if (!tenantMigrationAbortedErrors.empty()) {
-                        ++stats->numTenantMigrationAbortedErrors;
-                    }
-
-                    if (response.shardHostAndPort) {
-                        // Remember that we successfully wrote to this shard
-                        // NOTE: This will record lastOps for shards where we actually didn't update
-                        // or delete any documents, which preserves old behavior but is conservative
-                        stats->noteWriteAt(*response.shardHostAndPort,
-                                           batchedCommandResponse.isLastOpSet()
-                                               ? batchedCommandResponse.getLastOp()
-                                               : repl::OpTime(),
-                                           batchedCommandResponse.isElectionIdSet()
-                                               ? batchedCommandResponse.getElectionId()
-                                               : OID());
-                    }
-                } else {
-                    if ((ErrorCodes::isShutdownError(responseStatus) ||
-                         responseStatus == ErrorCodes::CallbackCanceled) &&
-                        globalInShutdownDeprecated()) {
-                        // Throw an error since the mongos itself is shutting down so this should
-                        // be a top level error instead of a write error.
-                        uassertStatusOK(responseStatus);
-                    }
-
-                    // Error occurred dispatching, note it
-                    const Status status = responseStatus.withContext(
-                        str::stream() << "Write results unavailable "
-                                      << (response.shardHostAndPort
-                                              ? "from "
-                                              : "from failing to target a host in the shard ")
-                                      << shardInfo);
-
-                    batchOp.noteBatchError(*batch, write_ops::WriteError(0, status));
-
-                    LOGV2_DEBUG(22908,
-                                4,
-                                "Unable to receive write results from {shardInfo}: {error}",
-                                "Unable to receive write results",
-                                "shardInfo"_attr = shardInfo,
-                                "error"_attr = redact(status));
-
-                    // If we are in a transaction, we must stop immediately (even for unordered).
-                    if (TransactionRouter::get(opCtx)) {
-                        batchOp.forgetTargetedBatchesOnTransactionAbortingError();
-
-                        // Throw when there is a transient transaction error since this should be a
-                        // top level error and not just a write error.
-                        if (isTransientTransactionError(status.code(), false, false)) {
-                            uassertStatusOK(status);
-                        }
-
-                        abortBatch = true;
-                        break;
-                    }
+                if (processResponseFromRemote(opCtx, targeter, response, *batch, batchOp, stats) ==
+                    ResponseOutcome::kAbortBatch) {
+                    abortBatch = true;
+                    break;
                 }
             }
         }
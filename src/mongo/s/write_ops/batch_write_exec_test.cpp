@@ -33,6 +33,7 @@
 #include "mongo/db/commands.h"
 #include "mongo/db/session/logical_session_id.h"
 #include "mongo/db/vector_clock.h"
+#include "mongo/idl/server_parameter_test_util.h"
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/mock_ns_targeter.h"
@@ -330,6 +331,47 @@ public:
         });
     }
 
+    /**
+     * Waits for 'numRequests' inserts to be sent on the arbitrary executor without responding to
+     * them, so that the test chooses the order of the responses. Each insert must carry a single
+     * document, and they are returned keyed by the shard key value of that document.
+     */
+    std::map<int, executor::NetworkInterfaceMock::NetworkOperationIterator> expectPendingInserts(
+        size_t numRequests) {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(networkForPool());
+
+        std::map<int, executor::NetworkInterfaceMock::NetworkOperationIterator> pendingInserts;
+        while (pendingInserts.size() < numRequests) {
+            auto noi = networkForPool()->getNextReadyRequest();
+            const auto& request = noi->getRequest();
+            ASSERT_EQUALS(nss.db(), request.dbname);
+
+            const auto opMsgRequest(OpMsgRequest::fromDBAndBody(request.dbname, request.cmdObj));
+            const auto actualBatchedInsert(BatchedCommandRequest::parseInsert(opMsgRequest));
+            const auto& inserted = actualBatchedInsert.getInsertRequest().getDocuments();
+            ASSERT_EQUALS(1U, inserted.size());
+
+            pendingInserts.emplace(inserted.front()["x"].numberInt(), noi);
+        }
+        return pendingInserts;
+    }
+
+    /**
+     * Responds to an insert returned by expectPendingInserts.
+     */
+    void respondToInsert(executor::NetworkInterfaceMock::NetworkOperationIterator noi,
+                         const BatchedCommandResponse& response) {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(networkForPool());
+
+        BSONObjBuilder result(response.toBSON());
+        CommandHelpers::appendCommandStatusNoThrow(result, Status::OK());
+        networkForPool()->scheduleResponse(
+            noi,
+            networkForPool()->now(),
+            executor::RemoteCommandResponse(result.obj(), Milliseconds(1)));
+        networkForPool()->runReadyNetworkOperations();
+    }
+
     const NamespaceString nss{"foo.bar"};
 
     const CollectionGeneration gen{OID::gen(), Timestamp(1, 1)};
@@ -341,6 +383,20 @@ public:
                                  boost::none),
                    BSON("x" << MINKEY),
                    BSON("x" << MAXKEY))}};
+    MockNSTargeter twoShardNSTargeter{
+        nss,
+        {MockRange(ShardEndpoint(kShardName1,
+                                 ShardVersion(ChunkVersion(gen, {100, 200}),
+                                              boost::optional<CollectionIndexes>(boost::none)),
+                                 boost::none),
+                   BSON("x" << MINKEY),
+                   BSON("x" << 0)),
+         MockRange(ShardEndpoint(kShardName2,
+                                 ShardVersion(ChunkVersion(gen, {101, 200}),
+                                              boost::optional<CollectionIndexes>(boost::none)),
+                                 boost::none),
+                   BSON("x" << 0),
+                   BSON("x" << MAXKEY))}};
 };
 
 //
@@ -682,6 +738,230 @@ TEST_F(BatchWriteExecTest, MultiOpLargeUnorderedWithStaleShardVersionError) {
     future.default_timed_get();
 }
 
+TEST_F(BatchWriteExecTest, MultiOpLargeUnorderedPipelined) {
+    RAIIServerParameterControllerForTest maxInFlight{"maxInFlightUnorderedInsertBatchesPerShard",
+                                                     1};
+    const int kNumDocsToInsert = 100'000;
+
+    std::vector<BSONObj> docsToInsert;
+    docsToInsert.reserve(kNumDocsToInsert);
+    for (int i = 0; i < kNumDocsToInsert; i++) {
+        docsToInsert.push_back(BSON("_id" << i));
+    }
+
+    BatchedCommandRequest request([&] {
+        write_ops::InsertCommandRequest insertOp(nss);
+        insertOp.setWriteCommandRequestBase([] {
+            write_ops::WriteCommandRequestBase writeCommandBase;
+            writeCommandBase.setOrdered(false);
+            return writeCommandBase;
+        }());
+        insertOp.setDocuments(docsToInsert);
+        return insertOp;
+    }());
+    request.setWriteConcern(BSONObj());
+
+    auto future = launchAsync([&] {
+        BatchedCommandResponse response;
+        BatchWriteExecStats stats;
+        BatchWriteExec::executeBatch(
+            operationContext(), singleShardNSTargeter, request, &response, &stats);
+
+        ASSERT(response.getOk());
+        ASSERT_EQ(kNumDocsToInsert, response.getN());
+
+        // Both child batches were targeted upfront and sent within a single round.
+        ASSERT_EQ(1, stats.numRounds);
+    });
+
+    expectInsertsReturnSuccess({docsToInsert.begin(), docsToInsert.begin() + 60133});
+    expectInsertsReturnSuccess({docsToInsert.begin() + 60133, docsToInsert.end()});
+
+    future.default_timed_get();
+}
+
+TEST_F(BatchWriteExecTest, MultiOpLargeUnorderedPipelinedWithStaleShardVersionError) {
+    RAIIServerParameterControllerForTest maxInFlight{"maxInFlightUnorderedInsertBatchesPerShard",
+                                                     1};
+    const int kNumDocsToInsert = 100'000;
+
+    std::vector<BSONObj> docsToInsert;
+    docsToInsert.reserve(kNumDocsToInsert);
+    for (int i = 0; i < kNumDocsToInsert; i++) {
+        docsToInsert.push_back(BSON("_id" << i));
+    }
+
+    BatchedCommandRequest request([&] {
+        write_ops::InsertCommandRequest insertOp(nss);
+        insertOp.setWriteCommandRequestBase([] {
+            write_ops::WriteCommandRequestBase writeCommandBase;
+            writeCommandBase.setOrdered(false);
+            return writeCommandBase;
+        }());
+        insertOp.setDocuments(docsToInsert);
+        return insertOp;
+    }());
+    request.setWriteConcern(BSONObj());
+
+    auto future = launchAsync([&] {
+        BatchedCommandResponse response;
+        BatchWriteExecStats stats;
+        BatchWriteExec::executeBatch(
+            operationContext(), singleShardNSTargeter, request, &response, &stats);
+
+        ASSERT(response.getOk());
+        ASSERT_EQ(kNumDocsToInsert, response.getN());
+        ASSERT_EQ(1, stats.numStaleShardBatches);
+        ASSERT_EQ(2, stats.numRounds);
+    });
+
+    // The stale version error stops the second child batch from being sent, so that both are
+    // retargeted in the next round.
+    expectInsertsReturnStaleVersionErrors({docsToInsert.begin(), docsToInsert.begin() + 60133});
+    expectInsertsReturnSuccess({docsToInsert.begin(), docsToInsert.begin() + 60133});
+    expectInsertsReturnSuccess({docsToInsert.begin() + 60133, docsToInsert.end()});
+
+    future.default_timed_get();
+}
+
+/**
+ * Builds an unordered insert of one document per shard key value in 'xs'. Each document is more
+ * than half the maximum size of a BSON object, so that every child batch holds a single document.
+ */
+BatchedCommandRequest makeUnorderedInsertOfBigDocs(const NamespaceString& nss,
+                                                   const std::vector<int>& xs) {
+    const std::string bigString(BSONObjMaxUserSize / 2, 'x');
+
+    std::vector<BSONObj> docsToInsert;
+    for (int x : xs) {
+        docsToInsert.push_back(BSON("x" << x << "data" << bigString));
+    }
+
+    BatchedCommandRequest request([&] {
+        write_ops::InsertCommandRequest insertOp(nss);
+        insertOp.setWriteCommandRequestBase([] {
+            write_ops::WriteCommandRequestBase writeCommandBase;
+            writeCommandBase.setOrdered(false);
+            return writeCommandBase;
+        }());
+        insertOp.setDocuments(docsToInsert);
+        return insertOp;
+    }());
+    request.setWriteConcern(BSONObj());
+    return request;
+}
+
+BatchedCommandResponse makeInsertSuccessResponse() {
+    BatchedCommandResponse response;
+    response.setStatus(Status::OK());
+    response.setN(1);
+    return response;
+}
+
+TEST_F(BatchWriteExecTest, MultiOpUnorderedPipelinedDoesNotWaitForSlowShard) {
+    RAIIServerParameterControllerForTest maxInFlight{"maxInFlightUnorderedInsertBatchesPerShard",
+                                                     2};
+
+    // The first shard gets three child batches and the second shard gets one.
+    const auto request = makeUnorderedInsertOfBigDocs(nss, {-1, 0, -2, -3});
+
+    auto future = launchAsync([&] {
+        BatchedCommandResponse response;
+        BatchWriteExecStats stats;
+        BatchWriteExec::executeBatch(
+            operationContext(), twoShardNSTargeter, request, &response, &stats);
+
+        ASSERT(response.getOk());
+        ASSERT_EQ(3, response.getN());
+        ASSERT_EQ(1, stats.numRounds);
+
+        // The write error was reported for the second batch sent to the first shard, even though
+        // it was the first response from that shard.
+        ASSERT_EQ(1U, response.sizeErrDetails());
+        ASSERT_EQ(2, response.getErrDetailsAt(0).getIndex());
+        ASSERT_EQ(ErrorCodes::UnknownError, response.getErrDetailsAt(0).getStatus().code());
+    });
+
+    // Each shard is sent up to two child batches upfront.
+    auto pendingInserts = expectPendingInserts(3);
+    ASSERT_EQ(kTestShardHost1, pendingInserts.at(-1)->getRequest().target);
+    ASSERT_EQ(kTestShardHost1, pendingInserts.at(-2)->getRequest().target);
+    ASSERT_EQ(kTestShardHost2, pendingInserts.at(0)->getRequest().target);
+
+    // Respond to the second batch of the first shard before its first one, which leaves it to the
+    // index of the request to match the response with its batch.
+    auto errorResponse = makeInsertSuccessResponse();
+    errorResponse.setN(0);
+    errorResponse.addToErrDetails(
+        write_ops::WriteError(0, {ErrorCodes::UnknownError, "mock non-retryable error"}));
+    respondToInsert(pendingInserts.at(-2), errorResponse);
+
+    // The first shard is sent its last batch while the batch of the second shard is outstanding.
+    auto nextInserts = expectPendingInserts(1);
+    ASSERT_EQ(kTestShardHost1, nextInserts.at(-3)->getRequest().target);
+
+    respondToInsert(pendingInserts.at(-1), makeInsertSuccessResponse());
+    respondToInsert(nextInserts.at(-3), makeInsertSuccessResponse());
+    respondToInsert(pendingInserts.at(0), makeInsertSuccessResponse());
+
+    future.default_timed_get();
+}
+
+TEST_F(BatchWriteExecTest, MultiOpUnorderedPipelinedStaleErrorCancelsOnlyUnsentBatches) {
+    RAIIServerParameterControllerForTest maxInFlight{"maxInFlightUnorderedInsertBatchesPerShard",
+                                                     2};
+
+    // The first shard gets three child batches and the second shard gets one.
+    const auto request = makeUnorderedInsertOfBigDocs(nss, {-1, 0, -2, -3});
+
+    auto future = launchAsync([&] {
+        BatchedCommandResponse response;
+        BatchWriteExecStats stats;
+        BatchWriteExec::executeBatch(
+            operationContext(), twoShardNSTargeter, request, &response, &stats);
+
+        ASSERT(response.getOk());
+        ASSERT_EQ(4, response.getN());
+        ASSERT(!response.isErrDetailsSet());
+        ASSERT_EQ(1, stats.numStaleShardBatches);
+        ASSERT_EQ(2, stats.numRounds);
+    });
+
+    auto pendingInserts = expectPendingInserts(3);
+    ASSERT_EQ(kTestShardHost1, pendingInserts.at(-1)->getRequest().target);
+    ASSERT_EQ(kTestShardHost1, pendingInserts.at(-2)->getRequest().target);
+    ASSERT_EQ(kTestShardHost2, pendingInserts.at(0)->getRequest().target);
+
+    // The second shard reports stale routing information before the first shard responds.
+    auto staleResponse = makeInsertSuccessResponse();
+    staleResponse.setN(0);
+    staleResponse.addToErrDetails(write_ops::WriteError(
+        0,
+        Status(StaleConfigInfo(nss,
+                               ShardVersion(ChunkVersion(gen, {101, 200}),
+                                            boost::optional<CollectionIndexes>(boost::none)),
+                               ShardVersion(ChunkVersion(gen, {105, 200}),
+                                            boost::optional<CollectionIndexes>(boost::none)),
+                               ShardId(kShardName2)),
+               "Stale error")));
+    respondToInsert(pendingInserts.at(0), staleResponse);
+
+    // The batches of the first shard which were already sent complete in this round, and the one
+    // which was not sent yet is not sent after the stale response.
+    respondToInsert(pendingInserts.at(-2), makeInsertSuccessResponse());
+    respondToInsert(pendingInserts.at(-1), makeInsertSuccessResponse());
+
+    // The next round retargets only the stale write and the write whose batch was cancelled.
+    auto retargetedInserts = expectPendingInserts(2);
+    ASSERT_EQ(kTestShardHost1, retargetedInserts.at(-3)->getRequest().target);
+    ASSERT_EQ(kTestShardHost2, retargetedInserts.at(0)->getRequest().target);
+
+    respondToInsert(retargetedInserts.at(-3), makeInsertSuccessResponse());
+    respondToInsert(retargetedInserts.at(0), makeInsertSuccessResponse());
+
+    future.default_timed_get();
+}
+
 TEST_F(BatchWriteExecTest, StaleShardVersionReturnedFromBatchWithSingleMultiWrite) {
     BatchedCommandRequest request([&] {
         write_ops::UpdateCommandRequest updateOp(nss);
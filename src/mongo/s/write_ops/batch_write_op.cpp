@@ -750,6 +750,18 @@ void BatchWriteOp::abortBatch(const write_ops::WriteError& error) {
     dassert(isFinished());
 }
 
+void BatchWriteOp::cancelUnsentBatch(const TargetedWriteBatch& targetedBatch) {
+    for (auto&& write : targetedBatch.getWrites()) {
+        WriteOp& writeOp = _writeOps[write->writeOpRef.first];
+        invariant(writeOp.getWriteState() == WriteOpState_Pending);
+        dassert(writeOp.getNumTargeted() == 1u);
+        writeOp.cancelWrites(nullptr);
+    }
+
+    // Stop tracking targeted batch
+    _targeted.erase(&targetedBatch);
+}
+
 void BatchWriteOp::forgetTargetedBatchesOnTransactionAbortingError() {
     _targeted.clear();
 }
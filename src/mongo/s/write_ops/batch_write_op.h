@@ -170,6 +170,13 @@ public:
     void noteBatchError(const TargetedWriteBatch& targetedBatch,
                         const write_ops::WriteError& error);
 
+    /**
+     * Returns the write ops of a targeted batch which is not going to be sent back to the Ready
+     * state, so that they get targeted again. Each of the write ops must only have been targeted
+     * to this batch, as is always the case for inserts.
+     */
+    void cancelUnsentBatch(const TargetedWriteBatch& targetedBatch);
+
     /**
      * Aborts any further writes in the batch with the provided error.  There must be no pending
      * ops awaiting results when a batch is aborted.